@@ -240,6 +240,7 @@ enum {
 	ESLURMD_STEP_SUSPENDED,
 	ESLURMD_STEP_NOTSUSPENDED,
 	ESLURMD_INVALID_SOCKET_NAME_LEN =		4030,
+	ESLURMD_BCAST_FILE_UP_TO_DATE,
 
 	/* slurmd errors in user batch job */
 	ESCRIPT_CHDIR_FAILED =			4100,
@@ -561,6 +561,17 @@ typedef struct slurmdb_assoc_rec {
 				       */
 } slurmdb_assoc_rec_t;
 
+/*
+ * Flags for slurmdb_assoc_usage_t lineage_limits, one per scheduling
+ * limit checked against the association parent chain.  A clear flag
+ * means no association in the chain sets that limit, so the check can
+ * be skipped without walking the chain.
+ */
+#define SLURMDB_LINEAGE_LIMIT_GRP_JOBS	0x0001
+#define SLURMDB_LINEAGE_LIMIT_GRP_WALL	0x0002
+#define SLURMDB_LINEAGE_LIMIT_MAX_JOBS	0x0004
+#define SLURMDB_LINEAGE_LIMIT_MAX_WALL	0x0008
+
 struct slurmdb_assoc_usage {
 	uint32_t accrue_cnt;    /* Count of how many jobs I have accuring prio
 				 * (DON'T PACK for state file) */
@@ -581,6 +592,11 @@ struct slurmdb_assoc_usage {
 	uint32_t level_shares;  /* number of shares on this level of
 				 * the tree (DON'T PACK for state file) */
 
+	uint16_t lineage_limits; /* SLURMDB_LINEAGE_LIMIT_* flags for the
+				  * scheduling limits set on this
+				  * association or any of its parents,
+				  * set in the assoc mgr (DON'T PACK) */
+
 	slurmdb_assoc_rec_t *parent_assoc_ptr; /* ptr to direct
 						* parent assoc
 						* set in slurmctld
@@ -1313,7 +1329,13 @@ typedef struct {
 	uint32_t type_cnt;		/* Length of rpc_type arrays */
 	uint16_t *rpc_type_id;		/* RPC type */
 	uint32_t *rpc_type_cnt;		/* count of RPCs processed */
+	uint32_t rpc_type_hist_size;	/* buckets per latency histogram,
+					 * zero if the server is too old */
+	uint32_t *rpc_type_hist;	/* latency histograms, one row of
+					 * rpc_type_hist_size power of two
+					 * microsecond buckets per RPC type */
 	uint64_t *rpc_type_time;	/* total usecs this type RPC */
+	uint64_t *rpc_type_time_max;	/* slowest RPC of this type, usecs */
 	uint32_t user_cnt;		/* Length of rpc_user arrays */
 	uint32_t *rpc_user_id;		/* User ID issuing RPC */
 	uint32_t *rpc_user_cnt;		/* count of RPCs processed */
@@ -279,6 +279,225 @@ slurm_allocate_resources_blocking (const job_desc_msg_t *user_req,
 	return resp;
 }
 
+/* One listening socket shared by every pending allocation in the
+ * context; the job ID carried in each response demultiplexes them */
+struct allocation_async_ctx {
+	listen_t *listen;
+	List pending_job_ids;	/* uint32_t *, jobs awaiting their grant */
+};
+
+static int _match_pending_job_id(void *x, void *key)
+{
+	uint32_t *id = (uint32_t *) x;
+	uint32_t *job_id = (uint32_t *) key;
+
+	return (*id == *job_id);
+}
+
+extern allocation_async_ctx_t *slurm_allocation_async_create(void)
+{
+	allocation_async_ctx_t *ctx;
+	listen_t *listen;
+
+	if ((listen = _create_allocation_response_socket()) == NULL)
+		return NULL;
+
+	ctx = xmalloc(sizeof(allocation_async_ctx_t));
+	ctx->listen = listen;
+	ctx->pending_job_ids = list_create(slurm_destroy_uint32_ptr);
+
+	return ctx;
+}
+
+extern int slurm_allocation_async_fd(allocation_async_ctx_t *ctx)
+{
+	if (ctx == NULL)
+		return -1;
+	return ctx->listen->fd;
+}
+
+extern int slurm_allocation_async_pending(allocation_async_ctx_t *ctx)
+{
+	if (ctx == NULL)
+		return 0;
+	return list_count(ctx->pending_job_ids);
+}
+
+extern int slurm_allocation_async_submit(
+	allocation_async_ctx_t *ctx, job_desc_msg_t *user_req,
+	uint32_t *job_id, resource_allocation_response_msg_t **resp)
+{
+	int rc, errnum = SLURM_SUCCESS;
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+	resource_allocation_response_msg_t *alloc;
+	job_desc_msg_t *req;
+	uint32_t *pend_id;
+
+	*job_id = 0;
+	*resp = NULL;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+
+	/* make a copy of the user's job description struct so that we
+	 * can make changes before contacting the controller */
+	req = (job_desc_msg_t *)xmalloc(sizeof(job_desc_msg_t));
+	memcpy(req, user_req, sizeof(job_desc_msg_t));
+
+	/*
+	 * set Node and session id for this request
+	 */
+	if (req->alloc_sid == NO_VAL)
+		req->alloc_sid = getsid(0);
+	req->alloc_resp_port = ctx->listen->port;
+
+	req_msg.msg_type = REQUEST_RESOURCE_ALLOCATION;
+	req_msg.data     = req;
+
+	rc = slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					    working_cluster_rec);
+
+	if (rc == SLURM_ERROR) {
+		errnum = errno;
+		destroy_forward(&req_msg.forward);
+		destroy_forward(&resp_msg.forward);
+		xfree(req);
+		errno = errnum;
+		return SLURM_ERROR;
+	}
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_SLURM_RC:
+		if (_handle_rc_msg(&resp_msg) < 0) {
+			/* will reach this when the allocation fails */
+			errnum = errno;
+		} else {
+			/* shouldn't get here */
+			errnum = SLURM_ERROR;
+		}
+		rc = SLURM_ERROR;
+		break;
+	case RESPONSE_RESOURCE_ALLOCATION:
+		alloc = (resource_allocation_response_msg_t *) resp_msg.data;
+		*job_id = alloc->job_id;
+		if (alloc->node_cnt > 0) {
+			/* allocation has been granted immediately */
+			*resp = alloc;
+		} else {
+			if (alloc->error_code != SLURM_SUCCESS)
+				info("%s", slurm_strerror(alloc->error_code));
+			print_multi_line_string(alloc->job_submit_user_msg,
+						-1, LOG_LEVEL_INFO);
+			pend_id = xmalloc(sizeof(uint32_t));
+			*pend_id = alloc->job_id;
+			list_append(ctx->pending_job_ids, pend_id);
+			slurm_free_resource_allocation_response_msg(alloc);
+		}
+		rc = SLURM_SUCCESS;
+		break;
+	default:
+		errnum = SLURM_UNEXPECTED_MSG_ERROR;
+		rc = SLURM_ERROR;
+	}
+
+	destroy_forward(&req_msg.forward);
+	destroy_forward(&resp_msg.forward);
+	xfree(req);
+	errno = errnum;
+	return rc;
+}
+
+extern allocation_async_event_t slurm_allocation_async_fetch(
+	allocation_async_ctx_t *ctx, uint32_t *job_id,
+	resource_allocation_response_msg_t **resp)
+{
+	int conn_fd;
+	slurm_msg_t *msg;
+	slurm_addr_t cli_addr;
+	uid_t req_uid;
+	uid_t uid       = getuid();
+	uid_t slurm_uid = (uid_t) slurm_get_slurm_user_id();
+
+	*job_id = 0;
+	*resp = NULL;
+
+	/* The listening socket is non-blocking, so keep consuming
+	 * connections until an event is found or none remain */
+	while (true) {
+		conn_fd = slurm_accept_msg_conn(ctx->listen->fd, &cli_addr);
+		if (conn_fd < 0) {
+			if ((errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+			    (errno != EINTR))
+				error("%s: accept: %m", __func__);
+			return ALLOC_ASYNC_NONE;
+		}
+
+		msg = xmalloc(sizeof(slurm_msg_t));
+		slurm_msg_t_init(msg);
+
+		if (slurm_receive_msg(conn_fd, msg, 0) != 0) {
+			error("%s: %m", __func__);
+			slurm_free_msg(msg);
+			close(conn_fd);
+			continue;
+		}
+
+		req_uid = g_slurm_auth_get_uid(msg->auth_cred);
+		if ((req_uid != slurm_uid) && (req_uid != 0) &&
+		    (req_uid != uid)) {
+			error("Security violation, slurm message from uid %u",
+			      (unsigned int) req_uid);
+			slurm_free_msg(msg);
+			close(conn_fd);
+			continue;
+		}
+
+		if (msg->msg_type == RESPONSE_RESOURCE_ALLOCATION) {
+			debug2("resource allocation response received");
+			slurm_send_rc_msg(msg, SLURM_SUCCESS);
+			*resp = (resource_allocation_response_msg_t *)
+				msg->data;    /* transfer payload */
+			msg->data = NULL;
+			*job_id = (*resp)->job_id;
+			(void) list_delete_all(ctx->pending_job_ids,
+					       _match_pending_job_id, job_id);
+			slurm_free_msg(msg);
+			close(conn_fd);
+			return ALLOC_ASYNC_GRANTED;
+		} else if (msg->msg_type == SRUN_JOB_COMPLETE) {
+			srun_job_complete_msg_t *comp =
+				(srun_job_complete_msg_t *) msg->data;
+			debug2("job %u ended while pending", comp->job_id);
+			*job_id = comp->job_id;
+			(void) list_delete_all(ctx->pending_job_ids,
+					       _match_pending_job_id, job_id);
+			slurm_free_msg(msg);
+			close(conn_fd);
+			return ALLOC_ASYNC_REVOKED;
+		}
+
+		error("%s: received spurious message type: %u",
+		      __func__, msg->msg_type);
+		slurm_free_msg(msg);
+		close(conn_fd);
+	}
+}
+
+extern void slurm_allocation_async_destroy(allocation_async_ctx_t *ctx)
+{
+	if (ctx == NULL)
+		return;
+
+	if (list_count(ctx->pending_job_ids)) {
+		info("%s: %d allocations still pending, their grant events will be lost",
+		     __func__, list_count(ctx->pending_job_ids));
+	}
+	FREE_NULL_LIST(ctx->pending_job_ids);
+	_destroy_allocation_response_socket(ctx->listen);
+	xfree(ctx);
+}
+
 static void *_load_willrun_thread(void *args)
 {
 	load_willrun_req_struct_t *load_args =
@@ -279,8 +279,8 @@ static void _net_forward(struct allocation_msg_thread *msg_thr,
 	/* prevent the upstream call path from closing the connection */
 	forward_msg->conn_fd = -1;
 
-	e1 = eio_obj_create(*local, &half_duplex_ops, remote);
-	e2 = eio_obj_create(*remote, &half_duplex_ops, local);
+	e1 = half_duplex_obj_create(*local, remote);
+	e2 = half_duplex_obj_create(*remote, local);
 
 	/* setup eio to handle both sides of the connection now */
 	eio_new_obj(msg_thr->handle, e1);
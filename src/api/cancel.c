@@ -152,6 +152,45 @@ slurm_kill_job2(const char *job_id, uint16_t signal, uint16_t flags)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * slurm_kill_jobs - signal every job matching the request in a single RPC
+ * IN kill_msg - explicit job ids and/or filters plus the signal to deliver
+ * OUT resp - per-job error codes, free using slurm_free_job_array_resp()
+ * RET SLURM_SUCCESS on success, otherwise return SLURM_ERROR with errno set
+ */
+extern int slurm_kill_jobs(kill_jobs_msg_t *kill_msg,
+			   job_array_resp_msg_t **resp)
+{
+	int rc = SLURM_SUCCESS;
+	slurm_msg_t req_msg, resp_msg;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+	req_msg.msg_type = REQUEST_KILL_JOBS;
+	req_msg.data     = kill_msg;
+
+	rc = slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					    working_cluster_rec);
+	if (rc < 0)
+		return SLURM_ERROR;
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_JOB_ARRAY_ERRORS:
+		*resp = (job_array_resp_msg_t *) resp_msg.data;
+		break;
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+	}
+
+	return rc;
+}
+
 /*
  * slurm_kill_job_msg - send kill msg to and existing job or step.
  *
@@ -174,9 +174,8 @@ static void _fname_format(char *buf, int buf_size, job_info_t * job_ptr,
 	}
 	while ((ptr = strstr(tmp, "%u"))) {	/* User name */
 		ptr[0] = '\0';
-		user = uid_to_string((uid_t) job_ptr->user_id);
+		user = uid_to_string_cached((uid_t) job_ptr->user_id);
 		xstrfmtcat(tmp2, "%s%s%s", tmp, user, ptr+2);
-		xfree(user);
 		xfree(tmp);	/* transfer the results */
 		tmp = tmp2;
 		tmp2 = NULL;
@@ -403,12 +402,11 @@ slurm_sprint_job_info ( job_info_t * job_ptr, int one_liner )
 	}
 
 	/****** Line ******/
-	user_name = uid_to_string((uid_t) job_ptr->user_id);
+	user_name = uid_to_string_cached((uid_t) job_ptr->user_id);
 	group_name = gid_to_string((gid_t) job_ptr->group_id);
 	xstrfmtcat(out, "UserId=%s(%u) GroupId=%s(%u) MCS_label=%s",
 		   user_name, job_ptr->user_id, group_name, job_ptr->group_id,
 		   (job_ptr->mcs_label==NULL) ? "N/A" : job_ptr->mcs_label);
-	xfree(user_name);
 	xfree(group_name);
 	xstrcat(out, line_end);
 
@@ -1166,6 +1164,15 @@ static int _load_fed_jobs(slurm_msg_t *req_msg,
 					      new_msg->record_count);
 				orig_msg->record_count = new_rec_cnt;
 			}
+			/* Adopt the buffers backing the merged records */
+			if (orig_msg->backing_buf && new_msg->backing_buf) {
+				list_transfer(orig_msg->backing_buf,
+					      new_msg->backing_buf);
+				FREE_NULL_LIST(new_msg->backing_buf);
+			} else if (new_msg->backing_buf) {
+				orig_msg->backing_buf = new_msg->backing_buf;
+				new_msg->backing_buf = NULL;
+			}
 			xfree(new_msg->job_array);
 			xfree(new_msg);
 		}
@@ -1332,6 +1339,68 @@ slurm_load_jobs (time_t update_time, job_info_msg_t **job_info_msg_pptr,
 	return rc;
 }
 
+/*
+ * slurm_load_jobs2 - equivalent to slurm_load_jobs() with addition
+ *	of cluster record for communications in a federation
+ */
+extern int slurm_load_jobs2(time_t update_time,
+			    job_info_msg_t **job_info_msg_pptr,
+			    uint16_t show_flags, slurmdb_cluster_rec_t *cluster)
+{
+	slurm_msg_t req_msg;
+	job_info_request_msg_t req;
+
+	slurm_msg_t_init(&req_msg);
+	memset(&req, 0, sizeof(req));
+	req.last_update  = update_time;
+	req.show_flags   = show_flags;
+	req_msg.msg_type = REQUEST_JOB_INFO;
+	req_msg.data     = &req;
+
+	return _load_cluster_jobs(&req_msg, job_info_msg_pptr, cluster);
+}
+
+/*
+ * slurm_load_job_ids - issue RPC to get slurm information about the
+ *	specified jobs, including every task of the named job arrays and
+ *	every component of the named heterogeneous jobs
+ * IN update_time - time of current configuration data
+ * IN/OUT job_info_msg_pptr - place to store a job configuration pointer
+ * IN job_ids - array of job IDs we want information for
+ * IN job_id_cnt - count of job IDs in job_ids
+ * IN show_flags - job filtering options
+ * RET 0 or -1 on error
+ * NOTE: free the response using slurm_free_job_info_msg
+ * NOTE: the response covers the local cluster only, job IDs can not be
+ *	interpreted by the other clusters of a federation
+ */
+extern int slurm_load_job_ids(time_t update_time,
+			      job_info_msg_t **job_info_msg_pptr,
+			      uint32_t *job_ids, uint32_t job_id_cnt,
+			      uint16_t show_flags)
+{
+	slurm_msg_t req_msg;
+	job_info_request_msg_t req;
+	uint32_t i;
+	int rc;
+
+	slurm_msg_t_init(&req_msg);
+	memset(&req, 0, sizeof(req));
+	req.last_update  = update_time;
+	req.show_flags   = show_flags | SHOW_LOCAL;
+	req.job_ids      = list_create(NULL);
+	for (i = 0; i < job_id_cnt; i++)
+		list_append(req.job_ids, job_ids + i);
+	req_msg.msg_type = REQUEST_JOB_INFO;
+	req_msg.data     = &req;
+
+	rc = _load_cluster_jobs(&req_msg, job_info_msg_pptr,
+				working_cluster_rec);
+	FREE_NULL_LIST(req.job_ids);
+
+	return rc;
+}
+
 /*
  * slurm_load_job_user - issue RPC to get slurm information about all jobs
  *	to be run as the specified user
@@ -657,6 +657,15 @@ static int _load_fed_nodes(slurm_msg_t *req_msg,
 					      new_msg->record_count);
 				orig_msg->record_count = new_rec_cnt;
 			}
+			/* Adopt the buffers backing the merged records */
+			if (orig_msg->backing_buf && new_msg->backing_buf) {
+				list_transfer(orig_msg->backing_buf,
+					      new_msg->backing_buf);
+				FREE_NULL_LIST(new_msg->backing_buf);
+			} else if (new_msg->backing_buf) {
+				orig_msg->backing_buf = new_msg->backing_buf;
+				new_msg->backing_buf = NULL;
+			}
 			xfree(new_msg->node_array);
 			xfree(new_msg);
 		}
@@ -729,6 +738,55 @@ extern int slurm_load_node(time_t update_time, node_info_msg_t **resp,
 	return rc;
 }
 
+/*
+ * slurm_load_node_summary - issue RPC to get per-partition node state counts
+ *	if changed since update_time, in place of a full node info dump
+ * IN update_time - time of current configuration data
+ * OUT resp - place to store a node summary pointer
+ * IN show_flags - node filtering options (e.g. SHOW_ALL)
+ * RET 0 or a slurm error code
+ * NOTE: free the response using slurm_free_node_summary_info_msg
+ */
+extern int slurm_load_node_summary(time_t update_time,
+				   node_summary_info_msg_t **resp,
+				   uint16_t show_flags)
+{
+	slurm_msg_t req_msg;
+	slurm_msg_t resp_msg;
+	node_info_request_msg_t req;
+	int rc;
+
+	slurm_msg_t_init(&req_msg);
+	slurm_msg_t_init(&resp_msg);
+	memset(&req, 0, sizeof(req));
+	req.last_update  = update_time;
+	req.show_flags   = show_flags;
+	req_msg.msg_type = REQUEST_NODE_INFO_SUMMARY;
+	req_msg.data     = &req;
+
+	if (slurm_send_recv_controller_msg(&req_msg, &resp_msg,
+					   working_cluster_rec) < 0)
+		return SLURM_ERROR;
+
+	switch (resp_msg.msg_type) {
+	case RESPONSE_NODE_INFO_SUMMARY:
+		*resp = (node_summary_info_msg_t *) resp_msg.data;
+		break;
+	case RESPONSE_SLURM_RC:
+		rc = ((return_code_msg_t *) resp_msg.data)->return_code;
+		slurm_free_return_code_msg(resp_msg.data);
+		if (rc)
+			slurm_seterrno_ret(rc);
+		*resp = NULL;
+		break;
+	default:
+		slurm_seterrno_ret(SLURM_UNEXPECTED_MSG_ERROR);
+		break;
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * slurm_load_node2 - equivalent to slurm_load_node() with addition
  *	of cluster record for communications in a federation
@@ -184,7 +184,8 @@ static void *_agent(void *x)
 	struct kvs_hosts *kvs_host_list;
 	int i, j, kvs_set_cnt = 0, host_cnt, pmi_fanout = 32;
 	int msg_sent = 0, max_forward = 0;
-	char *tmp, *fanout_off_host;
+	int *live = NULL, n_live = 0, host_total = 0, base, stride;
+	char *tmp, *fanout_off_host, *last_host = NULL;
 	DEF_TIMERS;
 
 	tmp = getenv("PMI_FANOUT");
@@ -199,6 +200,83 @@ static void *_agent(void *x)
 	 * build table of the ports on each host */
 	START_TIMER;
 	kvs_set = xmalloc(sizeof(kvs_comm_set_t) * args->barrier_xmit_cnt);
+
+	/* Count the hosts we would address directly. Tasks arrive in
+	 * block order, so comparing adjacent hostnames is accurate for
+	 * the common distributions; at worst we overcount and build
+	 * the tree a little early. */
+	for (i=0; i<args->barrier_xmit_cnt; i++) {
+		if (args->barrier_xmit_ptr[i].port == 0)
+			continue;
+		if (last_host &&
+		    (strcmp(last_host,
+			    args->barrier_xmit_ptr[i].hostname) == 0))
+			continue;
+		last_host = args->barrier_xmit_ptr[i].hostname;
+		host_total++;
+	}
+
+	if (host_total > pmi_fanout) {
+		/* Hierarchical distribution: address only pmi_fanout
+		 * tree roots, each taking an equal slice of the
+		 * remaining tasks. Recipients re-split their slice
+		 * the same way (see _forward_comm_set() in
+		 * slurm_pmi.c), so the key-pairs flow down a tree of
+		 * depth log(tasks)/log(fanout) instead of srun
+		 * contacting every node itself. */
+		live = xmalloc(sizeof(int) * args->barrier_xmit_cnt);
+		for (i=0; i<args->barrier_xmit_cnt; i++) {
+			if (args->barrier_xmit_ptr[i].port)
+				live[n_live++] = i;
+		}
+		stride = (n_live + pmi_fanout - 1) / pmi_fanout;
+		for (base=0; base<n_live; base+=stride) {
+			host_cnt = MIN(stride, (n_live - base)) - 1;
+			kvs_host_list = xmalloc(sizeof(struct kvs_hosts) *
+						host_cnt);
+			for (j=0; j<host_cnt; j++) {
+				kvs_host_list[j].task_id = 0; /* not avail */
+				kvs_host_list[j].port = args->
+					barrier_xmit_ptr[live[base+j+1]].port;
+				kvs_host_list[j].hostname = args->
+					barrier_xmit_ptr[live[base+j+1]].
+					hostname;
+			}
+			msg_sent++;
+			max_forward = MAX(host_cnt, max_forward);
+
+			slurm_mutex_lock(&agent_mutex);
+			while (agent_cnt >= agent_max_cnt)
+				slurm_cond_wait(&agent_cond, &agent_mutex);
+			agent_cnt++;
+			slurm_mutex_unlock(&agent_mutex);
+
+			msg_args = xmalloc(sizeof(struct msg_arg));
+			msg_args->bar_ptr =
+				&args->barrier_xmit_ptr[live[base]];
+			msg_args->kvs_ptr = &kvs_set[kvs_set_cnt];
+			kvs_set[kvs_set_cnt].host_cnt      = host_cnt;
+			kvs_set[kvs_set_cnt].kvs_host_ptr  = kvs_host_list;
+			kvs_set[kvs_set_cnt].kvs_comm_recs =
+				args->kvs_xmit_cnt;
+			kvs_set[kvs_set_cnt].kvs_comm_ptr  =
+				args->kvs_xmit_ptr;
+			kvs_set_cnt++;
+			if (agent_max_cnt == 1) {
+				_msg_thread((void *) msg_args);
+			} else {
+				slurm_thread_create_detached(NULL,
+							     _msg_thread,
+							     msg_args);
+			}
+		}
+		xfree(live);
+
+		verbose("Sent KVS info to %d tree roots, up to %d tasks each",
+			msg_sent, (max_forward+1));
+		goto await;
+	}
+
 	for (i=0; i<args->barrier_xmit_cnt; i++) {
 		if (args->barrier_xmit_ptr[i].port == 0)
 			continue;	/* already sent message to host */
@@ -260,6 +338,8 @@ static void *_agent(void *x)
 	verbose("Sent KVS info to %d nodes, up to %d tasks per node",
 		msg_sent, (max_forward+1));
 
+await:
+
 	/* wait for completion of all outgoing message */
 	slurm_mutex_lock(&agent_mutex);
 	while (agent_cnt > 0)
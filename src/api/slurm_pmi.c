@@ -331,34 +331,64 @@ int  slurm_get_kvs_comm_set(kvs_comm_set_t **kvs_set_ptr,
 
 /* Forward keypair info to other tasks as required.
  * Clear message forward structure upon completion.
- * The messages are forwarded sequentially. */
+ * The messages are forwarded sequentially.
+ *
+ * If the forward list is wider than PMI_FANOUT, split it into
+ * contiguous slices and hand each slice to its first entry, which
+ * repeats this process on receipt. The key-pairs then flow down a
+ * tree of depth log(tasks)/log(fanout) rather than this task
+ * contacting every entry itself. Tasks on a node occupy adjacent
+ * entries, so the slices keep most of the traffic on-node. */
 static int _forward_comm_set(kvs_comm_set_t *kvs_set_ptr)
 {
-	int i, rc = SLURM_SUCCESS;
+	int i, cnt, rc = SLURM_SUCCESS;
 	int tmp_host_cnt = kvs_set_ptr->host_cnt;
+	struct kvs_hosts *tmp_host_ptr = kvs_set_ptr->kvs_host_ptr;
+	int fanout = 32;
 	slurm_msg_t msg_send;
 	int msg_rc;
+	char *tmp;
 
-	kvs_set_ptr->host_cnt = 0;
-	for (i=0; i<tmp_host_cnt; i++) {
-		if (kvs_set_ptr->kvs_host_ptr[i].port == 0)
+	tmp = getenv("PMI_FANOUT");
+	if (tmp) {
+		fanout = atoi(tmp);
+		if (fanout < 1)
+			fanout = 32;
+	}
+
+	i = 0;
+	while (i < tmp_host_cnt) {
+		if (tmp_host_ptr[i].port == 0) {
+			i++;
 			continue;	/* empty */
+		}
+		if (tmp_host_cnt > fanout)
+			cnt = MIN((tmp_host_cnt + fanout - 1) / fanout,
+				  tmp_host_cnt - i);
+		else
+			cnt = 1;
+		kvs_set_ptr->kvs_host_ptr = tmp_host_ptr + i + 1;
+		kvs_set_ptr->host_cnt = cnt - 1;
 		slurm_msg_t_init(&msg_send);
 		msg_send.msg_type = PMI_KVS_GET_RESP;
 		msg_send.data = (void *) kvs_set_ptr;
 		slurm_set_addr(&msg_send.address,
-			kvs_set_ptr->kvs_host_ptr[i].port,
-			kvs_set_ptr->kvs_host_ptr[i].hostname);
+			tmp_host_ptr[i].port,
+			tmp_host_ptr[i].hostname);
 		if (slurm_send_recv_rc_msg_only_one(&msg_send,
 				&msg_rc, 0) < 0) {
 			error("Could not forward msg to %s",
-				kvs_set_ptr->kvs_host_ptr[i].hostname);
+				tmp_host_ptr[i].hostname);
 			msg_rc = 1;
 		}
 		rc = MAX(rc, msg_rc);
-		xfree(kvs_set_ptr->kvs_host_ptr[i].hostname);
+		i += cnt;
 	}
-	xfree(kvs_set_ptr->kvs_host_ptr);
+	for (i=0; i<tmp_host_cnt; i++)
+		xfree(tmp_host_ptr[i].hostname);
+	xfree(tmp_host_ptr);
+	kvs_set_ptr->kvs_host_ptr = NULL;
+	kvs_set_ptr->host_cnt = 0;
 	return rc;
 }
 
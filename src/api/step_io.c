@@ -35,6 +35,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
@@ -354,6 +355,23 @@ _server_read(eio_obj_t *obj, List objs)
 			list_enqueue(s->cio->free_outgoing, s->in_msg);
 			s->in_msg = NULL;
 			return SLURM_SUCCESS;
+		} else if (s->header.length > MAX_MSG_LEN) {
+			/* the receive buffers are sized for MAX_MSG_LEN,
+			 * never read a frame claiming to be larger */
+			error("%s: fd %d frame length %u exceeds limit %d",
+			      __func__, obj->fd, s->header.length,
+			      MAX_MSG_LEN);
+			if (s->cio->sls)
+				step_launch_notify_io_failure(
+					s->cio->sls, s->node_id);
+			if (obj->fd > STDERR_FILENO)
+				close(obj->fd);
+			obj->fd = -1;
+			s->in_eof = true;
+			s->out_eof = true;
+			list_enqueue(s->cio->free_outgoing, s->in_msg);
+			s->in_msg = NULL;
+			return SLURM_SUCCESS;
 		}
 		s->in_remaining = s->header.length;
 		s->in_msg->length = s->header.length;
@@ -553,6 +571,67 @@ create_file_write_eio_obj(int fd, uint32_t taskid, uint32_t nodeid,
 	return eio;
 }
 
+#define FILE_WRITE_IOV_CNT 64
+
+/* Write unlabelled, unfiltered output by gathering the pending message
+ * and as many queued messages as fit into one writev(), instead of one
+ * write() per frame. Fully written messages are freed; a partially
+ * written one resumes as out_msg and untouched ones return to the head
+ * of the queue in their original order. */
+static int _file_write_gather(eio_obj_t *obj)
+{
+	struct file_write_info *info = (struct file_write_info *) obj->arg;
+	struct io_buf *msgs[FILE_WRITE_IOV_CNT];
+	struct iovec iov[FILE_WRITE_IOV_CNT];
+	int cnt = 0, i, j, rc = SLURM_SUCCESS;
+	ssize_t n;
+
+	msgs[cnt] = info->out_msg;
+	iov[cnt].iov_base = info->out_msg->data +
+		(info->out_msg->length - info->out_remaining);
+	iov[cnt].iov_len = info->out_remaining;
+	cnt++;
+	while ((cnt < FILE_WRITE_IOV_CNT) &&
+	       (msgs[cnt] = list_dequeue(info->msg_queue))) {
+		iov[cnt].iov_base = msgs[cnt]->data;
+		iov[cnt].iov_len = msgs[cnt]->length;
+		cnt++;
+	}
+
+again:
+	if ((n = writev(obj->fd, iov, cnt)) < 0) {
+		if (errno == EINTR)
+			goto again;
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+			n = 0;
+		} else {
+			error("%s: writev failed: %m", __func__);
+			info->eof = true;
+			rc = SLURM_ERROR;
+		}
+	}
+	debug3("  wrote %zd bytes", n);
+
+	for (i = 0; i < cnt; i++) {
+		if ((rc == SLURM_SUCCESS) && (n < (ssize_t) iov[i].iov_len))
+			break;
+		/* fully written, or discarded after a write error */
+		if (rc == SLURM_SUCCESS)
+			n -= iov[i].iov_len;
+		msgs[i]->ref_count--;
+		if (msgs[i]->ref_count == 0)
+			list_enqueue(info->cio->free_outgoing, msgs[i]);
+	}
+	info->out_msg = NULL;
+	if ((rc == SLURM_SUCCESS) && (i < cnt)) {
+		info->out_msg = msgs[i];
+		info->out_remaining = iov[i].iov_len - n;
+		for (j = cnt - 1; j > i; j--)
+			list_push(info->msg_queue, msgs[j]);
+	}
+
+	return rc;
+}
 
 static bool _file_writable(eio_obj_t *obj)
 {
@@ -588,6 +667,12 @@ static int _file_write(eio_obj_t *obj, List objs)
 		info->out_remaining = info->out_msg->length;
 	}
 
+	/* Unlabelled output with no task filter needs no per-message
+	 * processing, flush as many messages as possible in one call */
+	if (!info->cio->label && (info->taskid == (uint32_t) -1) &&
+	    !info->eof)
+		return _file_write_gather(obj);
+
 	/*
 	 * Write message to file.
 	 */
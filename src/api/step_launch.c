@@ -107,13 +107,26 @@ static int    task_exit_signal = 0;
 static void _exec_prog(slurm_msg_t *msg);
 static int  _msg_thr_create(struct step_launch_state *sls, int num_nodes);
 static void _handle_msg(void *arg, slurm_msg_t *msg);
+static void _handle_msg_serialized(void *arg, slurm_msg_t *msg);
+static int  _ack_socket_accept(eio_obj_t *obj, List objs);
+static void *_ack_recv_worker(void *arg);
 static int  _cr_notify_step_launch(slurm_step_ctx_t *ctx);
 static void *_check_io_timeout(void *_sls);
 
+/* Receiver threads draining the launch response convergecast */
+#define ACK_RECV_THREADS 4
+
 static struct io_operations message_socket_ops = {
 	.readable = &eio_message_socket_readable,
 	.handle_read = &eio_message_socket_accept,
-	.handle_msg = &_handle_msg
+	.handle_msg = &_handle_msg_serialized
+};
+
+/* The response port sockets only get accepted here; the receiver pool
+ * does the reads so the eio thread never blocks on one connection */
+static struct io_operations ack_socket_ops = {
+	.readable = &eio_message_socket_readable,
+	.handle_read = &_ack_socket_accept,
 };
 
 
@@ -785,6 +798,17 @@ void slurm_step_launch_wait_finish(slurm_step_ctx_t *ctx)
 	slurm_mutex_unlock(&sls->lock);
 	if (sls->msg_thread)
 		pthread_join(sls->msg_thread, NULL);
+	if (sls->ack_tid) {
+		int i;
+		slurm_mutex_lock(&sls->ack_mutex);
+		sls->ack_shutdown = true;
+		slurm_cond_broadcast(&sls->ack_cond);
+		slurm_mutex_unlock(&sls->ack_mutex);
+		for (i = 0; i < ACK_RECV_THREADS; i++)
+			pthread_join(sls->ack_tid[i], NULL);
+		xfree(sls->ack_tid);
+		FREE_NULL_LIST(sls->ack_fds);
+	}
 	slurm_mutex_lock(&sls->lock);
 	pmi_kvs_free();
 
@@ -986,6 +1010,9 @@ struct step_launch_state *step_launch_state_create(slurm_step_ctx_t *ctx)
 	sls->mpi_state = NULL;
 	slurm_mutex_init(&sls->lock);
 	slurm_cond_init(&sls->cond, NULL);
+	slurm_mutex_init(&sls->ack_mutex);
+	slurm_cond_init(&sls->ack_cond, NULL);
+	slurm_mutex_init(&sls->dispatch_mutex);
 
 	for (ii = 0; ii < layout->node_cnt; ii++) {
 		sls->io_deadline[ii] = (time_t)NO_VAL;
@@ -1024,6 +1051,9 @@ void step_launch_state_destroy(struct step_launch_state *sls)
 	/* First undo anything created in step_launch_state_create() */
 	slurm_mutex_destroy(&sls->lock);
 	slurm_cond_destroy(&sls->cond);
+	slurm_mutex_destroy(&sls->ack_mutex);
+	slurm_cond_destroy(&sls->ack_cond);
+	slurm_mutex_destroy(&sls->dispatch_mutex);
 	FREE_NULL_BITMAP(sls->tasks_started);
 	FREE_NULL_BITMAP(sls->tasks_exited);
 	FREE_NULL_BITMAP(sls->node_io_error);
@@ -1140,6 +1170,78 @@ _estimate_nports(int nclients, int cli_per_port)
 	return d.rem > 0 ? d.quot + 1 : d.quot;
 }
 
+static void _ack_fd_del(void *x)
+{
+	int *fdp = (int *) x;
+
+	close(*fdp);
+	xfree(fdp);
+}
+
+/* Accept launch response connections and queue them for the receiver
+ * pool without reading them on the eio thread */
+static int _ack_socket_accept(eio_obj_t *obj, List objs)
+{
+	struct step_launch_state *sls = (struct step_launch_state *)obj->arg;
+	struct sockaddr_in addr;
+	int len = sizeof(addr);
+	int fd, *fdp;
+
+	memset(&addr, 0, sizeof(addr));
+	while ((fd = accept(obj->fd, (struct sockaddr *)&addr,
+			    (socklen_t *)&len)) >= 0) {
+		net_set_keep_alive(fd);
+		fd_set_close_on_exec(fd);
+		fd_set_blocking(fd);
+		fdp = xmalloc(sizeof(int));
+		*fdp = fd;
+		slurm_mutex_lock(&sls->ack_mutex);
+		list_enqueue(sls->ack_fds, fdp);
+		slurm_cond_signal(&sls->ack_cond);
+		slurm_mutex_unlock(&sls->ack_mutex);
+	}
+	if ((errno != EAGAIN) && (errno != EWOULDBLOCK) &&
+	    (errno != ECONNABORTED) && (errno != EINTR))
+		error("Error on msg accept socket: %m");
+
+	return SLURM_SUCCESS;
+}
+
+static void *_ack_recv_worker(void *arg)
+{
+	struct step_launch_state *sls = (struct step_launch_state *)arg;
+	slurm_msg_t *msg;
+	int *fdp, fd;
+
+	while (true) {
+		slurm_mutex_lock(&sls->ack_mutex);
+		while (!sls->ack_shutdown && !list_count(sls->ack_fds))
+			slurm_cond_wait(&sls->ack_cond, &sls->ack_mutex);
+		fdp = (int *) list_dequeue(sls->ack_fds);
+		slurm_mutex_unlock(&sls->ack_mutex);
+		if (!fdp)	/* shutdown with no work left */
+			break;
+		fd = *fdp;
+		xfree(fdp);
+
+		msg = xmalloc(sizeof(slurm_msg_t));
+		slurm_msg_t_init(msg);
+		if (slurm_receive_msg(fd, msg, message_socket_ops.timeout)) {
+			error("%s: slurm_receive_msg: %m", __func__);
+			close(fd);
+			slurm_free_msg(msg);
+			continue;
+		}
+		_handle_msg_serialized(sls, msg);
+		if ((msg->conn_fd >= STDERR_FILENO) &&
+		    (close(msg->conn_fd) < 0))
+			error("%s: close(%d): %m", __func__, msg->conn_fd);
+		slurm_free_msg(msg);
+	}
+
+	return NULL;
+}
+
 static int _msg_thr_create(struct step_launch_state *sls, int num_nodes)
 {
 	int sock = -1;
@@ -1163,6 +1265,12 @@ static int _msg_thr_create(struct step_launch_state *sls, int num_nodes)
 	if (!message_socket_ops.timeout)
 		message_socket_ops.timeout = slurm_get_msg_timeout() * 8000;
 
+	sls->ack_fds = list_create(_ack_fd_del);
+	sls->ack_shutdown = false;
+	sls->ack_tid = xmalloc(sizeof(pthread_t) * ACK_RECV_THREADS);
+	for (i = 0; i < ACK_RECV_THREADS; i++)
+		slurm_thread_create(&sls->ack_tid[i], _ack_recv_worker, sls);
+
 	ports = slurm_get_srun_port_range();
 	for (i = 0; i < sls->num_resp_port; i++) {
 		int cc;
@@ -1176,8 +1284,9 @@ static int _msg_thr_create(struct step_launch_state *sls, int num_nodes)
 			      "socket: %m");
 			return SLURM_ERROR;
 		}
+		fd_set_nonblocking(sock);
 		sls->resp_port[i] = port;
-		obj = eio_obj_create(sock, &message_socket_ops, (void *)sls);
+		obj = eio_obj_create(sock, &ack_socket_ops, (void *)sls);
 		eio_new_initial_obj(sls->msg_handle, obj);
 	}
 	/* finally, add the listening port that we told the slurmctld about
@@ -1563,6 +1672,18 @@ _task_user_managed_io_handler(struct step_launch_state *sls,
 /*
  * Identify the incoming message and call the appropriate handler function.
  */
+/* Keep the message handlers running one at a time whether a message
+ * arrived through the eio thread or the launch ack receiver pool */
+static void
+_handle_msg_serialized(void *arg, slurm_msg_t *msg)
+{
+	struct step_launch_state *sls = (struct step_launch_state *)arg;
+
+	slurm_mutex_lock(&sls->dispatch_mutex);
+	_handle_msg(arg, msg);
+	slurm_mutex_unlock(&sls->dispatch_mutex);
+}
+
 static void
 _handle_msg(void *arg, slurm_msg_t *msg)
 {
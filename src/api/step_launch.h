@@ -89,6 +89,18 @@ struct step_launch_state {
 	uint16_t num_resp_port;
 	uint16_t *resp_port; /* array of message response ports */
 
+	/* Receiver pool draining the launch responses converging from
+	   every node, so one slow peer cannot serialize the rest.
+	   Receives overlap across the pool; dispatch_mutex keeps the
+	   message handlers running one at a time as they did when the
+	   eio thread read every connection itself. */
+	pthread_mutex_t ack_mutex;
+	pthread_cond_t  ack_cond;
+	pthread_mutex_t dispatch_mutex;
+	List      ack_fds;	/* accepted, still unread connections */
+	pthread_t *ack_tid;	/* receiver pool, NULL if never started */
+	bool      ack_shutdown;
+
 	/* io variables */
 	bool user_managed_io;
 	union {
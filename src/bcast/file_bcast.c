@@ -82,15 +82,32 @@ int block_len;				/* block size */
 int fd;					/* source file descriptor */
 void *src;				/* source mmap'd address */
 struct stat f_stat;			/* source file stats */
+uint64_t file_digest;			/* digest of full file contents */
 job_sbcast_cred_msg_t *sbcast_cred;	/* job alloc info and sbcast cred */
 
 static int   _bcast_file(struct bcast_parameters *params);
 static int   _file_bcast(struct bcast_parameters *params,
 			 file_bcast_msg_t *bcast_msg,
-			 job_sbcast_cred_msg_t *sbcast_cred);
+			 job_sbcast_cred_msg_t *sbcast_cred,
+			 char **node_list);
 static int   _file_state(struct bcast_parameters *params);
 static int   _get_job_info(struct bcast_parameters *params);
 
+/* FNV-1a digest of the full source file. This identifies the content to
+ * slurmd, which can then skip the transfer for a destination file left
+ * in place by a prior broadcast of the same data. */
+static uint64_t _file_digest(void)
+{
+	uint64_t digest = 0xcbf29ce484222325;
+	unsigned char *position = src;
+	int64_t i;
+
+	for (i = 0; i < f_stat.st_size; i++) {
+		digest ^= position[i];
+		digest *= 0x100000001b3;
+	}
+	return digest;
+}
 
 static int _file_state(struct bcast_parameters *params)
 {
@@ -123,6 +140,7 @@ static int _file_state(struct bcast_parameters *params)
 		error("Can't mmap file `%s`, %m.", params->src_fname);
 		return SLURM_ERROR;
 	}
+	file_digest = _file_digest();
 
 	return SLURM_SUCCESS;
 }
@@ -178,14 +196,19 @@ static int _get_job_info(struct bcast_parameters *params)
 	return rc;
 }
 
-/* Issue the RPC to transfer the file's data */
+/* Issue the RPC to transfer the file's data.
+ * Nodes reporting that their destination file already matches the
+ * content digest from a prior broadcast are removed from "node_list"
+ * so the remaining blocks are not sent to them. */
 static int _file_bcast(struct bcast_parameters *params,
 		       file_bcast_msg_t *bcast_msg,
-		       job_sbcast_cred_msg_t *sbcast_cred)
+		       job_sbcast_cred_msg_t *sbcast_cred,
+		       char **node_list)
 {
 	List ret_list = NULL;
 	ListIterator itr;
 	ret_data_info_t *ret_data_info = NULL;
+	hostlist_t up_to_date = NULL;
 	int rc = 0, msg_rc;
 	slurm_msg_t msg;
 
@@ -194,7 +217,7 @@ static int _file_bcast(struct bcast_parameters *params,
 	msg.msg_type = REQUEST_FILE_BCAST;
 
 	ret_list = slurm_send_recv_msgs(
-		sbcast_cred->node_list, &msg, params->timeout, true);
+		*node_list, &msg, params->timeout, true);
 	if (ret_list == NULL) {
 		error("slurm_send_recv_msgs: %m");
 		exit(1);
@@ -206,6 +229,13 @@ static int _file_bcast(struct bcast_parameters *params,
 					       ret_data_info->data);
 		if (msg_rc == SLURM_SUCCESS)
 			continue;
+		if (msg_rc == ESLURMD_BCAST_FILE_UP_TO_DATE) {
+			if (!up_to_date)
+				up_to_date = hostlist_create(NULL);
+			hostlist_push_host(up_to_date,
+					   ret_data_info->node_name);
+			continue;
+		}
 
 		error("REQUEST_FILE_BCAST(%s): %s",
 		      ret_data_info->node_name,
@@ -215,6 +245,23 @@ static int _file_bcast(struct bcast_parameters *params,
 	list_iterator_destroy(itr);
 	FREE_NULL_LIST(ret_list);
 
+	if (up_to_date) {
+		hostlist_t hl = hostlist_create(*node_list);
+		char *name;
+
+		hostlist_uniq(up_to_date);
+		verbose("%d nodes already have `%s`, not sent",
+			hostlist_count(up_to_date), params->dst_fname);
+		while ((name = hostlist_shift(up_to_date))) {
+			hostlist_delete_host(hl, name);
+			free(name);
+		}
+		xfree(*node_list);
+		*node_list = hostlist_ranged_string_xmalloc(hl);
+		hostlist_destroy(hl);
+		hostlist_destroy(up_to_date);
+	}
+
 	return rc;
 }
 
@@ -383,6 +430,7 @@ static int _bcast_file(struct bcast_parameters *params)
 	int rc = SLURM_SUCCESS;
 	file_bcast_msg_t bcast_msg;
 	char *buffer = NULL;
+	char *node_list = NULL;
 	int32_t orig_len = 0;
 	uint64_t size_uncompressed = 0, size_compressed = 0;
 	uint32_t time_compression = 0;
@@ -403,7 +451,9 @@ static int _bcast_file(struct bcast_parameters *params)
 	bcast_msg.user_name	= uid_to_string(f_stat.st_uid);
 	bcast_msg.gid		= f_stat.st_gid;
 	bcast_msg.file_size	= f_stat.st_size;
+	bcast_msg.file_digest	= file_digest;
 	bcast_msg.cred          = sbcast_cred->sbcast_cred;
+	node_list		= xstrdup(sbcast_cred->node_list);
 
 	if (params->preserve) {
 		bcast_msg.atime     = f_stat.st_atime;
@@ -430,15 +480,21 @@ static int _bcast_file(struct bcast_parameters *params)
 		if (!more)
 			bcast_msg.last_block = 1;
 
-		rc = _file_bcast(params, &bcast_msg, sbcast_cred);
+		rc = _file_bcast(params, &bcast_msg, sbcast_cred, &node_list);
 		if (rc != SLURM_SUCCESS)
 			break;
 		if (bcast_msg.last_block)
 			break;	/* end of file */
+		if (!node_list || (node_list[0] == '\0')) {
+			verbose("all nodes already have `%s`",
+				params->dst_fname);
+			break;
+		}
 		bcast_msg.block_no++;
 		bcast_msg.block_offset += orig_len;
 	}
 	xfree(bcast_msg.user_name);
+	xfree(node_list);
 	xfree(buffer);
 
 	if (size_uncompressed && (params->compress != 0)) {
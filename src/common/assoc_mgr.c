@@ -51,7 +51,7 @@
 #include "src/slurmdbd/read_config.h"
 
 #define ASSOC_HASH_SIZE 1000
-#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % ASSOC_HASH_SIZE)
+#define ASSOC_HASH_ID_INX(_assoc_id)	(_assoc_id % assoc_hash_size)
 
 slurmdb_assoc_rec_t *assoc_mgr_root_assoc = NULL;
 uint32_t g_qos_max_priority = 0;
@@ -69,13 +69,68 @@ List assoc_mgr_qos_list = NULL;
 List assoc_mgr_user_list = NULL;
 List assoc_mgr_wckey_list = NULL;
 
+/*
+ * QOS records indexed directly by id (ids are small and dense), rebuilt
+ * whenever assoc_mgr_qos_list changes.  Lets the per-job limit checks
+ * find a QOS in O(1) instead of scanning the list.
+ */
+static slurmdb_qos_rec_t **assoc_mgr_qos_array = NULL;
+
+/*
+ * TRES id -> assoc_mgr_tres_array position, rebuilt with the TRES array
+ * in assoc_mgr_post_tres_list().  TRES ids are small database serials,
+ * so a direct map lets the id lookups done while converting TRES
+ * strings to count arrays run in O(1) instead of scanning the array.
+ */
+static int *assoc_mgr_tres_id2pos = NULL;
+static uint32_t assoc_mgr_tres_id2pos_size = 0;
+
 static char *assoc_mgr_cluster_name = NULL;
 static int setup_children = 0;
-static pthread_rwlock_t assoc_mgr_locks[ASSOC_MGR_ENTITY_COUNT];
+
+/*
+ * Snapshot of assoc_shares_object_t records for every association, used to
+ * answer REQUEST_SHARE_INFO without walking the association list under
+ * assoc_mgr locks for each RPC. The snapshot is rebuilt when marked dirty
+ * (association or TRES updates, each priority decay cycle) or when older
+ * than PriorityCalcPeriod as a backstop, since fields like the running
+ * TRES seconds drift between decay cycles.
+ */
+static pthread_mutex_t shares_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static List shares_cache_list = NULL;
+static time_t shares_cache_time = (time_t) 0;
+static uint32_t shares_cache_tres_cnt = 0;
+static char **shares_cache_tres_names = NULL;
+static volatile bool shares_cache_dirty = true;
+
+/*
+ * Each entity lock is split into shards so that concurrent readers do
+ * not all hammer the same rwlock.  A reader takes only the one shard
+ * selected from its thread id while a writer sweeps every shard, so
+ * read acquisitions from different threads touch different cache lines
+ * and limit checks against the association and QOS data can proceed in
+ * parallel.  The union pads each shard out to its own cache line.
+ */
+#define ASSOC_MGR_LOCK_SHARDS 8
+
+typedef union {
+	pthread_rwlock_t lock;
+	char pad[128];
+} assoc_mgr_lock_shard_t;
+
+static assoc_mgr_lock_shard_t
+	assoc_mgr_locks[ASSOC_MGR_ENTITY_COUNT][ASSOC_MGR_LOCK_SHARDS];
 
 static assoc_init_args_t init_setup;
 static slurmdb_assoc_rec_t **assoc_hash_id = NULL;
 static slurmdb_assoc_rec_t **assoc_hash = NULL;
+/*
+ * Sized from the association count when the hash tables are rebuilt so
+ * the chains stay around one entry regardless of how many associations
+ * the cluster carries.  Only changed while both tables are freed, since
+ * an entry must be removed from the same bucket it was added to.
+ */
+static int assoc_hash_size = ASSOC_HASH_SIZE;
 static int *assoc_mgr_tres_old_pos = NULL;
 
 static bool _running_cache(void)
@@ -121,9 +176,9 @@ static int _assoc_hash_index(slurmdb_assoc_rec_t *assoc)
 	if (assoc->partition)
 		index += _get_str_inx(assoc->partition);
 
-	index %= ASSOC_HASH_SIZE;
+	index %= assoc_hash_size;
 	if (index < 0)
-		index += ASSOC_HASH_SIZE;
+		index += assoc_hash_size;
 
 	return index;
 
@@ -134,10 +189,10 @@ static void _add_assoc_hash(slurmdb_assoc_rec_t *assoc)
 	int inx = ASSOC_HASH_ID_INX(assoc->id);
 
 	if (!assoc_hash_id)
-		assoc_hash_id = xcalloc(ASSOC_HASH_SIZE,
+		assoc_hash_id = xcalloc(assoc_hash_size,
 					sizeof(slurmdb_assoc_rec_t *));
 	if (!assoc_hash)
-		assoc_hash = xcalloc(ASSOC_HASH_SIZE,
+		assoc_hash = xcalloc(assoc_hash_size,
 				     sizeof(slurmdb_assoc_rec_t *));
 
 	assoc->assoc_next_id = assoc_hash_id[inx];
@@ -986,6 +1041,38 @@ static void _set_children_level_shares(slurmdb_assoc_rec_t *assoc,
 }
 
 /* transfer slurmdb assoc list to be assoc_mgr assoc list */
+/*
+ * Record which scheduling limits are set on each association or
+ * anywhere in its parent chain, so the limit checks in the slurmctld
+ * can skip the chain walk for the common association with no limits.
+ * Called whenever associations are loaded or updated.
+ */
+static void _set_lineage_limit_bits(void)
+{
+	slurmdb_assoc_rec_t *assoc, *ptr;
+	ListIterator itr;
+	uint16_t bits;
+
+	xassert(verify_assoc_lock(ASSOC_LOCK, WRITE_LOCK));
+
+	itr = list_iterator_create(assoc_mgr_assoc_list);
+	while ((assoc = list_next(itr))) {
+		bits = 0;
+		for (ptr = assoc; ptr; ptr = ptr->usage->parent_assoc_ptr) {
+			if (ptr->grp_jobs != INFINITE)
+				bits |= SLURMDB_LINEAGE_LIMIT_GRP_JOBS;
+			if (ptr->grp_wall != INFINITE)
+				bits |= SLURMDB_LINEAGE_LIMIT_GRP_WALL;
+			if (ptr->max_jobs != INFINITE)
+				bits |= SLURMDB_LINEAGE_LIMIT_MAX_JOBS;
+			if (ptr->max_wall_pj != INFINITE)
+				bits |= SLURMDB_LINEAGE_LIMIT_MAX_WALL;
+		}
+		assoc->usage->lineage_limits = bits;
+	}
+	list_iterator_destroy(itr);
+}
+
 static int _post_assoc_list(void)
 {
 	slurmdb_assoc_rec_t *assoc = NULL;
@@ -1004,6 +1091,8 @@ static int _post_assoc_list(void)
 
 	xfree(assoc_hash_id);
 	xfree(assoc_hash);
+	assoc_hash_size = MAX(ASSOC_HASH_SIZE,
+			      list_count(assoc_mgr_assoc_list));
 
 	itr = list_iterator_create(assoc_mgr_assoc_list);
 
@@ -1037,6 +1126,8 @@ static int _post_assoc_list(void)
 
 	_calculate_assoc_norm_priorities(true);
 
+	_set_lineage_limit_bits();
+
 	slurmdb_sort_hierarchical_assoc_list(assoc_mgr_assoc_list, true);
 
 	//END_TIMER2("load_associations");
@@ -1093,6 +1184,30 @@ static int _post_wckey_list(List wckey_list)
 }
 
 /* NOTE QOS write lock needs to be set before calling this. */
+/*
+ * Rebuild the id -> record index.  Must be called with the QOS write
+ * lock held (or before the lists are reachable) every time qos_list
+ * gains, loses or renumbers a record.
+ */
+static void _post_qos_array(List qos_list)
+{
+	slurmdb_qos_rec_t *qos = NULL;
+	ListIterator itr;
+
+	xfree(assoc_mgr_qos_array);
+	if (!qos_list || !g_qos_count)
+		return;
+
+	assoc_mgr_qos_array = xcalloc(g_qos_count,
+				      sizeof(slurmdb_qos_rec_t *));
+	itr = list_iterator_create(qos_list);
+	while ((qos = list_next(itr))) {
+		if (qos->id < g_qos_count)
+			assoc_mgr_qos_array[qos->id] = qos;
+	}
+	list_iterator_destroy(itr);
+}
+
 static int _post_qos_list(List qos_list)
 {
 	slurmdb_qos_rec_t *qos = NULL;
@@ -1131,6 +1246,8 @@ static int _post_qos_list(List qos_list)
 	}
 	list_iterator_destroy(itr);
 
+	_post_qos_array(qos_list);
+
 	return SLURM_SUCCESS;
 }
 
@@ -1296,6 +1413,17 @@ extern int assoc_mgr_post_tres_list(List new_list)
 
 	g_tres_count = new_cnt;
 
+	/* Rebuild the id -> position index (list is sorted by id) */
+	xfree(assoc_mgr_tres_id2pos);
+	assoc_mgr_tres_id2pos_size =
+		assoc_mgr_tres_array[new_cnt - 1]->id + 1;
+	assoc_mgr_tres_id2pos = xmalloc(assoc_mgr_tres_id2pos_size *
+					sizeof(int));
+	for (i = 0; i < assoc_mgr_tres_id2pos_size; i++)
+		assoc_mgr_tres_id2pos[i] = -1;
+	for (i = 0; i < new_cnt; i++)
+		assoc_mgr_tres_id2pos[assoc_mgr_tres_array[i]->id] = i;
+
 	if ((changed_size || changed_pos) &&
 	    assoc_mgr_assoc_list && assoc_mgr_qos_list) {
 		uint64_t grp_used_tres[new_cnt],
@@ -1466,6 +1594,8 @@ extern int assoc_mgr_post_tres_list(List new_list)
 		list_iterator_destroy(itr);
 	}
 
+	assoc_mgr_clear_shares_cache();
+
 	return (changed_size || changed_pos) ? 1 : 0;
 }
 
@@ -2071,6 +2201,18 @@ extern int assoc_mgr_fini(bool save_state)
 	if (save_state)
 		dump_assoc_mgr_state();
 
+	slurm_mutex_lock(&shares_cache_mutex);
+	FREE_NULL_LIST(shares_cache_list);
+	if (shares_cache_tres_names) {
+		int i;
+		for (i = 0; i < shares_cache_tres_cnt; i++)
+			xfree(shares_cache_tres_names[i]);
+		xfree(shares_cache_tres_names);
+	}
+	shares_cache_tres_cnt = 0;
+	shares_cache_dirty = true;
+	slurm_mutex_unlock(&shares_cache_mutex);
+
 	assoc_mgr_lock(&locks);
 
 	FREE_NULL_LIST(assoc_mgr_assoc_list);
@@ -2087,6 +2229,9 @@ extern int assoc_mgr_fini(bool save_state)
 	}
 	xfree(assoc_mgr_tres_array);
 	xfree(assoc_mgr_tres_old_pos);
+	xfree(assoc_mgr_tres_id2pos);
+	assoc_mgr_tres_id2pos_size = 0;
+	xfree(assoc_mgr_qos_array);
 	xfree(assoc_mgr_cluster_name);
 	assoc_mgr_assoc_list = NULL;
 	assoc_mgr_res_list = NULL;
@@ -2101,6 +2246,7 @@ extern int assoc_mgr_fini(bool save_state)
 
 	xfree(assoc_hash_id);
 	xfree(assoc_hash);
+	assoc_hash_size = ASSOC_HASH_SIZE;
 
 	assoc_mgr_unlock(&locks);
 
@@ -2160,77 +2306,78 @@ bool verify_assoc_lock(assoc_mgr_lock_datatype_t datatype, lock_level_t level)
 }
 #endif
 
+/*
+ * Pick the lock shard for the calling thread.  Thread ids are pointers
+ * on most systems and tend to differ only in a few middle bits, so mix
+ * the whole word before folding it down.  The result only has to be
+ * stable for the life of the thread so that assoc_mgr_unlock() releases
+ * the same shard assoc_mgr_lock() acquired.
+ */
+static int _lock_shard(void)
+{
+	uint64_t tid = (uint64_t) (uintptr_t) pthread_self();
+
+	tid ^= tid >> 33;
+	tid *= 0xff51afd7ed558ccd;
+	tid ^= tid >> 29;
+
+	return (int) (tid % ASSOC_MGR_LOCK_SHARDS);
+}
+
 extern void assoc_mgr_lock(assoc_mgr_lock_t *locks)
 {
 	static bool init_run = false;
+	static pthread_mutex_t init_mutex = PTHREAD_MUTEX_INITIALIZER;
+	lock_level_t *lock_levels = (lock_level_t *) locks;
+	int shard = _lock_shard();
+
 	xassert(_store_locks(locks));
 
 	if (!init_run) {
-		init_run = true;
-		for (int i = 0; i < ASSOC_MGR_ENTITY_COUNT; i++)
-			slurm_rwlock_init(&assoc_mgr_locks[i]);
-	}
-
-	if (locks->assoc == READ_LOCK)
-		slurm_rwlock_rdlock(&assoc_mgr_locks[ASSOC_LOCK]);
-	else if (locks->assoc == WRITE_LOCK)
-		slurm_rwlock_wrlock(&assoc_mgr_locks[ASSOC_LOCK]);
-
-	if (locks->file == READ_LOCK)
-		slurm_rwlock_rdlock(&assoc_mgr_locks[FILE_LOCK]);
-	else if (locks->file == WRITE_LOCK)
-		slurm_rwlock_wrlock(&assoc_mgr_locks[FILE_LOCK]);
-
-	if (locks->qos == READ_LOCK)
-		slurm_rwlock_rdlock(&assoc_mgr_locks[QOS_LOCK]);
-	else if (locks->qos == WRITE_LOCK)
-		slurm_rwlock_wrlock(&assoc_mgr_locks[QOS_LOCK]);
-
-	if (locks->res == READ_LOCK)
-		slurm_rwlock_rdlock(&assoc_mgr_locks[RES_LOCK]);
-	else if (locks->res == WRITE_LOCK)
-		slurm_rwlock_wrlock(&assoc_mgr_locks[RES_LOCK]);
-
-	if (locks->tres == READ_LOCK)
-		slurm_rwlock_rdlock(&assoc_mgr_locks[TRES_LOCK]);
-	else if (locks->tres == WRITE_LOCK)
-		slurm_rwlock_wrlock(&assoc_mgr_locks[TRES_LOCK]);
-
-	if (locks->user == READ_LOCK)
-		slurm_rwlock_rdlock(&assoc_mgr_locks[USER_LOCK]);
-	else if (locks->user == WRITE_LOCK)
-		slurm_rwlock_wrlock(&assoc_mgr_locks[USER_LOCK]);
-
-	if (locks->wckey == READ_LOCK)
-		slurm_rwlock_rdlock(&assoc_mgr_locks[WCKEY_LOCK]);
-	else if (locks->wckey == WRITE_LOCK)
-		slurm_rwlock_wrlock(&assoc_mgr_locks[WCKEY_LOCK]);
+		slurm_mutex_lock(&init_mutex);
+		if (!init_run) {
+			for (int i = 0; i < ASSOC_MGR_ENTITY_COUNT; i++) {
+				for (int j = 0; j < ASSOC_MGR_LOCK_SHARDS; j++)
+					slurm_rwlock_init(
+						&assoc_mgr_locks[i][j].lock);
+			}
+			init_run = true;
+		}
+		slurm_mutex_unlock(&init_mutex);
+	}
+
+	for (int i = 0; i < ASSOC_MGR_ENTITY_COUNT; i++) {
+		if (lock_levels[i] == READ_LOCK) {
+			slurm_rwlock_rdlock(&assoc_mgr_locks[i][shard].lock);
+		} else if (lock_levels[i] == WRITE_LOCK) {
+			/*
+			 * Writers take every shard in ascending order so
+			 * they exclude all readers without deadlocking
+			 * against other writers.
+			 */
+			for (int j = 0; j < ASSOC_MGR_LOCK_SHARDS; j++)
+				slurm_rwlock_wrlock(
+					&assoc_mgr_locks[i][j].lock);
+		}
+	}
 }
 
 extern void assoc_mgr_unlock(assoc_mgr_lock_t *locks)
 {
-	xassert(_clear_locks(locks));
-
-	if (locks->wckey)
-		slurm_rwlock_unlock(&assoc_mgr_locks[WCKEY_LOCK]);
-
-	if (locks->user)
-		slurm_rwlock_unlock(&assoc_mgr_locks[USER_LOCK]);
-
-	if (locks->tres)
-		slurm_rwlock_unlock(&assoc_mgr_locks[TRES_LOCK]);
-
-	if (locks->res)
-		slurm_rwlock_unlock(&assoc_mgr_locks[RES_LOCK]);
-
-	if (locks->qos)
-		slurm_rwlock_unlock(&assoc_mgr_locks[QOS_LOCK]);
+	lock_level_t *lock_levels = (lock_level_t *) locks;
+	int shard = _lock_shard();
 
-	if (locks->file)
-		slurm_rwlock_unlock(&assoc_mgr_locks[FILE_LOCK]);
+	xassert(_clear_locks(locks));
 
-	if (locks->assoc)
-		slurm_rwlock_unlock(&assoc_mgr_locks[ASSOC_LOCK]);
+	for (int i = ASSOC_MGR_ENTITY_COUNT - 1; i >= 0; i--) {
+		if (lock_levels[i] == READ_LOCK) {
+			slurm_rwlock_unlock(&assoc_mgr_locks[i][shard].lock);
+		} else if (lock_levels[i] == WRITE_LOCK) {
+			for (int j = ASSOC_MGR_LOCK_SHARDS - 1; j >= 0; j--)
+				slurm_rwlock_unlock(
+					&assoc_mgr_locks[i][j].lock);
+		}
+	}
 }
 
 /* Since the returned assoc_list is full of pointers from the
@@ -2674,6 +2821,21 @@ extern int assoc_mgr_fill_in_user(void *db_conn, slurmdb_user_rec_t *user,
 
 }
 
+/*
+ * Find a QOS record by id in O(1).
+ * Caller must hold the QOS read lock; the returned pointer is only
+ * valid while that lock is held.
+ */
+extern slurmdb_qos_rec_t *assoc_mgr_find_qos_rec_by_id(uint32_t qos_id)
+{
+	xassert(verify_assoc_lock(QOS_LOCK, READ_LOCK));
+
+	if (!assoc_mgr_qos_array || (qos_id >= g_qos_count))
+		return NULL;
+
+	return assoc_mgr_qos_array[qos_id];
+}
+
 extern int assoc_mgr_fill_in_qos(void *db_conn, slurmdb_qos_rec_t *qos,
 				 int enforce,
 				 slurmdb_qos_rec_t **qos_pptr, bool locked)
@@ -2713,14 +2875,17 @@ extern int assoc_mgr_fill_in_qos(void *db_conn, slurmdb_qos_rec_t *qos,
 		return SLURM_SUCCESS;
 	}
 
-	itr = list_iterator_create(assoc_mgr_qos_list);
-	while ((found_qos = list_next(itr))) {
-		if (qos->id == found_qos->id)
-			break;
-		else if (qos->name && !xstrcasecmp(qos->name, found_qos->name))
-			break;
+	if (qos->id)
+		found_qos = assoc_mgr_find_qos_rec_by_id(qos->id);
+
+	if (!found_qos && qos->name) {
+		itr = list_iterator_create(assoc_mgr_qos_list);
+		while ((found_qos = list_next(itr))) {
+			if (!xstrcasecmp(qos->name, found_qos->name))
+				break;
+		}
+		list_iterator_destroy(itr);
 	}
-	list_iterator_destroy(itr);
 
 	if (!found_qos) {
 		if (!locked)
@@ -3073,6 +3238,140 @@ extern bool assoc_mgr_is_user_acct_coord(void *db_conn,
 	return false;
 }
 
+/* Build one share object from an association.
+ * Caller must hold assoc_mgr read locks on assoc and tres. */
+static assoc_shares_object_t *_build_shares_object(slurmdb_assoc_rec_t *assoc)
+{
+	assoc_shares_object_t *share =
+		xmalloc(sizeof(assoc_shares_object_t));
+
+	share->assoc_id = assoc->id;
+	share->cluster = xstrdup(assoc->cluster);
+
+	if (assoc == assoc_mgr_root_assoc)
+		share->shares_raw = NO_VAL;
+	else
+		share->shares_raw = assoc->shares_raw;
+
+	share->shares_norm = assoc->usage->shares_norm;
+	share->usage_raw = (uint64_t)assoc->usage->usage_raw;
+
+	share->usage_tres_raw = xcalloc(g_tres_count, sizeof(long double));
+	memcpy(share->usage_tres_raw,
+	       assoc->usage->usage_tres_raw,
+	       sizeof(long double) * g_tres_count);
+
+	share->tres_grp_mins = xcalloc(g_tres_count, sizeof(uint64_t));
+	memcpy(share->tres_grp_mins, assoc->grp_tres_mins_ctld,
+	       sizeof(uint64_t) * g_tres_count);
+	share->tres_run_secs = xcalloc(g_tres_count, sizeof(uint64_t));
+	memcpy(share->tres_run_secs,
+	       assoc->usage->grp_used_tres_run_secs,
+	       sizeof(uint64_t) * g_tres_count);
+	share->fs_factor = assoc->usage->fs_factor;
+	share->level_fs = assoc->usage->level_fs;
+
+	if (assoc->partition) {
+		share->partition =  xstrdup(assoc->partition);
+	} else {
+		share->partition = NULL;
+	}
+
+	if (assoc->user) {
+		/* We only calculate user effective usage when
+		 * we need it
+		 */
+		if (fuzzy_equal(assoc->usage->usage_efctv, NO_VAL))
+			priority_g_set_assoc_usage(assoc);
+
+		share->name = xstrdup(assoc->user);
+		share->parent = xstrdup(assoc->acct);
+		share->user = 1;
+	} else {
+		share->name = xstrdup(assoc->acct);
+		if (!assoc->parent_acct
+		    && assoc->usage->parent_assoc_ptr)
+			share->parent = xstrdup(
+				assoc->usage->parent_assoc_ptr->acct);
+		else
+			share->parent = xstrdup(assoc->parent_acct);
+	}
+	share->usage_norm = (double)assoc->usage->usage_norm;
+	share->usage_efctv = (double)assoc->usage->usage_efctv;
+
+	return share;
+}
+
+/* Copy a share object out of the snapshot.
+ * Caller must hold shares_cache_mutex. */
+static assoc_shares_object_t *_dup_shares_object(assoc_shares_object_t *src)
+{
+	assoc_shares_object_t *share =
+		xmalloc(sizeof(assoc_shares_object_t));
+
+	memcpy(share, src, sizeof(assoc_shares_object_t));
+	share->cluster = xstrdup(src->cluster);
+	share->name = xstrdup(src->name);
+	share->parent = xstrdup(src->parent);
+	share->partition = xstrdup(src->partition);
+
+	share->usage_tres_raw = xcalloc(shares_cache_tres_cnt,
+					sizeof(long double));
+	memcpy(share->usage_tres_raw, src->usage_tres_raw,
+	       sizeof(long double) * shares_cache_tres_cnt);
+	share->tres_grp_mins = xcalloc(shares_cache_tres_cnt,
+				       sizeof(uint64_t));
+	memcpy(share->tres_grp_mins, src->tres_grp_mins,
+	       sizeof(uint64_t) * shares_cache_tres_cnt);
+	share->tres_run_secs = xcalloc(shares_cache_tres_cnt,
+				       sizeof(uint64_t));
+	memcpy(share->tres_run_secs, src->tres_run_secs,
+	       sizeof(uint64_t) * shares_cache_tres_cnt);
+
+	return share;
+}
+
+/* Rebuild the shares snapshot from the association list.
+ * Caller must hold shares_cache_mutex and no assoc_mgr locks. */
+static void _build_shares_cache(void)
+{
+	ListIterator itr;
+	slurmdb_assoc_rec_t *assoc;
+	uint32_t i;
+	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .tres = READ_LOCK };
+
+	/* An update applied while we rebuild will set this again and the
+	 * next request rebuilds once more. */
+	shares_cache_dirty = false;
+
+	FREE_NULL_LIST(shares_cache_list);
+	if (shares_cache_tres_names) {
+		for (i = 0; i < shares_cache_tres_cnt; i++)
+			xfree(shares_cache_tres_names[i]);
+		xfree(shares_cache_tres_names);
+	}
+	shares_cache_list = list_create(slurm_destroy_assoc_shares_object);
+
+	assoc_mgr_lock(&locks);
+	shares_cache_tres_cnt = g_tres_count;
+	shares_cache_tres_names = xcalloc(g_tres_count, sizeof(char *));
+	for (i = 0; i < g_tres_count; i++)
+		shares_cache_tres_names[i] =
+			xstrdup(assoc_mgr_tres_name_array[i]);
+	itr = list_iterator_create(assoc_mgr_assoc_list);
+	while ((assoc = list_next(itr)))
+		list_append(shares_cache_list, _build_shares_object(assoc));
+	list_iterator_destroy(itr);
+	assoc_mgr_unlock(&locks);
+
+	shares_cache_time = time(NULL);
+}
+
+extern void assoc_mgr_clear_shares_cache(void)
+{
+	shares_cache_dirty = true;
+}
+
 extern void assoc_mgr_get_shares(void *db_conn,
 				 uid_t uid, shares_request_msg_t *req_msg,
 				 shares_response_msg_t *resp_msg)
@@ -3080,14 +3379,13 @@ extern void assoc_mgr_get_shares(void *db_conn,
 	ListIterator itr = NULL;
 	ListIterator user_itr = NULL;
 	ListIterator acct_itr = NULL;
-	slurmdb_assoc_rec_t *assoc = NULL;
 	assoc_shares_object_t *share = NULL;
 	List ret_list = NULL;
 	char *tmp_char = NULL;
 	slurmdb_user_rec_t user;
 	int is_admin=1;
+	uint32_t i, calc_period;
 	uint16_t private_data = slurm_get_private_data();
-	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .tres = READ_LOCK };
 
 	xassert(resp_msg);
 
@@ -3128,20 +3426,29 @@ extern void assoc_mgr_get_shares(void *db_conn,
 	resp_msg->assoc_shares_list = ret_list =
 		list_create(slurm_destroy_assoc_shares_object);
 
-	assoc_mgr_lock(&locks);
+	calc_period = slurm_get_priority_calc_period();
 
-	resp_msg->tres_cnt = g_tres_count;
+	slurm_mutex_lock(&shares_cache_mutex);
 
-	/* DON'T FREE, since this shouldn't change while the slurmctld
-	 * is running we should be ok.
-	*/
-	resp_msg->tres_names = assoc_mgr_tres_name_array;
+	if (shares_cache_dirty || !shares_cache_list ||
+	    (difftime(time(NULL), shares_cache_time) >= calc_period))
+		_build_shares_cache();
 
-	itr = list_iterator_create(assoc_mgr_assoc_list);
-	while ((assoc = list_next(itr))) {
-		if (user_itr && assoc->user) {
+	resp_msg->tres_cnt = shares_cache_tres_cnt;
+	resp_msg->tres_names = xcalloc(shares_cache_tres_cnt,
+				       sizeof(char *));
+	for (i = 0; i < shares_cache_tres_cnt; i++)
+		resp_msg->tres_names[i] = xstrdup(shares_cache_tres_names[i]);
+
+	itr = list_iterator_create(shares_cache_list);
+	while ((share = list_next(itr))) {
+		/* The account of the underlying association: for user
+		 * associations the parent is always the account. */
+		char *acct = share->user ? share->parent : share->name;
+
+		if (user_itr && share->user) {
 			while ((tmp_char = list_next(user_itr))) {
-				if (!xstrcasecmp(tmp_char, assoc->user))
+				if (!xstrcasecmp(tmp_char, share->name))
 					break;
 			}
 			list_iterator_reset(user_itr);
@@ -3152,7 +3459,7 @@ extern void assoc_mgr_get_shares(void *db_conn,
 
 		if (acct_itr) {
 			while ((tmp_char = list_next(acct_itr))) {
-				if (!xstrcasecmp(tmp_char, assoc->acct))
+				if (!xstrcasecmp(tmp_char, acct))
 					break;
 			}
 			list_iterator_reset(acct_itr);
@@ -3163,11 +3470,11 @@ extern void assoc_mgr_get_shares(void *db_conn,
 
 		if (private_data & PRIVATE_DATA_USAGE) {
 			if (!is_admin) {
-				ListIterator itr = NULL;
+				ListIterator citr = NULL;
 				slurmdb_coord_rec_t *coord = NULL;
 
-				if (assoc->user &&
-				    !xstrcmp(assoc->user, user.name))
+				if (share->user &&
+				    !xstrcmp(share->name, user.name))
 					goto is_user;
 
 				if (!user.coord_accts) {
@@ -3175,19 +3482,18 @@ extern void assoc_mgr_get_shares(void *db_conn,
 					goto bad_user;
 				}
 
-				if (!assoc->acct) {
+				if (!acct) {
 					debug("No account name given "
 					      "in association.");
 					goto bad_user;
 				}
 
-				itr = list_iterator_create(user.coord_accts);
-				while ((coord = list_next(itr))) {
-					if (!xstrcasecmp(coord->name,
-							 assoc->acct))
+				citr = list_iterator_create(user.coord_accts);
+				while ((coord = list_next(citr))) {
+					if (!xstrcasecmp(coord->name, acct))
 						break;
 				}
-				list_iterator_destroy(itr);
+				list_iterator_destroy(citr);
 
 				if (coord)
 					goto is_user;
@@ -3198,66 +3504,10 @@ extern void assoc_mgr_get_shares(void *db_conn,
 		}
 	is_user:
 
-		share = xmalloc(sizeof(assoc_shares_object_t));
-		list_append(ret_list, share);
-
-		share->assoc_id = assoc->id;
-		share->cluster = xstrdup(assoc->cluster);
-
-		if (assoc == assoc_mgr_root_assoc)
-			share->shares_raw = NO_VAL;
-		else
-			share->shares_raw = assoc->shares_raw;
-
-		share->shares_norm = assoc->usage->shares_norm;
-		share->usage_raw = (uint64_t)assoc->usage->usage_raw;
-
-		share->usage_tres_raw = xcalloc(g_tres_count,
-						sizeof(long double));
-		memcpy(share->usage_tres_raw,
-		       assoc->usage->usage_tres_raw,
-		       sizeof(long double) * g_tres_count);
-
-		share->tres_grp_mins = xcalloc(g_tres_count, sizeof(uint64_t));
-		memcpy(share->tres_grp_mins, assoc->grp_tres_mins_ctld,
-		       sizeof(uint64_t) * g_tres_count);
-		share->tres_run_secs = xcalloc(g_tres_count, sizeof(uint64_t));
-		memcpy(share->tres_run_secs,
-		       assoc->usage->grp_used_tres_run_secs,
-		       sizeof(uint64_t) * g_tres_count);
-		share->fs_factor = assoc->usage->fs_factor;
-		share->level_fs = assoc->usage->level_fs;
-
-		if (assoc->partition) {
-			share->partition =  xstrdup(assoc->partition);
-		} else {
-			share->partition = NULL;
-		}
-
-		if (assoc->user) {
-			/* We only calculate user effective usage when
-			 * we need it
-			 */
-			if (fuzzy_equal(assoc->usage->usage_efctv, NO_VAL))
-				priority_g_set_assoc_usage(assoc);
-
-			share->name = xstrdup(assoc->user);
-			share->parent = xstrdup(assoc->acct);
-			share->user = 1;
-		} else {
-			share->name = xstrdup(assoc->acct);
-			if (!assoc->parent_acct
-			    && assoc->usage->parent_assoc_ptr)
-				share->parent = xstrdup(
-					assoc->usage->parent_assoc_ptr->acct);
-			else
-				share->parent = xstrdup(assoc->parent_acct);
-		}
-		share->usage_norm = (double)assoc->usage->usage_norm;
-		share->usage_efctv = (double)assoc->usage->usage_efctv;
+		list_append(ret_list, _dup_shares_object(share));
 	}
 	list_iterator_destroy(itr);
-	assoc_mgr_unlock(&locks);
+	slurm_mutex_unlock(&shares_cache_mutex);
 end_it:
 	if (user_itr)
 		list_iterator_destroy(user_itr);
@@ -3579,9 +3829,29 @@ extern int assoc_mgr_update(List update_list, bool locked)
 	int rc = SLURM_SUCCESS;
 	ListIterator itr = NULL;
 	slurmdb_update_object_t *object = NULL;
+	slurmdb_update_object_t *prev_object = NULL;
 
 	xassert(update_list);
+
+	/*
+	 * The dbd agent can stream many batches of the same type in one
+	 * message (e.g. one MODIFY_ASSOC object per commit of a mass
+	 * change).  Each batch costs a write-lock cycle and a full
+	 * derived-state recompute in its handler, so fold adjacent
+	 * batches of the same type together and pay those costs once
+	 * per run of batches.  Only adjacent batches are merged to
+	 * preserve the order updates of different types arrived in.
+	 */
 	itr = list_iterator_create(update_list);
+	while ((object = list_next(itr))) {
+		if (prev_object && (object->type == prev_object->type) &&
+		    prev_object->objects && object->objects) {
+			list_transfer(prev_object->objects, object->objects);
+			list_delete_item(itr);
+		} else
+			prev_object = object;
+	}
+	list_iterator_reset(itr);
 	while ((object = list_next(itr))) {
 		if (!object->objects || !list_count(object->objects))
 			continue;
@@ -4107,6 +4377,12 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 		slurmdb_sort_hierarchical_assoc_list(
 			assoc_mgr_assoc_list, true);
 
+	/*
+	 * A modified limit anywhere in the tree can change the lineage
+	 * of every association below it, so just recompute them all.
+	 */
+	_set_lineage_limit_bits();
+
 	if (!locked)
 		assoc_mgr_unlock(&locks);
 
@@ -4131,6 +4407,8 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 	if (run_update_resvs && init_setup.update_resvs)
 		init_setup.update_resvs();
 
+	assoc_mgr_clear_shares_cache();
+
 	return rc;
 }
 
@@ -4793,6 +5071,9 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 
 	list_iterator_destroy(itr);
 
+	/* records may have been added or deleted above */
+	_post_qos_array(assoc_mgr_qos_list);
+
 	if (!locked)
 		assoc_mgr_unlock(&locks);
 
@@ -6191,6 +6472,16 @@ extern int assoc_mgr_find_tres_pos(slurmdb_tres_rec_t *tres_rec, bool locked)
 	xassert(g_tres_count);
 	xassert(assoc_mgr_tres_array[g_tres_count - 1]);
 
+	/* Id lookups resolve directly through the id -> position index */
+	if (tres_rec->id && assoc_mgr_tres_id2pos &&
+	    (tres_rec->id < assoc_mgr_tres_id2pos_size) &&
+	    (assoc_mgr_tres_id2pos[tres_rec->id] != -1)) {
+		tres_pos = assoc_mgr_tres_id2pos[tres_rec->id];
+		if (!locked)
+			assoc_mgr_unlock(&locks);
+		return tres_pos;
+	}
+
 	for (i = 0; i < g_tres_count; i++) {
 		if (tres_rec->id &&
 		    assoc_mgr_tres_array[i]->id == tres_rec->id) {
@@ -6303,35 +6594,50 @@ extern int assoc_mgr_set_tres_cnt_array(uint64_t **tres_cnt, char *tres_str,
 			(*tres_cnt)[i] = init_val;
 	}
 
-	if (tres_str) {
-		List tmp_list = NULL;
-		/* info("got %s", tres_str); */
-		slurmdb_tres_list_from_string(
-			&tmp_list, tres_str, TRES_STR_FLAG_NONE);
-		if (tmp_list) {
-			slurmdb_tres_rec_t *tres_rec;
-			ListIterator itr = list_iterator_create(tmp_list);
-			while ((tres_rec = list_next(itr))) {
-				int pos = assoc_mgr_find_tres_pos(
-					tres_rec, locked);
-				if (pos == -1) {
-					debug2("assoc_mgr_set_tres_cnt_array: "
-					       "no tres "
-					       "of id %u found in the array",
-					       tres_rec->id);
-					continue;
-				}
+	if (tres_str && tres_str[0]) {
+		/*
+		 * Parse the "id=count" pairs in place rather than
+		 * building a temporary list of TRES records; this runs
+		 * for every limit string on every association and QOS
+		 * update.
+		 */
+		char *tmp_str = tres_str;
+		slurmdb_tres_rec_t tres_rec;
+		int pos, str_cnt = 0;
+
+		memset(&tres_rec, 0, sizeof(slurmdb_tres_rec_t));
+
+		if (tmp_str[0] == ',')
+			tmp_str++;
+
+		while (tmp_str) {
+			tres_rec.id = atoi(tmp_str);
+			if (tres_rec.id <= 0) {
+				error("%s: no id found at %s",
+				      __func__, tmp_str);
+				break;
+			}
+			if (!(tmp_str = strchr(tmp_str, '='))) {
+				error("%s: no value found in %s",
+				      __func__, tres_str);
+				break;
+			}
+			str_cnt++;
+			pos = assoc_mgr_find_tres_pos(&tres_rec, locked);
+			if (pos == -1) {
+				debug2("assoc_mgr_set_tres_cnt_array: no tres "
+				       "of id %u found in the array",
+				       tres_rec.id);
+			} else {
 				/* set the index to the count */
-				(*tres_cnt)[pos] = tres_rec->count;
-				/* info("%d pos %d has count of %"PRIu64, */
-				/*      tres_rec->id, */
-				/*      pos, tres_rec->count); */
-			}
-			list_iterator_destroy(itr);
-			if (g_tres_count != list_count(tmp_list))
-				diff_cnt = 1;
-			FREE_NULL_LIST(tmp_list);
+				(*tres_cnt)[pos] = slurm_atoull(++tmp_str);
+			}
+			if (!(tmp_str = strchr(tmp_str, ',')))
+				break;
+			tmp_str++;
 		}
+		if (g_tres_count != str_cnt)
+			diff_cnt = 1;
 	}
 	return diff_cnt;
 }
@@ -233,6 +233,16 @@ extern int assoc_mgr_fill_in_user(void *db_conn, slurmdb_user_rec_t *user,
 extern int assoc_mgr_fill_in_qos(void *db_conn, slurmdb_qos_rec_t *qos,
 				 int enforce,
 				 slurmdb_qos_rec_t **qos_pptr, bool locked);
+
+/*
+ * Find a QOS record by id in O(1) via the id indexed array.
+ * IN: qos_id - id of the QOS record
+ * RET: pointer into the cache or NULL, DO NOT FREE.
+ * NOTE: Caller must hold an assoc_mgr_lock_t READ_LOCK for QOS; the
+ *       pointer is only valid while that lock is held.
+ */
+extern slurmdb_qos_rec_t *assoc_mgr_find_qos_rec_by_id(uint32_t qos_id);
+
 /*
  * get info from the storage
  * IN/OUT:  wckey - slurmdb_wckey_rec_t with the name, cluster and user
@@ -281,6 +291,13 @@ extern void assoc_mgr_get_shares(void *db_conn,
 				 uid_t uid, shares_request_msg_t *req_msg,
 				 shares_response_msg_t *resp_msg);
 
+/*
+ * Mark the cached shares snapshot used by assoc_mgr_get_shares() stale.
+ * Called on association/TRES updates and after each priority decay cycle.
+ * Only sets a flag, so it is safe to call with assoc_mgr locks held.
+ */
+extern void assoc_mgr_clear_shares_cache(void);
+
 /*
  * get the state of the association manager and pack it up in buffer
  * OUT buffer_ptr - the pointer is set to the allocated buffer.
@@ -76,6 +76,22 @@
 #define	_bitstr_words(nbits)	\
 	((((nbits) + BITSTR_MAXPOS) >> BITSTR_SHIFT) + BITSTR_OVERHEAD)
 
+/* data words in a bitstring, excluding the overhead words */
+#define	_bitstr_data_words(name)	\
+	(_bitstr_words(_bitstr_bits(name)) - BITSTR_OVERHEAD)
+
+/*
+ * The bulk word loops below are written over plain array indexes so the
+ * compiler can auto-vectorize them; ask gcc to do so even at -O2. The
+ * scheduler executes these kernels millions of times per cycle against
+ * node and core bitmaps.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define BITSTR_VECTORIZE __attribute__((optimize("tree-vectorize")))
+#else
+#define BITSTR_VECTORIZE
+#endif
+
 /* check signature */
 #define _assert_bitstr_valid(name) do { \
 	assert((name) != NULL); \
@@ -151,6 +167,11 @@ strong_alias(bit_nffc,		slurm_bit_nffc);
 strong_alias(bit_noc,		slurm_bit_noc);
 strong_alias(bit_nffs,		slurm_bit_nffs);
 strong_alias(bit_copybits,	slurm_bit_copybits);
+strong_alias(bit_cow_create,	slurm_bit_cow_create);
+strong_alias(bit_cow_copy,	slurm_bit_cow_copy);
+strong_alias(bit_cow_read,	slurm_bit_cow_read);
+strong_alias(bit_cow_modify,	slurm_bit_cow_modify);
+strong_alias(bit_cow_free,	slurm_bit_cow_free);
 strong_alias(bit_get_bit_num,	slurm_bit_get_bit_num);
 strong_alias(bit_get_pos_num,	slurm_bit_get_pos_num);
 
@@ -342,6 +363,11 @@ bit_ffc(bitstr_t *b)
 			bit += sizeof(bitstr_t)*8;
 			continue;
 		}
+#if HAVE___BUILTIN_CLZLL && (defined SLURM_BIGENDIAN)
+		value = bit + __builtin_clzll(~b[word]);
+#elif HAVE___BUILTIN_CTZLL && (!defined SLURM_BIGENDIAN)
+		value = bit + __builtin_ctzll(~b[word]);
+#else
 		while (bit < _bitstr_bits(b) && _bit_word(bit) == word) {
 			if (!bit_test(b, bit)) {
 				value = bit;
@@ -349,7 +375,10 @@ bit_ffc(bitstr_t *b)
 			}
 			bit++;
 		}
+#endif
 	}
+	if ((value != -1) && (value >= _bitstr_bits(b)))
+		value = -1;	/* first clear bit was an unused tail bit */
 	return value;
 }
 
@@ -361,26 +390,42 @@ bit_ffc(bitstr_t *b)
 bitoff_t
 bit_nffc(bitstr_t *b, int32_t n)
 {
-	bitoff_t value = -1;
-	bitoff_t bit;
+	bitoff_t bit = 0;
 	int32_t cnt = 0;
 
 	_assert_bitstr_valid(b);
 	assert(n > 0 && n < _bitstr_bits(b));
 
-	for (bit = 0; bit < _bitstr_bits(b); bit++) {
+	while (bit < _bitstr_bits(b)) {
+		/* skip full words in a single test where possible */
+		if (((bit & BITSTR_MAXPOS) == 0) &&
+		    ((bit + BITSTR_MAXPOS) < _bitstr_bits(b))) {
+			int32_t word = _bit_word(bit);
+
+			if (b[word] == BITSTR_MAXVAL) {	/* run broken */
+				cnt = 0;
+				bit += sizeof(bitstr_t) * 8;
+				continue;
+			}
+			if (b[word] == 0) {		/* run extended */
+				cnt += sizeof(bitstr_t) * 8;
+				bit += sizeof(bitstr_t) * 8;
+				if (cnt >= n)
+					return bit - cnt;
+				continue;
+			}
+		}
 		if (bit_test(b, bit)) {		/* fail */
 			cnt = 0;
 		} else {
 			cnt++;
-			if (cnt >= n) {
-				value = bit - (cnt - 1);
-				break;
-			}
+			if (cnt >= n)
+				return bit - (cnt - 1);
 		}
+		bit++;
 	}
 
-	return value;
+	return -1;
 }
 
 /* Find n contiguous bits clear in b starting at some offset.
@@ -392,7 +437,6 @@ bit_nffc(bitstr_t *b, int32_t n)
 bitoff_t
 bit_noc(bitstr_t *b, int32_t n, int32_t seed)
 {
-	bitoff_t value = -1;
 	bitoff_t bit;
 	int32_t cnt = 0;
 
@@ -402,31 +446,68 @@ bit_noc(bitstr_t *b, int32_t n, int32_t seed)
 	if ((seed + n) >= _bitstr_bits(b))
 		seed = _bitstr_bits(b);	/* skip offset test, too small */
 
-	for (bit = seed; bit < _bitstr_bits(b); bit++) {	/* start at offset */
+	bit = seed;
+	while (bit < _bitstr_bits(b)) {		/* start at offset */
+		/* skip full words in a single test where possible */
+		if (((bit & BITSTR_MAXPOS) == 0) &&
+		    ((bit + BITSTR_MAXPOS) < _bitstr_bits(b))) {
+			int32_t word = _bit_word(bit);
+
+			if (b[word] == BITSTR_MAXVAL) {	/* run broken */
+				cnt = 0;
+				bit += sizeof(bitstr_t) * 8;
+				continue;
+			}
+			if (b[word] == 0) {		/* run extended */
+				cnt += sizeof(bitstr_t) * 8;
+				bit += sizeof(bitstr_t) * 8;
+				if (cnt >= n)
+					return bit - cnt;
+				continue;
+			}
+		}
 		if (bit_test(b, bit)) {		/* fail */
 			cnt = 0;
 		} else {
 			cnt++;
-			if (cnt >= n) {
-				value = bit - (cnt - 1);
-				return value;
-			}
+			if (cnt >= n)
+				return bit - (cnt - 1);
 		}
+		bit++;
 	}
 
 	cnt = 0;	/* start at beginning */
-	for (bit = 0; bit < _bitstr_bits(b); bit++) {
+	bit = 0;
+	while (bit < _bitstr_bits(b)) {
+		if (((bit & BITSTR_MAXPOS) == 0) &&
+		    ((bit + BITSTR_MAXPOS) < _bitstr_bits(b))) {
+			int32_t word = _bit_word(bit);
+
+			if (b[word] == BITSTR_MAXVAL) {
+				if ((bit + BITSTR_MAXPOS) >= seed)
+					break;	/* set bit at/after seed */
+				cnt = 0;
+				bit += sizeof(bitstr_t) * 8;
+				continue;
+			}
+			if (b[word] == 0) {
+				cnt += sizeof(bitstr_t) * 8;
+				bit += sizeof(bitstr_t) * 8;
+				if (cnt >= n)
+					return bit - cnt;
+				continue;
+			}
+		}
 		if (bit_test(b, bit)) {		/* fail */
 			if (bit >= seed)
 				break;
 			cnt = 0;
 		} else {
 			cnt++;
-			if (cnt >= n) {
-				value = bit - (cnt - 1);
-				return value;
-			}
+			if (cnt >= n)
+				return bit - (cnt - 1);
 		}
+		bit++;
 	}
 
 	return -1;
@@ -440,26 +521,44 @@ bit_noc(bitstr_t *b, int32_t n, int32_t seed)
 bitoff_t
 bit_nffs(bitstr_t *b, int32_t n)
 {
-	bitoff_t value = -1;
-	bitoff_t bit;
+	bitoff_t bit = 0;
 	int32_t cnt = 0;
 
 	_assert_bitstr_valid(b);
 	assert(n > 0 && n <= _bitstr_bits(b));
 
-	for (bit = 0; bit <= _bitstr_bits(b) - n; bit++) {
+	while (bit < _bitstr_bits(b)) {
+		if ((cnt == 0) && (bit > (_bitstr_bits(b) - n)))
+			break;			/* insufficient bits remain */
+		/* skip full words in a single test where possible */
+		if ((bit & BITSTR_MAXPOS) == 0) {
+			int32_t word = _bit_word(bit);
+
+			if (b[word] == 0) {		/* run broken */
+				cnt = 0;
+				bit += sizeof(bitstr_t) * 8;
+				continue;
+			}
+			if ((b[word] == BITSTR_MAXVAL) &&
+			    ((bit + BITSTR_MAXPOS) < _bitstr_bits(b))) {
+				cnt += sizeof(bitstr_t) * 8;	/* extended */
+				bit += sizeof(bitstr_t) * 8;
+				if (cnt >= n)
+					return bit - cnt;
+				continue;
+			}
+		}
 		if (!bit_test(b, bit)) {	/* fail */
 			cnt = 0;
 		} else {
 			cnt++;
-			if (cnt >= n) {
-				value = bit - (cnt - 1);
-				break;
-			}
+			if (cnt >= n)
+				return bit - (cnt - 1);
 		}
+		bit++;
 	}
 
-	return value;
+	return -1;
 }
 
 /*
@@ -583,9 +682,9 @@ bit_super_set(bitstr_t *b1, bitstr_t *b2)
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8) {
-		if (b1[_bit_word(bit)] != (b1[_bit_word(bit)] &
-		                           b2[_bit_word(bit)]))
+	for (bit = 0; bit < _bitstr_data_words(b1); bit++) {
+		if (b1[BITSTR_OVERHEAD + bit] &
+		    ~b2[BITSTR_OVERHEAD + bit])
 			return 0;
 	}
 
@@ -606,8 +705,8 @@ bit_equal(bitstr_t *b1, bitstr_t *b2)
 	if (_bitstr_bits(b1) != _bitstr_bits(b2))
 		return 0;
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8) {
-		if (b1[_bit_word(bit)] != b2[_bit_word(bit)])
+	for (bit = 0; bit < _bitstr_data_words(b1); bit++) {
+		if (b1[BITSTR_OVERHEAD + bit] != b2[BITSTR_OVERHEAD + bit])
 			return 0;
 	}
 
@@ -621,17 +720,20 @@ bit_equal(bitstr_t *b1, bitstr_t *b2)
  *   b1 (IN/OUT)	first string
  *   b2 (IN)		second bitstring
  */
-void
+BITSTR_VECTORIZE void
 bit_and(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitstr_t *w1 = b1 + BITSTR_OVERHEAD;
+	const bitstr_t *w2 = b2 + BITSTR_OVERHEAD;
+	bitoff_t i, words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8)
-		b1[_bit_word(bit)] &= b2[_bit_word(bit)];
+	words = _bitstr_data_words(b1);
+	for (i = 0; i < words; i++)
+		w1[i] &= w2[i];
 }
 
 /*
@@ -639,31 +741,36 @@ bit_and(bitstr_t *b1, bitstr_t *b2)
  * b1 (IN/OUT)
  * b2 (IN)
  */
-void bit_and_not(bitstr_t *b1, bitstr_t *b2)
+BITSTR_VECTORIZE void bit_and_not(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitstr_t *w1 = b1 + BITSTR_OVERHEAD;
+	const bitstr_t *w2 = b2 + BITSTR_OVERHEAD;
+	bitoff_t i, words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8)
-		b1[_bit_word(bit)] &= ~b2[_bit_word(bit)];
+	words = _bitstr_data_words(b1);
+	for (i = 0; i < words; i++)
+		w1[i] &= ~w2[i];
 }
 
 /*
  * b1 = ~b1		one's complement
  *   b1 (IN/OUT)	first bitmap
  */
-void
+BITSTR_VECTORIZE void
 bit_not(bitstr_t *b)
 {
-	bitoff_t bit;
+	bitstr_t *w = b + BITSTR_OVERHEAD;
+	bitoff_t i, words;
 
 	_assert_bitstr_valid(b);
 
-	for (bit = 0; bit < _bitstr_bits(b); bit += sizeof(bitstr_t)*8)
-		b[_bit_word(bit)] = ~b[_bit_word(bit)];
+	words = _bitstr_data_words(b);
+	for (i = 0; i < words; i++)
+		w[i] = ~w[i];
 }
 
 /*
@@ -671,17 +778,20 @@ bit_not(bitstr_t *b)
  *   b1 (IN/OUT)	first bitmap
  *   b2 (IN)		second bitmap
  */
-void
+BITSTR_VECTORIZE void
 bit_or(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitstr_t *w1 = b1 + BITSTR_OVERHEAD;
+	const bitstr_t *w2 = b2 + BITSTR_OVERHEAD;
+	bitoff_t i, words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8)
-		b1[_bit_word(bit)] |= b2[_bit_word(bit)];
+	words = _bitstr_data_words(b1);
+	for (i = 0; i < words; i++)
+		w1[i] |= w2[i];
 }
 
 /*
@@ -689,16 +799,79 @@ bit_or(bitstr_t *b1, bitstr_t *b2)
  * b1 (IN/OUT)
  * b2 (IN)
  */
-void bit_or_not(bitstr_t *b1, bitstr_t *b2)
+BITSTR_VECTORIZE void bit_or_not(bitstr_t *b1, bitstr_t *b2)
 {
-	bitoff_t bit;
+	bitstr_t *w1 = b1 + BITSTR_OVERHEAD;
+	const bitstr_t *w2 = b2 + BITSTR_OVERHEAD;
+	bitoff_t i, words;
 
 	_assert_bitstr_valid(b1);
 	_assert_bitstr_valid(b2);
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
-	for (bit = 0; bit < _bitstr_bits(b1); bit += sizeof(bitstr_t)*8)
-		b1[_bit_word(bit)] |= ~b2[_bit_word(bit)];
+	words = _bitstr_data_words(b1);
+	for (i = 0; i < words; i++)
+		w1[i] |= ~w2[i];
+}
+
+/*
+ * b1 |= (b2 << offset)
+ * OR every bit of b2 into b1 starting at bit "offset" of b1. Bits of b2
+ * which would land beyond the end of b1 are ignored. Replaces per-bit
+ * bit_test()/bit_set() loops when merging a small bitmap (e.g. one node's
+ * cores) into a larger one at an arbitrary position.
+ *   b1 (IN/OUT)	first bitmap
+ *   b2 (IN)		second bitmap
+ *   offset (IN)	position in b1 of the first bit of b2
+ */
+void bit_or_at(bitstr_t *b1, bitstr_t *b2, bitoff_t offset)
+{
+	bitoff_t bits;
+
+	_assert_bitstr_valid(b1);
+	_assert_bitstr_valid(b2);
+	assert(offset >= 0);
+
+	if (offset >= _bitstr_bits(b1))
+		return;
+	bits = MIN(_bitstr_bits(b2), _bitstr_bits(b1) - offset);
+	if (bits <= 0)
+		return;
+
+#ifdef SLURM_BIGENDIAN
+	{
+		bitoff_t bit;
+
+		for (bit = 0; bit < bits; bit++) {
+			if (bit_test(b2, bit))
+				bit_set(b1, offset + bit);
+		}
+	}
+#else
+	{
+		bitstr_t *w1 = b1 + BITSTR_OVERHEAD + (offset >> BITSTR_SHIFT);
+		const bitstr_t *w2 = b2 + BITSTR_OVERHEAD;
+		int shift = offset & BITSTR_MAXPOS;
+		bitoff_t i, words = (bits + BITSTR_MAXPOS) >> BITSTR_SHIFT;
+		uint64_t word, carry = 0;
+
+		for (i = 0; i < words; i++) {
+			word = (uint64_t) w2[i];
+			if ((i == (words - 1)) && (bits & BITSTR_MAXPOS)) {
+				/* Mask bits of b2 beyond the copied range */
+				word &= (((uint64_t) 1) <<
+					 (bits & BITSTR_MAXPOS)) - 1;
+			}
+			if (shift) {
+				w1[i] |= (bitstr_t) ((word << shift) | carry);
+				carry = word >> (BITSTR_MAXPOS + 1 - shift);
+			} else
+				w1[i] |= (bitstr_t) word;
+		}
+		if (carry)
+			w1[words] |= (bitstr_t) carry;
+	}
+#endif
 }
 
 /*
@@ -735,6 +908,101 @@ bit_copybits(bitstr_t *dest, bitstr_t *src)
 	memcpy(&dest[BITSTR_OVERHEAD], &src[BITSTR_OVERHEAD], len);
 }
 
+/*
+ * Copy-on-write bitmap snapshots.  A bit_cow_t handle refers to shared
+ * bitmap storage; taking another snapshot with bit_cow_copy() costs O(1)
+ * and the underlying bitmap is duplicated only when some handle asks to
+ * modify it.  Intended for planning code (e.g. the backfill scheduler's
+ * node_space maps) which takes many "what if" copies that are mostly
+ * never written.  As with the rest of this module, callers needing
+ * concurrent access to a snapshot group must provide their own locking.
+ */
+typedef struct bit_cow_data {
+	bitstr_t *bits;		/* the shared bitmap */
+	uint32_t ref_cnt;	/* count of handles sharing it */
+} bit_cow_data_t;
+
+struct bit_cow {
+	bit_cow_data_t *data;
+};
+
+/*
+ * Create a snapshot handle owning bitmap [b].  The caller must not use
+ * or free [b] directly thereafter.
+ */
+bit_cow_t *bit_cow_create(bitstr_t *b)
+{
+	bit_cow_t *cow;
+
+	_assert_bitstr_valid(b);
+
+	cow = xmalloc(sizeof(bit_cow_t));
+	cow->data = xmalloc(sizeof(bit_cow_data_t));
+	cow->data->bits = b;
+	cow->data->ref_cnt = 1;
+
+	return cow;
+}
+
+/* Take an O(1) snapshot of [cow], sharing its bitmap storage */
+bit_cow_t *bit_cow_copy(bit_cow_t *cow)
+{
+	bit_cow_t *new;
+
+	assert(cow != NULL);
+
+	new = xmalloc(sizeof(bit_cow_t));
+	new->data = cow->data;
+	new->data->ref_cnt++;
+
+	return new;
+}
+
+/*
+ * Return the bitmap behind [cow] for read-only use.  The pointer may be
+ * shared with other snapshot handles and remains owned by [cow]; it is
+ * valid until the handle is modified or freed.
+ */
+bitstr_t *bit_cow_read(bit_cow_t *cow)
+{
+	assert(cow != NULL);
+
+	return cow->data->bits;
+}
+
+/*
+ * Return the bitmap behind [cow] for modification, first giving the
+ * handle a private copy if the storage is currently shared.
+ */
+bitstr_t *bit_cow_modify(bit_cow_t *cow)
+{
+	bit_cow_data_t *data;
+
+	assert(cow != NULL);
+
+	if (cow->data->ref_cnt > 1) {
+		cow->data->ref_cnt--;
+		data = xmalloc(sizeof(bit_cow_data_t));
+		data->bits = bit_copy(cow->data->bits);
+		data->ref_cnt = 1;
+		cow->data = data;
+	}
+
+	return cow->data->bits;
+}
+
+/* Release snapshot handle [cow] and, with it, its share of the bitmap */
+void bit_cow_free(bit_cow_t *cow)
+{
+	if (!cow)
+		return;
+	if (--cow->data->ref_cnt == 0) {
+		bit_free(cow->data->bits);
+		xfree(cow->data);
+	}
+	xfree(cow);
+}
+
 #ifdef HAVE___BUILTIN_POPCOUNTLL
 #define hweight __builtin_popcountll
 #else
@@ -757,20 +1025,21 @@ hweight(uint64_t w)
  *   b (IN)		bitstring to check
  *   RETURN		count of set bits
  */
-int32_t
+BITSTR_VECTORIZE int32_t
 bit_set_count(bitstr_t *b)
 {
 	int32_t count = 0;
-	bitoff_t bit, bit_cnt;
+	bitoff_t bit, bit_cnt, i, words;
+	const bitstr_t *w = b + BITSTR_OVERHEAD;
 	int32_t word_size = sizeof(bitstr_t) * 8;
 
 	_assert_bitstr_valid(b);
 
 	bit_cnt = _bitstr_bits(b);
-	for (bit = 0; (bit + word_size) <= bit_cnt; bit += word_size) {
-		count += hweight(b[_bit_word(bit)]);
-	}
-	for ( ; bit < bit_cnt; bit++) {
+	words = bit_cnt / word_size;
+	for (i = 0; i < words; i++)
+		count += hweight(w[i]);
+	for (bit = words * word_size; bit < bit_cnt; bit++) {
 		if (bit_test(b, bit))
 			count++;
 	}
@@ -814,11 +1083,13 @@ bit_set_count_range(bitstr_t *b, int32_t start, int32_t end)
 /*
  * return number of bits set in b1 that are also set in b2, 0 if no overlap
  */
-extern int32_t
+BITSTR_VECTORIZE extern int32_t
 bit_overlap(bitstr_t *b1, bitstr_t *b2)
 {
 	int32_t count = 0;
-	bitoff_t bit, bit_cnt;
+	bitoff_t bit, bit_cnt, i, words;
+	const bitstr_t *w1 = b1 + BITSTR_OVERHEAD;
+	const bitstr_t *w2 = b2 + BITSTR_OVERHEAD;
 	int32_t word_size = sizeof(bitstr_t) * 8;
 
 	_assert_bitstr_valid(b1);
@@ -826,12 +1097,10 @@ bit_overlap(bitstr_t *b1, bitstr_t *b2)
 	assert(_bitstr_bits(b1) == _bitstr_bits(b2));
 
 	bit_cnt = _bitstr_bits(b1);
-	for (bit = 0; bit < bit_cnt; bit += word_size) {
-		if ((bit + word_size - 1) >= bit_cnt)
-			break;
-		count += hweight(b1[_bit_word(bit)] & b2[_bit_word(bit)]);
-	}
-	for ( ; bit < bit_cnt; bit++) {
+	words = bit_cnt / word_size;
+	for (i = 0; i < words; i++)
+		count += hweight(w1[i] & w2[i]);
+	for (bit = words * word_size; bit < bit_cnt; bit++) {
 		if (bit_test(b1, bit) && bit_test(b2, bit))
 			count++;
 	}
@@ -1345,10 +1614,14 @@ int32_t *bitstr2inx(bitstr_t *b)
  */
 char * bit_fmt_hexmask(bitstr_t * bitmap)
 {
+	static const char hex_tbl[] = "0123456789ABCDEF";
 	char *retstr, *ptr;
-	char current;
+	int current;
 	bitoff_t i;
 	bitoff_t bitsize = bit_size(bitmap);
+#ifndef SLURM_BIGENDIAN
+	bitstr_t word = 0;
+#endif
 
 	/* 4 bits per ASCII '0'-'F' */
 	bitoff_t charsize = (bitsize + 3) / 4;
@@ -1359,19 +1632,31 @@ char * bit_fmt_hexmask(bitstr_t * bitmap)
 	retstr[1] = 'x';
 	retstr[charsize + 2] = '\0';
 	ptr = &retstr[charsize + 1];
-	for (i=0; i < bitsize;) {
+#ifndef SLURM_BIGENDIAN
+	/*
+	 * Pull each word out once and emit sixteen digits from it rather
+	 * than testing the bits one at a time.  Only valid for the little
+	 * endian bit layout; with SLURM_BIGENDIAN the bit order is
+	 * reversed within each word, so test the bits individually.
+	 */
+	for (i = 0; i < bitsize; i += 4) {
+		if ((i & BITSTR_MAXPOS) == 0)
+			word = bitmap[_bit_word(i)];
+		current = (word >> (i & BITSTR_MAXPOS)) & 0xF;
+		if ((bitsize - i) < 4)	/* mask bits beyond the bitmap end */
+			current &= (1 << (bitsize - i)) - 1;
+		*ptr-- = hex_tbl[current];
+	}
+#else
+	for (i = 0; i < bitsize;) {
 		current = 0;
 		if (                 bit_test(bitmap,i++)) current |= 0x1;
 		if ((i < bitsize) && bit_test(bitmap,i++)) current |= 0x2;
 		if ((i < bitsize) && bit_test(bitmap,i++)) current |= 0x4;
 		if ((i < bitsize) && bit_test(bitmap,i++)) current |= 0x8;
-		if (current <= 9) {
-			current += '0';
-		} else {
-			current += 'A' - 10;
-		}
-		*ptr-- = current;
+		*ptr-- = hex_tbl[current];
 	}
+#endif
 
 	return retstr;
 }
@@ -1388,11 +1673,14 @@ char * bit_fmt_hexmask(bitstr_t * bitmap)
  */
 int bit_unfmt_hexmask(bitstr_t * bitmap, const char* str)
 {
-	int32_t bit_index = 0, len = strlen(str);
-	int rc = 0;
+	int rc = 0, len = strlen(str);
 	const char *curpos = str + len - 1;
 	int32_t current;
+	bitoff_t bit_index = 0;
 	bitoff_t bitsize = bit_size(bitmap);
+#ifndef SLURM_BIGENDIAN
+	bitstr_t word = 0;
+#endif
 
 	bit_nclear(bitmap, 0, bitsize - 1);
 	if (xstrncmp(str, "0x", 2) == 0) {	/* Bypass 0x */
@@ -1400,7 +1688,13 @@ int bit_unfmt_hexmask(bitstr_t * bitmap, const char* str)
 		len -= 2;
 	}
 
-	while (curpos >= str) {
+	/*
+	 * Accumulate whole words and store each with a single write
+	 * rather than setting the bits one at a time.  As above, only
+	 * the little endian bit layout allows this; with SLURM_BIGENDIAN
+	 * set the bits individually.
+	 */
+	while ((curpos >= str) && (bit_index < bitsize)) {
 		current = (int32_t) *curpos;
 		if (isxdigit(current)) {	/* valid hex digit */
 			if (isdigit(current)) {
@@ -1414,6 +1708,17 @@ int bit_unfmt_hexmask(bitstr_t * bitmap, const char* str)
 			rc = -1;
 		}
 
+#ifndef SLURM_BIGENDIAN
+		if ((bitsize - bit_index) < 4)	/* drop bits past the end */
+			current &= (1 << (bitsize - bit_index)) - 1;
+		word |= ((bitstr_t) current) << (bit_index & BITSTR_MAXPOS);
+		bit_index += 4;
+		if (((bit_index & BITSTR_MAXPOS) == 0) ||
+		    (bit_index >= bitsize) || (curpos == str)) {
+			bitmap[_bit_word(bit_index - 4)] = word;
+			word = 0;
+		}
+#else
 		if ((current & 1) && (bit_index   < bitsize))
 			bit_set(bitmap, bit_index);
 		if ((current & 2) && (bit_index+1 < bitsize))
@@ -1422,9 +1727,16 @@ int bit_unfmt_hexmask(bitstr_t * bitmap, const char* str)
 			bit_set(bitmap, bit_index+2);
 		if ((current & 8) && (bit_index+3 < bitsize))
 			bit_set(bitmap, bit_index+3);
-		len--;
+		bit_index += 4;
+#endif
+		curpos--;
+	}
+
+	/* still validate any digits addressing bits past the bitmap end */
+	while (curpos >= str) {
+		if (!isxdigit((int) *curpos))
+			rc = -1;
 		curpos--;
-		bit_index+=4;
 	}
 	return rc;
 }
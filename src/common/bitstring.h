@@ -116,6 +116,7 @@ void	bit_and(bitstr_t *b1, bitstr_t *b2);
 void	bit_and_not(bitstr_t *b1, bitstr_t *b2);
 void	bit_not(bitstr_t *b);
 void	bit_or(bitstr_t *b1, bitstr_t *b2);
+void	bit_or_at(bitstr_t *b1, bitstr_t *b2, bitoff_t offset);
 void	bit_or_not(bitstr_t *b1, bitstr_t *b2);
 int32_t	bit_set_count(bitstr_t *b);
 int32_t	bit_set_count_range(bitstr_t *b, int32_t start, int32_t end);
@@ -143,6 +144,24 @@ int     bit_overlap(bitstr_t *b1, bitstr_t *b2);
 int     bit_equal(bitstr_t *b1, bitstr_t *b2);
 void    bit_copybits(bitstr_t *dest, bitstr_t *src);
 bitstr_t *bit_copy(bitstr_t *b);
+
+/*
+ * Copy-on-write bitmap snapshots: handles created with bit_cow_copy()
+ * share the underlying bitmap in O(1) and the storage is duplicated
+ * only when a handle is opened for modification.
+ */
+typedef struct bit_cow bit_cow_t;
+bit_cow_t *bit_cow_create(bitstr_t *b);
+bit_cow_t *bit_cow_copy(bit_cow_t *cow);
+bitstr_t *bit_cow_read(bit_cow_t *cow);
+bitstr_t *bit_cow_modify(bit_cow_t *cow);
+void	bit_cow_free(bit_cow_t *cow);
+
+#define FREE_NULL_BIT_COW(_X)		\
+	do {				\
+		if (_X) bit_cow_free(_X);\
+		(_X) = NULL;		\
+	} while (0)
 bitstr_t *bit_pick_cnt(bitstr_t *b, bitoff_t nbits);
 bitoff_t bit_get_bit_num(bitstr_t *b, int32_t pos);
 int32_t	bit_get_pos_num(bitstr_t *b, bitoff_t pos);
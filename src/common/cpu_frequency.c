@@ -712,32 +712,45 @@ _cpu_freq_get_cur_gov(int cpuidx)
 }
 
 /*
- * set cpu governor
+ * write a value to a cpufreq file of one cpu
+ * -- the caller is expected to hold the CPU owner lock --
+ *
+ * Return: SLURM_SUCCESS or SLURM_ERROR
  */
 static int
-_cpu_freq_set_gov(stepd_step_rec_t *job, int cpuidx, char* gov )
+_cpu_freq_write(int cpuidx, char *option, char *value)
 {
 	char path[PATH_MAX];
-	FILE *fp;
-	int fd, rc;
+	ssize_t len = strlen(value);
+	int fd;
 
-	rc = SLURM_SUCCESS;
 	snprintf(path, sizeof(path), PATH_TO_CPU
-		 "cpu%u/cpufreq/scaling_governor", cpuidx);
-	fd = _set_cpu_owner_lock(cpuidx, job->jobid);
-	if ((fp = fopen(path, "w"))) {
-		fputs(gov, fp);
-		fputc('\n', fp);
-		fclose(fp);
-	} else {
-		error("%s: Can not set CPU governor: %m", __func__);
-		rc = SLURM_ERROR;
+		 "cpu%u/cpufreq/%s", cpuidx, option);
+	fd = open(path, O_WRONLY);
+	if (fd < 0) {
+		error("%s: Can not set %s: %m", __func__, option);
+		return SLURM_ERROR;
 	}
-	if (fd >= 0) {
-		(void) fd_release_lock(fd);
+	if (write(fd, value, len) != len) {
+		error("%s: Can not set %s: %m", __func__, option);
 		(void) close(fd);
+		return SLURM_ERROR;
 	}
-	return rc;
+	(void) close(fd);
+	return SLURM_SUCCESS;
+}
+
+/*
+ * set cpu governor
+ * -- the caller is expected to hold the CPU owner lock --
+ */
+static int
+_cpu_freq_set_gov(int cpuidx, char* gov )
+{
+	char value[GOV_NAME_LEN + 1];
+
+	snprintf(value, sizeof(value), "%s\n", gov);
+	return _cpu_freq_write(cpuidx, "scaling_governor", value);
 }
 
 /*
@@ -789,32 +802,18 @@ _cpu_freq_test_scaling_freq(int cpuidx, char *option)
 /*
  * set one of scalling_min_freq, scaling_max_freq, scaling_setspeed
  * -- assume governor already set to userspace ---
+ * -- the caller is expected to hold the CPU owner lock --
  *
  */
 static int
-_cpu_freq_set_scaling_freq(stepd_step_rec_t *job, int cpx, uint32_t freq,
-		char* option)
+_cpu_freq_set_scaling_freq(int cpx, uint32_t freq, char* option)
 {
-	char path[PATH_MAX];
-	FILE *fp;
-	int fd, rc;
+	char value[LINE_LEN];
+	int rc;
 	uint32_t newfreq;
 
-	rc = SLURM_SUCCESS;
-	snprintf(path, sizeof(path), PATH_TO_CPU
-		 "cpu%u/cpufreq/%s", cpx, option);
-	fd = _set_cpu_owner_lock(cpx, job->jobid);
-	if ((fp = fopen(path, "w"))) {
-		fprintf(fp, "%u\n", freq);
-		fclose(fp);
-	} else {
-		error("%s: Can not set %s: %m", __func__, option);
-		rc = SLURM_ERROR;
-	}
-	if (fd >= 0) {
-		(void) fd_release_lock(fd);
-		(void) close(fd);
-	}
+	snprintf(value, sizeof(value), "%u\n", freq);
+	rc = _cpu_freq_write(cpx, option, value);
 	if (debug_flags & DEBUG_FLAG_CPU_FREQ) {
 		newfreq = _cpu_freq_get_scaling_freq(cpx, option);
 		if (newfreq != freq) {
@@ -1141,15 +1140,115 @@ _cpu_freq_check_freq(const char* arg)
 	return 0;
 }
 
+/*
+ * apply the requested frequency/governor values to one cpu
+ * -- the caller is expected to hold the CPU owner lock --
+ *
+ * Return: SLURM_ERROR if the whole operation should be aborted,
+ *         SLURM_SUCCESS otherwise (including per-file failures which
+ *         only terminate work on this CPU)
+ */
+static int
+_cpu_freq_set_cpu(int i)
+{
+	char freq_detail[100];
+	uint32_t freq;
+	int rc;
+
+	/* Max must be set before min, per
+	 * www.kernel.org/doc/Documentation/cpu-freq/user-guide.txt
+	 */
+	if (cpufreq[i].new_max_freq != NO_VAL ) {
+		freq = cpufreq[i].new_max_freq;
+		if (cpufreq[i].org_frequency > freq) {
+			/* The current frequency is > requested max,
+			 * Set it so it is in range
+			 * have to go to UserSpace to do it. */
+			rc = _cpu_freq_set_gov(i, "userspace");
+			if (rc == SLURM_ERROR)
+				return SLURM_ERROR;
+			rc = _cpu_freq_set_scaling_freq(i, freq,
+					         "scaling_setspeed");
+			if (rc == SLURM_ERROR)
+				return SLURM_SUCCESS;
+			if (cpufreq[i].new_governor[0] == '\0') {
+				/* Not requesting new gov, so restore */
+				rc = _cpu_freq_set_gov(i,
+					cpufreq[i].org_governor);
+				if (rc == SLURM_ERROR)
+					return SLURM_SUCCESS;
+			}
+		}
+		rc = _cpu_freq_set_scaling_freq(i, freq, "scaling_max_freq");
+		if (rc == SLURM_ERROR)
+			return SLURM_SUCCESS;
+	}
+	if (cpufreq[i].new_min_freq != NO_VAL) {
+		freq = cpufreq[i].new_min_freq;
+		if (cpufreq[i].org_frequency < freq) {
+			/* The current frequency is < requested min,
+			 * Set it so it is in range
+			 * have to go to UserSpace to do it. */
+			rc = _cpu_freq_set_gov(i, "userspace");
+			if (rc == SLURM_ERROR)
+				return SLURM_SUCCESS;
+			rc = _cpu_freq_set_scaling_freq(i, freq,
+					         "scaling_setspeed");
+			if (rc == SLURM_ERROR)
+				return SLURM_SUCCESS;
+			if (cpufreq[i].new_governor[0] == '\0') {
+				/* Not requesting new gov, so restore */
+				rc= _cpu_freq_set_gov(i,
+					cpufreq[i].org_governor);
+				if (rc == SLURM_ERROR)
+					return SLURM_SUCCESS;
+			}
+		}
+		rc= _cpu_freq_set_scaling_freq(i, freq, "scaling_min_freq");
+		if (rc == SLURM_ERROR)
+			return SLURM_SUCCESS;
+	}
+	if (cpufreq[i].new_frequency != NO_VAL) {
+		if (xstrcmp(cpufreq[i].org_governor,"userspace")) {
+			rc = _cpu_freq_set_gov(i, "userspace");
+			if (rc == SLURM_ERROR)
+				return SLURM_SUCCESS;
+		}
+		rc = _cpu_freq_set_scaling_freq(i,
+				cpufreq[i].new_frequency,
+				"scaling_setspeed");
+		if (rc == SLURM_ERROR)
+			return SLURM_SUCCESS;
+	}
+	if (cpufreq[i].new_governor[0] != '\0') {
+		rc = _cpu_freq_set_gov(i, cpufreq[i].new_governor);
+		if (rc == SLURM_ERROR)
+			return SLURM_SUCCESS;
+	}
+	if (debug_flags & DEBUG_FLAG_CPU_FREQ) {
+		cpu_freq_debug(NULL, NULL,
+				freq_detail, sizeof(freq_detail),
+				NO_VAL, cpufreq[i].new_min_freq,
+				cpufreq[i].new_max_freq,
+				cpufreq[i].new_frequency);
+		if (cpufreq[i].new_governor[0] != '\0') {
+			info("cpu_freq: set cpu=%d %s Governor=%s",
+			     i, freq_detail, cpufreq[i].new_governor);
+		} else {
+			info("cpu_freq: reset cpu=%d %s", i,
+			     freq_detail);
+		}
+	}
+	return SLURM_SUCCESS;
+}
+
 /*
  * set cpu frequency if possible for each cpu of the job step
  */
 extern void
 cpu_freq_set(stepd_step_rec_t *job)
 {
-	char freq_detail[100];
-	uint32_t freq;
-	int i, rc;
+	int i, fd, rc;
 
 	if ((!cpu_freq_count) || (!cpufreq))
 		return;
@@ -1169,95 +1268,63 @@ cpu_freq_set(stepd_step_rec_t *job)
 			     cpufreq[i].org_governor);
 		}
 
-		/* Max must be set before min, per
-		 * www.kernel.org/doc/Documentation/cpu-freq/user-guide.txt
-		 */
-		if (cpufreq[i].new_max_freq != NO_VAL ) {
-			freq = cpufreq[i].new_max_freq;
-			if (cpufreq[i].org_frequency > freq) {
-				/* The current frequency is > requested max,
-				 * Set it so it is in range
-				 * have to go to UserSpace to do it. */
-				rc = _cpu_freq_set_gov(job, i, "userspace");
-				if (rc == SLURM_ERROR)
-					return;
-				rc = _cpu_freq_set_scaling_freq(job, i, freq,
-						         "scaling_setspeed");
-				if (rc == SLURM_ERROR)
-					continue;
-				if (cpufreq[i].new_governor[0] == '\0') {
-					/* Not requesting new gov, so restore */
-					rc = _cpu_freq_set_gov(job, i,
-						cpufreq[i].org_governor);
-					if (rc == SLURM_ERROR)
-						continue;
-				}
-			}
-			rc = _cpu_freq_set_scaling_freq(job, i, freq,
-							"scaling_max_freq");
-			if (rc == SLURM_ERROR)
-				continue;
-		}
-		if (cpufreq[i].new_min_freq != NO_VAL) {
-			freq = cpufreq[i].new_min_freq;
-			if (cpufreq[i].org_frequency < freq) {
-				/* The current frequency is < requested min,
-				 * Set it so it is in range
-				 * have to go to UserSpace to do it. */
-				rc = _cpu_freq_set_gov(job, i, "userspace");
-				if (rc == SLURM_ERROR)
-					continue;
-				rc = _cpu_freq_set_scaling_freq(job, i, freq,
-						         "scaling_setspeed");
-				if (rc == SLURM_ERROR)
-					continue;
-				if (cpufreq[i].new_governor[0] == '\0') {
-					/* Not requesting new gov, so restore */
-					rc= _cpu_freq_set_gov(job, i,
-						cpufreq[i].org_governor);
-					if (rc == SLURM_ERROR)
-						continue;
-				}
-			}
-			rc= _cpu_freq_set_scaling_freq(job, i, freq,
-						       "scaling_min_freq");
-			if (rc == SLURM_ERROR)
-				continue;
-		}
-		if (cpufreq[i].new_frequency != NO_VAL) {
-			if (xstrcmp(cpufreq[i].org_governor,"userspace")) {
-				rc = _cpu_freq_set_gov(job, i, "userspace");
-				if (rc == SLURM_ERROR)
-					continue;
-			}
-			rc = _cpu_freq_set_scaling_freq(job, i,
-					cpufreq[i].new_frequency,
-					"scaling_setspeed");
-			if (rc == SLURM_ERROR)
-				continue;
-		}
-		if (cpufreq[i].new_governor[0] != '\0') {
-			rc = _cpu_freq_set_gov(job, i, cpufreq[i].new_governor);
-			if (rc == SLURM_ERROR)
-				continue;
-		}
-		if (debug_flags & DEBUG_FLAG_CPU_FREQ) {
-			cpu_freq_debug(NULL, NULL,
-					freq_detail, sizeof(freq_detail),
-					NO_VAL, cpufreq[i].new_min_freq,
-					cpufreq[i].new_max_freq,
-					cpufreq[i].new_frequency);
-			if (cpufreq[i].new_governor[0] != '\0') {
-				info("cpu_freq: set cpu=%d %s Governor=%s",
-				     i, freq_detail, cpufreq[i].new_governor);
-			} else {
-				info("cpu_freq: reset cpu=%d %s", i,
-				     freq_detail);
-			}
+		/* Take the CPU owner lock once for all of the writes
+		 * to this CPU rather than once per file */
+		fd = _set_cpu_owner_lock(i, job->jobid);
+		rc = _cpu_freq_set_cpu(i);
+		if (fd >= 0) {
+			(void) fd_release_lock(fd);
+			(void) close(fd);
 		}
+		if (rc == SLURM_ERROR)
+			return;
 	}
 }
 
+/*
+ * restore the original frequency/governor values on one cpu
+ * -- the caller is expected to hold the CPU owner lock --
+ *
+ * Return: SLURM_SUCCESS or SLURM_ERROR
+ */
+static int
+_cpu_freq_reset_cpu(int i)
+{
+	int rc;
+
+	if (cpufreq[i].new_frequency != NO_VAL) {
+		rc = _cpu_freq_set_gov(i, "userspace");
+		if (rc == SLURM_ERROR)
+			return SLURM_ERROR;
+		rc = _cpu_freq_set_scaling_freq(i, cpufreq[i].org_frequency,
+						"scaling_setspeed");
+		if (rc == SLURM_ERROR)
+			return SLURM_ERROR;
+		cpufreq[i].new_governor[0] = 'u'; /* force gov reset */
+	}
+	/* Max must be set before min, per
+	 * www.kernel.org/doc/Documentation/cpu-freq/user-guide.txt
+	 */
+	if (cpufreq[i].new_max_freq != NO_VAL) {
+		rc = _cpu_freq_set_scaling_freq(i, cpufreq[i].org_max_freq,
+						"scaling_max_freq");
+		if (rc == SLURM_ERROR)
+			return SLURM_ERROR;
+	}
+	if (cpufreq[i].new_min_freq != NO_VAL) {
+		rc = _cpu_freq_set_scaling_freq(i, cpufreq[i].org_min_freq,
+						"scaling_min_freq");
+		if (rc == SLURM_ERROR)
+			return SLURM_ERROR;
+	}
+	if (cpufreq[i].new_governor[0] != '\0') {
+		rc = _cpu_freq_set_gov(i, cpufreq[i].org_governor);
+		if (rc == SLURM_ERROR)
+			return SLURM_ERROR;
+	}
+	return SLURM_SUCCESS;
+}
+
 /*
  * reset the cpus used by the process to their
  * default frequency and governor type
@@ -1288,43 +1355,19 @@ cpu_freq_reset(stepd_step_rec_t *job)
 		    && cpufreq[i].new_governor[0] == '\0')
 			continue; /* Nothing to reset on this CPU */
 
-		fd = _test_cpu_owner_lock(i, jobid);
-		if (fd < 0)
+		if (_test_cpu_owner_lock(i, jobid) < 0)
 			continue;
 
-		if (cpufreq[i].new_frequency != NO_VAL) {
-			rc = _cpu_freq_set_gov(job, i, "userspace");
-			if (rc == SLURM_ERROR)
-				continue;
-			rc = _cpu_freq_set_scaling_freq(job, i,
-					cpufreq[i].org_frequency,
-					"scaling_setspeed");
-			if (rc == SLURM_ERROR)
-				continue;
-			cpufreq[i].new_governor[0] = 'u'; /* force gov reset */
-		}
-		/* Max must be set before min, per
-		 * www.kernel.org/doc/Documentation/cpu-freq/user-guide.txt
-		 */
-		if (cpufreq[i].new_max_freq != NO_VAL) {
-			rc = _cpu_freq_set_scaling_freq(job, i,
-					cpufreq[i].org_max_freq,
-					"scaling_max_freq");
-			if (rc == SLURM_ERROR)
-				continue;
-		}
-		if (cpufreq[i].new_min_freq != NO_VAL) {
-			rc = _cpu_freq_set_scaling_freq(job, i,
-					cpufreq[i].org_min_freq,
-					"scaling_min_freq");
-			if (rc == SLURM_ERROR)
-				continue;
-		}
-		if (cpufreq[i].new_governor[0] != '\0') {
-			rc = _cpu_freq_set_gov(job, i, cpufreq[i].org_governor);
-			if (rc == SLURM_ERROR)
-				continue;
+		/* Take the CPU owner lock once for all of the writes
+		 * to this CPU rather than once per file */
+		fd = _set_cpu_owner_lock(i, job->jobid);
+		rc = _cpu_freq_reset_cpu(i);
+		if (fd >= 0) {
+			(void) fd_release_lock(fd);
+			(void) close(fd);
 		}
+		if (rc == SLURM_ERROR)
+			continue;
 
 		if (debug_flags & DEBUG_FLAG_CPU_FREQ) {
 			cpu_freq_debug(NULL, NULL,
@@ -38,12 +38,19 @@
 
 #define _GNU_SOURCE	/* For POLLRDHUP */
 
+#include "config.h"
+
 #include <errno.h>
 #include <poll.h>
+#include <string.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#if HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
 #if defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__)
 #define POLLRDHUP POLLHUP
 #endif
@@ -92,15 +99,38 @@ struct eio_handle_components {
 	List new_objs;
 };
 
+#if HAVE_SYS_EPOLL_H
+/*
+ * Per-fd interest bookkeeping for the epoll backend, indexed by fd.
+ * "obj" is only ever compared against list members, never dereferenced,
+ * so a stale pointer to a destroyed object is harmless.
+ */
+typedef struct {
+	eio_obj_t   *obj;	/* object that last owned this fd */
+	short        events;	/* interest currently registered with epoll */
+	unsigned int gen;	/* mainloop pass in which obj was last seen */
+} epoll_fd_t;
+#endif
+
 /* Function prototypes */
 
+#if HAVE_SYS_EPOLL_H
+static int          _epoll_mainloop(eio_handle_t *eio);
+static unsigned int _epoll_setup(int epfd, List l, epoll_fd_t **tab_p,
+				 int *tab_size_p, unsigned int gen);
+static short        _epoll_to_poll(uint32_t events);
+#else
 static int          _poll_internal(struct pollfd *pfds, unsigned int nfds,
 				   time_t shutdown_time);
+static int          _poll_mainloop(eio_handle_t *eio);
 static unsigned int _poll_setup_pollfds(struct pollfd *, eio_obj_t **, List);
 static void         _poll_dispatch(struct pollfd *, unsigned int, eio_obj_t **,
 		                   List objList);
+#endif
 static void         _poll_handle_event(short revents, eio_obj_t *obj,
 		                       List objList);
+static bool         _is_readable(eio_obj_t *obj);
+static bool         _is_writable(eio_obj_t *obj);
 
 eio_handle_t *eio_handle_create(uint16_t shutdown_wait)
 {
@@ -283,6 +313,250 @@ static int _eio_wakeup_handler(eio_handle_t *eio)
 }
 
 int eio_handle_mainloop(eio_handle_t *eio)
+{
+	xassert (eio != NULL);
+	xassert (eio->magic == EIO_MAGIC);
+
+#if HAVE_SYS_EPOLL_H
+	return _epoll_mainloop(eio);
+#else
+	return _poll_mainloop(eio);
+#endif
+}
+
+#if HAVE_SYS_EPOLL_H
+
+/*
+ * Translate an epoll(7) event mask into the poll(2) form understood by
+ * _poll_handle_event(), which is shared with the poll backend.
+ */
+static short _epoll_to_poll(uint32_t events)
+{
+	short revents = 0;
+
+	if (events & EPOLLIN)
+		revents |= POLLIN;
+	if (events & EPOLLOUT)
+		revents |= POLLOUT;
+	if (events & EPOLLERR)
+		revents |= POLLERR;
+	if (events & EPOLLHUP)
+		revents |= POLLHUP;
+	if (events & EPOLLRDHUP)
+		revents |= POLLRDHUP;
+
+	return revents;
+}
+
+/*
+ * Bring the kernel's interest set in line with what each object's
+ * readable() and writable() callbacks currently ask for. Unlike the poll
+ * backend, which rebuilds and hands the kernel the full fd array on every
+ * pass, this only issues an epoll_ctl() for objects whose interest
+ * actually changed, so an idle fd costs nothing.
+ *
+ * Returns the number of objects being watched.
+ */
+static unsigned int _epoll_setup(int epfd, List l, epoll_fd_t **tab_p,
+				 int *tab_size_p, unsigned int gen)
+{
+	ListIterator  i    = list_iterator_create(l);
+	eio_obj_t    *obj  = NULL;
+	epoll_fd_t   *tab  = *tab_p;
+	epoll_fd_t   *slot;
+	int           tab_size = *tab_size_p;
+	unsigned int  nfds = 0;
+	short         events;
+	bool          reused;
+	struct epoll_event ev;
+
+	while ((obj = list_next(i))) {
+		events = 0;
+		if (_is_readable(obj))
+			events |= POLLIN | POLLRDHUP;
+		if (_is_writable(obj))
+			events |= POLLOUT;
+		if (obj->fd < 0)
+			continue;
+
+		if (obj->fd >= tab_size) {
+			int new_size = MAX(tab_size, 64);
+			while (new_size <= obj->fd)
+				new_size *= 2;
+			/* Note: xrealloc() zero fills the new slots */
+			xrealloc(tab, new_size * sizeof(epoll_fd_t));
+			tab_size = new_size;
+		}
+		slot = &tab[obj->fd];
+		reused = (slot->obj != obj);
+		slot->obj = obj;
+		slot->gen = gen;
+
+		if (events)
+			nfds++;
+		if (!reused && (events == slot->events))
+			continue;
+
+		memset(&ev, 0, sizeof(ev));
+		ev.data.fd = obj->fd;
+		if (events & POLLIN)
+			ev.events |= EPOLLIN | EPOLLRDHUP;
+		if (events & POLLOUT)
+			ev.events |= EPOLLOUT;
+
+		if (!events) {
+			/*
+			 * A close() already dropped the registration, so
+			 * ENOENT and EBADF are expected here.
+			 */
+			if (epoll_ctl(epfd, EPOLL_CTL_DEL, obj->fd, &ev) &&
+			    (errno != ENOENT) && (errno != EBADF))
+				error("%s: epoll_ctl(DEL, %d): %m",
+				      __func__, obj->fd);
+		} else if (reused || !slot->events) {
+			if (epoll_ctl(epfd, EPOLL_CTL_ADD, obj->fd, &ev) &&
+			    ((errno != EEXIST) ||
+			     epoll_ctl(epfd, EPOLL_CTL_MOD, obj->fd, &ev))) {
+				error("%s: epoll_ctl(ADD, %d): %m",
+				      __func__, obj->fd);
+				slot->events = 0;
+				nfds--;
+				continue;
+			}
+		} else {
+			/*
+			 * If the fd was closed and the same number handed
+			 * back to this object, the old registration is gone
+			 * and the modify must become an add.
+			 */
+			if (epoll_ctl(epfd, EPOLL_CTL_MOD, obj->fd, &ev) &&
+			    ((errno != ENOENT) ||
+			     epoll_ctl(epfd, EPOLL_CTL_ADD, obj->fd, &ev))) {
+				error("%s: epoll_ctl(MOD, %d): %m",
+				      __func__, obj->fd);
+				slot->events = 0;
+				nfds--;
+				continue;
+			}
+		}
+		slot->events = events;
+	}
+	list_iterator_destroy(i);
+
+	*tab_p = tab;
+	*tab_size_p = tab_size;
+	return nfds;
+}
+
+static int _epoll_mainloop(eio_handle_t *eio)
+{
+	int          retval   = 0;
+	int          epfd     = -1;
+	epoll_fd_t  *tab      = NULL;
+	int          tab_size = 0;
+	struct epoll_event ev, *events = NULL;
+	int          maxevents = 0;
+	unsigned int nfds, gen = 0;
+	int          i, n, fd, timeout;
+	time_t shutdown_time;
+
+	if ((epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+		error("%s: epoll_create1: %m", __func__);
+		return -1;
+	}
+
+	/*
+	 *  Setup eio handle signaling fd
+	 */
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.fd = eio->fds[0];
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, eio->fds[0], &ev) < 0) {
+		error("%s: epoll_ctl(ADD, %d): %m", __func__, eio->fds[0]);
+		close(epfd);
+		return -1;
+	}
+
+	while (1) {
+		debug4("eio: handling events for %d objects",
+		       list_count(eio->obj_list));
+		gen++;
+		nfds = _epoll_setup(epfd, eio->obj_list, &tab, &tab_size, gen);
+		if (nfds <= 0)
+			goto done;
+		nfds++;		/* for the signaling fd */
+
+		if (maxevents < nfds) {
+			maxevents = nfds;
+			xrealloc(events,
+				 maxevents * sizeof(struct epoll_event));
+		}
+
+		/* Get shutdown_time to set the epoll_wait timeout */
+		slurm_mutex_lock(&eio->shutdown_mutex);
+		shutdown_time = eio->shutdown_time;
+		slurm_mutex_unlock(&eio->shutdown_mutex);
+		if (shutdown_time)
+			timeout = 1000;	/* Return every 1000 msec during
+					 * shutdown */
+		else
+			timeout = -1;
+
+		while ((n = epoll_wait(epfd, events, maxevents, timeout)) < 0) {
+			if (errno == EINTR) {
+				n = 0;
+				break;
+			} else if (errno == EAGAIN) {
+				continue;
+			}
+			error("%s: epoll_wait: %m", __func__);
+			goto error;
+		}
+
+		for (i = 0; i < n; i++) {
+			fd = events[i].data.fd;
+			if (fd == eio->fds[0]) {
+				if (events[i].events & EPOLLIN)
+					_eio_wakeup_handler(eio);
+				continue;
+			}
+			if ((fd >= tab_size) || (tab[fd].gen != gen)) {
+				/*
+				 * The owning object left the list without
+				 * closing the fd; stop watching it.
+				 */
+				epoll_ctl(epfd, EPOLL_CTL_DEL, fd, &ev);
+				if (fd < tab_size)
+					tab[fd].events = 0;
+				continue;
+			}
+			_poll_handle_event(_epoll_to_poll(events[i].events),
+					   tab[fd].obj, eio->obj_list);
+		}
+
+		slurm_mutex_lock(&eio->shutdown_mutex);
+		shutdown_time = eio->shutdown_time;
+		slurm_mutex_unlock(&eio->shutdown_mutex);
+		if (shutdown_time &&
+		    (difftime(time(NULL), shutdown_time)>=eio->shutdown_wait)) {
+			error("%s: Abandoning IO %d secs after job shutdown initiated",
+			      __func__, eio->shutdown_wait);
+			break;
+		}
+	}
+
+error:
+	retval = -1;
+done:
+	close(epfd);
+	xfree(events);
+	xfree(tab);
+	return retval;
+}
+
+#else /* !HAVE_SYS_EPOLL_H */
+
+static int _poll_mainloop(eio_handle_t *eio)
 {
 	int            retval  = 0;
 	struct pollfd *pollfds = NULL;
@@ -291,9 +565,6 @@ int eio_handle_mainloop(eio_handle_t *eio)
 	unsigned int   n       = 0;
 	time_t shutdown_time;
 
-	xassert (eio != NULL);
-	xassert (eio->magic == EIO_MAGIC);
-
 	while (1) {
 		/* Alloc memory for pfds and map if needed */
 		n = list_count(eio->obj_list);
@@ -379,6 +650,8 @@ static int _poll_internal(struct pollfd *pfds, unsigned int nfds,
 	return n;
 }
 
+#endif /* !HAVE_SYS_EPOLL_H */
+
 static bool _is_writable(eio_obj_t *obj)
 {
 	return (obj->ops->writable && (*obj->ops->writable)(obj));
@@ -389,6 +662,8 @@ static bool _is_readable(eio_obj_t *obj)
 	return (obj->ops->readable && (*obj->ops->readable)(obj));
 }
 
+#if !HAVE_SYS_EPOLL_H
+
 static unsigned int _poll_setup_pollfds(struct pollfd *pfds, eio_obj_t *map[],
 					List l)
 {
@@ -438,6 +713,8 @@ static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds,
 	}
 }
 
+#endif /* !HAVE_SYS_EPOLL_H */
+
 static void _poll_handle_event(short revents, eio_obj_t *obj, List objList)
 {
 	bool read_called = false;
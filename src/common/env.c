@@ -1685,25 +1685,112 @@ void env_unset_environment(void)
 }
 
 /*
- * Merge all of the environment variables in src_array into the
- * array dest_array.  Any variables already found in dest_array
- * will be overwritten with the value from src_array.
+ * Hash index over the variable names of an environment array. Merging
+ * one large environment into another with a linear lookup per variable
+ * is O(n^2), which is measurable when a batch job carries hundreds of
+ * variables and the merge is repeated for every task of a step; the
+ * index makes each lookup O(1).
  */
-void env_array_merge(char ***dest_array, const char **src_array)
+#define ENV_HASH_SIZE 512
+
+typedef struct env_hash_node {
+	int index;
+	struct env_hash_node *next;
+} env_hash_node_t;
+
+/* Hash an environment variable name, stopping at '=' or NUL */
+static unsigned int _env_hash_name(const char *name)
 {
-	char **ptr;
-	char name[256], *value;
+	unsigned int hash = 5381;
+
+	while (*name && (*name != '='))
+		hash = (hash * 33) + (unsigned char) *(name++);
+	return hash % ENV_HASH_SIZE;
+}
+
+/* Return true if two "name=value" entries have the same variable name */
+static bool _env_name_match(const char *e1, const char *e2)
+{
+	size_t cnt = 0;
+
+	while ((e1[cnt] != '\0') && (e1[cnt] != '=') && (e1[cnt] == e2[cnt]))
+		cnt++;
+	return (((e1[cnt] == '\0') || (e1[cnt] == '=')) &&
+		((e2[cnt] == '\0') || (e2[cnt] == '=')));
+}
+
+static void _env_array_merge_internal(char ***dest_array,
+				      const char **src_array, bool slurm_only)
+{
+	env_hash_node_t **index, *node, *next;
+	char **dest;
+	const char **src;
+	int dest_cnt = 0, src_cnt = 0, h;
 
 	if (src_array == NULL)
 		return;
+	if (*dest_array == NULL)
+		*dest_array = env_array_create();
 
-	value = xmalloc(ENV_BUFSIZE);
-	for (ptr = (char **)src_array; *ptr != NULL; ptr++) {
-		if (_env_array_entry_splitter(*ptr, name, sizeof(name),
-					      value, ENV_BUFSIZE))
-			env_array_overwrite(dest_array, name, value);
+	for (src = src_array; *src; src++)
+		src_cnt++;
+	if (!src_cnt)
+		return;
+
+	index = xcalloc(ENV_HASH_SIZE, sizeof(env_hash_node_t *));
+	for (dest = *dest_array; *dest; dest++) {
+		h = _env_hash_name(*dest);
+		node = xmalloc(sizeof(env_hash_node_t));
+		node->index = dest_cnt++;
+		node->next = index[h];
+		index[h] = node;
 	}
-	xfree(value);
+
+	/* Grow to worst case size in one step rather than per entry */
+	xrealloc(*dest_array,
+		 ((dest_cnt + src_cnt + 1) * sizeof(char *)));
+
+	for (src = src_array; *src; src++) {
+		if (!strchr(*src, '='))	/* Malformed entry */
+			continue;
+		if (slurm_only && xstrncmp(*src, "SLURM", 5))
+			continue;
+		h = _env_hash_name(*src);
+		for (node = index[h]; node; node = node->next) {
+			if (_env_name_match((*dest_array)[node->index], *src))
+				break;
+		}
+		if (node) {
+			xfree((*dest_array)[node->index]);
+			(*dest_array)[node->index] = xstrdup(*src);
+		} else {
+			node = xmalloc(sizeof(env_hash_node_t));
+			node->index = dest_cnt;
+			node->next = index[h];
+			index[h] = node;
+			(*dest_array)[dest_cnt++] = xstrdup(*src);
+		}
+	}
+	(*dest_array)[dest_cnt] = NULL;
+	xrealloc(*dest_array, ((dest_cnt + 1) * sizeof(char *)));
+
+	for (h = 0; h < ENV_HASH_SIZE; h++) {
+		for (node = index[h]; node; node = next) {
+			next = node->next;
+			xfree(node);
+		}
+	}
+	xfree(index);
+}
+
+/*
+ * Merge all of the environment variables in src_array into the
+ * array dest_array.  Any variables already found in dest_array
+ * will be overwritten with the value from src_array.
+ */
+void env_array_merge(char ***dest_array, const char **src_array)
+{
+	_env_array_merge_internal(dest_array, src_array, false);
 }
 
 /*
@@ -1713,20 +1800,7 @@ void env_array_merge(char ***dest_array, const char **src_array)
  */
 void env_array_merge_slurm(char ***dest_array, const char **src_array)
 {
-	char **ptr;
-	char name[256], *value;
-
-	if (src_array == NULL)
-		return;
-
-	value = xmalloc(ENV_BUFSIZE);
-	for (ptr = (char **)src_array; *ptr != NULL; ptr++) {
-		if (_env_array_entry_splitter(*ptr, name, sizeof(name),
-					      value, ENV_BUFSIZE) &&
-		    (xstrncmp(name, "SLURM", 5) == 0))
-			env_array_overwrite(dest_array, name, value);
-	}
-	xfree(value);
+	_env_array_merge_internal(dest_array, src_array, true);
 }
 
 /*
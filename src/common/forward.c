@@ -106,6 +106,7 @@ void *_forward_thread(void *arg)
 	char *buf = NULL;
 	int steps = 0;
 	int start_timeout = fwd_msg->timeout;
+	struct iovec iov[2];
 
 	/* repeat until we are sure the message was sent */
 	while ((name = hostlist_shift(hl))) {
@@ -113,8 +114,10 @@ void *_forward_thread(void *arg)
 			error("forward_thread: can't find address for host "
 			      "%s, check slurm.conf", name);
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
-			mark_as_failed_forward(&fwd_struct->ret_list, name,
-					       SLURM_UNKNOWN_FORWARD_ADDR);
+			if (!fwd_struct->abandoned)
+				mark_as_failed_forward(
+					&fwd_struct->ret_list, name,
+					SLURM_UNKNOWN_FORWARD_ADDR);
  			free(name);
 			if (hostlist_count(hl) > 0) {
 				slurm_mutex_unlock(&fwd_struct->forward_mutex);
@@ -126,9 +129,10 @@ void *_forward_thread(void *arg)
 			error("forward_thread to %s: %m", name);
 
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
-			mark_as_failed_forward(
-				&fwd_struct->ret_list, name,
-				SLURM_COMMUNICATIONS_CONNECTION_ERROR);
+			if (!fwd_struct->abandoned)
+				mark_as_failed_forward(
+					&fwd_struct->ret_list, name,
+					SLURM_COMMUNICATIONS_CONNECTION_ERROR);
 			free(name);
 			if (hostlist_count(hl) > 0) {
 				slurm_mutex_unlock(&fwd_struct->forward_mutex);
@@ -162,34 +166,28 @@ void *_forward_thread(void *arg)
 
 		pack_header(&fwd_msg->header, buffer);
 
-		/* add forward data to buffer */
-		if (remaining_buf(buffer) < fwd_struct->buf_len) {
-			int new_size = buffer->processed + fwd_struct->buf_len;
-			new_size += 1024; /* padded for paranoia */
-			xrealloc_nz(buffer->head, new_size);
-			buffer->size = new_size;
-		}
-		if (fwd_struct->buf_len) {
-			memcpy(&buffer->head[buffer->processed],
-			       fwd_struct->buf, fwd_struct->buf_len);
-			buffer->processed += fwd_struct->buf_len;
-		}
-
 		/*
-		 * forward message
+		 * forward message, sending the pre-packed forward data in
+		 * place behind the header rather than copying it into the
+		 * header buffer first
 		 */
-		if (slurm_msg_sendto(fd,
-				     get_buf_data(buffer),
-				     get_buf_offset(buffer)) < 0) {
-			error("forward_thread: slurm_msg_sendto: %m");
+		iov[0].iov_base = get_buf_data(buffer);
+		iov[0].iov_len  = get_buf_offset(buffer);
+		iov[1].iov_base = fwd_struct->buf;
+		iov[1].iov_len  = fwd_struct->buf_len;
+
+		if (slurm_msg_sendv(fd, iov,
+				    fwd_struct->buf_len ? 2 : 1) < 0) {
+			error("forward_thread: slurm_msg_sendv: %m");
 
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
-			mark_as_failed_forward(&fwd_struct->ret_list, name,
-					       errno);
+			if (!fwd_struct->abandoned)
+				mark_as_failed_forward(&fwd_struct->ret_list,
+						       name, errno);
 			free(name);
 			if (hostlist_count(hl) > 0) {
 				free_buf(buffer);
-				buffer = init_buf(fwd_struct->buf_len);
+				buffer = init_buf(BUF_SIZE);
 				slurm_mutex_unlock(&fwd_struct->forward_mutex);
 				close(fd);
 				fd = -1;
@@ -214,6 +212,11 @@ void *_forward_thread(void *arg)
 		    (fwd_msg->header.msg_type == REQUEST_RECONFIGURE) ||
 		    (fwd_msg->header.msg_type == REQUEST_REBOOT_NODES)) {
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
+			if (fwd_struct->abandoned) {
+				free(name);
+				name = NULL;
+				goto cleanup;
+			}
 			ret_data_info = xmalloc(sizeof(ret_data_info_t));
 			list_push(fwd_struct->ret_list, ret_data_info);
 			ret_data_info->node_name = xstrdup(name);
@@ -254,13 +257,14 @@ void *_forward_thread(void *arg)
 		if (!ret_list || (fwd_msg->header.forward.cnt != 0
 				  && list_count(ret_list) <= 1)) {
 			slurm_mutex_lock(&fwd_struct->forward_mutex);
-			mark_as_failed_forward(&fwd_struct->ret_list, name,
-					       errno);
+			if (!fwd_struct->abandoned)
+				mark_as_failed_forward(&fwd_struct->ret_list,
+						       name, errno);
 			free(name);
 			FREE_NULL_LIST(ret_list);
 			if (hostlist_count(hl) > 0) {
 				free_buf(buffer);
-				buffer = init_buf(fwd_struct->buf_len);
+				buffer = init_buf(BUF_SIZE);
 				slurm_mutex_unlock(&fwd_struct->forward_mutex);
 				close(fd);
 				fd = -1;
@@ -318,7 +322,7 @@ void *_forward_thread(void *arg)
 		break;
 	}
 	slurm_mutex_lock(&fwd_struct->forward_mutex);
-	if (ret_list) {
+	if (ret_list && !fwd_struct->abandoned) {
 		while ((ret_data_info = list_pop(ret_list)) != NULL) {
 			if (!ret_data_info->node_name) {
 				ret_data_info->node_name = xstrdup(name);
@@ -327,8 +331,8 @@ void *_forward_thread(void *arg)
 			debug3("got response from %s",
 			       ret_data_info->node_name);
 		}
-		FREE_NULL_LIST(ret_list);
 	}
+	FREE_NULL_LIST(ret_list);
 	free(name);
 cleanup:
 	if ((fd >= 0) && close(fd) < 0)
@@ -336,8 +340,15 @@ cleanup:
 	hostlist_destroy(hl);
 	destroy_forward(&fwd_msg->header.forward);
 	free_buf(buffer);
-	slurm_cond_signal(&fwd_struct->notify);
-	slurm_mutex_unlock(&fwd_struct->forward_mutex);
+	fwd_struct->thr_cnt--;
+	if (fwd_struct->abandoned && (fwd_struct->thr_cnt == 0)) {
+		/* forward_wait() already returned, nobody is listening */
+		slurm_mutex_unlock(&fwd_struct->forward_mutex);
+		destroy_forward_struct(fwd_struct);
+	} else {
+		slurm_cond_signal(&fwd_struct->notify);
+		slurm_mutex_unlock(&fwd_struct->forward_mutex);
+	}
 	xfree(fwd_msg);
 
 	return (NULL);
@@ -563,6 +574,9 @@ static void _forward_msg_internal(hostlist_t hl, hostlist_t* sp_hl,
 
 		forward_init(&fwd_msg->header.forward, NULL);
 		fwd_msg->header.forward.nodelist = buf;
+		slurm_mutex_lock(&fwd_struct->forward_mutex);
+		fwd_struct->thr_cnt++;
+		slurm_mutex_unlock(&fwd_struct->forward_mutex);
 		slurm_thread_create_detached(NULL, _forward_thread, fwd_msg);
 	}
 }
@@ -720,12 +734,74 @@ extern void mark_as_failed_forward(List *ret_list, char *node_name, int err)
 	return;
 }
 
+/*
+ * Mark every node in the forward nodelist which has no entry in the
+ * message's return list as failed. Caller must hold forward_mutex.
+ */
+static void _mark_missing_forwards(slurm_msg_t *msg)
+{
+	forward_struct_t *fwd_struct = msg->forward_struct;
+	hostlist_t hl;
+	hostlist_iterator_t host_itr;
+	ListIterator itr;
+	ret_data_info_t *ret_data_info;
+	char *name;
+
+	if (!fwd_struct->nodelist)
+		return;
+
+	hl = hostlist_create(fwd_struct->nodelist);
+	host_itr = hostlist_iterator_create(hl);
+	while ((name = hostlist_next(host_itr))) {
+		bool node_found = false;
+
+		if (msg->ret_list) {
+			itr = list_iterator_create(msg->ret_list);
+			while ((ret_data_info = list_next(itr))) {
+				if (!xstrcmp(name,
+					     ret_data_info->node_name)) {
+					node_found = true;
+					break;
+				}
+			}
+			list_iterator_destroy(itr);
+		}
+		if (!node_found)
+			mark_as_failed_forward(
+				&fwd_struct->ret_list, name,
+				SLURM_COMMUNICATIONS_CONNECTION_ERROR);
+		free(name);
+	}
+	hostlist_iterator_destroy(host_itr);
+	hostlist_destroy(hl);
+}
+
 extern void forward_wait(slurm_msg_t * msg)
 {
 	int count = 0;
+	struct timespec ts = {0, 0};
 
 	/* wait for all the other messages on the tree under us */
 	if (msg->forward_struct) {
+		static int message_timeout = -1;
+
+		if (message_timeout < 0)
+			message_timeout = slurm_get_msg_timeout() * 1000;
+
+		/*
+		 * Bound the wait by this hop's forwarding budget plus
+		 * one message timeout of grace. The forward threads
+		 * eventually account for every node, but a hung
+		 * connection deep in the tree can take several chained
+		 * receive timeouts to resolve. Responding upward with
+		 * the nodes we have lets the originator retire them
+		 * immediately and retry only the laggards, which are
+		 * marked failed here.
+		 */
+		ts.tv_sec = time(NULL) + 1 +
+			    ((msg->forward_struct->timeout +
+			      message_timeout) / 1000);
+
 		debug2("looking for %d", msg->forward_struct->fwd_cnt);
 		slurm_mutex_lock(&msg->forward_struct->forward_mutex);
 		count = 0;
@@ -734,15 +810,37 @@ extern void forward_wait(slurm_msg_t * msg)
 
 		debug2("Got back %d", count);
 		while ((count < msg->forward_struct->fwd_cnt)) {
-			slurm_cond_wait(&msg->forward_struct->notify,
-					&msg->forward_struct->forward_mutex);
+			slurm_cond_timedwait(&msg->forward_struct->notify,
+					     &msg->forward_struct->
+					     forward_mutex, &ts);
 
 			if (msg->ret_list != NULL) {
 				count = list_count(msg->ret_list);
 			}
 			debug2("Got back %d", count);
+
+			if ((count < msg->forward_struct->fwd_cnt) &&
+			    (time(NULL) >= ts.tv_sec))
+				break;
 		}
-		debug2("Got them all");
+		if (count < msg->forward_struct->fwd_cnt) {
+			error("%s: only got %d of %d responses, marking the remaining nodes as failed",
+			      __func__, count, msg->forward_struct->fwd_cnt);
+			_mark_missing_forwards(msg);
+			if (msg->forward_struct->thr_cnt > 0) {
+				/*
+				 * Late responses are discarded and the
+				 * last forward thread frees the
+				 * structure.
+				 */
+				msg->forward_struct->abandoned = true;
+				slurm_mutex_unlock(&msg->forward_struct->
+						   forward_mutex);
+				msg->forward_struct = NULL;
+				return;
+			}
+		} else
+			debug2("Got them all");
 		slurm_mutex_unlock(&msg->forward_struct->forward_mutex);
 		destroy_forward_struct(msg->forward_struct);
 		msg->forward_struct = NULL;
@@ -775,6 +873,7 @@ void destroy_forward_struct(forward_struct_t *forward_struct)
 {
 	if (forward_struct) {
 		xfree(forward_struct->buf);
+		xfree(forward_struct->nodelist);
 		slurm_mutex_destroy(&forward_struct->forward_mutex);
 		slurm_cond_destroy(&forward_struct->notify);
 		xfree(forward_struct);
@@ -194,12 +194,15 @@ static uint32_t select_plugin_type = NO_VAL;
 /* Local functions */
 static gres_node_state_t *
 		_build_gres_node_state(void);
+static gres_state_t **_build_node_gres_array(List node_gres_list);
 static void	_build_node_gres_str(List *gres_list, char **gres_str,
 				     int cores_per_sock, int sock_per_node);
 static uint32_t **_build_tasks_per_node_sock(struct job_resources *job_res,
 					    uint8_t overcommit,
 					    gres_mc_data_t *tres_mc_ptr,
 					    struct node_record *node_table_ptr);
+static void	_build_topo_core_any(gres_node_state_t *node_gres_ptr,
+				     int core_cnt);
 static bitstr_t *_core_bitmap_rebuild(bitstr_t *old_core_bitmap, int new_size);
 static void	_epilog_list_del(void *x);
 static int	_find_job_by_sock_gres(void *x, void *key);
@@ -213,6 +216,7 @@ static uint32_t	_get_task_cnt_node(uint32_t **tasks_per_node_socket,
 				   int node_inx, int sock_cnt);
 static uint64_t	_get_tot_gres_cnt(uint32_t plugin_id, uint64_t *topo_cnt,
 				  int *config_type_cnt);
+static int	_gres_context_inx(uint32_t plugin_id);
 static int	_gres_find_id(void *x, void *key);
 static int	_gres_find_job_by_key(void *x, void *key);
 static int	_gres_find_step_by_key(void *x, void *key);
@@ -314,6 +318,49 @@ extern uint32_t gres_plugin_build_id(char *name)
 	return id;
 }
 
+/*
+ * Return the index into gres_context[] of the plugin with the given ID,
+ * or -1 if that plugin is not configured.
+ * NOTE: gres_context_lock must be locked by the caller
+ */
+static int _gres_context_inx(uint32_t plugin_id)
+{
+	int i;
+
+	for (i = 0; i < gres_context_cnt; i++) {
+		if (gres_context[i].plugin_id == plugin_id)
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+ * Build a fixed array of a node's GRES records indexed by gres_context[]
+ * index. One pass over node_gres_list here replaces a separate list scan
+ * for every GRES type requested by a job in the test/allocate functions
+ * below, which run once per node per job in the selection logic.
+ * RET array of gres_context_cnt entries, caller must xfree()
+ * NOTE: gres_context_lock must be locked by the caller
+ */
+static gres_state_t **_build_node_gres_array(List node_gres_list)
+{
+	ListIterator node_gres_iter;
+	gres_state_t **node_gres_array, *node_gres_ptr;
+	int i;
+
+	node_gres_array = xcalloc(gres_context_cnt, sizeof(gres_state_t *));
+	node_gres_iter = list_iterator_create(node_gres_list);
+	while ((node_gres_ptr = (gres_state_t *) list_next(node_gres_iter))) {
+		i = _gres_context_inx(node_gres_ptr->plugin_id);
+		if (i >= 0)
+			node_gres_array[i] = node_gres_ptr;
+	}
+	list_iterator_destroy(node_gres_iter);
+
+	return node_gres_array;
+}
+
 static int _gres_find_id(void *x, void *key)
 {
 	uint32_t *plugin_id = (uint32_t *)key;
@@ -1603,6 +1650,7 @@ static void _gres_node_state_delete_topo(gres_node_state_t *gres_node_ptr)
 	xfree(gres_node_ptr->topo_gres_cnt_avail);
 	xfree(gres_node_ptr->topo_type_id);
 	xfree(gres_node_ptr->topo_type_name);
+	FREE_NULL_BITMAP(gres_node_ptr->topo_core_any_bitmap);
 }
 
 static void _gres_node_state_delete(gres_node_state_t *gres_node_ptr)
@@ -2237,6 +2285,7 @@ static int _node_config_validate(char *node_name, char *orig_config,
 	}
 
 	if (rebuild_topo) {
+		FREE_NULL_BITMAP(gres_data->topo_core_any_bitmap);
 		iter = list_iterator_create(gres_conf_list);
 		gres_inx = i = 0;
 		while ((gres_slurmd_conf = (gres_slurmd_conf_t *)
@@ -2484,6 +2533,7 @@ static int _node_config_validate(char *node_name, char *orig_config,
 			xfree(gres_data->topo_type_id);
 			xfree(gres_data->topo_type_name);
 		}
+		FREE_NULL_BITMAP(gres_data->topo_core_any_bitmap);
 		gres_data->topo_cnt = 0;
 	}
 
@@ -2802,6 +2852,7 @@ static void _sync_node_mps_to_gpu(gres_state_t *mps_gres_ptr,
 			FREE_NULL_BITMAP(mps_gres_data->topo_gres_bitmap[i]);
 		xfree(mps_gres_data->topo_type_name[i]);
 	}
+	FREE_NULL_BITMAP(mps_gres_data->topo_core_any_bitmap);
 
 	if (mps_gres_data->gres_cnt_avail == 0) {
 		/* No gres/mps on this node */
@@ -5973,6 +6024,7 @@ static void _validate_gres_node_cores(gres_node_state_t *node_gres_ptr,
 			debug("Rebuilding node %s gres core bitmap (%d != %d)",
 			      node_name, cores_slurmd, cores_ctld);
 			log_mismatch = false;
+			FREE_NULL_BITMAP(node_gres_ptr->topo_core_any_bitmap);
 		}
 		new_core_bitmap = _core_bitmap_rebuild(
 					node_gres_ptr->topo_core_bitmap[i],
@@ -5982,13 +6034,37 @@ static void _validate_gres_node_cores(gres_node_state_t *node_gres_ptr,
 	}
 }
 
+/*
+ * Build the cached union of a node's topo_core_bitmap[] entries with any
+ * GRES available, sized to the core count used by the scheduler. An entry
+ * with GRES but no core binding makes every core usable.
+ * NOTE: gres_context_lock must be locked by the caller
+ */
+static void _build_topo_core_any(gres_node_state_t *node_gres_ptr,
+				 int core_cnt)
+{
+	int i;
+
+	node_gres_ptr->topo_core_any_bitmap = bit_alloc(core_cnt);
+	for (i = 0; i < node_gres_ptr->topo_cnt; i++) {
+		if (node_gres_ptr->topo_gres_cnt_avail[i] == 0)
+			continue;
+		if (!node_gres_ptr->topo_core_bitmap[i]) {
+			bit_set_all(node_gres_ptr->topo_core_any_bitmap);
+			break;
+		}
+		bit_or_at(node_gres_ptr->topo_core_any_bitmap,
+			  node_gres_ptr->topo_core_bitmap[i], 0);
+	}
+}
+
 static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 				 bool use_total_gres, bitstr_t *core_bitmap,
 				 int core_start_bit, int core_end_bit,
 				 char *gres_name, char *node_name,
 				 uint32_t plugin_id)
 {
-	int i, j, core_ctld;
+	int i, core_ctld;
 	gres_job_state_t  *job_gres_ptr  = (gres_job_state_t *)  job_gres_data;
 	gres_node_state_t *node_gres_ptr = (gres_node_state_t *) node_gres_data;
 	bitstr_t *avail_core_bitmap = NULL;
@@ -6005,6 +6081,27 @@ static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 		use_busy_dev = true;
 	}
 
+	core_ctld = core_end_bit - core_start_bit + 1;
+	_validate_gres_node_cores(node_gres_ptr, core_ctld, node_name);
+
+	if (use_total_gres && !job_gres_ptr->type_name) {
+		/*
+		 * Every topology entry with GRES available contributes its
+		 * cores here, so the cached union of their core maps stands
+		 * in for the per-entry scan below.
+		 */
+		if (!node_gres_ptr->topo_core_any_bitmap)
+			_build_topo_core_any(node_gres_ptr, core_ctld);
+		avail_core_bitmap = bit_copy(core_bitmap);
+		bit_nclear(avail_core_bitmap, core_start_bit, core_end_bit);
+		bit_or_at(avail_core_bitmap,
+			  node_gres_ptr->topo_core_any_bitmap,
+			  core_start_bit);
+		bit_and(core_bitmap, avail_core_bitmap);
+		FREE_NULL_BITMAP(avail_core_bitmap);
+		return;
+	}
+
 	/* Determine which specific cores can be used */
 	avail_core_bitmap = bit_copy(core_bitmap);
 	bit_nclear(avail_core_bitmap, core_start_bit, core_end_bit);
@@ -6026,14 +6123,9 @@ static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 			FREE_NULL_BITMAP(avail_core_bitmap);	/* No filter */
 			return;
 		}
-		core_ctld = core_end_bit - core_start_bit + 1;
-		_validate_gres_node_cores(node_gres_ptr, core_ctld, node_name);
-		core_ctld = bit_size(node_gres_ptr->topo_core_bitmap[i]);
-		for (j = 0; j < core_ctld; j++) {
-			if (bit_test(node_gres_ptr->topo_core_bitmap[i], j)) {
-				bit_set(avail_core_bitmap, core_start_bit + j);
-			}
-		}
+		bit_or_at(avail_core_bitmap,
+			  node_gres_ptr->topo_core_bitmap[i],
+			  core_start_bit);
 	}
 	bit_and(core_bitmap, avail_core_bitmap);
 	FREE_NULL_BITMAP(avail_core_bitmap);
@@ -6422,8 +6514,8 @@ extern uint32_t gres_plugin_job_test(List job_gres_list, List node_gres_list,
 {
 	int i;
 	uint32_t core_cnt, tmp_cnt;
-	ListIterator job_gres_iter,  node_gres_iter;
-	gres_state_t *job_gres_ptr, *node_gres_ptr;
+	ListIterator job_gres_iter;
+	gres_state_t *job_gres_ptr, *node_gres_ptr, **node_gres_array;
 	bool topo_set = false;
 
 	if (job_gres_list == NULL)
@@ -6435,25 +6527,25 @@ extern uint32_t gres_plugin_job_test(List job_gres_list, List node_gres_list,
 	(void) gres_plugin_init();
 
 	slurm_mutex_lock(&gres_context_lock);
+	node_gres_array = _build_node_gres_array(node_gres_list);
 	job_gres_iter = list_iterator_create(job_gres_list);
 	while ((job_gres_ptr = (gres_state_t *) list_next(job_gres_iter))) {
-		node_gres_iter = list_iterator_create(node_gres_list);
-		while ((node_gres_ptr = (gres_state_t *)
-				list_next(node_gres_iter))) {
-			if (job_gres_ptr->plugin_id == node_gres_ptr->plugin_id)
-				break;
+		i = _gres_context_inx(job_gres_ptr->plugin_id);
+		if (i >= 0) {
+			node_gres_ptr = node_gres_array[i];
+		} else {
+			/* A likely sign that GresPlugins has changed */
+			node_gres_ptr = list_find_first(node_gres_list,
+						_gres_find_id,
+						&job_gres_ptr->plugin_id);
 		}
-		list_iterator_destroy(node_gres_iter);
 		if (node_gres_ptr == NULL) {
 			/* node lack resources required by the job */
 			core_cnt = 0;
 			break;
 		}
 
-		for (i = 0; i < gres_context_cnt; i++) {
-			if (job_gres_ptr->plugin_id !=
-			    gres_context[i].plugin_id)
-				continue;
+		if (i >= 0) {
 			tmp_cnt = _job_test(job_gres_ptr->gres_data,
 					    node_gres_ptr->gres_data,
 					    use_total_gres, core_bitmap,
@@ -6467,12 +6559,12 @@ extern uint32_t gres_plugin_job_test(List job_gres_list, List node_gres_list,
 				else
 					core_cnt = MIN(tmp_cnt, core_cnt);
 			}
-			break;
 		}
 		if (core_cnt == 0)
 			break;
 	}
 	list_iterator_destroy(job_gres_iter);
+	xfree(node_gres_array);
 	slurm_mutex_unlock(&gres_context_lock);
 
 	return core_cnt;
@@ -7041,11 +7133,12 @@ extern List gres_plugin_job_test2(List job_gres_list, List node_gres_list,
 				  const uint32_t node_inx)
 {
 	List sock_gres_list = NULL;
-	ListIterator job_gres_iter,  node_gres_iter;
-	gres_state_t *job_gres_ptr, *node_gres_ptr;
+	ListIterator job_gres_iter;
+	gres_state_t *job_gres_ptr, *node_gres_ptr, **node_gres_array;
 	gres_job_state_t  *job_data_ptr;
 	gres_node_state_t *node_data_ptr;
 	uint32_t local_s_p_n;
+	int i;
 
 	if (!job_gres_list || (list_count(job_gres_list) == 0))
 		return sock_gres_list;
@@ -7055,16 +7148,19 @@ extern List gres_plugin_job_test2(List job_gres_list, List node_gres_list,
 
 	sock_gres_list = list_create(_sock_gres_del);
 	slurm_mutex_lock(&gres_context_lock);
+	node_gres_array = _build_node_gres_array(node_gres_list);
 	job_gres_iter = list_iterator_create(job_gres_list);
 	while ((job_gres_ptr = (gres_state_t *) list_next(job_gres_iter))) {
 		sock_gres_t *sock_gres = NULL;
-		node_gres_iter = list_iterator_create(node_gres_list);
-		while ((node_gres_ptr = (gres_state_t *)
-				list_next(node_gres_iter))) {
-			if (job_gres_ptr->plugin_id == node_gres_ptr->plugin_id)
-				break;
+		i = _gres_context_inx(job_gres_ptr->plugin_id);
+		if (i >= 0) {
+			node_gres_ptr = node_gres_array[i];
+		} else {
+			/* A likely sign that GresPlugins has changed */
+			node_gres_ptr = list_find_first(node_gres_list,
+						_gres_find_id,
+						&job_gres_ptr->plugin_id);
 		}
-		list_iterator_destroy(node_gres_iter);
 		if (node_gres_ptr == NULL) {
 			/* node lack GRES of type required by the job */
 			FREE_NULL_LIST(sock_gres_list);
@@ -7090,15 +7186,11 @@ extern List gres_plugin_job_test2(List job_gres_list, List node_gres_list,
 					alt_plugin_id = gpu_plugin_id;
 			}
 			if (alt_plugin_id) {
-				node_gres_iter =
-					list_iterator_create(node_gres_list);
-				while ((node_gres_ptr = (gres_state_t *)
-						list_next(node_gres_iter))) {
-					if (node_gres_ptr->plugin_id ==
-					    alt_plugin_id)
-						break;
-				}
-				list_iterator_destroy(node_gres_iter);
+				i = _gres_context_inx(alt_plugin_id);
+				if (i >= 0)
+					node_gres_ptr = node_gres_array[i];
+				else
+					node_gres_ptr = NULL;
 			}
 			if (alt_plugin_id && node_gres_ptr) {
 				alt_node_data_ptr = (gres_node_state_t *)
@@ -7139,6 +7231,7 @@ extern List gres_plugin_job_test2(List job_gres_list, List node_gres_list,
 		list_append(sock_gres_list, sock_gres);
 	}
 	list_iterator_destroy(job_gres_iter);
+	xfree(node_gres_array);
 	slurm_mutex_unlock(&gres_context_lock);
 
 	if (gres_debug)
@@ -9776,6 +9869,7 @@ static int _job_alloc(void *job_gres_data, void *node_gres_data, int node_cnt,
 					bit_alloc(node_gres_ptr->topo_cnt);
 				bit_set(node_gres_ptr->topo_gres_bitmap[i], i);
 			}
+			FREE_NULL_BITMAP(node_gres_ptr->topo_core_any_bitmap);
 		}
 
 		for (i = 0; i < len; i++) {
@@ -9880,8 +9974,8 @@ extern int gres_plugin_job_alloc(List job_gres_list, List node_gres_list,
 				 bitstr_t *core_bitmap, uint32_t user_id)
 {
 	int i, rc, rc2;
-	ListIterator job_gres_iter,  node_gres_iter;
-	gres_state_t *job_gres_ptr, *node_gres_ptr;
+	ListIterator job_gres_iter;
+	gres_state_t *job_gres_ptr, *node_gres_ptr, **node_gres_array;
 
 	if (job_gres_list == NULL)
 		return SLURM_SUCCESS;
@@ -9894,14 +9988,11 @@ extern int gres_plugin_job_alloc(List job_gres_list, List node_gres_list,
 	rc = gres_plugin_init();
 
 	slurm_mutex_lock(&gres_context_lock);
+	node_gres_array = _build_node_gres_array(node_gres_list);
 	job_gres_iter = list_iterator_create(job_gres_list);
 	while ((job_gres_ptr = (gres_state_t *) list_next(job_gres_iter))) {
-		for (i = 0; i < gres_context_cnt; i++) {
-			if (job_gres_ptr->plugin_id ==
-			    gres_context[i].plugin_id)
-				break;
-		}
-		if (i >= gres_context_cnt) {
+		i = _gres_context_inx(job_gres_ptr->plugin_id);
+		if (i < 0) {
 			error("%s: no plugin configured for data type %u for job %u and node %s",
 			      __func__, job_gres_ptr->plugin_id, job_id,
 			      node_name);
@@ -9909,13 +10000,7 @@ extern int gres_plugin_job_alloc(List job_gres_list, List node_gres_list,
 			continue;
 		}
 
-		node_gres_iter = list_iterator_create(node_gres_list);
-		while ((node_gres_ptr = (gres_state_t *)
-				list_next(node_gres_iter))) {
-			if (job_gres_ptr->plugin_id == node_gres_ptr->plugin_id)
-				break;
-		}
-		list_iterator_destroy(node_gres_iter);
+		node_gres_ptr = node_gres_array[i];
 		if (node_gres_ptr == NULL) {
 			error("%s: job %u allocated gres/%s on node %s lacking that gres",
 			      __func__, job_id, gres_context[i].gres_name,
@@ -9932,6 +10017,7 @@ extern int gres_plugin_job_alloc(List job_gres_list, List node_gres_list,
 			rc = rc2;
 	}
 	list_iterator_destroy(job_gres_iter);
+	xfree(node_gres_array);
 	slurm_mutex_unlock(&gres_context_lock);
 
 	return rc;
@@ -10165,8 +10251,8 @@ extern int gres_plugin_job_dealloc(List job_gres_list, List node_gres_list,
 				   uint32_t user_id, bool job_fini)
 {
 	int i, rc, rc2;
-	ListIterator job_gres_iter,  node_gres_iter;
-	gres_state_t *job_gres_ptr, *node_gres_ptr;
+	ListIterator job_gres_iter;
+	gres_state_t *job_gres_ptr, *node_gres_ptr, **node_gres_array;
 	char *gres_name = NULL;
 
 	if (job_gres_list == NULL)
@@ -10180,29 +10266,23 @@ extern int gres_plugin_job_dealloc(List job_gres_list, List node_gres_list,
 	rc = gres_plugin_init();
 
 	slurm_mutex_lock(&gres_context_lock);
+	node_gres_array = _build_node_gres_array(node_gres_list);
 	job_gres_iter = list_iterator_create(job_gres_list);
 	while ((job_gres_ptr = (gres_state_t *) list_next(job_gres_iter))) {
-		for (i = 0; i < gres_context_cnt; i++) {
-			if (job_gres_ptr->plugin_id ==
-			    gres_context[i].plugin_id)
-				break;
-		}
-		if (i >= gres_context_cnt) {
+		i = _gres_context_inx(job_gres_ptr->plugin_id);
+		if (i < 0) {
 			error("%s: no plugin configured for data type %u for job %u and node %s",
 			      __func__, job_gres_ptr->plugin_id, job_id,
 			      node_name);
 			/* A likely sign that GresPlugins has changed */
 			gres_name = "UNKNOWN";
-		} else
+			node_gres_ptr = list_find_first(node_gres_list,
+						_gres_find_id,
+						&job_gres_ptr->plugin_id);
+		} else {
 			gres_name = gres_context[i].gres_name;
-
-		node_gres_iter = list_iterator_create(node_gres_list);
-		while ((node_gres_ptr = (gres_state_t *)
-				list_next(node_gres_iter))) {
-			if (job_gres_ptr->plugin_id == node_gres_ptr->plugin_id)
-				break;
+			node_gres_ptr = node_gres_array[i];
 		}
-		list_iterator_destroy(node_gres_iter);
 		if (node_gres_ptr == NULL) {
 			error("%s: node %s lacks gres/%s for job %u", __func__,
 			      node_name, gres_name , job_id);
@@ -10217,6 +10297,7 @@ extern int gres_plugin_job_dealloc(List job_gres_list, List node_gres_list,
 			rc = rc2;
 	}
 	list_iterator_destroy(job_gres_iter);
+	xfree(node_gres_array);
 	slurm_mutex_unlock(&gres_context_lock);
 
 	return rc;
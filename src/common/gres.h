@@ -154,6 +154,14 @@ typedef struct gres_node_state {
 	uint32_t *topo_type_id;		/* GRES type (e.g. model ID) */
 	char **topo_type_name;		/* GRES type (e.g. model name) */
 
+	/*
+	 * Union of cores in topo_core_bitmap[] entries with any GRES
+	 * available, all bits set if some such entry has no core binding.
+	 * Used to accelerate core filtering for untyped GRES requests.
+	 * Set NULL if needs to be rebuilt.
+	 */
+	bitstr_t *topo_core_any_bitmap;
+
 	/*
 	 * GRES type specific information (if gres.conf contains type option)
 	 *
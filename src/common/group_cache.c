@@ -51,6 +51,7 @@
 
 #include "src/common/group_cache.h"
 #include "src/common/list.h"
+#include "src/common/macros.h"
 #include "src/common/read_config.h"
 #include "src/common/timers.h"
 #include "src/common/uid.h"
@@ -60,15 +61,26 @@
 /* how many groups to use by default to avoid repeated calls to getgrouplist */
 #define NGROUPS_START 64
 
+/* how long to remember that the name service does not know a user */
+#define NEGATIVE_TIME 120
+
 typedef struct gids_cache {
 	uid_t uid;
 	gid_t gid;
 	char *username;
 	int ngids;
 	gid_t *gids;
+	bool negative;		/* name service did not know the user */
+	bool refreshing;	/* background refresh in flight */
 	time_t expiration;
 } gids_cache_t;
 
+typedef struct {
+	uid_t uid;
+	gid_t gid;
+	char *username;		/* NULL means resolve it again */
+} gids_refresh_args_t;
+
 typedef struct gids_cache_needle {
 	uid_t uid;		/* required */
 	gid_t gid;		/* required */
@@ -112,6 +124,84 @@ static int _find_entry(void *x, void *key)
 	return 1;
 }
 
+/*
+ * Resolve the group list for a user.  Must be called without gids_mutex
+ * held so a slow name service cannot stall unrelated lookups.
+ * OUT: gids_ptr - xmalloc'd array of gids
+ * RET: number of gids
+ */
+static int _fetch_gids(char *username, gid_t gid, gid_t **gids_ptr)
+{
+	int ngids = NGROUPS_START;
+	gid_t *gids = xmalloc(sizeof(gid_t) * ngids);
+
+#if defined(__APPLE__)
+	/*
+	 * macOS has (int *) for the third argument instead
+	 * of (gid_t *) like FreeBSD, NetBSD, and Linux.
+	 */
+	while (getgrouplist(username, gid, (int *) gids, &ngids) == -1) {
+#else
+	while (getgrouplist(username, gid, gids, &ngids) == -1) {
+#endif
+		/* group list larger than array, resize array to fit */
+		gids = xrealloc(gids, ngids * sizeof(gid_t));
+	}
+
+	*gids_ptr = gids;
+	return ngids;
+}
+
+/*
+ * Refresh a stale entry in the background.  The stale groups keep
+ * being served while this runs, so directory latency stays off the
+ * RPC path.
+ */
+static void *_refresh_thread(void *x)
+{
+	gids_refresh_args_t *args = x;
+	gids_cache_needle_t needle = { .uid = args->uid, .gid = args->gid };
+	gids_cache_t *entry;
+	gid_t *new_gids = NULL;
+	int new_ngids;
+	bool negative = false;
+
+	if (!args->username)
+		args->username = uid_to_string_or_null(args->uid);
+
+	if (!args->username) {
+		/* unknown user, only the primary gid can be handed back */
+		negative = true;
+		new_ngids = 1;
+		new_gids = xmalloc(sizeof(gid_t));
+		new_gids[0] = args->gid;
+	} else
+		new_ngids = _fetch_gids(args->username, args->gid, &new_gids);
+
+	slurm_mutex_lock(&gids_mutex);
+	if (gids_cache_list &&
+	    (entry = list_find_first(gids_cache_list, _find_entry, &needle))) {
+		xfree(entry->gids);
+		entry->gids = new_gids;
+		entry->ngids = new_ngids;
+		entry->negative = negative;
+		if (!entry->username) {
+			entry->username = args->username;
+			args->username = NULL;
+		}
+		entry->expiration = time(NULL) +
+			(negative ? NEGATIVE_TIME : slurmctld_conf.group_time);
+		entry->refreshing = false;
+		new_gids = NULL;
+	}
+	slurm_mutex_unlock(&gids_mutex);
+
+	xfree(new_gids);
+	xfree(args->username);
+	xfree(args);
+	return NULL;
+}
+
 /*
  * OUT: ngids as return value
  * IN: populated needle structure
@@ -122,6 +212,11 @@ static int _group_cache_lookup_internal(gids_cache_needle_t *needle, gid_t **gid
 {
 	gids_cache_t *entry;
 	int ngids; /* need a copy to safely return outside the lock */
+	char *username = NULL;
+	gid_t *fetched_gids = NULL;
+	int fetched_ngids;
+	bool negative = false, spawn_refresh = false;
+	char *refresh_username = NULL;
 	DEF_TIMERS;
 	START_TIMER;
 
@@ -139,50 +234,73 @@ static int _group_cache_lookup_internal(gids_cache_needle_t *needle, gid_t **gid
 	}
 
 	if (entry) {
-		debug2("%s: found old entry for %s, looking up again",
+		/*
+		 * The entry went stale.  Serve the cached groups right
+		 * away and have a background thread talk to the name
+		 * service, unless one is already doing so.
+		 */
+		if (!entry->refreshing) {
+			entry->refreshing = true;
+			spawn_refresh = true;
+			if (!entry->negative)
+				refresh_username = xstrdup(entry->username);
+		}
+		debug2("%s: found old entry for %s, refreshing in background",
 		       __func__, entry->username);
+		goto out;
+	}
+
+	/*
+	 * Nothing cached for this user yet, so the name service has to
+	 * be asked before anything can be handed back.  Drop the mutex
+	 * for the resolution so only this one request waits on it; a
+	 * concurrent miss for the same user just repeats the work and
+	 * reaches the same answer.
+	 */
+	slurm_mutex_unlock(&gids_mutex);
+
+	if (needle->username)
+		username = xstrdup(needle->username);
+	else
+		username = uid_to_string_or_null(needle->uid);
+
+	if (!username) {
 		/*
-		 * The timestamp is too old, need to replace the values.
-		 * Reuse the same gids_cache_t entry, just reset the
-		 * ngids to the largest the gids field can store.
+		 * Unknown user.  Remember that for a while so repeated
+		 * requests from a bad uid do not each query the
+		 * directory, and hand back just the primary gid.
 		 */
-		entry->ngids = xsize(entry->gids) / sizeof(gid_t);
+		negative = true;
+		fetched_ngids = 1;
+		fetched_gids = xmalloc(sizeof(gid_t));
+		fetched_gids[0] = needle->gid;
+		debug2("%s: no entry found for unknown uid=%u",
+		       __func__, needle->uid);
 	} else {
-		/* no result, allocate and add to list */
+		debug2("%s: no entry found for %s", __func__, username);
+		fetched_ngids = _fetch_gids(username, needle->gid,
+					    &fetched_gids);
+	}
+
+	slurm_mutex_lock(&gids_mutex);
+	if (!gids_cache_list)	/* raced with group_cache_purge() */
+		gids_cache_list = list_create(_group_cache_list_delete);
+
+	entry = list_find_first(gids_cache_list, _find_entry, needle);
+	if (!entry) {
 		entry = xmalloc(sizeof(gids_cache_t));
-		if (!needle->username)
-			entry->username = uid_to_string(needle->uid);
-		else
-			entry->username = xstrdup(needle->username);
 		entry->uid = needle->uid;
 		entry->gid = needle->gid;
-		entry->ngids = NGROUPS_START;
-		entry->gids = xmalloc(sizeof(gid_t) * entry->ngids);
 		list_prepend(gids_cache_list, entry);
-
-		debug2("%s: no entry found for %s",
-		       __func__, entry->username);
-	}
-
-	entry->expiration = needle->now + slurmctld_conf.group_time;
-
-	/* Cache lookup failed or entry value was too old, fetch new
-	 * value and insert it into cache.  */
-#if defined(__APPLE__)
-	/*
-	 * macOS has (int *) for the third argument instead
-	 * of (gid_t *) like FreeBSD, NetBSD, and Linux.
-	 */
-	while (getgrouplist(entry->username, entry->gid,
-			    (int *)entry->gids, &entry->ngids) == -1) {
-#else
-	while (getgrouplist(entry->username, entry->gid,
-			    entry->gids, &entry->ngids) == -1) {
-#endif
-		/* group list larger than array, resize array to fit */
-		entry->gids = xrealloc(entry->gids,
-				       entry->ngids * sizeof(gid_t));
 	}
+	xfree(entry->gids);
+	entry->gids = fetched_gids;
+	entry->ngids = fetched_ngids;
+	xfree(entry->username);
+	entry->username = username;
+	entry->negative = negative;
+	entry->expiration = needle->now +
+		(negative ? NEGATIVE_TIME : slurmctld_conf.group_time);
 
 out:
 	ngids = entry->ngids;
@@ -191,6 +309,15 @@ out:
 
 	slurm_mutex_unlock(&gids_mutex);
 
+	if (spawn_refresh) {
+		gids_refresh_args_t *args = xmalloc(sizeof(*args));
+
+		args->uid = needle->uid;
+		args->gid = needle->gid;
+		args->username = refresh_username;
+		slurm_thread_create_detached(NULL, _refresh_thread, args);
+	}
+
 	END_TIMER3("group_cache_lookup() took",
 		   3000000);
 
@@ -215,11 +342,58 @@ extern int group_cache_lookup(uid_t uid, gid_t gid, char *username, gid_t **gids
 	return _group_cache_lookup_internal(&needle, gids);
 }
 
+typedef struct {
+	group_cache_user_t *users;
+	int user_cnt;
+} prefetch_args_t;
+
+static void *_prefetch_thread(void *x)
+{
+	prefetch_args_t *args = x;
+
+	for (int i = 0; i < args->user_cnt; i++) {
+		gid_t *gids = NULL;
+
+		(void) group_cache_lookup(args->users[i].uid,
+					  args->users[i].gid, NULL, &gids);
+		xfree(gids);
+	}
+
+	xfree(args->users);
+	xfree(args);
+	return NULL;
+}
+
+/*
+ * Warm the cache for a set of users in a single background thread so the
+ * first requests after startup do not each wait on the name service.
+ * IN: users - xmalloc'd array, ownership is taken here
+ * IN: user_cnt - number of elements in users
+ */
+extern void group_cache_prefetch(group_cache_user_t *users, int user_cnt)
+{
+	prefetch_args_t *args;
+
+	if (!users || (user_cnt <= 0)) {
+		xfree(users);
+		return;
+	}
+
+	args = xmalloc(sizeof(*args));
+	args->users = users;
+	args->user_cnt = user_cnt;
+	slurm_thread_create_detached(NULL, _prefetch_thread, args);
+}
+
 static int _cleanup_search(void *x, void *key)
 {
 	gids_cache_t *cached = (gids_cache_t *) x;
 	time_t *now = (time_t *) key;
 
+	/* a background refresh is about to renew this entry */
+	if (cached->refreshing)
+		return 0;
+
 	if (cached->expiration < *now)
 		return 1;
 
@@ -49,6 +49,18 @@
  */
 extern int group_cache_lookup(uid_t uid, gid_t gid, char *username, gid_t **gids);
 
+typedef struct {
+	uid_t uid;
+	gid_t gid;	/* primary group id */
+} group_cache_user_t;
+
+/*
+ * Warm the cache for a set of users in a single background thread.
+ * IN: users - xmalloc'd array, ownership is taken here
+ * IN: user_cnt - number of elements in users
+ */
+extern void group_cache_prefetch(group_cache_user_t *users, int user_cnt);
+
 /* call on daemon shutdown to cleanup properly */
 void group_cache_purge(void);
 
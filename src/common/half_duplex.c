@@ -35,6 +35,15 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include "config.h"
+
+#define _GNU_SOURCE /* for splice(2) */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
 #include "src/common/eio.h"
 #include "src/common/half_duplex.h"
 #include "src/common/list.h"
@@ -42,6 +51,14 @@
 
 #define BUFFER_SIZE 4096
 
+typedef struct half_duplex_arg {
+	int *fd_out;
+#if defined(__linux__)
+	int pipe_fd[2];		/* intermediate pipe for splice(2), or -1 */
+	bool no_splice;		/* these fds want the copy path */
+#endif
+} half_duplex_arg_t;
+
 static bool _half_duplex_readable(eio_obj_t *obj);
 static int _half_duplex(eio_obj_t *obj, List objs);
 
@@ -50,13 +67,46 @@ struct io_operations half_duplex_ops = {
 	.handle_read = _half_duplex,
 };
 
+/*
+ * half_duplex_obj_create - create an eio object relaying everything
+ *	read from fd into *fd_out
+ * IN fd - file descriptor to read from
+ * IN fd_out - xmalloc'd file descriptor to write to, owned by the
+ *	object from here on
+ * RET the eio object, add it to a handle with eio_new_obj()
+ */
+extern eio_obj_t *half_duplex_obj_create(int fd, int *fd_out)
+{
+	half_duplex_arg_t *arg = xmalloc(sizeof(half_duplex_arg_t));
+
+	arg->fd_out = fd_out;
+#if defined(__linux__)
+	arg->pipe_fd[0] = arg->pipe_fd[1] = -1;
+#endif
+
+	return eio_obj_create(fd, &half_duplex_ops, arg);
+}
+
+static void _free_half_duplex_arg(half_duplex_arg_t *arg)
+{
+#if defined(__linux__)
+	if (arg->pipe_fd[0] != -1) {
+		close(arg->pipe_fd[0]);
+		close(arg->pipe_fd[1]);
+	}
+#endif
+	xfree(arg->fd_out);
+	xfree(arg);
+}
+
 static bool _half_duplex_readable(eio_obj_t *obj)
 {
 	if (obj->shutdown) {
-		int *fd_out = (int *) obj->arg;
-		if (fd_out) {
-			shutdown(*fd_out, SHUT_WR);
-			xfree(obj->arg);
+		half_duplex_arg_t *arg = obj->arg;
+		if (arg) {
+			shutdown(*arg->fd_out, SHUT_WR);
+			_free_half_duplex_arg(arg);
+			obj->arg = NULL;
 		}
 		shutdown(obj->fd, SHUT_RD);
 		return false;
@@ -64,15 +114,111 @@ static bool _half_duplex_readable(eio_obj_t *obj)
 	return true;
 }
 
+#if defined(__linux__)
+/* Ask for more than the pipe holds, splice moves what fits */
+#define SPLICE_MAX_CHUNK (1024 * 1024)
+
+/* Wait for the output fd to accept more data mid-transfer */
+static void _wait_writable(int fd)
+{
+	struct pollfd pfd;
+
+	pfd.fd = fd;
+	pfd.events = POLLOUT;
+	(void) poll(&pfd, 1, -1);
+}
+
+/*
+ * Relay through an intermediate pipe with splice(2), moving page
+ * references instead of copying the payload through user space.  The
+ * pipe is drained completely on every pass, so the relayed stream is
+ * never left sitting in it between events.
+ * RET 0 on success, -1 on EOF or error (caller shuts the relay down),
+ *	1 if these descriptors can not be spliced and the copy path
+ *	must be used instead
+ */
+static int _half_duplex_splice(eio_obj_t *obj, half_duplex_arg_t *arg)
+{
+	ssize_t in, out, wr;
+	bool moved = false;
+
+	if (arg->pipe_fd[0] == -1) {
+		if (pipe(arg->pipe_fd) < 0) {
+			error("%s: pipe: %m", __func__);
+			arg->pipe_fd[0] = arg->pipe_fd[1] = -1;
+			return 1;
+		}
+	}
+
+	while (true) {
+		in = splice(obj->fd, NULL, arg->pipe_fd[1], NULL,
+			    SPLICE_MAX_CHUNK,
+			    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+		if (in == 0) {
+			if (moved)	/* report EOF on the next event */
+				return 0;
+			debug("%s: shutting down %d -> %d",
+			      __func__, obj->fd, *arg->fd_out);
+			return -1;
+		}
+		if (in < 0) {
+			if (errno == EINTR)
+				continue;
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				return 0;	/* input drained */
+			if (((errno == EINVAL) || (errno == ENOSYS)) &&
+			    !moved)
+				return 1;
+			error("%s: splice read error: %m", __func__);
+			return -1;
+		}
+		moved = true;
+
+		/* the pipe holds the bytes now, they must all go out */
+		wr = 0;
+		while (wr < in) {
+			out = splice(arg->pipe_fd[0], NULL, *arg->fd_out,
+				     NULL, in - wr, SPLICE_F_MOVE);
+			if ((out < 0) && (errno == EINTR))
+				continue;
+			if ((out < 0) &&
+			    ((errno == EAGAIN) || (errno == EWOULDBLOCK))) {
+				_wait_writable(*arg->fd_out);
+				continue;
+			}
+			if (out <= 0) {
+				error("%s: wrote %zd of %zd",
+				      __func__, out, in);
+				return -1;
+			}
+			wr += out;
+		}
+	}
+}
+#endif	/* __linux__ */
+
 static int _half_duplex(eio_obj_t *obj, List objs)
 {
 	ssize_t in, out, wr = 0;
 	char buf[BUFFER_SIZE];
-	int *fd_out = (int *) obj->arg;
+	half_duplex_arg_t *arg = obj->arg;
+	int *fd_out = arg ? arg->fd_out : NULL;
 
 	if (obj->shutdown || !fd_out)
 		goto shutdown;
 
+#if defined(__linux__)
+	if (!arg->no_splice) {
+		int rc = _half_duplex_splice(obj, arg);
+		if (rc == 0)
+			return 0;
+		if (rc < 0)
+			goto shutdown;
+		/* splice is not usable on these fds, copy instead */
+		arg->no_splice = true;
+	}
+#endif
+
 	in = read(obj->fd, buf, sizeof(buf));
 	if (in == 0) {
 		debug("%s: shutting down %d -> %d",
@@ -84,7 +230,7 @@ static int _half_duplex(eio_obj_t *obj, List objs)
 	}
 
 	while (wr < in) {
-		out = write(*fd_out, buf, in - wr);
+		out = write(*fd_out, buf + wr, in - wr);
 		if (out <= 0) {
 			error("%s: wrote %zd of %zd", __func__, out, in);
 			goto shutdown;
@@ -96,9 +242,10 @@ static int _half_duplex(eio_obj_t *obj, List objs)
 shutdown:
 	obj->shutdown = true;
 	shutdown(obj->fd, SHUT_RD);
-	if (fd_out) {
-		shutdown(*fd_out, SHUT_WR);
-		xfree(fd_out);
+	if (arg) {
+		shutdown(*arg->fd_out, SHUT_WR);
+		_free_half_duplex_arg(arg);
+		obj->arg = NULL;
 	}
 	eio_remove_obj(obj, objs);
 	return 0;
@@ -38,6 +38,18 @@
 #ifndef _SLURM_HALF_DUPLEX_H
 #define _SLURM_HALF_DUPLEX_H
 
+#include "src/common/eio.h"
+
 extern struct io_operations half_duplex_ops;
 
+/*
+ * half_duplex_obj_create - create an eio object relaying everything
+ *	read from fd into *fd_out
+ * IN fd - file descriptor to read from
+ * IN fd_out - xmalloc'd file descriptor to write to, owned by the
+ *	object from here on
+ * RET the eio object, add it to a handle with eio_new_obj()
+ */
+extern eio_obj_t *half_duplex_obj_create(int fd, int *fd_out);
+
 #endif
@@ -71,6 +71,7 @@ strong_alias(hostlist_create_dims,	slurm_hostlist_create_dims);
 strong_alias(hostlist_create,		slurm_hostlist_create);
 strong_alias(hostlist_copy,		slurm_hostlist_copy);
 strong_alias(hostlist_count,		slurm_hostlist_count);
+strong_alias(hostlist_count_ranges,	slurm_hostlist_count_ranges);
 strong_alias(hostlist_delete,		slurm_hostlist_delete);
 strong_alias(hostlist_delete_host,	slurm_hostlist_delete_host);
 strong_alias(hostlist_delete_nth,	slurm_hostlist_delete_nth);
@@ -1938,11 +1939,72 @@ error:
 
 
 
+/*
+ * Cache of recently compiled hostlists, keyed on the source string and
+ * dimension count.  slurmctld parses the same node expressions over and
+ * over (one hostlist_create() per RPC or job referencing the expression)
+ * and copying an already compiled range array is far cheaper than the
+ * character level parse.  Only modest sized strings are retained so the
+ * cache memory use stays bounded; entries are replaced in place on
+ * collision.  The cached master is never handed out, each hit returns a
+ * private copy which the caller may modify and destroy as usual.
+ */
+#define HL_CACHE_SIZE		64
+#define HL_CACHE_STR_MAX	512
+
+typedef struct {
+	int dims;		/* dimensions used at parse time */
+	hostlist_t hl;		/* compiled master, never handed out */
+	char *str;		/* source string */
+} hl_cache_ent_t;
+
+static hl_cache_ent_t hl_cache[HL_CACHE_SIZE];
+static pthread_mutex_t hl_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static unsigned int _hl_cache_index(const char *str)
+{
+	unsigned int hash = 5381;
+
+	while (*str)
+		hash = ((hash << 5) + hash) + *str++;
+	return hash % HL_CACHE_SIZE;
+}
+
 hostlist_t hostlist_create_dims(const char *str, int dims)
 {
+	hl_cache_ent_t *ent = NULL;
+	hostlist_t new;
+
 	if (!dims)
 		dims = slurmdb_setup_cluster_name_dims();
-	return _hostlist_create(str, "\t, ", "-", dims);
+
+	if (str && (strlen(str) <= HL_CACHE_STR_MAX)) {
+		ent = &hl_cache[_hl_cache_index(str)];
+		slurm_mutex_lock(&hl_cache_mutex);
+		if (ent->str && (ent->dims == dims) &&
+		    (strcmp(ent->str, str) == 0)) {
+			new = hostlist_copy(ent->hl);
+			slurm_mutex_unlock(&hl_cache_mutex);
+			return new;
+		}
+		slurm_mutex_unlock(&hl_cache_mutex);
+	}
+
+	new = _hostlist_create(str, "\t, ", "-", dims);
+
+	if (new && ent) {
+		hostlist_t master = hostlist_copy(new);
+
+		slurm_mutex_lock(&hl_cache_mutex);
+		hostlist_destroy(ent->hl);
+		xfree(ent->str);
+		ent->str = xstrdup(str);
+		ent->dims = dims;
+		ent->hl = master;
+		slurm_mutex_unlock(&hl_cache_mutex);
+	}
+
+	return new;
 }
 
 hostlist_t hostlist_create(const char *str)
@@ -2409,6 +2471,18 @@ int hostlist_count(hostlist_t hl)
 	return retval;
 }
 
+int hostlist_count_ranges(hostlist_t hl)
+{
+	int retval;
+	if (!hl)
+		return -1;
+
+	LOCK_HOSTLIST(hl);
+	retval = hl->nranges;
+	UNLOCK_HOSTLIST(hl);
+	return retval;
+}
+
 int hostlist_find_dims(hostlist_t hl, const char *hostname, int dims)
 {
 	int i, count, ret = -1;
@@ -3146,10 +3220,37 @@ char *hostlist_ranged_string_malloc(hostlist_t hl)
 	return buf;
 }
 
+/*
+ * Upper bound on the buffer needed by hostlist_ranged_string_dims(),
+ * computed in one pass over the compiled ranges: every range may emit
+ * its prefix, two padded numbers, a dash, brackets and a comma.  The
+ * actual output is smaller since consecutive ranges share a prefix.
+ */
+static size_t _ranged_string_size_bound(hostlist_t hl)
+{
+	size_t bound = 1;	/* NUL */
+	size_t numeric;
+	int i;
+
+	LOCK_HOSTLIST(hl);
+	for (i = 0; i < hl->nranges; i++) {
+		/* 20 digits covers any unsigned long suffix */
+		numeric = MAX(hl->hr[i]->width, 20) + 1;
+		bound += strlen(hl->hr[i]->prefix) + (2 * numeric) + 4;
+	}
+	UNLOCK_HOSTLIST(hl);
+	return bound;
+}
+
 char *hostlist_ranged_string_xmalloc_dims(hostlist_t hl, int dims, int brackets)
 {
-	int buf_size = 8192;
+	int buf_size = _ranged_string_size_bound(hl);
 	char *buf = xmalloc_nz(buf_size);
+	/*
+	 * The bound holds for the bracketed range format, so the conversion
+	 * normally runs exactly once.  Multi-dimension box notation can
+	 * exceed it, in which case fall back on doubling and retrying.
+	 */
 	while (hostlist_ranged_string_dims(
 		       hl, buf_size, buf, dims, brackets) < 0) {
 		buf_size *= 2;
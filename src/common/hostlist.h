@@ -319,6 +319,15 @@ int hostlist_delete_nth(hostlist_t hl, int n);
  */
 int hostlist_count(hostlist_t hl);
 
+/* hostlist_count_ranges():
+ *
+ * Return the number of compiled ranges in hostlist hl.  This is an
+ * upper bound on the number of comma separated tokens which
+ * hostlist_ranged_string() will emit, useful for sizing output ahead
+ * of the conversion.
+ */
+int hostlist_count_ranges(hostlist_t hl);
+
 /* hostlist_is_empty(): return true if hostlist is empty. */
 #define hostlist_is_empty(__hl) ( hostlist_count(__hl) == 0 )
 
@@ -40,7 +40,8 @@
 #include "src/common/io_hdr.h"
 #include "src/common/slurm_protocol_defs.h"
 
-#define IO_PROTOCOL_VERSION 0xb001
+/* 0xb002: MAX_MSG_LEN raised from 1024 to 16k */
+#define IO_PROTOCOL_VERSION 0xb002
 
 /* If this changes, io_hdr_pack|unpack must change. */
 int g_io_hdr_size = sizeof(uint32_t) + 3*sizeof(uint16_t);
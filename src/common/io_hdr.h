@@ -46,7 +46,12 @@
 #include "src/common/cbuf.h"
 #include "src/common/xmalloc.h"
 
-#define MAX_MSG_LEN 1024
+/* Maximum frame size on the task I/O connections. Larger frames mean
+ * fewer header reads and write() calls per byte of output, which is
+ * what bounds srun's stdio fan-in rate on large task counts. Changing
+ * this requires bumping IO_PROTOCOL_VERSION (io_hdr.c) since both ends
+ * size their buffers from it. */
+#define MAX_MSG_LEN (16 * 1024)
 #define SLURM_IO_KEY_SIZE 8
 
 #define SLURM_IO_STDIN 0
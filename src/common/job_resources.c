@@ -546,13 +546,165 @@ extern void log_job_resources(void *void_job_ptr)
 	info("====================");
 }
 
+/*
+ * Pack a per-node uint16 array as run-length encoded (value, reps)
+ * pairs, the same form as the cpu_array_* fields. The nodes of a wide
+ * uniform job cost one pair rather than one element per node.
+ */
+static void _pack16_rle(uint16_t *array, uint32_t cnt, Buf buffer)
+{
+	uint32_t i, run = 0;
+
+	pack32(cnt, buffer);
+	for (i = 1; i <= cnt; i++) {
+		if ((i == cnt) || (array[i] != array[run])) {
+			pack16(array[run], buffer);
+			pack32(i - run, buffer);
+			run = i;
+		}
+	}
+}
+
+/* Unpack an array packed by _pack16_rle(), expanding it to one element
+ * per node. Sets *cnt_p to the expanded element count. */
+static int _unpack16_rle(uint16_t **array_p, uint32_t *cnt_p, Buf buffer)
+{
+	uint16_t *array = NULL, value;
+	uint32_t cnt, reps, inx = 0;
+
+	safe_unpack32(&cnt, buffer);
+	*cnt_p = cnt;
+	*array_p = NULL;
+	if (cnt == 0)
+		return SLURM_SUCCESS;
+
+	array = xcalloc(cnt, sizeof(uint16_t));
+	while (inx < cnt) {
+		safe_unpack16(&value, buffer);
+		safe_unpack32(&reps, buffer);
+		if ((reps == 0) || (reps > (cnt - inx)))
+			goto unpack_error;
+		while (reps--)
+			array[inx++] = value;
+	}
+	*array_p = array;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(array);
+	return SLURM_ERROR;
+}
+
+/* 64-bit variant of _pack16_rle(), used for the per-node memory sizes */
+static void _pack64_rle(uint64_t *array, uint32_t cnt, Buf buffer)
+{
+	uint32_t i, run = 0;
+
+	pack32(cnt, buffer);
+	for (i = 1; i <= cnt; i++) {
+		if ((i == cnt) || (array[i] != array[run])) {
+			pack64(array[run], buffer);
+			pack32(i - run, buffer);
+			run = i;
+		}
+	}
+}
+
+/* 64-bit variant of _unpack16_rle() */
+static int _unpack64_rle(uint64_t **array_p, uint32_t *cnt_p, Buf buffer)
+{
+	uint64_t *array = NULL, value;
+	uint32_t cnt, reps, inx = 0;
+
+	safe_unpack32(&cnt, buffer);
+	*cnt_p = cnt;
+	*array_p = NULL;
+	if (cnt == 0)
+		return SLURM_SUCCESS;
+
+	array = xcalloc(cnt, sizeof(uint64_t));
+	while (inx < cnt) {
+		safe_unpack64(&value, buffer);
+		safe_unpack32(&reps, buffer);
+		if ((reps == 0) || (reps > (cnt - inx)))
+			goto unpack_error;
+		while (reps--)
+			array[inx++] = value;
+	}
+	*array_p = array;
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(array);
+	return SLURM_ERROR;
+}
+
 extern void pack_job_resources(job_resources_t *job_resrcs_ptr, Buf buffer,
 			       uint16_t protocol_version)
 {
 	int i;
 	uint32_t core_cnt = 0, sock_recs = 0;
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		if (job_resrcs_ptr == NULL) {
+			uint32_t empty = NO_VAL;
+			pack32(empty, buffer);
+			return;
+		}
+
+		pack32(job_resrcs_ptr->nhosts, buffer);
+		pack32(job_resrcs_ptr->ncpus, buffer);
+		pack32(job_resrcs_ptr->node_req, buffer);
+		packstr(job_resrcs_ptr->nodes, buffer);
+		pack8(job_resrcs_ptr->whole_node, buffer);
+
+		/*
+		 * The per-node arrays are sent run-length encoded, so
+		 * the pack cost scales with the number of distinct
+		 * per-node shapes rather than the node count. The
+		 * cpu_array_* form is not sent at all, but regenerated
+		 * from cpus on unpack.
+		 */
+		_pack16_rle(job_resrcs_ptr->cpus,
+			    job_resrcs_ptr->cpus ?
+			    job_resrcs_ptr->nhosts : 0, buffer);
+		_pack16_rle(job_resrcs_ptr->cpus_used,
+			    job_resrcs_ptr->cpus_used ?
+			    job_resrcs_ptr->nhosts : 0, buffer);
+		_pack64_rle(job_resrcs_ptr->memory_allocated,
+			    job_resrcs_ptr->memory_allocated ?
+			    job_resrcs_ptr->nhosts : 0, buffer);
+		_pack64_rle(job_resrcs_ptr->memory_used,
+			    job_resrcs_ptr->memory_used ?
+			    job_resrcs_ptr->nhosts : 0, buffer);
+
+		xassert(job_resrcs_ptr->cores_per_socket);
+		xassert(job_resrcs_ptr->sock_core_rep_count);
+		xassert(job_resrcs_ptr->sockets_per_node);
+
+		for (i=0; i < job_resrcs_ptr->nhosts; i++) {
+			core_cnt += job_resrcs_ptr->sockets_per_node[i]
+				* job_resrcs_ptr->cores_per_socket[i] *
+				job_resrcs_ptr->sock_core_rep_count[i];
+			sock_recs += job_resrcs_ptr->
+				     sock_core_rep_count[i];
+			if (sock_recs >= job_resrcs_ptr->nhosts)
+				break;
+		}
+		i++;
+		pack16_array(job_resrcs_ptr->sockets_per_node,
+			     (uint32_t) i, buffer);
+		pack16_array(job_resrcs_ptr->cores_per_socket,
+			     (uint32_t) i, buffer);
+		pack32_array(job_resrcs_ptr->sock_core_rep_count,
+			     (uint32_t) i, buffer);
+
+		xassert(job_resrcs_ptr->core_bitmap);
+		xassert(job_resrcs_ptr->core_bitmap_used);
+		pack_bit_str_hex(job_resrcs_ptr->core_bitmap, buffer);
+		pack_bit_str_hex(job_resrcs_ptr->core_bitmap_used,
+				 buffer);
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		if (job_resrcs_ptr == NULL) {
 			uint32_t empty = NO_VAL;
 			pack32(empty, buffer);
@@ -643,7 +795,57 @@ extern int unpack_job_resources(job_resources_t **job_resrcs_pptr,
 	job_resources_t *job_resrcs;
 
 	xassert(job_resrcs_pptr);
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		safe_unpack32(&empty, buffer);
+		if (empty == NO_VAL) {
+			*job_resrcs_pptr = NULL;
+			return SLURM_SUCCESS;
+		}
+
+		job_resrcs = xmalloc(sizeof(struct job_resources));
+		job_resrcs->nhosts = empty;
+		safe_unpack32(&job_resrcs->ncpus, buffer);
+		safe_unpack32(&job_resrcs->node_req, buffer);
+		safe_unpackstr_xmalloc(&job_resrcs->nodes, &tmp32, buffer);
+		safe_unpack8(&job_resrcs->whole_node, buffer);
+
+		if (_unpack16_rle(&job_resrcs->cpus, &tmp32, buffer)
+		    != SLURM_SUCCESS)
+			goto unpack_error;
+		if (tmp32 != job_resrcs->nhosts)
+			goto unpack_error;
+		if (_unpack16_rle(&job_resrcs->cpus_used, &tmp32, buffer)
+		    != SLURM_SUCCESS)
+			goto unpack_error;
+		if (_unpack64_rle(&job_resrcs->memory_allocated,
+				  &tmp32, buffer) != SLURM_SUCCESS)
+			goto unpack_error;
+		if (_unpack64_rle(&job_resrcs->memory_used, &tmp32, buffer)
+		    != SLURM_SUCCESS)
+			goto unpack_error;
+
+		safe_unpack16_array(&job_resrcs->sockets_per_node,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->sockets_per_node);
+		safe_unpack16_array(&job_resrcs->cores_per_socket,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->cores_per_socket);
+		safe_unpack32_array(&job_resrcs->sock_core_rep_count,
+				    &tmp32, buffer);
+		if (tmp32 == 0)
+			xfree(job_resrcs->sock_core_rep_count);
+
+		unpack_bit_str_hex(&job_resrcs->core_bitmap, buffer);
+		unpack_bit_str_hex(&job_resrcs->core_bitmap_used,
+				   buffer);
+
+		/* Regenerate the cpu_array_* form, which is not sent */
+		if (job_resrcs->cpus &&
+		    (build_job_resources_cpu_array(job_resrcs) < 0))
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&empty, buffer);
 		if (empty == NO_VAL) {
 			*job_resrcs_pptr = NULL;
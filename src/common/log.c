@@ -55,6 +55,7 @@
 #endif
 
 #include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
 #include <pthread.h>
 #include <stdarg.h>
@@ -109,6 +110,7 @@ strong_alias(log_fatal,		slurm_log_fatal);
 strong_alias(log_oom,		slurm_log_oom);
 strong_alias(log_has_data,	slurm_log_has_data);
 strong_alias(log_flush,		slurm_log_flush);
+strong_alias(log_set_async,	slurm_log_set_async);
 strong_alias(log_var,		slurm_log_var);
 strong_alias(fatal,		slurm_fatal);
 strong_alias(fatal_abort,	slurm_fatal_abort);
@@ -158,12 +160,202 @@ extern char * program_invocation_name;
 #endif
 
 
+/*
+ * Asynchronous logfile writes:
+ *
+ * When enabled with log_set_async(), the formatted logfile lines built
+ * by _log_msg() are queued on a bounded ring and written by a dedicated
+ * thread, so that threads holding hot locks do not block on disk I/O
+ * when high debug levels are in effect. If the writer falls behind, new
+ * messages are dropped and counted rather than blocking the caller; the
+ * drop count is reported in the logfile once the writer catches up.
+ * log_flush() drains the ring synchronously, so fatal() still gets
+ * everything out before exit. Only the logfile streams are deferred;
+ * stderr and syslog writes remain synchronous.
+ *
+ * All queue/dequeue operations serialize on async_lock (the producers
+ * already hold log_lock to format the line, so a finer grained queue
+ * would buy nothing); the writer never takes log_lock, so it can not
+ * stall the producers while a write is in flight. The writer works on
+ * private dup()s of the logfile descriptors, refreshed whenever the
+ * logfile is reopened, so log rotation can not close a descriptor out
+ * from under a write.
+ */
+#define LOG_ASYNC_DEPTH 1024
+
+typedef struct {
+	char *line;		/* formatted output line, incl. newline */
+	bool sched;		/* true if destined for the sched logfile */
+} log_async_ent_t;
+
+static pthread_mutex_t  async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   async_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   async_drain_cond = PTHREAD_COND_INITIALIZER;
+static log_async_ent_t  async_ring[LOG_ASYNC_DEPTH];
+static uint32_t         async_head = 0;	/* next entry to write        */
+static uint32_t         async_tail = 0;	/* next entry to fill         */
+static uint32_t         async_dropped = 0;
+static bool             async_writing = false;
+static bool             async_enabled = false;
+static bool             async_shutdown = false;
+static pthread_t        async_thread = 0;
+static int              async_fd = -1;	/* dup of main logfile fd     */
+static int              async_sched_fd = -1; /* dup of sched logfile fd */
+
+static void _async_write(int fd, const char *buf, size_t len)
+{
+	ssize_t written;
+
+	while (len > 0) {
+		written = write(fd, buf, len);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+		buf += written;
+		len -= written;
+	}
+}
+
+static void *_log_async_writer(void *no_data)
+{
+	slurm_mutex_lock(&async_lock);
+	while (true) {
+		if (async_head != async_tail) {
+			log_async_ent_t ent;
+			int fd;
+
+			ent = async_ring[async_head % LOG_ASYNC_DEPTH];
+			async_head++;
+			fd = ent.sched ? async_sched_fd : async_fd;
+			async_writing = true;
+			slurm_mutex_unlock(&async_lock);
+			if (fd >= 0)
+				_async_write(fd, ent.line, strlen(ent.line));
+			xfree(ent.line);
+			slurm_mutex_lock(&async_lock);
+			async_writing = false;
+			continue;
+		}
+
+		if (async_dropped) {
+			char tmp[LINEBUFSIZE];
+			int fd = async_fd;
+
+			snprintf(tmp, sizeof(tmp),
+				 "error: async logging dropped %u messages (ring buffer full)\n",
+				 async_dropped);
+			async_dropped = 0;
+			async_writing = true;
+			slurm_mutex_unlock(&async_lock);
+			if (fd >= 0)
+				_async_write(fd, tmp, strlen(tmp));
+			slurm_mutex_lock(&async_lock);
+			async_writing = false;
+			continue;
+		}
+
+		slurm_cond_broadcast(&async_drain_cond);
+		if (async_shutdown)
+			break;
+		slurm_cond_wait(&async_cond, &async_lock);
+	}
+	slurm_mutex_unlock(&async_lock);
+	return NULL;
+}
+
+/*
+ * Queue one formatted line for the writer thread, taking ownership of
+ * it. Returns false (line untouched) if async mode is off and the
+ * caller must write synchronously. A full ring drops the message rather
+ * than blocking. Callers must hold log_lock.
+ */
+static bool _log_async_enqueue(char *line, bool sched)
+{
+	bool queued = false;
+
+	if (!async_enabled)
+		return false;
+
+	slurm_mutex_lock(&async_lock);
+	if (async_enabled) {
+		if ((async_tail - async_head) < LOG_ASYNC_DEPTH) {
+			async_ring[async_tail % LOG_ASYNC_DEPTH].line = line;
+			async_ring[async_tail % LOG_ASYNC_DEPTH].sched = sched;
+			async_tail++;
+			slurm_cond_signal(&async_cond);
+		} else {
+			async_dropped++;
+			xfree(line);
+		}
+		queued = true;
+	}
+	slurm_mutex_unlock(&async_lock);
+	return queued;
+}
+
+/* Wait for the writer thread to catch up. Safe with log_lock held since
+ * the writer never takes it. */
+static void _log_async_drain(void)
+{
+	slurm_mutex_lock(&async_lock);
+	while (async_enabled &&
+	       ((async_head != async_tail) || async_writing || async_dropped))
+		slurm_cond_wait(&async_drain_cond, &async_lock);
+	slurm_mutex_unlock(&async_lock);
+}
+
+/* Refresh the writer thread's private copies of the logfile descriptors
+ * after the logfiles have been (re)opened. Callers must hold log_lock
+ * and have drained the ring first. */
+static void _log_async_update_fds(void)
+{
+	slurm_mutex_lock(&async_lock);
+	if (async_fd >= 0)
+		close(async_fd);
+	if (async_sched_fd >= 0)
+		close(async_sched_fd);
+	async_fd = -1;
+	async_sched_fd = -1;
+	if (log && log->logfp)
+		async_fd = fcntl(fileno(log->logfp), F_DUPFD_CLOEXEC, 0);
+	if (sched_log && sched_log->logfp)
+		async_sched_fd = fcntl(fileno(sched_log->logfp),
+				       F_DUPFD_CLOEXEC, 0);
+	slurm_mutex_unlock(&async_lock);
+}
+
 /*
  * pthread_atfork handlers:
  */
-static void _atfork_prep()   { slurm_mutex_lock(&log_lock);   }
-static void _atfork_parent() { slurm_mutex_unlock(&log_lock); }
-static void _atfork_child()  { slurm_mutex_unlock(&log_lock); }
+static void _atfork_prep()
+{
+	slurm_mutex_lock(&log_lock);
+	_log_async_drain();
+	slurm_mutex_lock(&async_lock);
+}
+static void _atfork_parent()
+{
+	slurm_mutex_unlock(&async_lock);
+	slurm_mutex_unlock(&log_lock);
+}
+static void _atfork_child()
+{
+	/* The writer thread does not survive the fork. Fall back to
+	 * synchronous writes in the child, which normally exec()s or
+	 * exits shortly. The ring is empty courtesy of _atfork_prep(). */
+	async_enabled = false;
+	async_thread = 0;
+	if (async_fd >= 0)
+		close(async_fd);
+	if (async_sched_fd >= 0)
+		close(async_sched_fd);
+	async_fd = -1;
+	async_sched_fd = -1;
+	slurm_mutex_unlock(&async_lock);
+	slurm_mutex_unlock(&log_lock);
+}
 static bool at_forked = false;
 #define atfork_install_handlers()					\
 	while (!at_forked) {						\
@@ -369,6 +561,11 @@ _log_init(char *prog, log_options_t opt, log_facility_t fac, char *logfile )
 	if (log->logfp && (fileno(log->logfp) < 0))
 		log->logfp = NULL;
 
+	if (async_enabled) {
+		_log_async_drain();
+		_log_async_update_fds();
+	}
+
 	highest_log_level = _highest_level(log->opt.syslog_level,
 					   log->opt.logfile_level,
 					   log->opt.stderr_level);
@@ -460,6 +657,11 @@ _sched_log_init(char *prog, log_options_t opt, log_facility_t fac,
 	if (sched_log->logfp && (fileno(sched_log->logfp) < 0))
 		sched_log->logfp = NULL;
 
+	if (async_enabled) {
+		_log_async_drain();
+		_log_async_update_fds();
+	}
+
 	highest_sched_log_level = _highest_level(sched_log->opt.syslog_level,
 						 sched_log->opt.logfile_level,
 						 sched_log->opt.stderr_level);
@@ -509,6 +711,8 @@ void log_fini(void)
 	if (!log)
 		return;
 
+	log_set_async(false);
+
 	slurm_mutex_lock(&log_lock);
 	_log_flush(log);
 	xfree(log->argv0);
@@ -530,6 +734,8 @@ void sched_log_fini(void)
 		return;
 
 	slurm_mutex_lock(&log_lock);
+	if (async_enabled)
+		_log_async_drain();
 	_log_flush(sched_log);
 	xfree(sched_log->argv0);
 	xfree(sched_log->fpfx);
@@ -540,6 +746,8 @@ void sched_log_fini(void)
 	if (sched_log->logfp)
 		fclose(sched_log->logfp);
 	xfree(sched_log);
+	if (async_enabled)
+		_log_async_update_fds();
 	slurm_mutex_unlock(&log_lock);
 }
 
@@ -1164,11 +1372,16 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 	if (SCHED_LOG_INITIALIZED && sched &&
 	    (highest_sched_log_level > LOG_LEVEL_QUIET)) {
 		buf = vxstrfmt(fmt, args);
-		xlogfmtcat(&msgbuf, "[%M] %s%s%s", sched_log->fpfx, pfx, buf);
-		_log_printf(sched_log, sched_log->fbuf, sched_log->logfp,
-			    "sched: %s\n", msgbuf);
-		fflush(sched_log->logfp);
-		xfree(msgbuf);
+		xlogfmtcat(&msgbuf, "sched: [%M] %s%s%s\n",
+			   sched_log->fpfx, pfx, buf);
+		if (_log_async_enqueue(msgbuf, true)) {
+			msgbuf = NULL;
+		} else {
+			_log_printf(sched_log, sched_log->fbuf,
+				    sched_log->logfp, "%s", msgbuf);
+			fflush(sched_log->logfp);
+			xfree(msgbuf);
+		}
 	}
 
 	if (level > highest_log_level) {
@@ -1251,11 +1464,14 @@ static void _log_msg(log_level_t level, bool sched, const char *fmt, va_list arg
 
 	if ((level <= log->opt.logfile_level) && (log->logfp != NULL)) {
 
-		xlogfmtcat(&msgbuf, "[%M] %s%s%s", log->fpfx, pfx, buf);
-		_log_printf(log, log->fbuf, log->logfp, "%s\n", msgbuf);
-		fflush(log->logfp);
-
-		xfree(msgbuf);
+		xlogfmtcat(&msgbuf, "[%M] %s%s%s\n", log->fpfx, pfx, buf);
+		if (_log_async_enqueue(msgbuf, false)) {
+			msgbuf = NULL;
+		} else {
+			_log_printf(log, log->fbuf, log->logfp, "%s", msgbuf);
+			fflush(log->logfp);
+			xfree(msgbuf);
+		}
 	}
 
 	if (level <=  log->opt.syslog_level) {
@@ -1303,10 +1519,53 @@ void
 log_flush()
 {
 	slurm_mutex_lock(&log_lock);
+	_log_async_drain();
 	_log_flush(log);
 	slurm_mutex_unlock(&log_lock);
 }
 
+/*
+ * Enable or disable asynchronous logfile writes. Disabling (also done
+ * implicitly by log_fini()) drains the ring and joins the writer
+ * thread, so no messages are lost across the transition.
+ */
+void log_set_async(bool enable)
+{
+	slurm_mutex_lock(&log_lock);
+	if (enable && !async_enabled) {
+		int err;
+
+		_log_async_update_fds();
+		async_shutdown = false;
+		async_enabled = true;
+		/* Not slurm_thread_create(): a fatal() here would
+		 * deadlock on log_lock. */
+		err = pthread_create(&async_thread, NULL,
+				     _log_async_writer, NULL);
+		if (err) {
+			async_enabled = false;
+			async_thread = 0;
+			fprintf(stderr, "%s: pthread_create: %s\n",
+				__func__, strerror(err));
+		}
+	} else if (!enable && async_enabled) {
+		slurm_mutex_lock(&async_lock);
+		async_enabled = false;
+		async_shutdown = true;
+		slurm_cond_signal(&async_cond);
+		slurm_mutex_unlock(&async_lock);
+		pthread_join(async_thread, NULL);
+		async_thread = 0;
+		if (async_fd >= 0)
+			close(async_fd);
+		if (async_sched_fd >= 0)
+			close(async_sched_fd);
+		async_fd = -1;
+		async_sched_fd = -1;
+	}
+	slurm_mutex_unlock(&log_lock);
+}
+
 /*
  * attempt to log message and exit()
  */
@@ -223,6 +223,16 @@ bool log_has_data(void);
  */
 void log_flush(void);
 
+/*
+ * log_set_async() enables or disables asynchronous logfile writes.
+ * When enabled, logfile lines are queued and written by a dedicated
+ * thread so callers do not block on disk I/O; if the writer falls
+ * behind, messages are dropped and counted rather than blocking.
+ * fatal() and log_flush() drain the queue synchronously. stderr and
+ * syslog output is not affected.
+ */
+void log_set_async(bool enable);
+
 /* log_set_debug_flags()
  * Set or reset the debug flags based on the configuration
  * file or the scontrol command.
@@ -54,9 +54,11 @@
 #include "src/slurmd/slurmd/slurmd.h"
 
 typedef struct {
+	uint64_t        adapt_window;
 	pthread_mutex_t	aggr_mutex;
 	pthread_cond_t	cond;
 	uint32_t        debug_flags;
+	bool            flush;
 	bool		max_msgs;
 	uint64_t        max_msg_cnt;
 	List            msg_aggr_list;
@@ -81,6 +83,14 @@ typedef struct {
 static msg_collection_type_t msg_collection;
 
 
+/* Messages which should not wait out a collection window. These are
+ * singleton, latency sensitive messages; delaying a node registration
+ * holds up scheduler use of the node. */
+static bool _msg_aggr_is_urgent(uint16_t msg_type)
+{
+	return (msg_type == MESSAGE_NODE_REGISTRATION_STATUS);
+}
+
 static void _msg_aggr_free(void *x)
 {
 	msg_aggr_t *object = (msg_aggr_t *)x;
@@ -194,6 +204,8 @@ static void * _msg_aggregation_sender(void *arg)
 	struct timespec timeout;
 	slurm_msg_t msg;
 	composite_msg_t cmp;
+	uint64_t min_window;
+	int sent_cnt;
 
 	slurm_mutex_lock(&msg_collection.mutex);
 	msg_collection.running = 1;
@@ -207,17 +219,21 @@ static void * _msg_aggregation_sender(void *arg)
 		    !list_count(msg_collection.msg_list))
 			break;
 
-		/* A msg has been collected; start new window */
-		gettimeofday(&now, NULL);
-		timeout.tv_sec = now.tv_sec +
-			(msg_collection.window / MSEC_IN_SEC);
-		timeout.tv_nsec = (now.tv_usec * NSEC_IN_USEC) +
-			(NSEC_IN_MSEC * (msg_collection.window % MSEC_IN_SEC));
-		timeout.tv_sec += timeout.tv_nsec / NSEC_IN_SEC;
-		timeout.tv_nsec %= NSEC_IN_SEC;
-
-		slurm_cond_timedwait(&msg_collection.cond,
-				     &msg_collection.mutex, &timeout);
+		/* A msg has been collected; start new window. An urgent
+		 * msg terminates the window immediately. */
+		if (!msg_collection.flush) {
+			gettimeofday(&now, NULL);
+			timeout.tv_sec = now.tv_sec +
+				(msg_collection.adapt_window / MSEC_IN_SEC);
+			timeout.tv_nsec = (now.tv_usec * NSEC_IN_USEC) +
+				(NSEC_IN_MSEC *
+				 (msg_collection.adapt_window % MSEC_IN_SEC));
+			timeout.tv_sec += timeout.tv_nsec / NSEC_IN_SEC;
+			timeout.tv_nsec %= NSEC_IN_SEC;
+
+			slurm_cond_timedwait(&msg_collection.cond,
+					     &msg_collection.mutex, &timeout);
+		}
 
 		if (!msg_collection.running &&
 		    !list_count(msg_collection.msg_list))
@@ -237,6 +253,26 @@ static void * _msg_aggregation_sender(void *arg)
 		msg_collection.msg_list =
 			list_create(slurm_free_comp_msg_list);
 		msg_collection.max_msgs = false;
+		msg_collection.flush = false;
+
+		/* Adapt the next window to the observed arrival rate:
+		 * widen (up to the configured window) when this window
+		 * filled, narrow when only a lone msg showed up, so idle
+		 * periods do not tax every msg with the full window. */
+		sent_cnt = list_count(cmp.msg_list);
+		min_window = MAX(msg_collection.window / 16, 1);
+		if (sent_cnt >= msg_collection.max_msg_cnt) {
+			msg_collection.adapt_window =
+				MIN(msg_collection.adapt_window * 2,
+				    msg_collection.window);
+		} else if (sent_cnt <= 1) {
+			msg_collection.adapt_window =
+				MAX(msg_collection.adapt_window / 2,
+				    min_window);
+		}
+		if (msg_collection.debug_flags & DEBUG_FLAG_ROUTE)
+			info("msg aggr: sending %d msgs, next window %"PRIu64" msec",
+			     sent_cnt, msg_collection.adapt_window);
 
 		slurm_msg_t_init(&msg);
 		msg.msg_type = MESSAGE_COMPOSITE;
@@ -274,6 +310,7 @@ extern void msg_aggr_sender_init(char *host, uint16_t port, uint64_t window,
 	slurm_cond_init(&msg_collection.cond, NULL);
 	slurm_set_addr(&msg_collection.node_addr, port, host);
 	msg_collection.window = window;
+	msg_collection.adapt_window = window;
 	msg_collection.max_msg_cnt = max_msg_cnt;
 	msg_collection.msg_aggr_list = list_create(_msg_aggr_free);
 	msg_collection.msg_list = list_create(slurm_free_comp_msg_list);
@@ -295,6 +332,7 @@ extern void msg_aggr_sender_reconfig(uint64_t window, uint64_t max_msg_cnt)
 	if (msg_collection.running) {
 		slurm_mutex_lock(&msg_collection.mutex);
 		msg_collection.window = window;
+		msg_collection.adapt_window = window;
 		msg_collection.max_msg_cnt = max_msg_cnt;
 		msg_collection.debug_flags = slurm_get_debug_flags();
 		slurm_mutex_unlock(&msg_collection.mutex);
@@ -344,6 +382,34 @@ extern void msg_aggr_add_msg(slurm_msg_t *msg, bool wait,
 
 	msg->msg_index = msg_index++;
 
+	/* A newer registration from this node supersedes any of our own
+	 * still sitting in the collection; merge them rather than having
+	 * the controller process a stale one. Relayed registrations
+	 * (raw buffers from other nodes) are left alone. */
+	if (msg->msg_type == MESSAGE_NODE_REGISTRATION_STATUS) {
+		slurm_msg_t *old_msg;
+		msg_aggr_t *msg_aggr;
+		ListIterator itr =
+			list_iterator_create(msg_collection.msg_list);
+
+		while ((old_msg = list_next(itr))) {
+			if ((old_msg->msg_type !=
+			     MESSAGE_NODE_REGISTRATION_STATUS) ||
+			    old_msg->data_size)
+				continue;
+			if (msg_collection.debug_flags & DEBUG_FLAG_ROUTE)
+				info("msg aggr: registration %u superseded by %u",
+				     old_msg->msg_index, msg->msg_index);
+			slurm_mutex_lock(&msg_collection.aggr_mutex);
+			if ((msg_aggr = _handle_msg_aggr_ret(
+				     old_msg->msg_index, 1)))
+				slurm_cond_signal(&msg_aggr->wait_cond);
+			slurm_mutex_unlock(&msg_collection.aggr_mutex);
+			list_delete_item(itr);
+		}
+		list_iterator_destroy(itr);
+	}
+
 	/* Add msg to message collection */
 	list_append(msg_collection.msg_list, msg);
 
@@ -359,6 +425,12 @@ extern void msg_aggr_add_msg(slurm_msg_t *msg, bool wait,
 		msg_collection.max_msgs = true;
 		slurm_cond_signal(&msg_collection.cond);
 	}
+
+	/* Urgent singleton msgs bypass the collection window */
+	if (_msg_aggr_is_urgent(msg->msg_type)) {
+		msg_collection.flush = true;
+		slurm_cond_signal(&msg_collection.cond);
+	}
 	slurm_mutex_unlock(&msg_collection.mutex);
 
 	if (wait) {
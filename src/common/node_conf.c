@@ -81,6 +81,8 @@ time_t last_node_update = (time_t) 0;	/* time of last update */
 struct node_record *node_record_table_ptr = NULL;	/* node records */
 xhash_t* node_hash_table = NULL;
 int node_record_count = 0;		/* count in node_record_table_ptr */
+static int node_record_table_size = 0;	/* allocated node_record_table_ptr
+					 * size, in records */
 uint16_t *cr_node_num_cores = NULL;
 uint32_t *cr_node_cores_offset = NULL;
 
@@ -531,7 +533,7 @@ extern int build_all_nodeline_info(bool set_bitmap, int tres_cnt)
 {
 	slurm_conf_node_t *node, **ptr_array;
 	struct config_record *config_ptr = NULL;
-	int count;
+	int count, alias_cnt = 0;
 	int i, rc, max_rc = SLURM_SUCCESS;
 	bool in_daemon;
 
@@ -541,6 +543,21 @@ extern int build_all_nodeline_info(bool set_bitmap, int tres_cnt)
 	if (count == 0)
 		fatal("No NodeName information available!");
 
+	/*
+	 * Size the node record table for every alias up front so the loop
+	 * below does not repeatedly resize it (and rebuild the node hash
+	 * table) as the records are created one at a time.
+	 */
+	for (i = 0; i < count; i++) {
+		hostlist_t alias_list;
+		alias_list = hostlist_create(ptr_array[i]->nodenames);
+		if (!alias_list)	/* error logged while building below */
+			continue;
+		alias_cnt += hostlist_count(alias_list);
+		hostlist_destroy(alias_list);
+	}
+	grow_node_record_table(alias_cnt);
+
 	for (i = 0; i < count; i++) {
 		node = ptr_array[i];
 
@@ -629,29 +646,32 @@ extern struct node_record *create_node_record (
 			struct config_record *config_ptr, char *node_name)
 {
 	struct node_record *node_ptr;
-	int old_buffer_size, new_buffer_size;
+	int new_buffer_size;
 
 	last_node_update = time (NULL);
 	xassert(config_ptr);
 	xassert(node_name);
 
-	/* round up the buffer size to reduce overhead of xrealloc */
-	old_buffer_size = (node_record_count) * sizeof (struct node_record);
-	old_buffer_size =
-		((int) ((old_buffer_size / BUF_SIZE) + 1)) * BUF_SIZE;
-	new_buffer_size =
-		(node_record_count + 1) * sizeof (struct node_record);
-	new_buffer_size =
-		((int) ((new_buffer_size / BUF_SIZE) + 1)) * BUF_SIZE;
-	if (!node_record_table_ptr) {
-		node_record_table_ptr = xmalloc(new_buffer_size);
-	} else if (old_buffer_size != new_buffer_size) {
-		xrealloc (node_record_table_ptr, new_buffer_size);
-		/*
-		 * You need to rehash the hash after we realloc or we will have
-		 * only bad memory references in the hash.
-		 */
-		rehash_node();
+	if (!node_record_table_ptr)	/* table may be released elsewhere */
+		node_record_table_size = 0;
+	if (node_record_count >= node_record_table_size) {
+		/* round up the buffer size to reduce overhead of xrealloc */
+		new_buffer_size =
+			(node_record_count + 1) * sizeof (struct node_record);
+		new_buffer_size =
+			((int) ((new_buffer_size / BUF_SIZE) + 1)) * BUF_SIZE;
+		if (!node_record_table_ptr) {
+			node_record_table_ptr = xmalloc(new_buffer_size);
+		} else {
+			xrealloc (node_record_table_ptr, new_buffer_size);
+			/*
+			 * You need to rehash the hash after we realloc or we
+			 * will have only bad memory references in the hash.
+			 */
+			rehash_node();
+		}
+		node_record_table_size = new_buffer_size /
+					 sizeof(struct node_record);
 	}
 	node_ptr = node_record_table_ptr + (node_record_count++);
 	node_ptr->name = xstrdup(node_name);
@@ -685,6 +705,37 @@ extern struct node_record *create_node_record (
 	return node_ptr;
 }
 
+/*
+ * grow_node_record_table - preallocate space in the node record table for
+ *	node_cnt additional node records
+ * IN node_cnt - number of node records expected to be created
+ * NOTE: Growing the table as records are created one at a time forces a
+ *	rebuild of the node hash table on every xrealloc, which gets
+ *	expensive with large node counts. Sizing the table up front makes
+ *	the bulk build do a single allocation.
+ */
+extern void grow_node_record_table(int node_cnt)
+{
+	int new_buffer_size;
+
+	if (!node_record_table_ptr)	/* table may be released elsewhere */
+		node_record_table_size = 0;
+	if ((node_record_count + node_cnt) <= node_record_table_size)
+		return;
+
+	new_buffer_size = (node_record_count + node_cnt) *
+			  sizeof(struct node_record);
+	new_buffer_size = ((int) ((new_buffer_size / BUF_SIZE) + 1)) * BUF_SIZE;
+	if (!node_record_table_ptr) {
+		node_record_table_ptr = xmalloc(new_buffer_size);
+	} else {
+		xrealloc(node_record_table_ptr, new_buffer_size);
+		/* Existing records moved, rebuild their hash references */
+		rehash_node();
+	}
+	node_record_table_size = new_buffer_size / sizeof(struct node_record);
+}
+
 /*
  * find_node_record - find a record for node with specified name
  * IN: name - name of the desired node
@@ -790,6 +841,7 @@ extern int init_node_conf (void)
 		purge_node_rec(node_ptr);
 
 	node_record_count = 0;
+	node_record_table_size = 0;
 	xfree(node_record_table_ptr);
 	xhash_free(node_hash_table);
 
@@ -822,6 +874,7 @@ extern void node_fini2 (void)
 
 	xfree(node_record_table_ptr);
 	node_record_count = 0;
+	node_record_table_size = 0;
 }
 
 
@@ -274,6 +274,13 @@ extern struct node_record *find_node_record2 (char *name);
  */
 extern struct node_record *find_node_record_no_alias (char *name);
 
+/*
+ * grow_node_record_table - preallocate space in the node record table for
+ *	node_cnt additional node records
+ * IN node_cnt - number of node records expected to be created
+ */
+extern void grow_node_record_table(int node_cnt);
+
 /*
  * hostlist2bitmap - given a hostlist, build a bitmap representation
  * IN hl          - hostlist
@@ -70,6 +70,7 @@
  * Define slurm-specific aliases for use by plugins, see slurm_xlator.h
  * for details.
  */
+strong_alias(buf_ref,		slurm_buf_ref);
 strong_alias(create_buf,	slurm_create_buf);
 strong_alias(create_mmap_buf,	slurm_create_mmap_buf);
 strong_alias(free_buf,		slurm_free_buf);
@@ -129,10 +130,24 @@ Buf create_buf(char *data, uint32_t size)
 	my_buf->processed = 0;
 	my_buf->head = data;
 	my_buf->mmaped = false;
+	my_buf->ref_cnt = 1;
 
 	return my_buf;
 }
 
+/*
+ * buf_ref - take an additional reference on a buffer so that pointers
+ * into its data (e.g. from unpackmem_ptr) remain valid after the
+ * original owner calls free_buf(). Each reference must be released
+ * with its own free_buf() call.
+ */
+Buf buf_ref(Buf my_buf)
+{
+	assert(my_buf->magic == BUF_MAGIC);
+	my_buf->ref_cnt++;
+	return my_buf;
+}
+
 /*
  * create_mmap_buf - create an mmap()'d read-only buffer from
  * the supplied file.
@@ -168,6 +183,7 @@ Buf create_mmap_buf(char *file)
 	my_buf->processed = 0;
 	my_buf->head = data;
 	my_buf->mmaped = true;
+	my_buf->ref_cnt = 1;
 
 	debug3("%s: loaded file `%s` as Buf", __func__, file);
 
@@ -175,12 +191,16 @@ Buf create_mmap_buf(char *file)
 }
 
 
-/* free_buf - release memory associated with a given buffer */
+/* free_buf - release one reference on a buffer, freeing its memory
+ * when the last reference is released */
 void free_buf(Buf my_buf)
 {
 	if (!my_buf)
 		return;
 	assert(my_buf->magic == BUF_MAGIC);
+	assert(my_buf->ref_cnt > 0);
+	if (--my_buf->ref_cnt > 0)
+		return;
 	if (my_buf->mmaped)
 		munmap(my_buf->head, my_buf->size);
 	else
@@ -222,6 +242,7 @@ Buf init_buf(uint32_t size)
 	my_buf->processed = 0;
 	my_buf->head = xmalloc(size);
 	my_buf->mmaped = false;
+	my_buf->ref_cnt = 1;
 	return my_buf;
 }
 
@@ -232,6 +253,7 @@ void *xfer_buf_data(Buf my_buf)
 	void *data_ptr;
 
 	assert(my_buf->magic == BUF_MAGIC);
+	assert(my_buf->ref_cnt == 1);
 
 	if (my_buf->mmaped)
 		fatal_abort("attempt to grow mmap()'d buffer not supported");
@@ -241,6 +263,36 @@ void *xfer_buf_data(Buf my_buf)
 	return data_ptr;
 }
 
+/*
+ * Ensure the buffer has room for at least nbytes more data, growing
+ * it geometrically rather than by fixed BUF_SIZE increments so that
+ * packing a large aggregate (e.g. the job state dump) performs a
+ * logarithmic number of xrealloc/memcpy operations rather than one
+ * per BUF_SIZE of output. Returns false if the data can not fit
+ * within MAX_BUF_SIZE.
+ */
+static bool _grow_pack_buf(Buf buffer, uint32_t nbytes)
+{
+	uint64_t new_size;
+
+	if (remaining_buf(buffer) >= nbytes)
+		return true;
+
+	if (((uint64_t) buffer->size + nbytes + BUF_SIZE) > MAX_BUF_SIZE) {
+		error("%s: Buffer size limit exceeded (%"PRIu64" > %u)",
+		      __func__, ((uint64_t) buffer->size + nbytes + BUF_SIZE),
+		      MAX_BUF_SIZE);
+		return false;
+	}
+
+	new_size = MAX((uint64_t) buffer->size + nbytes + BUF_SIZE,
+		       (uint64_t) buffer->size * 2);
+	new_size = MIN(new_size, MAX_BUF_SIZE);
+	buffer->size = new_size;
+	xrealloc_nz(buffer->head, buffer->size);
+	return true;
+}
+
 /*
  * Given a time_t in host byte order, promote it to int64_t, convert to
  * network byte order, store in buffer and adjust buffer acc'd'ngly
@@ -249,16 +301,8 @@ void pack_time(time_t val, Buf buffer)
 {
 	int64_t n64 = HTON_int64((int64_t) val);
 
-	if (remaining_buf(buffer) < sizeof(n64)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(n64)))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &n64, sizeof(n64));
 	buffer->processed += sizeof(n64);
@@ -298,16 +342,8 @@ void 	packdouble(double val, Buf buffer)
 	 */
 	uval.d =  (val * FLOAT_MULT);
 	nl =  HTON_uint64(uval.u);
-	if (remaining_buf(buffer) < sizeof(nl)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(nl)))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &nl, sizeof(nl));
 	buffer->processed += sizeof(nl);
@@ -424,16 +460,8 @@ void pack64(uint64_t val, Buf buffer)
 {
 	uint64_t nl =  HTON_uint64(val);
 
-	if (remaining_buf(buffer) < sizeof(nl)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(nl)))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &nl, sizeof(nl));
 	buffer->processed += sizeof(nl);
@@ -463,16 +491,8 @@ void pack32(uint32_t val, Buf buffer)
 {
 	uint32_t nl = htonl(val);
 
-	if (remaining_buf(buffer) < sizeof(nl)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(nl)))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &nl, sizeof(nl));
 	buffer->processed += sizeof(nl);
@@ -710,16 +730,8 @@ void pack16(uint16_t val, Buf buffer)
 {
 	uint16_t ns = htons(val);
 
-	if (remaining_buf(buffer) < sizeof(ns)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(ns)))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &ns, sizeof(ns));
 	buffer->processed += sizeof(ns);
@@ -748,16 +760,8 @@ int unpack16(uint16_t * valp, Buf buffer)
  */
 void pack8(uint8_t val, Buf buffer)
 {
-	if (remaining_buf(buffer) < sizeof(uint8_t)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(uint8_t)))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &val, sizeof(uint8_t));
 	buffer->processed += sizeof(uint8_t);
@@ -820,16 +824,8 @@ void packmem(char *valp, uint32_t size_val, Buf buffer)
 		      __func__, size_val, MAX_PACK_MEM_LEN);
 		return;
 	}
-	if (remaining_buf(buffer) < (sizeof(ns) + size_val)) {
-		if ((buffer->size + size_val + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + size_val + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += (size_val + BUF_SIZE);
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(ns) + size_val))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &ns, sizeof(ns));
 	buffer->processed += sizeof(ns);
@@ -1070,16 +1066,8 @@ void packstr_array(char **valp, uint32_t size_val, Buf buffer)
 	int i;
 	uint32_t ns = htonl(size_val);
 
-	if (remaining_buf(buffer) < sizeof(ns)) {
-		if ((buffer->size + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += BUF_SIZE;
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, sizeof(ns)))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], &ns, sizeof(ns));
 	buffer->processed += sizeof(ns);
@@ -1137,16 +1125,8 @@ int unpackstr_array(char ***valp, uint32_t * size_valp, Buf buffer)
  */
 void packmem_array(char *valp, uint32_t size_val, Buf buffer)
 {
-	if (remaining_buf(buffer) < size_val) {
-		if ((buffer->size + size_val + BUF_SIZE) > MAX_BUF_SIZE) {
-			error("%s: Buffer size limit exceeded (%u > %u)",
-			      __func__, (buffer->size + size_val + BUF_SIZE),
-			      MAX_BUF_SIZE);
-			return;
-		}
-		buffer->size += (size_val + BUF_SIZE);
-		xrealloc_nz(buffer->head, buffer->size);
-	}
+	if (!_grow_pack_buf(buffer, size_val))
+		return;
 
 	memcpy(&buffer->head[buffer->processed], valp, size_val);
 	buffer->processed += size_val;
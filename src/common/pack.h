@@ -66,6 +66,7 @@ struct slurm_buf {
 	uint32_t size;
 	uint32_t processed;
 	bool mmaped;
+	uint32_t ref_cnt;	/* free_buf() releases storage at zero */
 };
 
 typedef struct slurm_buf * Buf;
@@ -76,6 +77,7 @@ typedef struct slurm_buf * Buf;
 #define remaining_buf(__buf)		(__buf->size - __buf->processed)
 #define size_buf(__buf)			(__buf->size)
 
+Buf	buf_ref(Buf my_buf);
 Buf	create_buf (char *data, uint32_t size);
 Buf	create_mmap_buf(char *file);
 void	free_buf(Buf my_buf);
@@ -335,6 +337,14 @@ int	unpackmem_array(char *valp, uint32_t size_valp, Buf buffer);
 #define unpackstr_ptr		                        \
         unpackmem_ptr
 
+/*
+ * Zero-copy string unpack: the returned pointer aliases the pack
+ * buffer and is only valid while a reference on that buffer is held
+ * (see buf_ref()). Packed strings include their NUL terminator.
+ */
+#define safe_unpackstr_ptr		                \
+        safe_unpackmem_ptr
+
 #define unpackstr_malloc	                        \
         unpackmem_malloc
 
@@ -338,14 +338,19 @@ _plugin_stack_parse_line(char *line, char **plugin, int *acp, char ***argv,
 
 static struct spank_plugin *_spank_plugin_create(struct spank_stack *stack,
 						 char *path, int ac,
-						 char **av, bool required)
+						 char **av, bool required,
+						 plugin_handle_t p)
 {
 	struct spank_plugin *plugin;
-	plugin_handle_t p;
 	plugin_err_t e;
 	struct spank_plugin_operations ops;
 
-	if ((e = plugin_load_from_file(&p, path)) != EPLUGIN_SUCCESS) {
+	/*
+	 *  The plugin may already have been loaded while resolving its
+	 *   path against the plugin search path.
+	 */
+	if ((p == PLUGIN_INVALID_HANDLE) &&
+	    ((e = plugin_load_from_file(&p, path)) != EPLUGIN_SUCCESS)) {
 		error ("spank: %s: %s", path, plugin_strerror(e));
 		return NULL;
 	}
@@ -397,13 +402,23 @@ void _spank_plugin_destroy(struct spank_plugin *sp)
 	return;
 }
 
+/*
+ *  Search the colon separated plugin path for `file' and load the first
+ *   candidate that is a valid plugin. On success return its full path and
+ *   set *handlep to the already loaded plugin so the caller does not have
+ *   to dlopen the same object a second time (plugin_peek() performed a
+ *   full dlopen/dlclose cycle per plugin just to test each candidate).
+ */
 static char *
-_spank_plugin_find (const char *path, const char *file)
+_spank_plugin_find (const char *path, const char *file,
+		    plugin_handle_t *handlep)
 {
 	char dir [4096];
 	char *p, *entry;
 	int pathlen = strlen (path);
 
+	*handlep = PLUGIN_INVALID_HANDLE;
+
 	if (strlcpy(dir, path, sizeof (dir)) > sizeof (dir))
 		return (NULL);
 
@@ -425,7 +440,8 @@ _spank_plugin_find (const char *path, const char *file)
 			xstrcatchar (fq_path, '/');
 		xstrcat (fq_path, file);
 
-		if (plugin_peek (fq_path, NULL, 0, NULL) != SLURM_ERROR)
+		if (plugin_load_from_file (handlep, fq_path)
+		    == EPLUGIN_SUCCESS)
 			return (fq_path);
 
 		xfree (fq_path);
@@ -475,6 +491,7 @@ _spank_stack_process_line(struct spank_stack *stack,
 	char *path;
 	cf_line_t type = CF_REQUIRED;
 	bool required;
+	plugin_handle_t handle = PLUGIN_INVALID_HANDLE;
 
 	struct spank_plugin *p;
 
@@ -495,14 +512,16 @@ _spank_stack_process_line(struct spank_stack *stack,
 	if (path[0] != '/') {
 		char *f;
 
-		if ((f = _spank_plugin_find (stack->plugin_path, path))) {
+		if ((f = _spank_plugin_find (stack->plugin_path, path,
+					     &handle))) {
 			xfree (path);
 			path = f;
 		}
 	}
 
 	required = (type == CF_REQUIRED);
-	if (!(p = _spank_plugin_create(stack, path, ac, argv, required))) {
+	if (!(p = _spank_plugin_create(stack, path, ac, argv, required,
+				       handle))) {
 		if (required)
 			error ("spank: %s:%d:"
 			       " Failed to load plugin %s. Aborting.",
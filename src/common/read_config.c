@@ -49,6 +49,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <netdb.h>
 #include <netinet/in.h>
@@ -79,6 +80,7 @@
 #include "src/common/slurm_accounting_storage.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/slurm_protocol_pack.h"
 #include "src/common/slurm_resource_info.h"
 #include "src/common/slurm_rlimits_info.h"
 #include "src/common/slurm_selecttype_info.h"
@@ -119,9 +121,11 @@ static s_p_hashtbl_t *default_partition_tbl;
 static bool	local_test_config = false;
 static int	local_test_config_rc = SLURM_SUCCESS;
 static bool     no_addr_cache = false;
+static bool	conf_from_cache = false;
 
 inline static void _normalize_debug_level(uint16_t *level);
 static int _init_slurm_conf(const char *file_name);
+static void _ensure_conf_hashtbl(void);
 
 #define NAME_HASH_LEN 512
 typedef struct names_ll_s {
@@ -1040,6 +1044,7 @@ int slurm_conf_frontend_array(slurm_conf_frontend_t **ptr_array[])
 	int count = 0;
 	slurm_conf_frontend_t **ptr;
 
+	_ensure_conf_hashtbl();
 	if (s_p_get_array((void ***)&ptr, &count, "FrontendName",
 			  conf_hashtbl)) {
 		*ptr_array = ptr;
@@ -1098,6 +1103,7 @@ int slurm_conf_nodename_array(slurm_conf_node_t **ptr_array[])
 	int count = 0;
 	slurm_conf_node_t **ptr;
 
+	_ensure_conf_hashtbl();
 	if (s_p_get_array((void ***)&ptr, &count, "NodeName", conf_hashtbl)) {
 		*ptr_array = ptr;
 		return count;
@@ -1909,6 +1915,7 @@ int slurm_conf_partition_array(slurm_conf_partition_t **ptr_array[])
 	int count = 0;
 	slurm_conf_partition_t **ptr;
 
+	_ensure_conf_hashtbl();
 	if (s_p_get_array((void ***)&ptr, &count, "PartitionName",
 			  conf_hashtbl)) {
 		*ptr_array = ptr;
@@ -1965,6 +1972,7 @@ extern int slurm_conf_downnodes_array(slurm_conf_downnodes_t **ptr_array[])
 	int count = 0;
 	slurm_conf_downnodes_t **ptr;
 
+	_ensure_conf_hashtbl();
 	if (s_p_get_array((void ***)&ptr, &count, "DownNodes", conf_hashtbl)) {
 		*ptr_array = ptr;
 		return count;
@@ -2704,6 +2712,77 @@ extern int slurm_conf_get_addr(const char *node_name, slurm_addr_t *address)
 	return SLURM_ERROR;
 }
 
+/*
+ * slurm_conf_prime_node_addrs - Resolve the addresses of all configured
+ *	nodes so communication paths can use the cached values. The resolver
+ *	is called without holding the configuration lock, so a slow or dead
+ *	DNS server delays only this caller and not threads performing
+ *	lookups through slurm_conf_get_addr().
+ * IN refresh - Also resolve previously cached addresses again, keeping the
+ *	old address for any node whose resolution now fails.
+ */
+extern void slurm_conf_prime_node_addrs(bool refresh)
+{
+	names_ll_t *p;
+	char **alias = NULL, **address = NULL;
+	uint16_t *port = NULL;
+	slurm_addr_t addr;
+	int cnt = 0, size = 0, i, idx;
+
+	slurm_conf_lock();
+	_init_slurmd_nodehash();
+	for (i = 0; i < NAME_HASH_LEN; i++) {
+		for (p = node_to_host_hashtbl[i]; p; p = p->next_alias) {
+			if (p->addr_initialized && !refresh)
+				continue;
+			if (cnt >= size) {
+				size += 1024;
+				xrecalloc(alias, size, sizeof(char *));
+				xrecalloc(address, size, sizeof(char *));
+				xrecalloc(port, size, sizeof(uint16_t));
+			}
+			alias[cnt] = xstrdup(p->alias);
+			address[cnt] = xstrdup(p->address);
+			if (!p->port)
+				p->port = (uint16_t) conf_ptr->slurmd_port;
+			port[cnt] = p->port;
+			cnt++;
+		}
+	}
+	slurm_conf_unlock();
+
+	for (i = 0; i < cnt; i++) {
+		slurm_set_addr(&addr, port[i], address[i]);
+		if ((addr.sin_family == 0) && (addr.sin_port == 0)) {
+			debug2("%s: can not resolve address for node %s",
+			       __func__, alias[i]);
+			xfree(alias[i]);
+			xfree(address[i]);
+			continue;
+		}
+		slurm_conf_lock();
+		idx = _get_hash_idx(alias[i]);
+		for (p = node_to_host_hashtbl[idx]; p; p = p->next_alias) {
+			if (xstrcmp(p->alias, alias[i]))
+				continue;
+			/* Skip nodes changed by slurm_reset_alias() since
+			 * the resolution started */
+			if (!xstrcmp(p->address, address[i])) {
+				p->addr = addr;
+				if (!no_addr_cache)
+					p->addr_initialized = true;
+			}
+			break;
+		}
+		slurm_conf_unlock();
+		xfree(alias[i]);
+		xfree(address[i]);
+	}
+	xfree(alias);
+	xfree(address);
+	xfree(port);
+}
+
 /*
  * slurm_conf_get_cpus_bsct -
  * Return the cpus, boards, sockets, cores, and threads configured for a
@@ -3217,6 +3296,218 @@ end:
 	return (rc);
 }
 
+/*
+ * Compiled configuration cache support. Parsing slurm.conf dominates the
+ * startup cost of short-lived client commands (scripted loops running
+ * squeue/sacct pay it on every invocation) and of every slurmstepd launch.
+ * After a successful parse the resulting slurm_ctl_conf_t is written in
+ * packed form next to the config file, tagged with the mtime and size of
+ * the source file, and later invocations load it instead of parsing. Any
+ * mismatch (stale cache, different protocol version, truncated file) just
+ * falls back to the parser. The cache only covers the slurm_ctl_conf_t
+ * values; the node, frontend, partition and down-node tables are built by
+ * parser callbacks, so _ensure_conf_hashtbl() re-parses the file the first
+ * time one of those tables is requested (most client commands never do).
+ */
+#define CONF_CACHE_MAGIC 0x63666e63
+
+/* caller must lock conf_lock */
+static int _load_conf_cache(const char *name)
+{
+	char *cache_name = NULL;
+	struct stat stat_buf;
+	Buf buffer = NULL;
+	slurm_msg_t msg;
+	slurm_ctl_conf_t *cache_conf = NULL;
+	uint32_t magic, uint32_tmp;
+	uint16_t version;
+	time_t mtime;
+	uint64_t fsize;
+
+	if (stat(name, &stat_buf) < 0)
+		return SLURM_ERROR;
+
+	cache_name = xstrdup_printf("%s.cache", name);
+	if (!(buffer = create_mmap_buf(cache_name))) {
+		xfree(cache_name);
+		return SLURM_ERROR;
+	}
+
+	safe_unpack32(&magic, buffer);
+	if (magic != CONF_CACHE_MAGIC)
+		goto unpack_error;
+	safe_unpack16(&version, buffer);
+	if (version != SLURM_PROTOCOL_VERSION)
+		goto unpack_error;
+	safe_unpack_time(&mtime, buffer);
+	safe_unpack64(&fsize, buffer);
+	if ((mtime != stat_buf.st_mtime) ||
+	    (fsize != (uint64_t) stat_buf.st_size))
+		goto unpack_error;
+
+	slurm_msg_t_init(&msg);
+	msg.protocol_version = version;
+	msg.msg_type = RESPONSE_BUILD_INFO;
+	if (unpack_msg(&msg, buffer) != SLURM_SUCCESS)
+		goto unpack_error;
+	cache_conf = msg.data;
+
+	/* Fields appended by _write_conf_cache(), see comment there */
+	safe_unpackstr_xmalloc(&cache_conf->accounting_storage_pass,
+			       &uint32_tmp, buffer);
+	safe_unpackstr_xmalloc(&cache_conf->authalttypes,
+			       &uint32_tmp, buffer);
+	safe_unpack16(&cache_conf->job_acct_oom_kill, buffer);
+	safe_unpackstr_xmalloc(&cache_conf->job_comp_pass,
+			       &uint32_tmp, buffer);
+	safe_unpackstr_xmalloc(&cache_conf->site_factor_params,
+			       &uint32_tmp, buffer);
+	safe_unpackstr_xmalloc(&cache_conf->site_factor_plugin,
+			       &uint32_tmp, buffer);
+
+	/* Move the unpacked values into place, freeing the container only */
+	memcpy(conf_ptr, cache_conf, sizeof(slurm_ctl_conf_t));
+	xfree(cache_conf);
+	xfree(conf_ptr->slurm_conf);
+	conf_ptr->slurm_conf = xstrdup(name);
+	conf_ptr->last_update = time(NULL);
+
+	debug("Loaded configuration from cache file %s", cache_name);
+	free_buf(buffer);
+	xfree(cache_name);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	debug2("Configuration cache file %s unusable, parsing %s",
+	       cache_name, name);
+	if (cache_conf) {
+		free_slurm_conf(cache_conf, false);
+		xfree(cache_conf);
+	}
+	free_buf(buffer);
+	xfree(cache_name);
+	return SLURM_ERROR;
+}
+
+/* caller must lock conf_lock */
+static void _write_conf_cache(const char *name)
+{
+	char *cache_name = NULL, *new_name = NULL;
+	struct stat stat_buf;
+	Buf buffer;
+	slurm_msg_t msg;
+	char *data, line[1024];
+	int fd, nwrite, pos, amount;
+	FILE *fp;
+
+	if (stat(name, &stat_buf) < 0)
+		return;
+
+	/*
+	 * The cache is validated against the mtime and size of this file
+	 * alone, which cannot cover files pulled in through Include
+	 * directives, so do not cache such configurations.
+	 */
+	if (!(fp = fopen(name, "r")))
+		return;
+	while (fgets(line, sizeof(line), fp)) {
+		char *p = line;
+		while (isspace((int) *p))
+			p++;
+		if (xstrncasecmp(p, "Include", 7) == 0) {
+			fclose(fp);
+			return;
+		}
+	}
+	fclose(fp);
+
+	buffer = init_buf(BUF_SIZE);
+	pack32(CONF_CACHE_MAGIC, buffer);
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack_time(stat_buf.st_mtime, buffer);
+	pack64((uint64_t) stat_buf.st_size, buffer);
+
+	slurm_msg_t_init(&msg);
+	msg.protocol_version = SLURM_PROTOCOL_VERSION;
+	msg.msg_type = RESPONSE_BUILD_INFO;
+	msg.data = conf_ptr;
+	pack_msg(&msg, buffer);
+
+	/*
+	 * A few fields are not part of the RPC pack format (passwords are
+	 * never sent over the wire, other fields predate their RPC
+	 * support); append them so a cache round trip is lossless.
+	 */
+	packstr(conf_ptr->accounting_storage_pass, buffer);
+	packstr(conf_ptr->authalttypes, buffer);
+	pack16(conf_ptr->job_acct_oom_kill, buffer);
+	packstr(conf_ptr->job_comp_pass, buffer);
+	packstr(conf_ptr->site_factor_params, buffer);
+	packstr(conf_ptr->site_factor_plugin, buffer);
+
+	cache_name = xstrdup_printf("%s.cache", name);
+	new_name = xstrdup_printf("%s.new", cache_name);
+	(void) unlink(new_name);
+	/* The cache holds exactly what the config file does; match modes */
+	fd = open(new_name, O_CREAT | O_WRONLY | O_TRUNC,
+		  stat_buf.st_mode & 0777);
+	if (fd < 0) {
+		/* Typically an unprivileged user; keep quiet about it */
+		debug3("Unable to write configuration cache %s: %m",
+		       cache_name);
+		goto fini;
+	}
+
+	data = get_buf_data(buffer);
+	nwrite = get_buf_offset(buffer);
+	pos = 0;
+	while (nwrite > 0) {
+		amount = write(fd, &data[pos], nwrite);
+		if ((amount < 0) && (errno != EINTR)) {
+			error("Error writing configuration cache %s: %m",
+			      new_name);
+			close(fd);
+			(void) unlink(new_name);
+			goto fini;
+		} else if (amount >= 0) {
+			nwrite -= amount;
+			pos    += amount;
+		}
+	}
+	close(fd);
+	if (rename(new_name, cache_name) < 0) {
+		error("Unable to rename configuration cache %s: %m",
+		      cache_name);
+		(void) unlink(new_name);
+	} else
+		debug2("Wrote configuration cache file %s", cache_name);
+
+fini:
+	free_buf(buffer);
+	xfree(cache_name);
+	xfree(new_name);
+}
+
+/*
+ * Build the parsed hash table for configurations loaded from the cache.
+ * The table is only needed by the node/frontend/partition/down-node
+ * array accessors; defer the parse until one of them asks.
+ * caller must lock conf_lock
+ */
+static void _ensure_conf_hashtbl(void)
+{
+	uint32_t hash_val = 0;
+
+	if (!conf_from_cache)
+		return;
+	conf_from_cache = false;
+
+	if (s_p_parse_file(conf_hashtbl, &hash_val, conf_ptr->slurm_conf,
+			   false) == SLURM_ERROR)
+		error("Unable to parse %s for configuration table lookups",
+		      conf_ptr->slurm_conf);
+}
+
 /* caller must lock conf_lock */
 static int _init_slurm_conf(const char *file_name)
 {
@@ -3236,16 +3527,24 @@ static int _init_slurm_conf(const char *file_name)
 
 	/* init hash to 0 */
 	conf_ptr->hash_val = 0;
-	if ((_config_is_storage(conf_hashtbl, name) < 0) &&
-	    (s_p_parse_file(conf_hashtbl, &conf_ptr->hash_val, name, false)
-	     == SLURM_ERROR)) {
-		rc = SLURM_ERROR;
+	conf_from_cache = false;
+	if (_config_is_storage(conf_hashtbl, name) < 0) {
+		if (_load_conf_cache(name) == SLURM_SUCCESS)
+			conf_from_cache = true;
+		else if (s_p_parse_file(conf_hashtbl, &conf_ptr->hash_val,
+					name, false) == SLURM_ERROR)
+			rc = SLURM_ERROR;
 	}
 	/* s_p_dump_values(conf_hashtbl, slurm_conf_options); */
 
-	if (_validate_and_set_defaults(conf_ptr, conf_hashtbl) == SLURM_ERROR)
-		rc = SLURM_ERROR;
-	conf_ptr->slurm_conf = xstrdup(name);
+	if (!conf_from_cache) {
+		if (_validate_and_set_defaults(conf_ptr, conf_hashtbl) ==
+		    SLURM_ERROR)
+			rc = SLURM_ERROR;
+		conf_ptr->slurm_conf = xstrdup(name);
+		if (rc == SLURM_SUCCESS)
+			_write_conf_cache(name);
+	}
 
 	no_addr_cache = false;
 	if (xstrcasestr("NoAddrCache", conf_ptr->comm_params))
@@ -3273,6 +3572,7 @@ _destroy_slurm_conf(void)
 	}
 	free_slurm_conf(conf_ptr, true);
 	conf_initialized = false;
+	conf_from_cache = false;
 
 	/* xfree(conf_ptr); */
 }
@@ -5337,11 +5637,26 @@ extern char * debug_flags2str(uint64_t debug_flags)
 			xstrcat(rc, ",");
 		xstrcat(rc, "NodeFeatures");
 	}
+	if (debug_flags & DEBUG_FLAG_PHASE_TRACE) {
+		if (rc)
+			xstrcat(rc, ",");
+		xstrcat(rc, "PhaseTrace");
+	}
 	if (debug_flags & DEBUG_FLAG_LICENSE) {
 		if (rc)
 			xstrcat(rc, ",");
 		xstrcat(rc, "License");
 	}
+	if (debug_flags & DEBUG_FLAG_LOCK_PROFILE) {
+		if (rc)
+			xstrcat(rc, ",");
+		xstrcat(rc, "LockProfile");
+	}
+	if (debug_flags & DEBUG_FLAG_MEMORY) {
+		if (rc)
+			xstrcat(rc, ",");
+		xstrcat(rc, "Memory");
+	}
 	if (debug_flags & DEBUG_FLAG_NO_CONF_HASH) {
 		if (rc)
 			xstrcat(rc, ",");
@@ -5513,10 +5828,16 @@ extern int debug_str2flags(char *debug_flags, uint64_t *flags_out)
 			(*flags_out) |= DEBUG_FLAG_JOB_CONT;
 		else if (xstrcasecmp(tok, "License") == 0)
 			(*flags_out) |= DEBUG_FLAG_LICENSE;
+		else if (xstrcasecmp(tok, "LockProfile") == 0)
+			(*flags_out) |= DEBUG_FLAG_LOCK_PROFILE;
+		else if (xstrcasecmp(tok, "Memory") == 0)
+			(*flags_out) |= DEBUG_FLAG_MEMORY;
 		else if (xstrcasecmp(tok, "NO_CONF_HASH") == 0)
 			(*flags_out) |= DEBUG_FLAG_NO_CONF_HASH;
 		else if (xstrcasecmp(tok, "NodeFeatures") == 0)
 			(*flags_out) |= DEBUG_FLAG_NODE_FEATURES;
+		else if (xstrcasecmp(tok, "PhaseTrace") == 0)
+			(*flags_out) |= DEBUG_FLAG_PHASE_TRACE;
 		else if (xstrcasecmp(tok, "NoRealTime") == 0)
 			(*flags_out) |= DEBUG_FLAG_NO_REALTIME;
 		else if (xstrcasecmp(tok, "Priority") == 0)
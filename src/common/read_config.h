@@ -497,6 +497,16 @@ extern uint16_t slurm_conf_get_port(const char *node_name);
  */
 extern int slurm_conf_get_addr(const char *node_name, slurm_addr_t *address);
 
+/*
+ * slurm_conf_prime_node_addrs - Resolve the addresses of all configured
+ *	nodes so communication paths can use the cached values. With refresh
+ *	set, previously cached addresses are resolved again, keeping the old
+ *	address for any node whose resolution now fails.
+ *
+ * NOTE: Caller must NOT be holding slurm_conf_lock().
+ */
+extern void slurm_conf_prime_node_addrs(bool refresh);
+
 /*
  * slurm_conf_get_cpus_bsct -
  * Return the cpus, boards, sockets, cores, and threads configured for a
@@ -52,7 +52,9 @@
 
 typedef enum {
 	ACCT_STORAGE_INFO_CONN_ACTIVE,
-	ACCT_STORAGE_INFO_AGENT_COUNT
+	ACCT_STORAGE_INFO_AGENT_COUNT,
+	ACCT_STORAGE_INFO_QUERY_STATS	/* data is (bool *), true to clear
+					 * the statistics, false to log them */
 } acct_storage_info_t;
 
 extern int with_slurmdbd;
@@ -62,6 +62,7 @@
 #include "src/common/slurm_time.h"
 #include "src/common/uid.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -88,11 +89,16 @@ typedef struct sbcast_cred sbcast_cred_t;		/* opaque data type */
  * slurm job credential state
  *
  */
+/* Fixed width lookup key for cred_state_t: jobid, stepid and ctime */
+#define CRED_STATE_KEY_LEN (2 * sizeof(uint32_t) + sizeof(uint64_t))
+
 typedef struct {
 	time_t   ctime;		/* Time that the cred was created	*/
 	time_t   expiration;    /* Time at which cred is no longer good	*/
 	uint32_t jobid;		/* Slurm job id for this credential	*/
 	uint32_t stepid;	/* Slurm step id for this credential	*/
+	unsigned char hash_key[CRED_STATE_KEY_LEN];
+				/* lookup key for ctx->state_index	*/
 } cred_state_t;
 
 /*
@@ -150,6 +156,9 @@ struct slurm_cred_context {
 	void *key;		/* private or public key		*/
 	List job_list;		/* List of used jobids (for verifier)	*/
 	List state_list;	/* List of cred states (for verifier)	*/
+	xhash_t *job_index;	/* job_list entries keyed by job id	*/
+	xhash_t *state_index;	/* state_list entries keyed by
+				 * jobid/stepid/ctime			*/
 
 	int expiry_window;	/* expiration window for cached creds	*/
 
@@ -266,6 +275,11 @@ static job_state_t  * _job_state_create(uint32_t jobid);
 static void           _cred_state_destroy(cred_state_t *cs);
 static void           _job_state_destroy(job_state_t   *js);
 
+static void _job_state_id(void *item, const char **key, uint32_t *key_len);
+static void _cred_state_id(void *item, const char **key, uint32_t *key_len);
+static void _cred_state_key(unsigned char *key, uint32_t jobid,
+			    uint32_t stepid, time_t ctime);
+
 static job_state_t  * _find_job_state(slurm_cred_ctx_t ctx, uint32_t jobid);
 static job_state_t  * _insert_job_state(slurm_cred_ctx_t ctx,  uint32_t jobid);
 static int            _find_cred_state(cred_state_t *c, slurm_cred_t *cred);
@@ -461,6 +475,8 @@ slurm_cred_ctx_destroy(slurm_cred_ctx_t ctx)
 		(*(ops.cred_destroy_key))(ctx->exkey);
 	if (ctx->key)
 		(*(ops.cred_destroy_key))(ctx->key);
+	xhash_free(ctx->job_index);
+	xhash_free(ctx->state_index);
 	FREE_NULL_LIST(ctx->job_list);
 	FREE_NULL_LIST(ctx->state_list);
 
@@ -646,16 +662,24 @@ slurm_cred_create(slurm_cred_ctx_t ctx, slurm_cred_arg_t *arg,
 	slurm_mutex_lock(&ctx->mutex);
 	xassert(ctx->magic == CRED_CTX_MAGIC);
 	xassert(ctx->type == SLURM_CRED_CREATOR);
+	slurm_mutex_unlock(&ctx->mutex);
+
+	/*
+	 * Sign without holding ctx->mutex. The signature request may
+	 * involve a round trip to an external daemon (munged), and the
+	 * cred plugins treat the signing key as read-only, so holding
+	 * the lock here would needlessly serialize credential creation
+	 * across all of the RPC threads. That serialization dominates
+	 * the controller cost of launching large job arrays.
+	 */
 	if (_slurm_cred_sign(ctx, cred, protocol_version) < 0)
 		goto fail;
 
-	slurm_mutex_unlock(&ctx->mutex);
 	slurm_mutex_unlock(&cred->mutex);
 
 	return cred;
 
 fail:
-	slurm_mutex_unlock(&ctx->mutex);
 	slurm_mutex_unlock(&cred->mutex);
 	slurm_cred_destroy(cred);
 	return NULL;
@@ -1041,6 +1065,7 @@ int
 slurm_cred_rewind(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 {
 	int rc = 0;
+	unsigned char key[CRED_STATE_KEY_LEN];
 
 	xassert(ctx != NULL);
 
@@ -1049,6 +1074,8 @@ slurm_cred_rewind(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 	xassert(ctx->magic == CRED_CTX_MAGIC);
 	xassert(ctx->type  == SLURM_CRED_VERIFIER);
 
+	_cred_state_key(key, cred->jobid, cred->stepid, cred->ctime);
+	xhash_pop(ctx->state_index, (const char *) key, CRED_STATE_KEY_LEN);
 	rc = list_delete_all(ctx->state_list,
 			     (ListFindF) _find_cred_state, cred);
 
@@ -1573,6 +1600,9 @@ _verifier_ctx_init(slurm_cred_ctx_t ctx)
 
 	ctx->job_list   = list_create((ListDelF) _job_state_destroy);
 	ctx->state_list = list_create((ListDelF) _cred_state_destroy);
+	/* Lookup indexes into the lists above; the lists own the records */
+	ctx->job_index   = xhash_init(_job_state_id, NULL);
+	ctx->state_index = xhash_init(_cred_state_id, NULL);
 
 	return;
 }
@@ -1846,26 +1876,17 @@ _pack_cred(slurm_cred_t *cred, Buf buffer, uint16_t protocol_version)
 	}
 }
 
-static int _list_find_cred_state(void *x, void *key)
-{
-	cred_state_t *s = (cred_state_t *) x;
-	slurm_cred_t *cred = (slurm_cred_t *) key;
-	if ((s->jobid  == cred->jobid)  &&
-	    (s->stepid == cred->stepid) &&
-	    (s->ctime  == cred->ctime))
-		return 1;
-	return 0;
-}
-
-
 static bool
 _credential_replayed(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 {
 	cred_state_t *s = NULL;
+	unsigned char key[CRED_STATE_KEY_LEN];
 
 	_clear_expired_credential_states(ctx);
 
-	s = list_find_first(ctx->state_list, _list_find_cred_state, cred);
+	_cred_state_key(key, cred->jobid, cred->stepid, cred->ctime);
+	s = xhash_get(ctx->state_index, (const char *) key,
+		      CRED_STATE_KEY_LEN);
 
 	/*
 	 * If we found a match, this credential is being replayed.
@@ -1934,21 +1955,41 @@ _credential_revoked(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 	return false;
 }
 
-static int _list_find_job_state(void *x, void *key)
+/* xhash identify function for ctx->job_index */
+static void _job_state_id(void *item, const char **key, uint32_t *key_len)
 {
-	job_state_t *j = (job_state_t *) x;
-	uint32_t jobid = *(uint32_t *) key;
-	if (j->jobid == jobid)
-		return 1;
-	return 0;
+	job_state_t *j = (job_state_t *) item;
+
+	*key = (const char *) &j->jobid;
+	*key_len = sizeof(j->jobid);
+}
+
+/* xhash identify function for ctx->state_index */
+static void _cred_state_id(void *item, const char **key, uint32_t *key_len)
+{
+	cred_state_t *s = (cred_state_t *) item;
+
+	*key = (const char *) s->hash_key;
+	*key_len = CRED_STATE_KEY_LEN;
+}
+
+/* Build a fixed width ctx->state_index lookup key */
+static void _cred_state_key(unsigned char *key, uint32_t jobid,
+			    uint32_t stepid, time_t ctime)
+{
+	uint64_t ctime64 = (uint64_t) ctime;
+
+	memset(key, 0, CRED_STATE_KEY_LEN);
+	memcpy(key, &jobid, sizeof(uint32_t));
+	memcpy(key + sizeof(uint32_t), &stepid, sizeof(uint32_t));
+	memcpy(key + (2 * sizeof(uint32_t)), &ctime64, sizeof(uint64_t));
 }
 
 static job_state_t *
 _find_job_state(slurm_cred_ctx_t ctx, uint32_t jobid)
 {
-	job_state_t *j =
-		list_find_first(ctx->job_list, _list_find_job_state, &jobid);
-	return j;
+	return xhash_get(ctx->job_index, (const char *) &jobid,
+			 sizeof(jobid));
 }
 
 static int
@@ -1961,11 +2002,11 @@ _find_cred_state(cred_state_t *c, slurm_cred_t *cred)
 static job_state_t *
 _insert_job_state(slurm_cred_ctx_t ctx, uint32_t jobid)
 {
-	job_state_t *j = list_find_first(
-		ctx->job_list, _list_find_job_state, &jobid);;
+	job_state_t *j = _find_job_state(ctx, jobid);
 	if (!j) {
 		j = _job_state_create(jobid);
 		list_append(ctx->job_list, j);
+		xhash_add(ctx->job_index, j);
 	} else
 		debug2("%s: we already have a job state for job %u.  No big deal, just an FYI.",
 		       __func__, jobid);
@@ -2013,6 +2054,8 @@ _clear_expired_job_states(slurm_cred_ctx_t ctx)
 		       j->jobid, (uint64_t)j->ctime, (uint64_t)j->revoked,
 		       (uint64_t)j->expiration);
 		if (j->revoked && (now > j->expiration)) {
+			xhash_pop(ctx->job_index, (const char *) &j->jobid,
+				  sizeof(j->jobid));
 			list_delete_item(i);
 		}
 	}
@@ -2020,27 +2063,28 @@ _clear_expired_job_states(slurm_cred_ctx_t ctx)
 	list_iterator_destroy(i);
 }
 
-static int _list_find_expired(void *x, void *key)
-{
-	cred_state_t *s = (cred_state_t *)x;
-	time_t curr_time = *(time_t *)key;
-
-	if (curr_time > s->expiration)
-		return 1;
-	return 0;
-}
-
 static void
 _clear_expired_credential_states(slurm_cred_ctx_t ctx)
 {
 	static time_t last_scan = 0;
 	time_t        now = time(NULL);
+	ListIterator  i   = NULL;
+	cred_state_t *s   = NULL;
 
 	if ((now - last_scan) < 2)	/* Reduces slurmd overhead */
 		return;
 	last_scan = now;
 
-	list_delete_all(ctx->state_list, _list_find_expired, &now);
+	i = list_iterator_create(ctx->state_list);
+	while ((s = list_next(i))) {
+		if (now > s->expiration) {
+			xhash_pop(ctx->state_index,
+				  (const char *) s->hash_key,
+				  CRED_STATE_KEY_LEN);
+			list_delete_item(i);
+		}
+	}
+	list_iterator_destroy(i);
 }
 
 
@@ -2049,6 +2093,7 @@ _insert_cred_state(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 {
 	cred_state_t *s = _cred_state_create(ctx, cred);
 	list_append(ctx->state_list, s);
+	xhash_add(ctx->state_index, s);
 }
 
 
@@ -2061,6 +2106,7 @@ _cred_state_create(slurm_cred_ctx_t ctx, slurm_cred_t *cred)
 	s->stepid     = cred->stepid;
 	s->ctime      = cred->ctime;
 	s->expiration = cred->ctime + ctx->expiry_window;
+	_cred_state_key(s->hash_key, s->jobid, s->stepid, s->ctime);
 
 	return s;
 }
@@ -2091,6 +2137,7 @@ _cred_state_unpack_one(Buf buffer)
 	safe_unpack32(&s->stepid, buffer);
 	safe_unpack_time(&s->ctime, buffer);
 	safe_unpack_time(&s->expiration, buffer);
+	_cred_state_key(s->hash_key, s->jobid, s->stepid, s->ctime);
 	return s;
 
 unpack_error:
@@ -2166,9 +2213,10 @@ _cred_state_unpack(slurm_cred_ctx_t ctx, Buf buffer)
 		if (!(s = _cred_state_unpack_one(buffer)))
 			goto unpack_error;
 
-		if (now < s->expiration)
+		if (now < s->expiration) {
 			list_append(ctx->state_list, s);
-		else
+			xhash_add(ctx->state_index, s);
+		} else
 			_cred_state_destroy(s);
 	}
 
@@ -2211,9 +2259,10 @@ _job_state_unpack(slurm_cred_ctx_t ctx, Buf buffer)
 		if (!(j = _job_state_unpack_one(buffer)))
 			goto unpack_error;
 
-		if (!j->revoked || (j->revoked && (now < j->expiration)))
+		if (!j->revoked || (j->revoked && (now < j->expiration))) {
 			list_append(ctx->job_list, j);
-		else {
+			xhash_add(ctx->job_index, j);
+		} else {
 			debug3 ("not appending expired job %u state",
 			        j->jobid);
 			_job_state_destroy(j);
@@ -434,6 +434,8 @@ static slurm_errtab_t slurm_errtab[] = {
 	  "Job step is not currently suspended"                 },
 	{ ESLURMD_INVALID_SOCKET_NAME_LEN,
 	  "Unix socket name exceeded maximum length"		},
+	{ ESLURMD_BCAST_FILE_UP_TO_DATE,
+	  "Destination file already up to date, transfer not required" },
 
 	/* slurmd errors in user batch job */
 	{ ESCRIPT_CHDIR_FAILED,
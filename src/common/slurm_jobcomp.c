@@ -75,6 +75,139 @@ static plugin_context_t *g_context = NULL;
 static pthread_mutex_t context_lock = PTHREAD_MUTEX_INITIALIZER;
 static bool init_run = false;
 
+/*
+ * Write-behind engine shared by the jobcomp plugins, see
+ * jobcomp_async_init() in slurm_jobcomp.h.  The queue is bounded so a
+ * stuck back end can not grow the controller without limit; when it
+ * fills, jobcomp_async_enqueue() refuses the record and the plugin
+ * falls back to its old synchronous write, which throttles the
+ * completion path naturally.
+ */
+#define JOBCOMP_ASYNC_MAX_QUEUE 4096
+#define JOBCOMP_ASYNC_BATCH 128
+
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t async_tid = 0;
+static List async_list = NULL;
+static jobcomp_async_flush_fn_t async_flush = NULL;
+static bool async_shutdown = false;
+static uint64_t async_queued = 0;	/* records accepted */
+static uint64_t async_flushed = 0;	/* records written out */
+static uint64_t async_fallback = 0;	/* records refused, queue full */
+static uint64_t async_failed = 0;	/* records lost to flush errors */
+static uint32_t async_high_water = 0;	/* deepest queue seen */
+
+static void *_async_writer(void *no_data)
+{
+	List batch;
+	char *record;
+	uint32_t cnt;
+
+	slurm_mutex_lock(&async_lock);
+	while (true) {
+		if (!list_count(async_list)) {
+			if (async_shutdown)
+				break;
+			slurm_cond_wait(&async_cond, &async_lock);
+			continue;
+		}
+		batch = list_create(slurm_destroy_char);
+		while ((list_count(batch) < JOBCOMP_ASYNC_BATCH) &&
+		       (record = list_dequeue(async_list)))
+			list_enqueue(batch, record);
+		slurm_mutex_unlock(&async_lock);
+
+		cnt = list_count(batch);
+		if ((*async_flush)(batch) == SLURM_SUCCESS)
+			async_flushed += cnt;
+		else
+			async_failed += cnt;
+		FREE_NULL_LIST(batch);
+
+		slurm_mutex_lock(&async_lock);
+	}
+	slurm_mutex_unlock(&async_lock);
+	return NULL;
+}
+
+extern int jobcomp_async_init(jobcomp_async_flush_fn_t flush_fn)
+{
+	if (!flush_fn)
+		return SLURM_ERROR;
+
+	slurm_mutex_lock(&async_lock);
+	if (async_list) {	/* already running */
+		slurm_mutex_unlock(&async_lock);
+		return SLURM_SUCCESS;
+	}
+	async_flush = flush_fn;
+	async_shutdown = false;
+	async_list = list_create(slurm_destroy_char);
+	slurm_thread_create(&async_tid, _async_writer, NULL);
+	slurm_mutex_unlock(&async_lock);
+	return SLURM_SUCCESS;
+}
+
+extern int jobcomp_async_enqueue(char *record)
+{
+	uint32_t cnt;
+	int rc = SLURM_SUCCESS;
+
+	if (!record)
+		return SLURM_ERROR;
+
+	slurm_mutex_lock(&async_lock);
+	if (!async_list || async_shutdown) {
+		rc = SLURM_ERROR;
+	} else if ((cnt = list_count(async_list)) >=
+		   JOBCOMP_ASYNC_MAX_QUEUE) {
+		async_fallback++;
+		if ((async_fallback == 1) || !(async_fallback % 1000))
+			error("jobcomp: async queue full (%u records), "
+			      "falling back to synchronous writes "
+			      "(%"PRIu64" times so far)",
+			      cnt, async_fallback);
+		rc = SLURM_ERROR;
+	} else {
+		list_enqueue(async_list, record);
+		async_queued++;
+		if (++cnt > async_high_water)
+			async_high_water = cnt;
+		slurm_cond_signal(&async_cond);
+	}
+	slurm_mutex_unlock(&async_lock);
+	return rc;
+}
+
+extern void jobcomp_async_fini(void)
+{
+	slurm_mutex_lock(&async_lock);
+	if (!async_list) {
+		slurm_mutex_unlock(&async_lock);
+		return;
+	}
+	async_shutdown = true;
+	slurm_cond_signal(&async_cond);
+	slurm_mutex_unlock(&async_lock);
+
+	/* the writer drains the queue before honoring the shutdown */
+	pthread_join(async_tid, NULL);
+
+	slurm_mutex_lock(&async_lock);
+	info("jobcomp: async writer flushed %"PRIu64" of %"PRIu64" records "
+	     "(%"PRIu64" lost to write errors, %"PRIu64" synchronous "
+	     "fallbacks, high water %u)",
+	     async_flushed, async_queued, async_failed, async_fallback,
+	     async_high_water);
+	FREE_NULL_LIST(async_list);
+	async_flush = NULL;
+	async_tid = 0;
+	async_queued = async_flushed = async_fallback = async_failed = 0;
+	async_high_water = 0;
+	slurm_mutex_unlock(&async_lock);
+}
+
 extern void
 jobcomp_destroy_job(void *object)
 {
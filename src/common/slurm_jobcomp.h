@@ -109,4 +109,34 @@ extern List g_slurm_jobcomp_get_jobs(slurmdb_job_cond_t *job_cond);
  */
 extern int g_slurm_jobcomp_archive(slurmdb_archive_cond_t *arch_cond);
 
+/*
+ * Asynchronous write-behind engine for jobcomp plugins.
+ *
+ * A plugin serializes each completion while the job record is still
+ * valid (it can not outlive job_completion_logger()), then hands the
+ * serialized record to the engine instead of writing it out itself.
+ * A single writer thread flushes queued records in batches through the
+ * plugin's flush function, so a slow jobcomp file system or endpoint
+ * no longer stalls the job completion path in slurmctld.
+ *
+ * The flush function is handed a List of serialized records (char *)
+ * owned by the engine and is called without any engine lock held.
+ */
+typedef int (*jobcomp_async_flush_fn_t)(List records);
+
+/* Start the writer thread.  Call from the plugin's init(). */
+extern int jobcomp_async_init(jobcomp_async_flush_fn_t flush_fn);
+
+/*
+ * Queue one serialized completion record.
+ * On SLURM_SUCCESS the engine owns record and will free it after the
+ * flush.  On error (engine not running or queue full) the caller keeps
+ * ownership and should fall back to a synchronous write.
+ */
+extern int jobcomp_async_enqueue(char *record);
+
+/* Drain the queue, stop the writer thread and log flush statistics.
+ * Call from the plugin's fini() before tearing down the back end. */
+extern void jobcomp_async_fini(void);
+
 #endif /*__SLURM_JOBCOMP_H__*/
@@ -1815,6 +1815,17 @@ static slurm_cli_opt_t slurm_opt_mail_user = {
 	.reset_each_pass = true,
 };
 
+COMMON_SBATCH_STRING_OPTION(manifest);
+static slurm_cli_opt_t slurm_opt_manifest = {
+	.name = "manifest",
+	.has_arg = required_argument,
+	.val = LONG_OPT_MANIFEST,
+	.sbatch_early_pass = true,
+	.set_func_sbatch = arg_set_manifest,
+	.get_func = arg_get_manifest,
+	.reset_func = arg_reset_manifest,
+};
+
 static int arg_set_max_threads(slurm_opt_t *opt, const char *arg)
 {
 	if (!opt->srun_opt)
@@ -3565,6 +3576,7 @@ static slurm_cli_opt_t *common_options[] = {
 	&slurm_opt_licenses,
 	&slurm_opt_mail_type,
 	&slurm_opt_mail_user,
+	&slurm_opt_manifest,
 	&slurm_opt_max_threads,
 	&slurm_opt_mcs_label,
 	&slurm_opt_mem,
@@ -115,6 +115,7 @@ enum {
 	LONG_OPT_LINUX_IMAGE,
 	LONG_OPT_MAIL_TYPE,
 	LONG_OPT_MAIL_USER,
+	LONG_OPT_MANIFEST,
 	LONG_OPT_MCS_LABEL,
 	LONG_OPT_MEM,
 	LONG_OPT_MEM_BIND,
@@ -202,6 +203,7 @@ typedef struct sbatch_opt {
 	char *export_env;		/* --export			*/
 	char *export_file;		/* --export-file=file		*/
 	bool ignore_pbs;		/* --ignore-pbs			*/
+	char *manifest;			/* --manifest=file		*/
 	int minsockets;			/* --minsockets=n		*/
 	int mincores;			/* --mincores=n			*/
 	int minthreads;			/* --minthreads=n		*/
@@ -56,6 +56,11 @@
 
 #define MAX_THREAD_COUNT 100
 
+/* A PERSIST_FLAG_PARKABLE connection idle this long at a message
+ * boundary is handed to the parked connection manager, releasing its
+ * service thread slot for active traffic. */
+#define PARK_IDLE_MSEC   10000
+
 /*
  *  Maximum message size. Messages larger than this value (in bytes)
  *  will not be received.
@@ -69,12 +74,22 @@ typedef struct {
 	pthread_t thread_id;
 } persist_service_conn_t;
 
+/* A connection parked off its service thread while idle */
+typedef struct {
+	void *arg;
+	slurm_persist_conn_t *conn;
+} parked_conn_t;
+
 static persist_service_conn_t *persist_service_conn[MAX_THREAD_COUNT];
 static int             thread_count = 0;
 static pthread_mutex_t thread_count_lock = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  thread_count_cond = PTHREAD_COND_INITIALIZER;
 static int             shutdown_time = 0;
 
+static List            parked_conns = NULL;
+static pthread_t       parker_tid = 0;
+static pthread_mutex_t parked_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /* Return time in msec since "start time" */
 static int _tot_wait (struct timeval *start_time)
 {
@@ -171,6 +186,51 @@ static bool _conn_readable(slurm_persist_conn_t *persist_conn)
 	return false;
 }
 
+/* Wait up to timeout_msec for the connection to become readable.
+ * RET 1 readable, 0 idle timeout, -1 error or shutdown */
+static int _conn_wait_readable(slurm_persist_conn_t *persist_conn,
+			       int timeout_msec)
+{
+	struct pollfd ufds;
+	int rc;
+
+	xassert(persist_conn->shutdown);
+
+	ufds.fd     = persist_conn->fd;
+	ufds.events = POLLIN;
+	while (!(*persist_conn->shutdown)) {
+		rc = poll(&ufds, 1, timeout_msec);
+		if (*persist_conn->shutdown)
+			return -1;
+		if (rc == -1) {
+			if ((errno == EINTR) || (errno == EAGAIN))
+				continue;
+			error("poll: %m");
+			return -1;
+		}
+		if (rc == 0)
+			return 0;
+		if ((ufds.revents & POLLHUP) &&
+		    ((ufds.revents & POLLIN) == 0)) {
+			debug2("persistent connection closed");
+			return -1;
+		}
+		if (ufds.revents & (POLLNVAL | POLLERR)) {
+			error("persistent connection experienced an error");
+			return -1;
+		}
+		if ((ufds.revents & POLLIN) == 0) {
+			error("persistent connection %d events %d",
+			      persist_conn->fd, ufds.revents);
+			return -1;
+		}
+		/* revents == POLLIN */
+		errno = 0;
+		return 1;
+	}
+	return -1;
+}
+
 static void _destroy_persist_service(persist_service_conn_t *persist_service)
 {
 	if (persist_service) {
@@ -192,8 +252,121 @@ static void _persist_free_msg_members(slurm_persist_conn_t *persist_conn,
 		slurm_free_msg_data(persist_msg->msg_type, persist_msg->data);
 }
 
+/* Pull a connection out of the parked list and give it back to a
+ * service thread now that it has traffic (or hung up) */
+static void _unpark_connection(parked_conn_t *parked)
+{
+	ListIterator itr;
+	parked_conn_t *p;
+
+	slurm_mutex_lock(&parked_lock);
+	itr = list_iterator_create(parked_conns);
+	while ((p = list_next(itr))) {
+		if (p == parked) {
+			list_remove(itr);
+			break;
+		}
+	}
+	list_iterator_destroy(itr);
+	slurm_mutex_unlock(&parked_lock);
+
+	parked->conn->flags |= PERSIST_FLAG_ALREADY_INITED;
+	slurm_persist_conn_recv_thread_init(parked->conn, -1, parked->arg);
+	xfree(parked);
+}
+
+/* Watch all parked connections with a single poll(), dispatching each
+ * one back to a service thread when it becomes readable.  This lets the
+ * daemon hold many more idle clients than MAX_THREAD_COUNT.
+ * Meant to execute as a pthread. */
+static void *_parked_conn_mgr(void *no_data)
+{
+	parked_conn_t *parked;
+	struct pollfd *ufds = NULL;
+	parked_conn_t **lookup = NULL;
+	ListIterator itr;
+	int nfds, i, rc;
+
+	while (!shutdown_time) {
+		slurm_mutex_lock(&parked_lock);
+		nfds = list_count(parked_conns);
+		if (!nfds) {
+			slurm_mutex_unlock(&parked_lock);
+			sleep(1);
+			continue;
+		}
+		ufds = xmalloc(sizeof(struct pollfd) * nfds);
+		lookup = xmalloc(sizeof(parked_conn_t *) * nfds);
+		i = 0;
+		itr = list_iterator_create(parked_conns);
+		while ((parked = list_next(itr))) {
+			ufds[i].fd = parked->conn->fd;
+			ufds[i].events = POLLIN;
+			lookup[i] = parked;
+			i++;
+		}
+		list_iterator_destroy(itr);
+		slurm_mutex_unlock(&parked_lock);
+
+		/* Bounded timeout so newly parked connections and
+		 * shutdown are noticed promptly */
+		rc = poll(ufds, nfds, 1000);
+		if ((rc > 0) && !shutdown_time) {
+			for (i = 0; i < nfds; i++) {
+				if (!ufds[i].revents)
+					continue;
+				_unpark_connection(lookup[i]);
+			}
+		}
+		xfree(ufds);
+		xfree(lookup);
+	}
+
+	/* Clean up whatever is still parked at shutdown */
+	slurm_mutex_lock(&parked_lock);
+	while ((parked = list_dequeue(parked_conns))) {
+		if (parked->conn->callback_fini)
+			(parked->conn->callback_fini)(parked->arg);
+		slurm_persist_conn_destroy(parked->conn);
+		xfree(parked);
+	}
+	slurm_mutex_unlock(&parked_lock);
+	return NULL;
+}
+
+/* Hand an idle connection to the parked connection manager and release
+ * this service thread's slot for active traffic */
+static void _park_connection(persist_service_conn_t *service_conn)
+{
+	parked_conn_t *parked = xmalloc(sizeof(parked_conn_t));
+	int thread_loc = service_conn->thread_loc;
+
+	parked->conn = service_conn->conn;
+	parked->arg = service_conn->arg;
+
+	slurm_mutex_lock(&parked_lock);
+	if (!parked_conns)
+		parked_conns = list_create(NULL);
+	list_append(parked_conns, parked);
+	if (!parker_tid)
+		slurm_thread_create(&parker_tid, _parked_conn_mgr, NULL);
+	slurm_mutex_unlock(&parked_lock);
+
+	/* Free the thread slot without destroying the connection */
+	slurm_mutex_lock(&thread_count_lock);
+	persist_service_conn[thread_loc] = NULL;
+	if (thread_count > 0)
+		thread_count--;
+	else
+		error("thread_count underflow");
+	slurm_cond_broadcast(&thread_count_cond);
+	slurm_mutex_unlock(&thread_count_lock);
+
+	xfree(service_conn);
+}
+
 static int _process_service_connection(
-	slurm_persist_conn_t *persist_conn, void *arg)
+	slurm_persist_conn_t *persist_conn, void *arg, bool *parked)
 {
 	uint32_t nw_size = 0, msg_size = 0, uid = NO_VAL;
 	char *msg_char = NULL;
@@ -208,11 +381,29 @@ static int _process_service_connection(
 	debug2("Opened connection %d from %s", persist_conn->fd,
 	       persist_conn->rem_host);
 
-	if (persist_conn->flags & PERSIST_FLAG_ALREADY_INITED)
+	if (persist_conn->flags & PERSIST_FLAG_ALREADY_INITED) {
 		first = false;
+		if (persist_conn->flags & PERSIST_FLAG_PARKABLE)
+			uid = persist_conn->auth_uid;
+	}
 
 	while (!(*persist_conn->shutdown) && !fini) {
-		if (!_conn_readable(persist_conn))
+		if (!first && (persist_conn->flags & PERSIST_FLAG_PARKABLE)) {
+			/*
+			 * At a message boundary an idle connection can be
+			 * parked off this thread; it comes back through
+			 * another service thread when traffic resumes.
+			 */
+			int readable = _conn_wait_readable(persist_conn,
+							   PARK_IDLE_MSEC);
+			if (readable < 0)
+				break;	/* problem with this socket */
+			if (readable == 0) {
+				persist_conn->auth_uid = uid;
+				*parked = true;
+				break;
+			}
+		} else if (!_conn_readable(persist_conn))
 			break;		/* problem with this socket */
 		msg_read = read(persist_conn->fd, &nw_size, sizeof(nw_size));
 		if (msg_read == 0)	/* EOF */
@@ -304,6 +495,7 @@ static int _process_service_connection(
 static void *_service_connection(void *arg)
 {
 	persist_service_conn_t *service_conn = arg;
+	bool parked = false;
 
 	xassert(service_conn);
 	xassert(service_conn->conn);
@@ -319,17 +511,25 @@ static void *_service_connection(void *arg)
 
 	service_conn->thread_id = pthread_self();
 
-	_process_service_connection(service_conn->conn, service_conn->arg);
+	_process_service_connection(service_conn->conn, service_conn->arg,
+				    &parked);
 
-	if (service_conn->conn->callback_fini)
-		(service_conn->conn->callback_fini)(service_conn->arg);
-	else
-		debug("Persist connection from cluster %s has disconnected",
-		      service_conn->conn->cluster_name);
-
-	/* service_conn is freed inside here */
-	slurm_persist_conn_free_thread_loc(service_conn->thread_loc);
-//	xfree(service_conn);
+	if (parked) {
+		/* service_conn is freed inside here, the connection and
+		 * its arg live on with the parked connection manager */
+		_park_connection(service_conn);
+	} else {
+		if (service_conn->conn->callback_fini)
+			(service_conn->conn->callback_fini)(service_conn->arg);
+		else
+			debug("Persist connection from cluster %s has "
+			      "disconnected",
+			      service_conn->conn->cluster_name);
+
+		/* service_conn is freed inside here */
+		slurm_persist_conn_free_thread_loc(service_conn->thread_loc);
+//		xfree(service_conn);
+	}
 
 	/* In order to avoid zombie threads, detach the thread now before
 	 * exiting.  slurm_persist_conn_recv_server_fini() will not try to join
@@ -404,6 +604,15 @@ extern void slurm_persist_conn_recv_server_fini(void)
 		persist_service_conn[i] = NULL;
 	}
 	slurm_mutex_unlock(&thread_count_lock);
+
+	if (parker_tid) {
+		pthread_kill(parker_tid, SIGUSR1);
+		pthread_join(parker_tid, NULL);
+		parker_tid = 0;
+	}
+	slurm_mutex_lock(&parked_lock);
+	FREE_NULL_LIST(parked_conns);
+	slurm_mutex_unlock(&parked_lock);
 }
 
 extern void slurm_persist_conn_recv_thread_init(slurm_persist_conn_t *persist_conn,
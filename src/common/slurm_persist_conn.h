@@ -45,6 +45,10 @@
 #define PERSIST_FLAG_ALREADY_INITED 0x0004
 #define PERSIST_FLAG_P_USER_CASE    0x0008
 #define PERSIST_FLAG_SUPPRESS_ERR   0x0010
+/* Server side: an idle connection may be parked off its service thread
+ * and watched by a single poll() thread until traffic resumes, so idle
+ * clients do not pin thread slots. */
+#define PERSIST_FLAG_PARKABLE       0x0020
 
 typedef enum {
 	PERSIST_TYPE_NONE = 0,
@@ -52,6 +56,8 @@ typedef enum {
 	PERSIST_TYPE_FED,
 	PERSIST_TYPE_HA_CTL,
 	PERSIST_TYPE_HA_DBD,
+	PERSIST_TYPE_RPC,	/* long-lived slurmd RPC channel to the
+				 * controller */
 } persist_conn_type_t;
 
 typedef struct {
@@ -63,6 +69,9 @@ typedef struct {
 
 typedef struct {
 	void *auth_cred;
+	uint32_t auth_uid;	/* uid from the persist init, kept here so it
+				 * survives while the connection is parked off
+				 * its service thread (PERSIST_FLAG_PARKABLE) */
 	int (*callback_proc)(void *arg,
 			     persist_msg_t *msg,
 			     Buf *out_buffer, uint32_t *uid);
@@ -45,16 +45,23 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <poll.h>
 #include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <time.h>
 #include <unistd.h>
 
+#if HAVE_LIBZ
+#  include <zlib.h>
+#endif
+
 /* PROJECT INCLUDES */
 #include "src/common/assoc_mgr.h"
 #include "src/common/fd.h"
@@ -87,11 +94,21 @@ strong_alias(get_unit_type, slurm_get_unit_type);
 /* #DEFINES */
 #define _DEBUG	0
 
+/*
+ * Only compress message bodies at least this large. Small messages
+ * dominate normal traffic and would pay the CPU cost for negligible
+ * savings; the target is multi-MB job/node info responses.
+ */
+#define COMPRESS_MSG_THRESHOLD (256 * 1024)
+
 /* STATIC VARIABLES */
 static int message_timeout = -1;
 
 /* STATIC FUNCTIONS */
 static char *_global_auth_key(void);
+#if HAVE_LIBZ
+static Buf   _inflate_msg_body(Buf buffer, uint32_t body_length);
+#endif
 static void  _remap_slurmctld_errno(void);
 static int   _unpack_msg_uid(Buf buffer, uint16_t protocol_version);
 static bool  _is_port_ok(int, uint16_t, bool);
@@ -3464,8 +3481,29 @@ extern int slurm_unpack_received_msg(slurm_msg_t *msg, int fd, Buf buffer)
 
 	msg->body_offset =  get_buf_offset(buffer);
 
-	if ((header.body_length > remaining_buf(buffer)) ||
-	    (unpack_msg(msg, buffer) != SLURM_SUCCESS)) {
+	if (header.flags & SLURM_MSG_ZLIB_COMPRESS) {
+#if HAVE_LIBZ
+		Buf z_buffer = NULL;
+
+		if ((header.body_length > remaining_buf(buffer)) ||
+		    !(z_buffer = _inflate_msg_body(buffer,
+						   header.body_length)) ||
+		    (unpack_msg(msg, z_buffer) != SLURM_SUCCESS)) {
+			free_buf(z_buffer);
+			rc = ESLURM_PROTOCOL_INCOMPLETE_PACKET;
+			(void) g_slurm_auth_destroy(auth_cred);
+			goto total_return;
+		}
+		free_buf(z_buffer);
+#else
+		error("%s: %s body is compressed but zlib support is not built",
+		      __func__, rpc_num2string(header.msg_type));
+		rc = ESLURM_PROTOCOL_INCOMPLETE_PACKET;
+		(void) g_slurm_auth_destroy(auth_cred);
+		goto total_return;
+#endif
+	} else if ((header.body_length > remaining_buf(buffer)) ||
+		   (unpack_msg(msg, buffer) != SLURM_SUCCESS)) {
 		rc = ESLURM_PROTOCOL_INCOMPLETE_PACKET;
 		(void) g_slurm_auth_destroy(auth_cred);
 		goto total_return;
@@ -3494,6 +3532,72 @@ total_return:
  * receive message functions
 \**********************************************************************/
 
+/*
+ * Optional capture of received raw message buffers for offline replay
+ * (see testsuite/performance/rpc-replay.c). Records are written in
+ * host byte order: magic, seconds, microseconds, length, then the raw
+ * framed message body exactly as read from the socket.
+ */
+#define RPC_CAPTURE_MAGIC 0x52504343	/* "RPCC" */
+
+static pthread_mutex_t rpc_capture_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int rpc_capture_fd = -1;
+
+extern int slurm_rpc_capture_start(const char *path)
+{
+	int fd;
+
+	fd = open(path, O_CREAT | O_WRONLY | O_APPEND, 0600);
+	if (fd < 0) {
+		error("%s: could not open %s: %m", __func__, path);
+		return SLURM_ERROR;
+	}
+	slurm_mutex_lock(&rpc_capture_mutex);
+	if (rpc_capture_fd >= 0)
+		(void) close(rpc_capture_fd);
+	rpc_capture_fd = fd;
+	slurm_mutex_unlock(&rpc_capture_mutex);
+	info("RPC capture to %s started", path);
+	return SLURM_SUCCESS;
+}
+
+extern void slurm_rpc_capture_stop(void)
+{
+	slurm_mutex_lock(&rpc_capture_mutex);
+	if (rpc_capture_fd >= 0) {
+		(void) close(rpc_capture_fd);
+		rpc_capture_fd = -1;
+		info("RPC capture stopped");
+	}
+	slurm_mutex_unlock(&rpc_capture_mutex);
+}
+
+static void _rpc_capture(char *buf, size_t buflen)
+{
+	uint32_t hdr[4];
+	struct timeval tv;
+	struct iovec iov[2];
+
+	gettimeofday(&tv, NULL);
+	hdr[0] = RPC_CAPTURE_MAGIC;
+	hdr[1] = (uint32_t) tv.tv_sec;
+	hdr[2] = (uint32_t) tv.tv_usec;
+	hdr[3] = (uint32_t) buflen;
+	iov[0].iov_base = hdr;
+	iov[0].iov_len  = sizeof(hdr);
+	iov[1].iov_base = buf;
+	iov[1].iov_len  = buflen;
+
+	slurm_mutex_lock(&rpc_capture_mutex);
+	if ((rpc_capture_fd >= 0) &&
+	    (writev(rpc_capture_fd, iov, 2) < 0)) {
+		error("%s: write failed, capture stopped: %m", __func__);
+		(void) close(rpc_capture_fd);
+		rpc_capture_fd = -1;
+	}
+	slurm_mutex_unlock(&rpc_capture_mutex);
+}
+
 /*
  * NOTE: memory is allocated for the returned msg must be freed at
  *       some point using the slurm_free_functions.
@@ -3571,6 +3675,9 @@ int slurm_receive_msg(int fd, slurm_msg_t *msg, int timeout)
 		goto endit;
 	}
 
+	if (rpc_capture_fd >= 0)
+		_rpc_capture(buf, buflen);
+
 #if	_DEBUG
 	_print_data (buf, buflen);
 #endif
@@ -3933,6 +4040,8 @@ int slurm_receive_msg_and_forward(int fd, slurm_addr_t *orig_addr,
 		if (msg->forward_struct->timeout <= 0)
 			msg->forward_struct->timeout = message_timeout;
 		msg->forward_struct->fwd_cnt = header.forward.cnt;
+		msg->forward_struct->nodelist =
+			xstrdup(header.forward.nodelist);
 
 		debug3("forwarding messages to %u nodes with timeout of %d",
 		       msg->forward_struct->fwd_cnt,
@@ -4012,6 +4121,80 @@ total_return:
  * send message functions
 \**********************************************************************/
 
+#if HAVE_LIBZ
+/*
+ * Compress a packed message body in place, replacing it with its
+ * unpacked length followed by the zlib compressed data and setting
+ * SLURM_MSG_ZLIB_COMPRESS in the header. The body starts at
+ * body_offset and extends to the buffer's current offset. Does
+ * nothing if the body is below COMPRESS_MSG_THRESHOLD or does not
+ * shrink, so the flag is only set when the receiver saves work.
+ */
+static void _compress_msg_body(header_t *hdr, Buf buffer,
+			       uint32_t body_offset)
+{
+	uint32_t body_len = get_buf_offset(buffer) - body_offset;
+	uLongf z_len;
+	Bytef *z_buf;
+
+	if (body_len < COMPRESS_MSG_THRESHOLD)
+		return;
+
+	z_len = compressBound(body_len);
+	z_buf = xmalloc_nz(z_len);
+	if ((compress2(z_buf, &z_len,
+		       (Bytef *) (get_buf_data(buffer) + body_offset),
+		       body_len, Z_BEST_SPEED) != Z_OK) ||
+	    ((z_len + sizeof(uint32_t)) >= body_len)) {
+		xfree(z_buf);
+		return;
+	}
+
+	set_buf_offset(buffer, body_offset);
+	pack32(body_len, buffer);
+	packmem_array((char *) z_buf, z_len, buffer);
+	xfree(z_buf);
+	hdr->flags |= SLURM_MSG_ZLIB_COMPRESS;
+	debug2("%s: compressed %s body from %u to %u bytes",
+	       __func__, rpc_num2string(hdr->msg_type),
+	       body_len, (uint32_t) (z_len + sizeof(uint32_t)));
+}
+
+/*
+ * Inflate a message body compressed by _compress_msg_body() into a
+ * new buffer ready for unpack_msg(). The source buffer's offset is at
+ * the start of the body, which holds the unpacked length followed by
+ * body_length - 4 bytes of zlib compressed data. Returns NULL if the
+ * body is malformed.
+ */
+static Buf _inflate_msg_body(Buf buffer, uint32_t body_length)
+{
+	uint32_t orig_len;
+	uLongf dst_len;
+	Buf z_buffer;
+
+	if ((body_length <= sizeof(uint32_t)) ||
+	    (body_length > remaining_buf(buffer)))
+		return NULL;
+	if (unpack32(&orig_len, buffer))
+		return NULL;
+
+	if (!(z_buffer = init_buf(orig_len)))
+		return NULL;
+	dst_len = orig_len;
+	if ((uncompress((Bytef *) get_buf_data(z_buffer), &dst_len,
+			(Bytef *) (get_buf_data(buffer) +
+				   get_buf_offset(buffer)),
+			body_length - sizeof(uint32_t)) != Z_OK) ||
+	    (dst_len != orig_len)) {
+		free_buf(z_buffer);
+		return NULL;
+	}
+
+	return z_buffer;
+}
+#endif
+
 /*
  *  Do the wonderful stuff that needs be done to pack msg
  *  and hdr into buffer
@@ -4023,6 +4206,21 @@ _pack_msg(slurm_msg_t *msg, header_t *hdr, Buf buffer)
 
 	tmplen = get_buf_offset(buffer);
 	pack_msg(msg, buffer);
+
+#if HAVE_LIBZ
+	/*
+	 * Compress large info responses for peers recent enough to
+	 * know the flag. The header version is the negotiated protocol
+	 * version of the connection, so an older client never sees a
+	 * compressed body.
+	 */
+	if (((msg->msg_type == RESPONSE_JOB_INFO) ||
+	     (msg->msg_type == RESPONSE_NODE_INFO)) &&
+	    (hdr->version >= SLURM_20_02_PROTOCOL_VERSION) &&
+	    (hdr->forward.cnt == 0))
+		_compress_msg_body(hdr, buffer, tmplen);
+#endif
+
 	msglen = get_buf_offset(buffer) - tmplen;
 
 	/* update header with correct cred and msg lengths */
@@ -4599,6 +4797,60 @@ _send_and_recv_msgs(int fd, slurm_msg_t *req, int timeout)
 	return ret_list;
 }
 
+/*
+ * Long-lived RPC channel to the local controller, installed by slurmd
+ * via slurm_ctld_rpc_conn_set(). RPCs are serialized on the connection
+ * one request/response pair at a time; any failure falls back to a
+ * fresh per-RPC connection.
+ */
+static slurm_persist_conn_t *ctld_rpc_conn = NULL;
+static pthread_mutex_t ctld_rpc_conn_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+extern void slurm_ctld_rpc_conn_set(void *conn)
+{
+	slurm_mutex_lock(&ctld_rpc_conn_mutex);
+	ctld_rpc_conn = conn;
+	slurm_mutex_unlock(&ctld_rpc_conn_mutex);
+}
+
+/*
+ * Send a request over the installed controller RPC channel and, if
+ * with_resp is set, wait for the single response to it.
+ * RET SLURM_ERROR if the channel is absent or fails, in which case
+ * nothing went out on the wire as a whole message and the caller can
+ * retry over a fresh connection.
+ */
+static int _ctld_rpc_conn_msg(slurm_msg_t *req, slurm_msg_t *resp,
+			      bool with_resp)
+{
+	int rc = SLURM_ERROR;
+
+	slurm_mutex_lock(&ctld_rpc_conn_mutex);
+	if (!ctld_rpc_conn || (ctld_rpc_conn->fd < 0))
+		goto done;
+
+	req->conn = ctld_rpc_conn;
+	if (slurm_send_node_msg(ctld_rpc_conn->fd, req) < 0) {
+		req->conn = NULL;
+		goto done;
+	}
+	req->conn = NULL;
+
+	if (!with_resp) {
+		rc = SLURM_SUCCESS;
+		goto done;
+	}
+
+	resp->conn = ctld_rpc_conn;
+	rc = slurm_receive_msg(ctld_rpc_conn->fd, resp, 0);
+	resp->conn = NULL;
+	if (rc != SLURM_SUCCESS)
+		rc = SLURM_ERROR;
+done:
+	slurm_mutex_unlock(&ctld_rpc_conn_mutex);
+	return rc;
+}
+
 /*
  * slurm_send_recv_controller_msg
  * opens a connection to the controller, sends the controller a message,
@@ -4632,6 +4884,12 @@ extern int slurm_send_recv_controller_msg(slurm_msg_t * request_msg,
 	request_msg->ret_list = NULL;
 	request_msg->forward_struct = NULL;
 
+	/* Prefer the long-lived controller channel when one is installed */
+	if (!comm_cluster_rec &&
+	    (_ctld_rpc_conn_msg(request_msg, response_msg, true)
+	     == SLURM_SUCCESS))
+		return SLURM_SUCCESS;
+
 tryagain:
 	retry = 1;
 	if (comm_cluster_rec)
@@ -4750,6 +5008,16 @@ extern int slurm_send_only_controller_msg(slurm_msg_t *req,
 	slurm_addr_t ctrl_addr;
 	bool     use_backup = false;
 
+	/*
+	 * Prefer the long-lived controller channel when one is installed.
+	 * Only message types whose handler never responds may go out
+	 * without a response read or the channel would fall out of step.
+	 */
+	if (!comm_cluster_rec &&
+	    (req->msg_type == MESSAGE_EPILOG_COMPLETE) &&
+	    (_ctld_rpc_conn_msg(req, NULL, false) == SLURM_SUCCESS))
+		return SLURM_SUCCESS;
+
 	/*
 	 *  Open connection to Slurm controller:
 	 */
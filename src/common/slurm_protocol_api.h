@@ -1048,6 +1048,16 @@ extern int slurm_accept_msg_conn(int open_fd, slurm_addr_t * slurm_address);
  * receive message functions
 \**********************************************************************/
 
+/*
+ * Start/stop appending timestamped raw copies of every message
+ * received through slurm_receive_msg() to the given file, for offline
+ * replay with testsuite/performance/rpc-replay. Enabled in slurmctld
+ * with SlurmctldParameters=rpc_capture_file=<path>.
+ * RET SLURM_SUCCESS or SLURM_ERROR if the file cannot be opened
+ */
+extern int slurm_rpc_capture_start(const char *path);
+extern void slurm_rpc_capture_stop(void);
+
 /* unpack a complete recieved message
  * OUT msg - a slurm_msg struct to be filled in by the function
  * IN  fd - file descriptor the message came from
@@ -1273,6 +1283,17 @@ int slurm_send_rc_msg(slurm_msg_t * request_msg, int rc);
  */
 int slurm_send_rc_err_msg(slurm_msg_t *msg, int rc, char *err_msg);
 
+/*
+ * slurm_ctld_rpc_conn_set
+ * Install (NULL to remove) a long-lived persistent connection to the
+ * local controller. While one is installed the controller send
+ * functions below use it, one RPC at a time, instead of opening a new
+ * TCP connection and auth credential per message. The caller retains
+ * ownership of the connection. Used by slurmd.
+ * IN conn - open persistent connection of type PERSIST_TYPE_RPC
+ */
+extern void slurm_ctld_rpc_conn_set(void *conn);
+
 /*
  * slurm_send_recv_controller_msg
  * opens a connection to the controller, sends the controller a message,
@@ -104,5 +104,7 @@
 #define SLURMDBD_CONNECTION     0x0002
 #define SLURM_MSG_KEEP_BUFFER   0x0004
 #define SLURM_DROP_PRIV		0x0008
+#define SLURM_MSG_ZLIB_COMPRESS 0x0010	/* message body is zlib compressed,
+					 * prefixed by its unpacked length */
 
 #endif
@@ -779,6 +779,20 @@ extern void slurm_free_job_step_kill_msg(job_step_kill_msg_t * msg)
 	}
 }
 
+extern void slurm_free_kill_jobs_msg(kill_jobs_msg_t *msg)
+{
+	int i;
+
+	if (msg) {
+		xfree(msg->user_name);
+		xfree(msg->partition);
+		for (i = 0; i < msg->jobs_cnt; i++)
+			xfree(msg->jobs_array[i]);
+		xfree(msg->jobs_array);
+		xfree(msg);
+	}
+}
+
 extern void slurm_free_job_info_request_msg(job_info_request_msg_t *msg)
 {
 	if (msg) {
@@ -1064,6 +1078,37 @@ extern void slurm_free_job_info_members(job_info_t * job)
 	}
 }
 
+/*
+ * Free only those job fields which the unpack functions allocate even
+ * in zero-copy mode. The remaining string fields are pointers into the
+ * message's reference counted unpack buffer (see the backing_buf field
+ * of job_info_msg_t) and are released when that buffer is.
+ */
+extern void slurm_free_job_info_members_shallow(job_info_t * job)
+{
+	int i;
+
+	if (job) {
+		if (job->array_bitmap)
+			bit_free((bitstr_t *) job->array_bitmap);
+		xfree(job->array_task_str);
+		xfree(job->exc_node_inx);
+		if (job->gres_detail_str) {
+			for (i = 0; i < job->gres_detail_cnt; i++)
+				xfree(job->gres_detail_str[i]);
+			xfree(job->gres_detail_str);
+		}
+		xfree(job->node_inx);
+		xfree(job->nodes);
+		xfree(job->partition);
+		xfree(job->req_node_inx);
+		select_g_select_jobinfo_free(job->select_jobinfo);
+		job->select_jobinfo = NULL;
+		free_job_resources(&job->job_resrcs);
+		xfree(job->state_desc);
+	}
+}
+
 
 extern void slurm_free_acct_gather_node_resp_msg(
 	acct_gather_node_resp_msg_t *msg)
@@ -1569,9 +1614,44 @@ extern void slurm_free_stats_response_msg(stats_info_response_msg_t *msg)
 {
 	int i;
 	if (msg) {
+		for (i = 0; i < msg->lock_domain_cnt; i++)
+			xfree(msg->lock_domain_names[i]);
+		xfree(msg->lock_domain_names);
+		xfree(msg->lock_domain_lock_cnt);
+		xfree(msg->lock_domain_wait_time);
+		xfree(msg->lock_domain_wait_max);
+		xfree(msg->lock_domain_hold_time);
+		xfree(msg->lock_domain_hold_max);
+		xfree(msg->lock_hold_hist);
+		xfree(msg->lock_caller_addr);
+		xfree(msg->lock_caller_lock_cnt);
+		xfree(msg->lock_caller_wait_time);
+		xfree(msg->lock_caller_wait_max);
+		xfree(msg->lock_caller_hold_time);
+		xfree(msg->lock_caller_hold_max);
+		xfree(msg->bf_cycle_rec_when);
+		xfree(msg->bf_cycle_rec_usec);
+		xfree(msg->bf_cycle_rec_try_usec);
+		xfree(msg->bf_cycle_rec_depth);
+		xfree(msg->bf_cycle_rec_depth_try);
+		xfree(msg->bf_cycle_rec_yields);
+		xfree(msg->bf_cycle_rec_table_size);
+		xfree(msg->bf_cycle_rec_queue_len);
+		xfree(msg->job_timing_submit_eval_hist);
+		xfree(msg->job_timing_alloc_launch_hist);
+		xfree(msg->job_timing_complete_clean_hist);
+		for (i = 0; i < msg->queue_cnt; i++) {
+			xfree(msg->queue_name[i]);
+		}
+		xfree(msg->queue_name);
+		xfree(msg->queue_depth);
+		xfree(msg->queue_head_age);
+		xfree(msg->queue_enqueued);
+		xfree(msg->queue_dequeued);
 		xfree(msg->rpc_type_id);
 		xfree(msg->rpc_type_cnt);
 		xfree(msg->rpc_type_time);
+		xfree(msg->rpc_type_hist);
 		xfree(msg->rpc_user_id);
 		xfree(msg->rpc_user_cnt);
 		xfree(msg->rpc_user_time);
@@ -4022,6 +4102,7 @@ extern void slurm_free_job_info_msg(job_info_msg_t * job_buffer_ptr)
 			_free_all_job_info(job_buffer_ptr);
 			xfree(job_buffer_ptr->job_array);
 		}
+		FREE_NULL_LIST(job_buffer_ptr->backing_buf);
 		xfree(job_buffer_ptr);
 	}
 }
@@ -4034,8 +4115,13 @@ static void _free_all_job_info(job_info_msg_t *msg)
 	    (msg->job_array == NULL))
 		return;
 
-	for (i = 0; i < msg->record_count; i++)
-		slurm_free_job_info_members (&msg->job_array[i]);
+	for (i = 0; i < msg->record_count; i++) {
+		if (msg->backing_buf)
+			slurm_free_job_info_members_shallow(
+				&msg->job_array[i]);
+		else
+			slurm_free_job_info_members (&msg->job_array[i]);
+	}
 }
 
 /*
@@ -4156,6 +4242,24 @@ extern void slurm_free_node_info_msg(node_info_msg_t * msg)
 			_free_all_node_info(msg);
 			xfree(msg->node_array);
 		}
+		FREE_NULL_LIST(msg->backing_buf);
+		xfree(msg);
+	}
+}
+
+/*
+ * slurm_free_node_summary_info_msg - free the node summary response message
+ * IN msg - pointer to node summary response message
+ * NOTE: buffer is loaded by slurm_load_node_summary.
+ */
+extern void slurm_free_node_summary_info_msg(node_summary_info_msg_t *msg)
+{
+	int i;
+
+	if (msg) {
+		for (i = 0; i < msg->record_count; i++)
+			xfree(msg->summary_array[i].partition);
+		xfree(msg->summary_array);
 		xfree(msg);
 	}
 }
@@ -4167,8 +4271,13 @@ static void _free_all_node_info(node_info_msg_t *msg)
 	if ((msg == NULL) || (msg->node_array == NULL))
 		return;
 
-	for (i = 0; i < msg->record_count; i++)
-		slurm_free_node_info_members(&msg->node_array[i]);
+	for (i = 0; i < msg->record_count; i++) {
+		if (msg->backing_buf)
+			slurm_free_node_info_members_shallow(
+				&msg->node_array[i]);
+		else
+			slurm_free_node_info_members(&msg->node_array[i]);
+	}
 }
 
 extern void slurm_free_node_info_members(node_info_t * node)
@@ -4200,6 +4309,28 @@ extern void slurm_free_node_info_members(node_info_t * node)
 	}
 }
 
+/*
+ * Free only those node fields which are allocated even in zero-copy
+ * mode: fields populated by the client after the unpack plus the
+ * sub-structures. The string fields unpacked from the message are
+ * pointers into its reference counted unpack buffer (see the
+ * backing_buf field of node_info_msg_t).
+ */
+extern void slurm_free_node_info_members_shallow(node_info_t * node)
+{
+	if (node) {
+		xfree(node->cluster_name);
+		acct_gather_energy_destroy(node->energy);
+		ext_sensors_destroy(node->ext_sensors);
+		power_mgmt_data_free(node->power);
+		xfree(node->name);
+		xfree(node->partitions);
+		select_g_select_nodeinfo_free(node->select_nodeinfo);
+		node->select_nodeinfo = NULL;
+		/* Do NOT free node, it is an element of an array */
+	}
+}
+
 
 /*
  * slurm_free_partition_info_msg - free the partition information
@@ -4660,8 +4791,12 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 		slurm_free_job_info_request_msg(data);
 		break;
 	case REQUEST_NODE_INFO:
+	case REQUEST_NODE_INFO_SUMMARY:
 		slurm_free_node_info_request_msg(data);
 		break;
+	case RESPONSE_NODE_INFO_SUMMARY:
+		slurm_free_node_summary_info_msg(data);
+		break;
 	case REQUEST_NODE_INFO_SINGLE:
 		slurm_free_node_info_single_msg(data);
 		break;
@@ -4676,6 +4811,9 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 	case SRUN_STEP_SIGNAL:
 		slurm_free_job_step_kill_msg(data);
 		break;
+	case REQUEST_KILL_JOBS:
+		slurm_free_kill_jobs_msg(data);
+		break;
 	case REQUEST_COMPLETE_JOB_ALLOCATION:
 		slurm_free_complete_job_allocation_msg(data);
 		break;
@@ -5015,7 +5153,9 @@ extern int slurm_free_msg_data(slurm_msg_type_t type, void *data)
 		break;
 	case REQUEST_JOB_PACK_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_JOB_PACK:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 	case RESPONSE_JOB_PACK_ALLOCATION:
+	case RESPONSE_SUBMIT_BATCH_JOBS:
 		FREE_NULL_LIST(data);
 		break;
 	case REQUEST_SET_FS_DAMPENING_FACTOR:
@@ -5305,6 +5445,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_BURST_BUFFER_STATUS";
 	case RESPONSE_BURST_BUFFER_STATUS:
 		return "RESPONSE_BURST_BUFFER_STATUS";
+	case REQUEST_NODE_INFO_SUMMARY:
+		return "REQUEST_NODE_INFO_SUMMARY";
+	case RESPONSE_NODE_INFO_SUMMARY:
+		return "RESPONSE_NODE_INFO_SUMMARY";
 
 	case REQUEST_UPDATE_JOB:				/* 3001 */
 		return "REQUEST_UPDATE_JOB";
@@ -5394,6 +5538,10 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_JOB_PACK_ALLOC_INFO";
 	case REQUEST_SUBMIT_BATCH_JOB_PACK:
 		return "REQUEST_SUBMIT_BATCH_JOB_PACK";
+	case REQUEST_SUBMIT_BATCH_JOBS:
+		return "REQUEST_SUBMIT_BATCH_JOBS";
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		return "RESPONSE_SUBMIT_BATCH_JOBS";
 
 	case REQUEST_JOB_STEP_CREATE:				/* 5001 */
 		return "REQUEST_JOB_STEP_CREATE";
@@ -5459,6 +5607,8 @@ rpc_num2string(uint16_t opcode)
 		return "REQUEST_KILL_JOB";
 	case REQUEST_KILL_JOBSTEP:
 		return "REQUEST_KILL_JOBSTEP";
+	case REQUEST_KILL_JOBS:
+		return "REQUEST_KILL_JOBS";
 	case RESPONSE_JOB_ARRAY_ERRORS:
 		return "RESPONSE_JOB_ARRAY_ERRORS";
 	case REQUEST_NETWORK_CALLERID:
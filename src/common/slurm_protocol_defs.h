@@ -170,6 +170,9 @@
 
 #define SLURMD_REG_FLAG_STARTUP  0x0001
 #define SLURMD_REG_FLAG_RESP     0x0002
+#define SLURMD_REG_FLAG_SLIM     0x0004	/* Static node configuration omitted,
+					 * it is unchanged since the last full
+					 * registration the controller took */
 
 /* These defines have to be here to avoid circular dependancy with
  * switch.h
@@ -277,6 +280,8 @@ typedef enum {
 	RESPONSE_CONTROL_STATUS,
 	REQUEST_BURST_BUFFER_STATUS,
 	RESPONSE_BURST_BUFFER_STATUS,
+	REQUEST_NODE_INFO_SUMMARY,
+	RESPONSE_NODE_INFO_SUMMARY,
 
 	REQUEST_UPDATE_JOB = 3001,
 	REQUEST_UPDATE_NODE,
@@ -320,6 +325,8 @@ typedef enum {
 	RESPONSE_JOB_PACK_ALLOCATION,
 	REQUEST_JOB_PACK_ALLOC_INFO,
 	REQUEST_SUBMIT_BATCH_JOB_PACK,
+	REQUEST_SUBMIT_BATCH_JOBS,
+	RESPONSE_SUBMIT_BATCH_JOBS,
 
 	REQUEST_CTLD_MULT_MSG = 4500,
 	RESPONSE_CTLD_MULT_MSG,
@@ -365,6 +372,7 @@ typedef enum {
 	RESPONSE_NETWORK_CALLERID,
 	REQUEST_STEP_COMPLETE_AGGR,
 	REQUEST_TOP_JOB,		/* 5038 */
+	REQUEST_KILL_JOBS,
 
 	REQUEST_LAUNCH_TASKS = 6001,
 	RESPONSE_LAUNCH_TASKS,
@@ -450,12 +458,20 @@ typedef struct slurm_protocol_header {
 } header_t;
 
 typedef struct forward_struct {
+	bool abandoned;		/* forward_wait() returned with partial
+				 * results; the last forward thread frees
+				 * this structure and late responses are
+				 * discarded */
 	char *buf;
 	int buf_len;
 	uint16_t fwd_cnt;
+	char *nodelist;		/* ranged string of nodes the message was
+				 * forwarded to, so nodes which never
+				 * respond can be marked as failed */
 	pthread_mutex_t forward_mutex;
 	pthread_cond_t notify;
 	List ret_list;
+	int thr_cnt;		/* forward threads still running */
 	int timeout;
 } forward_struct_t;
 
@@ -1178,6 +1194,11 @@ typedef struct file_bcast_msg {
 	uint32_t uncomp_len;	/* uncompressed length of this data block */
 	char *block;		/* data for this block */
 	uint64_t file_size;	/* file size */
+	uint64_t file_digest;	/* FNV-1a digest of the entire source file,
+				 * lets slurmd skip the transfer when the
+				 * destination file was left by a prior
+				 * broadcast of identical content,
+				 * zero if not computed */
 } file_bcast_msg_t;
 
 typedef struct multi_core_data {
@@ -1419,6 +1440,7 @@ extern void slurm_free_node_reg_resp_msg(
 
 extern void slurm_free_job_info(job_info_t * job);
 extern void slurm_free_job_info_members(job_info_t * job);
+extern void slurm_free_job_info_members_shallow(job_info_t * job);
 
 extern void slurm_free_batch_script_msg(char *msg);
 extern void slurm_free_job_id_msg(job_id_msg_t * msg);
@@ -1464,6 +1486,7 @@ extern void slurm_free_reattach_tasks_response_msg(
 extern void slurm_free_kill_job_msg(kill_job_msg_t * msg);
 extern void slurm_free_update_job_time_msg(job_time_msg_t * msg);
 extern void slurm_free_job_step_kill_msg(job_step_kill_msg_t * msg);
+extern void slurm_free_kill_jobs_msg(kill_jobs_msg_t *msg);
 extern void slurm_free_epilog_complete_msg(epilog_complete_msg_t * msg);
 extern void slurm_free_srun_job_complete_msg(srun_job_complete_msg_t * msg);
 extern void slurm_free_srun_exec_msg(srun_exec_msg_t *msg);
@@ -1499,6 +1522,7 @@ extern void slurm_free_front_end_info_members(front_end_info_t * front_end);
 extern void slurm_free_node_info_msg(node_info_msg_t * msg);
 extern void slurm_init_node_info_t(node_info_t * msg, bool clear);
 extern void slurm_free_node_info_members(node_info_t * node);
+extern void slurm_free_node_info_members_shallow(node_info_t * node);
 extern void slurm_free_partition_info_msg(partition_info_msg_t * msg);
 extern void slurm_free_partition_info_members(partition_info_t * part);
 extern void slurm_free_layout_info_msg(layout_info_msg_t * msg);
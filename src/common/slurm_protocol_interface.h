@@ -48,6 +48,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "src/common/macros.h"
@@ -95,6 +96,21 @@ extern ssize_t slurm_msg_sendto_timeout(int open_fd,
 					size_t size,
 					int timeout);
 
+/* slurm_msg_sendv
+ * Send a message given as an array of buffer segments, contiguous on
+ * the wire, without copying them into a staging buffer first.
+ * Default timeout value.
+ * IN open_fd - an open file descriptor
+ * IN iov - segments to transmit, consumed by the send
+ * IN iovcnt - number of segments
+ * RET number of message bytes written
+ */
+extern ssize_t slurm_msg_sendv(int open_fd, struct iovec *iov, int iovcnt);
+/* slurm_msg_sendv_timeout is identical to slurm_msg_sendv except
+ * IN timeout - maximum time to wait for a message in milliseconds */
+extern ssize_t slurm_msg_sendv_timeout(int open_fd, struct iovec *iov,
+				       int iovcnt, int timeout);
+
 /********************/
 /* stream functions */
 /********************/
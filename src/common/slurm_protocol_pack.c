@@ -78,6 +78,7 @@
 #define _pack_reserve_info_msg(msg,buf)		_pack_buffer_msg(msg,buf)
 #define _pack_layout_info_msg(msg,buf)		_pack_buffer_msg(msg,buf)
 #define _pack_assoc_mgr_info_msg(msg,buf)      _pack_buffer_msg(msg,buf)
+#define _pack_priority_factors_resp_msg(msg,buf) _pack_buffer_msg(msg,buf)
 
 static void _pack_assoc_shares_object(void *in, uint32_t tres_cnt, Buf buffer,
 				      uint16_t protocol_version);
@@ -102,9 +103,6 @@ static void _pack_priority_factors_request_msg(
 static int _unpack_priority_factors_request_msg(
 	priority_factors_request_msg_t ** msg, Buf buffer,
 	uint16_t protocol_version);
-static void _pack_priority_factors_response_msg(
-	priority_factors_response_msg_t * msg, Buf buffer,
-	uint16_t protocol_version);
 static int _unpack_priority_factors_response_msg(
 	priority_factors_response_msg_t ** msg, Buf buffer,
 	uint16_t protocol_version);
@@ -154,6 +152,11 @@ static int _unpack_submit_response_msg(submit_response_msg_t ** msg,
 				       Buf buffer,
 				       uint16_t protocol_version);
 
+static void _pack_submit_response_list_msg(List resp_list, Buf buffer,
+					   uint16_t protocol_version);
+static int _unpack_submit_response_list_msg(List *resp_list, Buf buffer,
+					    uint16_t protocol_version);
+
 static void _pack_node_info_request_msg(
 	node_info_request_msg_t * msg, Buf buffer,
 	uint16_t protocol_version);
@@ -162,6 +165,12 @@ static int _unpack_node_info_request_msg(
 	node_info_request_msg_t ** msg, Buf bufer,
 	uint16_t protocol_version);
 
+static void _pack_node_summary_msg(node_summary_info_msg_t * msg,
+				   Buf buffer, uint16_t protocol_version);
+
+static int _unpack_node_summary_msg(node_summary_info_msg_t ** msg,
+				    Buf buffer, uint16_t protocol_version);
+
 static void _pack_node_info_single_msg(node_info_single_msg_t * msg,
 				       Buf buffer, uint16_t protocol_version);
 
@@ -491,6 +500,11 @@ static int  _unpack_job_id_response_msg(job_id_response_msg_t ** msg,
 
 static void _pack_job_step_kill_msg(job_step_kill_msg_t * msg, Buf buffer,
 				    uint16_t protocol_version);
+static void _pack_kill_jobs_msg(kill_jobs_msg_t *msg, Buf buffer,
+				uint16_t protocol_version);
+static int  _unpack_kill_jobs_msg(kill_jobs_msg_t **msg_ptr, Buf buffer,
+				  uint16_t protocol_version);
+
 static int  _unpack_job_step_kill_msg(job_step_kill_msg_t ** msg_ptr,
 				      Buf buffer,
 				      uint16_t protocol_version);
@@ -910,10 +924,16 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 
 	switch (msg->msg_type) {
 	case REQUEST_NODE_INFO:
+	case REQUEST_NODE_INFO_SUMMARY:
 		_pack_node_info_request_msg((node_info_request_msg_t *)
 					    msg->data, buffer,
 					    msg->protocol_version);
 		break;
+	case RESPONSE_NODE_INFO_SUMMARY:
+		_pack_node_summary_msg((node_summary_info_msg_t *)
+				       msg->data, buffer,
+				       msg->protocol_version);
+		break;
 	case REQUEST_NODE_INFO_SINGLE:
 		_pack_node_info_single_msg((node_info_single_msg_t *)
 					   msg->data, buffer,
@@ -979,9 +999,14 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 		break;
 	case REQUEST_JOB_PACK_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_JOB_PACK:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 		_pack_job_desc_list_msg((List) msg->data, buffer,
 					msg->protocol_version);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		_pack_submit_response_list_msg((List) msg->data, buffer,
+					       msg->protocol_version);
+		break;
 	case RESPONSE_JOB_PACK_ALLOCATION:
 		_pack_job_info_list_msg((List) msg->data, buffer,
 					msg->protocol_version);
@@ -1172,6 +1197,10 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 					msg->data, buffer,
 					msg->protocol_version);
 		break;
+	case REQUEST_KILL_JOBS:
+		_pack_kill_jobs_msg((kill_jobs_msg_t *) msg->data, buffer,
+				    msg->protocol_version);
+		break;
 	case REQUEST_COMPLETE_JOB_ALLOCATION:
 		_pack_complete_job_allocation_msg(
 			(complete_job_allocation_msg_t *)msg->data, buffer,
@@ -1404,10 +1433,7 @@ pack_msg(slurm_msg_t const *msg, Buf buffer)
 			msg->protocol_version);
 		break;
 	case RESPONSE_PRIORITY_FACTORS:
-		_pack_priority_factors_response_msg(
-			(priority_factors_response_msg_t*)msg->data,
-			buffer,
-			msg->protocol_version);
+		_pack_priority_factors_resp_msg((slurm_msg_t *) msg, buffer);
 		break;
 	case RESPONSE_BURST_BUFFER_INFO:
 		_pack_burst_buffer_info_resp_msg((slurm_msg_t *) msg, buffer);
@@ -1604,10 +1630,16 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 
 	switch (msg->msg_type) {
 	case REQUEST_NODE_INFO:
+	case REQUEST_NODE_INFO_SUMMARY:
 		rc = _unpack_node_info_request_msg((node_info_request_msg_t **)
 						   & (msg->data), buffer,
 						   msg->protocol_version);
 		break;
+	case RESPONSE_NODE_INFO_SUMMARY:
+		rc = _unpack_node_summary_msg((node_summary_info_msg_t **)
+					      & (msg->data), buffer,
+					      msg->protocol_version);
+		break;
 	case REQUEST_NODE_INFO_SINGLE:
 		rc = _unpack_node_info_single_msg((node_info_single_msg_t **)
 						  & (msg->data), buffer,
@@ -1681,9 +1713,15 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 		break;
 	case REQUEST_JOB_PACK_ALLOCATION:
 	case REQUEST_SUBMIT_BATCH_JOB_PACK:
+	case REQUEST_SUBMIT_BATCH_JOBS:
 		rc = _unpack_job_desc_list_msg((List *) &(msg->data),
 					       buffer, msg->protocol_version);
 		break;
+	case RESPONSE_SUBMIT_BATCH_JOBS:
+		rc = _unpack_submit_response_list_msg((List *) &(msg->data),
+						      buffer,
+						      msg->protocol_version);
+		break;
 	case RESPONSE_JOB_PACK_ALLOCATION:
 		rc = _unpack_job_info_list_msg((List *) &(msg->data),
 					       buffer, msg->protocol_version);
@@ -1888,6 +1926,11 @@ unpack_msg(slurm_msg_t * msg, Buf buffer)
 					       & (msg->data), buffer,
 					       msg->protocol_version);
 		break;
+	case REQUEST_KILL_JOBS:
+		rc = _unpack_kill_jobs_msg((kill_jobs_msg_t **)
+					   &(msg->data), buffer,
+					   msg->protocol_version);
+		break;
 	case REQUEST_COMPLETE_JOB_ALLOCATION:
 		rc = _unpack_complete_job_allocation_msg(
 			(complete_job_allocation_msg_t **)&msg->data, buffer,
@@ -2988,10 +3031,14 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
-static void
-_pack_priority_factors_response_msg(priority_factors_response_msg_t * msg,
-				    Buf buffer,
-				    uint16_t protocol_version)
+/*
+ * The sender (slurmctld) packs the response body itself so that it can
+ * cache the packed image, then ships it through _pack_buffer_msg().
+ */
+extern void
+pack_priority_factors_response_msg(priority_factors_response_msg_t * msg,
+				   Buf buffer,
+				   uint16_t protocol_version)
 {
 	ListIterator itr = NULL;
 	priority_factors_object_t *factors = NULL;
@@ -3713,6 +3760,69 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void
+_pack_submit_response_list_msg(List resp_list, Buf buffer,
+			       uint16_t protocol_version)
+{
+	submit_response_msg_t *resp;
+	ListIterator iter;
+	uint16_t cnt = 0;
+
+	if (resp_list)
+		cnt = list_count(resp_list);
+	pack16(cnt, buffer);
+	if (cnt == 0)
+		return;
+
+	iter = list_iterator_create(resp_list);
+	while ((resp = (submit_response_msg_t *) list_next(iter))) {
+		_pack_submit_response_msg(resp, buffer, protocol_version);
+	}
+	list_iterator_destroy(iter);
+}
+
+static void _free_submit_response_list(void *x)
+{
+	submit_response_msg_t *resp = (submit_response_msg_t *) x;
+	slurm_free_submit_response_response_msg(resp);
+}
+
+static int
+_unpack_submit_response_list_msg(List *resp_list, Buf buffer,
+				 uint16_t protocol_version)
+{
+	submit_response_msg_t *resp;
+	uint16_t cnt = 0;
+	int i;
+
+	*resp_list = NULL;
+
+	safe_unpack16(&cnt, buffer);
+	if (cnt == 0)
+		return SLURM_SUCCESS;
+
+	*resp_list = list_create(_free_submit_response_list);
+	for (i = 0; i < cnt; i++) {
+		resp = NULL;
+		if (_unpack_submit_response_msg(&resp, buffer,
+						protocol_version) !=
+		    SLURM_SUCCESS)
+			goto unpack_error;
+		list_append(*resp_list, resp);
+	}
+	return SLURM_SUCCESS;
+
+unpack_error:
+	FREE_NULL_LIST(*resp_list);
+	return SLURM_ERROR;
+}
+
+/* List destructor for the buffer references held in backing_buf */
+static void _backing_buf_del(void *x)
+{
+	free_buf((Buf) x);
+}
+
 static int _unpack_node_info_msg(node_info_msg_t **msg, Buf buffer,
 				 uint16_t protocol_version)
 {
@@ -3723,6 +3833,14 @@ static int _unpack_node_info_msg(node_info_msg_t **msg, Buf buffer,
 	tmp_ptr = xmalloc(sizeof(node_info_msg_t));
 	*msg = tmp_ptr;
 
+	/*
+	 * Most string fields in the node records are unpacked zero-copy
+	 * and point into this buffer, so hold a reference to it for the
+	 * life of the message (released by slurm_free_node_info_msg()).
+	 */
+	tmp_ptr->backing_buf = list_create(_backing_buf_del);
+	list_append(tmp_ptr->backing_buf, buf_ref(buffer));
+
 	/* load buffer's header (data structure version and time) */
 	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&tmp_ptr->record_count, buffer);
@@ -3762,13 +3880,13 @@ _unpack_node_info_members(node_info_t * node, Buf buffer,
 
 	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpackstr_xmalloc(&node->name, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&node->node_hostname, &uint32_tmp,
+		safe_unpackstr_ptr(&node->node_hostname, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&node->node_addr, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->node_addr, &uint32_tmp, buffer);
 		safe_unpack16(&node->port, buffer);
 		safe_unpack32(&node->next_state, buffer);
 		safe_unpack32(&node->node_state, buffer);
-		safe_unpackstr_xmalloc(&node->version, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->version, &uint32_tmp, buffer);
 
 		safe_unpack16(&node->cpus, buffer);
 		safe_unpack16(&node->boards, buffer);
@@ -3779,12 +3897,12 @@ _unpack_node_info_members(node_info_t * node, Buf buffer,
 		safe_unpack64(&node->real_memory, buffer);
 		safe_unpack32(&node->tmp_disk, buffer);
 
-		safe_unpackstr_xmalloc(&node->mcs_label, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->mcs_label, &uint32_tmp, buffer);
 		safe_unpack32(&node->owner, buffer);
 		safe_unpack16(&node->core_spec_cnt, buffer);
 		safe_unpack32(&node->cpu_bind, buffer);
 		safe_unpack64(&node->mem_spec_limit, buffer);
-		safe_unpackstr_xmalloc(&node->cpu_spec_list, &uint32_tmp,
+		safe_unpackstr_ptr(&node->cpu_spec_list, &uint32_tmp,
 				       buffer);
 
 		safe_unpack32(&node->cpu_load, buffer);
@@ -3801,16 +3919,16 @@ _unpack_node_info_members(node_info_t * node, Buf buffer,
 		    != SLURM_SUCCESS)
 			goto unpack_error;
 
-		safe_unpackstr_xmalloc(&node->arch, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&node->features, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&node->features_act, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->arch, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->features, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->features_act, &uint32_tmp, buffer);
 		if (!node->features_act)
-			node->features_act = xstrdup(node->features);
-		safe_unpackstr_xmalloc(&node->gres, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&node->gres_drain, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&node->gres_used, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&node->os, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&node->reason, &uint32_tmp, buffer);
+			node->features_act = node->features;
+		safe_unpackstr_ptr(&node->gres, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->gres_drain, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->gres_used, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->os, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&node->reason, &uint32_tmp, buffer);
 		if (acct_gather_energy_unpack(&node->energy, buffer,
 					      protocol_version, 1)
 		    != SLURM_SUCCESS)
@@ -3823,7 +3941,7 @@ _unpack_node_info_members(node_info_t * node, Buf buffer,
 					   protocol_version) != SLURM_SUCCESS)
 			goto unpack_error;
 
-		safe_unpackstr_xmalloc(&node->tres_fmt_str, &uint32_tmp,
+		safe_unpackstr_ptr(&node->tres_fmt_str, &uint32_tmp,
 				       buffer);
 	} else {
 		error("_unpack_node_info_members: protocol_version "
@@ -3833,7 +3951,7 @@ _unpack_node_info_members(node_info_t * node, Buf buffer,
 	return SLURM_SUCCESS;
 
 unpack_error:
-	slurm_free_node_info_members(node);
+	slurm_free_node_info_members_shallow(node);
 	return SLURM_ERROR;
 }
 
@@ -5156,8 +5274,76 @@ _unpack_job_info_msg(job_info_msg_t ** msg, Buf buffer,
 	xassert(msg);
 	*msg = xmalloc(sizeof(job_info_msg_t));
 
+	/*
+	 * Most string fields in the job records are unpacked zero-copy
+	 * and point into this buffer, so hold a reference to it for the
+	 * life of the message (released by slurm_free_job_info_msg()).
+	 */
+	(*msg)->backing_buf = list_create(_backing_buf_del);
+	list_append((*msg)->backing_buf, buf_ref(buffer));
+
 	/* load buffer's header (data structure version and time) */
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		char *prev_data = NULL, *rec_data, *lit_data;
+		uint32_t prev_len = 0, rec_len, copy_len, lit_len, off;
+		Buf rec_buf;
+
+		safe_unpack32(&((*msg)->record_count), buffer);
+		safe_unpack_time(&((*msg)->last_update), buffer);
+
+		if ((*msg)->record_count) {
+			safe_xcalloc((*msg)->job_array, (*msg)->record_count,
+				     sizeof(job_info_t));
+			job = (*msg)->job_array;
+		}
+		/*
+		 * Each record is framed as its full length followed by
+		 * (copy length, literal bytes) pairs; copied bytes come
+		 * from the previous record at the same offset. Rebuild
+		 * each record into its own buffer before unpacking it.
+		 * The rebuilt buffers are kept on backing_buf since the
+		 * job strings are unpacked zero-copy out of them.
+		 */
+		for (i = 0; i < (*msg)->record_count; i++) {
+			safe_unpack32(&rec_len, buffer);
+			if ((rec_len == 0) || (rec_len > MAX_BUF_SIZE))
+				goto unpack_error;
+			rec_data = xmalloc(rec_len);
+			rec_buf = create_buf(rec_data, rec_len);
+			list_append((*msg)->backing_buf, rec_buf);
+			off = 0;
+			while (off < rec_len) {
+				safe_unpack32(&copy_len, buffer);
+				if (copy_len > (rec_len - off))
+					goto unpack_error;
+				if (copy_len &&
+				    ((off + copy_len) > prev_len))
+					goto unpack_error;
+				if (copy_len) {
+					memcpy(rec_data + off,
+					       prev_data + off, copy_len);
+					off += copy_len;
+				}
+				safe_unpackmem_ptr(&lit_data, &lit_len,
+						   buffer);
+				if (lit_len > (rec_len - off))
+					goto unpack_error;
+				if (lit_len) {
+					memcpy(rec_data + off, lit_data,
+					       lit_len);
+					off += lit_len;
+				}
+				if (!copy_len && !lit_len)
+					goto unpack_error;
+			}
+			set_buf_offset(rec_buf, 0);
+			if (_unpack_job_info_members(&job[i], rec_buf,
+						     protocol_version))
+				goto unpack_error;
+			prev_data = rec_data;
+			prev_len = rec_len;
+		}
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&((*msg)->record_count), buffer);
 		safe_unpack_time(&((*msg)->last_update), buffer);
 
@@ -5298,7 +5484,7 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 		safe_unpack32(&job->user_id,  buffer);
 		safe_unpack32(&job->group_id, buffer);
 		safe_unpack32(&job->pack_job_id, buffer);
-		safe_unpackstr_xmalloc(&job->pack_job_id_set, &uint32_tmp,
+		safe_unpackstr_ptr(&job->pack_job_id_set, &uint32_tmp,
 				       buffer);
 		safe_unpack32(&job->pack_job_offset, buffer);
 		safe_unpack32(&job->profile,  buffer);
@@ -5330,29 +5516,29 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 		safe_unpack_time(&job->preempt_time, buffer);
 		safe_unpack32(&job->priority, buffer);
 		safe_unpackdouble(&job->billable_tres, buffer);
-		safe_unpackstr_xmalloc(&job->cluster, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->cluster, &uint32_tmp, buffer);
 		safe_unpackstr_xmalloc(&job->nodes, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->sched_nodes, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->sched_nodes, &uint32_tmp, buffer);
 		safe_unpackstr_xmalloc(&job->partition, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->account, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->admin_comment, &uint32_tmp,buffer);
+		safe_unpackstr_ptr(&job->account, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->admin_comment, &uint32_tmp,buffer);
 		safe_unpack32(&job->site_factor, buffer);
-		safe_unpackstr_xmalloc(&job->network, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->comment, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->batch_features, &uint32_tmp,
+		safe_unpackstr_ptr(&job->network, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->comment, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->batch_features, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->batch_host, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->burst_buffer, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->burst_buffer_state, &uint32_tmp,
+		safe_unpackstr_ptr(&job->batch_host, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->burst_buffer, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->burst_buffer_state, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->system_comment,
+		safe_unpackstr_ptr(&job->system_comment,
 				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->qos, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->qos, &uint32_tmp, buffer);
 		safe_unpack_time(&job->preemptable_time, buffer);
-		safe_unpackstr_xmalloc(&job->licenses, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->licenses, &uint32_tmp, buffer);
 		safe_unpackstr_xmalloc(&job->state_desc, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->resv_name,  &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->mcs_label,  &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->resv_name,  &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->mcs_label,  &uint32_tmp, buffer);
 
 		safe_unpack32(&job->exit_code, buffer);
 		safe_unpack32(&job->derived_ec, buffer);
@@ -5361,13 +5547,13 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 		safe_unpackstr_array(&job->gres_detail_str,
 				     &job->gres_detail_cnt, buffer);
 
-		safe_unpackstr_xmalloc(&job->name, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->user_name, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->wckey, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->name, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->user_name, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->wckey, &uint32_tmp, buffer);
 		safe_unpack32(&job->req_switch, buffer);
 		safe_unpack32(&job->wait4switch, buffer);
 
-		safe_unpackstr_xmalloc(&job->alloc_node, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->alloc_node, &uint32_tmp, buffer);
 
 		unpack_bit_str_hex_as_inx(&job->node_inx, buffer);
 
@@ -5376,12 +5562,12 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 			goto unpack_error;
 
 		/*** unpack default job details ***/
-		safe_unpackstr_xmalloc(&job->features,   &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->cluster_features, &uint32_tmp,
+		safe_unpackstr_ptr(&job->features,   &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->cluster_features, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->work_dir,   &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->dependency, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->command,    &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->work_dir,   &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->dependency, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->command,    &uint32_tmp, buffer);
 
 		safe_unpack32(&job->num_cpus, buffer);
 		safe_unpack32(&job->max_cpus, buffer);
@@ -5404,17 +5590,17 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 
 		safe_unpack64(&job->pn_min_memory, buffer);
 		safe_unpack32(&job->pn_min_tmp_disk, buffer);
-		safe_unpackstr_xmalloc(&job->req_nodes, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->req_nodes, &uint32_tmp, buffer);
 
 		unpack_bit_str_hex_as_inx(&job->req_node_inx, buffer);
 
-		safe_unpackstr_xmalloc(&job->exc_nodes, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->exc_nodes, &uint32_tmp, buffer);
 
 		unpack_bit_str_hex_as_inx(&job->exc_node_inx, buffer);
 
-		safe_unpackstr_xmalloc(&job->std_err, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->std_in,  &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->std_out, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->std_err, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->std_in,  &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->std_out, &uint32_tmp, buffer);
 
 		if (unpack_multi_core_data(&mc_ptr, buffer, protocol_version))
 			goto unpack_error;
@@ -5430,36 +5616,36 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 			xfree(mc_ptr);
 		}
 		safe_unpack32(&job->bitflags, buffer);
-		safe_unpackstr_xmalloc(&job->tres_alloc_str,
+		safe_unpackstr_ptr(&job->tres_alloc_str,
 				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->tres_req_str,
+		safe_unpackstr_ptr(&job->tres_req_str,
 				       &uint32_tmp, buffer);
 		safe_unpack16(&job->start_protocol_ver, buffer);
 
-		safe_unpackstr_xmalloc(&job->fed_origin_str, &uint32_tmp,
+		safe_unpackstr_ptr(&job->fed_origin_str, &uint32_tmp,
 				       buffer);
 		safe_unpack64(&job->fed_siblings_active, buffer);
-		safe_unpackstr_xmalloc(&job->fed_siblings_active_str,
+		safe_unpackstr_ptr(&job->fed_siblings_active_str,
 				       &uint32_tmp, buffer);
 		safe_unpack64(&job->fed_siblings_viable, buffer);
-		safe_unpackstr_xmalloc(&job->fed_siblings_viable_str,
+		safe_unpackstr_ptr(&job->fed_siblings_viable_str,
 				       &uint32_tmp, buffer);
 
-		safe_unpackstr_xmalloc(&job->cpus_per_tres, &uint32_tmp,
+		safe_unpackstr_ptr(&job->cpus_per_tres, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->mem_per_tres, &uint32_tmp,
+		safe_unpackstr_ptr(&job->mem_per_tres, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_bind, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_bind, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_freq, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_freq, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_job, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_job, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_node, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_node, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_socket, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_socket, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_task, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_task, &uint32_tmp,
 				       buffer);
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&job->array_job_id, buffer);
@@ -5478,7 +5664,7 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 		safe_unpack32(&job->user_id,  buffer);
 		safe_unpack32(&job->group_id, buffer);
 		safe_unpack32(&job->pack_job_id, buffer);
-		safe_unpackstr_xmalloc(&job->pack_job_id_set, &uint32_tmp,
+		safe_unpackstr_ptr(&job->pack_job_id_set, &uint32_tmp,
 				       buffer);
 		safe_unpack32(&job->pack_job_offset, buffer);
 		safe_unpack32(&job->profile,  buffer);
@@ -5510,27 +5696,27 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 		safe_unpack_time(&job->preempt_time, buffer);
 		safe_unpack32(&job->priority, buffer);
 		safe_unpackdouble(&job->billable_tres, buffer);
-		safe_unpackstr_xmalloc(&job->cluster, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->cluster, &uint32_tmp, buffer);
 		safe_unpackstr_xmalloc(&job->nodes, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->sched_nodes, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->sched_nodes, &uint32_tmp, buffer);
 		safe_unpackstr_xmalloc(&job->partition, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->account, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->admin_comment, &uint32_tmp,buffer);
-		safe_unpackstr_xmalloc(&job->network, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->comment, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->batch_features, &uint32_tmp,
+		safe_unpackstr_ptr(&job->account, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->admin_comment, &uint32_tmp,buffer);
+		safe_unpackstr_ptr(&job->network, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->comment, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->batch_features, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->batch_host, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->burst_buffer, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->burst_buffer_state, &uint32_tmp,
+		safe_unpackstr_ptr(&job->batch_host, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->burst_buffer, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->burst_buffer_state, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->system_comment,
+		safe_unpackstr_ptr(&job->system_comment,
 				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->qos, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->licenses, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->qos, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->licenses, &uint32_tmp, buffer);
 		safe_unpackstr_xmalloc(&job->state_desc, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->resv_name,  &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->mcs_label,  &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->resv_name,  &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->mcs_label,  &uint32_tmp, buffer);
 
 		safe_unpack32(&job->exit_code, buffer);
 		safe_unpack32(&job->derived_ec, buffer);
@@ -5539,13 +5725,13 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 		safe_unpackstr_array(&job->gres_detail_str,
 				     &job->gres_detail_cnt, buffer);
 
-		safe_unpackstr_xmalloc(&job->name, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->user_name, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->wckey, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->name, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->user_name, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->wckey, &uint32_tmp, buffer);
 		safe_unpack32(&job->req_switch, buffer);
 		safe_unpack32(&job->wait4switch, buffer);
 
-		safe_unpackstr_xmalloc(&job->alloc_node, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->alloc_node, &uint32_tmp, buffer);
 
 		unpack_bit_str_hex_as_inx(&job->node_inx, buffer);
 
@@ -5554,12 +5740,12 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 			goto unpack_error;
 
 		/*** unpack default job details ***/
-		safe_unpackstr_xmalloc(&job->features,   &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->cluster_features, &uint32_tmp,
+		safe_unpackstr_ptr(&job->features,   &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->cluster_features, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->work_dir,   &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->dependency, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->command,    &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->work_dir,   &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->dependency, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->command,    &uint32_tmp, buffer);
 
 		safe_unpack32(&job->num_cpus, buffer);
 		safe_unpack32(&job->max_cpus, buffer);
@@ -5582,17 +5768,17 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 
 		safe_unpack64(&job->pn_min_memory, buffer);
 		safe_unpack32(&job->pn_min_tmp_disk, buffer);
-		safe_unpackstr_xmalloc(&job->req_nodes, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->req_nodes, &uint32_tmp, buffer);
 
 		unpack_bit_str_hex_as_inx(&job->req_node_inx, buffer);
 
-		safe_unpackstr_xmalloc(&job->exc_nodes, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->exc_nodes, &uint32_tmp, buffer);
 
 		unpack_bit_str_hex_as_inx(&job->exc_node_inx, buffer);
 
-		safe_unpackstr_xmalloc(&job->std_err, &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->std_in,  &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->std_out, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->std_err, &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->std_in,  &uint32_tmp, buffer);
+		safe_unpackstr_ptr(&job->std_out, &uint32_tmp, buffer);
 
 		if (unpack_multi_core_data(&mc_ptr, buffer, protocol_version))
 			goto unpack_error;
@@ -5608,36 +5794,36 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 			xfree(mc_ptr);
 		}
 		safe_unpack32(&job->bitflags, buffer);
-		safe_unpackstr_xmalloc(&job->tres_alloc_str,
+		safe_unpackstr_ptr(&job->tres_alloc_str,
 				       &uint32_tmp, buffer);
-		safe_unpackstr_xmalloc(&job->tres_req_str,
+		safe_unpackstr_ptr(&job->tres_req_str,
 				       &uint32_tmp, buffer);
 		safe_unpack16(&job->start_protocol_ver, buffer);
 
-		safe_unpackstr_xmalloc(&job->fed_origin_str, &uint32_tmp,
+		safe_unpackstr_ptr(&job->fed_origin_str, &uint32_tmp,
 				       buffer);
 		safe_unpack64(&job->fed_siblings_active, buffer);
-		safe_unpackstr_xmalloc(&job->fed_siblings_active_str,
+		safe_unpackstr_ptr(&job->fed_siblings_active_str,
 				       &uint32_tmp, buffer);
 		safe_unpack64(&job->fed_siblings_viable, buffer);
-		safe_unpackstr_xmalloc(&job->fed_siblings_viable_str,
+		safe_unpackstr_ptr(&job->fed_siblings_viable_str,
 				       &uint32_tmp, buffer);
 
-		safe_unpackstr_xmalloc(&job->cpus_per_tres, &uint32_tmp,
+		safe_unpackstr_ptr(&job->cpus_per_tres, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->mem_per_tres, &uint32_tmp,
+		safe_unpackstr_ptr(&job->mem_per_tres, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_bind, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_bind, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_freq, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_freq, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_job, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_job, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_node, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_node, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_socket, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_socket, &uint32_tmp,
 				       buffer);
-		safe_unpackstr_xmalloc(&job->tres_per_task, &uint32_tmp,
+		safe_unpackstr_ptr(&job->tres_per_task, &uint32_tmp,
 				       buffer);
 	} else {
 		error("_unpack_job_info_members: protocol_version "
@@ -5648,7 +5834,7 @@ _unpack_job_info_members(job_info_t * job, Buf buffer,
 	return SLURM_SUCCESS;
 
 unpack_error:
-	slurm_free_job_info_members(job);
+	slurm_free_job_info_members_shallow(job);
 	return SLURM_ERROR;
 }
 
@@ -5684,20 +5870,19 @@ _pack_slurm_ctl_conf_msg(slurm_ctl_conf_info_msg_t * build_ptr, Buf buffer,
 		packstr(build_ptr->accounting_storage_user, buffer);
 		pack16(build_ptr->acctng_store_job_comment, buffer);
 
-		if (build_ptr->acct_gather_conf)
+		if (build_ptr->acct_gather_conf) {
 			count = list_count(build_ptr->acct_gather_conf);
-		else
+			if (list_find_first(build_ptr->acct_gather_conf,
+					    _list_find_conf_entry,
+					    "ProfileInfluxDBPass"))
+				count--;
+			if (list_find_first(build_ptr->acct_gather_conf,
+					    _list_find_conf_entry,
+					    "ProfileInfluxDBUser"))
+				count--;
+		} else
 			count = NO_VAL;
 
-		if (list_find_first(build_ptr->acct_gather_conf,
-				    _list_find_conf_entry,
-				    "ProfileInfluxDBPass"))
-			count--;
-		if (list_find_first(build_ptr->acct_gather_conf,
-				    _list_find_conf_entry,
-				    "ProfileInfluxDBUser"))
-			count--;
-
 		pack32(count, buffer);
 		if (count && (count != NO_VAL)) {
 			ListIterator itr = list_iterator_create(
@@ -5935,8 +6120,13 @@ _pack_slurm_ctl_conf_msg(slurm_ctl_conf_info_msg_t * build_ptr, Buf buffer,
 		pack16(build_ptr->slurmd_syslog_debug, buffer);
 		pack16(build_ptr->slurmd_timeout, buffer);
 		packstr(build_ptr->srun_epilog, buffer);
-		pack16(build_ptr->srun_port_range[0], buffer);
-		pack16(build_ptr->srun_port_range[1], buffer);
+		if (build_ptr->srun_port_range) {
+			pack16(build_ptr->srun_port_range[0], buffer);
+			pack16(build_ptr->srun_port_range[1], buffer);
+		} else {
+			pack16((uint16_t) 0, buffer);
+			pack16((uint16_t) 0, buffer);
+		}
 		packstr(build_ptr->srun_prolog, buffer);
 		packstr(build_ptr->state_save_location, buffer);
 		packstr(build_ptr->suspend_exc_nodes, buffer);
@@ -5980,20 +6170,19 @@ _pack_slurm_ctl_conf_msg(slurm_ctl_conf_info_msg_t * build_ptr, Buf buffer,
 		packstr(build_ptr->accounting_storage_user, buffer);
 		pack16(build_ptr->acctng_store_job_comment, buffer);
 
-		if (build_ptr->acct_gather_conf)
+		if (build_ptr->acct_gather_conf) {
 			count = list_count(build_ptr->acct_gather_conf);
-		else
+			if (list_find_first(build_ptr->acct_gather_conf,
+					    _list_find_conf_entry,
+					    "ProfileInfluxDBPass"))
+				count--;
+			if (list_find_first(build_ptr->acct_gather_conf,
+					    _list_find_conf_entry,
+					    "ProfileInfluxDBUser"))
+				count--;
+		} else
 			count = NO_VAL;
 
-		if (list_find_first(build_ptr->acct_gather_conf,
-				    _list_find_conf_entry,
-				    "ProfileInfluxDBPass"))
-			count--;
-		if (list_find_first(build_ptr->acct_gather_conf,
-				    _list_find_conf_entry,
-				    "ProfileInfluxDBUser"))
-			count--;
-
 		pack32(count, buffer);
 		if (count && (count != NO_VAL)) {
 			ListIterator itr = list_iterator_create(
@@ -6228,8 +6417,13 @@ _pack_slurm_ctl_conf_msg(slurm_ctl_conf_info_msg_t * build_ptr, Buf buffer,
 		pack16(build_ptr->slurmd_syslog_debug, buffer);
 		pack16(build_ptr->slurmd_timeout, buffer);
 		packstr(build_ptr->srun_epilog, buffer);
-		pack16(build_ptr->srun_port_range[0], buffer);
-		pack16(build_ptr->srun_port_range[1], buffer);
+		if (build_ptr->srun_port_range) {
+			pack16(build_ptr->srun_port_range[0], buffer);
+			pack16(build_ptr->srun_port_range[1], buffer);
+		} else {
+			pack16((uint16_t) 0, buffer);
+			pack16((uint16_t) 0, buffer);
+		}
 		packstr(build_ptr->srun_prolog, buffer);
 		packstr(build_ptr->state_save_location, buffer);
 		packstr(build_ptr->suspend_exc_nodes, buffer);
@@ -9345,6 +9539,49 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void
+_pack_kill_jobs_msg(kill_jobs_msg_t *msg, Buf buffer,
+		    uint16_t protocol_version)
+{
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		pack16(msg->signal, buffer);
+		pack16(msg->flags, buffer);
+		packstr(msg->user_name, buffer);
+		packstr(msg->partition, buffer);
+		pack32(msg->job_state, buffer);
+		packstr_array(msg->jobs_array, msg->jobs_cnt, buffer);
+	}
+}
+
+static int
+_unpack_kill_jobs_msg(kill_jobs_msg_t **msg_ptr, Buf buffer,
+		      uint16_t protocol_version)
+{
+	kill_jobs_msg_t *msg;
+	uint32_t uint32_tmp;
+
+	msg = xmalloc(sizeof(kill_jobs_msg_t));
+	*msg_ptr = msg;
+
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		safe_unpack16(&msg->signal, buffer);
+		safe_unpack16(&msg->flags, buffer);
+		safe_unpackstr_xmalloc(&msg->user_name, &uint32_tmp, buffer);
+		safe_unpackstr_xmalloc(&msg->partition, &uint32_tmp, buffer);
+		safe_unpack32(&msg->job_state, buffer);
+		safe_unpackstr_array(&msg->jobs_array, &msg->jobs_cnt,
+				     buffer);
+	} else
+		goto unpack_error;
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_kill_jobs_msg(msg);
+	*msg_ptr = NULL;
+	return SLURM_ERROR;
+}
+
 static void
 _pack_update_job_step_msg(step_update_request_msg_t * msg, Buf buffer,
 			  uint16_t protocol_version)
@@ -10084,6 +10321,74 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+static void
+_pack_node_summary_msg(node_summary_info_msg_t * msg, Buf buffer,
+		       uint16_t protocol_version)
+{
+	partition_summary_t *sum;
+	uint32_t i;
+
+	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+		pack_time(msg->last_update, buffer);
+		pack32(msg->record_count, buffer);
+		for (i = 0; i < msg->record_count; i++) {
+			sum = &msg->summary_array[i];
+			packstr(sum->partition, buffer);
+			pack32(sum->nodes_alloc, buffer);
+			pack32(sum->nodes_idle, buffer);
+			pack32(sum->nodes_other, buffer);
+			pack32(sum->nodes_total, buffer);
+			pack32(sum->cpus_alloc, buffer);
+			pack32(sum->cpus_idle, buffer);
+			pack32(sum->cpus_other, buffer);
+			pack32(sum->cpus_total, buffer);
+		}
+	}
+}
+
+static int
+_unpack_node_summary_msg(node_summary_info_msg_t ** msg, Buf buffer,
+			 uint16_t protocol_version)
+{
+	node_summary_info_msg_t *summary_msg;
+	partition_summary_t *sum;
+	uint32_t uint32_tmp, i;
+
+	summary_msg = xmalloc(sizeof(node_summary_info_msg_t));
+	*msg = summary_msg;
+
+	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+		safe_unpack_time(&summary_msg->last_update, buffer);
+		safe_unpack32(&summary_msg->record_count, buffer);
+		if (summary_msg->record_count > NO_VAL)
+			goto unpack_error;
+		safe_xcalloc(summary_msg->summary_array,
+			     summary_msg->record_count,
+			     sizeof(partition_summary_t));
+		for (i = 0; i < summary_msg->record_count; i++) {
+			sum = &summary_msg->summary_array[i];
+			safe_unpackstr_xmalloc(&sum->partition, &uint32_tmp,
+					       buffer);
+			safe_unpack32(&sum->nodes_alloc, buffer);
+			safe_unpack32(&sum->nodes_idle, buffer);
+			safe_unpack32(&sum->nodes_other, buffer);
+			safe_unpack32(&sum->nodes_total, buffer);
+			safe_unpack32(&sum->cpus_alloc, buffer);
+			safe_unpack32(&sum->cpus_idle, buffer);
+			safe_unpack32(&sum->cpus_other, buffer);
+			safe_unpack32(&sum->cpus_total, buffer);
+		}
+	} else
+		goto unpack_error;
+
+	return SLURM_SUCCESS;
+
+unpack_error:
+	slurm_free_node_summary_info_msg(summary_msg);
+	*msg = NULL;
+	return SLURM_ERROR;
+}
+
 static void
 _pack_node_info_single_msg(node_info_single_msg_t * msg, Buf buffer,
 			   uint16_t protocol_version)
@@ -11307,7 +11612,29 @@ static void _pack_file_bcast(file_bcast_msg_t * msg , Buf buffer,
 
 	grow_buf(buffer,  msg->block_len);
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		pack32(msg->block_no, buffer);
+		pack16(msg->compress, buffer);
+		pack16(msg->last_block, buffer);
+		pack16(msg->force, buffer);
+		pack16(msg->modes, buffer);
+
+		pack32(msg->uid, buffer);
+		packstr(msg->user_name, buffer);
+		pack32(msg->gid, buffer);
+
+		pack_time(msg->atime, buffer);
+		pack_time(msg->mtime, buffer);
+
+		packstr(msg->fname, buffer);
+		pack32(msg->block_len, buffer);
+		pack32(msg->uncomp_len, buffer);
+		pack64(msg->block_offset, buffer);
+		pack64(msg->file_size, buffer);
+		pack64(msg->file_digest, buffer);
+		packmem (msg->block, msg->block_len, buffer);
+		pack_sbcast_cred(msg->cred, buffer, protocol_version);
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		pack32(msg->block_no, buffer);
 		pack16(msg->compress, buffer);
 		pack16(msg->last_block, buffer);
@@ -11342,7 +11669,34 @@ static int _unpack_file_bcast(file_bcast_msg_t ** msg_ptr , Buf buffer,
 	msg = xmalloc ( sizeof (file_bcast_msg_t) ) ;
 	*msg_ptr = msg;
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		safe_unpack32(&msg->block_no, buffer);
+		safe_unpack16(&msg->compress, buffer);
+		safe_unpack16(&msg->last_block, buffer);
+		safe_unpack16(&msg->force, buffer);
+		safe_unpack16(&msg->modes, buffer);
+
+		safe_unpack32(&msg->uid, buffer);
+		safe_unpackstr_xmalloc(&msg->user_name, &uint32_tmp, buffer);
+		safe_unpack32 (&msg->gid, buffer);
+
+		safe_unpack_time(&msg->atime, buffer);
+		safe_unpack_time(&msg->mtime, buffer);
+
+		safe_unpackstr_xmalloc ( & msg->fname, &uint32_tmp, buffer );
+		safe_unpack32(&msg->block_len, buffer);
+		safe_unpack32(&msg->uncomp_len, buffer);
+		safe_unpack64(&msg->block_offset, buffer);
+		safe_unpack64(&msg->file_size, buffer);
+		safe_unpack64(&msg->file_digest, buffer);
+		safe_unpackmem_xmalloc ( & msg->block, &uint32_tmp , buffer ) ;
+		if ( uint32_tmp != msg->block_len )
+			goto unpack_error;
+
+		msg->cred = unpack_sbcast_cred(buffer, protocol_version);
+		if (msg->cred == NULL)
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack32(&msg->block_no, buffer);
 		safe_unpack16(&msg->compress, buffer);
 		safe_unpack16(&msg->last_block, buffer);
@@ -12152,7 +12506,7 @@ unpack_error:
 static int  _unpack_stats_response_msg(stats_info_response_msg_t **msg_ptr,
 				       Buf buffer, uint16_t protocol_version)
 {
-	uint32_t uint32_tmp = 0;
+	uint32_t i, uint32_tmp = 0;
 	stats_info_response_msg_t * msg;
 	xassert(msg_ptr);
 
@@ -12205,12 +12559,154 @@ static int  _unpack_stats_response_msg(stats_info_response_msg_t **msg_ptr,
 
 			safe_unpack32(&msg->bf_active,		buffer);
 			safe_unpack32(&msg->bf_backfilled_pack_jobs, buffer);
+
+			safe_unpack32(&msg->bf_cycle_rec_cnt,	buffer);
+			if (msg->bf_cycle_rec_cnt > NO_VAL16)
+				goto unpack_error;
+			if (msg->bf_cycle_rec_cnt) {
+				uint32_t cnt = msg->bf_cycle_rec_cnt;
+				msg->bf_cycle_rec_when =
+					xcalloc(cnt, sizeof(time_t));
+				msg->bf_cycle_rec_usec =
+					xcalloc(cnt, sizeof(uint32_t));
+				msg->bf_cycle_rec_try_usec =
+					xcalloc(cnt, sizeof(uint32_t));
+				msg->bf_cycle_rec_depth =
+					xcalloc(cnt, sizeof(uint32_t));
+				msg->bf_cycle_rec_depth_try =
+					xcalloc(cnt, sizeof(uint32_t));
+				msg->bf_cycle_rec_yields =
+					xcalloc(cnt, sizeof(uint32_t));
+				msg->bf_cycle_rec_table_size =
+					xcalloc(cnt, sizeof(uint32_t));
+				msg->bf_cycle_rec_queue_len =
+					xcalloc(cnt, sizeof(uint32_t));
+				for (i = 0; i < cnt; i++) {
+					safe_unpack_time(
+						&msg->bf_cycle_rec_when[i],
+						buffer);
+					safe_unpack32(
+						&msg->bf_cycle_rec_usec[i],
+						buffer);
+					safe_unpack32(
+						&msg->bf_cycle_rec_try_usec[i],
+						buffer);
+					safe_unpack32(
+						&msg->bf_cycle_rec_depth[i],
+						buffer);
+					safe_unpack32(
+						&msg->bf_cycle_rec_depth_try[i],
+						buffer);
+					safe_unpack32(
+						&msg->bf_cycle_rec_yields[i],
+						buffer);
+					safe_unpack32(
+						&msg->bf_cycle_rec_table_size[i],
+						buffer);
+					safe_unpack32(
+						&msg->bf_cycle_rec_queue_len[i],
+						buffer);
+				}
+			}
+
+			safe_unpack32(&msg->lock_domain_cnt, buffer);
+			if (msg->lock_domain_cnt > NO_VAL16)
+				goto unpack_error;
+			if (msg->lock_domain_cnt) {
+				safe_unpackstr_array(&msg->lock_domain_names,
+						     &uint32_tmp, buffer);
+				if (uint32_tmp != msg->lock_domain_cnt)
+					goto unpack_error;
+				safe_unpack32_array(&msg->lock_domain_lock_cnt,
+						    &uint32_tmp, buffer);
+				safe_unpack64_array(
+					&msg->lock_domain_wait_time,
+					&uint32_tmp, buffer);
+				safe_unpack64_array(&msg->lock_domain_wait_max,
+						    &uint32_tmp, buffer);
+				safe_unpack64_array(
+					&msg->lock_domain_hold_time,
+					&uint32_tmp, buffer);
+				safe_unpack64_array(&msg->lock_domain_hold_max,
+						    &uint32_tmp, buffer);
+				safe_unpack32(&msg->lock_hist_size, buffer);
+				safe_unpack32_array(&msg->lock_hold_hist,
+						    &uint32_tmp, buffer);
+				if (uint32_tmp != (msg->lock_domain_cnt *
+						   msg->lock_hist_size))
+					goto unpack_error;
+				safe_unpack32(&msg->lock_caller_cnt, buffer);
+				safe_unpack64_array(&msg->lock_caller_addr,
+						    &uint32_tmp, buffer);
+				safe_unpack32_array(&msg->lock_caller_lock_cnt,
+						    &uint32_tmp, buffer);
+				safe_unpack64_array(
+					&msg->lock_caller_wait_time,
+					&uint32_tmp, buffer);
+				safe_unpack64_array(&msg->lock_caller_wait_max,
+						    &uint32_tmp, buffer);
+				safe_unpack64_array(
+					&msg->lock_caller_hold_time,
+					&uint32_tmp, buffer);
+				safe_unpack64_array(&msg->lock_caller_hold_max,
+						    &uint32_tmp, buffer);
+				if (uint32_tmp != msg->lock_caller_cnt)
+					goto unpack_error;
+			}
+		}
+
+		/* Job lifecycle interval histograms */
+		safe_unpack32(&msg->job_timing_hist_size, buffer);
+		if (msg->job_timing_hist_size > 1024)
+			goto unpack_error;
+		safe_unpack32_array(&msg->job_timing_submit_eval_hist,
+				    &uint32_tmp, buffer);
+		if (uint32_tmp != msg->job_timing_hist_size)
+			goto unpack_error;
+		safe_unpack32_array(&msg->job_timing_alloc_launch_hist,
+				    &uint32_tmp, buffer);
+		if (uint32_tmp != msg->job_timing_hist_size)
+			goto unpack_error;
+		safe_unpack32_array(&msg->job_timing_complete_clean_hist,
+				    &uint32_tmp, buffer);
+		if (uint32_tmp != msg->job_timing_hist_size)
+			goto unpack_error;
+
+		/* Internal work queue depths and event counters */
+		safe_unpack32(&msg->queue_cnt, buffer);
+		if (msg->queue_cnt > 1024)
+			goto unpack_error;
+		if (msg->queue_cnt) {
+			msg->queue_name = xcalloc(msg->queue_cnt,
+						  sizeof(char *));
+			msg->queue_depth = xcalloc(msg->queue_cnt,
+						   sizeof(uint32_t));
+			msg->queue_head_age = xcalloc(msg->queue_cnt,
+						      sizeof(uint32_t));
+			msg->queue_enqueued = xcalloc(msg->queue_cnt,
+						      sizeof(uint64_t));
+			msg->queue_dequeued = xcalloc(msg->queue_cnt,
+						      sizeof(uint64_t));
+			for (i = 0; i < msg->queue_cnt; i++) {
+				safe_unpackstr_xmalloc(&msg->queue_name[i],
+						       &uint32_tmp, buffer);
+				safe_unpack32(&msg->queue_depth[i], buffer);
+				safe_unpack32(&msg->queue_head_age[i], buffer);
+				safe_unpack64(&msg->queue_enqueued[i], buffer);
+				safe_unpack64(&msg->queue_dequeued[i], buffer);
+			}
 		}
 
 		safe_unpack32(&msg->rpc_type_size,		buffer);
 		safe_unpack16_array(&msg->rpc_type_id,   &uint32_tmp, buffer);
 		safe_unpack32_array(&msg->rpc_type_cnt,  &uint32_tmp, buffer);
 		safe_unpack64_array(&msg->rpc_type_time, &uint32_tmp, buffer);
+		safe_unpack32(&msg->rpc_type_hist_size,		buffer);
+		safe_unpack32_array(&msg->rpc_type_hist, &uint32_tmp, buffer);
+		if (uint32_tmp !=
+		    (msg->rpc_type_size * msg->rpc_type_hist_size))
+			goto unpack_error;
+		safe_unpack32(&msg->rpc_queue_depth,		buffer);
 
 		safe_unpack32(&msg->rpc_user_size,		buffer);
 		safe_unpack32_array(&msg->rpc_user_id,   &uint32_tmp, buffer);
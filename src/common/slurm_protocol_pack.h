@@ -156,6 +156,10 @@ extern int unpack_job_step_create_request_msg(
 	job_step_create_request_msg_t ** msg, Buf buffer,
 	uint16_t protocol_version);
 
+extern void pack_priority_factors_response_msg(
+	priority_factors_response_msg_t * msg, Buf buffer,
+	uint16_t protocol_version);
+
 extern void pack_multi_core_data (multi_core_data_t *multi_core, Buf buffer,
 				  uint16_t protocol_version);
 extern int unpack_multi_core_data (multi_core_data_t **multi_core, Buf buffer,
@@ -51,6 +51,7 @@
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "slurm/slurm_errno.h"
@@ -81,6 +82,8 @@
 /* Static functions */
 static int _slurm_connect(int __fd, struct sockaddr const * __addr,
 			  socklen_t __len);
+static int _writev_timeout(int fd, struct iovec *iov, int iovcnt,
+			   uint32_t flags, int timeout);
 
 /****************************************************************
  * MIDDLE LAYER MSG FUNCTIONS
@@ -161,6 +164,128 @@ extern ssize_t slurm_msg_recvfrom_timeout(int fd, char **pbuf, size_t *lenp,
 	return (ssize_t) msglen;
 }
 
+/* Send a full iovec array with timeout. The iovec entries are consumed
+ * as their bytes go out, so the caller must not reuse them.
+ * RET total bytes sent or SLURM_ERROR on error */
+static int _writev_timeout(int fd, struct iovec *iov, int iovcnt,
+			   uint32_t flags, int timeout)
+{
+	int rc;
+	int sent = 0;
+	size_t size = 0;
+	int fd_flags;
+	struct pollfd ufds;
+	struct timeval tstart;
+	int timeleft = timeout;
+	char temp[2];
+	int i;
+
+	for (i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+
+	ufds.fd     = fd;
+	ufds.events = POLLOUT;
+
+	fd_flags = fcntl(fd, F_GETFL);
+	fd_set_nonblocking(fd);
+
+	gettimeofday(&tstart, NULL);
+
+	while (sent < size) {
+		timeleft = timeout - _tot_wait(&tstart);
+		if (timeleft <= 0) {
+			debug("%s at %d of %zu, timeout",
+			      __func__, sent, size);
+			slurm_seterrno(SLURM_PROTOCOL_SOCKET_IMPL_TIMEOUT);
+			sent = SLURM_ERROR;
+			goto done;
+		}
+
+		if ((rc = poll(&ufds, 1, timeleft)) <= 0) {
+			if ((rc == 0) || (errno == EINTR) || (errno == EAGAIN))
+ 				continue;
+			else {
+				debug("%s at %d of %zu, poll error: %s",
+				      __func__, sent, size, strerror(errno));
+				slurm_seterrno(SLURM_COMMUNICATIONS_SEND_ERROR);
+				sent = SLURM_ERROR;
+				goto done;
+			}
+		}
+
+		/*
+		 * Check here to make sure the socket really is there.
+		 * If not then exit out and notify the sender.  This
+ 		 * is here since a write doesn't always tell you the
+		 * socket is gone, but getting 0 back from a
+		 * nonblocking read means just that.
+		 */
+		if (ufds.revents & POLLERR) {
+			debug("%s: Socket POLLERR", __func__);
+			slurm_seterrno(ENOTCONN);
+			sent = SLURM_ERROR;
+			goto done;
+		}
+		if ((ufds.revents & POLLHUP) || (ufds.revents & POLLNVAL) ||
+		    (recv(fd, &temp, 1, flags) == 0)) {
+			debug2("%s: Socket no longer there", __func__);
+			slurm_seterrno(ENOTCONN);
+			sent = SLURM_ERROR;
+			goto done;
+		}
+		if ((ufds.revents & POLLOUT) != POLLOUT) {
+			error("%s: Poll failure, revents:%d",
+			      __func__, ufds.revents);
+		}
+
+		rc = writev(fd, iov, iovcnt);
+		if (rc < 0) {
+ 			if (errno == EINTR)
+				continue;
+			debug("%s at %d of %zu, writev error: %s",
+			      __func__, sent, size, strerror(errno));
+ 			if (errno == EAGAIN) {	/* poll() lied to us */
+				usleep(10000);
+				continue;
+			}
+ 			slurm_seterrno(SLURM_COMMUNICATIONS_SEND_ERROR);
+			sent = SLURM_ERROR;
+			goto done;
+		}
+		if (rc == 0) {
+			debug("%s at %d of %zu, sent zero bytes",
+			      __func__, sent, size);
+			slurm_seterrno(SLURM_PROTOCOL_SOCKET_ZERO_BYTES_SENT);
+			sent = SLURM_ERROR;
+			goto done;
+		}
+
+		sent += rc;
+
+		/* Advance past the fully sent segments */
+		while (iovcnt && (rc >= iov->iov_len)) {
+			rc -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (iovcnt) {
+			iov->iov_base = ((char *) iov->iov_base) + rc;
+			iov->iov_len -= rc;
+		}
+	}
+
+    done:
+	/* Reset fd flags to prior state, preserve errno */
+	if (fd_flags != -1) {
+		int slurm_err = slurm_get_errno();
+		if (fcntl(fd, F_SETFL, fd_flags) < 0)
+			error("%s: fcntl(F_SETFL) error: %m", __func__);
+		slurm_seterrno(slurm_err);
+	}
+
+	return sent;
+}
+
 extern ssize_t slurm_msg_sendto(int fd, char *buffer, size_t size)
 {
 	return slurm_msg_sendto_timeout(fd, buffer, size,
@@ -169,10 +294,40 @@ extern ssize_t slurm_msg_sendto(int fd, char *buffer, size_t size)
 
 ssize_t slurm_msg_sendto_timeout(int fd, char *buffer,
 				 size_t size, int timeout)
+{
+	struct iovec iov;
+
+	iov.iov_base = buffer;
+	iov.iov_len  = size;
+
+	return slurm_msg_sendv_timeout(fd, &iov, 1, timeout);
+}
+
+extern ssize_t slurm_msg_sendv(int fd, struct iovec *iov, int iovcnt)
+{
+	return slurm_msg_sendv_timeout(fd, iov, iovcnt,
+				       (slurm_get_msg_timeout() * 1000));
+}
+
+ssize_t slurm_msg_sendv_timeout(int fd, struct iovec *iov, int iovcnt,
+				int timeout)
 {
 	int   len;
+	size_t size = 0;
 	uint32_t usize;
 	SigFunc *ohandler;
+	struct iovec *send_iov;
+	int i;
+
+	for (i = 0; i < iovcnt; i++)
+		size += iov[i].iov_len;
+	usize = htonl(size);
+
+	/* Prepend the message length so it goes out in the same writev */
+	send_iov = xmalloc(sizeof(struct iovec) * (iovcnt + 1));
+	send_iov[0].iov_base = &usize;
+	send_iov[0].iov_len  = sizeof(usize);
+	memcpy(send_iov + 1, iov, sizeof(struct iovec) * iovcnt);
 
 	/*
 	 *  Ignore SIGPIPE so that send can return a error code if the
@@ -180,19 +335,11 @@ ssize_t slurm_msg_sendto_timeout(int fd, char *buffer,
 	 */
 	ohandler = xsignal(SIGPIPE, SIG_IGN);
 
-	usize = htonl(size);
-
-	if ((len = slurm_send_timeout(
-				fd, (char *)&usize, sizeof(usize), 0,
-				timeout)) < 0)
-		goto done;
-
-	if ((len = slurm_send_timeout(fd, buffer, size, 0, timeout)) < 0)
-		goto done;
-
+	if ((len = _writev_timeout(fd, send_iov, iovcnt + 1, 0, timeout)) >= 0)
+		len = size;
 
-     done:
 	xsignal(SIGPIPE, ohandler);
+	xfree(send_iov);
 	return len;
 }
 
@@ -235,9 +235,49 @@ extern slurm_step_layout_t *slurm_step_layout_copy(
 extern void pack_slurm_step_layout(slurm_step_layout_t *step_layout,
 				   Buf buffer, uint16_t protocol_version)
 {
-	uint32_t i = 0;
+	uint32_t i = 0, j, task_id = 0;
+	uint8_t compact = 1;
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		if (step_layout)
+			i = 1;
+
+		pack16(i, buffer);
+		if (!i)
+			return;
+		packstr(step_layout->front_end, buffer);
+		packstr(step_layout->node_list, buffer);
+		pack32(step_layout->node_cnt, buffer);
+		pack16(step_layout->start_protocol_ver, buffer);
+		pack32(step_layout->task_cnt, buffer);
+		pack32(step_layout->task_dist, buffer);
+
+		/*
+		 * A block distribution assigns sequential task ids on each
+		 * node, so the per-node task id arrays are fully described
+		 * by the task counts. Transmit only the counts in that case,
+		 * shrinking the message by the tasks-per-node factor.
+		 */
+		for (i = 0; compact && (i < step_layout->node_cnt); i++) {
+			for (j = 0; j < step_layout->tasks[i]; j++) {
+				if (step_layout->tids[i][j] != task_id++) {
+					compact = 0;
+					break;
+				}
+			}
+		}
+		pack8(compact, buffer);
+		if (compact) {
+			pack16_array(step_layout->tasks,
+				     step_layout->node_cnt, buffer);
+		} else {
+			for (i = 0; i < step_layout->node_cnt; i++) {
+				pack32_array(step_layout->tids[i],
+					     step_layout->tasks[i],
+					     buffer);
+			}
+		}
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		if (step_layout)
 			i = 1;
 
@@ -265,12 +305,59 @@ extern void pack_slurm_step_layout(slurm_step_layout_t *step_layout,
 extern int unpack_slurm_step_layout(slurm_step_layout_t **layout, Buf buffer,
 				    uint16_t protocol_version)
 {
+	uint8_t compact;
 	uint16_t uint16_tmp;
-	uint32_t num_tids, uint32_tmp;
+	uint32_t num_tids, task_id = 0, uint32_tmp;
 	slurm_step_layout_t *step_layout = NULL;
-	int i;
+	int i, j;
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		safe_unpack16(&uint16_tmp, buffer);
+		if (!uint16_tmp)
+			return SLURM_SUCCESS;
+
+		step_layout = xmalloc(sizeof(slurm_step_layout_t));
+		*layout = step_layout;
+
+		safe_unpackstr_xmalloc(&step_layout->front_end,
+				       &uint32_tmp, buffer);
+		safe_unpackstr_xmalloc(&step_layout->node_list,
+				       &uint32_tmp, buffer);
+		safe_unpack32(&step_layout->node_cnt, buffer);
+		safe_unpack16(&step_layout->start_protocol_ver, buffer);
+		safe_unpack32(&step_layout->task_cnt, buffer);
+		safe_unpack32(&step_layout->task_dist, buffer);
+
+		safe_unpack8(&compact, buffer);
+		if (compact) {
+			/* Block distribution: expand the task counts back
+			 * into sequential per-node task id arrays */
+			safe_unpack16_array(&step_layout->tasks,
+					    &num_tids, buffer);
+			if (num_tids != step_layout->node_cnt)
+				goto unpack_error;
+			safe_xcalloc(step_layout->tids, step_layout->node_cnt,
+				     sizeof(uint32_t *));
+			for (i = 0; i < step_layout->node_cnt; i++) {
+				step_layout->tids[i] =
+					xcalloc(step_layout->tasks[i],
+						sizeof(uint32_t));
+				for (j = 0; j < step_layout->tasks[i]; j++)
+					step_layout->tids[i][j] = task_id++;
+			}
+		} else {
+			safe_xcalloc(step_layout->tasks, step_layout->node_cnt,
+				     sizeof(uint32_t));
+			safe_xcalloc(step_layout->tids, step_layout->node_cnt,
+				     sizeof(uint32_t *));
+			for (i = 0; i < step_layout->node_cnt; i++) {
+				safe_unpack32_array(&(step_layout->tids[i]),
+						    &num_tids,
+						    buffer);
+				step_layout->tasks[i] = num_tids;
+			}
+		}
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		safe_unpack16(&uint16_tmp, buffer);
 		if (!uint16_tmp)
 			return SLURM_SUCCESS;
@@ -668,7 +755,7 @@ static int _task_layout_cyclic(slurm_step_layout_t *step_layout,
 			       uint16_t *cpus)
 {
 	int i, j, max_over_subscribe = 0, taskid = 0, total_cpus = 0;
-	bool over_subscribe = false;
+	bool over_subscribe = false, over_subscribe_init;
 
 	for (i = 0; i < step_layout->node_cnt; i++)
 		total_cpus += cpus[i];
@@ -678,7 +765,11 @@ static int _task_layout_cyclic(slurm_step_layout_t *step_layout,
 		max_over_subscribe = (i + step_layout->node_cnt - 1) /
 				     step_layout->node_cnt;
 	}
+	over_subscribe_init = over_subscribe;
 
+	/* Pass 1: count the tasks landing on each node so the task id
+	 * arrays can be sized in one shot below rather than grown one
+	 * entry at a time */
 	for (j=0; taskid<step_layout->task_cnt; j++) {   /* cycle counter */
 		bool space_remaining = false;
 		for (i=0; ((i<step_layout->node_cnt)
@@ -686,9 +777,32 @@ static int _task_layout_cyclic(slurm_step_layout_t *step_layout,
 			if ((j < cpus[i]) ||
 			    (over_subscribe &&
 			     (j < (cpus[i] + max_over_subscribe)))) {
-				xrealloc(step_layout->tids[i], sizeof(uint32_t)
-					 * (step_layout->tasks[i] + 1));
+				taskid++;
+				step_layout->tasks[i]++;
+				if ((j+1) < cpus[i])
+					space_remaining = true;
+			}
+		}
+		if (!space_remaining)
+			over_subscribe = true;
+	}
+
+	for (i = 0; i < step_layout->node_cnt; i++) {
+		step_layout->tids[i] = xcalloc(step_layout->tasks[i],
+					       sizeof(uint32_t));
+		step_layout->tasks[i] = 0;
+	}
 
+	/* Pass 2: replay the same cycle to assign the task ids */
+	taskid = 0;
+	over_subscribe = over_subscribe_init;
+	for (j=0; taskid<step_layout->task_cnt; j++) {   /* cycle counter */
+		bool space_remaining = false;
+		for (i=0; ((i<step_layout->node_cnt)
+			   && (taskid<step_layout->task_cnt)); i++) {
+			if ((j < cpus[i]) ||
+			    (over_subscribe &&
+			     (j < (cpus[i] + max_over_subscribe)))) {
 				step_layout->tids[i][step_layout->tasks[i]] =
 					taskid;
 				taskid++;
@@ -53,6 +53,17 @@ inline static void _init(void)
 	}
 }
 
+extern time_t slurm_cached_time(void)
+{
+#ifdef CLOCK_REALTIME_COARSE
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_REALTIME_COARSE, &ts) == 0)
+		return ts.tv_sec;
+#endif
+	return time(NULL);
+}
+
 extern char *slurm_ctime(const time_t *timep)
 {
 	char *rc;
@@ -40,6 +40,15 @@ extern struct tm *slurm_localtime_r(const time_t *timep, struct tm *result);
 
 extern time_t slurm_mktime(struct tm *tp);
 
+/*
+ * Coarse equivalent of time(NULL) for hot paths. Served from the
+ * kernel's tick resolution clock (via the vDSO, no syscall) where
+ * available, so the result may lag the precise clock by a scheduler
+ * tick (typically 1-10 msec). Use wherever one second resolution
+ * wall-clock time is being fetched repeatedly per operation.
+ */
+extern time_t slurm_cached_time(void);
+
 /* Slurm variants of ctime and ctime_r without a trailing new-line */
 extern char *slurm_ctime2(const time_t *timep);
 extern char *slurm_ctime2_r(const time_t *timep, char *time_str);
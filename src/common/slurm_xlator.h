@@ -213,6 +213,7 @@
 #define	log_fp			slurm_log_fp
 #define	log_has_data		slurm_log_has_data
 #define	log_flush		slurm_log_flush
+#define	log_set_async		slurm_log_set_async
 #define log_var			slurm_log_var
 #define	fatal_abort		slurm_fatal_abort
 #define	fatal			slurm_fatal
@@ -229,6 +230,7 @@
 #define net_set_low_water	slurm_net_set_low_water
 
 /* pack.[ch] functions */
+#define	buf_ref			slurm_buf_ref
 #define	create_buf		slurm_create_buf
 #define	free_buf		slurm_free_buf
 #define grow_buf		slurm_grow_buf
@@ -321,6 +323,11 @@
 #define	_xrfc5424timecat	slurm_xrfc5424timecat
 #define	_xstrfmtcat		slurm_xstrfmtcat
 #define	_xmemcat		slurm_xmemcat
+#define	xstrbuf_cat		slurm_xstrbuf_cat
+#define	xstrbuf_ncat		slurm_xstrbuf_ncat
+#define	xstrbuf_fmtcat		slurm_xstrbuf_fmtcat
+#define	xstrbuf_finish		slurm_xstrbuf_finish
+#define	xstrbuf_free		slurm_xstrbuf_free
 #define	xstrdup			slurm_xstrdup
 #define	xstrdup_printf		slurm_xstrdup_printf
 #define	xbasename		slurm_xbasename
@@ -336,6 +343,16 @@
 #define xstrncasecmp		slurm_xstrncasecmp
 #define xstrcasestr		slurm_xstrcasestr
 
+/* xvector.[ch] functions */
+#define	xvector_create		slurm_xvector_create
+#define	xvector_destroy		slurm_xvector_destroy
+#define	xvector_count		slurm_xvector_count
+#define	xvector_append		slurm_xvector_append
+#define	xvector_get		slurm_xvector_get
+#define	xvector_pop		slurm_xvector_pop
+#define	xvector_sort		slurm_xvector_sort
+#define	xvector_for_each	slurm_xvector_for_each
+
 /* slurm_protocol_api.[ch] functions */
 #define convert_num_unit2       slurm_convert_num_unit2
 #define convert_num_unit        slurm_convert_num_unit
@@ -474,5 +491,6 @@
 #include "src/common/xmalloc.h"
 #include "src/common/xsignal.h"
 #include "src/common/xstring.h"
+#include "src/common/xvector.h"
 
 #endif /*__SLURM_XLATOR_H__*/
@@ -398,6 +398,44 @@ extern void slurmdb_job_cond_def_start_end(slurmdb_job_cond_t *job_cond)
 		job_cond->usage_end = time(NULL);
 }
 
+static void _destroy_shard_job_cond(void *object)
+{
+	/* shallow copy, the shared members belong to the original */
+	xfree(object);
+}
+
+extern List slurmdb_job_cond_shard(slurmdb_job_cond_t *job_cond, int count)
+{
+	List shard_list;
+	slurmdb_job_cond_t *shard;
+	time_t start, end, step;
+	int i;
+
+	if (!job_cond || (job_cond->flags & JOBCOND_FLAG_RUNAWAY) ||
+	    (count < 2))
+		return NULL;
+
+	start = job_cond->usage_start;
+	end = job_cond->usage_end;
+	if (!end)
+		end = time(NULL);
+	/* need a window big enough to give every shard a piece */
+	if (!start || ((end - start) < count))
+		return NULL;
+
+	step = (end - start + count - 1) / count;
+	shard_list = list_create(_destroy_shard_job_cond);
+	for (i = 0; i < count; i++) {
+		shard = xmalloc(sizeof(slurmdb_job_cond_t));
+		*shard = *job_cond;
+		shard->usage_start = start + (step * i);
+		shard->usage_end = MIN(end, shard->usage_start + step);
+		list_append(shard_list, shard);
+	}
+
+	return shard_list;
+}
+
 static uint32_t _str_2_qos_flags(char *flags)
 {
 	if (xstrcasestr(flags, "DenyOnLimit"))
@@ -4452,7 +4490,9 @@ extern void slurmdb_destroy_stats_rec(void *object)
 
 		xfree(rpc_stats->rpc_type_id);
 		xfree(rpc_stats->rpc_type_cnt);
+		xfree(rpc_stats->rpc_type_hist);
 		xfree(rpc_stats->rpc_type_time);
+		xfree(rpc_stats->rpc_type_time_max);
 
 		xfree(rpc_stats->rpc_user_id);
 		xfree(rpc_stats->rpc_user_cnt);
@@ -295,4 +295,17 @@ extern int slurmdb_setup_cluster_rec(slurmdb_cluster_rec_t *cluster_rec);
 
 extern void slurmdb_job_cond_def_start_end(slurmdb_job_cond_t *job_cond);
 
+/*
+ * Split a job condition's [usage_start, usage_end] window into count
+ * contiguous time shards so they can be fetched over concurrent
+ * connections.  The returned conditions are shallow copies sharing the
+ * original's lists and strings: free them (with the returned list)
+ * before the original and only read them while in use.  A job active
+ * across a shard boundary is returned by every shard it overlaps, so
+ * callers merging shard results must drop those duplicates.
+ * RET list of slurmdb_job_cond_t, or NULL if the condition has no
+ * time window that can be split count ways.
+ */
+extern List slurmdb_job_cond_shard(slurmdb_job_cond_t *job_cond, int count);
+
 #endif
@@ -42,6 +42,7 @@
 #include "slurmdbd_defs.h"
 #include "slurm_protocol_defs.h"
 #include "slurm_jobacct_gather.h"
+#include "slurm_protocol_pack.h"
 #include "list.h"
 #include "pack.h"
 
@@ -5715,6 +5716,361 @@ unpack_error:
 	return SLURM_ERROR;
 }
 
+/*
+ * Bulk pack of a whole List of slurmdb_job_rec_t in a columnar layout:
+ * each fixed width field is written as one contiguous column across all
+ * records, then the stats, then the string fields and finally the step
+ * lists.  A large sacct response stays in one tight loop per field this
+ * way instead of walking the full per record field sequence for every
+ * job.  Peers older than 20.02 get the row layout from
+ * slurmdb_pack_job_rec(); both sides pick the layout from the connection
+ * version, so no extra negotiation is needed.
+ *
+ * The column order below must stay in sync with
+ * slurmdb_unpack_job_rec_list().
+ */
+#define _pack_col16(field)					\
+	do {							\
+		for (i = 0; i < count; i++)			\
+			pack16(job_array[i]->field, buffer);	\
+	} while (0)
+#define _pack_col32(field)					\
+	do {							\
+		for (i = 0; i < count; i++)			\
+			pack32(job_array[i]->field, buffer);	\
+	} while (0)
+#define _pack_col64(field)					\
+	do {							\
+		for (i = 0; i < count; i++)			\
+			pack64(job_array[i]->field, buffer);	\
+	} while (0)
+#define _pack_col_time(field)					\
+	do {							\
+		for (i = 0; i < count; i++)			\
+			pack_time(job_array[i]->field, buffer);	\
+	} while (0)
+#define _pack_colstr(field)					\
+	do {							\
+		for (i = 0; i < count; i++)			\
+			packstr(job_array[i]->field, buffer);	\
+		if (size_buf(buffer) > REASONABLE_BUF_SIZE)	\
+			goto too_large;				\
+	} while (0)
+
+extern int slurmdb_pack_job_rec_list(List jobs, uint16_t protocol_version,
+				     Buf buffer)
+{
+	slurmdb_job_rec_t **job_array, *job;
+	slurmdb_step_rec_t *step;
+	ListIterator itr;
+	uint32_t count, header_position, i;
+	int rc = SLURM_SUCCESS;
+
+	if (protocol_version < SLURM_20_02_PROTOCOL_VERSION)
+		return slurm_pack_list(jobs, slurmdb_pack_job_rec, buffer,
+				       protocol_version);
+
+	if (!jobs) {
+		/* to let user know there wasn't a list (error) */
+		pack32(NO_VAL, buffer);
+		return rc;
+	}
+
+	header_position = get_buf_offset(buffer);
+
+	count = list_count(jobs);
+	pack32(count, buffer);
+	if (!count)
+		return rc;
+
+	/*
+	 * Flatten the list once so every column below is a tight loop
+	 * over an array instead of a list walk per field.
+	 */
+	job_array = xcalloc(count, sizeof(slurmdb_job_rec_t *));
+	i = 0;
+	itr = list_iterator_create(jobs);
+	while ((job = list_next(itr)))
+		job_array[i++] = job;
+	list_iterator_destroy(itr);
+
+	_pack_col32(alloc_nodes);
+	_pack_col32(array_job_id);
+	_pack_col32(array_max_tasks);
+	_pack_col32(array_task_id);
+	_pack_col32(associd);
+	for (i = 0; i < count; i++)
+		pack32((uint32_t)job_array[i]->derived_ec, buffer);
+	_pack_col32(elapsed);
+	for (i = 0; i < count; i++)
+		pack32((uint32_t)job_array[i]->exitcode, buffer);
+	_pack_col32(flags);
+	_pack_col32(gid);
+	_pack_col32(jobid);
+	_pack_col32(lft);
+	_pack_col32(pack_job_id);
+	_pack_col32(pack_job_offset);
+	_pack_col32(priority);
+	_pack_col32(qosid);
+	_pack_col32(req_cpus);
+	_pack_col32(requid);
+	_pack_col32(resvid);
+	_pack_col32(show_full);
+	_pack_col32(state);
+	_pack_col32(state_reason_prev);
+	_pack_col32(suspended);
+	_pack_col32(sys_cpu_sec);
+	_pack_col32(sys_cpu_usec);
+	_pack_col32(timelimit);
+	_pack_col32(tot_cpu_sec);
+	_pack_col32(tot_cpu_usec);
+	_pack_col32(uid);
+	_pack_col32(user_cpu_sec);
+	_pack_col32(user_cpu_usec);
+	_pack_col32(wckeyid);
+	_pack_col64(req_mem);
+	_pack_col16(track_steps);
+	_pack_col_time(eligible);
+	_pack_col_time(end);
+	_pack_col_time(start);
+	_pack_col_time(submit);
+
+	for (i = 0; i < count; i++)
+		_pack_slurmdb_stats(&job_array[i]->stats, protocol_version,
+				    buffer);
+	if (size_buf(buffer) > REASONABLE_BUF_SIZE)
+		goto too_large;
+
+	_pack_colstr(account);
+	_pack_colstr(admin_comment);
+	_pack_colstr(alloc_gres);
+	_pack_colstr(array_task_str);
+	_pack_colstr(blockid);
+	_pack_colstr(cluster);
+	_pack_colstr(constraints);
+	_pack_colstr(derived_es);
+	_pack_colstr(jobname);
+	_pack_colstr(mcs_label);
+	_pack_colstr(nodes);
+	_pack_colstr(partition);
+	_pack_colstr(req_gres);
+	_pack_colstr(resv_name);
+	_pack_colstr(system_comment);
+	_pack_colstr(tres_alloc_str);
+	_pack_colstr(tres_req_str);
+	_pack_colstr(user);
+	_pack_colstr(wckey);
+	_pack_colstr(work_dir);
+
+	for (i = 0; i < count; i++) {
+		uint32_t step_cnt = 0;
+
+		if (job_array[i]->steps)
+			step_cnt = list_count(job_array[i]->steps);
+		pack32(step_cnt, buffer);
+		if (!step_cnt)
+			continue;
+		itr = list_iterator_create(job_array[i]->steps);
+		while ((step = list_next(itr)))
+			slurmdb_pack_step_rec(step, protocol_version, buffer);
+		list_iterator_destroy(itr);
+		if (size_buf(buffer) > REASONABLE_BUF_SIZE)
+			goto too_large;
+	}
+
+	xfree(job_array);
+	return rc;
+
+too_large:
+	error("%s: size limit exceeded", __func__);
+	/* rewind buffer, pack NO_VAL as count instead */
+	set_buf_offset(buffer, header_position);
+	pack32(NO_VAL, buffer);
+	xfree(job_array);
+	return ESLURM_RESULT_TOO_LARGE;
+}
+
+#undef _pack_col16
+#undef _pack_col32
+#undef _pack_col64
+#undef _pack_col_time
+#undef _pack_colstr
+
+/*
+ * Unpack the columnar layout written by slurmdb_pack_job_rec_list().
+ * All records are allocated up front and every column read fills in one
+ * field across all of them.
+ */
+#define _unpack_col16(field)						\
+	do {								\
+		for (i = 0; i < count; i++)				\
+			safe_unpack16(&job_array[i]->field, buffer);	\
+	} while (0)
+#define _unpack_col32(field)						\
+	do {								\
+		for (i = 0; i < count; i++)				\
+			safe_unpack32(&job_array[i]->field, buffer);	\
+	} while (0)
+#define _unpack_col64(field)						\
+	do {								\
+		for (i = 0; i < count; i++)				\
+			safe_unpack64(&job_array[i]->field, buffer);	\
+	} while (0)
+#define _unpack_col_time(field)						\
+	do {								\
+		for (i = 0; i < count; i++)				\
+			safe_unpack_time(&job_array[i]->field, buffer);	\
+	} while (0)
+#define _unpack_colstr(field)						\
+	do {								\
+		for (i = 0; i < count; i++)				\
+			safe_unpackstr_xmalloc(&job_array[i]->field,	\
+					       &uint32_tmp, buffer);	\
+	} while (0)
+
+extern int slurmdb_unpack_job_rec_list(List *jobs, uint16_t protocol_version,
+				       Buf buffer)
+{
+	slurmdb_job_rec_t **job_array = NULL;
+	slurmdb_step_rec_t *step = NULL;
+	uint32_t count, step_cnt, uint32_tmp, i, j;
+
+	xassert(jobs);
+
+	if (protocol_version < SLURM_20_02_PROTOCOL_VERSION)
+		return slurm_unpack_list(jobs, slurmdb_unpack_job_rec,
+					 slurmdb_destroy_job_rec,
+					 buffer, protocol_version);
+
+	safe_unpack32(&count, buffer);
+	if (count == NO_VAL) {
+		/*
+		 * NO_VAL indicates an error on the sending side, and no
+		 * list is created (same as slurm_unpack_list()).
+		 */
+		return SLURM_SUCCESS;
+	}
+
+	/*
+	 * The first column alone holds 4 bytes per record, so any count
+	 * beyond that is a corrupt or malicious message.
+	 */
+	if (((uint64_t)count * 4) > remaining_buf(buffer))
+		return SLURM_ERROR;
+
+	*jobs = list_create(slurmdb_destroy_job_rec);
+	job_array = xcalloc(count, sizeof(slurmdb_job_rec_t *));
+	for (i = 0; i < count; i++) {
+		job_array[i] = xmalloc(sizeof(slurmdb_job_rec_t));
+		list_append(*jobs, job_array[i]);
+	}
+
+	_unpack_col32(alloc_nodes);
+	_unpack_col32(array_job_id);
+	_unpack_col32(array_max_tasks);
+	_unpack_col32(array_task_id);
+	_unpack_col32(associd);
+	for (i = 0; i < count; i++) {
+		safe_unpack32(&uint32_tmp, buffer);
+		job_array[i]->derived_ec = (int32_t)uint32_tmp;
+	}
+	_unpack_col32(elapsed);
+	for (i = 0; i < count; i++) {
+		safe_unpack32(&uint32_tmp, buffer);
+		job_array[i]->exitcode = (int32_t)uint32_tmp;
+	}
+	_unpack_col32(flags);
+	_unpack_col32(gid);
+	_unpack_col32(jobid);
+	_unpack_col32(lft);
+	_unpack_col32(pack_job_id);
+	_unpack_col32(pack_job_offset);
+	_unpack_col32(priority);
+	_unpack_col32(qosid);
+	_unpack_col32(req_cpus);
+	_unpack_col32(requid);
+	_unpack_col32(resvid);
+	_unpack_col32(show_full);
+	for (i = 0; i < count; i++) {
+		safe_unpack32(&uint32_tmp, buffer);
+		job_array[i]->state = uint32_tmp;
+	}
+	_unpack_col32(state_reason_prev);
+	_unpack_col32(suspended);
+	_unpack_col32(sys_cpu_sec);
+	_unpack_col32(sys_cpu_usec);
+	_unpack_col32(timelimit);
+	_unpack_col32(tot_cpu_sec);
+	_unpack_col32(tot_cpu_usec);
+	_unpack_col32(uid);
+	_unpack_col32(user_cpu_sec);
+	_unpack_col32(user_cpu_usec);
+	_unpack_col32(wckeyid);
+	_unpack_col64(req_mem);
+	_unpack_col16(track_steps);
+	_unpack_col_time(eligible);
+	_unpack_col_time(end);
+	_unpack_col_time(start);
+	_unpack_col_time(submit);
+
+	for (i = 0; i < count; i++) {
+		if (_unpack_slurmdb_stats(&job_array[i]->stats,
+					  protocol_version, buffer)
+		    != SLURM_SUCCESS)
+			goto unpack_error;
+	}
+
+	_unpack_colstr(account);
+	_unpack_colstr(admin_comment);
+	_unpack_colstr(alloc_gres);
+	_unpack_colstr(array_task_str);
+	_unpack_colstr(blockid);
+	_unpack_colstr(cluster);
+	_unpack_colstr(constraints);
+	_unpack_colstr(derived_es);
+	_unpack_colstr(jobname);
+	_unpack_colstr(mcs_label);
+	_unpack_colstr(nodes);
+	_unpack_colstr(partition);
+	_unpack_colstr(req_gres);
+	_unpack_colstr(resv_name);
+	_unpack_colstr(system_comment);
+	_unpack_colstr(tres_alloc_str);
+	_unpack_colstr(tres_req_str);
+	_unpack_colstr(user);
+	_unpack_colstr(wckey);
+	_unpack_colstr(work_dir);
+
+	for (i = 0; i < count; i++) {
+		safe_unpack32(&step_cnt, buffer);
+		job_array[i]->steps = list_create(slurmdb_destroy_step_rec);
+		for (j = 0; j < step_cnt; j++) {
+			if (slurmdb_unpack_step_rec(&step, protocol_version,
+						    buffer) == SLURM_ERROR)
+				goto unpack_error;
+
+			step->job_ptr = job_array[i];
+			if (!job_array[i]->first_step_ptr)
+				job_array[i]->first_step_ptr = step;
+			list_append(job_array[i]->steps, step);
+		}
+	}
+
+	xfree(job_array);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	xfree(job_array);
+	FREE_NULL_LIST(*jobs);
+	return SLURM_ERROR;
+}
+
+#undef _unpack_col16
+#undef _unpack_col32
+#undef _unpack_col64
+#undef _unpack_col_time
+#undef _unpack_colstr
+
 extern void slurmdb_pack_qos_cond(void *in, uint16_t protocol_version,
 				  Buf buffer)
 {
@@ -7103,7 +7459,39 @@ extern void slurmdb_pack_stats_msg(void *object, uint16_t protocol_version,
 	slurmdb_stats_rec_t *stats_ptr = (slurmdb_stats_rec_t *) object;
 	uint32_t i;
 
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		/* Rollup statistics */
+		i = 3;
+		pack32(i, buffer);
+		pack16_array(stats_ptr->rollup_count,    i, buffer);
+		pack64_array(stats_ptr->rollup_time,     i, buffer);
+		pack64_array(stats_ptr->rollup_max_time, i, buffer);
+
+		/* RPC type statistics */
+		for (i = 0; i < stats_ptr->type_cnt; i++) {
+			if (stats_ptr->rpc_type_id[i] == 0)
+				break;
+		}
+		pack32(i, buffer);
+		pack16_array(stats_ptr->rpc_type_id,       i, buffer);
+		pack32_array(stats_ptr->rpc_type_cnt,      i, buffer);
+		pack64_array(stats_ptr->rpc_type_time,     i, buffer);
+		pack64_array(stats_ptr->rpc_type_time_max, i, buffer);
+		/* Histogram rows for the first i types are contiguous */
+		pack32(stats_ptr->rpc_type_hist_size, buffer);
+		pack32_array(stats_ptr->rpc_type_hist,
+			     i * stats_ptr->rpc_type_hist_size, buffer);
+
+		/* RPC user statistics */
+		for (i = 1; i < stats_ptr->user_cnt; i++) {
+			if (stats_ptr->rpc_user_id[i] == 0)
+				break;
+		}
+		pack32(i, buffer);
+		pack32_array(stats_ptr->rpc_user_id,   i, buffer);
+		pack32_array(stats_ptr->rpc_user_cnt,  i, buffer);
+		pack64_array(stats_ptr->rpc_user_time, i, buffer);
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		/* Rollup statistics */
 		i = 3;
 		pack32(i, buffer);
@@ -7144,7 +7532,66 @@ extern int slurmdb_unpack_stats_msg(void **object, uint16_t protocol_version,
 		xmalloc(sizeof(slurmdb_stats_rec_t));
 
 	*object = stats_ptr;
-	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		/* Rollup statistics */
+		safe_unpack32(&uint32_tmp, buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+		safe_unpack16_array(&stats_ptr->rollup_count, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rollup_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rollup_max_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != 3)
+			goto unpack_error;
+
+		/* RPC type statistics */
+		safe_unpack32(&stats_ptr->type_cnt, buffer);
+		safe_unpack16_array(&stats_ptr->rpc_type_id, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->type_cnt)
+			goto unpack_error;
+		safe_unpack32_array(&stats_ptr->rpc_type_cnt, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->type_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rpc_type_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->type_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rpc_type_time_max, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->type_cnt)
+			goto unpack_error;
+		safe_unpack32(&stats_ptr->rpc_type_hist_size, buffer);
+		if (stats_ptr->rpc_type_hist_size > 1024)
+			goto unpack_error;
+		safe_unpack32_array(&stats_ptr->rpc_type_hist, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp !=
+		    (stats_ptr->type_cnt * stats_ptr->rpc_type_hist_size))
+			goto unpack_error;
+
+		/* RPC user statistics */
+		safe_unpack32(&stats_ptr->user_cnt, buffer);
+		safe_unpack32_array(&stats_ptr->rpc_user_id, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->user_cnt)
+			goto unpack_error;
+		safe_unpack32_array(&stats_ptr->rpc_user_cnt, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->user_cnt)
+			goto unpack_error;
+		safe_unpack64_array(&stats_ptr->rpc_user_time, &uint32_tmp,
+				    buffer);
+		if (uint32_tmp != stats_ptr->user_cnt)
+			goto unpack_error;
+	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		/* Rollup statistics */
 		safe_unpack32(&uint32_tmp, buffer);
 		if (uint32_tmp != 3)
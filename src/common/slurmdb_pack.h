@@ -187,6 +187,14 @@ extern void slurmdb_pack_job_rec(void *object,
 				 uint16_t protocol_version, Buf buffer);
 extern int slurmdb_unpack_job_rec(void **job, uint16_t protocol_version,
 				  Buf buffer);
+/*
+ * Bulk columnar (un)pack of a List of slurmdb_job_rec_t.  Falls back to
+ * the per record layout for peers older than 20.02.
+ */
+extern int slurmdb_pack_job_rec_list(List jobs, uint16_t protocol_version,
+				     Buf buffer);
+extern int slurmdb_unpack_job_rec_list(List *jobs, uint16_t protocol_version,
+				       Buf buffer);
 extern void slurmdb_pack_qos_cond(void *in,
 				  uint16_t protocol_version, Buf buffer);
 extern int slurmdb_unpack_qos_cond(void **object, uint16_t protocol_version,
@@ -1175,6 +1175,18 @@ extern void slurmdbd_pack_list_msg(dbd_list_msg_t *msg,
 	int rc;
 	void (*my_function) (void *object, uint16_t rpc_version, Buf buffer);
 
+	/*
+	 * Job record lists can run to millions of entries, so they get a
+	 * bulk columnar layout on new enough connections.
+	 */
+	if ((type == DBD_GOT_JOBS) || (type == DBD_FIX_RUNAWAY_JOB)) {
+		if ((rc = slurmdb_pack_job_rec_list(msg->my_list, rpc_version,
+						    buffer)) != SLURM_SUCCESS)
+			msg->return_code = rc;
+		pack32(msg->return_code, buffer);
+		return;
+	}
+
 	switch (type) {
 	case DBD_ADD_ACCOUNTS:
 	case DBD_GOT_ACCOUNTS:
@@ -1261,6 +1273,17 @@ extern int slurmdbd_unpack_list_msg(dbd_list_msg_t **msg, uint16_t rpc_version,
 	int (*my_function) (void **object, uint16_t rpc_version, Buf buffer);
 	void (*my_destroy) (void *object);
 
+	/* See the corresponding note in slurmdbd_pack_list_msg() */
+	if ((type == DBD_GOT_JOBS) || (type == DBD_FIX_RUNAWAY_JOB)) {
+		msg_ptr = xmalloc(sizeof(dbd_list_msg_t));
+		*msg = msg_ptr;
+		if (slurmdb_unpack_job_rec_list(&msg_ptr->my_list, rpc_version,
+						buffer) != SLURM_SUCCESS)
+			goto unpack_error;
+		safe_unpack32(&msg_ptr->return_code, buffer);
+		return SLURM_SUCCESS;
+	}
+
 	switch (type) {
 	case DBD_ADD_ACCOUNTS:
 	case DBD_GOT_ACCOUNTS:
@@ -36,10 +36,161 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/time.h>
+#include "slurm/slurm_errno.h"
 #include "src/common/log.h"
+#include "src/common/macros.h"
 #include "src/common/slurm_time.h"
+#include "src/common/timers.h"
+#include "src/common/xmalloc.h"
+
+/*
+ * Phase trace ring buffers. Events are recorded into one of several
+ * rings selected by the recording thread's identifier so concurrent
+ * threads seldom contend; each event carries the thread identifier so
+ * interleaved rings can still be separated when dumped.
+ */
+#define PHASE_TRACE_RINGS  16
+#define PHASE_TRACE_EVENTS 8192	/* events retained per ring */
+
+typedef struct {
+	uint64_t time_usec;	/* microseconds since epoch */
+	unsigned long tid;	/* recording thread */
+	uint16_t phase;		/* phase_trace_id_t */
+	uint8_t begin;		/* 1 on phase entry, 0 on exit */
+} phase_trace_event_t;
+
+typedef struct {
+	pthread_mutex_t lock;
+	uint32_t head;		/* next slot to write */
+	uint32_t count;		/* events recorded, capped at ring size */
+	phase_trace_event_t *events;
+} phase_trace_ring_t;
+
+/* Must match phase_trace_id_t in timers.h */
+static const char *phase_trace_names[PHASE_TRACE_CNT] = {
+	"none",
+	"select_nodes",
+	"sched_cycle",
+	"bf_cycle",
+	"bf_try_sched",
+	"pack_job_info",
+	"pack_node_info",
+	"dbd_agent_send",
+};
+
+bool phase_trace_on = false;
+static phase_trace_ring_t phase_trace_rings[PHASE_TRACE_RINGS];
+static pthread_once_t phase_trace_once = PTHREAD_ONCE_INIT;
+
+static void _phase_trace_init(void)
+{
+	int i;
+
+	for (i = 0; i < PHASE_TRACE_RINGS; i++)
+		slurm_mutex_init(&phase_trace_rings[i].lock);
+}
+
+extern void phase_trace_event(phase_trace_id_t phase, bool begin)
+{
+	phase_trace_ring_t *ring;
+	phase_trace_event_t *event;
+	struct timeval tv;
+	size_t h = (size_t) pthread_self();
+
+	/* Thread handles are aligned pointers on many systems, fold in the
+	 * high bits so the rings spread over more than the alignment */
+	h ^= (h >> 12);
+	ring = &phase_trace_rings[h % PHASE_TRACE_RINGS];
+
+	gettimeofday(&tv, NULL);
+	slurm_mutex_lock(&ring->lock);
+	if (!ring->events) {	/* tracing disabled since the test */
+		slurm_mutex_unlock(&ring->lock);
+		return;
+	}
+	event = &ring->events[ring->head];
+	event->time_usec = ((uint64_t) tv.tv_sec * 1000000) + tv.tv_usec;
+	event->tid = (unsigned long) pthread_self();
+	event->phase = phase;
+	event->begin = begin ? 1 : 0;
+	ring->head = (ring->head + 1) % PHASE_TRACE_EVENTS;
+	if (ring->count < PHASE_TRACE_EVENTS)
+		ring->count++;
+	slurm_mutex_unlock(&ring->lock);
+}
+
+extern void phase_trace_set(bool enable)
+{
+	phase_trace_ring_t *ring;
+	int i;
+
+	pthread_once(&phase_trace_once, _phase_trace_init);
+	if (!enable) {
+		/* Buffers are retained for a subsequent dump */
+		phase_trace_on = false;
+		return;
+	}
+	for (i = 0; i < PHASE_TRACE_RINGS; i++) {
+		ring = &phase_trace_rings[i];
+		slurm_mutex_lock(&ring->lock);
+		if (!ring->events) {
+			ring->events = xcalloc(PHASE_TRACE_EVENTS,
+					       sizeof(phase_trace_event_t));
+		}
+		ring->head = 0;
+		ring->count = 0;
+		slurm_mutex_unlock(&ring->lock);
+	}
+	phase_trace_on = true;
+}
+
+extern int phase_trace_dump(const char *path)
+{
+	phase_trace_ring_t *ring;
+	phase_trace_event_t *event;
+	uint32_t inx, j;
+	FILE *fp;
+	int i;
+
+	pthread_once(&phase_trace_once, _phase_trace_init);
+	if (!(fp = fopen(path, "w"))) {
+		error("%s: can not open %s: %m", __func__, path);
+		return errno;
+	}
+
+	for (i = 0; i < PHASE_TRACE_RINGS; i++) {
+		ring = &phase_trace_rings[i];
+		slurm_mutex_lock(&ring->lock);
+		if (!ring->events) {
+			slurm_mutex_unlock(&ring->lock);
+			continue;
+		}
+		/* Oldest event first */
+		inx = (ring->head + PHASE_TRACE_EVENTS - ring->count) %
+		      PHASE_TRACE_EVENTS;
+		for (j = 0; j < ring->count; j++) {
+			event = &ring->events[inx];
+			fprintf(fp, "%"PRIu64" %lu %s %c\n",
+				event->time_usec, event->tid,
+				phase_trace_names[event->phase],
+				event->begin ? 'B' : 'E');
+			inx = (inx + 1) % PHASE_TRACE_EVENTS;
+		}
+		xfree(ring->events);
+		ring->head = 0;
+		ring->count = 0;
+		slurm_mutex_unlock(&ring->lock);
+	}
+	fclose(fp);
+
+	return SLURM_SUCCESS;
+}
 
 /* Return the number of micro-seconds between now and argument "tv",
  * Initialize tv to NOW if zero on entry */
@@ -112,3 +263,94 @@ extern void slurm_diff_tv_str(struct timeval *tv1, struct timeval *tv2,
 		}
 	}
 }
+
+/*
+ * Internal queue telemetry, see timers.h. The table only grows and
+ * entries are immutable once registered, so the mutex guards only the
+ * registration itself and the event counters; depth and head callbacks
+ * run unlocked so they may take their queue's own lock freely.
+ */
+typedef struct {
+	const char *name;
+	queue_stats_depth_f depth_cb;
+	queue_stats_head_f head_cb;
+	uint64_t enqueued;
+	uint64_t dequeued;
+} queue_stats_ent_t;
+
+static queue_stats_ent_t queue_stats_tbl[QUEUE_STATS_MAX];
+static int queue_stats_cnt = 0;
+static pthread_mutex_t queue_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+extern int queue_stats_register(const char *name,
+				queue_stats_depth_f depth_cb,
+				queue_stats_head_f head_cb)
+{
+	int qid = -1;
+
+	slurm_mutex_lock(&queue_stats_mutex);
+	if (queue_stats_cnt < QUEUE_STATS_MAX) {
+		qid = queue_stats_cnt;
+		queue_stats_tbl[qid].name = name;
+		queue_stats_tbl[qid].depth_cb = depth_cb;
+		queue_stats_tbl[qid].head_cb = head_cb;
+		queue_stats_cnt++;
+	} else {
+		error("%s: queue table full, %s not registered",
+		      __func__, name);
+	}
+	slurm_mutex_unlock(&queue_stats_mutex);
+
+	return qid;
+}
+
+extern void queue_stats_enqueued(int qid)
+{
+	if (qid < 0)
+		return;
+	slurm_mutex_lock(&queue_stats_mutex);
+	queue_stats_tbl[qid].enqueued++;
+	slurm_mutex_unlock(&queue_stats_mutex);
+}
+
+extern void queue_stats_dequeued(int qid)
+{
+	if (qid < 0)
+		return;
+	slurm_mutex_lock(&queue_stats_mutex);
+	queue_stats_tbl[qid].dequeued++;
+	slurm_mutex_unlock(&queue_stats_mutex);
+}
+
+extern void queue_stats_pack(Buf buffer)
+{
+	time_t now = time(NULL), head;
+	uint64_t enqueued, dequeued;
+	uint32_t age;
+	int i, cnt, depth;
+
+	slurm_mutex_lock(&queue_stats_mutex);
+	cnt = queue_stats_cnt;
+	slurm_mutex_unlock(&queue_stats_mutex);
+
+	pack32((uint32_t) cnt, buffer);
+	for (i = 0; i < cnt; i++) {
+		queue_stats_ent_t *ent = &queue_stats_tbl[i];
+
+		depth = ent->depth_cb ? (ent->depth_cb)() : 0;
+		head = ent->head_cb ? (ent->head_cb)() : 0;
+		age = 0;
+		if (head && (now > head))
+			age = (uint32_t) (now - head);
+		slurm_mutex_lock(&queue_stats_mutex);
+		enqueued = ent->enqueued;
+		dequeued = ent->dequeued;
+		slurm_mutex_unlock(&queue_stats_mutex);
+
+		packstr((char *) ent->name, buffer);
+		pack32((uint32_t) MAX(depth, 0), buffer);
+		pack32(age, buffer);
+		pack64(enqueued, buffer);
+		pack64(dequeued, buffer);
+	}
+}
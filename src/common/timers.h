@@ -39,8 +39,11 @@
 #ifndef _HAVE_TIMERS_H
 #define _HAVE_TIMERS_H
 
+#include <stdbool.h>
 #include <sys/time.h>
 
+#include "src/common/pack.h"
+
 #define DEF_TIMERS	struct timeval tv1, tv2; char tv_str[20] = ""; long delta_t;
 #define START_TIMER	gettimeofday(&tv1, NULL)
 #define END_TIMER	gettimeofday(&tv2, NULL); \
@@ -71,4 +74,78 @@ extern void slurm_diff_tv_str(struct timeval *tv1,struct timeval *tv2,
 			      char *tv_str, int len_tv_str, const char *from,
 			      long limit, long *delta_t);
 
+/*
+ * Structured phase tracing. When enabled (DebugFlags=PhaseTrace in the
+ * controller), PHASE_TRACE_BEGIN/END record compact begin/end events
+ * for named hot path phases into ring buffers sharded by thread, which
+ * can later be dumped for offline timeline analysis. When disabled the
+ * macros cost one predicted branch.
+ */
+typedef enum {
+	PHASE_TRACE_NONE = 0,
+	PHASE_TRACE_SELECT_NODES,	/* job to node resource selection */
+	PHASE_TRACE_SCHED_CYCLE,	/* main scheduling cycle */
+	PHASE_TRACE_BF_CYCLE,		/* backfill scheduling cycle */
+	PHASE_TRACE_BF_TRY_SCHED,	/* backfill per-job placement test */
+	PHASE_TRACE_PACK_JOB_INFO,	/* job info dump for squeue etc. */
+	PHASE_TRACE_PACK_NODE_INFO,	/* node info dump for sinfo etc. */
+	PHASE_TRACE_DBD_AGENT_SEND,	/* slurmdbd agent message send */
+	PHASE_TRACE_CNT
+} phase_trace_id_t;
+
+extern bool phase_trace_on;
+
+/* Record one phase begin or end event, use the macros below instead */
+extern void phase_trace_event(phase_trace_id_t phase, bool begin);
+
+/* Enable or disable event recording, allocating or keeping the buffers */
+extern void phase_trace_set(bool enable);
+
+/*
+ * Write all recorded events to the given file as text lines of
+ * "<usec since epoch> <thread> <phase> B|E" and release the buffers.
+ * Returns a Slurm errno.
+ */
+extern int phase_trace_dump(const char *path);
+
+#define PHASE_TRACE_BEGIN(phase) do {		\
+	if (phase_trace_on)			\
+		phase_trace_event(phase, true);	\
+} while (0)
+#define PHASE_TRACE_END(phase) do {		\
+	if (phase_trace_on)			\
+		phase_trace_event(phase, false);\
+} while (0)
+
+/*
+ * Internal queue telemetry. Long lived work queues (agent retry list,
+ * pending mail, slurmdbd agent queue, state save requests, triggers)
+ * register a name plus callbacks reporting their current depth and the
+ * time the head element was queued, and count enqueue/dequeue events.
+ * The aggregate is packed into the sdiag statistics response; rates
+ * follow from the counter difference between two polls, and the age of
+ * the queue head is the earliest warning of a daemon failing to drain.
+ */
+#define QUEUE_STATS_MAX 16
+
+typedef int (*queue_stats_depth_f)(void);
+typedef time_t (*queue_stats_head_f)(void);
+
+/*
+ * Register a queue. The name must outlive the process (a literal);
+ * either callback may be NULL when the queue cannot report that value.
+ * RET a queue id for the event counters, or -1 if the table is full
+ */
+extern int queue_stats_register(const char *name,
+				queue_stats_depth_f depth_cb,
+				queue_stats_head_f head_cb);
+
+/* Count one element added to or removed from a registered queue,
+ * a negative qid is ignored */
+extern void queue_stats_enqueued(int qid);
+extern void queue_stats_dequeued(int qid);
+
+/* Pack all registered queues for the sdiag statistics response */
+extern void queue_stats_pack(Buf buffer);
+
 #endif
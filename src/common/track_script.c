@@ -42,7 +42,25 @@
 #include "src/common/list.h"
 #include "src/common/track_script.h"
 
-static List track_script_thd_list = NULL;
+/*
+ * Tracked scripts are sharded by the launcher's thread id. Each script is
+ * reaped by its own launcher thread, so completion is already event driven;
+ * sharding keeps concurrent add/remove/reset operations from contending on
+ * a single list lock.
+ */
+#define TRACK_SCRIPT_SHARDS 16
+
+static List track_script_thd_list[TRACK_SCRIPT_SHARDS] = {NULL};
+
+static int _shard_index(pthread_t tid)
+{
+	size_t h = (size_t) tid;
+
+	/* Thread handles are aligned pointers on many systems, fold in the
+	 * high bits so the shards spread over more than the alignment */
+	h ^= (h >> 12);
+	return (int)(h % TRACK_SCRIPT_SHARDS);
+}
 
 static void _track_script_rec_destroy(void *arg)
 {
@@ -152,28 +170,45 @@ static int _reset_cpid(void *object, void *key)
 
 extern void track_script_init(void)
 {
-	FREE_NULL_LIST(track_script_thd_list);
-	track_script_thd_list = list_create(_track_script_rec_destroy);
+	int i;
+
+	for (i = 0; i < TRACK_SCRIPT_SHARDS; i++) {
+		FREE_NULL_LIST(track_script_thd_list[i]);
+		track_script_thd_list[i] =
+			list_create(_track_script_rec_destroy);
+	}
 }
 
 extern void track_script_flush(void)
 {
+	int i;
+
 	/* kill all scripts we are tracking */
-	(void) list_for_each(track_script_thd_list,
-			     (ListForF)_track_script_rec_cleanup, NULL);
-	(void) list_flush(track_script_thd_list);
+	for (i = 0; i < TRACK_SCRIPT_SHARDS; i++) {
+		(void) list_for_each(track_script_thd_list[i],
+				     (ListForF)_track_script_rec_cleanup,
+				     NULL);
+		(void) list_flush(track_script_thd_list[i]);
+	}
 }
 
 extern void track_script_flush_job(uint32_t job_id)
 {
-	(void)list_for_each(track_script_thd_list,
-			    (ListFindF) _flush_job,
-			    &job_id);
+	int i;
+
+	for (i = 0; i < TRACK_SCRIPT_SHARDS; i++) {
+		(void)list_for_each(track_script_thd_list[i],
+				    (ListFindF) _flush_job,
+				    &job_id);
+	}
 }
 
 extern void track_script_fini(void)
 {
-	FREE_NULL_LIST(track_script_thd_list);
+	int i;
+
+	for (i = 0; i < TRACK_SCRIPT_SHARDS; i++)
+		FREE_NULL_LIST(track_script_thd_list[i]);
 }
 
 extern track_script_rec_t *track_script_rec_add(
@@ -187,7 +222,8 @@ extern track_script_rec_t *track_script_rec_add(
 	track_script_rec->tid = tid;
 	slurm_mutex_init(&track_script_rec->timer_mutex);
 	slurm_cond_init(&track_script_rec->timer_cond, NULL);
-	list_append(track_script_thd_list, track_script_rec);
+	list_append(track_script_thd_list[_shard_index(tid)],
+		    track_script_rec);
 
 	return track_script_rec;
 }
@@ -212,7 +248,8 @@ extern bool track_script_broadcast(track_script_rec_t *track_script_rec,
 /* Remove this job from the list of jobs currently running a script */
 extern void track_script_remove(pthread_t tid)
 {
-	if (!list_delete_all(track_script_thd_list, _match_tid, &tid))
+	if (!list_delete_all(track_script_thd_list[_shard_index(tid)],
+			     _match_tid, &tid))
 		error("%s: thread %lu not found", __func__, tid);
 	else
 		debug2("%s: thread running script from job removed",
@@ -225,5 +262,6 @@ extern void track_script_reset_cpid(pthread_t tid, pid_t cpid)
 	tmp_rec.tid = tid;
 	tmp_rec.cpid = cpid;
 
-	(void)list_for_each(track_script_thd_list, _reset_cpid, &tmp_rec);
+	(void)list_for_each(track_script_thd_list[_shard_index(tid)],
+			    _reset_cpid, &tmp_rec);
 }
@@ -39,6 +39,7 @@
 
 #define _GNU_SOURCE
 
+#include <fcntl.h>
 #include <stdlib.h>
 #include <pwd.h>
 #include <grp.h>
@@ -46,23 +47,42 @@
 #include <errno.h>
 #include <limits.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "slurm/slurm_errno.h"
 
 #include "src/common/macros.h"
+#include "src/common/pack.h"
 #include "src/common/uid.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
+/* how long a cached uid -> name translation is trusted */
+#define UID_CACHE_TTL 3600
+
+/* private header for the uid_cache_state file, bump on format changes */
+#define UID_CACHE_STATE_VERSION 1
+
 typedef struct {
     uid_t uid;
     char *username;
+    time_t expiration;
+    bool refreshing;		/* background refresh in flight */
 } uid_cache_entry_t;
 
 static pthread_mutex_t uid_lock = PTHREAD_MUTEX_INITIALIZER;
 static uid_cache_entry_t *uid_cache = NULL;
 static int uid_cache_used = 0;
 
+/*
+ * uid_to_string_cached() hands out pointers into the cache without any
+ * reference counting, so a username replaced by a refresh cannot be
+ * freed while a caller may still hold it. Park the old strings here and
+ * release them in uid_cache_clear().
+ */
+static char **retired_names = NULL;
+static int retired_cnt = 0;
+
 static int _getpwnam_r (const char *name, struct passwd *pwd, char *buf,
 		size_t bufsiz, struct passwd **result)
 {
@@ -185,30 +205,292 @@ extern void uid_cache_clear(void)
 		xfree(uid_cache[i].username);
 	xfree(uid_cache);
 	uid_cache_used = 0;
+	for (i = 0; i < retired_cnt; i++)
+		xfree(retired_names[i]);
+	xfree(retired_names);
+	retired_cnt = 0;
+	slurm_mutex_unlock(&uid_lock);
+}
+
+/* Must hold uid_lock. Insert a new entry keeping the cache sorted. */
+static uid_cache_entry_t *_uid_cache_insert(uid_t uid, char *username,
+					    time_t expiration)
+{
+	uid_cache_entry_t target = {uid, NULL, 0, false};
+
+	uid_cache_used++;
+	uid_cache = xrealloc(uid_cache,
+			     sizeof(uid_cache_entry_t) * uid_cache_used);
+	uid_cache[uid_cache_used - 1].uid = uid;
+	uid_cache[uid_cache_used - 1].username = username;
+	uid_cache[uid_cache_used - 1].expiration = expiration;
+	uid_cache[uid_cache_used - 1].refreshing = false;
+	qsort(uid_cache, uid_cache_used, sizeof(uid_cache_entry_t),
+	      _uid_compare);
+
+	return bsearch(&target, uid_cache, uid_cache_used,
+		       sizeof(uid_cache_entry_t), _uid_compare);
+}
+
+/*
+ * Re-resolve one expired entry in the background while the stale name
+ * keeps being served, keeping the name service off the lookup path.
+ */
+static void *_uid_refresh_thread(void *x)
+{
+	uid_t uid = *(uid_t *) x;
+	uid_cache_entry_t *entry;
+	uid_cache_entry_t target = {uid, NULL, 0, false};
+	char *username;
+
+	xfree(x);
+	username = uid_to_string(uid);
+
+	slurm_mutex_lock(&uid_lock);
+	entry = bsearch(&target, uid_cache, uid_cache_used,
+			sizeof(uid_cache_entry_t), _uid_compare);
+	if (entry) {
+		if (xstrcmp(entry->username, username)) {
+			/* retire the old string, a caller may hold it */
+			retired_cnt++;
+			retired_names = xrealloc(retired_names,
+						 sizeof(char *) * retired_cnt);
+			retired_names[retired_cnt - 1] = entry->username;
+			entry->username = username;
+			username = NULL;
+		}
+		entry->expiration = time(NULL) + UID_CACHE_TTL;
+		entry->refreshing = false;
+	}
 	slurm_mutex_unlock(&uid_lock);
+
+	xfree(username);
+	return NULL;
 }
 
 extern char *uid_to_string_cached(uid_t uid)
 {
 	uid_cache_entry_t *entry;
-	uid_cache_entry_t target = {uid, NULL};
+	uid_cache_entry_t target = {uid, NULL, 0, false};
+	char *username;
+	time_t now = time(NULL);
 
 	slurm_mutex_lock(&uid_lock);
 	entry = bsearch(&target, uid_cache, uid_cache_used,
 			sizeof(uid_cache_entry_t), _uid_compare);
-	if (entry == NULL) {
-		uid_cache_entry_t new_entry = {uid, uid_to_string(uid)};
-		uid_cache_used++;
-		uid_cache = xrealloc(uid_cache,
-				     sizeof(uid_cache_entry_t)*uid_cache_used);
-		uid_cache[uid_cache_used-1] = new_entry;
-		qsort(uid_cache, uid_cache_used, sizeof(uid_cache_entry_t),
-		      _uid_compare);
+	if (entry) {
+		username = entry->username;
+		if ((entry->expiration <= now) && !entry->refreshing) {
+			uid_t *refresh_uid = xmalloc(sizeof(uid_t));
+			*refresh_uid = uid;
+			entry->refreshing = true;
+			slurm_mutex_unlock(&uid_lock);
+			slurm_thread_create_detached(NULL, _uid_refresh_thread,
+						     refresh_uid);
+			return username;
+		}
 		slurm_mutex_unlock(&uid_lock);
-		return new_entry.username;
+		return username;
 	}
+
+	/*
+	 * Nothing cached yet, resolve with the lock dropped so a slow
+	 * name service only stalls lookups of this one uid.
+	 */
+	slurm_mutex_unlock(&uid_lock);
+	username = uid_to_string(uid);
+	slurm_mutex_lock(&uid_lock);
+
+	entry = bsearch(&target, uid_cache, uid_cache_used,
+			sizeof(uid_cache_entry_t), _uid_compare);
+	if (entry)	/* lost the race to another lookup, keep theirs */
+		xfree(username);
+	else
+		entry = _uid_cache_insert(uid, username,
+					  now + UID_CACHE_TTL);
+	username = entry->username;
 	slurm_mutex_unlock(&uid_lock);
-	return entry->username;
+	return username;
+}
+
+typedef struct {
+	uid_t *uids;
+	int uid_cnt;
+} uid_warm_args_t;
+
+static void *_uid_warm_thread(void *x)
+{
+	uid_warm_args_t *args = x;
+
+	for (int i = 0; i < args->uid_cnt; i++)
+		(void) uid_to_string_cached(args->uids[i]);
+
+	xfree(args->uids);
+	xfree(args);
+	return NULL;
+}
+
+/*
+ * Resolve a batch of uids into the cache from one background thread so
+ * later uid_to_string_cached() calls are hits.
+ * IN: uids - xmalloc'd array, ownership is taken here
+ * IN: uid_cnt - number of elements in uids
+ */
+extern void uid_cache_warm(uid_t *uids, int uid_cnt)
+{
+	uid_warm_args_t *args;
+
+	if (!uids || (uid_cnt <= 0)) {
+		xfree(uids);
+		return;
+	}
+
+	args = xmalloc(sizeof(*args));
+	args->uids = uids;
+	args->uid_cnt = uid_cnt;
+	slurm_thread_create_detached(NULL, _uid_warm_thread, args);
+}
+
+/*
+ * Write the uid cache to a "uid_cache_state" file in state_save_location
+ * so a restarted daemon does not have to re-resolve every user.
+ */
+extern int uid_cache_state_save(const char *state_save_location)
+{
+	int error_code = SLURM_SUCCESS, log_fd, i;
+	char *old_file = NULL, *new_file = NULL, *reg_file = NULL;
+	Buf buffer;
+
+	if (!state_save_location)
+		return SLURM_ERROR;
+
+	buffer = init_buf(BUF_SIZE);
+	pack16(UID_CACHE_STATE_VERSION, buffer);
+	pack_time(time(NULL), buffer);
+
+	slurm_mutex_lock(&uid_lock);
+	pack32((uint32_t) uid_cache_used, buffer);
+	for (i = 0; i < uid_cache_used; i++) {
+		pack32((uint32_t) uid_cache[i].uid, buffer);
+		packstr(uid_cache[i].username, buffer);
+	}
+	slurm_mutex_unlock(&uid_lock);
+
+	reg_file = xstrdup_printf("%s/uid_cache_state", state_save_location);
+	old_file = xstrdup_printf("%s.old", reg_file);
+	new_file = xstrdup_printf("%s.new", reg_file);
+
+	log_fd = creat(new_file, 0600);
+	if (log_fd < 0) {
+		error("Can't save state, create file %s error %m", new_file);
+		error_code = errno;
+	} else {
+		int pos = 0, nwrite = get_buf_offset(buffer), amount;
+		char *data = (char *) get_buf_data(buffer);
+		while (nwrite > 0) {
+			amount = write(log_fd, &data[pos], nwrite);
+			if ((amount < 0) && (errno != EINTR)) {
+				error("Error writing file %s, %m", new_file);
+				error_code = errno;
+				break;
+			}
+			nwrite -= amount;
+			pos    += amount;
+		}
+		fsync(log_fd);
+		close(log_fd);
+	}
+	if (error_code)
+		(void) unlink(new_file);
+	else {			/* file shuffle */
+		(void) unlink(old_file);
+		if (link(reg_file, old_file))
+			debug4("unable to create link for %s -> %s: %m",
+			       reg_file, old_file);
+		(void) unlink(reg_file);
+		if (link(new_file, reg_file))
+			debug4("unable to create link for %s -> %s: %m",
+			       new_file, reg_file);
+		(void) unlink(new_file);
+	}
+	xfree(old_file);
+	xfree(reg_file);
+	xfree(new_file);
+
+	free_buf(buffer);
+	return error_code;
+}
+
+/*
+ * Reload a previously saved uid cache. Restored entries are inserted
+ * already expired: lookups serve them immediately, and the first use of
+ * each uid triggers a background refresh in case the name changed while
+ * the daemon was down.
+ */
+extern int uid_cache_state_restore(const char *state_save_location)
+{
+	char *state_file, *username = NULL;
+	Buf buffer;
+	time_t buf_time;
+	uint16_t ver = 0;
+	uint32_t cnt = 0, uid = 0, tmp32, i;
+	bool locked = false;
+
+	if (!state_save_location)
+		return SLURM_ERROR;
+
+	state_file = xstrdup_printf("%s/uid_cache_state",
+				    state_save_location);
+	if (!(buffer = create_mmap_buf(state_file))) {
+		debug2("No uid cache file (%s) to recover", state_file);
+		xfree(state_file);
+		return ENOENT;
+	}
+	xfree(state_file);
+
+	safe_unpack16(&ver, buffer);
+	if (ver != UID_CACHE_STATE_VERSION) {
+		/* just a cache, quietly start cold on a format change */
+		debug("Not recovering uid cache, version %hu need %d",
+		      ver, UID_CACHE_STATE_VERSION);
+		free_buf(buffer);
+		return EFAULT;
+	}
+	safe_unpack_time(&buf_time, buffer);
+
+	safe_unpack32(&cnt, buffer);
+	slurm_mutex_lock(&uid_lock);
+	locked = true;
+	for (i = 0; i < cnt; i++) {
+		uid_cache_entry_t target;
+
+		safe_unpack32(&uid, buffer);
+		safe_unpackstr_xmalloc(&username, &tmp32, buffer);
+		if (!username)
+			continue;
+
+		target.uid = (uid_t) uid;
+		if (bsearch(&target, uid_cache, uid_cache_used,
+			    sizeof(uid_cache_entry_t), _uid_compare)) {
+			xfree(username);	/* already resolved */
+			continue;
+		}
+		(void) _uid_cache_insert((uid_t) uid, username, (time_t) 0);
+		username = NULL;
+	}
+	slurm_mutex_unlock(&uid_lock);
+
+	debug2("Recovered %u cached uid translations", cnt);
+	free_buf(buffer);
+	return SLURM_SUCCESS;
+
+unpack_error:
+	error("Incomplete uid cache state file");
+	xfree(username);
+	if (locked)
+		slurm_mutex_unlock(&uid_lock);
+	free_buf(buffer);
+	return SLURM_ERROR;
 }
 
 gid_t
@@ -96,10 +96,27 @@ extern void uid_cache_clear(void);
 
 /*
  * Translate uid to user name, using a cache.
+ * Entries expire after an hour and are refreshed in the background while
+ * the old name keeps being served, so the name service stays off this path.
  * Call uid_cache_clear() to free memory.
  */
 extern char *uid_to_string_cached(uid_t uid);
 
+/*
+ * Resolve a batch of uids into the uid_to_string_cached() cache from one
+ * background thread.
+ * IN: uids - xmalloc'd array, ownership is taken here
+ * IN: uid_cnt - number of elements in uids
+ */
+extern void uid_cache_warm(uid_t *uids, int uid_cnt);
+
+/*
+ * Save/reload the uid cache to/from a "uid_cache_state" file in the
+ * given state save directory.
+ */
+extern int uid_cache_state_save(const char *state_save_location);
+extern int uid_cache_state_restore(const char *state_save_location);
+
 /*
  * Same as uid_to_string, but for group name.
  * NOTE: xfree the return value
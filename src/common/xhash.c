@@ -33,72 +33,187 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <string.h>
+
 #include "src/common/xhash.h"
+#include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
-#include "src/common/uthash/uthash.h"
-
-#if 0
-/* undefine default allocators */
-#undef uthash_malloc
-#undef uthash_free
-
-/* re-define them using slurm's ones */
-#define uthash_malloc(sz) xmalloc(sz)
-#define uthash_free(ptr, sz) xfree(ptr)
-#endif
 
 /*
- * FIXME:
- * A pre-malloced array of xhash_item_t could be associated to
- * the xhash_table in order to speed up the xhash_add function.
- * The default array size could be something like 10% of the
- * provided table_size (hash table are commonly defined larger
- * than necessary to avoid shared keys and usage of linked list)
+ * Robin hood open addressing table.  All entries live in one bulk
+ * allocated slot array, so a lookup usually touches one or two cache
+ * lines instead of chasing per-entry heap allocations, and adding an
+ * item costs no allocation at all until the table has to grow.  Probe
+ * sequences are kept short by letting an inserted entry displace any
+ * resident entry that sits closer to its home slot ("stealing from the
+ * rich"), and removal shifts the following displaced entries backward
+ * rather than leaving tombstones.
+ *
+ * Keys are not stored; as before they are recomputed from the user
+ * items via the identify callback when a full comparison is needed,
+ * which the stored 32 bit hash makes rare.
  */
 
-typedef struct xhash_item_st {
-	void*		item;    /* user item                               */
-	UT_hash_handle	hh;      /* make this structure hashable by uthash  */
-} xhash_item_t;
+typedef struct xhash_slot_st {
+	void*		item;    /* user item, NULL for an empty slot       */
+	uint32_t	hash;    /* full hash of the item's key             */
+} xhash_slot_t;
 
 struct xhash_st {
 	uint32_t		count;    /* user items count                */
+	uint32_t		size;     /* slots allocated, power of two   */
 	xhash_freefunc_t	freefunc; /* function used to free items     */
-	xhash_item_t*		ht;       /* hash table                      */
+	xhash_slot_t*		slots;    /* bulk allocated slot array       */
 	xhash_idfunc_t		identify; /* function returning a unique str
 					     key */
 };
 
+#define XHASH_INITIAL_SIZE 64	/* must be a power of two */
+
+/* FNV-1a, fast and good enough for short text keys */
+static uint32_t _hash_key(const char* key, uint32_t len)
+{
+	uint32_t hash = 2166136261u;
+
+	while (len--) {
+		hash ^= (unsigned char)*key++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* distance of the slot at [inx] from the home slot of [hash] */
+#define _slot_distance(table, inx, hash) \
+	(((inx) - (hash)) & ((table)->size - 1))
+
+/* find the slot holding [key], or -1 if not present */
+static int64_t _find_slot(xhash_t* table, const char* key, uint32_t len,
+			  uint32_t hash)
+{
+	uint32_t mask = table->size - 1;
+	uint32_t inx = hash & mask;
+	uint32_t dist = 0;
+
+	while (1) {
+		xhash_slot_t* slot = &table->slots[inx];
+
+		if (!slot->item)
+			return -1;
+		/*
+		 * Robin hood invariant: an entry this far into its probe
+		 * sequence would have displaced this better placed slot,
+		 * so the key cannot be further along.
+		 */
+		if (_slot_distance(table, inx, slot->hash) < dist)
+			return -1;
+		if (slot->hash == hash) {
+			const char* ikey = NULL;
+			uint32_t ilen = 0;
+
+			table->identify(slot->item, &ikey, &ilen);
+			if ((ilen == len) && (memcmp(ikey, key, len) == 0))
+				return inx;
+		}
+		inx = (inx + 1) & mask;
+		++dist;
+	}
+}
+
+/* place [item] into a table known to have a free slot */
+static void _insert(xhash_t* table, void* item, uint32_t hash)
+{
+	uint32_t mask = table->size - 1;
+	uint32_t inx = hash & mask;
+	uint32_t dist = 0;
+
+	while (1) {
+		xhash_slot_t* slot = &table->slots[inx];
+		uint32_t slot_dist;
+
+		if (!slot->item) {
+			slot->item = item;
+			slot->hash = hash;
+			return;
+		}
+		slot_dist = _slot_distance(table, inx, slot->hash);
+		if (slot_dist < dist) {
+			/* displace the better placed entry, carry it on */
+			void* titem = slot->item;
+			uint32_t thash = slot->hash;
+
+			slot->item = item;
+			slot->hash = hash;
+			item = titem;
+			hash = thash;
+			dist = slot_dist;
+		}
+		inx = (inx + 1) & mask;
+		++dist;
+	}
+}
+
+/* grow the slot array, or allocate it on first use */
+static void _grow(xhash_t* table)
+{
+	xhash_slot_t* old_slots = table->slots;
+	uint32_t old_size = table->size;
+	uint32_t i;
+
+	if (old_size)
+		table->size = old_size * 2;
+	else
+		table->size = XHASH_INITIAL_SIZE;
+	table->slots = xcalloc(table->size, sizeof(xhash_slot_t));
+
+	for (i = 0; i < old_size; ++i) {
+		if (old_slots[i].item)
+			_insert(table, old_slots[i].item, old_slots[i].hash);
+	}
+	xfree(old_slots);
+}
+
+/* empty the slot at [inx], backward shifting any displaced followers */
+static void _remove_slot(xhash_t* table, uint32_t inx)
+{
+	uint32_t mask = table->size - 1;
+
+	while (1) {
+		uint32_t next = (inx + 1) & mask;
+		xhash_slot_t* nslot = &table->slots[next];
+
+		if (!nslot->item ||
+		    (_slot_distance(table, next, nslot->hash) == 0)) {
+			table->slots[inx].item = NULL;
+			return;
+		}
+		table->slots[inx] = *nslot;
+		inx = next;
+	}
+}
+
 xhash_t *xhash_init(xhash_idfunc_t idfunc, xhash_freefunc_t freefunc)
 {
 	xhash_t* table = NULL;
 	if (!idfunc)
 		return NULL;
 	table = xmalloc(sizeof(xhash_t));
-	table->ht = NULL; /* required by uthash */
 	table->count = 0;
 	table->identify = idfunc;
 	table->freefunc = freefunc;
 	return table;
 }
 
-static xhash_item_t* xhash_find(xhash_t* table, const char* key, uint32_t len)
+void* xhash_get(xhash_t* table, const char* key, uint32_t key_len)
 {
-	xhash_item_t* hash_item = NULL;
+	int64_t inx;
 
-	if (!table || !key)
+	if (!table || !key || !table->count)
 		return NULL;
-	HASH_FIND(hh, table->ht, key, len, hash_item);
-	return hash_item;
-}
-
-void* xhash_get(xhash_t* table, const char* key, uint32_t key_len)
-{
-	xhash_item_t* item = xhash_find(table, key, key_len);
-	if (!item)
+	inx = _find_slot(table, key, key_len, _hash_key(key, key_len));
+	if (inx < 0)
 		return NULL;
-	return item->item;
+	return table->slots[inx].item;
 }
 
 void* xhash_get_str(xhash_t* table, const char* key)
@@ -108,29 +223,32 @@ void* xhash_get_str(xhash_t* table, const char* key)
 
 void* xhash_add(xhash_t* table, void* item)
 {
-	xhash_item_t* hash_item = NULL;
 	const char *key = NULL;
 	uint32_t keylen = 0;
 
 	if (!table || !item)
 		return NULL;
-	hash_item = xmalloc(sizeof(xhash_item_t));
-	hash_item->item    = item;
+	/* grow at 3/4 load to keep probe sequences short */
+	if (((table->count + 1) * 4) > (table->size * 3))
+		_grow(table);
 	table->identify(item, &key, &keylen);
-	HASH_ADD_KEYPTR(hh, table->ht, key, keylen, hash_item);
+	_insert(table, item, _hash_key(key, keylen));
 	++table->count;
-	return hash_item->item;
+	return item;
 }
 
 void* xhash_pop(xhash_t* table, const char* key, uint32_t len)
 {
 	void* item_item;
-	xhash_item_t* item = xhash_find(table, key, len);
-	if (!item)
+	int64_t inx;
+
+	if (!table || !key || !table->count)
 		return NULL;
-	item_item = item->item;
-	HASH_DELETE(hh, table->ht, item);
-	xfree(item);
+	inx = _find_slot(table, key, len, _hash_key(key, len));
+	if (inx < 0)
+		return NULL;
+	item_item = table->slots[inx].item;
+	_remove_slot(table, inx);
 	--table->count;
 	return item_item;
 }
@@ -165,27 +283,29 @@ void xhash_walk(xhash_t* table,
 		void (*callback)(void* item, void* arg),
 		void* arg)
 {
-	xhash_item_t* current_item = NULL;
-	xhash_item_t* tmp = NULL;
+	uint32_t i;
+
 	if (!table || !callback)
 		return;
-	HASH_ITER(hh, table->ht, current_item, tmp) {
-		  callback(current_item->item, arg);
+	/* the callback must not add or remove items from the table */
+	for (i = 0; i < table->size; ++i) {
+		if (table->slots[i].item)
+			callback(table->slots[i].item, arg);
 	}
 }
 
 void xhash_clear(xhash_t* table)
 {
-	xhash_item_t* current_item = NULL;
-	xhash_item_t* tmp = NULL;
+	uint32_t i;
 
 	if (!table)
 		return;
-	HASH_ITER(hh, table->ht, current_item, tmp) {
-		  HASH_DEL(table->ht, current_item);
-		  if (table->freefunc)
-			  table->freefunc(current_item->item);
-		  xfree(current_item);
+	for (i = 0; i < table->size; ++i) {
+		if (!table->slots[i].item)
+			continue;
+		if (table->freefunc)
+			table->freefunc(table->slots[i].item);
+		table->slots[i].item = NULL;
 	}
 
 	table->count = 0;
@@ -196,5 +316,6 @@ void xhash_free_ptr(xhash_t** table)
 	if (!table || !*table)
 		return;
 	xhash_clear(*table);
+	xfree((*table)->slots);
 	xfree(*table);
 }
@@ -42,6 +42,7 @@
 #include "config.h"
 
 #include <errno.h>
+#include <inttypes.h>
 #include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -66,6 +67,161 @@ static void malloc_assert_failed(char *, const char *, int,
 
 #define XMALLOC_MAGIC 0x42
 
+/*
+ * Allocation headers carry the magic cookie and the user size. With
+ * allocation accounting compiled in (-DXMALLOC_STATS in CFLAGS) two
+ * more words hold the callsite table index and pad, preserving 16 byte
+ * alignment of the returned pointer. The option changes the layout of
+ * every allocation, so it must be set for the whole build including
+ * plugins.
+ */
+#ifdef XMALLOC_STATS
+#  define XMALLOC_HDR_WORDS 4
+#else
+#  define XMALLOC_HDR_WORDS 2
+#endif
+
+#ifdef XMALLOC_STATS
+/*
+ * Per-callsite allocation accounting. Sites are identified by the
+ * file/line already passed to every allocator entry point; the table
+ * is open addressed and append-only. A single mutex serializes the
+ * counter updates; this is an opt-in diagnostic build and the cost is
+ * accepted in exchange for exact live/peak byte counts per callsite.
+ */
+#define XSTATS_SITES 1024
+
+typedef struct {
+	const char *file;
+	int line;
+	const char *func;
+	uint64_t allocs;
+	uint64_t frees;
+	uint64_t bytes_alloced;
+	uint64_t bytes_freed;
+	uint64_t bytes_live;
+	uint64_t bytes_peak;
+} xstats_site_t;
+
+static xstats_site_t xstats_sites[XSTATS_SITES];
+static pthread_mutex_t xstats_lock = PTHREAD_MUTEX_INITIALIZER;
+/* allocations made after the site table filled up */
+static uint64_t xstats_lost_allocs = 0;
+static uint64_t xstats_lost_bytes = 0;
+
+/* Find or claim the table slot for a callsite.
+ * Caller must hold xstats_lock. Returns XSTATS_SITES if full. */
+static size_t _xstats_site(const char *file, int line, const char *func)
+{
+	size_t h, i;
+
+	h = ((((uintptr_t) file) >> 4) ^ ((size_t) line * 2654435761UL)) %
+	    XSTATS_SITES;
+	for (i = 0; i < XSTATS_SITES; i++) {
+		xstats_site_t *site = &xstats_sites[(h + i) % XSTATS_SITES];
+
+		if ((site->file == file) && (site->line == line))
+			return (h + i) % XSTATS_SITES;
+		if (!site->file) {
+			site->file = file;
+			site->line = line;
+			site->func = func;
+			return (h + i) % XSTATS_SITES;
+		}
+	}
+	return XSTATS_SITES;
+}
+
+static size_t _xstats_alloc(const char *file, int line, const char *func,
+			    size_t size)
+{
+	size_t inx;
+
+	slurm_mutex_lock(&xstats_lock);
+	inx = _xstats_site(file, line, func);
+	if (inx < XSTATS_SITES) {
+		xstats_site_t *site = &xstats_sites[inx];
+
+		site->allocs++;
+		site->bytes_alloced += size;
+		site->bytes_live += size;
+		if (site->bytes_live > site->bytes_peak)
+			site->bytes_peak = site->bytes_live;
+	} else {
+		xstats_lost_allocs++;
+		xstats_lost_bytes += size;
+	}
+	slurm_mutex_unlock(&xstats_lock);
+	return inx;
+}
+
+static void _xstats_free(size_t inx, size_t size)
+{
+	if (inx >= XSTATS_SITES)
+		return;
+	slurm_mutex_lock(&xstats_lock);
+	xstats_sites[inx].frees++;
+	xstats_sites[inx].bytes_freed += size;
+	xstats_sites[inx].bytes_live -= size;
+	slurm_mutex_unlock(&xstats_lock);
+}
+
+/* A grown or shrunk allocation stays attributed to its original site */
+static void _xstats_resize(size_t inx, size_t old_size, size_t new_size)
+{
+	xstats_site_t *site;
+
+	if (inx >= XSTATS_SITES)
+		return;
+	slurm_mutex_lock(&xstats_lock);
+	site = &xstats_sites[inx];
+	site->bytes_alloced += new_size;
+	site->bytes_freed += old_size;
+	site->bytes_live += new_size - old_size;
+	if (site->bytes_live > site->bytes_peak)
+		site->bytes_peak = site->bytes_live;
+	slurm_mutex_unlock(&xstats_lock);
+}
+#endif /* XMALLOC_STATS */
+
+/*
+ * Log per-callsite allocation statistics, heaviest live sites first
+ * worth reading. No-op message if accounting is not compiled in.
+ */
+extern void xmalloc_stats_log(void)
+{
+#ifdef XMALLOC_STATS
+	uint64_t total_live = 0, total_allocs = 0;
+	int i;
+
+	slurm_mutex_lock(&xstats_lock);
+	for (i = 0; i < XSTATS_SITES; i++) {
+		xstats_site_t *site = &xstats_sites[i];
+
+		if (!site->file || !site->allocs)
+			continue;
+		total_live += site->bytes_live;
+		total_allocs += site->allocs;
+		info("xmalloc: %s:%d %s() allocs:%"PRIu64" frees:%"PRIu64
+		     " live:%"PRIu64" peak:%"PRIu64" total:%"PRIu64,
+		     site->file, site->line, site->func, site->allocs,
+		     site->frees, site->bytes_live, site->bytes_peak,
+		     site->bytes_alloced);
+	}
+	if (xstats_lost_allocs) {
+		info("xmalloc: site table full, %"PRIu64" allocs (%"PRIu64
+		     " bytes) untracked", xstats_lost_allocs,
+		     xstats_lost_bytes);
+	}
+	info("xmalloc: total allocs:%"PRIu64" live bytes:%"PRIu64,
+	     total_allocs, total_live);
+	slurm_mutex_unlock(&xstats_lock);
+#else
+	info("xmalloc: allocation accounting not compiled in, rebuild with "
+	     "-DXMALLOC_STATS in CFLAGS");
+#endif
+}
+
 /*
  * "Safe" version of malloc().
  *   size (IN)	number of bytes to malloc
@@ -99,7 +255,7 @@ void *slurm_xcalloc(size_t count, size_t size, bool clear, bool try,
 	}
 
 	count_size = count * size;
-	total_size = count_size + 2 * sizeof(size_t);
+	total_size = count_size + XMALLOC_HDR_WORDS * sizeof(size_t);
 
 	if (clear)
 		p = calloc(1, total_size);
@@ -115,8 +271,11 @@ void *slurm_xcalloc(size_t count, size_t size, bool clear, bool try,
 	}
 	p[0] = XMALLOC_MAGIC;	/* add "secret" magic cookie */
 	p[1] = count_size;	/* store size in buffer */
+#ifdef XMALLOC_STATS
+	p[2] = _xstats_alloc(file, line, func, count_size);
+#endif
 
-	return &p[2];
+	return &p[XMALLOC_HDR_WORDS];
 }
 
 /*
@@ -152,11 +311,11 @@ extern void * slurm_xrecalloc(void **item, size_t count, size_t size,
 		goto error;
 
 	count_size = count * size;
-	total_size = count_size + 2 * sizeof(size_t);
+	total_size = count_size + XMALLOC_HDR_WORDS * sizeof(size_t);
 
 	if (*item != NULL) {
 		size_t old_size;
-		p = (size_t *)*item - 2;
+		p = (size_t *)*item - XMALLOC_HDR_WORDS;
 
 		/* magic cookie still there? */
 		xmalloc_assert(p[0] == XMALLOC_MAGIC);
@@ -167,11 +326,15 @@ extern void * slurm_xrecalloc(void **item, size_t count, size_t size,
 			goto error;
 
 		if (old_size < count_size) {
-			char *p_new = (char *)(&p[2]) + old_size;
+			char *p_new = (char *)(&p[XMALLOC_HDR_WORDS]) +
+				      old_size;
 			if (clear)
 				memset(p_new, 0, (count_size - old_size));
 		}
 		xmalloc_assert(p[0] == XMALLOC_MAGIC);
+#ifdef XMALLOC_STATS
+		_xstats_resize(p[2], old_size, count_size);
+#endif
 	} else {
 		/* Initalize new memory */
 		if (clear)
@@ -181,10 +344,13 @@ extern void * slurm_xrecalloc(void **item, size_t count, size_t size,
 		if (p == NULL)
 			goto error;
 		p[0] = XMALLOC_MAGIC;
+#ifdef XMALLOC_STATS
+		p[2] = _xstats_alloc(file, line, func, count_size);
+#endif
 	}
 
 	p[1] = count_size;
-	*item = &p[2];
+	*item = &p[XMALLOC_HDR_WORDS];
 	return *item;
 
 error:
@@ -200,7 +366,7 @@ error:
  */
 size_t slurm_xsize(void *item, const char *file, int line, const char *func)
 {
-	size_t *p = (size_t *)item - 2;
+	size_t *p = (size_t *)item - XMALLOC_HDR_WORDS;
 	xmalloc_assert(item != NULL);
 	xmalloc_assert(p[0] == XMALLOC_MAGIC); /* CLANG false positive here */
 	return p[1];
@@ -214,15 +380,219 @@ size_t slurm_xsize(void *item, const char *file, int line, const char *func)
 void slurm_xfree(void **item, const char *file, int line, const char *func)
 {
 	if (*item != NULL) {
-		size_t *p = (size_t *)*item - 2;
+		size_t *p = (size_t *)*item - XMALLOC_HDR_WORDS;
 		/* magic cookie still there? */
 		xmalloc_assert(p[0] == XMALLOC_MAGIC);
 		p[0] = 0;	/* make sure xfree isn't called twice */
+#ifdef XMALLOC_STATS
+		_xstats_free(p[2], p[1]);
+#endif
 		free(p);
 		*item = NULL;
 	}
 }
 
+/*
+ * Arena allocator for groups of allocations which are all released at
+ * once (e.g. the temporary objects built up while servicing one RPC or
+ * one scheduling pass).  Memory is carved sequentially out of large
+ * chunks, so each allocation is a pointer bump rather than a trip
+ * through the process allocator and its locks, and the whole group is
+ * returned with a single xarena_destroy().  Arena memory carries no
+ * per-allocation header and must never be passed to xfree().
+ */
+
+#define XARENA_CHUNK_SIZE	(64 * 1024)
+/* sufficient alignment for any object, matching malloc() */
+#define XARENA_ALIGN		16
+
+typedef struct xarena_chunk {
+	struct xarena_chunk *next;	/* previously filled chunks */
+	size_t used;			/* bytes handed out so far */
+	size_t size;			/* usable bytes following header */
+} xarena_chunk_t;
+
+struct xarena {
+	xarena_chunk_t *chunks;		/* current chunk at list head */
+};
+
+xarena_t *slurm_xarena_create(const char *file, int line, const char *func)
+{
+	xarena_t *arena = calloc(1, sizeof(*arena));
+
+	if (!arena) {
+		log_oom(file, line, func);
+		abort();
+	}
+	return arena;
+}
+
+void *slurm_xarena_alloc(xarena_t *arena, size_t size,
+			 const char *file, int line, const char *func)
+{
+	xarena_chunk_t *chunk;
+	void *p;
+
+	xmalloc_assert(arena != NULL);
+	if (!size)
+		return NULL;
+
+	size = (size + XARENA_ALIGN - 1) & ~((size_t) XARENA_ALIGN - 1);
+	chunk = arena->chunks;
+	if (!chunk || ((chunk->size - chunk->used) < size)) {
+		size_t chunk_size = XARENA_CHUNK_SIZE;
+
+		if (chunk_size < size)
+			chunk_size = size;
+		chunk = malloc(sizeof(*chunk) + chunk_size);
+		if (!chunk) {
+			log_oom(file, line, func);
+			abort();
+		}
+		chunk->next = arena->chunks;
+		chunk->used = 0;
+		chunk->size = chunk_size;
+		arena->chunks = chunk;
+	}
+	p = (char *) (chunk + 1) + chunk->used;
+	chunk->used += size;
+	memset(p, 0, size);
+
+	return p;
+}
+
+void slurm_xarena_destroy(xarena_t *arena)
+{
+	xarena_chunk_t *chunk;
+
+	if (!arena)
+		return;
+	while ((chunk = arena->chunks)) {
+		arena->chunks = chunk->next;
+		free(chunk);
+	}
+	free(arena);
+}
+
+/*
+ * Deferred reclamation: xfree_deferred() hands a fully detached object
+ * graph and its destructor to a background reaper thread, so callers
+ * tearing down large structures (job records, the pre-reconfiguration
+ * node table) do not spend their lock hold time in free(). The reaper
+ * is started on first use and runs for the life of the process. After
+ * a fork() the child restarts its own reaper on the next call, which
+ * then also reclaims anything the child inherited queued.
+ */
+typedef struct xfree_deferred_item {
+	struct xfree_deferred_item *next;
+	void *item;
+	void (*destroy)(void *);
+} xfree_deferred_item_t;
+
+static pthread_mutex_t reaper_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  reaper_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  reaper_drain_cond = PTHREAD_COND_INITIALIZER;
+static xfree_deferred_item_t *reaper_queue = NULL;
+static bool reaper_running = false;
+static bool reaper_busy = false;
+static bool reaper_atforked = false;
+
+static void *_xfree_reaper(void *no_data)
+{
+	slurm_mutex_lock(&reaper_lock);
+	while (true) {
+		xfree_deferred_item_t *ent = reaper_queue;
+
+		if (!ent) {
+			slurm_cond_broadcast(&reaper_drain_cond);
+			slurm_cond_wait(&reaper_cond, &reaper_lock);
+			continue;
+		}
+		reaper_queue = ent->next;
+		reaper_busy = true;
+		slurm_mutex_unlock(&reaper_lock);
+		if (ent->destroy)
+			ent->destroy(ent->item);
+		else
+			xfree(ent->item);
+		xfree(ent);
+		slurm_mutex_lock(&reaper_lock);
+		reaper_busy = false;
+	}
+	return NULL;		/* never reached */
+}
+
+static void _reaper_atfork_prep(void)   { slurm_mutex_lock(&reaper_lock); }
+static void _reaper_atfork_parent(void) { slurm_mutex_unlock(&reaper_lock); }
+static void _reaper_atfork_child(void)
+{
+	/* the reaper thread does not survive the fork */
+	reaper_running = false;
+	reaper_busy = false;
+	slurm_mutex_unlock(&reaper_lock);
+}
+
+/* Start the reaper thread. Callers must hold reaper_lock. */
+static void _reaper_start(void)
+{
+	pthread_attr_t attr;
+	pthread_t tid;
+
+	if (!reaper_atforked) {
+		pthread_atfork(_reaper_atfork_prep, _reaper_atfork_parent,
+			       _reaper_atfork_child);
+		reaper_atforked = true;
+	}
+	if (pthread_attr_init(&attr))
+		return;
+	if (!pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) &&
+	    !pthread_create(&tid, &attr, _xfree_reaper, NULL))
+		reaper_running = true;
+	pthread_attr_destroy(&attr);
+}
+
+extern void slurm_xfree_deferred(void **item, void (*destroy)(void *))
+{
+	xfree_deferred_item_t *ent;
+
+	if (!item || !*item)
+		return;
+
+	ent = xmalloc(sizeof(xfree_deferred_item_t));
+	ent->item = *item;
+	ent->destroy = destroy;
+	*item = NULL;
+
+	slurm_mutex_lock(&reaper_lock);
+	if (!reaper_running)
+		_reaper_start();
+	if (reaper_running) {
+		ent->next = reaper_queue;
+		reaper_queue = ent;
+		slurm_cond_signal(&reaper_cond);
+		slurm_mutex_unlock(&reaper_lock);
+		return;
+	}
+	slurm_mutex_unlock(&reaper_lock);
+
+	/* could not start the reaper; reclaim synchronously */
+	if (ent->destroy)
+		ent->destroy(ent->item);
+	else
+		xfree(ent->item);
+	xfree(ent);
+}
+
+extern void slurm_xfree_deferred_drain(void)
+{
+	slurm_mutex_lock(&reaper_lock);
+	if (reaper_queue && !reaper_running)
+		_reaper_start();
+	while (reaper_running && (reaper_queue || reaper_busy))
+		slurm_cond_wait(&reaper_drain_cond, &reaper_lock);
+	slurm_mutex_unlock(&reaper_lock);
+}
+
 #ifndef NDEBUG
 static void malloc_assert_failed(char *expr, const char *file,
 		                 int line, const char *caller, const char *func)
@@ -63,6 +63,13 @@
  * p. The memory must have been allocated with [try_]xmalloc() or
  * [try_]xrealloc().
  *
+ * xarena_create() allocates an arena for a group of allocations which
+ * are all released together. xarena_alloc(arena, size) returns size
+ * bytes of zeroed memory carved out of the arena with a pointer bump;
+ * there is no per-allocation free and the memory must never be passed
+ * to xfree(). xarena_destroy(arena) releases every allocation made
+ * from the arena along with the arena itself.
+ *
 \*****************************************************************************/
 
 #ifndef _XMALLOC_H
@@ -107,9 +114,49 @@
 #define xsize(__p) \
 	slurm_xsize((void *)__p, __FILE__, __LINE__, __func__)
 
+#define xarena_create() \
+	slurm_xarena_create(__FILE__, __LINE__, __func__)
+
+#define xarena_alloc(__a, __sz) \
+	slurm_xarena_alloc(__a, __sz, __FILE__, __LINE__, __func__)
+
+#define xarena_destroy(__a) \
+	slurm_xarena_destroy(__a)
+
+/*
+ * Hand a fully detached object graph to a background reaper thread and
+ * NULL the caller's pointer. The destroy function (or xfree() of the
+ * block itself if NULL) runs on the reaper, so large teardowns do not
+ * happen while the caller holds hot locks. The object must no longer
+ * be reachable by any other thread. xfree_deferred_drain() blocks
+ * until everything queued so far has been reclaimed; call it before
+ * unloading plugins whose code the destructors may run.
+ */
+#define xfree_deferred(__p, __destroy) \
+	slurm_xfree_deferred((void **)&(__p), __destroy)
+
+#define xfree_deferred_drain() \
+	slurm_xfree_deferred_drain()
+
+/* Opaque arena allocator type */
+typedef struct xarena xarena_t;
+
 void *slurm_xcalloc(size_t, size_t, bool, bool, const char *, int, const char *);
 void slurm_xfree(void **, const char *, int, const char *);
 void *slurm_xrecalloc(void **, size_t, size_t, bool, bool, const char *, int, const char *);
 size_t slurm_xsize(void *, const char *, int, const char *);
+xarena_t *slurm_xarena_create(const char *, int, const char *);
+void *slurm_xarena_alloc(xarena_t *, size_t, const char *, int, const char *);
+void slurm_xarena_destroy(xarena_t *);
+void slurm_xfree_deferred(void **, void (*)(void *));
+void slurm_xfree_deferred_drain(void);
+
+/*
+ * Log per-callsite allocation statistics (allocs, frees, live and
+ * peak bytes) when built with -DXMALLOC_STATS; otherwise logs that the
+ * accounting is not compiled in. The option adds two header words to
+ * every allocation and must be set for the entire build.
+ */
+void xmalloc_stats_log(void);
 
 #endif /* !_XMALLOC_H */
@@ -76,6 +76,11 @@ strong_alias(_xstrcatchar,	slurm_xstrcatchar);
 strong_alias(_xstrftimecat,	slurm_xstrftimecat);
 strong_alias(_xstrfmtcat,	slurm_xstrfmtcat);
 strong_alias(_xmemcat,		slurm_xmemcat);
+strong_alias(xstrbuf_cat,	slurm_xstrbuf_cat);
+strong_alias(xstrbuf_ncat,	slurm_xstrbuf_ncat);
+strong_alias(xstrbuf_fmtcat,	slurm_xstrbuf_fmtcat);
+strong_alias(xstrbuf_finish,	slurm_xstrbuf_finish);
+strong_alias(xstrbuf_free,	slurm_xstrbuf_free);
 strong_alias(xstrdup,		slurm_xstrdup);
 strong_alias(xstrdup_printf,	slurm_xstrdup_printf);
 strong_alias(xstrndup,		slurm_xstrndup);
@@ -283,6 +288,96 @@ int _xstrfmtcat(char **str, const char *fmt, ...)
 	return n;
 }
 
+/* grow the builder so at least needed more bytes plus NUL fit */
+static void _strbuf_makespace(xstrbuf_t *sb, size_t needed)
+{
+	size_t min_size = sb->len + needed + 1;
+
+	if (min_size <= sb->size)
+		return;
+	if (sb->size == 0)
+		sb->size = XFGETS_CHUNKSIZE;
+	while (sb->size < min_size)
+		sb->size *= 2;
+	xrealloc_nz(sb->buf, sb->size);
+}
+
+/*
+ * cat len bytes of str onto the builder
+ */
+void xstrbuf_ncat(xstrbuf_t *sb, const char *str, size_t len)
+{
+	_strbuf_makespace(sb, len);
+	memcpy(sb->buf + sb->len, str, len);
+	sb->len += len;
+	sb->buf[sb->len] = '\0';
+}
+
+/*
+ * cat str onto the builder
+ */
+void xstrbuf_cat(xstrbuf_t *sb, const char *str)
+{
+	if (str == NULL)
+		str = "(null)";
+
+	xstrbuf_ncat(sb, str, strlen(str));
+}
+
+/*
+ * append formatted string with printf-style args to the builder
+ */
+int xstrbuf_fmtcat(xstrbuf_t *sb, const char *fmt, ...)
+{
+	va_list ap;
+	size_t avail;
+	int n;
+
+	_strbuf_makespace(sb, 64);	/* the common cases fit directly */
+	avail = sb->size - sb->len;
+	va_start(ap, fmt);
+	n = vsnprintf(sb->buf + sb->len, avail, fmt, ap);
+	va_end(ap);
+
+	if ((n > 0) && ((size_t) n >= avail)) {
+		/* truncated, make room and format again */
+		_strbuf_makespace(sb, n);
+		va_start(ap, fmt);
+		n = vsnprintf(sb->buf + sb->len, sb->size - sb->len, fmt, ap);
+		va_end(ap);
+	}
+	if (n > 0)
+		sb->len += n;
+	sb->buf[sb->len] = '\0';
+
+	return n;
+}
+
+/*
+ * detach and return the builder's string (NULL if nothing was ever
+ * appended), resetting the builder; the caller must xfree() the result
+ */
+char *xstrbuf_finish(xstrbuf_t *sb)
+{
+	char *str = sb->buf;
+
+	sb->buf = NULL;
+	sb->len = 0;
+	sb->size = 0;
+
+	return str;
+}
+
+/*
+ * release the builder's string and reset the builder
+ */
+void xstrbuf_free(xstrbuf_t *sb)
+{
+	xfree(sb->buf);
+	sb->len = 0;
+	sb->size = 0;
+}
+
 /*
  * append a range of memory from start to end to the string str,
  * expanding str as needed
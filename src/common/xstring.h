@@ -110,6 +110,51 @@ int _xstrfmtcat(char **str, const char *fmt, ...)
 */
 void _xmemcat(char **str, char *start, char *end);
 
+/*
+** Length tracking string builder.  The xstrcat() family above must
+** recompute strlen() of the destination on every append, which turns
+** large record-by-record compositions quadratic; the builder remembers
+** the length and capacity so each append costs only the bytes added.
+** The struct may live on the stack, initialized with
+** XSTRBUF_INITIALIZER.  buf is NUL terminated and xmalloc()'d (NULL
+** until something has been appended).
+*/
+typedef struct {
+	char *buf;		/* NUL terminated contents */
+	size_t len;		/* bytes used, excluding the NUL */
+	size_t size;		/* bytes allocated */
+} xstrbuf_t;
+
+#define XSTRBUF_INITIALIZER	{ NULL, 0, 0 }
+
+/*
+** cat str onto the builder, expanding it as necessary
+*/
+void xstrbuf_cat(xstrbuf_t *sb, const char *str);
+
+/*
+** cat len bytes of str onto the builder, expanding it as necessary
+*/
+void xstrbuf_ncat(xstrbuf_t *sb, const char *str, size_t len);
+
+/*
+** concatenate printf-style formatted string onto the builder
+** return value is result from vsnprintf(3)
+*/
+int xstrbuf_fmtcat(xstrbuf_t *sb, const char *fmt, ...)
+  __attribute__ ((format (printf, 2, 3)));
+
+/*
+** detach and return the builder's string (NULL if nothing was ever
+** appended), resetting the builder; caller must xfree() the result
+*/
+char *xstrbuf_finish(xstrbuf_t *sb);
+
+/*
+** release the builder's string and reset the builder
+*/
+void xstrbuf_free(xstrbuf_t *sb);
+
 /*
 ** strdup which uses xmalloc routines
 */
@@ -0,0 +1,174 @@
+/*****************************************************************************\
+ *  xvector.c - array-backed list for iteration-heavy collections
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/common/macros.h"
+#include "src/common/xassert.h"
+#include "src/common/xmalloc.h"
+#include "src/common/xvector.h"
+
+/*
+ * Define slurm-specific aliases for use by plugins, see slurm_xlator.h
+ * for details.
+ */
+strong_alias(xvector_create,	slurm_xvector_create);
+strong_alias(xvector_destroy,	slurm_xvector_destroy);
+strong_alias(xvector_count,	slurm_xvector_count);
+strong_alias(xvector_append,	slurm_xvector_append);
+strong_alias(xvector_get,	slurm_xvector_get);
+strong_alias(xvector_pop,	slurm_xvector_pop);
+strong_alias(xvector_sort,	slurm_xvector_sort);
+strong_alias(xvector_for_each,	slurm_xvector_for_each);
+
+#define XVECTOR_INITIAL_SIZE 64
+
+struct xvector_st {
+#ifndef NDEBUG
+#	define XVECTOR_MAGIC 0x56454354
+	int magic;
+#endif
+	void **items;		/* array of item pointers */
+	uint32_t size;		/* slots allocated in items */
+	uint32_t count;		/* slots used in items */
+	uint32_t head;		/* first item not yet popped */
+	xvector_free_f free_func;
+};
+
+xvector_t *xvector_create(xvector_free_f f)
+{
+	xvector_t *v = xmalloc(sizeof(*v));
+
+	xassert((v->magic = XVECTOR_MAGIC));
+	v->free_func = f;
+
+	return v;
+}
+
+void xvector_destroy(xvector_t *v)
+{
+	uint32_t i;
+
+	xassert(v != NULL);
+	xassert(v->magic == XVECTOR_MAGIC);
+
+	if (v->free_func) {
+		for (i = v->head; i < v->count; i++)
+			v->free_func(v->items[i]);
+	}
+	xfree(v->items);
+	xassert((v->magic = ~XVECTOR_MAGIC));
+	xfree(v);
+}
+
+uint32_t xvector_count(xvector_t *v)
+{
+	xassert(v != NULL);
+	xassert(v->magic == XVECTOR_MAGIC);
+
+	return v->count - v->head;
+}
+
+void xvector_append(xvector_t *v, void *x)
+{
+	xassert(v != NULL);
+	xassert(v->magic == XVECTOR_MAGIC);
+	xassert(x != NULL);
+
+	if (v->count >= v->size) {
+		if (v->size)
+			v->size *= 2;
+		else
+			v->size = XVECTOR_INITIAL_SIZE;
+		xrealloc_nz(v->items, v->size * sizeof(void *));
+	}
+	v->items[v->count++] = x;
+}
+
+void *xvector_get(xvector_t *v, uint32_t inx)
+{
+	xassert(v != NULL);
+	xassert(v->magic == XVECTOR_MAGIC);
+
+	if ((v->head + inx) >= v->count)
+		return NULL;
+	return v->items[v->head + inx];
+}
+
+void *xvector_pop(xvector_t *v)
+{
+	xassert(v != NULL);
+	xassert(v->magic == XVECTOR_MAGIC);
+
+	if (v->head >= v->count)
+		return NULL;
+	/*
+	 * The head index just advances, so draining a large vector does
+	 * not shift the remaining items on every pop.
+	 */
+	return v->items[v->head++];
+}
+
+void xvector_sort(xvector_t *v, __compar_fn_t f)
+{
+	xassert(v != NULL);
+	xassert(v->magic == XVECTOR_MAGIC);
+	xassert(f != NULL);
+
+	if (xvector_count(v) > 1)
+		qsort(&v->items[v->head], v->count - v->head,
+		      sizeof(void *), f);
+}
+
+int xvector_for_each(xvector_t *v, int (*f) (void *x, void *arg), void *arg)
+{
+	uint32_t i;
+	int n = 0;
+
+	xassert(v != NULL);
+	xassert(v->magic == XVECTOR_MAGIC);
+	xassert(f != NULL);
+
+	for (i = v->head; i < v->count; i++) {
+		n++;
+		if (f(v->items[i], arg) < 0) {
+			n = -n;
+			break;
+		}
+	}
+
+	return n;
+}
@@ -0,0 +1,117 @@
+/*****************************************************************************\
+ *  xvector.h - array-backed list for iteration-heavy collections
+ *****************************************************************************
+ *  Copyright (C) 2019 SchedMD LLC.
+ *
+ *  This file is part of Slurm, a resource management program.
+ *  For details, see <https://slurm.schedmd.com/>.
+ *  Please also read the included file: DISCLAIMER.
+ *
+ *  Slurm is free software; you can redistribute it and/or modify it under
+ *  the terms of the GNU General Public License as published by the Free
+ *  Software Foundation; either version 2 of the License, or (at your option)
+ *  any later version.
+ *
+ *  In addition, as a special exception, the copyright holders give permission
+ *  to link the code of portions of this program with the OpenSSL library under
+ *  certain conditions as described in each individual source file, and
+ *  distribute linked combinations including the two. You must obey the GNU
+ *  General Public License in all respects for all of the code used other than
+ *  OpenSSL. If you modify file(s) with this exception, you may extend this
+ *  exception to your version of the file(s), but you are not obligated to do
+ *  so. If you do not wish to do so, delete this exception statement from your
+ *  version.  If you delete this exception statement from all source files in
+ *  the program, then also delete it here.
+ *
+ *  Slurm is distributed in the hope that it will be useful, but WITHOUT ANY
+ *  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ *  FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ *  details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with Slurm; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
+\*****************************************************************************/
+
+#ifndef _XVECTOR_H
+#define _XVECTOR_H
+
+#include <inttypes.h>
+
+/*
+ * A growable array of item pointers offering the common build / sort /
+ * drain pattern of the List container without per-node pointer chasing,
+ * per-operation locking or iterator allocations.  Intended for
+ * collections that are built up, optionally sorted, then iterated or
+ * drained by a single thread (e.g. a scheduler's job queue); callers
+ * needing concurrent access must provide their own locking.
+ */
+
+#define FREE_NULL_XVECTOR(_X)			\
+	do {					\
+		if (_X) xvector_destroy(_X);	\
+		_X	= NULL;			\
+	} while (0)
+
+/* Opaque array-backed list type */
+typedef struct xvector_st xvector_t;
+
+/*
+ * Function prototype to deallocate an item stored in the vector, as with
+ * the List container's ListDelF.
+ */
+typedef void (*xvector_free_f) (void *x);
+
+#ifndef __COMPAR_FN_T
+# define __COMPAR_FN_T
+typedef int (*__compar_fn_t) (__const void *, __const void *);
+#endif
+
+/*
+ * Create an empty vector.  The deletion function [f] is used to
+ * deallocate items remaining in the vector when it is destroyed; if
+ * NULL, the items are not freed.
+ */
+xvector_t *xvector_create(xvector_free_f f);
+
+/*
+ * Destroy vector [v], calling its deletion function (if any) on every
+ * item still held.
+ */
+void xvector_destroy(xvector_t *v);
+
+/* Return the number of items held by vector [v]. */
+uint32_t xvector_count(xvector_t *v);
+
+/* Append item [x] at the end of vector [v]. */
+void xvector_append(xvector_t *v, void *x);
+
+/*
+ * Return item [inx] (zero origin, counted from the current head) of
+ * vector [v], or NULL if out of range.
+ */
+void *xvector_get(xvector_t *v, uint32_t inx);
+
+/*
+ * Remove and return the item at the head of vector [v], or NULL if the
+ * vector is empty.  As with list_pop() after list_sort(), draining a
+ * sorted vector this way yields the items in sorted order.
+ */
+void *xvector_pop(xvector_t *v);
+
+/*
+ * Sort vector [v] with qsort().  As with list_sort(), the comparison
+ * function receives pointers to the item pointers, so existing ListCmpF
+ * style functions written for list_sort() may be reused unchanged.
+ */
+void xvector_sort(xvector_t *v, __compar_fn_t f);
+
+/*
+ * Invoke function [f] with [arg] on each item of vector [v].
+ * Returns a count of the number of items on which [f] was invoked; if
+ * [f] returns <0 for an item the iteration is aborted and the negative
+ * of that item's position is returned, as with list_for_each().
+ */
+int xvector_for_each(xvector_t *v, int (*f) (void *x, void *arg), void *arg);
+
+#endif /* !_XVECTOR_H */
@@ -40,6 +40,8 @@
 
 #include "config.h"
 
+#include <inttypes.h>
+
 #include "mysql_common.h"
 #include "src/common/log.h"
 #include "src/common/xstring.h"
@@ -50,6 +52,29 @@
 
 static char *table_defs_table = "table_defs_table";
 
+/*
+ * Per SQL statement timing, keyed by a hash of the query text with
+ * digits and quoted strings skipped so every instance of one statement
+ * shape shares an entry. Always on; recording is one hash of the query
+ * text plus a few adds under a mutex. Logged and cleared on demand
+ * through acct_storage_p_get_data(ACCT_STORAGE_INFO_QUERY_STATS),
+ * driven by "sacctmgr show stats" and "sacctmgr clear stats".
+ */
+#define QUERY_STATS_SLOTS  256
+#define QUERY_STATS_SAMPLE 120
+
+typedef struct {
+	uint32_t hash;
+	uint64_t count;
+	uint64_t total_usec;
+	uint64_t max_usec;
+	char sample[QUERY_STATS_SAMPLE];
+} query_stats_t;
+
+static query_stats_t query_stats[QUERY_STATS_SLOTS];
+static uint64_t query_stats_lost = 0;
+static pthread_mutex_t query_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
 typedef struct {
 	char *name;
 	char *columns;
@@ -66,6 +91,28 @@ static void _destroy_db_key(void *arg)
 	}
 }
 
+/* Cached prepared statement, keyed by its SQL text */
+typedef struct {
+	char *sql;
+	MYSQL_STMT *stmt;
+} prep_stmt_t;
+
+static void _destroy_prep_stmt(void *arg)
+{
+	prep_stmt_t *prep = (prep_stmt_t *)arg;
+
+	if (prep) {
+		mysql_stmt_close(prep->stmt);
+		xfree(prep->sql);
+		xfree(prep);
+	}
+}
+
+static int _find_prep_stmt(void *x, void *key)
+{
+	return !xstrcmp(((prep_stmt_t *)x)->sql, (char *)key);
+}
+
 /* NOTE: Ensure that mysql_conn->lock is set on function entry */
 static int _clear_results(MYSQL *db_conn)
 {
@@ -131,16 +178,116 @@ static MYSQL_RES *_get_last_result(MYSQL *db_conn)
 	return last_result;
 }
 
+/* Hash the shape of a query, skipping digits and single quoted strings
+ * so "...where id_job=1234" and "...where id_job=99" collide */
+static uint32_t _query_stats_hash(const char *query)
+{
+	uint32_t hash = 5381;
+	const char *p;
+
+	for (p = query; *p; p++) {
+		if ((*p >= '0') && (*p <= '9'))
+			continue;
+		if (*p == '\'') {
+			while (p[1] && (p[1] != '\''))
+				p++;
+			if (p[1])
+				p++;
+			continue;
+		}
+		hash = (hash * 33) + (uint8_t) *p;
+	}
+
+	return hash;
+}
+
+static void _query_stats_record(const char *query, uint64_t usec)
+{
+	uint32_t hash = _query_stats_hash(query);
+	query_stats_t *ent = NULL;
+	int i, inx;
+
+	slurm_mutex_lock(&query_stats_lock);
+	for (i = 0; i < QUERY_STATS_SLOTS; i++) {
+		inx = (hash + i) % QUERY_STATS_SLOTS;
+		if ((query_stats[inx].count == 0) ||
+		    (query_stats[inx].hash == hash)) {
+			ent = &query_stats[inx];
+			break;
+		}
+	}
+	if (!ent) {
+		query_stats_lost++;
+	} else {
+		if (ent->count == 0) {
+			ent->hash = hash;
+			snprintf(ent->sample, sizeof(ent->sample), "%s",
+				 query);
+		}
+		ent->count++;
+		ent->total_usec += usec;
+		if (ent->max_usec < usec)
+			ent->max_usec = usec;
+	}
+	slurm_mutex_unlock(&query_stats_lock);
+}
+
+extern void mysql_db_query_stats_log(void)
+{
+	int inx[QUERY_STATS_SLOTS];
+	query_stats_t *ent;
+	int i, j, n = 0, tmp;
+
+	slurm_mutex_lock(&query_stats_lock);
+	for (i = 0; i < QUERY_STATS_SLOTS; i++) {
+		if (query_stats[i].count)
+			inx[n++] = i;
+	}
+	/* Busiest statements first */
+	for (i = 0; i < n; i++) {
+		for (j = i + 1; j < n; j++) {
+			if (query_stats[inx[i]].total_usec >=
+			    query_stats[inx[j]].total_usec)
+				continue;
+			tmp = inx[i];
+			inx[i] = inx[j];
+			inx[j] = tmp;
+		}
+	}
+	info("SQL statement statistics (%d statements):", n);
+	for (i = 0; i < n; i++) {
+		ent = &query_stats[inx[i]];
+		info("count:%-8"PRIu64" ave_time:%-8"PRIu64
+		     " max_time:%-10"PRIu64" total_time:%-12"PRIu64" %s",
+		     ent->count, ent->total_usec / ent->count,
+		     ent->max_usec, ent->total_usec, ent->sample);
+	}
+	if (query_stats_lost)
+		info("%"PRIu64" queries not recorded, statement table full",
+		     query_stats_lost);
+	slurm_mutex_unlock(&query_stats_lock);
+}
+
+extern void mysql_db_query_stats_clear(void)
+{
+	slurm_mutex_lock(&query_stats_lock);
+	memset(query_stats, 0, sizeof(query_stats));
+	query_stats_lost = 0;
+	slurm_mutex_unlock(&query_stats_lock);
+}
+
 /* NOTE: Ensure that mysql_conn->lock is set on function entry */
 static int _mysql_query_internal(MYSQL *db_conn, char *query)
 {
-	int rc = SLURM_SUCCESS;
+	int rc = SLURM_SUCCESS, err_save;
+	DEF_TIMERS;
 
 	if (!db_conn)
 		fatal("You haven't inited this storage yet.");
 
 	/* clear out the old results so we don't get a 2014 error */
 	_clear_results(db_conn);
+	START_TIMER;
 	if (mysql_query(db_conn, query)) {
 		const char *err_str = mysql_error(db_conn);
 		errno = mysql_errno(db_conn);
@@ -171,6 +318,12 @@ static int _mysql_query_internal(MYSQL *db_conn, char *query)
 		rc = SLURM_ERROR;
 	}
 end_it:
+	/* Record timing without disturbing the errno callers check */
+	err_save = errno;
+	END_TIMER;
+	_query_stats_record(query, DELTA_TIMER);
+	errno = err_save;
+
 	/*
 	 * Starting in MariaDB 10.2 many of the api commands started
 	 * setting errno erroneously.
@@ -711,6 +864,9 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 
 	slurm_mutex_lock(&mysql_conn->lock);
 
+	/* statements prepared on a previous connection are now stale */
+	FREE_NULL_LIST(mysql_conn->stmt_cache);
+
 	if (!(mysql_conn->db_conn = mysql_init(mysql_conn->db_conn))) {
 		slurm_mutex_unlock(&mysql_conn->lock);
 		fatal("mysql_init failed: %s",
@@ -779,6 +935,7 @@ extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn)
 {
 	slurm_mutex_lock(&mysql_conn->lock);
 	if (mysql_conn && mysql_conn->db_conn) {
+		FREE_NULL_LIST(mysql_conn->stmt_cache);
 		if (mysql_thread_safe())
 			mysql_thread_end();
 		mysql_close(mysql_conn->db_conn);
@@ -815,6 +972,101 @@ extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query)
 	return rc;
 }
 
+/* Find a prepared statement for this SQL in the connection's cache,
+ * preparing and caching one on first use.
+ * NOTE: Ensure that mysql_conn->lock is set on function entry */
+static MYSQL_STMT *_stmt_cache_get(mysql_conn_t *mysql_conn, char *query)
+{
+	prep_stmt_t *prep = NULL;
+	MYSQL_STMT *stmt;
+
+	if (!mysql_conn->stmt_cache)
+		mysql_conn->stmt_cache = list_create(_destroy_prep_stmt);
+	else if ((prep = list_find_first(mysql_conn->stmt_cache,
+					 _find_prep_stmt, query)))
+		return prep->stmt;
+
+	if (!(stmt = mysql_stmt_init(mysql_conn->db_conn))) {
+		error("mysql_stmt_init failed: out of memory");
+		return NULL;
+	}
+	if (mysql_stmt_prepare(stmt, query, strlen(query))) {
+		errno = mysql_stmt_errno(stmt);
+		error("mysql_stmt_prepare failed: %d %s\n%s",
+		      errno, mysql_stmt_error(stmt), query);
+		mysql_stmt_close(stmt);
+		return NULL;
+	}
+
+	prep = xmalloc(sizeof(prep_stmt_t));
+	prep->sql = xstrdup(query);
+	prep->stmt = stmt;
+	list_append(mysql_conn->stmt_cache, prep);
+
+	return stmt;
+}
+
+extern int mysql_db_execute_prepared(mysql_conn_t *mysql_conn, char *query,
+				     MYSQL_BIND *binds,
+				     unsigned long param_cnt)
+{
+	MYSQL_STMT *stmt;
+	int rc = SLURM_SUCCESS;
+
+	if (!mysql_conn || !mysql_conn->db_conn) {
+		fatal("You haven't inited this storage yet.");
+		return 0;	/* For CLANG false positive */
+	}
+	slurm_mutex_lock(&mysql_conn->lock);
+
+	/* clear out the old results so we don't get a 2014 error */
+	_clear_results(mysql_conn->db_conn);
+
+	if (!(stmt = _stmt_cache_get(mysql_conn, query))) {
+		rc = SLURM_ERROR;
+		goto end_it;
+	}
+	if (mysql_stmt_param_count(stmt) != param_cnt) {
+		error("%s: %lu params bound but statement takes %lu\n%s",
+		      __func__, param_cnt, mysql_stmt_param_count(stmt),
+		      query);
+		rc = SLURM_ERROR;
+		goto end_it;
+	}
+
+	if (mysql_stmt_bind_param(stmt, binds) ||
+	    mysql_stmt_execute(stmt)) {
+		const char *err_str = mysql_stmt_error(stmt);
+		errno = mysql_stmt_errno(stmt);
+		if (errno == ER_NO_SUCH_TABLE) {
+			debug4("This could happen often and is expected.\n"
+			       "mysql_stmt_execute failed: %d %s\n%s",
+			       errno, err_str, query);
+			errno = 0;
+		} else {
+			error("mysql_stmt_execute failed: %d %s\n%s",
+			      errno, err_str, query);
+			rc = SLURM_ERROR;
+		}
+		/*
+		 * The handle may be tied to a lost connection or a dropped
+		 * table, toss it so the next call prepares afresh.
+		 */
+		list_delete_all(mysql_conn->stmt_cache, _find_prep_stmt,
+				query);
+	}
+
+end_it:
+	/*
+	 * Starting in MariaDB 10.2 many of the api commands started
+	 * setting errno erroneously.
+	 */
+	if (!rc)
+		errno = 0;
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return rc;
+}
+
 /*
  * Executes a single delete sql query.
  * Returns the number of deleted rows, <0 for failure.
@@ -934,6 +1186,33 @@ fini:
 	return result;
 }
 
+extern MYSQL_RES *mysql_db_query_ret_use(mysql_conn_t *mysql_conn,
+					 char *query)
+{
+	MYSQL_RES *result = NULL;
+
+	slurm_mutex_lock(&mysql_conn->lock);
+	if (_mysql_query_internal(mysql_conn->db_conn, query) != SLURM_ERROR) {
+		if (mysql_errno(mysql_conn->db_conn) == ER_NO_SUCH_TABLE)
+			goto fini;
+		result = mysql_use_result(mysql_conn->db_conn);
+		/*
+		 * Starting in MariaDB 10.2 many of the api commands started
+		 * setting errno erroneously.
+		 */
+		errno = 0;
+		if (!result && mysql_field_count(mysql_conn->db_conn)) {
+			/* should have returned data */
+			error("We should have gotten a result: '%m' '%s'",
+			      mysql_error(mysql_conn->db_conn));
+		}
+	}
+
+fini:
+	slurm_mutex_unlock(&mysql_conn->lock);
+	return result;
+}
+
 extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query)
 {
 	int rc = SLURM_SUCCESS;
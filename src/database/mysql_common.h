@@ -65,10 +65,43 @@ typedef struct {
 	pthread_mutex_t lock;
 	char *pre_commit_query;
 	bool rollback;
+	List stmt_cache;	/* see mysql_db_execute_prepared() */
 	List update_list;
 	int conn;
 } mysql_conn_t;
 
+/*
+ * Helpers to fill one entry of a (zeroed) MYSQL_BIND array for
+ * mysql_db_execute_prepared().  Bound values are read at execute time,
+ * so they must stay valid until the call returns.
+ */
+#define mysql_bind_uint64(_bind, _val)			\
+do {							\
+	(_bind)->buffer_type = MYSQL_TYPE_LONGLONG;	\
+	(_bind)->buffer = (char *)(_val);		\
+	(_bind)->is_unsigned = true;			\
+} while (0)
+
+#define mysql_bind_int32(_bind, _val)			\
+do {							\
+	(_bind)->buffer_type = MYSQL_TYPE_LONG;		\
+	(_bind)->buffer = (char *)(_val);		\
+} while (0)
+
+#define mysql_bind_uint32(_bind, _val)			\
+do {							\
+	(_bind)->buffer_type = MYSQL_TYPE_LONG;		\
+	(_bind)->buffer = (char *)(_val);		\
+	(_bind)->is_unsigned = true;			\
+} while (0)
+
+#define mysql_bind_str(_bind, _str)			\
+do {							\
+	(_bind)->buffer_type = MYSQL_TYPE_STRING;	\
+	(_bind)->buffer = (_str);			\
+	(_bind)->buffer_length = strlen(_str);		\
+} while (0)
+
 typedef struct {
 	char *backup;
 	uint32_t port;
@@ -93,13 +126,43 @@ extern int mysql_db_get_db_connection(mysql_conn_t *mysql_conn, char *db_name,
 extern int mysql_db_close_db_connection(mysql_conn_t *mysql_conn);
 extern int mysql_db_cleanup();
 extern int mysql_db_query(mysql_conn_t *mysql_conn, char *query);
+/*
+ * Run a parameterized query through a prepared statement cached on the
+ * connection, so the server parses and plans frequently repeated
+ * statements only once.  query holds '?' placeholders and doubles as
+ * the cache key; binds describes param_cnt parameters (see the
+ * mysql_bind_* helpers above).  The cache is dropped whenever the
+ * connection is (re)established or closed.
+ */
+extern int mysql_db_execute_prepared(mysql_conn_t *mysql_conn, char *query,
+				     MYSQL_BIND *binds,
+				     unsigned long param_cnt);
 extern int mysql_db_delete_affected_rows(mysql_conn_t *mysql_conn, char *query);
+/*
+ * Per SQL statement timing, aggregated by statement shape (query text
+ * with digits and quoted strings ignored).  _log() writes count, ave,
+ * max and total times per statement to the log, busiest first;
+ * _clear() zeroes the table.
+ */
+extern void mysql_db_query_stats_log(void);
+extern void mysql_db_query_stats_clear(void);
 extern int mysql_db_ping(mysql_conn_t *mysql_conn);
 extern int mysql_db_commit(mysql_conn_t *mysql_conn);
 extern int mysql_db_rollback(mysql_conn_t *mysql_conn);
 
 extern MYSQL_RES *mysql_db_query_ret(mysql_conn_t *mysql_conn,
 				     char *query, bool last);
+/*
+ * Issue a query and return its result set as a server-side cursor
+ * (mysql_use_result()).  Rows are streamed from the server as they are
+ * fetched instead of being materialized in this daemon's memory, so the
+ * memory footprint is bounded regardless of the result set size.  The
+ * connection can not issue another query until the returned result has
+ * been freed, so callers needing nested queries while iterating must
+ * run them on a separate connection.
+ */
+extern MYSQL_RES *mysql_db_query_ret_use(mysql_conn_t *mysql_conn,
+					 char *query);
 extern int mysql_db_query_check_after(mysql_conn_t *mysql_conn, char *query);
 
 extern uint64_t mysql_db_insert_ret_id(mysql_conn_t *mysql_conn, char *query);
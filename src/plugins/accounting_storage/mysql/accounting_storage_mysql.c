@@ -1127,6 +1127,29 @@ extern int check_connection(mysql_conn_t *mysql_conn)
 	return SLURM_SUCCESS;
 }
 
+/* Open a private database connection for streaming reads
+ * (mysql_db_query_ret_use()).  A server-side cursor monopolizes its
+ * connection until the result is freed, so it can not share the
+ * caller's connection with any nested queries.  Destroy the returned
+ * connection with destroy_mysql_conn() when the stream is done.
+ */
+extern mysql_conn_t *get_stream_conn(mysql_conn_t *mysql_conn)
+{
+	mysql_conn_t *stream_conn = create_mysql_conn(
+		mysql_conn->conn, false, mysql_conn->cluster_name);
+
+	if (mysql_db_get_db_connection(
+		    stream_conn, mysql_db_name, mysql_db_info)
+	    != SLURM_SUCCESS) {
+		error("unable to open streaming connection "
+		      "to as_mysql database");
+		destroy_mysql_conn(stream_conn);
+		return NULL;
+	}
+
+	return stream_conn;
+}
+
 /* Let me know if the last statement had rows that were affected.
  * This only gets called by a non-threaded connection, so there is no
  * need to worry about locks.
@@ -3394,6 +3417,17 @@ extern int acct_storage_p_clear_stats(void *db_conn, bool dbd)
 extern int acct_storage_p_get_data(void *db_conn, acct_storage_info_t dinfo,
 				   void *data)
 {
+	switch (dinfo) {
+	case ACCT_STORAGE_INFO_QUERY_STATS:
+		if (data && *(bool *) data)
+			mysql_db_query_stats_clear();
+		else
+			mysql_db_query_stats_log();
+		break;
+	default:
+		break;
+	}
+
 	return SLURM_SUCCESS;
 }
 
@@ -64,6 +64,10 @@
 
 #define MAX_PURGE_LIMIT 50000 /* Number of records that are purged at a time
 				 so that locks can be periodically released. */
+#define MIN_PURGE_LIMIT 1000  /* Lower bound for the adaptive batch size. */
+#define PURGE_TARGET_USEC 500000 /* The batch size is adapted so each delete
+				    finishes near this, keeping the locks it
+				    takes on the live tables short. */
 #define MAX_ARCHIVE_AGE (60 * 60 * 24 * 60) /* If archive data is older than
 					       this then archive by month to
 					       handle large datasets. */
@@ -552,7 +556,8 @@ typedef enum {
 static uint32_t _archive_table(purge_type_t type, mysql_conn_t *mysql_conn,
 			       char *cluster_name, time_t period_end,
 			       char *arch_dir, uint32_t archive_period,
-			       char *sql_table, uint32_t usage_info);
+			       char *sql_table, uint32_t usage_info,
+			       uint32_t limit);
 
 static uint32_t high_buffer_size = (1024 * 1024);
 
@@ -2237,21 +2242,13 @@ static char *_get_archive_columns(purge_type_t type)
 }
 
 
-static Buf _pack_archive_events(MYSQL_RES *result, char *cluster_name,
-				uint32_t cnt, uint32_t usage_info,
-				time_t *period_start)
+static uint32_t _pack_archive_events(MYSQL_RES *result, uint32_t usage_info,
+				     time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_event_t event;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(DBD_GOT_EVENTS, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
-
 	while ((row = mysql_fetch_row(result))) {
 		if (period_start && !*period_start)
 			*period_start = slurm_atoul(row[EVENT_REQ_START]);
@@ -2268,9 +2265,10 @@ static Buf _pack_archive_events(MYSQL_RES *result, char *cluster_name,
 		event.tres_str = row[EVENT_REQ_TRES];
 
 		_pack_local_event(&event, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 /* returns sql statement from archived data or NULL on error */
@@ -2278,18 +2276,19 @@ static char *
 _load_events(uint16_t rpc_version, Buf buffer, char *cluster_name,
 	     uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL;
+	char *format = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_event_t object;
 	int i = 0;
 
-	xstrfmtcat(insert, "insert into \"%s_%s\" (%s",
-		   cluster_name, event_table, event_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s_%s\" (%s",
+		       cluster_name, event_table, event_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for(i=1; i<EVENT_REQ_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", event_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", event_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 
 	for (i=0; i<rec_cnt; i++) {
@@ -2298,22 +2297,22 @@ _load_events(uint16_t rpc_version, Buf buffer, char *cluster_name,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
-			   object.period_start,
-			   object.period_end,
-			   object.node_name,
-			   object.cluster_nodes,
-			   object.reason,
-			   object.reason_uid,
-			   object.state,
-			   object.tres_str);
+			xstrbuf_cat(&insert, ", ");
+
+		xstrbuf_fmtcat(&insert, format,
+			       object.period_start,
+			       object.period_end,
+			       object.node_name,
+			       object.cluster_nodes,
+			       object.reason,
+			       object.reason_uid,
+			       object.state,
+			       object.tres_str);
 
 		if (rpc_version < SLURM_15_08_PROTOCOL_VERSION)
 			xfree(object.tres_str);
@@ -2322,24 +2321,16 @@ _load_events(uint16_t rpc_version, Buf buffer, char *cluster_name,
 //	info("event query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
-static Buf _pack_archive_jobs(MYSQL_RES *result, char *cluster_name,
-			      uint32_t cnt, uint32_t usage_info,
-			      time_t *period_start)
+static uint32_t _pack_archive_jobs(MYSQL_RES *result, uint32_t usage_info,
+				   time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_job_t job;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(DBD_GOT_JOBS, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
-
 	while ((row = mysql_fetch_row(result))) {
 		if (period_start && !*period_start)
 			*period_start = slurm_atoul(row[JOB_REQ_SUBMIT]);
@@ -2389,27 +2380,29 @@ static Buf _pack_archive_jobs(MYSQL_RES *result, char *cluster_name,
 		job.work_dir = row[JOB_REQ_WORK_DIR];
 
 		_pack_local_job(&job, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 /* returns sql statement from archived data or NULL on error */
 static char *_load_jobs(uint16_t rpc_version, Buf buffer,
 			char *cluster_name, uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL;
+	char *format = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_job_t object;
 	int i = 0;
 
-	xstrfmtcat(insert, "insert into \"%s_%s\" (%s",
-		   cluster_name, job_table, job_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s_%s\" (%s",
+		       cluster_name, job_table, job_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for(i=1; i<JOB_REQ_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", job_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", job_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 	for(i = 0; i < rec_cnt; i++) {
 
@@ -2417,57 +2410,57 @@ static char *_load_jobs(uint16_t rpc_version, Buf buffer,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
-			   object.account,
-			   object.array_max_tasks,
-			   object.alloc_nodes,
-			   object.associd,
-			   object.array_jobid,
-			   object.array_taskid,
-			   object.blockid,
-			   object.constraints,
-			   object.derived_ec,
-			   object.derived_es,
-			   object.exit_code,
-			   object.flags,
-			   object.timelimit,
-			   object.eligible,
-			   object.end,
-			   object.gid,
-			   object.job_db_inx,
-			   object.jobid,
-			   object.kill_requid,
-			   object.mcs_label,
-			   object.name,
-			   object.nodelist,
-			   object.node_inx,
-			   object.pack_job_id,
-			   object.pack_job_offset,
-			   object.partition,
-			   object.priority,
-			   object.qos,
-			   object.req_cpus,
-			   object.req_mem,
-			   object.resvid,
-			   object.start,
-			   object.state,
-			   object.state_reason_prev,
-			   object.submit,
-			   object.suspended,
-			   object.track_steps,
-			   object.uid,
-			   object.wckey,
-			   object.wckey_id,
-			   object.work_dir,
-			   object.tres_alloc_str,
-			   object.tres_req_str);
+			xstrbuf_cat(&insert, ", ");
+
+		xstrbuf_fmtcat(&insert, format,
+			       object.account,
+			       object.array_max_tasks,
+			       object.alloc_nodes,
+			       object.associd,
+			       object.array_jobid,
+			       object.array_taskid,
+			       object.blockid,
+			       object.constraints,
+			       object.derived_ec,
+			       object.derived_es,
+			       object.exit_code,
+			       object.flags,
+			       object.timelimit,
+			       object.eligible,
+			       object.end,
+			       object.gid,
+			       object.job_db_inx,
+			       object.jobid,
+			       object.kill_requid,
+			       object.mcs_label,
+			       object.name,
+			       object.nodelist,
+			       object.node_inx,
+			       object.pack_job_id,
+			       object.pack_job_offset,
+			       object.partition,
+			       object.priority,
+			       object.qos,
+			       object.req_cpus,
+			       object.req_mem,
+			       object.resvid,
+			       object.start,
+			       object.state,
+			       object.state_reason_prev,
+			       object.submit,
+			       object.suspended,
+			       object.track_steps,
+			       object.uid,
+			       object.wckey,
+			       object.wckey_id,
+			       object.work_dir,
+			       object.tres_alloc_str,
+			       object.tres_req_str);
 
 		if (rpc_version >= SLURMDBD_2_6_VERSION &&
 		    rpc_version <= SLURM_17_02_PROTOCOL_VERSION)
@@ -2482,24 +2475,16 @@ static char *_load_jobs(uint16_t rpc_version, Buf buffer,
 //	info("job query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
-static Buf _pack_archive_resvs(MYSQL_RES *result, char *cluster_name,
-			       uint32_t cnt, uint32_t usage_info,
-			       time_t *period_start)
+static uint32_t _pack_archive_resvs(MYSQL_RES *result, uint32_t usage_info,
+				    time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_resv_t resv;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(DBD_GOT_RESVS, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
-
 	while ((row = mysql_fetch_row(result))) {
 		if (period_start && !*period_start)
 			*period_start = slurm_atoul(row[RESV_REQ_START]);
@@ -2518,27 +2503,29 @@ static Buf _pack_archive_resvs(MYSQL_RES *result, char *cluster_name,
 		resv.unused_wall = row[RESV_REQ_UNUSED];
 
 		_pack_local_resv(&resv, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 /* returns sql statement from archived data or NULL on error */
 static char *_load_resvs(uint16_t rpc_version, Buf buffer,
 			 char *cluster_name, uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL;
+	char *format = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_resv_t object;
 	int i = 0;
 
-	xstrfmtcat(insert, "insert into \"%s_%s\" (%s",
-		   cluster_name, resv_table, resv_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s_%s\" (%s",
+		       cluster_name, resv_table, resv_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for(i=1; i<RESV_REQ_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", resv_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", resv_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_resv_t));
@@ -2546,24 +2533,24 @@ static char *_load_resvs(uint16_t rpc_version, Buf buffer,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
-			   object.id,
-			   object.assocs,
-			   object.flags,
-			   object.tres_str,
-			   object.nodes,
-			   object.node_inx,
-			   object.name,
-			   object.time_start,
-			   object.time_end,
-			   object.unused_wall);
+			xstrbuf_cat(&insert, ", ");
+
+		xstrbuf_fmtcat(&insert, format,
+			       object.id,
+			       object.assocs,
+			       object.flags,
+			       object.tres_str,
+			       object.nodes,
+			       object.node_inx,
+			       object.name,
+			       object.time_start,
+			       object.time_end,
+			       object.unused_wall);
 
 		if (rpc_version < SLURM_15_08_PROTOCOL_VERSION)
 			xfree(object.tres_str);
@@ -2572,24 +2559,16 @@ static char *_load_resvs(uint16_t rpc_version, Buf buffer,
 //	info("resv query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
-static Buf _pack_archive_steps(MYSQL_RES *result, char *cluster_name,
-			       uint32_t cnt, uint32_t usage_info,
-			       time_t *period_start)
+static uint32_t _pack_archive_steps(MYSQL_RES *result, uint32_t usage_info,
+				    time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_step_t step;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(DBD_STEP_START, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
-
 	while ((row = mysql_fetch_row(result))) {
 		if (period_start && !*period_start)
 			*period_start = slurm_atoul(row[STEP_REQ_START]);
@@ -2646,27 +2625,29 @@ static Buf _pack_archive_steps(MYSQL_RES *result, char *cluster_name,
 		step.user_usec = row[STEP_REQ_USER_USEC];
 
 		_pack_local_step(&step, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 /* returns sql statement from archived data or NULL on error */
 static char *_load_steps(uint16_t rpc_version, Buf buffer,
 			 char *cluster_name, uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL;
+	char *format = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_step_t object;
 	int i;
 
-	xstrfmtcat(insert, "insert into \"%s_%s\" (%s",
-		   cluster_name, step_table, step_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s_%s\" (%s",
+		       cluster_name, step_table, step_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for (i=1; i<STEP_REQ_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", step_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", step_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 	for (i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_step_t));
@@ -2674,54 +2655,54 @@ static char *_load_steps(uint16_t rpc_version, Buf buffer,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
-			   object.job_db_inx,
-			   object.stepid,
-			   object.period_start,
-			   object.period_end,
-			   object.period_suspended,
-			   object.name,
-			   object.nodelist,
-			   object.node_inx,
-			   object.state,
-			   object.kill_requid,
-			   object.exit_code,
-			   object.nodes,
-			   object.tasks,
-			   object.task_dist,
-			   object.user_sec,
-			   object.user_usec,
-			   object.sys_sec,
-			   object.sys_usec,
-			   object.act_cpufreq,
-			   object.consumed_energy,
-			   object.req_cpufreq_max,
-			   object.req_cpufreq_min,
-			   object.req_cpufreq_gov,
-			   object.tres_alloc_str,
-			   object.tres_usage_in_ave,
-			   object.tres_usage_in_max,
-			   object.tres_usage_in_max_nodeid,
-			   object.tres_usage_in_max_taskid,
-			   object.tres_usage_in_min,
-			   object.tres_usage_in_min_nodeid,
-			   object.tres_usage_in_min_taskid,
-			   object.tres_usage_in_tot,
-			   object.tres_usage_out_ave,
-			   object.tres_usage_out_max,
-			   object.tres_usage_out_max_nodeid,
-			   object.tres_usage_out_max_taskid,
-			   object.tres_usage_out_min,
-			   object.tres_usage_out_min_nodeid,
-			   object.tres_usage_out_min_taskid,
-			   object.tres_usage_out_tot);
+			xstrbuf_cat(&insert, ", ");
+
+		xstrbuf_fmtcat(&insert, format,
+			       object.job_db_inx,
+			       object.stepid,
+			       object.period_start,
+			       object.period_end,
+			       object.period_suspended,
+			       object.name,
+			       object.nodelist,
+			       object.node_inx,
+			       object.state,
+			       object.kill_requid,
+			       object.exit_code,
+			       object.nodes,
+			       object.tasks,
+			       object.task_dist,
+			       object.user_sec,
+			       object.user_usec,
+			       object.sys_sec,
+			       object.sys_usec,
+			       object.act_cpufreq,
+			       object.consumed_energy,
+			       object.req_cpufreq_max,
+			       object.req_cpufreq_min,
+			       object.req_cpufreq_gov,
+			       object.tres_alloc_str,
+			       object.tres_usage_in_ave,
+			       object.tres_usage_in_max,
+			       object.tres_usage_in_max_nodeid,
+			       object.tres_usage_in_max_taskid,
+			       object.tres_usage_in_min,
+			       object.tres_usage_in_min_nodeid,
+			       object.tres_usage_in_min_taskid,
+			       object.tres_usage_in_tot,
+			       object.tres_usage_out_ave,
+			       object.tres_usage_out_max,
+			       object.tres_usage_out_max_nodeid,
+			       object.tres_usage_out_max_taskid,
+			       object.tres_usage_out_min,
+			       object.tres_usage_out_min_nodeid,
+			       object.tres_usage_out_min_taskid,
+			       object.tres_usage_out_tot);
 
 		if (rpc_version < SLURM_18_08_PROTOCOL_VERSION) {
 			xfree(object.tres_usage_in_ave);
@@ -2744,24 +2725,16 @@ static char *_load_steps(uint16_t rpc_version, Buf buffer,
 //	info("step query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
-static Buf _pack_archive_suspends(MYSQL_RES *result, char *cluster_name,
-				  uint32_t cnt, uint32_t usage_info,
-				  time_t *period_start)
+static uint32_t _pack_archive_suspends(MYSQL_RES *result, uint32_t usage_info,
+				       time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_suspend_t suspend;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(DBD_JOB_SUSPEND, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
-
 	while ((row = mysql_fetch_row(result))) {
 		if (period_start && !*period_start)
 			*period_start = slurm_atoul(row[SUSPEND_REQ_START]);
@@ -2774,9 +2747,10 @@ static Buf _pack_archive_suspends(MYSQL_RES *result, char *cluster_name,
 		suspend.period_end = row[SUSPEND_REQ_END];
 
 		_pack_local_suspend(&suspend, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 
@@ -2784,18 +2758,19 @@ static Buf _pack_archive_suspends(MYSQL_RES *result, char *cluster_name,
 static char *_load_suspend(uint16_t rpc_version, Buf buffer,
 			   char *cluster_name, uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL;
+	char *format = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_suspend_t object;
 	int i = 0;
 
-	xstrfmtcat(insert, "insert into \"%s_%s\" (%s",
-		   cluster_name, suspend_table, suspend_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s_%s\" (%s",
+		       cluster_name, suspend_table, suspend_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for(i=1; i<SUSPEND_REQ_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", suspend_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", suspend_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_suspend_t));
@@ -2803,41 +2778,33 @@ static char *_load_suspend(uint16_t rpc_version, Buf buffer,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
+			xstrbuf_cat(&insert, ", ");
 
-		xstrfmtcat(insert, format,
-			   object.job_db_inx,
-			   object.associd,
-			   object.period_start,
-			   object.period_end);
+		xstrbuf_fmtcat(&insert, format,
+			       object.job_db_inx,
+			       object.associd,
+			       object.period_start,
+			       object.period_end);
 	}
 //	END_TIMER2("suspend query");
 //	info("suspend query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
-static Buf _pack_archive_txns(MYSQL_RES *result, char *cluster_name,
-			      uint32_t cnt, uint32_t usage_info,
-			      time_t *period_start)
+static uint32_t _pack_archive_txns(MYSQL_RES *result, uint32_t usage_info,
+				   time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_txn_t txn;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(DBD_GOT_TXN, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
-
 	while ((row = mysql_fetch_row(result))) {
 		if (period_start && !*period_start)
 			*period_start = slurm_atoul(row[TXN_REQ_TS]);
@@ -2853,9 +2820,10 @@ static Buf _pack_archive_txns(MYSQL_RES *result, char *cluster_name,
 		txn.cluster = row[TXN_REQ_CLUSTER];
 
 		_pack_local_txn(&txn, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 
@@ -2863,19 +2831,20 @@ static Buf _pack_archive_txns(MYSQL_RES *result, char *cluster_name,
 static char *_load_txn(uint16_t rpc_version, Buf buffer,
 		       char *cluster_name, uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL;
+	char *format = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_txn_t object;
 	char *tmp = NULL;
 	int i = 0;
 
-	xstrfmtcat(insert, "insert into \"%s\" (%s",
-		   txn_table, txn_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s\" (%s",
+		       txn_table, txn_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for(i=1; i<TXN_REQ_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", txn_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", txn_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_txn_t));
@@ -2883,48 +2852,40 @@ static char *_load_txn(uint16_t rpc_version, Buf buffer,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
+			xstrbuf_cat(&insert, ", ");
 
 		/* object.info has a bunch of "'" in it */
 		tmp = slurm_add_slash_to_quotes(object.info);
-		xstrfmtcat(insert, format,
-			   object.id,
-			   object.timestamp,
-			   object.action,
-			   object.name,
-			   object.actor,
-			   tmp,
-			   object.cluster);
+		xstrbuf_fmtcat(&insert, format,
+			       object.id,
+			       object.timestamp,
+			       object.action,
+			       object.name,
+			       object.actor,
+			       tmp,
+			       object.cluster);
 		xfree(tmp);
 	}
 //	END_TIMER2("txn query");
 //	info("txn query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
-static Buf _pack_archive_usage(MYSQL_RES *result, char *cluster_name,
-			       uint32_t cnt, uint32_t usage_info,
-			       time_t *period_start)
+static uint32_t _pack_archive_usage(MYSQL_RES *result, uint32_t usage_info,
+				    time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_usage_t usage;
-	uint16_t type = usage_info & 0x0000ffff;
 	uint16_t period = usage_info >> 16;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(type, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
 	pack16(period, buffer);
 
 	while ((row = mysql_fetch_row(result))) {
@@ -2939,9 +2900,10 @@ static Buf _pack_archive_usage(MYSQL_RES *result, char *cluster_name,
 		usage.alloc_secs = row[USAGE_ALLOC];
 
 		_pack_local_usage(&usage, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 /* returns sql statement from archived data or NULL on error */
@@ -2949,7 +2911,8 @@ static char *_load_usage(uint16_t rpc_version, Buf buffer,
 			 char *cluster_name, uint16_t type, uint16_t period,
 			 uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL, *my_usage_table = NULL;
+	char *format = NULL, *my_usage_table = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_usage_t object;
 	int i = 0;
 
@@ -2994,14 +2957,14 @@ static char *_load_usage(uint16_t rpc_version, Buf buffer,
 		break;
 	}
 
-	xstrfmtcat(insert, "insert into \"%s_%s\" (%s",
-		   cluster_name, my_usage_table, usage_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s_%s\" (%s",
+		       cluster_name, my_usage_table, usage_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for(i=1; i<USAGE_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", usage_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", usage_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_usage_t));
@@ -3009,41 +2972,34 @@ static char *_load_usage(uint16_t rpc_version, Buf buffer,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
+			xstrbuf_cat(&insert, ", ");
 
-		xstrfmtcat(insert, format,
-			   object.id,
-			   object.tres_id,
-			   object.time_start,
-			   object.alloc_secs);
+		xstrbuf_fmtcat(&insert, format,
+			       object.id,
+			       object.tres_id,
+			       object.time_start,
+			       object.alloc_secs);
 	}
 //	END_TIMER2("usage query");
 //	info("usage query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
-static Buf _pack_archive_cluster_usage(MYSQL_RES *result, char *cluster_name,
-				       uint32_t cnt, uint32_t usage_info,
-				       time_t *period_start)
+static uint32_t _pack_archive_cluster_usage(MYSQL_RES *result, uint32_t usage_info,
+					    time_t *period_start, Buf buffer)
 {
 	MYSQL_ROW row;
-	Buf buffer;
+	uint32_t cnt = 0;
 	local_cluster_usage_t usage;
 	uint16_t period = usage_info >> 16;
 
-	buffer = init_buf(high_buffer_size);
-	pack16(SLURM_PROTOCOL_VERSION, buffer);
-	pack_time(time(NULL), buffer);
-	pack16(DBD_GOT_CLUSTER_USAGE, buffer);
-	packstr(cluster_name, buffer);
-	pack32(cnt, buffer);
 	pack16(period, buffer);
 
 	while ((row = mysql_fetch_row(result))) {
@@ -3064,9 +3020,10 @@ static Buf _pack_archive_cluster_usage(MYSQL_RES *result, char *cluster_name,
 
 		_pack_local_cluster_usage(
 			&usage, SLURM_PROTOCOL_VERSION, buffer);
+		cnt++;
 	}
 
-	return buffer;
+	return cnt;
 }
 
 /* returns sql statement from archived data or NULL on error */
@@ -3074,7 +3031,8 @@ static char *_load_cluster_usage(uint16_t rpc_version, Buf buffer,
 				 char *cluster_name, uint16_t period,
 				 uint32_t rec_cnt)
 {
-	char *insert = NULL, *format = NULL, *my_usage_table = NULL;
+	char *format = NULL, *my_usage_table = NULL;
+	xstrbuf_t insert = XSTRBUF_INITIALIZER;
 	local_cluster_usage_t object;
 	int i = 0;
 
@@ -3094,14 +3052,14 @@ static char *_load_cluster_usage(uint16_t rpc_version, Buf buffer,
 		break;
 	}
 
-	xstrfmtcat(insert, "insert into \"%s_%s\" (%s",
-		   cluster_name, my_usage_table, cluster_req_inx[0]);
+	xstrbuf_fmtcat(&insert, "insert into \"%s_%s\" (%s",
+		       cluster_name, my_usage_table, cluster_req_inx[0]);
 	xstrcat(format, "('%s'");
 	for(i=1; i<CLUSTER_COUNT; i++) {
-		xstrfmtcat(insert, ", %s", cluster_req_inx[i]);
+		xstrbuf_fmtcat(&insert, ", %s", cluster_req_inx[i]);
 		xstrcat(format, ", '%s'");
 	}
-	xstrcat(insert, ") values ");
+	xstrbuf_cat(&insert, ") values ");
 	xstrcat(format, ")");
 	for(i=0; i<rec_cnt; i++) {
 		memset(&object, 0, sizeof(local_cluster_usage_t));
@@ -3109,73 +3067,84 @@ static char *_load_cluster_usage(uint16_t rpc_version, Buf buffer,
 		    != SLURM_SUCCESS) {
 			error("issue unpacking");
 			xfree(format);
-			xfree(insert);
+			xstrbuf_free(&insert);
 			break;
 		}
 
 		if (i)
-			xstrcat(insert, ", ");
-
-		xstrfmtcat(insert, format,
-			   object.tres_id,
-			   object.time_start,
-			   object.tres_cnt,
-			   object.alloc_secs,
-			   object.down_secs,
-			   object.pdown_secs,
-			   object.idle_secs,
-			   object.resv_secs,
-			   object.over_secs);
+			xstrbuf_cat(&insert, ", ");
+
+		xstrbuf_fmtcat(&insert, format,
+			       object.tres_id,
+			       object.time_start,
+			       object.tres_cnt,
+			       object.alloc_secs,
+			       object.down_secs,
+			       object.pdown_secs,
+			       object.idle_secs,
+			       object.resv_secs,
+			       object.over_secs);
 	}
 //	END_TIMER2("usage query");
 //	info("usage query took %s", TIME_STR);
 	xfree(format);
 
-	return insert;
+	return xstrbuf_finish(&insert);
 }
 
 /* returns count of events archived or SLURM_ERROR on error */
 static uint32_t _archive_table(purge_type_t type, mysql_conn_t *mysql_conn,
 			       char *cluster_name, time_t period_end,
 			       char *arch_dir, uint32_t archive_period,
-			       char *sql_table, uint32_t usage_info)
+			       char *sql_table, uint32_t usage_info,
+			       uint32_t limit)
 {
 	MYSQL_RES *result = NULL;
+	mysql_conn_t *stream_conn = NULL;
 	char *cols = NULL, *query = NULL;
 	time_t period_start = 0;
 	uint32_t cnt = 0;
+	uint32_t cnt_offset, tmp_offset;
+	uint16_t msg_type = NO_VAL16;
 	Buf buffer;
 	int error_code = 0;
-	Buf (*pack_func)(MYSQL_RES *result, char *cluster_name,
-			 uint32_t cnt, uint32_t usage_info,
-			 time_t *period_start);
+	uint32_t (*pack_func)(MYSQL_RES *result, uint32_t usage_info,
+			      time_t *period_start, Buf buffer);
 
 	cols = _get_archive_columns(type);
 
 	switch (type) {
 	case PURGE_EVENT:
 		pack_func = &_pack_archive_events;
+		msg_type = DBD_GOT_EVENTS;
 		break;
 	case PURGE_SUSPEND:
 		pack_func = &_pack_archive_suspends;
+		msg_type = DBD_JOB_SUSPEND;
 		break;
 	case PURGE_RESV:
 		pack_func = &_pack_archive_resvs;
+		msg_type = DBD_GOT_RESVS;
 		break;
 	case PURGE_JOB:
 		pack_func = &_pack_archive_jobs;
+		msg_type = DBD_GOT_JOBS;
 		break;
 	case PURGE_STEP:
 		pack_func = &_pack_archive_steps;
+		msg_type = DBD_STEP_START;
 		break;
 	case PURGE_TXN:
 		pack_func = &_pack_archive_txns;
+		msg_type = DBD_GOT_TXN;
 		break;
 	case PURGE_USAGE:
 		pack_func = &_pack_archive_usage;
+		msg_type = usage_info & 0x0000ffff;
 		break;
 	case PURGE_CLUSTER_USAGE:
 		pack_func = &_pack_archive_cluster_usage;
+		msg_type = DBD_GOT_CLUSTER_USAGE;
 		break;
 	default:
 		fatal("Unknown purge type: %d", type);
@@ -3189,7 +3158,7 @@ static uint32_t _archive_table(purge_type_t type, mysql_conn_t *mysql_conn,
 				       "order by timestamp asc LIMIT %d",
 				       cols, sql_table,
 				       period_end, cluster_name,
-				       MAX_PURGE_LIMIT);
+				       limit);
 		break;
 	case PURGE_USAGE:
 	case PURGE_CLUSTER_USAGE:
@@ -3197,21 +3166,21 @@ static uint32_t _archive_table(purge_type_t type, mysql_conn_t *mysql_conn,
 				       "time_start <= %ld "
 				       "order by time_start asc LIMIT %d",
 				       cols, cluster_name, sql_table,
-				       period_end, MAX_PURGE_LIMIT);
+				       period_end, limit);
 		break;
 	case PURGE_JOB:
 		query = xstrdup_printf("select %s from \"%s_%s\" where "
 				       "time_submit <= %ld && time_end != 0 "
 				       "order by time_submit asc LIMIT %d",
 				       cols, cluster_name, job_table,
-				       period_end, MAX_PURGE_LIMIT);
+				       period_end, limit);
 		break;
 	default:
 		query = xstrdup_printf("select %s from \"%s_%s\" where "
 				       "time_start <= %ld && time_end != 0 "
 				       "order by time_start asc LIMIT %d",
 				       cols, cluster_name, sql_table,
-				       period_end, MAX_PURGE_LIMIT);
+				       period_end, limit);
 		break;
 	}
 
@@ -3219,20 +3188,60 @@ static uint32_t _archive_table(purge_type_t type, mysql_conn_t *mysql_conn,
 
 	if (debug_flags & DEBUG_FLAG_DB_ARCHIVE)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
+
+	/* Stream the rows through a server-side cursor on a private
+	 * connection so archiving does not materialize up to
+	 * a batch worth of rows in this daemon's memory on top of the
+	 * pack buffer.  If a second connection can not be opened fall
+	 * back to the old store-everything behavior.
+	 */
+	if ((stream_conn = get_stream_conn(mysql_conn)))
+		result = mysql_db_query_ret_use(stream_conn, query);
+	else
+		result = mysql_db_query_ret(mysql_conn, query, 0);
+	if (!result) {
 		xfree(query);
+		if (stream_conn)
+			destroy_mysql_conn(stream_conn);
 		return SLURM_ERROR;
 	}
 	xfree(query);
 
-	if (!(cnt = mysql_num_rows(result))) {
-		mysql_free_result(result);
+	buffer = init_buf(high_buffer_size);
+	pack16(SLURM_PROTOCOL_VERSION, buffer);
+	pack_time(time(NULL), buffer);
+	pack16(msg_type, buffer);
+	packstr(cluster_name, buffer);
+	/* The row count is not known until the cursor has been
+	 * drained, so pack a placeholder and backfill it below. */
+	cnt_offset = get_buf_offset(buffer);
+	pack32(cnt, buffer);
+
+	cnt = (*pack_func)(result, usage_info, &period_start, buffer);
+	mysql_free_result(result);
+	if (stream_conn) {
+		/* A cursor fetch can fail mid-stream, which ends the
+		 * pack loop just like a normal EOF. */
+		if (mysql_errno(stream_conn->db_conn)) {
+			error("stream fetch for %s archive of cluster %s "
+			      "failed: %s", sql_table, cluster_name,
+			      mysql_error(stream_conn->db_conn));
+			destroy_mysql_conn(stream_conn);
+			free_buf(buffer);
+			return SLURM_ERROR;
+		}
+		destroy_mysql_conn(stream_conn);
+	}
+
+	if (!cnt) {
+		free_buf(buffer);
 		return 0;
 	}
 
-	buffer = (*pack_func)(result, cluster_name, cnt, usage_info,
-			      &period_start);
-	mysql_free_result(result);
+	tmp_offset = get_buf_offset(buffer);
+	set_buf_offset(buffer, cnt_offset);
+	pack32(cnt, buffer);
+	set_buf_offset(buffer, tmp_offset);
 
 	error_code = archive_write_file(buffer, cluster_name,
 					period_start, period_end,
@@ -3342,6 +3351,8 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 	char    *query = NULL, *sql_table = NULL,
 		*col_name = NULL;
 	uint32_t tmp_archive_period;
+	uint32_t purge_limit = MAX_PURGE_LIMIT;
+	DEF_TIMERS;
 
 	switch (purge_type) {
 	case PURGE_EVENT:
@@ -3484,7 +3495,8 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 					    cluster_name, tmp_end,
 					    arch_cond->archive_dir,
 					    tmp_archive_period,
-					    sql_table, usage_info);
+					    sql_table, usage_info,
+					    purge_limit);
 			if (!rc) { /* no records archived */
 				error("%s: No records archived for %s before %ld but we found some records",
 				      __func__, sql_table, tmp_end);
@@ -3506,7 +3518,7 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 				"delete from \"%s\" where "
 				"%s <= %ld && cluster='%s' order by %s asc LIMIT %d",
 				sql_table, col_name, tmp_end, cluster_name,
-				col_name, MAX_PURGE_LIMIT);
+				col_name, purge_limit);
 			break;
 		case PURGE_USAGE:
 		case PURGE_CLUSTER_USAGE:
@@ -3514,14 +3526,14 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 				"delete from \"%s_%s\" where "
 				"%s <= %ld order by %s asc LIMIT %d",
 				cluster_name, sql_table, col_name,
-				tmp_end, col_name, MAX_PURGE_LIMIT);
+				tmp_end, col_name, purge_limit);
 			break;
 		default:
 			query = xstrdup_printf(
 				"delete from \"%s_%s\" where "
 				"%s <= %ld && time_end != 0 order by %s asc LIMIT %d",
 				cluster_name, sql_table, col_name,
-				tmp_end, col_name, MAX_PURGE_LIMIT);
+				tmp_end, col_name, purge_limit);
 			break;
 		}
 		if (debug_flags & DEBUG_FLAG_DB_ARCHIVE)
@@ -3529,10 +3541,11 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 
 		/*
 		 * Don't loop this query, just do it once, since we are only
-		 * archiving and purging MAX_PURGE_LIMIT rows at a time.
+		 * archiving and purging purge_limit rows at a time.
 		 * mysql_db_delete_affected_rows will return < 0 on failure or
 		 * 0 if no records are affected.
 		 */
+		START_TIMER;
 		if ((rc = mysql_db_delete_affected_rows(
 				mysql_conn, query)) > 0) {
 			/* Commit here every time since this could create a huge
@@ -3542,6 +3555,7 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 				error("Couldn't commit cluster (%s) purge",
 				      cluster_name);
 		}
+		END_TIMER;
 
 		xfree(query);
 		if (rc != SLURM_SUCCESS) {
@@ -3553,6 +3567,28 @@ static int _archive_purge_table(purge_type_t purge_type, uint32_t usage_info,
 			      cluster_name);
 			break;
 		}
+
+		/*
+		 * Adapt the batch size to the observed delete latency so
+		 * each batch holds its locks on the live tables only
+		 * briefly, then pause for as long as the batch took.
+		 * This keeps purging from stalling the job start and
+		 * rollup write paths; maintenance just takes longer on a
+		 * loaded database instead.
+		 */
+		if ((DELTA_TIMER > PURGE_TARGET_USEC) &&
+		    (purge_limit > MIN_PURGE_LIMIT)) {
+			purge_limit = MAX(purge_limit / 2, MIN_PURGE_LIMIT);
+			if (debug_flags & DEBUG_FLAG_DB_ARCHIVE)
+				debug("Purge of %s_%s took %ld usec, "
+				      "reducing batch size to %u",
+				      cluster_name, sql_table, DELTA_TIMER,
+				      purge_limit);
+		} else if ((DELTA_TIMER < (PURGE_TARGET_USEC / 2)) &&
+			   (purge_limit < MAX_PURGE_LIMIT)) {
+			purge_limit = MIN(purge_limit * 2, MAX_PURGE_LIMIT);
+		}
+		usleep(MIN(DELTA_TIMER, 1000000));
 	}
 
 	return SLURM_SUCCESS;
@@ -128,8 +128,21 @@ enum {
 	ASSOC2_REQ_QOS,
 	ASSOC2_REQ_DELTA_QOS,
 	ASSOC2_REQ_PRIO,
+	ASSOC2_REQ_COUNT
 };
 
+/*
+ * Cached copy of one get_parent_limits() result.  A bulk add of many
+ * users to the same account would otherwise call the stored procedure
+ * once per association even though every sibling shares the parent.
+ */
+typedef struct {
+	char *cluster;
+	char *parent;
+	char *row[ASSOC2_REQ_COUNT];
+	bool valid;
+} parent_limits_cache_t;
+
 static char *aassoc_req_inx[] = {
 	"id_assoc",
 	"parent_acct",
@@ -356,78 +369,95 @@ static int _make_sure_users_have_default(
 	mysql_conn_t *mysql_conn, List user_list)
 {
 	char *query = NULL, *cluster = NULL, *user = NULL;
+	char *user_names = NULL;
 	ListIterator itr = NULL, clus_itr = NULL;
 	int rc = SLURM_SUCCESS;
 
-	if (!user_list)
+	if (!user_list || !list_count(user_list))
 		return SLURM_SUCCESS;
 
+	/*
+	 * Check every user in one query per cluster rather than one
+	 * query per user per cluster; a bulk user add used to turn this
+	 * into thousands of round trips.
+	 */
+	itr = list_iterator_create(user_list);
+	while ((user = list_next(itr)))
+		xstrfmtcat(user_names, "%s'%s'",
+			   user_names ? ", " : "", user);
+	list_iterator_destroy(itr);
+
 	slurm_mutex_lock(&as_mysql_cluster_list_lock);
 
 	clus_itr = list_iterator_create(as_mysql_cluster_list);
-	itr = list_iterator_create(user_list);
+	while ((cluster = list_next(clus_itr))) {
+		MYSQL_RES *result = NULL;
+		MYSQL_ROW row;
+		char *last_user = NULL, *acct = NULL, *update = NULL;
+		bool have_def = false;
 
-	while ((user = list_next(itr))) {
-		while ((cluster = list_next(clus_itr))) {
-			MYSQL_RES *result = NULL;
-			MYSQL_ROW row;
-			char *acct = NULL;
-			query = xstrdup_printf(
-				"select distinct is_def, acct from "
-				"\"%s_%s\" where user='%s' FOR UPDATE;",
-				cluster, assoc_table, user);
-			debug4("%d(%s:%d) query\n%s",
-			       mysql_conn->conn, THIS_FILE, __LINE__, query);
-			if (!(result = mysql_db_query_ret(
-				      mysql_conn, query, 0))) {
-				xfree(query);
-				error("couldn't query the database");
-				rc = SLURM_ERROR;
-				break;
-			}
+		query = xstrdup_printf(
+			"select distinct is_def, acct, user from "
+			"\"%s_%s\" where user in (%s) order by user "
+			"FOR UPDATE;",
+			cluster, assoc_table, user_names);
+		debug4("%d(%s:%d) query\n%s",
+		       mysql_conn->conn, THIS_FILE, __LINE__, query);
+		if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
 			xfree(query);
-			/* Check to see if the user is even added to
-			   the cluster.
-			*/
-			if (!mysql_num_rows(result)) {
-				mysql_free_result(result);
-				continue;
-			}
-			while ((row = mysql_fetch_row(result))) {
-				if (row[0][0] == '1')
-					break;
-				if (!acct)
-					acct = xstrdup(row[1]);
-			}
-			mysql_free_result(result);
+			error("couldn't query the database");
+			rc = SLURM_ERROR;
+			break;
+		}
+		xfree(query);
 
-			/* we found one so just continue */
-			if (row || !acct) {
+		/* Rows are sorted by user; when a user's rows end
+		   without an is_def found promote the first account
+		   seen to be their default. */
+		while ((row = mysql_fetch_row(result))) {
+			if (xstrcmp(last_user, row[2])) {
+				if (last_user && !have_def && acct)
+					xstrfmtcat(update,
+						   "update \"%s_%s\" set "
+						   "is_def=1 where user='%s' "
+						   "and acct='%s';",
+						   cluster, assoc_table,
+						   last_user, acct);
+				xfree(last_user);
 				xfree(acct);
-				continue;
+				last_user = xstrdup(row[2]);
+				have_def = false;
 			}
-			query = xstrdup_printf(
-				"update \"%s_%s\" set is_def=1 where "
-				"user='%s' and acct='%s';",
-				cluster, assoc_table, user, acct);
-			xfree(acct);
+			if (row[0][0] == '1')
+				have_def = true;
+			else if (!acct)
+				acct = xstrdup(row[1]);
+		}
+		if (last_user && !have_def && acct)
+			xstrfmtcat(update,
+				   "update \"%s_%s\" set is_def=1 where "
+				   "user='%s' and acct='%s';",
+				   cluster, assoc_table, last_user, acct);
+		xfree(last_user);
+		xfree(acct);
+		mysql_free_result(result);
+
+		if (update) {
 			if (debug_flags & DEBUG_FLAG_DB_ASSOC)
-				DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-			rc = mysql_db_query(mysql_conn, query);
-			xfree(query);
+				DB_DEBUG(mysql_conn->conn, "query\n%s",
+					 update);
+			rc = mysql_db_query(mysql_conn, update);
+			xfree(update);
 			if (rc != SLURM_SUCCESS) {
 				error("problem with update query");
 				rc = SLURM_ERROR;
 				break;
 			}
 		}
-		if (rc != SLURM_SUCCESS)
-			break;
-		list_iterator_reset(clus_itr);
 	}
-	list_iterator_destroy(itr);
 	list_iterator_destroy(clus_itr);
 	slurm_mutex_unlock(&as_mysql_cluster_list_lock);
+	xfree(user_names);
 
 	return rc;
 }
@@ -687,8 +717,20 @@ static int _set_assoc_lft_rgt(
 	return rc;
 }
 
+static void _clear_parent_limits_cache(parent_limits_cache_t *cache)
+{
+	int i;
+
+	xfree(cache->cluster);
+	xfree(cache->parent);
+	for (i = 0; i < ASSOC2_REQ_COUNT; i++)
+		xfree(cache->row[i]);
+	cache->valid = false;
+}
+
 static int _set_assoc_limits_for_add(
-	mysql_conn_t *mysql_conn, slurmdb_assoc_rec_t *assoc)
+	mysql_conn_t *mysql_conn, slurmdb_assoc_rec_t *assoc,
+	parent_limits_cache_t *cache)
 {
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
@@ -696,6 +738,7 @@ static int _set_assoc_limits_for_add(
 	char *parent = NULL;
 	char *qos_delta = NULL;
 	uint32_t tres_str_flags = TRES_STR_FLAG_REMOVE;
+	int i;
 
 	xassert(assoc);
 
@@ -706,6 +749,12 @@ static int _set_assoc_limits_for_add(
 	else
 		return SLURM_SUCCESS;
 
+	if (cache->valid && !xstrcmp(cache->parent, parent) &&
+	    !xstrcmp(cache->cluster, assoc->cluster)) {
+		row = cache->row;
+		goto apply;
+	}
+
 	query = xstrdup_printf("call get_parent_limits('%s', "
 			       "'%s', '%s', %u); %s",
 			       assoc_table, parent, assoc->cluster, 0,
@@ -721,6 +770,16 @@ static int _set_assoc_limits_for_add(
 	if (!(row = mysql_fetch_row(result)))
 		goto end_it;
 
+	/* Keep a copy for the next sibling under the same parent */
+	_clear_parent_limits_cache(cache);
+	cache->cluster = xstrdup(assoc->cluster);
+	cache->parent = xstrdup(parent);
+	for (i = 0; i < ASSOC2_REQ_COUNT; i++)
+		cache->row[i] = xstrdup(row[i]);
+	cache->valid = true;
+
+apply:
+
 	if (row[ASSOC2_REQ_DEF_QOS] && assoc->def_qos_id == INFINITE)
 		assoc->def_qos_id = slurm_atoul(row[ASSOC2_REQ_DEF_QOS]);
 	else if (assoc->def_qos_id == INFINITE)
@@ -796,7 +855,8 @@ static int _set_assoc_limits_for_add(
 	}
 
 end_it:
-	mysql_free_result(result);
+	if (result)
+		mysql_free_result(result);
 
 	return SLURM_SUCCESS;
 }
@@ -2432,6 +2492,9 @@ extern int as_mysql_add_assocs(mysql_conn_t *mysql_conn, uint32_t uid,
 	bool is_coord = false;
 	slurmdb_update_object_t *update_object = NULL;
 	List assoc_list_tmp = NULL;
+	parent_limits_cache_t limits_cache;
+
+	memset(&limits_cache, 0, sizeof(parent_limits_cache_t));
 
 	if (!assoc_list) {
 		error("No association list given");
@@ -2582,7 +2645,13 @@ extern int as_mysql_add_assocs(mysql_conn_t *mysql_conn, uint32_t uid,
 			xstrfmtcat(extra, ", `partition`='%s'", part);
 			if (!added_user_list)
 				added_user_list = list_create(NULL);
-			list_append(added_user_list, object->user);
+			/* Add each user once; a user given several
+			 * associations would otherwise repeat the
+			 * default account checks per association. */
+			if (!list_find_first(added_user_list,
+					     slurm_find_char_in_list,
+					     object->user))
+				list_append(added_user_list, object->user);
 		}
 
 		if (object->id) {
@@ -2732,6 +2801,11 @@ extern int as_mysql_add_assocs(mysql_conn_t *mysql_conn, uint32_t uid,
 				   "values (%s, %d, %d, 2);",
 				   object->cluster, assoc_table, cols,
 				   vals, my_left+(incr-1), my_left+incr);
+			/* The new row's lft/rgt are known here, so the
+			 * per-record lookup in _set_assoc_lft_rgt()
+			 * can be skipped below. */
+			object->lft = my_left + (incr - 1);
+			object->rgt = my_left + incr;
 
 			/* definantly works but slow */
 /* 			xstrfmtcat(query, */
@@ -2843,7 +2917,8 @@ extern int as_mysql_add_assocs(mysql_conn_t *mysql_conn, uint32_t uid,
 		object->parent_id = my_par_id;
 
 		if (!moved_parent) {
-			_set_assoc_limits_for_add(mysql_conn, object);
+			_set_assoc_limits_for_add(mysql_conn, object,
+						  &limits_cache);
 			if (object->lft == NO_VAL)
 				_set_assoc_lft_rgt(mysql_conn, object);
 		}
@@ -3022,6 +3097,7 @@ end_it:
 			assoc_cond.cluster_list = local_cluster_list;
 			if (!(assoc_list_tmp =
 			      as_mysql_get_assocs(mysql_conn, uid, NULL))) {
+				_clear_parent_limits_cache(&limits_cache);
 				FREE_NULL_LIST(local_cluster_list);
 				return rc;
 			}
@@ -3048,6 +3124,7 @@ end_it:
 		xfree(txn_query);
 		reset_mysql_conn(mysql_conn);
 	}
+	_clear_parent_limits_cache(&limits_cache);
 	FREE_NULL_LIST(local_cluster_list);
 	return rc;
 }
@@ -76,6 +76,105 @@ static char *_average_tres_usage(uint32_t *tres_ids, uint64_t *tres_cnts,
 	return ret_str;
 }
 
+/* Cache of db_index values recently handed out or looked up here.
+ *
+ * When the controller doesn't know a job's db_index (e.g. the start
+ * record went out while the database was unreachable) every subsequent
+ * message for that job would otherwise cost a select against the job
+ * table.  Remembering the index bounds that to at most one lookup (or
+ * insert) per job.  Keyed the same way as _get_db_index() below, plus
+ * the cluster name since one slurmdbd can serve many clusters.
+ */
+typedef struct {
+	char *cluster;
+	uint64_t db_index;
+	uint32_t job_id;
+	time_t submit;
+} db_inx_cache_entry_t;
+
+#define DB_INX_CACHE_MAX 4096
+
+static List db_inx_cache_list = NULL;
+static pthread_mutex_t db_inx_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void _free_db_inx_cache_entry(void *object)
+{
+	db_inx_cache_entry_t *entry = (db_inx_cache_entry_t *) object;
+
+	if (entry) {
+		xfree(entry->cluster);
+		xfree(entry);
+	}
+}
+
+static int _find_db_inx_cache_entry(void *x, void *key)
+{
+	db_inx_cache_entry_t *entry = (db_inx_cache_entry_t *) x;
+	db_inx_cache_entry_t *target = (db_inx_cache_entry_t *) key;
+
+	if ((entry->job_id == target->job_id) &&
+	    (entry->submit == target->submit) &&
+	    !xstrcmp(entry->cluster, target->cluster))
+		return 1;
+	return 0;
+}
+
+static void _cache_db_index(mysql_conn_t *mysql_conn, time_t submit,
+			    uint32_t jobid, uint64_t db_index)
+{
+	db_inx_cache_entry_t *entry, target;
+
+	if (!db_index)
+		return;
+
+	memset(&target, 0, sizeof(target));
+	target.cluster = mysql_conn->cluster_name;
+	target.job_id = jobid;
+	target.submit = submit;
+
+	slurm_mutex_lock(&db_inx_cache_lock);
+	if (!db_inx_cache_list)
+		db_inx_cache_list = list_create(_free_db_inx_cache_entry);
+	if ((entry = list_find_first(db_inx_cache_list,
+				     _find_db_inx_cache_entry, &target))) {
+		entry->db_index = db_index;
+		slurm_mutex_unlock(&db_inx_cache_lock);
+		return;
+	}
+	/* Evict the oldest entry rather than growing without bound. */
+	while (list_count(db_inx_cache_list) >= DB_INX_CACHE_MAX)
+		_free_db_inx_cache_entry(list_dequeue(db_inx_cache_list));
+
+	entry = xmalloc(sizeof(db_inx_cache_entry_t));
+	entry->cluster = xstrdup(mysql_conn->cluster_name);
+	entry->db_index = db_index;
+	entry->job_id = jobid;
+	entry->submit = submit;
+	list_append(db_inx_cache_list, entry);
+	slurm_mutex_unlock(&db_inx_cache_lock);
+}
+
+static uint64_t _get_cached_db_index(mysql_conn_t *mysql_conn, time_t submit,
+				     uint32_t jobid)
+{
+	db_inx_cache_entry_t *entry, target;
+	uint64_t db_index = 0;
+
+	memset(&target, 0, sizeof(target));
+	target.cluster = mysql_conn->cluster_name;
+	target.job_id = jobid;
+	target.submit = submit;
+
+	slurm_mutex_lock(&db_inx_cache_lock);
+	if (db_inx_cache_list &&
+	    (entry = list_find_first(db_inx_cache_list,
+				     _find_db_inx_cache_entry, &target)))
+		db_index = entry->db_index;
+	slurm_mutex_unlock(&db_inx_cache_lock);
+
+	return db_index;
+}
+
 /* Used in job functions for getting the database index based off the
  * submit time and job.  0 is returned if none is found
  */
@@ -85,10 +184,15 @@ static uint64_t _get_db_index(mysql_conn_t *mysql_conn,
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
 	uint64_t db_index = 0;
-	char *query = xstrdup_printf("select job_db_inx from \"%s_%s\" where "
-				     "time_submit=%d and id_job=%u",
-				     mysql_conn->cluster_name, job_table,
-				     (int)submit, jobid);
+	char *query;
+
+	if ((db_index = _get_cached_db_index(mysql_conn, submit, jobid)))
+		return db_index;
+
+	query = xstrdup_printf("select job_db_inx from \"%s_%s\" where "
+			       "time_submit=%d and id_job=%u",
+			       mysql_conn->cluster_name, job_table,
+			       (int)submit, jobid);
 
 	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
 		xfree(query);
@@ -109,6 +213,8 @@ static uint64_t _get_db_index(mysql_conn_t *mysql_conn,
 	db_index = slurm_atoull(row[0]);
 	mysql_free_result(result);
 
+	_cache_db_index(mysql_conn, submit, jobid, db_index);
+
 	return db_index;
 }
 
@@ -636,6 +742,9 @@ no_rollup_change:
 			} else
 				rc = SLURM_ERROR;
 		}
+		if (job_ptr->db_index)
+			_cache_db_index(mysql_conn, submit_time,
+					job_ptr->job_id, job_ptr->db_index);
 	} else {
 		query = xstrdup_printf("update \"%s_%s\" set nodelist='%s', ",
 				       mysql_conn->cluster_name,
@@ -999,6 +1108,9 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 	char *node_inx = NULL;
 	time_t start_time, submit_time;
 	char *query = NULL;
+	char *step_name = NULL, *tres_alloc = NULL;
+	int start, state;
+	MYSQL_BIND binds[24], *bind;
 
 	if (!step_ptr->job_ptr->db_index
 	    && ((!step_ptr->job_ptr->details
@@ -1102,35 +1214,64 @@ extern int as_mysql_step_start(mysql_conn_t *mysql_conn,
 		}
 	}
 
-	/* we want to print a -1 for the requid so leave it a
-	   %d */
-	/* The stepid could be -2 so use %d not %u */
+	start = (int)start_time;
+	state = JOB_RUNNING;
+	step_name = step_ptr->name ? step_ptr->name : "";
+	tres_alloc = step_ptr->tres_alloc_str ? step_ptr->tres_alloc_str : "";
+	if (!node_inx)
+		node_inx = "";
+
+	/*
+	 * This runs for every step on the system, so it goes through a
+	 * cached prepared statement with bound parameters rather than
+	 * being parsed by the server each time.
+	 */
 	query = xstrdup_printf(
 		"insert into \"%s_%s\" (job_db_inx, id_step, time_start, "
 		"step_name, state, tres_alloc, "
 		"nodes_alloc, task_cnt, nodelist, node_inx, "
 		"task_dist, req_cpufreq, req_cpufreq_min, req_cpufreq_gov) "
-		"values (%"PRIu64", %d, %d, '%s', %d, '%s', %d, %d, "
-		"'%s', '%s', %d, %u, %u, %u) "
+		"values (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
 		"on duplicate key update "
-		"nodes_alloc=%d, task_cnt=%d, time_end=0, state=%d, "
-		"nodelist='%s', node_inx='%s', task_dist=%d, "
-		"req_cpufreq=%u, req_cpufreq_min=%u, req_cpufreq_gov=%u,"
-		"tres_alloc='%s';",
-		mysql_conn->cluster_name, step_table,
-		step_ptr->job_ptr->db_index,
-		step_ptr->step_id,
-		(int)start_time, step_ptr->name,
-		JOB_RUNNING, step_ptr->tres_alloc_str,
-		nodes, tasks, node_list, node_inx, task_dist,
-		step_ptr->cpu_freq_max, step_ptr->cpu_freq_min,
-		step_ptr->cpu_freq_gov, nodes, tasks, JOB_RUNNING,
-		node_list, node_inx, task_dist, step_ptr->cpu_freq_max,
-		step_ptr->cpu_freq_min, step_ptr->cpu_freq_gov,
-		step_ptr->tres_alloc_str);
+		"nodes_alloc=?, task_cnt=?, time_end=0, state=?, "
+		"nodelist=?, node_inx=?, task_dist=?, "
+		"req_cpufreq=?, req_cpufreq_min=?, req_cpufreq_gov=?,"
+		"tres_alloc=?;",
+		mysql_conn->cluster_name, step_table);
+
+	memset(binds, 0, sizeof(binds));
+	bind = binds;
+	mysql_bind_uint64(bind++, &step_ptr->job_ptr->db_index);
+	/* The stepid could be -2 so bind it signed */
+	mysql_bind_int32(bind++, &step_ptr->step_id);
+	mysql_bind_int32(bind++, &start);
+	mysql_bind_str(bind++, step_name);
+	mysql_bind_int32(bind++, &state);
+	mysql_bind_str(bind++, tres_alloc);
+	mysql_bind_int32(bind++, &nodes);
+	mysql_bind_int32(bind++, &tasks);
+	mysql_bind_str(bind++, node_list);
+	mysql_bind_str(bind++, node_inx);
+	mysql_bind_int32(bind++, &task_dist);
+	mysql_bind_uint32(bind++, &step_ptr->cpu_freq_max);
+	mysql_bind_uint32(bind++, &step_ptr->cpu_freq_min);
+	mysql_bind_uint32(bind++, &step_ptr->cpu_freq_gov);
+	/* on duplicate key update */
+	mysql_bind_int32(bind++, &nodes);
+	mysql_bind_int32(bind++, &tasks);
+	mysql_bind_int32(bind++, &state);
+	mysql_bind_str(bind++, node_list);
+	mysql_bind_str(bind++, node_inx);
+	mysql_bind_int32(bind++, &task_dist);
+	mysql_bind_uint32(bind++, &step_ptr->cpu_freq_max);
+	mysql_bind_uint32(bind++, &step_ptr->cpu_freq_min);
+	mysql_bind_uint32(bind++, &step_ptr->cpu_freq_gov);
+	mysql_bind_str(bind++, tres_alloc);
+
 	if (debug_flags & DEBUG_FLAG_DB_STEP)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	rc = mysql_db_query(mysql_conn, query);
+	rc = mysql_db_execute_prepared(mysql_conn, query, binds,
+				       bind - binds);
 	xfree(query);
 
 	return rc;
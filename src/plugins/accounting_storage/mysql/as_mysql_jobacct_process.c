@@ -474,6 +474,7 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 	slurmdb_job_rec_t *job = NULL;
 	slurmdb_step_rec_t *step = NULL;
 	time_t now = time(NULL);
+	mysql_conn_t *stream_conn = NULL;
 	List job_list = list_create(slurmdb_destroy_job_rec);
 	ListIterator itr = NULL, itr2 = NULL;
 	List local_cluster_list = NULL;
@@ -587,7 +588,22 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 
 	if (debug_flags & DEBUG_FLAG_DB_JOB)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
-	if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
+
+	/* Stream the job rows through a server-side cursor on a private
+	 * connection so a wide query (e.g. a month of jobs) does not
+	 * materialize the entire result set in this daemon's memory.
+	 * The nested suspend/step queries below keep using the caller's
+	 * connection, which a cursor would otherwise monopolize.  If a
+	 * second connection can not be opened fall back to the old
+	 * store-everything behavior.
+	 */
+	if ((stream_conn = get_stream_conn(mysql_conn))) {
+		if (!(result = mysql_db_query_ret_use(stream_conn, query))) {
+			xfree(query);
+			rc = SLURM_ERROR;
+			goto end_it;
+		}
+	} else if (!(result = mysql_db_query_ret(mysql_conn, query, 0))) {
 		xfree(query);
 		rc = SLURM_ERROR;
 		goto end_it;
@@ -1112,9 +1128,19 @@ static int _cluster_get_jobs(mysql_conn_t *mysql_conn,
 		/* need to reset here to make the above test valid */
 		step = NULL;
 	}
+	/* A cursor fetch can fail mid-stream (e.g. on a lost
+	 * connection), which ends the loop just like a normal EOF. */
+	if (stream_conn && mysql_errno(stream_conn->db_conn)) {
+		error("stream fetch of jobs from cluster %s failed: %s",
+		      cluster_name, mysql_error(stream_conn->db_conn));
+		rc = SLURM_ERROR;
+	}
 	mysql_free_result(result);
 
 end_it:
+	if (stream_conn)
+		destroy_mysql_conn(stream_conn);
+
 	if (itr2)
 		list_iterator_destroy(itr2);
 
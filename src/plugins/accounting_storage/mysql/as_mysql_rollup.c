@@ -948,11 +948,13 @@ static local_cluster_usage_t *_setup_cluster_usage(mysql_conn_t *mysql_conn,
 extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 				  char *cluster_name,
 				  time_t start, time_t end,
-				  uint16_t archive_data)
+				  uint16_t archive_data,
+				  bool track_progress)
 {
 	int rc = SLURM_SUCCESS;
 	int add_sec = 3600;
 	int i=0;
+	int hours_rolled = 0;
 	time_t now = time(NULL);
 	time_t curr_start = start;
 	time_t curr_end = curr_start + add_sec;
@@ -1668,6 +1670,39 @@ extern int as_mysql_hourly_rollup(mysql_conn_t *mysql_conn,
 		list_flush(resv_usage_list);
 		curr_start = curr_end;
 		curr_end = curr_start + add_sec;
+
+		/* When catching up many hours (e.g. after dbd downtime)
+		   commit each day's worth of buckets along with the matching
+		   last_ran position instead of holding one transaction for
+		   the entire catch-up.  A week long catch-up used to hold
+		   row locks on the usage and reservation tables for hours,
+		   blocking unrelated operations, and a failure or crash
+		   threw away all progress.  The buckets themselves have to
+		   stay sequential: each hour's reservation accounting reads
+		   the unused_wall its predecessor wrote.
+		*/
+		if (track_progress && (curr_start < end) &&
+		    !(++hours_rolled % 24)) {
+			query = xstrdup_printf(
+				"update \"%s_%s\" set hourly_rollup=%ld",
+				cluster_name, last_ran_table, curr_start);
+			if (debug_flags & DEBUG_FLAG_DB_USAGE)
+				DB_DEBUG(mysql_conn->conn, "query\n%s", query);
+			rc = mysql_db_query(mysql_conn, query);
+			xfree(query);
+			if (rc != SLURM_SUCCESS) {
+				error("Couldn't update last_ran for cluster %s",
+				      cluster_name);
+				goto end_it;
+			}
+			if (mysql_db_commit(mysql_conn)) {
+				error("Couldn't commit cluster (%s) hour "
+				      "rollup at %ld",
+				      cluster_name, curr_start);
+				rc = SLURM_ERROR;
+				goto end_it;
+			}
+		}
 	}
 end_it:
 	xfree(query);
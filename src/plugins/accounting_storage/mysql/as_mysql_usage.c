@@ -293,7 +293,8 @@ static void *_cluster_rollup_usage(void *arg)
 					    local_rollup->cluster_name,
 					    hour_start,
 					    hour_end,
-					    local_rollup->archive_data);
+					    local_rollup->archive_data,
+					    !local_rollup->sent_end);
 		snprintf(timer_str, sizeof(timer_str),
 			 "hourly_rollup for %s", local_rollup->cluster_name);
 		END_TIMER3(timer_str, 5000000);
@@ -407,6 +408,174 @@ end_it:
 }
 
 /* assoc_mgr locks need to be unlocked before coming here */
+/* A sub-period of a usage request served from one rollup table */
+typedef struct {
+	time_t start;
+	time_t end;
+	char *table;		/* borrowed, never freed */
+} usage_span_t;
+
+static void _destroy_usage_span(void *object)
+{
+	xfree(object);
+}
+
+static void _append_usage_span(List span_list, char *table,
+			       time_t start, time_t end)
+{
+	usage_span_t *span;
+
+	if (end <= start)
+		return;
+	span = xmalloc(sizeof(usage_span_t));
+	span->table = table;
+	span->start = start;
+	span->end = end;
+	list_append(span_list, span);
+}
+
+/* midnight at or after t */
+static time_t _next_day(time_t t)
+{
+	struct tm tm;
+
+	if (!slurm_localtime_r(&t, &tm))
+		return t;
+	if (tm.tm_sec || tm.tm_min || tm.tm_hour) {
+		tm.tm_sec = tm.tm_min = tm.tm_hour = 0;
+		tm.tm_mday++;
+	}
+	return slurm_mktime(&tm);
+}
+
+/* midnight at or before t */
+static time_t _prev_day(time_t t)
+{
+	struct tm tm;
+
+	if (!slurm_localtime_r(&t, &tm))
+		return t;
+	tm.tm_sec = tm.tm_min = tm.tm_hour = 0;
+	return slurm_mktime(&tm);
+}
+
+/* month boundary at or after t */
+static time_t _next_month(time_t t)
+{
+	struct tm tm;
+
+	if (!slurm_localtime_r(&t, &tm))
+		return t;
+	if (tm.tm_sec || tm.tm_min || tm.tm_hour || (tm.tm_mday != 1)) {
+		tm.tm_sec = tm.tm_min = tm.tm_hour = 0;
+		tm.tm_mday = 1;
+		tm.tm_mon++;
+	}
+	return slurm_mktime(&tm);
+}
+
+/* month boundary at or before t */
+static time_t _prev_month(time_t t)
+{
+	struct tm tm;
+
+	if (!slurm_localtime_r(&t, &tm))
+		return t;
+	tm.tm_sec = tm.tm_min = tm.tm_hour = 0;
+	tm.tm_mday = 1;
+	return slurm_mktime(&tm);
+}
+
+/*
+ * Decompose the requested period into sub-periods, each read from the
+ * coarsest rollup table that covers it: partial days from the hour
+ * table, partial months from the day table and whole months from the
+ * month table.  set_usage_information() alone drops the entire period
+ * to the hour table as soon as one boundary is off a day boundary,
+ * which makes reports over long periods rescan months of hourly rows;
+ * the rollup tables are already maintained incrementally, so reading
+ * the coarsest one for every sub-period gets report latency down to the
+ * handful of rows actually needed.
+ * RET list of usage_span_t (start/end normalized in usage_start and
+ * usage_end as set_usage_information() does) or NULL on error.
+ */
+static List _get_usage_spans(char *usage_table, slurmdbd_msg_type_t type,
+			     time_t *usage_start, time_t *usage_end)
+{
+	char *hour_table = NULL, *day_table = NULL, *month_table = NULL;
+	List span_list;
+	time_t start, end, limit, day0, dayn, mon0, monn;
+
+	if (set_usage_information(&usage_table, type, usage_start, usage_end)
+	    != SLURM_SUCCESS)
+		return NULL;
+	start = *usage_start;
+	end = *usage_end;
+
+	switch (type) {
+	case DBD_GET_ASSOC_USAGE:
+		hour_table = assoc_hour_table;
+		day_table = assoc_day_table;
+		month_table = assoc_month_table;
+		break;
+	case DBD_GET_WCKEY_USAGE:
+		hour_table = wckey_hour_table;
+		day_table = wckey_day_table;
+		month_table = wckey_month_table;
+		break;
+	case DBD_GET_CLUSTER_USAGE:
+		hour_table = cluster_hour_table;
+		day_table = cluster_day_table;
+		month_table = cluster_month_table;
+		break;
+	default:
+		break;
+	}
+
+	span_list = list_create(_destroy_usage_span);
+
+	if (!hour_table || (usage_table == month_table) || (end <= start)) {
+		/*
+		 * Unknown type, already on the coarsest table, or a
+		 * degenerate period: keep the old single query shape.
+		 */
+		usage_span_t *span = xmalloc(sizeof(usage_span_t));
+		span->table = usage_table;
+		span->start = start;
+		span->end = end;
+		list_append(span_list, span);
+		return span_list;
+	}
+
+	/*
+	 * Rollups past the last finished day may not exist yet, so keep
+	 * everything after the previous midnight on the hour table just
+	 * as set_usage_information() does for such a period.
+	 */
+	limit = MIN(end, _prev_day(time(NULL)));
+
+	day0 = _next_day(start);
+	dayn = (limit > day0) ? _prev_day(limit) : day0;
+	if (dayn <= day0) {
+		/* no whole day to serve from a coarser table */
+		_append_usage_span(span_list, usage_table, start, end);
+		return span_list;
+	}
+
+	_append_usage_span(span_list, hour_table, start, day0);
+	mon0 = _next_month(day0);
+	monn = (dayn > mon0) ? _prev_month(dayn) : mon0;
+	if (monn > mon0) {
+		_append_usage_span(span_list, day_table, day0, mon0);
+		_append_usage_span(span_list, month_table, mon0, monn);
+		_append_usage_span(span_list, day_table, monn, dayn);
+	} else
+		_append_usage_span(span_list, day_table, day0, dayn);
+	_append_usage_span(span_list, hour_table, dayn, end);
+
+	return span_list;
+}
+
 static int _get_object_usage(mysql_conn_t *mysql_conn,
 			     slurmdbd_msg_type_t type, char *my_usage_table,
 			     char *cluster_name, char *id_str,
@@ -417,6 +586,9 @@ static int _get_object_usage(mysql_conn_t *mysql_conn,
 	MYSQL_RES *result = NULL;
 	MYSQL_ROW row;
 	char *query = NULL;
+	List span_list = NULL;
+	ListIterator s_itr;
+	usage_span_t *span;
 	assoc_mgr_lock_t locks = { NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
 				   READ_LOCK, NO_LOCK, NO_LOCK };
 
@@ -434,42 +606,70 @@ static int _get_object_usage(mysql_conn_t *mysql_conn,
 		USAGE_COUNT
 	};
 
-	if (type == DBD_GET_WCKEY_USAGE)
-		usage_req_inx[0] = "t1.id";
-
-	xstrfmtcat(tmp, "%s", usage_req_inx[i]);
-	for (i=1; i<USAGE_COUNT; i++) {
-		xstrfmtcat(tmp, ", %s", usage_req_inx[i]);
-	}
-
 	switch (type) {
 	case DBD_GET_ASSOC_USAGE:
-		query = xstrdup_printf(
-			"select %s from \"%s_%s\" as t1, "
-			"\"%s_%s\" as t2, \"%s_%s\" as t3 "
-			"where (t1.time_start < %ld && t1.time_start >= %ld) "
-			"&& t1.id=t2.id_assoc && (%s) && "
-			"t2.lft between t3.lft and t3.rgt "
-			"order by t3.id_assoc, time_start;",
-			tmp, cluster_name, my_usage_table,
-			cluster_name, assoc_table, cluster_name, assoc_table,
-			end, start, id_str);
-		break;
 	case DBD_GET_WCKEY_USAGE:
-		query = xstrdup_printf(
-			"select %s from \"%s_%s\" as t1 "
-			"where (time_start < %ld && time_start >= %ld) "
-			"&& (%s) order by id, time_start;",
-			tmp, cluster_name, my_usage_table, end, start, id_str);
 		break;
 	default:
 		error("Unknown usage type %d", type);
-		xfree(tmp);
 		return SLURM_ERROR;
 		break;
 	}
+
+	if (!(span_list = _get_usage_spans(my_usage_table, type, &start, &end)))
+		return SLURM_ERROR;
+
+	if (type == DBD_GET_WCKEY_USAGE)
+		usage_req_inx[0] = "t1.id";
+
+	xstrfmtcat(tmp, "%s", usage_req_inx[i]);
+	for (i=1; i<USAGE_COUNT; i++) {
+		xstrfmtcat(tmp, ", %s", usage_req_inx[i]);
+	}
+
+	s_itr = list_iterator_create(span_list);
+	while ((span = list_next(s_itr))) {
+		switch (type) {
+		case DBD_GET_ASSOC_USAGE:
+			xstrfmtcat(query,
+				   "%sselect %s from \"%s_%s\" as t1, "
+				   "\"%s_%s\" as t2, \"%s_%s\" as t3 "
+				   "where (t1.time_start < %ld && "
+				   "t1.time_start >= %ld) "
+				   "&& t1.id=t2.id_assoc && (%s) && "
+				   "t2.lft between t3.lft and t3.rgt",
+				   query ? " union all " : "",
+				   tmp, cluster_name, span->table,
+				   cluster_name, assoc_table,
+				   cluster_name, assoc_table,
+				   span->end, span->start, id_str);
+			break;
+		case DBD_GET_WCKEY_USAGE:
+			xstrfmtcat(query,
+				   "%sselect %s from \"%s_%s\" as t1 "
+				   "where (time_start < %ld && "
+				   "time_start >= %ld) && (%s)",
+				   query ? " union all " : "",
+				   tmp, cluster_name, span->table,
+				   span->end, span->start, id_str);
+			break;
+		default:
+			break;
+		}
+	}
+	list_iterator_destroy(s_itr);
+	FREE_NULL_LIST(span_list);
 	xfree(tmp);
 
+	/*
+	 * get_usage_for_list() merges by walking the objects and the
+	 * usage in lockstep, so keep the rows id ordered across spans.
+	 */
+	if (type == DBD_GET_WCKEY_USAGE)
+		xstrcat(query, " order by id, time_start;");
+	else
+		xstrcat(query, " order by id_assoc, time_start;");
+
 	if (debug_flags & DEBUG_FLAG_DB_USAGE)
 		DB_DEBUG(mysql_conn->conn, "query\n%s", query);
 	result = mysql_db_query_ret(mysql_conn, query, 0);
@@ -523,6 +723,9 @@ static int _get_cluster_usage(mysql_conn_t *mysql_conn, uid_t uid,
 	char *tmp = NULL;
 	char *my_usage_table = cluster_day_table;
 	char *query = NULL;
+	List span_list = NULL;
+	ListIterator s_itr;
+	usage_span_t *span;
 	assoc_mgr_lock_t locks = { NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
 				   READ_LOCK, NO_LOCK, NO_LOCK };
 	char *cluster_req_inx[] = {
@@ -555,10 +758,8 @@ static int _get_cluster_usage(mysql_conn_t *mysql_conn, uid_t uid,
 		return SLURM_ERROR;
 	}
 
-	if (set_usage_information(&my_usage_table, type, &start, &end)
-	    != SLURM_SUCCESS) {
+	if (!(span_list = _get_usage_spans(my_usage_table, type, &start, &end)))
 		return SLURM_ERROR;
-	}
 
 	xfree(tmp);
 	i=0;
@@ -567,10 +768,17 @@ static int _get_cluster_usage(mysql_conn_t *mysql_conn, uid_t uid,
 		xstrfmtcat(tmp, ", %s", cluster_req_inx[i]);
 	}
 
-	query = xstrdup_printf(
-		"select %s from \"%s_%s\" where (time_start < %ld "
-		"&& time_start >= %ld)",
-		tmp, cluster_rec->name, my_usage_table, end, start);
+	s_itr = list_iterator_create(span_list);
+	while ((span = list_next(s_itr))) {
+		xstrfmtcat(query,
+			   "%sselect %s from \"%s_%s\" where "
+			   "(time_start < %ld && time_start >= %ld)",
+			   query ? " union all " : "", tmp,
+			   cluster_rec->name, span->table,
+			   span->end, span->start);
+	}
+	list_iterator_destroy(s_itr);
+	FREE_NULL_LIST(span_list);
 
 	xfree(tmp);
 	if (debug_flags & DEBUG_FLAG_DB_USAGE)
@@ -706,12 +914,6 @@ extern int get_usage_for_list(mysql_conn_t *mysql_conn,
 		hostlist_destroy(hl);
 	}
 
-	if (set_usage_information(&my_usage_table, type, &start, &end)
-	    != SLURM_SUCCESS) {
-		xfree(id_str);
-		return SLURM_ERROR;
-	}
-
 	if (_get_object_usage(mysql_conn, type, my_usage_table, cluster_name,
 			      id_str, start, end, &usage_list)
 	    != SLURM_SUCCESS) {
@@ -898,12 +1100,6 @@ extern int as_mysql_get_usage(mysql_conn_t *mysql_conn, uid_t uid,
 	}
 is_user:
 
-	if (set_usage_information(&my_usage_table, type, &start, &end)
-	    != SLURM_SUCCESS) {
-		xfree(id_str);
-		return SLURM_ERROR;
-	}
-
 	_get_object_usage(mysql_conn, type, my_usage_table, cluster_name,
 			  id_str, start, end, my_list);
 	xfree(id_str);
@@ -41,6 +41,7 @@
 
 #include "src/common/fd.h"
 #include "src/common/slurmdbd_pack.h"
+#include "src/common/timers.h"
 #include "src/common/xsignal.h"
 #include "src/common/xstring.h"
 
@@ -55,6 +56,23 @@ static pthread_cond_t  agent_cond = PTHREAD_COND_INITIALIZER;
 static List      agent_list     = (List) NULL;
 static pthread_t agent_tid      = 0;
 
+/* On-disk overflow spool for the agent queue, guarded by agent_lock.
+ * Once the in-memory queue is full, further messages are appended to
+ * the spool file and read back in send order as the queue drains, so a
+ * long SlurmDBD outage costs disk space instead of controller memory
+ * or discarded records. */
+#define DBD_SPOOL_MAGIC	0x44425370
+#define SPOOL_HDR_SIZE	(sizeof(uint32_t) + sizeof(uint16_t) +	\
+			 sizeof(uint64_t))
+static int      spool_fd   = -1;
+static uint64_t spool_head = 0;	/* offset of first unconsumed record */
+static uint64_t spool_tail = 0;	/* append offset (end of file) */
+static uint32_t spool_cnt  = 0;	/* records in [spool_head, spool_tail) */
+
+static void _spool_recover(void);
+
+static int dbd_qid = -1;	/* queue telemetry, see timers.h */
+
 static bool      halt_agent          = 0;
 static time_t    slurmdbd_shutdown   = 0;
 static char *    slurmdbd_cluster    = NULL;
@@ -195,6 +213,7 @@ static int _handle_mult_rc_ret(void)
 
 				if ((b = list_dequeue(agent_list))) {
 					free_buf(b);
+					queue_stats_dequeued(dbd_qid);
 				} else {
 					error("slurmdbd: DBD_GOT_MULT_MSG "
 					      "unpack message error");
@@ -369,6 +388,7 @@ static void _load_dbd_state(void)
 			}
 			if (!list_enqueue(agent_list, buffer))
 				fatal("slurmdbd: list_enqueue, no memory");
+			queue_stats_enqueued(dbd_qid);
 			recovered++;
 			buffer = NULL;
 		}
@@ -378,6 +398,7 @@ static void _load_dbd_state(void)
 		(void) close(fd);
 	}
 	xfree(dbd_fname);
+	_spool_recover();
 }
 
 static int _save_dbd_rec(int fd, Buf buffer)
@@ -479,6 +500,268 @@ end_it:
 	xfree(dbd_fname);
 }
 
+static char *_spool_fname(void)
+{
+	char *fname = slurm_get_state_save_location();
+	xstrcat(fname, "/dbd.spool");
+	return fname;
+}
+
+/* (Re)write the spool file header: magic, protocol version and the
+ * offset of the first unconsumed record */
+static int _spool_write_header(void)
+{
+	uint32_t magic = DBD_SPOOL_MAGIC;
+	uint16_t version = SLURM_PROTOCOL_VERSION;
+	char hdr[SPOOL_HDR_SIZE];
+
+	memcpy(hdr, &magic, sizeof(magic));
+	memcpy(hdr + sizeof(magic), &version, sizeof(version));
+	memcpy(hdr + sizeof(magic) + sizeof(version), &spool_head,
+	       sizeof(spool_head));
+	if (pwrite(spool_fd, hdr, sizeof(hdr), 0) != sizeof(hdr)) {
+		error("slurmdbd: spool header write error: %m");
+		return SLURM_ERROR;
+	}
+	return SLURM_SUCCESS;
+}
+
+/* Truncate the spool back down to an empty file so consumed records do
+ * not occupy disk space indefinitely */
+static void _spool_reset(void)
+{
+	spool_head = spool_tail = SPOOL_HDR_SIZE;
+	spool_cnt = 0;
+	if (ftruncate(spool_fd, SPOOL_HDR_SIZE))
+		error("slurmdbd: spool truncate error: %m");
+	(void) _spool_write_header();
+}
+
+static int _spool_create(void)
+{
+	char *fname = _spool_fname();
+
+	spool_fd = open(fname, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (spool_fd < 0) {
+		error("slurmdbd: Creating spool file %s: %m", fname);
+		xfree(fname);
+		return SLURM_ERROR;
+	}
+	xfree(fname);
+	spool_head = spool_tail = SPOOL_HDR_SIZE;
+	spool_cnt = 0;
+	return _spool_write_header();
+}
+
+/* Append one packed message to the tail of the spool.
+ * Call with agent_lock set.
+ * RET SLURM_SUCCESS if the record is safely on disk */
+static int _spool_append(Buf buffer)
+{
+	off_t offset;
+
+	if ((spool_fd < 0) && (_spool_create() != SLURM_SUCCESS))
+		return SLURM_ERROR;
+
+	if (lseek(spool_fd, spool_tail, SEEK_SET) < 0) {
+		error("slurmdbd: spool seek error: %m");
+		return SLURM_ERROR;
+	}
+	if (_save_dbd_rec(spool_fd, buffer) != SLURM_SUCCESS) {
+		/* A partial record would corrupt the spool, cut it off */
+		if (ftruncate(spool_fd, spool_tail))
+			error("slurmdbd: spool truncate error: %m");
+		return SLURM_ERROR;
+	}
+	if ((offset = lseek(spool_fd, 0, SEEK_CUR)) < 0) {
+		error("slurmdbd: spool seek error: %m");
+		return SLURM_ERROR;
+	}
+	spool_tail = offset;
+	spool_cnt++;
+	return SLURM_SUCCESS;
+}
+
+/* Move up to max_recs records from the head of the spool onto the tail
+ * of agent_list, preserving the order they were queued in.
+ * Call with agent_lock set. */
+static void _spool_refill(int max_recs)
+{
+	Buf buffer;
+	off_t offset;
+	int fetched = 0;
+
+	if ((spool_fd < 0) || (spool_cnt == 0))
+		return;
+
+	if (lseek(spool_fd, spool_head, SEEK_SET) < 0) {
+		error("slurmdbd: spool seek error: %m");
+		return;
+	}
+	while (spool_cnt && (fetched < max_recs)) {
+		if (!(buffer = _load_dbd_rec(spool_fd))) {
+			error("slurmdbd: spool file corrupt, "
+			      "discarding %u spooled messages", spool_cnt);
+			_spool_reset();
+			return;
+		}
+		if (!list_enqueue(agent_list, buffer))
+			fatal("slurmdbd: list_enqueue, no memory");
+		spool_cnt--;
+		fetched++;
+	}
+	if ((offset = lseek(spool_fd, 0, SEEK_CUR)) >= 0)
+		spool_head = offset;
+
+	/* Persist the new head so records already moved to the queue are
+	 * not replayed after a restart. A crash before _save_dbd_state()
+	 * runs can still resend them, which the DBD tolerates. */
+	if (spool_cnt == 0)
+		_spool_reset();
+	else
+		(void) _spool_write_header();
+}
+
+/* Convert a spool written by a prior release to the current protocol
+ * version, record by record, then take over the converted file */
+static void _spool_convert(int old_fd, uint16_t old_version,
+			   uint64_t old_head)
+{
+	char *fname = _spool_fname(), *new_fname = NULL;
+	Buf buffer, new_buf;
+	int converted = 0;
+
+	xstrfmtcat(new_fname, "%s.new", fname);
+	spool_fd = open(new_fname, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	if (spool_fd < 0) {
+		error("slurmdbd: Creating spool file %s: %m", new_fname);
+		goto end_it;
+	}
+	spool_head = spool_tail = SPOOL_HDR_SIZE;
+	spool_cnt = 0;
+	if (_spool_write_header() != SLURM_SUCCESS)
+		goto end_it;
+
+	if (lseek(old_fd, old_head, SEEK_SET) < 0)
+		goto end_it;
+	while ((buffer = _load_dbd_rec(old_fd))) {
+		slurmdbd_msg_t msg;
+		int rc;
+		set_buf_offset(buffer, 0);
+		rc = unpack_slurmdbd_msg(&msg, old_version, buffer);
+		free_buf(buffer);
+		if (rc != SLURM_SUCCESS)
+			continue;
+		if (!(new_buf = pack_slurmdbd_msg(&msg,
+						  SLURM_PROTOCOL_VERSION)))
+			continue;
+		if (_spool_append(new_buf) == SLURM_SUCCESS)
+			converted++;
+		free_buf(new_buf);
+	}
+	if (rename(new_fname, fname))
+		error("slurmdbd: renaming spool file %s: %m", new_fname);
+	verbose("slurmdbd: converted %d spooled messages to current version",
+		converted);
+end_it:
+	(void) close(old_fd);
+	xfree(new_fname);
+	xfree(fname);
+}
+
+/* Recover the overflow spool left by a prior run, if any.
+ * Call with agent_lock set. */
+static void _spool_recover(void)
+{
+	char *fname;
+	uint32_t magic = 0, msg_size;
+	uint16_t version = 0;
+	uint64_t head = 0;
+	off_t end, pos;
+	uint32_t cnt = 0;
+	int fd;
+
+	if (spool_fd >= 0)	/* already open */
+		return;
+
+	fname = _spool_fname();
+	fd = open(fname, O_RDWR);
+	if (fd < 0) {
+		if (errno != ENOENT)
+			error("slurmdbd: Opening spool file %s: %m", fname);
+		xfree(fname);
+		return;
+	}
+
+	if ((read(fd, &magic, sizeof(magic)) != sizeof(magic)) ||
+	    (magic != DBD_SPOOL_MAGIC) ||
+	    (read(fd, &version, sizeof(version)) != sizeof(version)) ||
+	    (read(fd, &head, sizeof(head)) != sizeof(head)) ||
+	    ((end = lseek(fd, 0, SEEK_END)) < 0) ||
+	    (head < SPOOL_HDR_SIZE) || (head > end)) {
+		error("slurmdbd: spool file %s unusable, ignoring", fname);
+		(void) close(fd);
+		xfree(fname);
+		return;
+	}
+	xfree(fname);
+
+	if (version != SLURM_PROTOCOL_VERSION) {
+		_spool_convert(fd, version, head);
+		return;
+	}
+
+	/* Count the unconsumed records, truncating at the first sign of
+	 * a short or torn write */
+	pos = head;
+	while (pos < end) {
+		if ((lseek(fd, pos, SEEK_SET) < 0) ||
+		    (read(fd, &msg_size, sizeof(msg_size)) !=
+		     sizeof(msg_size)) ||
+		    (msg_size > MAX_DBD_MSG_LEN) ||
+		    (lseek(fd, msg_size, SEEK_CUR) < 0) ||
+		    (read(fd, &magic, sizeof(magic)) != sizeof(magic)) ||
+		    (magic != DBD_MAGIC)) {
+			error("slurmdbd: spool file truncated at incomplete "
+			      "record");
+			end = pos;
+			if (ftruncate(fd, end))
+				error("slurmdbd: spool truncate error: %m");
+			break;
+		}
+		pos += sizeof(msg_size) + msg_size + sizeof(magic);
+		cnt++;
+	}
+
+	spool_fd = fd;
+	spool_head = head;
+	spool_tail = end;
+	spool_cnt = cnt;
+	if (spool_cnt)
+		verbose("slurmdbd: recovered %u spooled RPCs", spool_cnt);
+	else
+		_spool_reset();
+}
+
+/* Close the spool file, removing it if nothing is left to send.
+ * Call with agent_lock set. */
+static void _spool_close(void)
+{
+	char *fname;
+
+	if (spool_fd < 0)
+		return;
+	if (spool_cnt) {
+		fsync_and_close(spool_fd, "dbd.spool");
+	} else {
+		(void) close(spool_fd);
+		fname = _spool_fname();
+		(void) unlink(fname);
+		xfree(fname);
+	}
+	spool_fd = -1;
+}
+
 /* Open a connection to the Slurm DBD and set slurmdbd_conn */
 static void _open_slurmdbd_conn(bool need_db)
 {
@@ -614,6 +897,10 @@ static void *_agent(void *x)
 		}
 
 		slurm_mutex_lock(&agent_lock);
+		/* Top up the queue from the overflow spool as it drains */
+		if (agent_list && spool_cnt &&
+		    ((cnt = list_count(agent_list)) < 1000))
+			_spool_refill(1000 - cnt);
 		if (agent_list && slurmdbd_conn->fd)
 			cnt = list_count(agent_list);
 		else
@@ -669,7 +956,9 @@ static void *_agent(void *x)
 		/* NOTE: agent_lock is clear here, so we can add more
 		 * requests to the queue while waiting for this RPC to
 		 * complete. */
+		PHASE_TRACE_BEGIN(PHASE_TRACE_DBD_AGENT_SEND);
 		rc = slurm_persist_send_msg(slurmdbd_conn, buffer);
+		PHASE_TRACE_END(PHASE_TRACE_DBD_AGENT_SEND);
 		if (rc != SLURM_SUCCESS) {
 			if (*slurmdbd_conn->shutdown) {
 				slurm_mutex_unlock(&slurmdbd_lock);
@@ -706,8 +995,10 @@ static void *_agent(void *x)
 				if (list_msg.my_list != agent_list)
 					FREE_NULL_LIST(list_msg.my_list);
 				list_msg.my_list = NULL;
-			} else
+			} else {
 				buffer = (Buf) list_dequeue(agent_list);
+				queue_stats_dequeued(dbd_qid);
+			}
 
 			free_buf(buffer);
 			fail_time = 0;
@@ -729,11 +1020,25 @@ static void *_agent(void *x)
 
 	slurm_mutex_lock(&agent_lock);
 	_save_dbd_state();
+	_spool_close();
 	FREE_NULL_LIST(agent_list);
 	slurm_mutex_unlock(&agent_lock);
 	return NULL;
 }
 
+/* Pending messages, both queued in memory and overflowed to the spool */
+static int _dbd_queue_depth(void)
+{
+	int depth = 0;
+
+	slurm_mutex_lock(&agent_lock);
+	if (agent_list)
+		depth = list_count(agent_list) + spool_cnt;
+	slurm_mutex_unlock(&agent_lock);
+
+	return depth;
+}
+
 static void _create_agent(void)
 {
 	/* this needs to be set because the agent thread will do
@@ -742,6 +1047,9 @@ static void _create_agent(void)
 
 	if (agent_list == NULL) {
 		agent_list = list_create(slurmdbd_free_buffer);
+		if (dbd_qid < 0)
+			dbd_qid = queue_stats_register("dbd_agent",
+						       _dbd_queue_depth, NULL);
 		_load_dbd_state();
 	}
 
@@ -750,63 +1058,6 @@ static void _create_agent(void)
 	}
 }
 
-/* Purge queued step records from the agent queue
- * RET number of records purged */
-static int _purge_step_req(void)
-{
-	int purged = 0;
-	ListIterator iter;
-	uint16_t msg_type;
-	uint32_t offset;
-	Buf buffer;
-
-	iter = list_iterator_create(agent_list);
-	while ((buffer = list_next(iter))) {
-		offset = get_buf_offset(buffer);
-		if (offset < 2)
-			continue;
-		set_buf_offset(buffer, 0);
-		(void) unpack16(&msg_type, buffer);	/* checked by offset */
-		set_buf_offset(buffer, offset);
-		if ((msg_type == DBD_STEP_START) ||
-		    (msg_type == DBD_STEP_COMPLETE)) {
-			list_remove(iter);
-			purged++;
-		}
-	}
-	list_iterator_destroy(iter);
-	info("slurmdbd: purge %d step records", purged);
-	return purged;
-}
-
-/* Purge queued job start records from the agent queue
- * RET number of records purged */
-static int _purge_job_start_req(void)
-{
-	int purged = 0;
-	ListIterator iter;
-	uint16_t msg_type;
-	uint32_t offset;
-	Buf buffer;
-
-	iter = list_iterator_create(agent_list);
-	while ((buffer = list_next(iter))) {
-		offset = get_buf_offset(buffer);
-		if (offset < 2)
-			continue;
-		set_buf_offset(buffer, 0);
-		(void) unpack16(&msg_type, buffer);	/* checked by offset */
-		set_buf_offset(buffer, offset);
-		if (msg_type == DBD_JOB_START) {
-			list_remove(iter);
-			purged++;
-		}
-	}
-	list_iterator_destroy(iter);
-	info("slurmdbd: purge %d job start records", purged);
-	return purged;
-}
-
 static void _shutdown_agent(void)
 {
 	int i;
@@ -1084,23 +1335,32 @@ extern int send_slurmdbd_msg(uint16_t rpc_version, slurmdbd_msg_t *req)
 		if (slurmdbd_conn->trigger_callbacks.dbd_fail)
 			(slurmdbd_conn->trigger_callbacks.dbd_fail)();
 	}
-	if (cnt == (max_agent_queue - 1))
-		cnt -= _purge_step_req();
-	if (cnt == (max_agent_queue - 1))
-		cnt -= _purge_job_start_req();
-	if (cnt < max_agent_queue) {
-		if (list_enqueue(agent_list, buffer) == NULL)
-			fatal("list_enqueue: memory allocation failure");
-	} else {
-		error("slurmdbd: agent queue is full (%u), discarding %s:%u request",
-		      cnt,
-		      slurmdbd_msg_type_2_str(req->msg_type, 1),
-		      req->msg_type);
-		if (slurmdbd_conn->trigger_callbacks.acct_full)
-			(slurmdbd_conn->trigger_callbacks.acct_full)();
-		free_buf(buffer);
-		rc = SLURM_ERROR;
-	}
+	/*
+	 * Once the in-memory queue is full further messages spill to the
+	 * on-disk spool, and keep doing so while any spooled messages
+	 * remain so that the send order is preserved. Registration
+	 * messages are the exception: they are never written to disk
+	 * (see _save_dbd_state()) and may jump ahead of spooled traffic.
+	 */
+	if ((spool_cnt || (cnt >= max_agent_queue)) &&
+	    (req->msg_type != DBD_REGISTER_CTLD)) {
+		if (_spool_append(buffer) == SLURM_SUCCESS) {
+			free_buf(buffer);
+		} else {
+			error("slurmdbd: agent queue is full (%u) and spool unusable, discarding %s:%u request",
+			      cnt,
+			      slurmdbd_msg_type_2_str(req->msg_type, 1),
+			      req->msg_type);
+			if (slurmdbd_conn->trigger_callbacks.acct_full)
+				(slurmdbd_conn->trigger_callbacks.acct_full)();
+			free_buf(buffer);
+			rc = SLURM_ERROR;
+		}
+	} else if (list_enqueue(agent_list, buffer) == NULL)
+		fatal("list_enqueue: memory allocation failure");
+
+	if (rc == SLURM_SUCCESS)
+		queue_stats_enqueued(dbd_qid);
 
 	slurm_cond_broadcast(&agent_cond);
 	slurm_mutex_unlock(&agent_lock);
@@ -1120,5 +1380,5 @@ extern int slurmdbd_agent_queue_count(void)
 {
 	if (!agent_list)
 		return 0;
-	return list_count(agent_list);
+	return list_count(agent_list) + spool_cnt;
 }
@@ -125,6 +125,9 @@ const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 static acct_gather_energy_t *local_energy = NULL;
 static uint64_t debug_flags = 0;
 
+/* joules per energy status count, constant after boot, read once */
+static double energy_units = 0;
+
 static int dataset_id = -1; /* id of the dataset for profile data */
 
 /* one cpu in the package */
@@ -150,9 +153,8 @@ static uint64_t _read_msr(int fd, int which)
 	uint64_t data = 0;
 	static bool first = true;
 
-	if (lseek(fd, which, SEEK_SET) < 0)
-		error("lseek of /dev/cpu/#/msr: %m");
-	if (read(fd, &data, sizeof(data)) != sizeof(data)) {
+	/* a single pread() instead of lseek() + read() per sample */
+	if (pread(fd, &data, sizeof(data), which) != sizeof(data)) {
 		if (which == MSR_DRAM_ENERGY_STATUS) {
 			if (first && (debug_flags & DEBUG_FLAG_ENERGY)) {
 				first = false;
@@ -313,7 +315,6 @@ _send_drain_request(void)
 static void _get_joules_task(acct_gather_energy_t *energy)
 {
 	int i;
-	double energy_units;
 	uint64_t result;
 	double ret;
 	static uint32_t readings = 0;
@@ -325,37 +326,6 @@ static void _get_joules_task(acct_gather_energy_t *energy)
 		return;
 	}
 
-	/*
-	 * MSR_RAPL_POWER_UNIT
-	 * Power Units - bits 3:0
-	 * Energy Status Units - bits 12:8
-	 * Time Units - bits 19:16
-	 * See: Intel 64 and IA-32 Architectures Software Developer's
-	 * Manual, Volume 3 for details
-	 */
-	result = _read_msr(pkg_fd[0], MSR_RAPL_POWER_UNIT);
-	energy_units = pow(0.5, (double)((result>>8)&0x1f));
-
-	if (debug_flags & DEBUG_FLAG_ENERGY) {
-		double power_units = pow(0.5, (double)(result&0xf));
-		unsigned long max_power;
-
-		info("RAPL powercapture_debug Energy units = %.6f, "
-		     "Power Units = %.6f", energy_units, power_units);
-		/*
-		 * MSR_PKG_POWER_INFO
-		 * Thermal Spec Power - bits 14:0
-		 * Minimum Power - bits 30:16
-		 * Maximum Power - bits 46:32
-		 * Maximum Time Window - bits 53:48
-		 * See: Intel 64 and IA-32 Architectures Software Developer's
-		 * Manual, Volume 3 for details
-		 */
-		result = _read_msr(pkg_fd[0], MSR_PKG_POWER_INFO);
-		max_power = power_units * ((result >> 32) & 0x7fff);
-		info("RAPL Max power = %ld w", max_power);
-	}
-
 	result = 0;
 	for (i = 0; i < nb_pkg; i++)
 		result += _get_package_energy(i) + _get_dram_energy(i);
@@ -367,17 +337,19 @@ static void _get_joules_task(acct_gather_energy_t *energy)
 
 	if (energy->consumed_energy) {
 		time_t interval;
+		double joule_delta =
+			ret - (double)energy->previous_consumed_energy;
 
 		energy->consumed_energy =
 			(uint64_t)ret - energy->base_consumed_energy;
-		energy->current_watts =
-			(uint32_t)ret - energy->previous_consumed_energy;
-		energy->ave_watts =  ((energy->ave_watts * readings) +
-				       energy->current_watts) / (readings + 1);
+		energy->current_watts = (uint32_t)joule_delta;
 
 		interval = time(NULL) - energy->poll_time;
 		if (interval)	/* Prevent divide by zero */
-			energy->current_watts /= (float)interval;
+			energy->current_watts =
+				(uint32_t)(joule_delta / (double)interval);
+		energy->ave_watts =  ((energy->ave_watts * readings) +
+				       energy->current_watts) / (readings + 1);
 	} else {
 		energy->consumed_energy = 1;
 		energy->base_consumed_energy = (uint64_t)ret;
@@ -591,9 +563,41 @@ extern void acct_gather_energy_p_conf_set(s_p_hashtbl_t *tbl)
 
 	local_energy = acct_gather_energy_alloc(1);
 
+	/*
+	 * MSR_RAPL_POWER_UNIT
+	 * Power Units - bits 3:0
+	 * Energy Status Units - bits 12:8
+	 * Time Units - bits 19:16
+	 * See: Intel 64 and IA-32 Architectures Software Developer's
+	 * Manual, Volume 3 for details
+	 *
+	 * The units are fixed after boot, so read them here once
+	 * instead of on every sample.
+	 */
 	result = _read_msr(pkg_fd[0], MSR_RAPL_POWER_UNIT);
 	if (result == 0)
 		local_energy->current_watts = NO_VAL;
+	energy_units = pow(0.5, (double)((result>>8)&0x1f));
+
+	if (debug_flags & DEBUG_FLAG_ENERGY) {
+		double power_units = pow(0.5, (double)(result&0xf));
+		unsigned long max_power;
+
+		info("RAPL powercapture_debug Energy units = %.6f, "
+		     "Power Units = %.6f", energy_units, power_units);
+		/*
+		 * MSR_PKG_POWER_INFO
+		 * Thermal Spec Power - bits 14:0
+		 * Minimum Power - bits 30:16
+		 * Maximum Power - bits 46:32
+		 * Maximum Time Window - bits 53:48
+		 * See: Intel 64 and IA-32 Architectures Software Developer's
+		 * Manual, Volume 3 for details
+		 */
+		result = _read_msr(pkg_fd[0], MSR_PKG_POWER_INFO);
+		max_power = power_units * ((result >> 32) & 0x7fff);
+		info("RAPL Max power = %ld w", max_power);
+	}
 
 	debug("%s loaded", plugin_name);
 
@@ -176,9 +176,18 @@ static int _read_ofed_values(void)
 
 	uint16_t cap_mask;
 	uint64_t send_val, recv_val, send_pkts, recv_pkts;
+	time_t now = time(NULL);
+
+	/*
+	 * The TRES poll (_get_data) and the profile sample (_node_update)
+	 * both end up here, usually back to back in the same interval.
+	 * One MAD query per interval is enough; reuse the values just read.
+	 */
+	if (!first && (ofed_sens.update_time == now))
+		return SLURM_SUCCESS;
 
 	ofed_sens.last_update_time = ofed_sens.update_time;
-	ofed_sens.update_time = time(NULL);
+	ofed_sens.update_time = now;
 
 	if (first) {
 		int mgmt_classes[4] = {IB_SMI_CLASS, IB_SMI_DIRECT_CLASS,
@@ -224,7 +233,6 @@ static int _read_ofed_values(void)
 	}
 
 	memset(pc, 0, sizeof(pc));
-	memcpy(&cap_mask, pc + 2, sizeof(cap_mask));
 	if (!_slurm_pma_query_via(pc, &portid, port, ibd_timeout,
 				  IB_GSI_PORT_COUNTERS_EXT, srcport)) {
 		error("ofed: %m");
@@ -64,7 +64,14 @@
 #include "src/slurmd/common/proctrack.h"
 #include "hdf5_api.h"
 
-#define HDF5_CHUNK_SIZE 10
+/*
+ * Records per in-memory sample buffer; the background writer flushes a
+ * whole buffer with one H5PTappend().  The dataset chunk size matches
+ * so each flush lands on chunk boundaries, which is the cheap append
+ * pattern for the HDF5 library.
+ */
+#define PROFILE_BUF_RECORDS 128
+#define HDF5_CHUNK_SIZE PROFILE_BUF_RECORDS
 /* Compression level, a value of 0 through 9. Level 0 is faster but offers the
  * least compression; level 9 is slower but offers maximum compression.
  * A setting of -1 indicates that no compression is desired. */
@@ -108,6 +115,9 @@ typedef struct {
 typedef struct {
 	hid_t  table_id;
 	size_t type_size;
+	uint8_t *buf[2];	/* double buffered sample records */
+	size_t buf_count[2];	/* records queued in each buffer */
+	int    buf_active;	/* buffer currently being filled */
 } table_t;
 
 // Global HDF5 Variables
@@ -133,6 +143,65 @@ static table_t *tables = NULL;
 static size_t   tables_max_len = 0;
 static size_t   tables_cur_len = 0;
 
+/*
+ * Samples are appended to in-memory double buffers and flushed to the
+ * packet tables in whole-buffer chunks by a background writer thread,
+ * so an I/O stall in the HDF5 library no longer blocks the thread that
+ * is taking the samples.  buf_lock protects the buffers and the tables
+ * array, h5_lock serializes the HDF5 library calls the writer makes
+ * against the ones made from the sampling threads (the library is not
+ * thread safe).  If both buffers of a table fill up the sampler waits
+ * for the writer, which is the natural backpressure of the scheme.
+ */
+static pthread_mutex_t buf_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t buf_cond = PTHREAD_COND_INITIALIZER; /* writer work */
+static pthread_cond_t drain_cond = PTHREAD_COND_INITIALIZER; /* buf emptied */
+static pthread_mutex_t h5_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t writer_tid = 0;
+static bool writer_shutdown = false;
+
+static void *_writer_thread(void *no_data)
+{
+	size_t i, count;
+	int shadow;
+	uint8_t *buf;
+	hid_t tid;
+
+	slurm_mutex_lock(&buf_lock);
+	while (true) {
+		bool idle = true;
+
+		for (i = 0; i < tables_cur_len; ++i) {
+			shadow = tables[i].buf_active ^ 1;
+			if (!tables[i].buf_count[shadow])
+				continue;
+			idle = false;
+			tid = tables[i].table_id;
+			buf = tables[i].buf[shadow];
+			count = tables[i].buf_count[shadow];
+			slurm_mutex_unlock(&buf_lock);
+
+			slurm_mutex_lock(&h5_lock);
+			if (H5PTappend(tid, count, buf) < 0)
+				error("PROFILE: Impossible to add data to the table %zu; maybe the table has not been created?",
+				      i);
+			slurm_mutex_unlock(&h5_lock);
+
+			/* tables may have been reallocated, re-index */
+			slurm_mutex_lock(&buf_lock);
+			tables[i].buf_count[shadow] = 0;
+			slurm_cond_broadcast(&drain_cond);
+		}
+		if (idle) {
+			if (writer_shutdown)
+				break;
+			slurm_cond_wait(&buf_cond, &buf_lock);
+		}
+	}
+	slurm_mutex_unlock(&buf_lock);
+	return NULL;
+}
+
 static void _reset_slurm_profile_conf(void)
 {
 	xfree(hdf5_conf.dir);
@@ -384,6 +453,10 @@ extern int acct_gather_profile_p_node_step_start(stepd_step_rec_t* job)
 	put_string_attribute(gid_node, ATTR_STARTTIME,
 			     slurm_ctime2(&step_start_time));
 
+	/* start the background sample writer */
+	writer_shutdown = false;
+	slurm_thread_create(&writer_tid, _writer_thread, NULL);
+
 	return rc;
 }
 
@@ -422,9 +495,28 @@ extern int acct_gather_profile_p_node_step_end(void)
 	if (debug_flags & DEBUG_FLAG_PROFILE)
 		info("PROFILE: node_step_end (shutdown)");
 
-	/* close tables */
+	/* stop the writer; it drains all full buffers before exiting */
+	slurm_mutex_lock(&buf_lock);
+	writer_shutdown = true;
+	slurm_cond_signal(&buf_cond);
+	slurm_mutex_unlock(&buf_lock);
+	if (writer_tid)
+		pthread_join(writer_tid, NULL);
+	writer_tid = 0;
+
+	/* flush partially filled buffers and close tables */
 	for (i = 0; i < tables_cur_len; ++i) {
-		H5PTclose(tables[i].table_id);
+		table_t *ds = &tables[i];
+		int active = ds->buf_active;
+
+		if (ds->buf_count[active] &&
+		    (H5PTappend(ds->table_id, ds->buf_count[active],
+				ds->buf[active]) < 0))
+			error("PROFILE: failed to flush table %zu", i);
+		ds->buf_count[active] = 0;
+		xfree(ds->buf[0]);
+		xfree(ds->buf[1]);
+		H5PTclose(ds->table_id);
 	}
 	/* close groups */
 	for (i = 0; i < groups_len; ++i) {
@@ -519,20 +611,28 @@ extern int acct_gather_profile_p_create_dataset(
 		dataset_loc++;
 	}
 
+	/* serialize against the background sample writer */
+	slurm_mutex_lock(&h5_lock);
+
 	/* create the datatype for the dataset */
 	if ((dtype_id = H5Tcreate(H5T_COMPOUND, type_size)) < 0) {
 		debug3("PROFILE: failed to create datatype for table %s",
 		       name);
+		slurm_mutex_unlock(&h5_lock);
 		return SLURM_ERROR;
 	}
 
 	/* insert fields */
 	if (H5Tinsert(dtype_id, "ElapsedTime", 0,
-		      H5T_NATIVE_UINT64) < 0)
+		      H5T_NATIVE_UINT64) < 0) {
+		slurm_mutex_unlock(&h5_lock);
 		return SLURM_ERROR;
+	}
 	if (H5Tinsert(dtype_id, "EpochTime", sizeof(uint64_t),
-		      H5T_NATIVE_UINT64) < 0)
+		      H5T_NATIVE_UINT64) < 0) {
+		slurm_mutex_unlock(&h5_lock);
 		return SLURM_ERROR;
+	}
 
 	dataset_loc = dataset;
 
@@ -553,8 +653,10 @@ extern int acct_gather_profile_p_create_dataset(
 			continue;
 		}
 		if (H5Tinsert(dtype_id, dataset_loc->name,
-			      offset, field_id) < 0)
+			      offset, field_id) < 0) {
+			slurm_mutex_unlock(&h5_lock);
 			return SLURM_ERROR;
+		}
 		offset += field_size;
 		dataset_loc++;
 	}
@@ -567,10 +669,13 @@ extern int acct_gather_profile_p_create_dataset(
 	if (table_id < 0) {
 		error("PROFILE: Impossible to create the table %s", name);
 		H5Tclose(dtype_id);
+		slurm_mutex_unlock(&h5_lock);
 		return SLURM_ERROR;
 	}
 	H5Tclose(dtype_id); /* close the datatype since H5PT keeps a copy */
+	slurm_mutex_unlock(&h5_lock);
 
+	slurm_mutex_lock(&buf_lock);
 	/* resize the tables array if full */
 	if (tables_cur_len == tables_max_len) {
 		if (tables_max_len == 0)
@@ -582,7 +687,15 @@ extern int acct_gather_profile_p_create_dataset(
 	/* reserve a new table */
 	tables[tables_cur_len].table_id  = table_id;
 	tables[tables_cur_len].type_size = type_size;
+	tables[tables_cur_len].buf[0] = xmalloc(PROFILE_BUF_RECORDS *
+						type_size);
+	tables[tables_cur_len].buf[1] = xmalloc(PROFILE_BUF_RECORDS *
+						type_size);
+	tables[tables_cur_len].buf_count[0] = 0;
+	tables[tables_cur_len].buf_count[1] = 0;
+	tables[tables_cur_len].buf_active = 0;
 	++tables_cur_len;
+	slurm_mutex_unlock(&buf_lock);
 
 	return tables_cur_len - 1;
 }
@@ -590,9 +703,10 @@ extern int acct_gather_profile_p_create_dataset(
 extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 						 time_t sample_time)
 {
-	table_t *ds = &tables[table_id];
-	uint8_t send_data[ds->type_size];
-	int header_size = 0;
+	table_t *ds;
+	uint8_t *slot;
+	int shadow;
+
 	debug("acct_gather_profile_p_add_sample_data %d", table_id);
 
 	if (file_id < 0) {
@@ -614,20 +728,30 @@ extern int acct_gather_profile_p_add_sample_data(int table_id, void *data,
 	if (g_profile_running <= ACCT_GATHER_PROFILE_NONE)
 		return SLURM_ERROR;
 
-	/* prepend timestampe and relative time */
-	((uint64_t *)send_data)[0] = difftime(sample_time, step_start_time);
-	header_size += sizeof(uint64_t);
-	((uint64_t *)send_data)[1] = sample_time;
-	header_size += sizeof(uint64_t);
-
-	memcpy(send_data + header_size, data, ds->type_size - header_size);
-
-	/* append the record to the table */
-	if (H5PTappend(ds->table_id, 1, send_data) < 0) {
-		error("PROFILE: Impossible to add data to the table %d; "
-		      "maybe the table has not been created?", table_id);
-		return SLURM_ERROR;
+	slurm_mutex_lock(&buf_lock);
+	ds = &tables[table_id];
+	while (ds->buf_count[ds->buf_active] == PROFILE_BUF_RECORDS) {
+		shadow = ds->buf_active ^ 1;
+		if (ds->buf_count[shadow]) {
+			/* both buffers full, wait for the writer */
+			slurm_cond_wait(&drain_cond, &buf_lock);
+			ds = &tables[table_id]; /* may have been moved */
+			continue;
+		}
+		ds->buf_active = shadow;
 	}
+	slot = ds->buf[ds->buf_active] +
+		(ds->buf_count[ds->buf_active] * ds->type_size);
+
+	/* prepend timestampe and relative time */
+	((uint64_t *)slot)[0] = difftime(sample_time, step_start_time);
+	((uint64_t *)slot)[1] = sample_time;
+	memcpy(slot + (2 * sizeof(uint64_t)), data,
+	       ds->type_size - (2 * sizeof(uint64_t)));
+
+	if (++ds->buf_count[ds->buf_active] == PROFILE_BUF_RECORDS)
+		slurm_cond_signal(&buf_cond);
+	slurm_mutex_unlock(&buf_lock);
 
 	return SLURM_SUCCESS;
 }
@@ -49,13 +49,25 @@
 #include <unistd.h>
 
 #include "slurm/slurm_errno.h"
+#include "src/common/list.h"
+#include "src/common/macros.h"
 #include "src/common/slurm_xlator.h"
 #include "src/common/slurm_time.h"
 #include "src/common/util-net.h"
+#include "src/common/xhash.h"
 
 #define RETRY_COUNT		20
 #define RETRY_USEC		100000
 
+/*
+ * Fallback lifetime for verification cache entries when AuthInfo does
+ * not set "ttl=", matching the munged default TTL.
+ */
+#define CRED_CACHE_DEFAULT_TTL	300
+
+/* How long an encoded credential may be handed to additional RPCs */
+#define CRED_REUSE_SECS		2
+
 /*
  * These variables are required by the generic plugin interface.  If they
  * are not found in the plugin, the plugin loader will ignore it.
@@ -104,11 +116,180 @@ typedef struct _slurm_auth_credential {
 	gid_t   gid;       /* GID. valid only if verified == true            */
 } slurm_auth_credential_t;
 
+/*
+ * A verified credential, cached so repeats of the same munged string
+ * within the TTL do not cost another round trip to munged.
+ */
+typedef struct {
+	char   *m_str;     /* munged string, used as the hash key */
+	uid_t   uid;
+	gid_t   gid;
+	struct in_addr addr;
+	time_t  expires;
+} cred_cache_entry_t;
+
+static pthread_mutex_t cred_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static xhash_t *cred_cache = NULL;
+static List cred_cache_fifo = NULL;
+static char *encode_cache_str = NULL;
+static time_t encode_cache_time = 0;
+
 /* Static prototypes */
 
+static bool _cred_cache_enabled(void);
+static void _cred_cache_insert(slurm_auth_credential_t *c);
+static bool _cred_cache_lookup(slurm_auth_credential_t *c);
+static slurm_auth_credential_t *_cred_reuse(void);
+static void _cred_reuse_save(char *m_str);
 static int _decode_cred(slurm_auth_credential_t *c, char *socket);
 static void _print_cred(munge_ctx_t ctx);
 
+/*
+ * Both caches are opt-in through AuthInfo=cred_cache because accepting a
+ * cached credential means accepting what munged itself would reject as a
+ * replay.  Since the same slurm.conf AuthInfo drives every daemon, the
+ * sending side only reuses a credential when the verifying side will
+ * also have the cache enabled.
+ */
+static bool _cred_cache_enabled(void)
+{
+	static int enabled = -1;
+	char *auth_info;
+
+	if (enabled >= 0)
+		return enabled;
+
+	auth_info = slurm_get_auth_info();
+	if (auth_info && strstr(auth_info, "cred_cache"))
+		enabled = 1;
+	else
+		enabled = 0;
+	xfree(auth_info);
+
+	return enabled;
+}
+
+static void _cred_cache_id(void *item, const char **key, uint32_t *key_len)
+{
+	cred_cache_entry_t *entry = item;
+
+	*key = entry->m_str;
+	*key_len = strlen(entry->m_str);
+}
+
+static void _cred_cache_free(void *item)
+{
+	cred_cache_entry_t *entry = item;
+
+	xfree(entry->m_str);
+	xfree(entry);
+}
+
+static bool _cred_cache_lookup(slurm_auth_credential_t *c)
+{
+	cred_cache_entry_t *entry;
+	bool found = false;
+
+	if (!_cred_cache_enabled() || !c->m_str)
+		return false;
+
+	slurm_mutex_lock(&cred_cache_mutex);
+	if (cred_cache && (entry = xhash_get_str(cred_cache, c->m_str)) &&
+	    (entry->expires > time(NULL))) {
+		c->uid = entry->uid;
+		c->gid = entry->gid;
+		c->addr = entry->addr;
+		c->verified = true;
+		found = true;
+	}
+	slurm_mutex_unlock(&cred_cache_mutex);
+
+	return found;
+}
+
+static void _cred_cache_insert(slurm_auth_credential_t *c)
+{
+	cred_cache_entry_t *entry;
+	time_t now = time(NULL);
+	int ttl = slurm_get_auth_ttl();
+
+	if (!_cred_cache_enabled() || !c->m_str)
+		return;
+	if (!ttl)
+		ttl = CRED_CACHE_DEFAULT_TTL;
+
+	slurm_mutex_lock(&cred_cache_mutex);
+	if (!cred_cache) {
+		cred_cache = xhash_init(_cred_cache_id, _cred_cache_free);
+		cred_cache_fifo = list_create(NULL);
+	}
+
+	/*
+	 * Every entry gets the same lifetime, so the FIFO is ordered by
+	 * expiration time and sweeping from the head is sufficient.
+	 */
+	while ((entry = list_peek(cred_cache_fifo)) &&
+	       (entry->expires <= now)) {
+		entry = list_dequeue(cred_cache_fifo);
+		xhash_delete_str(cred_cache, entry->m_str);
+	}
+
+	/*
+	 * An expired entry may still await its sweep; do not shadow it
+	 * with a second item under the same key.
+	 */
+	if (!xhash_get_str(cred_cache, c->m_str)) {
+		entry = xmalloc(sizeof(*entry));
+		entry->m_str = xstrdup(c->m_str);
+		entry->uid = c->uid;
+		entry->gid = c->gid;
+		entry->addr = c->addr;
+		entry->expires = now + ttl;
+		xhash_add(cred_cache, entry);
+		list_enqueue(cred_cache_fifo, entry);
+	}
+	slurm_mutex_unlock(&cred_cache_mutex);
+}
+
+/*
+ * Hand out a copy of the most recently encoded credential if it is still
+ * fresh.  Slurm credentials carry no payload, so several RPCs may share
+ * one munged string; the verifying side answers the repeats from its
+ * cache instead of having munged reject them as replays.
+ */
+static slurm_auth_credential_t *_cred_reuse(void)
+{
+	slurm_auth_credential_t *cred = NULL;
+
+	if (!_cred_cache_enabled())
+		return NULL;
+
+	slurm_mutex_lock(&cred_cache_mutex);
+	if (encode_cache_str &&
+	    (time(NULL) < (encode_cache_time + CRED_REUSE_SECS))) {
+		cred = xmalloc(sizeof(*cred));
+		cred->verified = false;
+		/* Note: must be free()able like a munge_encode() result */
+		cred->m_str = strdup(encode_cache_str);
+		xassert((cred->magic = MUNGE_MAGIC));
+	}
+	slurm_mutex_unlock(&cred_cache_mutex);
+
+	return cred;
+}
+
+static void _cred_reuse_save(char *m_str)
+{
+	if (!_cred_cache_enabled() || !m_str)
+		return;
+
+	slurm_mutex_lock(&cred_cache_mutex);
+	xfree(encode_cache_str);
+	encode_cache_str = xstrdup(m_str);
+	encode_cache_time = time(NULL);
+	slurm_mutex_unlock(&cred_cache_mutex);
+}
+
 /*
  *  Munge plugin initialization
  */
@@ -135,10 +316,14 @@ slurm_auth_credential_t *slurm_auth_create(char *opts)
 	int rc, retry = RETRY_COUNT, auth_ttl;
 	slurm_auth_credential_t *cred = NULL;
 	munge_err_t err = EMUNGE_SUCCESS;
-	munge_ctx_t ctx = munge_ctx_create();
+	munge_ctx_t ctx;
 	SigFunc *ohandler;
 	char *socket;
 
+	if ((cred = _cred_reuse()))
+		return cred;
+
+	ctx = munge_ctx_create();
 	if (!ctx) {
 		error("munge_ctx_create failure");
 		return NULL;
@@ -191,6 +376,8 @@ again:
 	} else if ((bad_cred_test > 0) && cred->m_str) {
 		int i = ((int) time(NULL)) % strlen(cred->m_str);
 		cred->m_str[i]++;	/* random position in credential */
+	} else {
+		_cred_reuse_save(cred->m_str);
 	}
 
 	xsignal(SIGALRM, ohandler);
@@ -240,12 +427,17 @@ int slurm_auth_verify(slurm_auth_credential_t *c, char *opts)
 	if (c->verified)
 		return SLURM_SUCCESS;
 
+	if (_cred_cache_lookup(c))
+		return SLURM_SUCCESS;
+
 	socket = slurm_auth_opts_to_socket(opts);
 	rc = _decode_cred(c, socket);
 	xfree(socket);
 	if (rc < 0)
 		return SLURM_ERROR;
 
+	_cred_cache_insert(c);
+
 	return SLURM_SUCCESS;
 }
 
@@ -1134,6 +1134,33 @@ static void _set_assoc_mgr_ptrs(bb_alloc_t *bb_alloc)
 /*
  * Determine the current actual burst buffer state.
  */
+/* Arguments for the _load_state() status fetch threads */
+typedef struct {
+	bb_instances_t *instances;
+	int num_instances;
+	bb_sessions_t *sessions;
+	int num_sessions;
+	uint32_t timeout;
+} load_state_args_t;
+
+static void *_load_instances_thread(void *x)
+{
+	load_state_args_t *args = x;
+
+	args->instances = _bb_get_instances(&args->num_instances, &bb_state,
+					    args->timeout);
+	return NULL;
+}
+
+static void *_load_sessions_thread(void *x)
+{
+	load_state_args_t *args = x;
+
+	args->sessions = _bb_get_sessions(&args->num_sessions, &bb_state,
+					  args->timeout);
+	return NULL;
+}
+
 static void _load_state(bool init_config)
 {
 	static bool first_run = true;
@@ -1154,6 +1181,8 @@ static void _load_state(bool init_config)
 					 .user = READ_LOCK };
 	bool found_pool;
 	bitstr_t *pools_bitmap;
+	load_state_args_t fetch_args;
+	pthread_t instances_tid, sessions_tid;
 
 	slurm_mutex_lock(&bb_state.bb_mutex);
 	if (bb_state.bb_config.other_timeout)
@@ -1162,6 +1191,18 @@ static void _load_state(bool init_config)
 		timeout = DEFAULT_OTHER_TIMEOUT * 1000;
 	slurm_mutex_unlock(&bb_state.bb_mutex);
 
+	/*
+	 * Each status query is a separate dw_wlm_cli invocation which can
+	 * take seconds on a busy system. They are independent of each
+	 * other, so fetch the instances and sessions in parallel while
+	 * this thread fetches and processes the pools.
+	 */
+	memset(&fetch_args, 0, sizeof(fetch_args));
+	fetch_args.timeout = timeout;
+	slurm_thread_create(&instances_tid, _load_instances_thread,
+			    &fetch_args);
+	slurm_thread_create(&sessions_tid, _load_sessions_thread, &fetch_args);
+
 	/*
 	 * Load the pools information
 	 */
@@ -1169,6 +1210,12 @@ static void _load_state(bool init_config)
 	if (pools == NULL) {
 		error("%s: failed to find DataWarp entries, what now?",
 		      __func__);
+		pthread_join(instances_tid, NULL);
+		pthread_join(sessions_tid, NULL);
+		_bb_free_instances(fetch_args.instances,
+				   fetch_args.num_instances);
+		_bb_free_sessions(fetch_args.sessions,
+				  fetch_args.num_sessions);
 		return;
 	}
 
@@ -1240,15 +1287,19 @@ static void _load_state(bool init_config)
 	_bb_free_pools(pools, num_pools);
 
 	/*
-	 * Load the instances information
+	 * Collect the instances and sessions information
 	 */
-	instances = _bb_get_instances(&num_instances, &bb_state, timeout);
+	pthread_join(instances_tid, NULL);
+	pthread_join(sessions_tid, NULL);
+	instances = fetch_args.instances;
+	num_instances = fetch_args.num_instances;
 	if (instances == NULL) {
 		if (bb_state.bb_config.debug_flag)
 			debug("%s: No DataWarp instances found", __func__);
 		num_instances = 0;	/* Redundant, but fixes CLANG bug */
 	}
-	sessions = _bb_get_sessions(&num_sessions, &bb_state, timeout);
+	sessions = fetch_args.sessions;
+	num_sessions = fetch_args.num_sessions;
 	assoc_mgr_lock(&assoc_locks);
 	slurm_mutex_lock(&bb_state.bb_mutex);
 	bb_state.last_load_time = time(NULL);
@@ -2291,6 +2342,13 @@ static void *_start_teardown(void *x)
 			}
 
 		}
+		/*
+		 * The freed buffer space may let a pending job start, so
+		 * kick the scheduler rather than waiting for its next
+		 * periodic pass.
+		 */
+		bb_state.last_update_time = time(NULL);
+		queue_job_scheduler();
 		slurm_mutex_unlock(&bb_state.bb_mutex);
 		unlock_slurmctld(job_write_lock);
 	}
@@ -206,14 +206,21 @@ extern const char *cred_p_str_error(int errnum)
 extern int cred_p_sign(void *key, char *buffer, int buf_size,
 		       char **sig_pp, uint32_t *sig_size_p)
 {
-	int retry = RETRY_COUNT, auth_ttl;
+	int retry = RETRY_COUNT;
 	char *cred;
 	munge_err_t err;
-	munge_ctx_t ctx = (munge_ctx_t) key;
+	munge_ctx_t ctx;
 
-	auth_ttl = slurm_get_auth_ttl();
-	if (auth_ttl)
-		(void) munge_ctx_set(ctx, MUNGE_OPT_TTL, auth_ttl);
+	/*
+	 * Use a private context for each signature rather than the shared
+	 * key context. A munge_ctx_t is not thread-safe, and with per-call
+	 * contexts the encode requests issued by concurrent RPC threads
+	 * (e.g. launching many job array tasks at once) can be serviced by
+	 * munged in parallel rather than being serialized in slurmctld.
+	 * The TTL is set by _munge_ctx_setup().
+	 */
+	if ((ctx = _munge_ctx_setup(true)) == NULL)
+		return EMUNGE_SNAFU;
 
 again:
 	err = munge_encode(&cred, ctx, buffer, buf_size);
@@ -226,8 +233,10 @@ again:
 		}
 		if (err == EMUNGE_SOCKET)  /* Also see MUNGE_OPT_TTL above */
 			error("If munged is up, restart with --num-threads=10");
+		munge_ctx_destroy(ctx);
 		return err;
 	}
+	munge_ctx_destroy(ctx);
 
 	*sig_size_p = strlen(cred) + 1;
 	*sig_pp = xstrdup(cred);
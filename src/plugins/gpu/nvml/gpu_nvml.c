@@ -1244,6 +1244,52 @@ static char *_nvml_get_nvlink_info(nvmlDevice_t device, int index,
 	return links_str;
 }
 
+/* Data gathered from one device by a _probe_device() thread */
+typedef struct {
+	char **device_lut;
+	unsigned int device_count;
+	unsigned int index;
+	bool valid;
+
+	nvmlDevice_t device;
+	char device_name[NVML_DEVICE_NAME_BUFFER_SIZE];
+	char uuid[NVML_DEVICE_UUID_BUFFER_SIZE];
+	nvmlPciInfo_t pci_info;
+	unsigned int minor_number;
+	unsigned long cpu_set[CPU_SET_SIZE];
+	char *nvlinks;
+	char *device_brand;
+} nvml_probe_t;
+
+/*
+ * Gather all of the attributes of one device. Run in a separate thread
+ * per device; everything here is a read-only NVML query and NVML is
+ * thread safe, so the devices can be probed concurrently.
+ */
+static void *_probe_device(void *arg)
+{
+	nvml_probe_t *probe = (nvml_probe_t *) arg;
+
+	if (!_nvml_get_handle(probe->index, &probe->device))
+		return NULL;
+	probe->valid = true;
+
+	_nvml_get_device_name(probe->device, probe->device_name,
+			      NVML_DEVICE_NAME_BUFFER_SIZE);
+	_nvml_get_device_uuid(probe->device, probe->uuid,
+			      NVML_DEVICE_UUID_BUFFER_SIZE);
+	_nvml_get_device_pci_info(probe->device, &probe->pci_info);
+	_nvml_get_device_minor_number(probe->device, &probe->minor_number);
+	_nvml_get_device_affinity(probe->device, CPU_SET_SIZE,
+				  probe->cpu_set);
+	probe->nvlinks = _nvml_get_nvlink_info(probe->device, probe->index,
+					       probe->device_lut,
+					       probe->device_count);
+	probe->device_brand = _nvml_get_device_brand(probe->device);
+
+	return NULL;
+}
+
 /*
  * Creates and returns a gres conf list of detected nvidia gpus on the node.
  * If an error occurs, return NULL
@@ -1261,6 +1307,8 @@ static List _get_system_gpu_list_nvml(node_config_load_t *node_config)
 	char driver[NVML_SYSTEM_DRIVER_VERSION_BUFFER_SIZE];
 	char version[NVML_SYSTEM_NVML_VERSION_BUFFER_SIZE];
 	char **device_lut;
+	nvml_probe_t *probes;
+	pthread_t *tids;
 	nvmlPciInfo_t pci_info;
 
 	_nvml_init();
@@ -1295,22 +1343,36 @@ static List _get_system_gpu_list_nvml(node_config_load_t *node_config)
 	}
 
 	/*
-	 * Loop through all the GPUs on the system and add to gres_list_system
+	 * Probe all of the GPUs on the system concurrently, one thread
+	 * per device. The slow queries (cpu affinity, nvlink state) hit
+	 * the driver independently per device, so the probe time is that
+	 * of the slowest device rather than the sum over all of them.
+	 */
+	probes = xcalloc(device_count, sizeof(nvml_probe_t));
+	tids = xcalloc(device_count, sizeof(pthread_t));
+	for (i = 0; i < device_count; ++i) {
+		probes[i].index = i;
+		probes[i].device_lut = device_lut;
+		probes[i].device_count = device_count;
+		slurm_thread_create(&tids[i], _probe_device, &probes[i]);
+	}
+	for (i = 0; i < device_count; ++i)
+		pthread_join(tids[i], NULL);
+	xfree(tids);
+
+	/*
+	 * Merge the probe results into gres_list_system in device index
+	 * order so that the resulting configuration is deterministic.
+	 * The cpuset conversion callback and the list append are not
+	 * thread safe and stay in this single pass.
 	 */
 	for (i = 0; i < device_count; ++i) {
-		nvmlDevice_t device;
-		char uuid[NVML_DEVICE_UUID_BUFFER_SIZE] = {0};
-		unsigned int minor_number = 0;
-		unsigned long cpu_set[CPU_SET_SIZE] = {0};
 		bitstr_t *cpu_aff_mac_bitstr = NULL;
 		char *cpu_aff_mac_range = NULL;
 		char *cpu_aff_abs_range = NULL;
 		char *device_file = NULL;
-		char *nvlinks = NULL;
-		char device_name[NVML_DEVICE_NAME_BUFFER_SIZE] = {0};
-		char *device_brand = NULL;
 
-		if (!_nvml_get_handle(i, &device)) {
+		if (!probes[i].valid) {
 			error("Creating null GRES GPU record");
 			add_gres_to_list(gres_list_system, "gpu", 1,
 					 node_config->cpu_cnt, NULL,
@@ -1318,18 +1380,10 @@ static List _get_system_gpu_list_nvml(node_config_load_t *node_config)
 			continue;
 		}
 
-		memset(&pci_info, 0, sizeof(pci_info));
-		_nvml_get_device_name(device, device_name,
-				      NVML_DEVICE_NAME_BUFFER_SIZE);
-		_nvml_get_device_uuid(device, uuid,
-				      NVML_DEVICE_UUID_BUFFER_SIZE);
-		_nvml_get_device_pci_info(device, &pci_info);
-		_nvml_get_device_minor_number(device, &minor_number);
-		_nvml_get_device_affinity(device, CPU_SET_SIZE, cpu_set);
-
 		// Convert from nvml cpu bitmask to slurm bitstr_t (machine fmt)
 		cpu_aff_mac_bitstr = bit_alloc(MAX_CPUS);
-		_set_cpu_set_bitstr(cpu_aff_mac_bitstr, cpu_set, CPU_SET_SIZE);
+		_set_cpu_set_bitstr(cpu_aff_mac_bitstr, probes[i].cpu_set,
+				    CPU_SET_SIZE);
 
 		// Convert from bitstr_t to cpu range str
 		cpu_aff_mac_range = bit_fmt_full(cpu_aff_mac_bitstr);
@@ -1343,45 +1397,47 @@ static List _get_system_gpu_list_nvml(node_config_load_t *node_config)
 			continue;
 		}
 
-		nvlinks = _nvml_get_nvlink_info(device, i, device_lut,
-						device_count);
-		device_brand = _nvml_get_device_brand(device);
-		xstrfmtcat(device_file, "/dev/nvidia%u", minor_number);
+		xstrfmtcat(device_file, "/dev/nvidia%u",
+			   probes[i].minor_number);
 
 		debug2("GPU index %u:", i);
-		debug2("    Name: %s", device_name);
-		debug2("    Brand/Type: %s", device_brand);
-		debug2("    UUID: %s", uuid);
-		debug2("    PCI Domain/Bus/Device: %u:%u:%u", pci_info.domain,
-		       pci_info.bus, pci_info.device);
-		debug2("    PCI Bus ID: %s", pci_info.busId);
-		debug2("    NVLinks: %s", nvlinks);
+		debug2("    Name: %s", probes[i].device_name);
+		debug2("    Brand/Type: %s", probes[i].device_brand);
+		debug2("    UUID: %s", probes[i].uuid);
+		debug2("    PCI Domain/Bus/Device: %u:%u:%u",
+		       probes[i].pci_info.domain, probes[i].pci_info.bus,
+		       probes[i].pci_info.device);
+		debug2("    PCI Bus ID: %s", probes[i].pci_info.busId);
+		debug2("    NVLinks: %s", probes[i].nvlinks);
 		debug2("    Device File (minor number): %s", device_file);
-		if (minor_number != i)
+		if (probes[i].minor_number != i)
 			debug("Note: GPU index %u is different from minor "
-			      "number %u", i, minor_number);
+			      "number %u", i, probes[i].minor_number);
 		debug2("    CPU Affinity Range: %s", cpu_aff_mac_range);
 		debug2("    CPU Affinity Range Abstract: %s",cpu_aff_abs_range);
 		// Print out possible memory frequencies for this device
-		_nvml_print_freqs(device, LOG_LEVEL_DEBUG2);
+		_nvml_print_freqs(probes[i].device, LOG_LEVEL_DEBUG2);
 
 		add_gres_to_list(gres_list_system, "gpu", 1,
 				 node_config->cpu_cnt, cpu_aff_abs_range,
-				 device_file, device_brand, nvlinks);
+				 device_file, probes[i].device_brand,
+				 probes[i].nvlinks);
 
 		xfree(cpu_aff_mac_range);
 		xfree(cpu_aff_abs_range);
-		xfree(nvlinks);
-		xfree(device_brand);
 		xfree(device_file);
 	}
 
 	/*
-	 * Free lookup table
+	 * Free lookup table and probe results
 	 */
-	for (i = 0; i < device_count; ++i)
+	for (i = 0; i < device_count; ++i) {
+		xfree(probes[i].nvlinks);
+		xfree(probes[i].device_brand);
 		xfree(device_lut[i]);
+	}
 	xfree(device_lut);
+	xfree(probes);
 	_nvml_shutdown();
 
 	info("%u GPU system device(s) detected", device_count);
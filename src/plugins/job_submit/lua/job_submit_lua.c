@@ -95,18 +95,33 @@ const char plugin_type[]       	= "job_submit/lua";
 const uint32_t plugin_version   = SLURM_VERSION_NUMBER;
 
 static const char lua_script_path[] = DEFAULT_SCRIPT_DIR "/job_submit.lua";
-static time_t lua_script_last_loaded = (time_t) 0;
-static lua_State *L = NULL;
-static char *user_msg = NULL;
 
-time_t last_lua_jobs_update = (time_t) 0;
-time_t last_lua_resv_update = (time_t) 0;
+/*
+ *  Pool of independent Lua interpreters, each with its own copy of the
+ *   script, so that submissions can execute concurrently. A thread checks
+ *   an interpreter out of the pool for the duration of one submit/modify
+ *   call; if all interpreters are busy it waits for one to be returned.
+ */
+#define LUA_STATE_POOL_SIZE 4
+typedef struct {
+	lua_State *st;			/* interpreter, NULL until loaded */
+	time_t script_loaded;		/* script mtime at load time */
+	time_t jobs_update;		/* "jobs" global table build time */
+	time_t resv_update;		/* "resvs" global table build time */
+	bool in_use;			/* checked out by some thread */
+} lua_state_entry_t;
+static lua_state_entry_t lua_state_pool[LUA_STATE_POOL_SIZE];
+
+/* Interpreter checked out by the current thread */
+static __thread lua_state_entry_t *lua_cur = NULL;
+static __thread lua_State *L = NULL;
+static __thread char *user_msg = NULL;
 
 /*
- *  Mutex for protecting multi-threaded access to this plugin.
- *   (Only 1 thread at a time should be in here)
+ *  Mutex and condition protecting the interpreter pool above
  */
 static pthread_mutex_t lua_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t lua_cond = PTHREAD_COND_INITIALIZER;
 
 /* These are defined here so when we link with something other than
  * the slurmctld we will have these symbols defined.  They will get
@@ -480,7 +495,7 @@ static void _update_jobs_global(void)
 	ListIterator iter;
 	struct job_record *job_ptr;
 
-	if (last_lua_jobs_update >= last_job_update) {
+	if (lua_cur->jobs_update >= last_job_update) {
 		return;
 	}
 
@@ -509,7 +524,7 @@ static void _update_jobs_global(void)
 		         "%d", job_ptr->job_id);
 		lua_setfield(L, -2, job_id_buf);
 	}
-	last_lua_jobs_update = last_job_update;
+	lua_cur->jobs_update = last_job_update;
 	list_iterator_destroy(iter);
 
 	lua_setfield(L, -2, "jobs");
@@ -576,7 +591,7 @@ static void _update_resvs_global(void)
 	ListIterator iter;
 	slurmctld_resv_t *resv_ptr;
 
-	if (last_lua_resv_update >= last_resv_update) {
+	if (lua_cur->resv_update >= last_resv_update) {
 		return;
 	}
 
@@ -602,7 +617,7 @@ static void _update_resvs_global(void)
 
 		lua_setfield(L, -2, resv_ptr->name);
 	}
-	last_lua_resv_update = last_resv_update;
+	lua_cur->resv_update = last_resv_update;
 	list_iterator_destroy(iter);
 
 	lua_setfield(L, -2, "reservations");
@@ -1598,9 +1613,9 @@ static void _register_lua_slurm_output_functions (void)
 
 	lua_setglobal (L, "slurm");
 
-	last_lua_jobs_update = 0;
+	lua_cur->jobs_update = 0;
 	_update_jobs_global();
-	last_lua_resv_update = 0;
+	lua_cur->resv_update = 0;
 	_update_resvs_global();
 }
 
@@ -1674,7 +1689,7 @@ static int _load_script(void)
 		             lua_script_path, strerror(errno));
 	}
 	
-	if (st.st_mtime <= lua_script_last_loaded) {
+	if (st.st_mtime <= lua_cur->script_loaded) {
 		debug3("%s: skipping loading Lua script: %s", __func__,
 		       lua_script_path);
 		return SLURM_SUCCESS;
@@ -1767,10 +1782,47 @@ static int _load_script(void)
 
 	if (L_orig)
 		lua_close(L_orig);
-	lua_script_last_loaded = st.st_mtime;
+	lua_cur->st = L;
+	lua_cur->script_loaded = st.st_mtime;
 	return SLURM_SUCCESS;
 }
 
+/*
+ *  Check an interpreter out of the pool for exclusive use by this thread,
+ *   waiting for one to be returned if all are busy
+ */
+static void _lua_state_checkout(void)
+{
+	int i;
+
+	slurm_mutex_lock(&lua_lock);
+	while (!lua_cur) {
+		for (i = 0; i < LUA_STATE_POOL_SIZE; i++) {
+			if (lua_state_pool[i].in_use)
+				continue;
+			lua_state_pool[i].in_use = true;
+			lua_cur = &lua_state_pool[i];
+			break;
+		}
+		if (!lua_cur)
+			slurm_cond_wait(&lua_cond, &lua_lock);
+	}
+	slurm_mutex_unlock(&lua_lock);
+	L = lua_cur->st;
+}
+
+/* Return this thread's interpreter to the pool */
+static void _lua_state_checkin(void)
+{
+	slurm_mutex_lock(&lua_lock);
+	lua_cur->st = L;
+	lua_cur->in_use = false;
+	lua_cur = NULL;
+	L = NULL;
+	slurm_cond_signal(&lua_cond);
+	slurm_mutex_unlock(&lua_lock);
+}
+
 /*
  *  NOTE: The init callback should never be called multiple times,
  *   let alone called from multiple threads. Therefore, locking
@@ -1779,6 +1831,7 @@ static int _load_script(void)
 int init(void)
 {
 	int rc = SLURM_SUCCESS;
+	int i;
 
 	/*
 	 * Need to dlopen() the Lua library to ensure plugins see
@@ -1787,16 +1840,26 @@ int init(void)
 	if ((rc = xlua_dlopen()) != SLURM_SUCCESS)
 		return rc;
 
-	return _load_script();
+	for (i = 0; i < LUA_STATE_POOL_SIZE; i++) {
+		lua_cur = &lua_state_pool[i];
+		L = lua_cur->st;
+		if ((rc = _load_script()))
+			break;
+	}
+	lua_cur = NULL;
+	L = NULL;
+	return rc;
 }
 
 int fini(void)
 {
-	if (L) {
-		debug3("%s: Unloading Lua script", __func__);
-		lua_close(L);
-		L = NULL;
-		lua_script_last_loaded = 0;
+	int i;
+
+	debug3("%s: Unloading Lua script", __func__);
+	for (i = 0; i < LUA_STATE_POOL_SIZE; i++) {
+		if (lua_state_pool[i].st)
+			lua_close(lua_state_pool[i].st);
+		memset(&lua_state_pool[i], 0, sizeof(lua_state_entry_t));
 	}
 	return SLURM_SUCCESS;
 }
@@ -1807,7 +1870,7 @@ extern int job_submit(struct job_descriptor *job_desc, uint32_t submit_uid,
 		      char **err_msg)
 {
 	int rc = SLURM_ERROR;
-	slurm_mutex_lock (&lua_lock);
+	_lua_state_checkout();
 
 	if ((rc = _load_script()))
 		goto out;
@@ -1846,7 +1909,7 @@ extern int job_submit(struct job_descriptor *job_desc, uint32_t submit_uid,
 		user_msg = NULL;
 	}
 
-out:	slurm_mutex_unlock (&lua_lock);
+out:	_lua_state_checkin();
 	return rc;
 }
 
@@ -1855,7 +1918,7 @@ extern int job_modify(struct job_descriptor *job_desc,
 		      struct job_record *job_ptr, uint32_t submit_uid)
 {
 	int rc = SLURM_ERROR;
-	slurm_mutex_lock (&lua_lock);
+	_lua_state_checkout();
 
 	/*
 	 *  All lua script functions should have been verified during
@@ -1893,6 +1956,6 @@ extern int job_modify(struct job_descriptor *job_desc,
 		xfree(user_msg);
 	}
 
-out:	slurm_mutex_unlock (&lua_lock);
+out:	_lua_state_checkin();
 	return rc;
 }
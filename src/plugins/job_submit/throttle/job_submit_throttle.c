@@ -89,6 +89,9 @@ static time_t last_reset = (time_t) 0;
 static thru_put_t *thru_put_array = NULL;
 static int thru_put_size = 0;
 
+/* Submissions may run concurrently, protect the counters above */
+static pthread_mutex_t thru_put_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static void _get_config(void)
 {
 	char *opt;
@@ -150,12 +153,14 @@ extern int fini(void)
 extern int job_submit(struct job_descriptor *job_desc, uint32_t submit_uid,
 		      char **err_msg)
 {
+	int rc = SLURM_SUCCESS;
 	int i;
 
+	slurm_mutex_lock(&thru_put_mutex);
 	if (!last_reset)
 		_get_config();
 	if (jobs_per_user_per_hour == 0)
-		return SLURM_SUCCESS;
+		goto fini;
 	_reset_counters();
 
 	for (i = 0; i < thru_put_size; i++) {
@@ -163,18 +168,20 @@ extern int job_submit(struct job_descriptor *job_desc, uint32_t submit_uid,
 			continue;
 		if (thru_put_array[i].job_count < jobs_per_user_per_hour) {
 			thru_put_array[i].job_count++;
-			return SLURM_SUCCESS;
+			goto fini;
 		}
 		if (err_msg)
 			*err_msg = xstrdup("Reached jobs per hour limit");
-		return ESLURM_ACCOUNTING_POLICY;
+		rc = ESLURM_ACCOUNTING_POLICY;
+		goto fini;
 	}
 	thru_put_size++;
 	thru_put_array = xrealloc(thru_put_array,
 				  (sizeof(thru_put_t) * thru_put_size));
 	thru_put_array[thru_put_size - 1].uid = job_desc->user_id;
 	thru_put_array[thru_put_size - 1].job_count = 1;
-	return SLURM_SUCCESS;
+fini:	slurm_mutex_unlock(&thru_put_mutex);
+	return rc;
 }
 
 extern int job_modify(struct job_descriptor *job_desc,
@@ -97,10 +97,15 @@ const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 {
 	unsigned long utime, stime, total_rss, total_pgpgin;
-	char *cpu_time = NULL, *memory_stat = NULL, *ptr;
-	size_t cpu_time_size = 0, memory_stat_size = 0;
-	xcgroup_t *task_cpuacct_cg = NULL;;
-	xcgroup_t *task_memory_cg = NULL;
+	/*
+	 * Fixed sample arenas.  Polling is serialized by the caller, so
+	 * static buffers avoid any per-sample allocation.
+	 */
+	static char cpu_time[256];
+	static char memory_stat[8192];
+	char *ptr;
+	task_cg_info_t *task_cpuacct_cg = NULL;
+	task_cg_info_t *task_memory_cg = NULL;
 	bool exit_early = false;
 
 	/* Find which task cgroups to use */
@@ -132,9 +137,12 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 	//START_TIMER;
 	/* info("before"); */
 	/* print_jag_prec(prec); */
-	xcgroup_get_param(task_cpuacct_cg, "cpuacct.stat",
-			  &cpu_time, &cpu_time_size);
-	if (cpu_time == NULL) {
+	if (!task_cpuacct_cg->stat_h.path)
+		(void) xcgroup_open_param(&task_cpuacct_cg->task_cg,
+					  "cpuacct.stat",
+					  &task_cpuacct_cg->stat_h);
+	if (xcgroup_read_param(&task_cpuacct_cg->stat_h, cpu_time,
+			       sizeof(cpu_time), NULL) != XCGROUP_SUCCESS) {
 		debug2("%s: failed to collect cpuacct.stat pid %d ppid %d",
 		       __func__, prec->pid, prec->ppid);
 	} else {
@@ -147,9 +155,12 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 		prec->ssec = stime;
 	}
 
-	xcgroup_get_param(task_memory_cg, "memory.stat",
-			  &memory_stat, &memory_stat_size);
-	if (memory_stat == NULL) {
+	if (!task_memory_cg->stat_h.path)
+		(void) xcgroup_open_param(&task_memory_cg->task_cg,
+					  "memory.stat",
+					  &task_memory_cg->stat_h);
+	if (xcgroup_read_param(&task_memory_cg->stat_h, memory_stat,
+			       sizeof(memory_stat), NULL) != XCGROUP_SUCCESS) {
 		debug2("%s: failed to collect memory.stat  pid %d ppid %d",
 		       __func__, prec->pid, prec->ppid);
 	} else {
@@ -175,9 +186,6 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 		}
 	}
 
-	xfree(cpu_time);
-	xfree(memory_stat);
-
 	/* FIXME: Enable when kernel support ready.
 	 *
 	 * "Read" and "Write" from blkio.throttle.io_service_bytes are
@@ -403,6 +411,7 @@ extern void free_task_cg_info(void *object)
 	task_cg_info_t *task_cg = (task_cg_info_t *)object;
 
 	if (task_cg) {
+		xcgroup_close_param(&task_cg->stat_h);
 		xcgroup_destroy(&task_cg->task_cg);
 		xfree(task_cg);
 	}
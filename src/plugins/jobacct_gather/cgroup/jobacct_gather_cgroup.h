@@ -49,6 +49,9 @@
  */
 typedef struct task_cg_info {
 	xcgroup_t task_cg;
+	xcgroup_param_handle_t stat_h; /* cached handle on the stat file
+					* sampled from this cgroup, opened
+					* on the first poll */
 	uint32_t taskid;
 } task_cg_info_t;
 
@@ -78,6 +78,75 @@ static DIR  *slash_proc = NULL;
 static int energy_profile = ENERGY_DATA_NODE_ENERGY_UP;
 static uint64_t debug_flags = 0;
 
+/*
+ * Cache of open /proc/<pid> file descriptors so each poll rereads the
+ * stat and io files with pread() at offset zero instead of paying a
+ * path lookup and open/close per file per pid.  Only used when the pid
+ * set comes from the proctrack container; the /proc walking fallback
+ * would cache a descriptor for every process on the node.
+ *
+ * A cached descriptor can outlive its process (the pid may even be
+ * reused), so a failed read closes it and retries through a fresh
+ * open() once.  Entries not touched during a poll are pruned at the
+ * end of _get_precs().
+ */
+typedef struct {
+	pid_t pid;
+	int stat_fd;
+	int io_fd;
+	bool used;		/* touched during the current poll */
+} proc_fd_cache_t;
+
+static List proc_fd_cache_list = NULL;
+
+static void _destroy_proc_fd_cache(void *object)
+{
+	proc_fd_cache_t *cache = (proc_fd_cache_t *)object;
+
+	if (cache->stat_fd >= 0)
+		close(cache->stat_fd);
+	if (cache->io_fd >= 0)
+		close(cache->io_fd);
+	xfree(cache);
+}
+
+static int _find_proc_fd_cache(void *x, void *key)
+{
+	return (((proc_fd_cache_t *)x)->pid == *(pid_t *)key);
+}
+
+static int _clear_proc_fd_cache_used(void *x, void *arg)
+{
+	((proc_fd_cache_t *)x)->used = false;
+	return 0;
+}
+
+static int _proc_fd_cache_unused(void *x, void *key)
+{
+	return !((proc_fd_cache_t *)x)->used;
+}
+
+static proc_fd_cache_t *_get_proc_fd_cache(pid_t pid)
+{
+	proc_fd_cache_t *cache;
+
+	if (!proc_fd_cache_list)
+		proc_fd_cache_list = list_create(_destroy_proc_fd_cache);
+
+	cache = list_find_first(proc_fd_cache_list, _find_proc_fd_cache,
+				&pid);
+	if (!cache) {
+		cache = xmalloc(sizeof(proc_fd_cache_t));
+		cache->pid = pid;
+		cache->stat_fd = -1;
+		cache->io_fd = -1;
+		list_append(proc_fd_cache_list, cache);
+	}
+	cache->used = true;
+
+	return cache;
+}
+
 static int _find_prec(void *x, void *key)
 {
 	jag_prec_t *prec = (jag_prec_t *) x;
@@ -328,7 +397,7 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
 	long unsigned f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13;
 	int exit_signal, last_cpu;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
+	num_read = pread(in, sbuf, (sizeof(sbuf) - 1), 0);
 	if (num_read <= 0)
 		return 0;
 	sbuf[num_read] = '\0';
@@ -405,7 +474,7 @@ static int _get_process_memory_line(int in, jag_prec_t *prec)
 	int num_read, nvals;
 	long int size, rss, share, text, lib, data, dt;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
+	num_read = pread(in, sbuf, (sizeof(sbuf) - 1), 0);
 	if (num_read <= 0)
 		return 0;
 	sbuf[num_read] = '\0';
@@ -467,7 +536,7 @@ static int _get_process_io_data_line(int in, jag_prec_t *prec) {
 	int num_read, nvals;
 	uint64_t rchar, wchar;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
+	num_read = pread(in, sbuf, (sizeof(sbuf) - 1), 0);
 	if (num_read <= 0)
 		return 0;
 	sbuf[num_read] = '\0';
@@ -487,15 +556,21 @@ static int _get_process_io_data_line(int in, jag_prec_t *prec) {
 	return 1;
 }
 
+/*
+ * Collect a precs entry for one process.  A non-zero pid enables the
+ * cached descriptor fast path; the /proc walking caller passes zero
+ * and keeps the old open/read/close behavior.
+ */
 static void _handle_stats(List prec_list, char *proc_stat_file,
 			  char *proc_io_file, char *proc_smaps_file,
 			  jag_callbacks_t *callbacks,
-			  int tres_count)
+			  int tres_count, pid_t pid)
 {
 	static int no_share_data = -1;
 	static int use_pss = -1;
 	FILE *stat_fp = NULL;
 	FILE *io_fp = NULL;
+	proc_fd_cache_t *cache = NULL;
 	int fd, fd2, i;
 	jag_prec_t *prec = NULL;
 
@@ -513,21 +588,31 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 		xfree(acct_params);
 	}
 
-	if (!(stat_fp = fopen(proc_stat_file, "r")))
-		return;  /* Assume the process went away */
-	/*
-	 * Close the file on exec() of user tasks.
-	 *
-	 * NOTE: If we fork() slurmstepd after the
-	 * fopen() above and before the fcntl() below,
-	 * then the user task may have this extra file
-	 * open, which can cause problems for
-	 * checkpoint/restart, but this should be a very rare
-	 * problem in practice.
-	 */
-	fd = fileno(stat_fp);
-	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_stat_file);
+	if (pid) {
+		cache = _get_proc_fd_cache(pid);
+		if (cache->stat_fd < 0)
+			cache->stat_fd = open(proc_stat_file,
+					      O_RDONLY | O_CLOEXEC);
+		fd = cache->stat_fd;
+		if (fd < 0)
+			return;  /* Assume the process went away */
+	} else {
+		if (!(stat_fp = fopen(proc_stat_file, "r")))
+			return;  /* Assume the process went away */
+		/*
+		 * Close the file on exec() of user tasks.
+		 *
+		 * NOTE: If we fork() slurmstepd after the
+		 * fopen() above and before the fcntl() below,
+		 * then the user task may have this extra file
+		 * open, which can cause problems for
+		 * checkpoint/restart, but this should be a very rare
+		 * problem in practice.
+		 */
+		fd = fileno(stat_fp);
+		if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
+			error("%s: fcntl(%s): %m", __func__, proc_stat_file);
+	}
 
 	prec = xmalloc(sizeof(jag_prec_t));
 
@@ -553,12 +638,35 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 	}
 
 	if (!_get_process_data_line(fd, prec)) {
-		xfree(prec->tres_data);
-		xfree(prec);
-		fclose(stat_fp);
-		return;
+		bool retried = false;
+		if (cache) {
+			/*
+			 * The cached descriptor may belong to an exited
+			 * (or even reused) pid; retry once through a
+			 * fresh open() before giving up, and drop the
+			 * io descriptor with it.
+			 */
+			close(cache->stat_fd);
+			if (cache->io_fd >= 0) {
+				close(cache->io_fd);
+				cache->io_fd = -1;
+			}
+			cache->stat_fd = open(proc_stat_file,
+					      O_RDONLY | O_CLOEXEC);
+			fd = cache->stat_fd;
+			if ((fd >= 0) && _get_process_data_line(fd, prec))
+				retried = true;
+		}
+		if (!retried) {
+			xfree(prec->tres_data);
+			xfree(prec);
+			if (stat_fp)
+				fclose(stat_fp);
+			return;
+		}
 	}
-	fclose(stat_fp);
+	if (stat_fp)
+		fclose(stat_fp);
 
 	if (acct_gather_filesystem_g_get_data(prec->tres_data) < 0) {
 		debug2("problem retrieving filesystem data");
@@ -583,7 +691,13 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 
 	list_append(prec_list, prec);
 
-	if ((io_fp = fopen(proc_io_file, "r"))) {
+	if (cache) {
+		if (cache->io_fd < 0)
+			cache->io_fd = open(proc_io_file,
+					    O_RDONLY | O_CLOEXEC);
+		if (cache->io_fd >= 0)
+			_get_process_io_data_line(cache->io_fd, prec);
+	} else if ((io_fp = fopen(proc_io_file, "r"))) {
 		fd2 = fileno(io_fp);
 		if (fcntl(fd2, F_SETFD, FD_CLOEXEC) == -1)
 			error("%s: fcntl: %m", __func__);
@@ -633,14 +747,22 @@ static List _get_precs(List task_list, bool pgid_plugin, uint64_t cont_id,
 			debug4("no pids in this container %"PRIu64"", cont_id);
 			goto finished;
 		}
+		if (proc_fd_cache_list)
+			list_for_each(proc_fd_cache_list,
+				      _clear_proc_fd_cache_used, NULL);
 		for (i = 0; i < npids; i++) {
 			snprintf(proc_stat_file, 256, "/proc/%d/stat", pids[i]);
 			snprintf(proc_io_file, 256, "/proc/%d/io", pids[i]);
 			snprintf(proc_smaps_file, 256, "/proc/%d/smaps", pids[i]);
 			_handle_stats(prec_list, proc_stat_file, proc_io_file,
 				      proc_smaps_file, callbacks,
-				      jobacct ? jobacct->tres_count : 0);
+				      jobacct ? jobacct->tres_count : 0,
+				      pids[i]);
 		}
+		/* drop descriptors for pids gone from the container */
+		if (proc_fd_cache_list)
+			list_delete_all(proc_fd_cache_list,
+					_proc_fd_cache_unused, NULL);
 		xfree(pids);
 	} else {
 		struct dirent *slash_proc_entry;
@@ -729,7 +851,7 @@ static List _get_precs(List task_list, bool pgid_plugin, uint64_t cont_id,
 
 			_handle_stats(prec_list, proc_stat_file, proc_io_file,
 				      proc_smaps_file,callbacks,
-				      jobacct ? jobacct->tres_count : 0);
+				      jobacct ? jobacct->tres_count : 0, 0);
 		}
 	}
 
@@ -887,6 +1009,7 @@ extern void jag_common_fini(void)
 {
 	if (slash_proc)
 		(void) closedir(slash_proc);
+	FREE_NULL_LIST(proc_fd_cache_list);
 }
 
 extern void destroy_jag_prec(void *object)
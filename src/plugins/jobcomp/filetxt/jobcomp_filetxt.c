@@ -125,17 +125,60 @@ _get_group_name(uint32_t group_id, char *group_name, int buf_size)
 	snprintf(group_name, buf_size, "%s", cache_name);
 }
 
+/*
+ * Write a batch of queued completion records with a single write pass,
+ * called from the common async writer thread.
+ */
+static int _write_batch(List records)
+{
+	int rc = SLURM_SUCCESS;
+	char *buf = NULL, *record;
+	size_t offset = 0, tot_size;
+	ssize_t wrote;
+	ListIterator itr;
+
+	if ((log_name == NULL) || (job_comp_fd < 0)) {
+		error("JobCompLoc log file %s not open", log_name);
+		return SLURM_ERROR;
+	}
+
+	itr = list_iterator_create(records);
+	while ((record = list_next(itr)))
+		xstrcat(buf, record);
+	list_iterator_destroy(itr);
+	tot_size = strlen(buf);
+
+	slurm_mutex_lock( &file_lock );
+	while (offset < tot_size) {
+		wrote = write(job_comp_fd, buf + offset, tot_size - offset);
+		if (wrote == -1) {
+			if (errno == EAGAIN)
+				continue;
+			else {
+				rc = SLURM_ERROR;
+				break;
+			}
+		}
+		offset += wrote;
+	}
+	slurm_mutex_unlock( &file_lock );
+	xfree(buf);
+	return rc;
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  * are called.  Put global initialization here.
  */
 int init ( void )
 {
+	jobcomp_async_init(_write_batch);
 	return SLURM_SUCCESS;
 }
 
 int fini ( void )
 {
+	jobcomp_async_fini();	/* drain before closing the file */
 	if (job_comp_fd >= 0)
 		close(job_comp_fd);
 	xfree(log_name);
@@ -206,7 +249,7 @@ extern int slurm_jobcomp_log_record ( struct job_record *job_ptr )
 	char job_rec[1024];
 	char usr_str[32], grp_str[32], start_str[32], end_str[32], lim_str[32];
 	char *resv_name, *gres, *account, *qos, *wckey, *cluster;
-	char *exit_code_str = NULL, *derived_ec_str = NULL;
+	char *exit_code_str = NULL, *derived_ec_str = NULL, *record = NULL;
 	char submit_time[32], eligible_time[32], array_id[64], pack_id[64];
 	char select_buf[128], *state_string, *work_dir;
 	size_t offset = 0, tot_size, wrote;
@@ -359,8 +402,24 @@ extern int slurm_jobcomp_log_record ( struct job_record *job_ptr )
 		 job_ptr->total_cpus, work_dir, resv_name, gres, account, qos,
 		 wckey, cluster, submit_time, eligible_time, array_id, pack_id,
 		 derived_ec_str, exit_code_str, select_buf);
+	xfree(derived_ec_str);
+	xfree(exit_code_str);
+	slurm_mutex_unlock( &file_lock );
+
+	/*
+	 * Hand the formatted record to the write-behind engine so a slow
+	 * file system does not stall the completion path.  If the queue
+	 * is full (or the engine is not running, as in sacct) fall back
+	 * to the old synchronous write.
+	 */
+	record = xstrdup(job_rec);
+	if (jobcomp_async_enqueue(record) == SLURM_SUCCESS)
+		return SLURM_SUCCESS;
+	xfree(record);
+
 	tot_size = strlen(job_rec);
 
+	slurm_mutex_lock( &file_lock );
 	while (offset < tot_size) {
 		wrote = write(job_comp_fd, job_rec + offset,
 			tot_size - offset);
@@ -374,8 +433,6 @@ extern int slurm_jobcomp_log_record ( struct job_record *job_ptr )
 		}
 		offset += wrote;
 	}
-	xfree(derived_ec_str);
-	xfree(exit_code_str);
 	slurm_mutex_unlock( &file_lock );
 	return rc;
 }
@@ -157,6 +157,48 @@ static char *_get_group_name(uint32_t group_id)
 	return ret_name;
 }
 
+/*
+ * Make sure we have a usable database connection, reconnecting if
+ * needed.  Serialized so the async writer thread and the query paths
+ * can not both recreate jobcomp_mysql_conn.
+ */
+static int _check_conn(void)
+{
+	int rc = SLURM_SUCCESS;
+
+	slurm_mutex_lock(&jobcomp_lock);
+	if (!jobcomp_mysql_conn || mysql_db_ping(jobcomp_mysql_conn) != 0) {
+		char *loc = slurm_get_jobcomp_loc();
+		rc = slurm_jobcomp_set_location(loc);
+		xfree(loc);
+	}
+	slurm_mutex_unlock(&jobcomp_lock);
+	return rc;
+}
+
+/*
+ * Run a batch of queued insert statements, called from the common
+ * async writer thread.  mysql_db_query() serializes on the connection
+ * lock, so concurrent fetches from sacct are safe.
+ */
+static int _flush_records(List records)
+{
+	int rc = SLURM_SUCCESS;
+	char *query;
+	ListIterator itr;
+
+	if (_check_conn() != SLURM_SUCCESS)
+		return SLURM_ERROR;
+
+	itr = list_iterator_create(records);
+	while ((query = list_next(itr))) {
+		if (mysql_db_query(jobcomp_mysql_conn, query) != SLURM_SUCCESS)
+			rc = SLURM_ERROR;
+	}
+	list_iterator_destroy(itr);
+	return rc;
+}
+
 /*
  * init() is called when the plugin is loaded, before any other functions
  * are called.  Put global initialization here.
@@ -174,11 +216,14 @@ extern int init ( void )
 		debug4("%s loaded", plugin_name);
 	}
 
+	jobcomp_async_init(_flush_records);
+
 	return SLURM_SUCCESS;
 }
 
 extern int fini ( void )
 {
+	jobcomp_async_fini();	/* drain before dropping the connection */
 	if (jobcomp_mysql_conn) {
 		destroy_mysql_conn(jobcomp_mysql_conn);
 		jobcomp_mysql_conn = NULL;
@@ -216,7 +261,10 @@ extern int slurm_jobcomp_set_location(char *location)
 
 	debug2("mysql_connect() called for db %s", db_name);
 	/* Just make sure our connection is gone. */
-	fini();
+	if (jobcomp_mysql_conn) {
+		destroy_mysql_conn(jobcomp_mysql_conn);
+		jobcomp_mysql_conn = NULL;
+	}
 	jobcomp_mysql_conn = create_mysql_conn(0, 0, NULL);
 
 	db_info = create_mysql_db_info(SLURM_MYSQL_PLUGIN_JC);
@@ -246,15 +294,6 @@ extern int slurm_jobcomp_log_record(struct job_record *job_ptr)
 	char *query = NULL, *on_dup = NULL;
 	uint32_t time_limit, start_time, end_time;
 
-	if (!jobcomp_mysql_conn || mysql_db_ping(jobcomp_mysql_conn) != 0) {
-		char *loc = slurm_get_jobcomp_loc();
-		if (slurm_jobcomp_set_location(loc) == SLURM_ERROR) {
-			xfree(loc);
-			return SLURM_ERROR;
-		}
-		xfree(loc);
-	}
-
 	usr_str = _get_user_name(job_ptr->user_id);
 	grp_str = _get_group_name(job_ptr->group_id);
 
@@ -390,7 +429,19 @@ extern int slurm_jobcomp_log_record(struct job_record *job_ptr)
 
 	debug3("(%s:%d) query\n%s",
 	       THIS_FILE, __LINE__, query);
-	rc = mysql_db_query(jobcomp_mysql_conn, query);
+	/*
+	 * Hand the statement to the write-behind engine so a slow or
+	 * unreachable database does not stall the completion path.  If
+	 * the queue is full (or the engine is not running, as in sacct)
+	 * fall back to the old synchronous query.
+	 */
+	if (jobcomp_async_enqueue(query) == SLURM_SUCCESS) {
+		query = NULL;	/* now owned by the engine */
+	} else if (_check_conn() != SLURM_SUCCESS) {
+		rc = SLURM_ERROR;
+	} else {
+		rc = mysql_db_query(jobcomp_mysql_conn, query);
+	}
 	xfree(usr_str);
 	xfree(grp_str);
 	xfree(jname);
@@ -409,14 +460,8 @@ extern List slurm_jobcomp_get_jobs(slurmdb_job_cond_t *job_cond)
 {
 	List job_list = NULL;
 
-	if (!jobcomp_mysql_conn || mysql_db_ping(jobcomp_mysql_conn) != 0) {
-		char *loc = slurm_get_jobcomp_loc();
-		if (slurm_jobcomp_set_location(loc) == SLURM_ERROR) {
-			xfree(loc);
-			return job_list;
-		}
-		xfree(loc);
-	}
+	if (_check_conn() != SLURM_SUCCESS)
+		return job_list;
 
 	job_list = mysql_jobcomp_process_get_jobs(job_cond);
 
@@ -428,14 +473,8 @@ extern List slurm_jobcomp_get_jobs(slurmdb_job_cond_t *job_cond)
  */
 extern int slurm_jobcomp_archive(slurmdb_archive_cond_t *arch_cond)
 {
-	if (!jobcomp_mysql_conn || mysql_db_ping(jobcomp_mysql_conn) != 0) {
-		char *loc = slurm_get_jobcomp_loc();
-		if (slurm_jobcomp_set_location(loc) == SLURM_ERROR) {
-			xfree(loc);
-			return SLURM_ERROR;
-		}
-		xfree(loc);
-	}
+	if (_check_conn() != SLURM_SUCCESS)
+		return SLURM_ERROR;
 
 	return mysql_jobcomp_process_archive(arch_cond);
 }
@@ -955,6 +955,29 @@ void pmixp_server_sent_buf_cb(int rc, pmixp_p2p_ctx_t ctx, void *data)
 	return;
 }
 
+/*
+ * Deliver a same-node message in place. Routing a message that both
+ * originates and terminates in this stepd through the Slurm RPC stack
+ * (or through a direct connection to ourselves) only adds latency and
+ * serialization overhead.
+ */
+static int _loopback_send(pmixp_base_hdr_t *bhdr, Buf buf,
+			  pmixp_server_sent_cb_t complete_cb, void *cb_data)
+{
+	Buf lbuf = init_buf(bhdr->msgsize);
+
+	/* The request processor consumes the buffer it is given, while
+	 * `buf` remains owned (and possibly recycled) by the completion
+	 * callback, so hand over a private copy of the payload
+	 */
+	memcpy(get_buf_data(lbuf),
+	       get_buf_data(buf) + PMIXP_SERVER_BUFFER_OFFS,
+	       bhdr->msgsize);
+	complete_cb(SLURM_SUCCESS, PMIXP_P2P_INLINE, cb_data);
+	_process_server_request(bhdr, lbuf);
+	return SLURM_SUCCESS;
+}
+
 int pmixp_server_send_nb(pmixp_ep_t *ep, pmixp_srv_cmd_t type,
 			 uint32_t seq, Buf buf,
 			 pmixp_server_sent_cb_t complete_cb,
@@ -966,6 +989,12 @@ int pmixp_server_send_nb(pmixp_ep_t *ep, pmixp_srv_cmd_t type,
 
 	PMIXP_BASE_HDR_SETUP(bhdr, type, seq, buf);
 
+	/* a message to ourselves doesn't need any transport */
+	if ((PMIXP_EP_NOIDEID == ep->type) &&
+	    ((uint32_t)ep->ep.nodeid == pmixp_info_nodeid_job())) {
+		return _loopback_send(&bhdr, buf, complete_cb, cb_data);
+	}
+
 	/* if direct connection is not enabled
 	 * always use Slurm protocol
 	 */
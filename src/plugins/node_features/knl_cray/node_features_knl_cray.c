@@ -258,6 +258,7 @@ typedef struct numa_cfg2 {
 	char *numa_cfg;
 } numa_cfg2_t;
 
+static void *_capmc_inventory_agent(void *args);
 static void _check_node_disabled(void);
 static void _check_node_status(void);
 static s_p_hashtbl_t *_config_make_tbl(char *filename);
@@ -2183,6 +2184,65 @@ extern void *_queue_agent(void *args)
 	return NULL;
 }
 
+/* State of a single capmc inventory query run by _capmc_inventory_agent() */
+typedef struct capmc_inventory {
+	char *cmd;		/* capmc sub-command to execute */
+	char *resp_msg;		/* response, NULL on error */
+	int rc;			/* SLURM_SUCCESS or SLURM_ERROR */
+} capmc_inventory_t;
+
+/*
+ * Run a single "capmc <cmd>" inventory query with the standard retry logic.
+ * The MCDRAM/NUMA queries issued by _update_node_state() are independent of
+ * each other, so each one runs in its own thread and their command execution
+ * and State Manager wait times overlap rather than accumulate.
+ */
+static void *_capmc_inventory_agent(void *args)
+{
+	capmc_inventory_t *inv = (capmc_inventory_t *) args;
+	char **script_argv, *resp_msg;
+	int retry, status = 0;
+	DEF_TIMERS;
+
+	script_argv = xmalloc(sizeof(char *) * 4);	/* NULL terminated */
+	script_argv[0] = xstrdup("capmc");
+	script_argv[1] = xstrdup(inv->cmd);
+	for (retry = 0; ; retry++) {
+		START_TIMER;
+		resp_msg = _run_script(capmc_path, script_argv, &status);
+		END_TIMER;
+		if (debug_flag)
+			info("%s: %s ran for %s", __func__, inv->cmd, TIME_STR);
+		_log_script_argv(script_argv, resp_msg);
+		if (WIFEXITED(status) && (WEXITSTATUS(status) == 0))
+			break;	/* Success */
+		error("%s: %s status:%u response:%s",
+		      __func__, inv->cmd, status, resp_msg);
+		if (resp_msg == NULL) {
+			info("%s: %s returned no information",
+			     __func__, inv->cmd);
+			_free_script_argv(script_argv);
+			inv->rc = SLURM_ERROR;
+			return NULL;
+		}
+		if (strstr(resp_msg, "Could not lookup") &&
+		    (retry <= capmc_retries)) {
+			/* State Manager is down. Sleep and retry */
+			sleep(1);
+			xfree(resp_msg);
+		} else {
+			xfree(resp_msg);
+			_free_script_argv(script_argv);
+			inv->rc = SLURM_ERROR;
+			return NULL;
+		}
+	}
+	_free_script_argv(script_argv);
+	inv->resp_msg = resp_msg;
+	inv->rc = SLURM_SUCCESS;
+	return NULL;
+}
+
 /* Queue request to update node information */
 static int _queue_node_update(char *node_list)
 {
@@ -2215,9 +2275,15 @@ static int _update_node_state(char *node_list, bool set_locks)
 {
 	json_object *j;
 	json_object_iter iter;
-	int i, k, rc = SLURM_SUCCESS, retry, status = 0;
+	int i, k, rc = SLURM_SUCCESS;
 	DEF_TIMERS;
-	char *resp_msg, **script_argv;
+	char *resp_msg;
+	capmc_inventory_t inv[4] = {
+		{ "get_mcdram_capabilities", NULL, SLURM_SUCCESS },
+		{ "get_mcdram_cfg",          NULL, SLURM_SUCCESS },
+		{ "get_numa_capabilities",   NULL, SLURM_SUCCESS },
+		{ "get_numa_cfg",            NULL, SLURM_SUCCESS } };
+	pthread_t inv_thread[4];
 	mcdram_cap_t *mcdram_cap = NULL;
 	mcdram_cfg_t *mcdram_cfg = NULL;
 	mcdram_cfg2_t *mcdram_cfg2 = NULL;
@@ -2244,45 +2310,28 @@ static int _update_node_state(char *node_list, bool set_locks)
 		mcdram_per_node = xmalloc(sizeof(uint64_t) * node_record_count);
 
 	/*
-	 * Load available MCDRAM capabilities
+	 * Load the available MCDRAM/NUMA capabilities and the current
+	 * MCDRAM/NUMA configurations. The four capmc queries are independent,
+	 * so issue them concurrently and wait for all of them to finish.
 	 */
-	script_argv = xmalloc(sizeof(char *) * 4);	/* NULL terminated */
-	script_argv[0] = xstrdup("capmc");
-	script_argv[1] = xstrdup("get_mcdram_capabilities");
-	for (retry = 0; ; retry++) {
-		START_TIMER;
-		resp_msg = _run_script(capmc_path, script_argv, &status);
-		END_TIMER;
-		if (debug_flag) {
-			info("%s: get_mcdram_capabilities ran for %s",
-			     __func__, TIME_STR);
-		}
-		_log_script_argv(script_argv, resp_msg);
-		if (WIFEXITED(status) && (WEXITSTATUS(status) == 0))
-			break;	/* Success */
-		error("%s: get_mcdram_capabilities status:%u response:%s",
-		      __func__, status, resp_msg);
-		if (resp_msg == NULL) {
-			info("%s: get_mcdram_capabilities returned no information",
-			     __func__);
-			_free_script_argv(script_argv);
-			rc = SLURM_ERROR;
-			goto fini;
-		}
-		if (strstr(resp_msg, "Could not lookup") &&
-		    (retry <= capmc_retries)) {
-			/* State Manager is down. Sleep and retry */
-			sleep(1);
-			xfree(resp_msg);
-		} else {
-			xfree(resp_msg);
-			_free_script_argv(script_argv);
+	for (i = 0; i < 4; i++) {
+		slurm_thread_create(&inv_thread[i], _capmc_inventory_agent,
+				    &inv[i]);
+	}
+	for (i = 0; i < 4; i++)
+		pthread_join(inv_thread[i], NULL);
+	for (i = 0; i < 4; i++) {
+		if (inv[i].rc != SLURM_SUCCESS) {
 			rc = SLURM_ERROR;
 			goto fini;
 		}
 	}
-	_free_script_argv(script_argv);
 
+	/*
+	 * Parse available MCDRAM capabilities
+	 */
+	resp_msg = inv[0].resp_msg;
+	inv[0].resp_msg = NULL;
 	j = json_tokener_parse(resp_msg);
 	if (j == NULL) {
 		error("%s: json parser failed on %s", __func__, resp_msg);
@@ -2301,45 +2350,10 @@ static int _update_node_state(char *node_list, bool set_locks)
 	json_object_put(j);	/* Frees json memory */
 
 	/*
-	 * Load current MCDRAM configuration
+	 * Parse current MCDRAM configuration
 	 */
-	script_argv = xmalloc(sizeof(char *) * 4);	/* NULL terminated */
-	script_argv[0] = xstrdup("capmc");
-	script_argv[1] = xstrdup("get_mcdram_cfg");
-	for (retry = 0; ; retry++) {
-		START_TIMER;
-		resp_msg = _run_script(capmc_path, script_argv, &status);
-		END_TIMER;
-		if (debug_flag) {
-			info("%s: get_mcdram_cfg ran for %s",
-			     __func__, TIME_STR);
-		}
-		_log_script_argv(script_argv, resp_msg);
-		if (WIFEXITED(status) && (WEXITSTATUS(status) == 0))
-			break;	/* Success */
-		error("%s: get_mcdram_cfg status:%u response:%s",
-		      __func__, status, resp_msg);
-		if (resp_msg == NULL) {
-			info("%s: get_mcdram_cfg returned no information",
-			     __func__);
-			_free_script_argv(script_argv);
-			rc = SLURM_ERROR;
-			goto fini;
-		}
-		if (strstr(resp_msg, "Could not lookup") &&
-		    (retry <= capmc_retries)) {
-			/* State Manager is down. Sleep and retry */
-			sleep(1);
-			xfree(resp_msg);
-		} else {
-			xfree(resp_msg);
-			_free_script_argv(script_argv);
-			rc = SLURM_ERROR;
-			goto fini;
-		}
-	}
-	_free_script_argv(script_argv);
-
+	resp_msg = inv[1].resp_msg;
+	inv[1].resp_msg = NULL;
 	j = json_tokener_parse(resp_msg);
 	if (j == NULL) {
 		error("%s: json parser failed on %s", __func__, resp_msg);
@@ -2360,45 +2374,10 @@ static int _update_node_state(char *node_list, bool set_locks)
 	mcdram_cfg2 = _load_current_mcdram(&mcdram_cfg2_cnt);
 
 	/*
-	 * Load available NUMA capabilities
+	 * Parse available NUMA capabilities
 	 */
-	script_argv = xmalloc(sizeof(char *) * 4);	/* NULL terminated */
-	script_argv[0] = xstrdup("capmc");
-	script_argv[1] = xstrdup("get_numa_capabilities");
-	for (retry = 0; ; retry++) {
-		START_TIMER;
-		resp_msg = _run_script(capmc_path, script_argv, &status);
-		END_TIMER;
-		if (debug_flag) {
-			info("%s: get_numa_capabilities ran for %s",
-			     __func__, TIME_STR);
-		}
-		_log_script_argv(script_argv, resp_msg);
-		if (WIFEXITED(status) && (WEXITSTATUS(status) == 0))
-			break;	/* Success */
-		error("%s: get_numa_capabilities status:%u response:%s",
-		      __func__, status, resp_msg);
-		if (resp_msg == NULL) {
-			info("%s: get_numa_capabilities returned no information",
-			     __func__);
-			_free_script_argv(script_argv);
-			rc = SLURM_ERROR;
-			goto fini;
-		}
-		if (strstr(resp_msg, "Could not lookup") &&
-		    (retry <= capmc_retries)) {
-			/* State Manager is down. Sleep and retry */
-			sleep(1);
-			xfree(resp_msg);
-		} else {
-			xfree(resp_msg);
-			_free_script_argv(script_argv);
-			rc = SLURM_ERROR;
-			goto fini;
-		}
-	}
-	_free_script_argv(script_argv);
-
+	resp_msg = inv[2].resp_msg;
+	inv[2].resp_msg = NULL;
 	j = json_tokener_parse(resp_msg);
 	if (j == NULL) {
 		error("%s: json parser failed on %s", __func__, resp_msg);
@@ -2417,43 +2396,10 @@ static int _update_node_state(char *node_list, bool set_locks)
 	json_object_put(j);	/* Frees json memory */
 
 	/*
-	 * Load current NUMA configuration
+	 * Parse current NUMA configuration
 	 */
-	script_argv = xmalloc(sizeof(char *) * 4);	/* NULL terminated */
-	script_argv[0] = xstrdup("capmc");
-	script_argv[1] = xstrdup("get_numa_cfg");
-	for (retry = 0; ; retry++) {
-		START_TIMER;
-		resp_msg = _run_script(capmc_path, script_argv, &status);
-		END_TIMER;
-		if (debug_flag)
-			info("%s: get_numa_cfg ran for %s", __func__, TIME_STR);
-		_log_script_argv(script_argv, resp_msg);
-		if (WIFEXITED(status) && (WEXITSTATUS(status) == 0))
-			break;	/* Success */
-		error("%s: get_numa_cfg status:%u response:%s",
-		      __func__, status, resp_msg);
-		if (resp_msg == NULL) {
-			info("%s: get_numa_cfg returned no information",
-			     __func__);
-			_free_script_argv(script_argv);
-			rc = SLURM_ERROR;
-			goto fini;
-		}
-		if (strstr(resp_msg, "Could not lookup") &&
-		    (retry <= capmc_retries)) {
-			/* State Manager is down. Sleep and retry */
-			sleep(1);
-			xfree(resp_msg);
-		} else {
-			xfree(resp_msg);
-			_free_script_argv(script_argv);
-			rc = SLURM_ERROR;
-			goto fini;
-		}
-	}
-	_free_script_argv(script_argv);
-
+	resp_msg = inv[3].resp_msg;
+	inv[3].resp_msg = NULL;
 	j = json_tokener_parse(resp_msg);
 	if (j == NULL) {
 		error("%s: json parser failed on %s", __func__, resp_msg);
@@ -2602,7 +2548,9 @@ static int _update_node_state(char *node_list, bool set_locks)
 
 	last_node_update = time(NULL);
 
-fini:	_mcdram_cap_free(mcdram_cap, mcdram_cap_cnt);
+fini:	for (i = 0; i < 4; i++)
+		xfree(inv[i].resp_msg);
+	_mcdram_cap_free(mcdram_cap, mcdram_cap_cnt);
 	_mcdram_cfg_free(mcdram_cfg, mcdram_cfg_cnt);
 	_mcdram_cfg2_free(mcdram_cfg2, mcdram_cfg2_cnt);
 	_numa_cap_free(numa_cap, numa_cap_cnt);
@@ -46,6 +46,7 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/plugin.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/job_scheduler.h"
@@ -61,6 +62,73 @@ static int _sort_by_youngest(void *x, void *y);
 
 static bool youngest_order = false;
 
+/*
+ * Running jobs in partitions subject to preemption, sorted by ascending
+ * partition priority tier. The scheduler and backfill call
+ * find_preemptable_jobs() once per pending preemptor, so without this
+ * index every call walks the entire job_list (mostly pending jobs) to
+ * find the same handful of running candidates. Job state changes and
+ * partition updates both bump their generation stamps, so the array is
+ * rebuilt at most once per change. Per-preemptor conditions (tier
+ * comparison, node overlap, preemption exemption) are still evaluated
+ * live against each candidate.
+ */
+typedef struct {
+	struct job_record *job_ptr;
+	uint16_t prio_tier;	/* candidate's partition priority tier */
+} cand_rec_t;
+
+static cand_rec_t *cand_array = NULL;
+static int cand_cnt = 0;
+static int cand_size = 0;
+static time_t cand_job_gen = 0;
+static time_t cand_part_gen = 0;
+static time_t cand_fill_time = 0;
+
+static int _sort_cand_by_tier(const void *x, const void *y)
+{
+	const cand_rec_t *c1 = x;
+	const cand_rec_t *c2 = y;
+
+	if (c1->prio_tier > c2->prio_tier)
+		return 1;
+	if (c1->prio_tier < c2->prio_tier)
+		return -1;
+	return 0;
+}
+
+static void _build_cand_array(void)
+{
+	ListIterator job_iterator;
+	struct job_record *job_p;
+
+	cand_cnt = 0;
+	job_iterator = list_iterator_create(job_list);
+	while ((job_p = (struct job_record *) list_next(job_iterator))) {
+		if (!IS_JOB_RUNNING(job_p) && !IS_JOB_SUSPENDED(job_p))
+			continue;
+		if ((job_p->part_ptr == NULL) ||
+		    (job_p->part_ptr->preempt_mode == PREEMPT_MODE_OFF))
+			continue;
+		if (job_p->node_bitmap == NULL)
+			continue;
+		if (cand_cnt >= cand_size) {
+			cand_size = MAX(cand_size * 2, 64);
+			xrealloc(cand_array, cand_size * sizeof(cand_rec_t));
+		}
+		cand_array[cand_cnt].job_ptr = job_p;
+		cand_array[cand_cnt].prio_tier =
+			job_p->part_ptr->priority_tier;
+		cand_cnt++;
+	}
+	list_iterator_destroy(job_iterator);
+
+	qsort(cand_array, cand_cnt, sizeof(cand_rec_t), _sort_cand_by_tier);
+	cand_job_gen = last_job_update;
+	cand_part_gen = last_part_update;
+	cand_fill_time = time(NULL);
+}
+
 extern int init(void)
 {
 	char *sched_params;
@@ -74,14 +142,15 @@ extern int init(void)
 
 extern void fini(void)
 {
-	/* Empty. */
+	xfree(cand_array);
+	cand_cnt = cand_size = 0;
 }
 
 extern List find_preemptable_jobs(struct job_record *job_ptr)
 {
-	ListIterator job_iterator;
 	struct job_record *job_p;
 	List preemptee_job_list = NULL;
+	int i;
 
 	/* Validate the preemptor job */
 	if (job_ptr == NULL) {
@@ -102,19 +171,20 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 		return preemptee_job_list;
 	}
 
+	if ((cand_job_gen != last_job_update) ||
+	    (cand_part_gen != last_part_update) ||
+	    (cand_fill_time <= cand_job_gen) ||
+	    (cand_fill_time <= cand_part_gen))
+		_build_cand_array();
+
 	/* Build an array of pointers to preemption candidates */
-	job_iterator = list_iterator_create(job_list);
-	while ((job_p = (struct job_record *) list_next(job_iterator))) {
-		if (!IS_JOB_RUNNING(job_p) && !IS_JOB_SUSPENDED(job_p))
-			continue;
-		if ((job_p->part_ptr == NULL) ||
-		    (job_p->part_ptr->priority_tier >=
-		     job_ptr->part_ptr->priority_tier) ||
-		    (job_p->part_ptr->preempt_mode == PREEMPT_MODE_OFF))
-			continue;
-		if ((job_p->node_bitmap == NULL) ||
-		    (bit_overlap(job_p->node_bitmap,
-				 job_ptr->part_ptr->node_bitmap) == 0))
+	for (i = 0; i < cand_cnt; i++) {
+		if (cand_array[i].prio_tier >=
+		    job_ptr->part_ptr->priority_tier)
+			break;	/* sorted by tier, no more candidates */
+		job_p = cand_array[i].job_ptr;
+		if (bit_overlap(job_p->node_bitmap,
+				job_ptr->part_ptr->node_bitmap) == 0)
 			continue;
 		if (job_ptr->details &&
 		    (job_ptr->details->expanding_jobid == job_p->job_id))
@@ -128,7 +198,6 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 		}
 		list_append(preemptee_job_list, job_p);
 	}
-	list_iterator_destroy(job_iterator);
 
 	if (preemptee_job_list && youngest_order)
 		list_sort(preemptee_job_list, _sort_by_youngest);
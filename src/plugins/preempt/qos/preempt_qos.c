@@ -46,6 +46,7 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/plugin.h"
+#include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/common/slurm_accounting_storage.h"
 #include "src/slurmctld/slurmctld.h"
@@ -64,6 +65,46 @@ static int _sort_by_youngest(void *x, void *y);
 
 static bool youngest_order = false;
 
+/*
+ * Cache of running jobs which could be preempted by some QOS, so each
+ * find_preemptable_jobs() call (one per pending preemptor, repeated
+ * within backfill cycles) only examines running jobs rather than
+ * walking the entire job_list. Any job state change bumps
+ * last_job_update, invalidating the cache. QOS preemption rules are
+ * checked live per preemptor since QOS updates do not bump any
+ * generation stamp.
+ */
+static struct job_record **cand_jobs = NULL;
+static int cand_job_cnt = 0;
+static int cand_job_size = 0;
+static time_t cand_job_gen = 0;
+static time_t cand_fill_time = 0;
+
+static void _build_cand_jobs(void)
+{
+	ListIterator job_iterator;
+	struct job_record *job_p;
+
+	cand_job_cnt = 0;
+	job_iterator = list_iterator_create(job_list);
+	while ((job_p = (struct job_record *) list_next(job_iterator))) {
+		if (!IS_JOB_RUNNING(job_p) && !IS_JOB_SUSPENDED(job_p))
+			continue;
+		if ((job_p->qos_ptr == NULL) || (job_p->node_bitmap == NULL))
+			continue;
+		if (cand_job_cnt >= cand_job_size) {
+			cand_job_size = MAX(cand_job_size * 2, 64);
+			xrealloc(cand_jobs, cand_job_size *
+				 sizeof(struct job_record *));
+		}
+		cand_jobs[cand_job_cnt++] = job_p;
+	}
+	list_iterator_destroy(job_iterator);
+
+	cand_job_gen = last_job_update;
+	cand_fill_time = time(NULL);
+}
+
 extern int init(void)
 {
 	char *sched_params;
@@ -77,14 +118,15 @@ extern int init(void)
 
 extern void fini(void)
 {
-	/* Empty. */
+	xfree(cand_jobs);
+	cand_job_cnt = cand_job_size = 0;
 }
 
 extern List find_preemptable_jobs(struct job_record *job_ptr)
 {
-	ListIterator job_iterator;
 	struct job_record *job_p;
 	List preemptee_job_list = NULL;
+	int i;
 
 	/* Validate the preemptor job */
 	if (job_ptr == NULL) {
@@ -105,16 +147,17 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 		return preemptee_job_list;
 	}
 
+	if ((cand_job_gen != last_job_update) ||
+	    (cand_fill_time <= cand_job_gen))
+		_build_cand_jobs();
+
 	/* Build an array of pointers to preemption candidates */
-	job_iterator = list_iterator_create(job_list);
-	while ((job_p = (struct job_record *) list_next(job_iterator))) {
-		if (!IS_JOB_RUNNING(job_p) && !IS_JOB_SUSPENDED(job_p))
-			continue;
+	for (i = 0; i < cand_job_cnt; i++) {
+		job_p = cand_jobs[i];
 		if (!_qos_preemptable(job_p, job_ptr))
 			continue;
-		if ((job_p->node_bitmap == NULL) ||
-		    (bit_overlap(job_p->node_bitmap,
-				 job_ptr->part_ptr->node_bitmap) == 0))
+		if (bit_overlap(job_p->node_bitmap,
+				job_ptr->part_ptr->node_bitmap) == 0)
 			continue;
 		if (job_ptr->details &&
 		    (job_ptr->details->expanding_jobid == job_p->job_id))
@@ -128,7 +171,6 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 		}
 		list_append(preemptee_job_list, job_p);
 	}
-	list_iterator_destroy(job_iterator);
 
 	if (preemptee_job_list && youngest_order)
 		list_sort(preemptee_job_list, _sort_by_youngest);
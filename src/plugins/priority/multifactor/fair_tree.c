@@ -41,6 +41,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include "fair_tree.h"
 
@@ -68,6 +69,7 @@ extern void fair_tree_decay(List jobs, time_t start)
 
 	/* assign job priorities */
 	lock_slurmctld(job_write_lock);
+	decay_factors_epoch_roll();
 	list_for_each(jobs, (ListForF) decay_apply_weighted_factors, &start);
 	unlock_slurmctld(job_write_lock);
 }
@@ -384,6 +386,131 @@ static void _calc_tree_fs(slurmdb_assoc_rec_t** siblings,
 }
 
 
+/*
+ * A slice of the sorted top-level sibling array whose rank range is
+ * known in advance, so its subtrees can be ranked independently of the
+ * other slices.
+ */
+typedef struct {
+	slurmdb_assoc_rec_t **entries;	/* null terminated copy */
+	uint32_t rank;			/* rank counter at entry */
+} ft_work_unit_t;
+
+static List ft_work_list = NULL;
+
+static void _ft_work_unit_del(void *x)
+{
+	ft_work_unit_t *unit = x;
+
+	xfree(unit->entries);
+	xfree(unit);
+}
+
+/* Number of user associations at or below this association */
+static uint32_t _count_subtree_users(slurmdb_assoc_rec_t *assoc)
+{
+	ListIterator itr;
+	slurmdb_assoc_rec_t *child;
+	uint32_t cnt = 0;
+
+	if (assoc->user)
+		return 1;
+
+	if (!assoc->usage->children_list)
+		return 0;
+
+	itr = list_iterator_create(assoc->usage->children_list);
+	while ((child = list_next(itr)))
+		cnt += _count_subtree_users(child);
+	list_iterator_destroy(itr);
+
+	return cnt;
+}
+
+static void *_ft_worker(void *arg)
+{
+	ft_work_unit_t *unit;
+
+	while ((unit = list_dequeue(ft_work_list))) {
+		uint32_t rank = unit->rank;
+		uint32_t rnt = unit->rank;
+
+		/*
+		 * _calc_tree_fs() recomputes the level_fs values of the
+		 * slice and re-sorts it, both of which are idempotent,
+		 * then ranks the slice exactly as the serial walk would
+		 * have when it reached this point.
+		 */
+		_calc_tree_fs(unit->entries, 0, &rank, &rnt, false);
+		_ft_work_unit_del(unit);
+	}
+
+	return NULL;
+}
+
+/*
+ * Rank the sorted top-level siblings with a pool of workers.  The tie
+ * rules only couple adjacent siblings with equal level_fs values, and
+ * the rank counter entering each sibling depends only on how many user
+ * associations precede it in sorted order.  So the array is cut into
+ * slices at every boundary where adjacent siblings are not tied, each
+ * slice gets its rank start from a running user count, and the slices
+ * are processed concurrently.
+ */
+static void _calc_tree_fs_parallel(slurmdb_assoc_rec_t **siblings,
+				   size_t child_count)
+{
+	slurmdb_assoc_rec_t *assoc;
+	pthread_t *tids;
+	uint32_t rnt = g_user_assoc_count;
+	size_t i, begin, end;
+	int nthreads, t;
+
+	/* Calculate level_fs then sort, as _calc_tree_fs() would */
+	for (i = 0; (assoc = siblings[i]); i++)
+		_calc_assoc_fs(assoc);
+	qsort(siblings, i, sizeof(slurmdb_assoc_rec_t *), _cmp_level_fs);
+
+	ft_work_list = list_create(_ft_work_unit_del);
+
+	for (begin = 0; begin < child_count; begin = end + 1) {
+		ft_work_unit_t *unit;
+		size_t cnt;
+
+		end = begin;
+		while (siblings[end + 1] &&
+		       (siblings[end]->usage->level_fs ==
+			siblings[end + 1]->usage->level_fs))
+			end++;
+
+		cnt = end - begin + 1;
+		unit = xmalloc(sizeof(ft_work_unit_t));
+		unit->entries = xcalloc(cnt + 1,
+					sizeof(slurmdb_assoc_rec_t *));
+		memcpy(unit->entries, siblings + begin,
+		       cnt * sizeof(slurmdb_assoc_rec_t *));
+		unit->rank = rnt;
+		list_enqueue(ft_work_list, unit);
+
+		for (i = begin; i <= end; i++)
+			rnt -= _count_subtree_users(siblings[i]);
+	}
+
+	nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads < 1)
+		nthreads = 1;
+	nthreads = MIN(nthreads, list_count(ft_work_list));
+
+	tids = xcalloc(nthreads, sizeof(pthread_t));
+	for (t = 0; t < nthreads; t++)
+		slurm_thread_create(&tids[t], _ft_worker, NULL);
+	for (t = 0; t < nthreads; t++)
+		pthread_join(tids[t], NULL);
+	xfree(tids);
+
+	FREE_NULL_LIST(ft_work_list);
+}
+
 /* Start fairshare calculations at root. Call assoc_mgr_lock before this. */
 static void _apply_priority_fs(void)
 {
@@ -403,7 +530,15 @@ static void _apply_priority_fs(void)
 		children,
 		&child_count);
 
-	_calc_tree_fs(children, 0, &rank, &rnt, false);
+	/*
+	 * Keep the serial walk for small trees, where thread start-up
+	 * costs more than it saves, and under priority_debug so the
+	 * trace comes out in rank order.
+	 */
+	if (priority_debug || (child_count < 4))
+		_calc_tree_fs(children, 0, &rank, &rnt, false);
+	else
+		_calc_tree_fs_parallel(children, child_count);
 
 	xfree(children);
 }
@@ -153,12 +153,88 @@ static uint32_t prevflags;    /* Priority Flags before _internal_setup() resets
 static time_t g_last_ran = 0; /* when the last poll ran */
 static double decay_factor = 1; /* The decay factor when decaying time. */
 
+/*
+ * Generation counter over the global inputs to the priority factors.
+ * Bumped whenever something that can move a job's factors without the
+ * job itself changing has happened: new usage accrued, a usage reset,
+ * an association update from the database, a reconfigure, or a change
+ * to the cluster size or partition table.  A pending job whose stored
+ * factors were computed in the current generation and whose job-local
+ * inputs still match does not need to be re-scored, which lets the
+ * decay thread skip the bulk of a large stable backlog.  Like
+ * last_job_update, these are read without locking; a missed update
+ * only delays a re-score by one calc period.
+ */
+static uint64_t factors_epoch = 1;
+static bool usage_accrued = false; /* new usage applied since last roll */
+
 /* variables defined in priority_multifactor.h */
 bool priority_debug = 0;
 
 static void _priority_p_set_assoc_usage_debug(slurmdb_assoc_rec_t *assoc);
 static void _set_assoc_usage_efctv(slurmdb_assoc_rec_t *assoc);
 
+/*
+ * Flattened views of the association and QOS usage records.  The decay
+ * and reset sweeps touch every record, and chasing the list nodes one
+ * element at a time takes the list mutex per element and defeats the
+ * hardware prefetcher.  Instead the usage pointers are gathered into
+ * these arrays with a single list_for_each() pass and the arithmetic
+ * runs as a linear sweep over the arrays.  The arrays are only valid
+ * while the assoc and QOS write locks from the gathering pass are
+ * still held, so they never outlive a list change.
+ */
+static slurmdb_assoc_usage_t **assoc_usage_flat = NULL;
+static slurmdb_qos_usage_t **qos_usage_flat = NULL;
+static int assoc_usage_cnt = 0, qos_usage_cnt = 0;
+static int assoc_usage_size = 0, qos_usage_size = 0;
+
+static int _flatten_assoc_usage(void *x, void *arg)
+{
+	slurmdb_assoc_rec_t *assoc = x;
+
+	assoc_usage_flat[assoc_usage_cnt++] = assoc->usage;
+	return 0;
+}
+
+static int _flatten_qos_usage(void *x, void *arg)
+{
+	slurmdb_qos_rec_t *qos = x;
+	bool *skip_nodecay = arg;
+
+	if (*skip_nodecay && (qos->flags & QOS_FLAG_NO_DECAY))
+		return 0;
+	qos_usage_flat[qos_usage_cnt++] = qos->usage;
+	return 0;
+}
+
+/*
+ * Rebuild the flat usage arrays from the current lists.  Caller must
+ * hold the assoc and QOS write locks.
+ */
+static void _gather_usage_flat(bool skip_nodecay)
+{
+	int cnt;
+
+	cnt = list_count(assoc_mgr_assoc_list);
+	if (cnt > assoc_usage_size) {
+		assoc_usage_size = cnt;
+		xrecalloc(assoc_usage_flat, assoc_usage_size,
+			  sizeof(slurmdb_assoc_usage_t *));
+	}
+	assoc_usage_cnt = 0;
+	list_for_each(assoc_mgr_assoc_list, _flatten_assoc_usage, NULL);
+
+	cnt = list_count(assoc_mgr_qos_list);
+	if (cnt > qos_usage_size) {
+		qos_usage_size = cnt;
+		xrecalloc(qos_usage_flat, qos_usage_size,
+			  sizeof(slurmdb_qos_usage_t *));
+	}
+	qos_usage_cnt = 0;
+	list_for_each(assoc_mgr_qos_list, _flatten_qos_usage, &skip_nodecay);
+}
+
 /*
  * apply decay factor to all associations usage_raw
  * IN: real_decay - decay to be applied to each associations' used
@@ -168,10 +244,7 @@ static void _set_assoc_usage_efctv(slurmdb_assoc_rec_t *assoc);
  */
 static int _apply_decay(double real_decay)
 {
-	int i;
-	ListIterator itr = NULL;
-	slurmdb_assoc_rec_t *assoc = NULL;
-	slurmdb_qos_rec_t *qos = NULL;
+	int i, j;
 	assoc_mgr_lock_t locks = { WRITE_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK,
 				   NO_LOCK, NO_LOCK, NO_LOCK };
 
@@ -188,28 +261,28 @@ static int _apply_decay(double real_decay)
 	xassert(assoc_mgr_assoc_list);
 	xassert(assoc_mgr_qos_list);
 
-	itr = list_iterator_create(assoc_mgr_assoc_list);
+	_gather_usage_flat(true);
+
 	/* We want to do this to all associations including root.
 	   All usage_raws are calculated from the bottom up.
 	*/
-	while ((assoc = list_next(itr))) {
-		assoc->usage->usage_raw *= real_decay;
-		for (i=0; i<slurmctld_tres_cnt; i++)
-			assoc->usage->usage_tres_raw[i] *= real_decay;
-		assoc->usage->grp_used_wall *= real_decay;
+	for (i = 0; i < assoc_usage_cnt; i++) {
+		slurmdb_assoc_usage_t *usage = assoc_usage_flat[i];
+
+		usage->usage_raw *= real_decay;
+		for (j = 0; j < slurmctld_tres_cnt; j++)
+			usage->usage_tres_raw[j] *= real_decay;
+		usage->grp_used_wall *= real_decay;
 	}
-	list_iterator_destroy(itr);
 
-	itr = list_iterator_create(assoc_mgr_qos_list);
-	while ((qos = list_next(itr))) {
-		if (qos->flags & QOS_FLAG_NO_DECAY)
-			continue;
-		qos->usage->usage_raw *= real_decay;
-		for (i=0; i<slurmctld_tres_cnt; i++)
-			qos->usage->usage_tres_raw[i] *= real_decay;
-		qos->usage->grp_used_wall *= real_decay;
+	for (i = 0; i < qos_usage_cnt; i++) {
+		slurmdb_qos_usage_t *usage = qos_usage_flat[i];
+
+		usage->usage_raw *= real_decay;
+		for (j = 0; j < slurmctld_tres_cnt; j++)
+			usage->usage_tres_raw[j] *= real_decay;
+		usage->grp_used_wall *= real_decay;
 	}
-	list_iterator_destroy(itr);
 	assoc_mgr_unlock(&locks);
 
 	return SLURM_SUCCESS;
@@ -222,10 +295,7 @@ static int _apply_decay(double real_decay)
  */
 static int _reset_usage(void)
 {
-	ListIterator itr = NULL;
-	slurmdb_assoc_rec_t *assoc = NULL;
-	slurmdb_qos_rec_t *qos = NULL;
-	int i;
+	int i, j;
 	assoc_mgr_lock_t locks = { WRITE_LOCK, NO_LOCK, WRITE_LOCK,
 				   NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
 
@@ -236,26 +306,29 @@ static int _reset_usage(void)
 
 	xassert(assoc_mgr_assoc_list);
 
-	itr = list_iterator_create(assoc_mgr_assoc_list);
+	_gather_usage_flat(false);
+
 	/* We want to do this to all associations including root.
 	 * All usage_raws are calculated from the bottom up.
 	 */
-	while ((assoc = list_next(itr))) {
-		assoc->usage->usage_raw = 0;
-		for (i=0; i<slurmctld_tres_cnt; i++)
-			assoc->usage->usage_tres_raw[i] = 0;
-		assoc->usage->grp_used_wall = 0;
+	for (i = 0; i < assoc_usage_cnt; i++) {
+		slurmdb_assoc_usage_t *usage = assoc_usage_flat[i];
+
+		usage->usage_raw = 0;
+		for (j = 0; j < slurmctld_tres_cnt; j++)
+			usage->usage_tres_raw[j] = 0;
+		usage->grp_used_wall = 0;
 	}
-	list_iterator_destroy(itr);
 
-	itr = list_iterator_create(assoc_mgr_qos_list);
-	while ((qos = list_next(itr))) {
-		qos->usage->usage_raw = 0;
-		for (i=0; i<slurmctld_tres_cnt; i++)
-			qos->usage->usage_tres_raw[i] = 0;
-		qos->usage->grp_used_wall = 0;
+	for (i = 0; i < qos_usage_cnt; i++) {
+		slurmdb_qos_usage_t *usage = qos_usage_flat[i];
+
+		usage->usage_raw = 0;
+		for (j = 0; j < slurmctld_tres_cnt; j++)
+			usage->usage_tres_raw[j] = 0;
+		usage->grp_used_wall = 0;
 	}
-	list_iterator_destroy(itr);
+	factors_epoch++;
 	assoc_mgr_unlock(&locks);
 
 	return SLURM_SUCCESS;
@@ -1187,6 +1260,7 @@ static int _apply_new_usage(struct job_record *job_ptr,
 
 		assoc = assoc->usage->parent_assoc_ptr;
 	}
+	usage_accrued = true;
 	assoc_mgr_unlock(&locks);
 	return 1;
 }
@@ -1382,6 +1456,7 @@ static void *_decay_thread(void *no_data)
 		site_factor_g_update();
 
 		if (!(flags & PRIORITY_FLAGS_FAIR_TREE)) {
+			decay_factors_epoch_roll();
 			list_for_each(
 				job_list,
 				(ListForF) _decay_apply_new_usage_and_weighted_factors,
@@ -1399,6 +1474,9 @@ static void *_decay_thread(void *no_data)
 
 		_write_last_decay_ran(g_last_ran, last_reset);
 
+		/* Usage just changed, refresh the sshare snapshot */
+		assoc_mgr_clear_shares_cache();
+
 		running_decay = 0;
 
 		/* Sleep until the next time. */
@@ -1836,6 +1914,11 @@ int fini ( void )
 	if (decay_handler_thread)
 		pthread_join(decay_handler_thread, NULL);
 
+	xfree(assoc_usage_flat);
+	xfree(qos_usage_flat);
+	assoc_usage_size = qos_usage_size = 0;
+	assoc_usage_cnt = qos_usage_cnt = 0;
+
 	site_factor_plugin_fini();
 
 	return SLURM_SUCCESS;
@@ -1852,6 +1935,7 @@ extern uint32_t priority_p_set(uint32_t last_prio, struct job_record *job_ptr)
 	site_factor_g_set(job_ptr);
 
 	priority = _get_priority_internal(time(NULL), job_ptr);
+	job_ptr->prio_factors_epoch = factors_epoch;
 
 	debug2("initial priority for job %u is %u", job_ptr->job_id, priority);
 
@@ -1865,6 +1949,7 @@ extern void priority_p_reconfig(bool assoc_clear)
 
 	reconfig = 1;
 	prevflags = flags;
+	factors_epoch++;
 	_internal_setup();
 
 	/* Since Fair Tree uses a different shares calculation method, we
@@ -1923,6 +2008,7 @@ extern void priority_p_set_assoc_usage(slurmdb_assoc_rec_t *assoc)
 
 	set_assoc_usage_norm(assoc);
 	_set_assoc_usage_efctv(assoc);
+	factors_epoch++;
 
 	if (priority_debug)
 		_priority_p_set_assoc_usage_debug(assoc);
@@ -2064,6 +2150,102 @@ extern bool decay_apply_new_usage(struct job_record *job_ptr,
 }
 
 
+/*
+ * Advance the factors generation if anything global changed since the
+ * last scoring pass.  Called with the job write lock held right before
+ * the jobs are re-scored.
+ */
+extern void decay_factors_epoch_roll(void)
+{
+	static uint32_t last_cluster_cpus = NO_VAL;
+	static uint16_t last_max_priority = NO_VAL16;
+	static time_t part_update_seen = 0;
+
+	if (usage_accrued ||
+	    (last_cluster_cpus != cluster_cpus) ||
+	    (last_max_priority != part_max_priority) ||
+	    (part_update_seen != last_part_update)) {
+		factors_epoch++;
+		usage_accrued = false;
+		last_cluster_cpus = cluster_cpus;
+		last_max_priority = part_max_priority;
+		part_update_seen = last_part_update;
+	}
+}
+
+/*
+ * Return true if the factors stored on the job are still current, so
+ * the full re-score can be skipped.  Only cheap job-local inputs are
+ * checked here; every global input is covered by factors_epoch.  The
+ * stored factors carry the weights they were computed with, so each
+ * comparison re-applies the weight to the present input, which yields
+ * a bitwise identical product when nothing changed.
+ */
+static bool _job_factors_current(struct job_record *job_ptr,
+				 time_t start_time)
+{
+	priority_factors_object_t *factors = job_ptr->prio_factors;
+	double expected;
+
+	if (!factors || job_ptr->direct_set_prio || !job_ptr->details)
+		return false;
+
+	if (job_ptr->prio_factors_epoch != factors_epoch)
+		return false;
+
+	/* The site factor plugin may reset this on any cycle. */
+	if (factors->priority_site != job_ptr->site_factor)
+		return false;
+
+	if (factors->nice != job_ptr->details->nice)
+		return false;
+
+	/*
+	 * The age factor keeps rising until the job has been eligible
+	 * for PriorityMaxAge; after that it is pinned at 1.0 and age
+	 * no longer forces a periodic re-score.
+	 */
+	if (weight_age && job_ptr->details->accrue_time) {
+		if ((job_ptr->details->accrue_time + max_age) > start_time)
+			return false;
+		if (factors->priority_age != (double) weight_age)
+			return false;
+	}
+
+	expected = 0.0;
+	if (job_ptr->part_ptr && job_ptr->part_ptr->priority_job_factor &&
+	    weight_part) {
+		expected = ((flags & PRIORITY_FLAGS_NO_NORMAL_PART) ?
+			    job_ptr->part_ptr->priority_job_factor :
+			    job_ptr->part_ptr->norm_priority) *
+			(double) weight_part;
+	}
+	if (factors->priority_part != expected)
+		return false;
+
+	expected = 0.0;
+	if (job_ptr->assoc_ptr && weight_assoc) {
+		expected = ((flags & PRIORITY_FLAGS_NO_NORMAL_ASSOC) ?
+			    job_ptr->assoc_ptr->priority :
+			    job_ptr->assoc_ptr->usage->priority_norm) *
+			(double) weight_assoc;
+	}
+	if (factors->priority_assoc != expected)
+		return false;
+
+	expected = 0.0;
+	if (job_ptr->qos_ptr && job_ptr->qos_ptr->priority && weight_qos) {
+		expected = ((flags & PRIORITY_FLAGS_NO_NORMAL_QOS) ?
+			    job_ptr->qos_ptr->priority :
+			    job_ptr->qos_ptr->usage->norm_priority) *
+			(double) weight_qos;
+	}
+	if (factors->priority_qos != expected)
+		return false;
+
+	return true;
+}
+
 extern int decay_apply_weighted_factors(struct job_record *job_ptr,
 					 time_t *start_time_ptr)
 {
@@ -2082,9 +2264,17 @@ extern int decay_apply_weighted_factors(struct job_record *job_ptr,
 	     !(flags & PRIORITY_FLAGS_CALCULATE_RUNNING)))
 		return SLURM_SUCCESS;
 
+	if (_job_factors_current(job_ptr, *start_time_ptr)) {
+		debug3("priority for job %u is unchanged",
+		       job_ptr->job_id);
+		return SLURM_SUCCESS;
+	}
+
 	new_prio = _get_priority_internal(*start_time_ptr, job_ptr);
-	if (((flags & PRIORITY_FLAGS_INCR_ONLY) == 0) ||
-	    (job_ptr->priority < new_prio)) {
+	job_ptr->prio_factors_epoch = factors_epoch;
+	if ((((flags & PRIORITY_FLAGS_INCR_ONLY) == 0) ||
+	     (job_ptr->priority < new_prio)) &&
+	    (job_ptr->priority != new_prio)) {
 		job_ptr->priority = new_prio;
 		last_job_update = time(NULL);
 	}
@@ -517,6 +517,41 @@ extern int proctrack_p_signal (uint64_t id, int signal)
 	int i;
 	int slurm_task;
 
+	/* directly manage SIGSTOP using cgroup freezer subsystem */
+	if (signal == SIGSTOP)
+		return _slurm_cgroup_suspend(id);
+
+	if (signal == SIGKILL) {
+		/*
+		 * Freeze the whole container first: frozen processes can
+		 * not fork, so a single pass over the pid list catches
+		 * everything, and no per-pid /proc inspection is needed
+		 * since SIGKILL goes to inherited processes as well.
+		 * The queued signals are delivered on the thaw.
+		 */
+		_slurm_cgroup_suspend(id);
+		if (_slurm_cgroup_get_pids(id, &pids, &npids) !=
+		    SLURM_SUCCESS) {
+			debug3("unable to get pids list for cont_id=%"PRIu64"",
+			       id);
+			/* that could mean that all the processes already */
+			/* exited the container so return success */
+			return _slurm_cgroup_resume(id);
+		}
+		for (i = 0 ; i<npids ; i++) {
+			/* do not kill slurmstepd (it should not be part
+			 * of the list, but just to not forget about that ;))
+			 */
+			if (pids[i] == (pid_t)id)
+				continue;
+			debug2("killing process %d with signal %d",
+			       pids[i], signal);
+			kill(pids[i], signal);
+		}
+		xfree(pids);
+		return _slurm_cgroup_resume(id);
+	}
+
 	/* get all the pids associated with the step */
 	if (_slurm_cgroup_get_pids(id, &pids, &npids) !=
 	    SLURM_SUCCESS) {
@@ -526,17 +561,6 @@ extern int proctrack_p_signal (uint64_t id, int signal)
 		return SLURM_SUCCESS;
 	}
 
-	/* directly manage SIGSTOP using cgroup freezer subsystem */
-	if (signal == SIGSTOP) {
-		xfree(pids);
-		return _slurm_cgroup_suspend(id);
-	}
-
-	/* start by resuming in case of SIGKILL */
-	if (signal == SIGKILL) {
-		_slurm_cgroup_resume(id);
-	}
-
 	for (i = 0 ; i<npids ; i++) {
 		/* do not kill slurmstepd (it should not be part
 		 * of the list, but just to not forget about that ;))
@@ -544,12 +568,11 @@ extern int proctrack_p_signal (uint64_t id, int signal)
 		if (pids[i] == (pid_t)id)
 			continue;
 
-		/* only signal slurm tasks unless signal is SIGKILL */
+		/* only signal slurm tasks */
 		slurm_task = _slurm_cgroup_is_pid_a_slurm_task(id, pids[i]);
-		if (slurm_task == 1 || signal == SIGKILL) {
-			debug2("killing process %d (%s) with signal %d", pids[i],
-			       (slurm_task==1)?"slurm_task":"inherited_task",
-			       signal);
+		if (slurm_task == 1) {
+			debug2("killing process %d (slurm_task) with signal %d",
+			       pids[i], signal);
 			kill(pids[i], signal);
 		}
 	}
@@ -95,6 +95,15 @@ const uint32_t plugin_version   = SLURM_VERSION_NUMBER;
 static uint64_t debug_flags = 0;
 static pthread_mutex_t route_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * Compiled route table: switch indexes sorted by level, built once per
+ * topology generation under route_lock and then read without locking.
+ * A new switch_record_table pointer (reconfigure) invalidates the cache.
+ */
+static int *switch_level_order = NULL;
+static struct switch_record *cached_switch_table = NULL;
+static int cached_switch_cnt = 0;
+
 /*****************************************************************************\
  *  Functions required of all plugins
 \*****************************************************************************/
@@ -120,9 +129,51 @@ extern int init(void)
  */
 extern int fini(void)
 {
+	xfree(switch_level_order);
+	cached_switch_table = NULL;
+	cached_switch_cnt = 0;
 	return SLURM_SUCCESS;
 }
 
+/* Order switch indexes by level, then by table position */
+static int _sort_switches_by_level(const void *x, const void *y)
+{
+	int i = *(int *) x;
+	int j = *(int *) y;
+
+	if (switch_record_table[i].level != switch_record_table[j].level)
+		return switch_record_table[i].level -
+		       switch_record_table[j].level;
+	return i - j;
+}
+
+/*
+ * Rebuild the compiled route table if the topology changed.
+ * Calls after the first return without taking any lock.
+ */
+static void _build_route_cache(void)
+{
+	int i;
+
+	if ((cached_switch_table == switch_record_table) &&
+	    (cached_switch_cnt == switch_record_cnt))
+		return;
+
+	slurm_mutex_lock(&route_lock);
+	if ((cached_switch_table != switch_record_table) ||
+	    (cached_switch_cnt != switch_record_cnt)) {
+		xfree(switch_level_order);
+		switch_level_order = xcalloc(switch_record_cnt, sizeof(int));
+		for (i = 0; i < switch_record_cnt; i++)
+			switch_level_order[i] = i;
+		qsort(switch_level_order, switch_record_cnt, sizeof(int),
+		      _sort_switches_by_level);
+		cached_switch_cnt = switch_record_cnt;
+		cached_switch_table = switch_record_table;
+	}
+	slurm_mutex_unlock(&route_lock);
+}
+
 /* Only run when in the slurmctld */
 static bool _run_in_slurmctld(void)
 {
@@ -165,25 +216,28 @@ extern int route_p_split_hostlist(hostlist_t hl,
 	slurmctld_lock_t node_read_lock = { .node = READ_LOCK };
 
 	msg_count = hostlist_count(hl);
-	slurm_mutex_lock(&route_lock);
 	if (switch_record_cnt == 0) {
-		if (_run_in_slurmctld())
-			fatal_abort("%s: Somehow we have 0 for switch_record_cnt and we are here in the slurmctld.  This should never happen.", __func__);
-		/* configs have not already been processed */
-		slurm_conf_init(NULL);
-		if (init_node_conf()) {
-			fatal("ROUTE: Failed to init slurm config");
-		}
-		if (build_all_nodeline_info(false, 0)) {
-			fatal("ROUTE: Failed to build node config");
-		}
-		rehash_node();
+		slurm_mutex_lock(&route_lock);
+		if (switch_record_cnt == 0) {
+			if (_run_in_slurmctld())
+				fatal_abort("%s: Somehow we have 0 for switch_record_cnt and we are here in the slurmctld.  This should never happen.", __func__);
+			/* configs have not already been processed */
+			slurm_conf_init(NULL);
+			if (init_node_conf()) {
+				fatal("ROUTE: Failed to init slurm config");
+			}
+			if (build_all_nodeline_info(false, 0)) {
+				fatal("ROUTE: Failed to build node config");
+			}
+			rehash_node();
 
-		if (slurm_topo_build_config() != SLURM_SUCCESS) {
-			fatal("ROUTE: Failed to build topology config");
+			if (slurm_topo_build_config() != SLURM_SUCCESS) {
+				fatal("ROUTE: Failed to build topology config");
+			}
 		}
+		slurm_mutex_unlock(&route_lock);
 	}
-	slurm_mutex_unlock(&route_lock);
+	_build_route_cache();
 	*sp_hl = (hostlist_t*) xmalloc(switch_record_cnt * sizeof(hostlist_t));
 	/* Only acquire the slurmctld lock if running as the slurmctld. */
 	if (_run_in_slurmctld())
@@ -198,24 +252,15 @@ extern int route_p_split_hostlist(hostlist_t hl,
 
 	/* Find lowest level switch containing all the nodes in the list */
 	j = 0;
-	for (i = 0; i <= switch_levels; i++) {
-		for (j=0; j<switch_record_cnt; j++) {
-			if (switch_record_table[j].level == i) {
-				if (bit_super_set(nodes_bitmap,
-						  switch_record_table[j].
-						  node_bitmap)) {
-					/* All nodes in message list are in
-					 * this switch */
-					break;
-				}
-			}
+	for (i = 0; i < switch_record_cnt; i++) {
+		j = switch_level_order[i];
+		if (bit_super_set(nodes_bitmap,
+				  switch_record_table[j].node_bitmap)) {
+			/* All nodes in message list are in this switch */
+			break;
 		}
-		if (j < switch_record_cnt) {
-			/* Got here via break after bit_super_set */
-			break; // 'j' is our switch
-		} /* else, no switches at this level reach all nodes */
 	}
-	if (i > switch_levels) {
+	if (i >= switch_record_cnt) {
 		/* This can only happen if trying to schedule multiple physical
 		 * clusters as a single logical cluster under the control of a
 		 * single slurmctld daemon, and sending something like a
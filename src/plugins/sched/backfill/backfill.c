@@ -79,6 +79,7 @@
 #include "src/common/slurm_accounting_storage.h"
 #include "src/common/slurm_mcs.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/timers.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 
@@ -127,7 +128,7 @@
 typedef struct node_space_map {
 	time_t begin_time;
 	time_t end_time;
-	bitstr_t *avail_bitmap;
+	bit_cow_t *avail_cow;	/* copy-on-write available node bitmap */
 	int next;	/* next record, by time, zero termination */
 } node_space_map_t;
 
@@ -150,6 +151,21 @@ typedef struct pack_job_map {
 	List pack_job_list;		/* List of pack_job_rec_t */
 } pack_job_map_t;
 
+/*
+ * Memo of job/partition pairs found unschedulable within the backfill
+ * window. Entries are only valid while no job, node or partition state
+ * has changed since the table was (re)built, so a lookup hit means the
+ * prior test result still holds and the job can be skipped. This lets
+ * cycles which would otherwise retest an unchanged queue head reach
+ * jobs deeper in the queue before bf_max_time expires.
+ */
+#define BF_MEMO_HASH_SIZE 4096
+typedef struct bf_memo {
+	uint32_t job_id;
+	struct part_record *part_ptr;
+	struct bf_memo *next;
+} bf_memo_t;
+
 typedef struct deadlock_job_struct {
 	uint32_t pack_job_id;
 	time_t start_time;
@@ -202,6 +218,15 @@ static int yield_interval = YIELD_INTERVAL;
 static int yield_sleep   = YIELD_SLEEP;
 static List pack_job_list = NULL;
 static xhash_t *user_usage_map = NULL; /* look up user usage when no assoc */
+static int *node_space_order = NULL;	/* node_space records indexed in
+					 * time order, for binary search */
+static int node_space_order_cnt = 0;
+static int node_space_order_size = 0;
+static bf_memo_t **bf_memo_hash = NULL;
+static time_t bf_memo_fill_time = 0;	/* when bf_memo_hash was rebuilt */
+static time_t bf_memo_job_gen = 0;	/* last_job_update at rebuild */
+static time_t bf_memo_node_gen = 0;	/* last_node_update at rebuild */
+static time_t bf_memo_part_gen = 0;	/* last_part_update at rebuild */
 
 /*********************** local functions *********************/
 static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
@@ -210,10 +235,20 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 			     int *node_space_recs);
 static void _adjust_hetjob_prio(uint32_t *prio, uint32_t val);
 static int  _attempt_backfill(void);
+static void _bf_memo_add(struct job_record *job_ptr,
+			 struct part_record *part_ptr);
+static void _bf_memo_clear(void);
+static void _bf_memo_cycle_start(void);
+static bool _bf_memo_test(struct job_record *job_ptr,
+			  struct part_record *part_ptr);
+static bool _bf_memo_valid(void);
+static void _build_node_space_index(node_space_map_t *node_space);
+static int  _node_space_first(node_space_map_t *node_space, time_t start);
 static int  _clear_job_start_times(void *x, void *arg);
 static int  _clear_qos_blocked_times(void *x, void *arg);
 static void _do_diag_stats(struct timeval *tv1, struct timeval *tv2,
-			   int node_space_recs);
+			   int node_space_recs, uint32_t try_usec,
+			   uint32_t yield_cnt);
 static uint32_t _get_job_max_tl(struct job_record *job_ptr, time_t now,
 				node_space_map_t *node_space);
 static bool _hetjob_any_resv(struct job_record *het_leader);
@@ -295,7 +330,8 @@ static void _dump_node_space_table(node_space_map_t *node_space_ptr)
 				    begin_buf, sizeof(begin_buf));
 		slurm_make_time_str(&node_space_ptr[i].end_time,
 				    end_buf, sizeof(end_buf));
-		node_list = bitmap2node_name(node_space_ptr[i].avail_bitmap);
+		node_list = bitmap2node_name(
+			bit_cow_read(node_space_ptr[i].avail_cow));
 		info("Begin:%s End:%s Nodes:%s",
 		     begin_buf, end_buf, node_list);
 		xfree(node_list);
@@ -449,8 +485,10 @@ static int  _try_sched(struct job_record *job_ptr, bitstr_t **avail_bitmap,
 					*avail_bitmap = NULL;
 				}
 			}
-			FREE_NULL_BITMAP(*avail_bitmap);
-			*avail_bitmap = bit_copy(tmp_bitmap);
+			if (*avail_bitmap)
+				bit_copybits(*avail_bitmap, tmp_bitmap);
+			else
+				*avail_bitmap = bit_copy(tmp_bitmap);
 			list_destroy(detail_ptr->feature_list);
 		}
 		list_iterator_destroy(feat_iter);
@@ -517,8 +555,10 @@ static int  _try_sched(struct job_record *job_ptr, bitstr_t **avail_bitmap,
 					*avail_bitmap = NULL;
 				}
 			}
-			FREE_NULL_BITMAP(*avail_bitmap);
-			*avail_bitmap = bit_copy(tmp_bitmap);
+			if (*avail_bitmap)
+				bit_copybits(*avail_bitmap, tmp_bitmap);
+			else
+				*avail_bitmap = bit_copy(tmp_bitmap);
 			list_destroy(detail_ptr->feature_list);
 		}
 		list_iterator_destroy(feat_iter);
@@ -917,11 +957,15 @@ extern void backfill_reconfig(void)
  * IN tv1 - start time
  * IN tv2 - end (current) time
  * IN node_space_recs - count of records in resouces/time table being tested
+ * IN try_usec - time spent testing job resource availability this cycle
+ * IN yield_cnt - count of lock yields taken this cycle
  */
 static void _do_diag_stats(struct timeval *tv1, struct timeval *tv2,
-			   int node_space_recs)
+			   int node_space_recs, uint32_t try_usec,
+			   uint32_t yield_cnt)
 {
 	uint32_t delta_t, real_time;
+	bf_cycle_rec_t *rec;
 
 	delta_t  = (tv2->tv_sec - tv1->tv_sec) * 1000000;
 	delta_t +=  tv2->tv_usec;
@@ -942,6 +986,20 @@ static void _do_diag_stats(struct timeval *tv1, struct timeval *tv2,
 	}
 	slurmctld_diag_stats.bf_table_size = node_space_recs;
 	slurmctld_diag_stats.bf_table_size_sum += node_space_recs;
+
+	/* Record this cycle in the introspection ring for sdiag */
+	rec = &slurmctld_diag_stats.bf_cycle_recs[
+		slurmctld_diag_stats.bf_cycle_rec_inx];
+	rec->when	= tv1->tv_sec;
+	rec->cycle_usec	= real_time;
+	rec->try_usec	= try_usec;
+	rec->depth	= slurmctld_diag_stats.bf_last_depth;
+	rec->depth_try	= slurmctld_diag_stats.bf_last_depth_try;
+	rec->yields	= yield_cnt;
+	rec->table_size	= node_space_recs;
+	rec->queue_len	= slurmctld_diag_stats.bf_queue_len;
+	slurmctld_diag_stats.bf_cycle_rec_inx =
+		(slurmctld_diag_stats.bf_cycle_rec_inx + 1) % BF_CYCLE_RECORDS;
 }
 
 static int _list_find_all(void *x, void *key)
@@ -949,6 +1007,154 @@ static int _list_find_all(void *x, void *key)
 	return 1;
 }
 
+/* Release all unschedulable job memo records */
+static void _bf_memo_clear(void)
+{
+	bf_memo_t *memo_ptr, *next_ptr;
+
+	if (!bf_memo_hash)
+		return;
+	for (int i = 0; i < BF_MEMO_HASH_SIZE; i++) {
+		memo_ptr = bf_memo_hash[i];
+		while (memo_ptr) {
+			next_ptr = memo_ptr->next;
+			xfree(memo_ptr);
+			memo_ptr = next_ptr;
+		}
+		bf_memo_hash[i] = NULL;
+	}
+}
+
+/*
+ * Return true if the memo table still reflects current system state.
+ * The table must have been built strictly later than the last job, node
+ * and partition updates; with one second time resolution an update in
+ * the same second as the rebuild could otherwise be missed.
+ */
+static bool _bf_memo_valid(void)
+{
+	if (!bf_memo_hash)
+		return false;
+	return (last_job_update  == bf_memo_job_gen)  &&
+	       (last_node_update == bf_memo_node_gen) &&
+	       (last_part_update == bf_memo_part_gen) &&
+	       (bf_memo_fill_time > bf_memo_job_gen)  &&
+	       (bf_memo_fill_time > bf_memo_node_gen) &&
+	       (bf_memo_fill_time > bf_memo_part_gen);
+}
+
+/* Flush the memo table if any relevant state changed since it was built */
+static void _bf_memo_cycle_start(void)
+{
+	if (_bf_memo_valid())
+		return;
+	if (!bf_memo_hash) {
+		bf_memo_hash = xmalloc(sizeof(bf_memo_t *) *
+				       BF_MEMO_HASH_SIZE);
+	} else {
+		_bf_memo_clear();
+	}
+	bf_memo_job_gen  = last_job_update;
+	bf_memo_node_gen = last_node_update;
+	bf_memo_part_gen = last_part_update;
+	bf_memo_fill_time = time(NULL);
+}
+
+/* Record that a job can not be scheduled or reserved in this partition */
+static void _bf_memo_add(struct job_record *job_ptr,
+			 struct part_record *part_ptr)
+{
+	bf_memo_t *memo_ptr;
+	int inx;
+
+	if (job_ptr->pack_job_id)	/* pack job tests interact */
+		return;
+	if (!_bf_memo_valid())
+		return;
+	inx = job_ptr->job_id % BF_MEMO_HASH_SIZE;
+	memo_ptr = xmalloc(sizeof(bf_memo_t));
+	memo_ptr->job_id = job_ptr->job_id;
+	memo_ptr->part_ptr = part_ptr;
+	memo_ptr->next = bf_memo_hash[inx];
+	bf_memo_hash[inx] = memo_ptr;
+}
+
+/* Return true if a still valid memo records this job/partition pair as
+ * unschedulable, in which case re-testing it now would be futile */
+static bool _bf_memo_test(struct job_record *job_ptr,
+			  struct part_record *part_ptr)
+{
+	bf_memo_t *memo_ptr;
+
+	if (!_bf_memo_valid())
+		return false;
+	memo_ptr = bf_memo_hash[job_ptr->job_id % BF_MEMO_HASH_SIZE];
+	while (memo_ptr) {
+		if ((memo_ptr->job_id == job_ptr->job_id) &&
+		    (memo_ptr->part_ptr == part_ptr))
+			return true;
+		memo_ptr = memo_ptr->next;
+	}
+	return false;
+}
+
+/*
+ * Per-job evaluation cost model. Each main loop pass through
+ * _attempt_backfill() is timed and smoothed into a direct mapped table
+ * keyed by job_id (collisions simply overwrite, this is a heuristic).
+ * When the smoothed cost of a job exceeds what remains of the cycle's
+ * bf_max_time budget, testing it would overrun the budget mid-test
+ * (the budget check at TRY_LATER can not interrupt _try_sched) and
+ * starve every job queued behind it, so the job is deferred until a
+ * cycle with sufficient budget remaining.
+ */
+typedef struct bf_cost {
+	uint32_t job_id;
+	uint32_t usec;		/* smoothed evaluation cost */
+} bf_cost_t;
+
+#define BF_COST_TAB_SIZE 1024
+static bf_cost_t *bf_cost_tab = NULL;
+
+static void _bf_cost_record(uint32_t job_id, uint32_t usec)
+{
+	bf_cost_t *cost_ptr;
+
+	if (!bf_cost_tab)
+		bf_cost_tab = xmalloc(BF_COST_TAB_SIZE * sizeof(bf_cost_t));
+	cost_ptr = bf_cost_tab + (job_id % BF_COST_TAB_SIZE);
+	if (cost_ptr->job_id == job_id) {
+		cost_ptr->usec = (uint32_t)
+			(((uint64_t) cost_ptr->usec * 3 + usec) / 4);
+	} else {
+		cost_ptr->job_id = job_id;
+		cost_ptr->usec = usec;
+	}
+}
+
+static uint32_t _bf_cost_lookup(uint32_t job_id)
+{
+	bf_cost_t *cost_ptr;
+
+	if (!bf_cost_tab)
+		return 0;
+	cost_ptr = bf_cost_tab + (job_id % BF_COST_TAB_SIZE);
+	if (cost_ptr->job_id == job_id)
+		return cost_ptr->usec;
+	return 0;
+}
+
+/* Charge the elapsed time since *cost_tv to the job last marked as under
+ * evaluation, if any. Called at each job evaluation boundary and before
+ * yielding locks so sleep time is not charged to any job. */
+static void _bf_cost_flush(uint32_t *cost_job_id, struct timeval *cost_tv)
+{
+	if (*cost_job_id == 0)
+		return;
+	_bf_cost_record(*cost_job_id, (uint32_t) slurm_delta_tv(cost_tv));
+	*cost_job_id = 0;
+}
+
 /* backfill_agent - detached thread periodically attempts to backfill jobs */
 extern void *backfill_agent(void *args)
 {
@@ -1021,6 +1227,11 @@ extern void *backfill_agent(void *args)
 	}
 	FREE_NULL_LIST(pack_job_list);
 	xhash_free(user_usage_map); /* May have been init'ed if used */
+	_bf_memo_clear();
+	xfree(bf_memo_hash);
+	xfree(bf_cost_tab);
+	xfree(node_space_order);
+	node_space_order_cnt = node_space_order_size = 0;
 
 	return NULL;
 }
@@ -1486,7 +1697,8 @@ static bool _job_exceeds_max_bf_param(struct job_record *job_ptr,
 static int _attempt_backfill(void)
 {
 	DEF_TIMERS;
-	List job_queue;
+	xvector_t *job_queue;
+	xarena_t *job_queue_arena = NULL;
 	job_queue_rec_t *job_queue_rec;
 	int bb, i, j, node_space_recs, mcs_select = 0;
 	slurmdb_qos_rec_t *qos_ptr = NULL;
@@ -1501,9 +1713,13 @@ static int _attempt_backfill(void)
 	time_t now, sched_start, later_start, start_res, resv_end, window_end;
 	time_t pack_time, orig_sched_start, orig_start_time = (time_t) 0;
 	node_space_map_t *node_space;
-	struct timeval bf_time1, bf_time2;
+	struct timeval bf_time1, bf_time2, try_time1, try_time2;
+	uint32_t bf_try_usec = 0, bf_yield_cnt = 0;
 	int rc = 0, error_code;
 	int job_test_count = 0, test_time_count = 0, pend_time;
+	int bf_memo_skip_cnt = 0, bf_cost_skip_cnt = 0;
+	uint32_t cost_job_id = 0, job_cost;
+	struct timeval cost_tv = {0, 0};
 	bool already_counted, many_rpcs = false;
 	uint32_t reject_array_job_id = 0;
 	struct part_record *reject_array_part = NULL;
@@ -1545,14 +1761,15 @@ static int _attempt_backfill(void)
 	sched_start = orig_sched_start = now = time(NULL);
 	gettimeofday(&start_tv, NULL);
 
-	job_queue = build_job_queue(true, true);
-	job_test_count = list_count(job_queue);
+	job_queue = build_job_queue(true, true, &job_queue_arena);
+	job_test_count = xvector_count(job_queue);
 	if (job_test_count == 0) {
 		if (debug_flags & DEBUG_FLAG_BACKFILL)
 			info("backfill: no jobs to backfill");
 		else
 			debug("backfill: no jobs to backfill");
-		FREE_NULL_LIST(job_queue);
+		FREE_NULL_XVECTOR(job_queue);
+		xarena_destroy(job_queue_arena);
 		return 0;
 	} else {
 		debug("backfill: %u jobs to backfill", job_test_count);
@@ -1566,6 +1783,7 @@ static int _attempt_backfill(void)
 		list_for_each(job_list, _set_hetjob_details, NULL);
 
 	gettimeofday(&bf_time1, NULL);
+	PHASE_TRACE_BEGIN(PHASE_TRACE_BF_CYCLE);
 
 	slurmctld_diag_stats.bf_queue_len = job_test_count;
 	slurmctld_diag_stats.bf_queue_len_sum += slurmctld_diag_stats.
@@ -1580,12 +1798,13 @@ static int _attempt_backfill(void)
 	window_end = sched_start + backfill_window;
 	node_space[0].end_time = window_end;
 
-	node_space[0].avail_bitmap = bit_copy(avail_node_bitmap);
+	node_space[0].avail_cow = bit_cow_create(bit_copy(avail_node_bitmap));
 	/* Make "resuming" nodes available to be scheduled in backfill */
-	bit_or(node_space[0].avail_bitmap, rs_node_bitmap);
+	bit_or(bit_cow_modify(node_space[0].avail_cow), rs_node_bitmap);
 
 	node_space[0].next = 0;
 	node_space_recs = 1;
+	_build_node_space_index(node_space);
 	if (debug_flags & DEBUG_FLAG_BACKFILL_MAP)
 		_dump_node_space_table(node_space);
 
@@ -1598,6 +1817,9 @@ static int _attempt_backfill(void)
 
 	sort_job_queue(job_queue);
 
+	/* Flush the unschedulable job memo if system state has changed */
+	_bf_memo_cycle_start();
+
 	/* Ignore nodes that have been set as available during this cycle. */
 	bit_clear_all(bf_ignore_node_bitmap);
 
@@ -1606,7 +1828,7 @@ static int _attempt_backfill(void)
 			prio_reserve;
 		bool get_boot_time = false;
 
-		job_queue_rec = (job_queue_rec_t *) list_pop(job_queue);
+		job_queue_rec = (job_queue_rec_t *) xvector_pop(job_queue);
 		if (!job_queue_rec) {
 			if (debug_flags & DEBUG_FLAG_BACKFILL)
 				info("backfill: reached end of job queue");
@@ -1617,7 +1839,6 @@ static int _attempt_backfill(void)
 		part_ptr         = job_queue_rec->part_ptr;
 		bf_job_priority  = job_queue_rec->priority;
 		bf_array_task_id = job_queue_rec->array_task_id;
-		xfree(job_queue_rec);
 
 		if (slurmctld_config.shutdown_time ||
 		    (difftime(time(NULL),orig_sched_start) >= bf_max_time)){
@@ -1639,6 +1860,8 @@ static int _attempt_backfill(void)
 				     slurmctld_diag_stats.bf_last_depth,
 				     job_test_count, TIME_STR);
 			}
+			_bf_cost_flush(&cost_job_id, &cost_tv);
+			bf_yield_cnt++;
 			if ((_yield_locks(yield_sleep) && !backfill_continue) ||
 			    (slurmctld_conf.last_update != config_update) ||
 			    (last_part_update != part_update)) {
@@ -1671,6 +1894,30 @@ static int _attempt_backfill(void)
 				continue;
 		}
 
+		if (_bf_memo_test(job_ptr, part_ptr)) {
+			/* Previously proven unschedulable in this partition
+			 * and nothing relevant has changed since */
+			bf_memo_skip_cnt++;
+			continue;
+		}
+
+		_bf_cost_flush(&cost_job_id, &cost_tv);
+		job_cost = _bf_cost_lookup(job_ptr->job_id);
+		if (job_cost &&
+		    ((int64_t) job_cost >
+		     ((int64_t) (bf_max_time -
+				 difftime(time(NULL), orig_sched_start))) *
+		     1000000)) {
+			if (debug_flags & DEBUG_FLAG_BACKFILL) {
+				info("backfill: deferring %pJ, expected test cost %u usec exceeds remaining budget",
+				     job_ptr, job_cost);
+			}
+			bf_cost_skip_cnt++;
+			continue;
+		}
+		cost_job_id = job_ptr->job_id;
+		gettimeofday(&cost_tv, NULL);
+
 		/* Restore preemption state if needed. */
 		_restore_preempt_state(job_ptr, &tmp_preempt_start_time,
 				       &tmp_preempt_in_progress);
@@ -2001,6 +2248,8 @@ next_task:
 				     slurmctld_diag_stats.bf_last_depth,
 				     job_test_count, test_time_count, TIME_STR);
 			}
+			_bf_cost_flush(&cost_job_id, &cost_tv);
+			bf_yield_cnt++;
 			if ((_yield_locks(yield_sleep) && !backfill_continue) ||
 			    (slurmctld_conf.last_update != config_update) ||
 			    (last_part_update != part_update)) {
@@ -2071,15 +2320,12 @@ next_task:
 		bit_and_not(avail_bitmap, bf_ignore_node_bitmap);
 		filter_by_node_owner(job_ptr, avail_bitmap);
 		filter_by_node_mcs(job_ptr, mcs_select, avail_bitmap);
-		for (j = 0; ; ) {
-			if ((node_space[j].end_time > start_res) &&
-			     node_space[j].next && (later_start == 0))
+		for (j = _node_space_first(node_space, start_res); j >= 0; ) {
+			if (node_space[j].next && (later_start == 0))
 				later_start = node_space[j].end_time;
-			if (node_space[j].end_time <= start_res)
-				;
-			else if (node_space[j].begin_time <= end_time) {
+			if (node_space[j].begin_time <= end_time) {
 				bit_and(avail_bitmap,
-					node_space[j].avail_bitmap);
+					bit_cow_read(node_space[j].avail_cow));
 			} else
 				break;
 			if ((j = node_space[j].next) == 0)
@@ -2117,12 +2363,19 @@ next_task:
 			 * start in different partition it will be 0
 			 */
 			job_ptr->start_time = orig_start_time;
+			if (!job_no_reserve)
+				_bf_memo_add(job_ptr, part_ptr);
 			continue;
 		}
 
 		/* Identify nodes which are definitely off limits */
-		FREE_NULL_BITMAP(resv_bitmap);
-		resv_bitmap = bit_copy(avail_bitmap);
+		if (resv_bitmap &&
+		    (bit_size(resv_bitmap) == bit_size(avail_bitmap))) {
+			bit_copybits(resv_bitmap, avail_bitmap);
+		} else {
+			FREE_NULL_BITMAP(resv_bitmap);
+			resv_bitmap = bit_copy(avail_bitmap);
+		}
 		bit_not(resv_bitmap);
 
 		/* this is the time consuming operation */
@@ -2142,8 +2395,15 @@ next_task:
 		job_ptr->bit_flags |= job_no_reserve;	/* 0 or TEST_NOW_ONLY */
 
 		if (active_bitmap) {
+			PHASE_TRACE_BEGIN(PHASE_TRACE_BF_TRY_SCHED);
+			gettimeofday(&try_time1, NULL);
 			j = _try_sched(job_ptr, &active_bitmap, min_nodes,
 				       max_nodes, req_nodes, exc_core_bitmap);
+			gettimeofday(&try_time2, NULL);
+			PHASE_TRACE_END(PHASE_TRACE_BF_TRY_SCHED);
+			bf_try_usec += (try_time2.tv_sec - try_time1.tv_sec) *
+				       1000000;
+			bf_try_usec += try_time2.tv_usec - try_time1.tv_usec;
 			if (j == SLURM_SUCCESS) {
 				FREE_NULL_BITMAP(avail_bitmap);
 				avail_bitmap = active_bitmap;
@@ -2191,14 +2451,15 @@ next_task:
 			orig_end_time = end_time;
 			end_time += boot_time;
 
-			for (j = 0; ; ) {
-				if (node_space[j].end_time <= start_res)
-					;
-				else if (node_space[j].begin_time <= end_time) {
+			for (j = _node_space_first(node_space, start_res);
+			     j >= 0; ) {
+				if (node_space[j].begin_time <= end_time) {
 					if (node_space[j].begin_time >
 					    orig_end_time)
 						bit_and(avail_bitmap,
-						node_space[j].avail_bitmap);
+							bit_cow_read(
+							node_space[j].
+							avail_cow));
 				} else
 					break;
 				if ((j = node_space[j].next) == 0)
@@ -2208,8 +2469,15 @@ next_task:
 		if (test_fini != 1) {
 			/* Either active_bitmap was NULL or not usable by the
 			 * job. Test using avail_bitmap instead */
+			PHASE_TRACE_BEGIN(PHASE_TRACE_BF_TRY_SCHED);
+			gettimeofday(&try_time1, NULL);
 			j = _try_sched(job_ptr, &avail_bitmap, min_nodes,
 				       max_nodes, req_nodes, exc_core_bitmap);
+			gettimeofday(&try_time2, NULL);
+			PHASE_TRACE_END(PHASE_TRACE_BF_TRY_SCHED);
+			bf_try_usec += (try_time2.tv_sec - try_time1.tv_sec) *
+				       1000000;
+			bf_try_usec += try_time2.tv_usec - try_time1.tv_usec;
 			if (test_fini == 0) {
 				job_ptr->details->share_res = save_share_res;
 				job_ptr->details->whole_node = save_whole_node;
@@ -2226,6 +2494,8 @@ next_task:
 				goto TRY_LATER;
 			}
 			job_ptr->start_time = orig_start_time;
+			if (!job_no_reserve)
+				_bf_memo_add(job_ptr, part_ptr);
 			continue;	/* not runable in this partition */
 		}
 
@@ -2492,6 +2762,8 @@ skip_start:
 				job_ptr->start_time = orig_start_time;
 			}
 			_set_job_time_limit(job_ptr, orig_time_limit);
+			if (!job_no_reserve)
+				_bf_memo_add(job_ptr, part_ptr);
 			continue;
 		}
 
@@ -2665,24 +2937,28 @@ skip_start:
 		_pack_start_test(node_space, 0);
 
 	FREE_NULL_BITMAP(avail_bitmap);
+	_bf_cost_flush(&cost_job_id, &cost_tv);
 	FREE_NULL_BITMAP(exc_core_bitmap);
 	FREE_NULL_BITMAP(resv_bitmap);
 
 	for (i = 0; ; ) {
-		FREE_NULL_BITMAP(node_space[i].avail_bitmap);
+		FREE_NULL_BIT_COW(node_space[i].avail_cow);
 		if ((i = node_space[i].next) == 0)
 			break;
 	}
 	xfree(node_space);
-	FREE_NULL_LIST(job_queue);
+	FREE_NULL_XVECTOR(job_queue);
+	xarena_destroy(job_queue_arena);
 
 	gettimeofday(&bf_time2, NULL);
-	_do_diag_stats(&bf_time1, &bf_time2, node_space_recs);
+	_do_diag_stats(&bf_time1, &bf_time2, node_space_recs, bf_try_usec,
+		       bf_yield_cnt);
 	if (debug_flags & DEBUG_FLAG_BACKFILL) {
 		END_TIMER;
-		info("backfill: completed testing %u(%d) jobs, %s",
+		info("backfill: completed testing %u(%d) jobs, skipped %d still unschedulable jobs, deferred %d over budget jobs, %s",
 		     slurmctld_diag_stats.bf_last_depth,
-		     job_test_count, TIME_STR);
+		     job_test_count, bf_memo_skip_cnt, bf_cost_skip_cnt,
+		     TIME_STR);
 	}
 
 	slurm_mutex_lock(&slurmctld_config.thread_count_lock);
@@ -2692,6 +2968,7 @@ skip_start:
 		     slurmctld_config.server_thread_count);
 	}
 	slurm_mutex_unlock(&slurmctld_config.thread_count_lock);
+	PHASE_TRACE_END(PHASE_TRACE_BF_CYCLE);
 
 	return rc;
 }
@@ -2787,7 +3064,7 @@ static uint32_t _get_job_max_tl(struct job_record *job_ptr, time_t now,
 		if ((node_space[j].begin_time != now) && // No current conflicts
 		    (node_space[j].begin_time < job_ptr->end_time) &&
 		    (!bit_super_set(job_ptr->node_bitmap,
-				    node_space[j].avail_bitmap))) {
+				    bit_cow_read(node_space[j].avail_cow)))) {
 			/* Job overlaps pending job's resource reservation */
 			if ((comp_time == 0) ||
 			    (comp_time > node_space[j].begin_time))
@@ -2820,7 +3097,7 @@ static void _reset_job_time_limit(struct job_record *job_ptr, time_t now,
 		if ((node_space[j].begin_time != now) && // No current conflicts
 		    (node_space[j].begin_time < job_ptr->end_time) &&
 		    (!bit_super_set(job_ptr->node_bitmap,
-				    node_space[j].avail_bitmap))) {
+				    bit_cow_read(node_space[j].avail_cow)))) {
 			/* Job overlaps pending job's resource reservation */
 			resv_delay = difftime(node_space[j].begin_time, now);
 			resv_delay /= 60;	/* seconds to minutes */
@@ -2859,6 +3136,53 @@ static bool _more_work (time_t last_backfill_time)
 	return rc;
 }
 
+/*
+ * Rebuild the time ordered index of node_space records. The records form
+ * a linked list sorted by begin_time; capturing that order in an array
+ * lets the per-job scans locate their first relevant record with a
+ * binary search rather than walking the list from its head, which made
+ * large reservation maps quadratic over a backfill cycle.
+ */
+static void _build_node_space_index(node_space_map_t *node_space)
+{
+	int cnt = 0, j = 0;
+
+	while (1) {
+		if (cnt >= node_space_order_size) {
+			node_space_order_size =
+				MAX(64, node_space_order_size * 2);
+			xrealloc(node_space_order,
+				 sizeof(int) * node_space_order_size);
+		}
+		node_space_order[cnt++] = j;
+		if ((j = node_space[j].next) == 0)
+			break;
+	}
+	node_space_order_cnt = cnt;
+}
+
+/*
+ * Return the index of the first node_space record (in time order) with
+ * end_time greater than start, or -1 if there is none. The caller can
+ * then follow the "next" links as before; all skipped records end at or
+ * before the given time.
+ */
+static int _node_space_first(node_space_map_t *node_space, time_t start)
+{
+	int low = 0, high = node_space_order_cnt - 1, mid, first = -1;
+
+	while (low <= high) {
+		mid = (low + high) / 2;
+		if (node_space[node_space_order[mid]].end_time > start) {
+			first = node_space_order[mid];
+			high = mid - 1;
+		} else {
+			low = mid + 1;
+		}
+	}
+	return first;
+}
+
 /* Create a reservation for a job in the future */
 static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 			     bitstr_t *res_bitmap,
@@ -2880,15 +3204,20 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 #endif
 
 	start_time = MAX(start_time, node_space[0].begin_time);
-	for (j = 0; ; ) {
+	/* Locate the record containing start_time: the first one with
+	 * end_time >= start_time, given the records are contiguous */
+	j = _node_space_first(node_space, ((time_t) start_time) - 1);
+	if (j < 0)	/* start_time beyond the backfill window */
+		return;
+	for ( ; ; ) {
 		if (node_space[j].end_time > start_time) {
 			/* insert start entry record */
 			i = *node_space_recs;
 			node_space[i].begin_time = start_time;
 			node_space[i].end_time = node_space[j].end_time;
 			node_space[j].end_time = start_time;
-			node_space[i].avail_bitmap =
-				bit_copy(node_space[j].avail_bitmap);
+			node_space[i].avail_cow =
+				bit_cow_copy(node_space[j].avail_cow);
 			node_space[i].next = node_space[j].next;
 			node_space[j].next = i;
 			(*node_space_recs)++;
@@ -2907,9 +3236,9 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 					node_space[i].end_time = node_space[j].
 								 end_time;
 					node_space[j].end_time = end_reserve;
-					node_space[i].avail_bitmap =
-						bit_copy(node_space[j].
-							 avail_bitmap);
+					node_space[i].avail_cow =
+						bit_cow_copy(node_space[j].
+							     avail_cow);
 					node_space[i].next = node_space[j].next;
 					node_space[j].next = i;
 					(*node_space_recs)++;
@@ -2925,10 +3254,15 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 			break;
 	}
 
-	for (j = 0; ; ) {
+	/* Pick up any records inserted above before searching again */
+	_build_node_space_index(node_space);
+
+	j = _node_space_first(node_space, start_time);
+	for ( ; j >= 0; ) {
 		if ((node_space[j].begin_time >= start_time) &&
 		    (node_space[j].end_time <= end_reserve))
-			bit_and(node_space[j].avail_bitmap, res_bitmap);
+			bit_and(bit_cow_modify(node_space[j].avail_cow),
+				res_bitmap);
 		if ((node_space[j].begin_time >= end_reserve) ||
 		    ((j = node_space[j].next) == 0))
 			break;
@@ -2939,14 +3273,17 @@ static void _add_reservation(uint32_t start_time, uint32_t end_reserve,
 	for (i = 0; ; ) {
 		if ((j = node_space[i].next) == 0)
 			break;
-		if (!bit_equal(node_space[i].avail_bitmap,
-			       node_space[j].avail_bitmap)) {
+		if ((bit_cow_read(node_space[i].avail_cow) !=
+		     bit_cow_read(node_space[j].avail_cow)) &&
+		    !bit_equal(bit_cow_read(node_space[i].avail_cow),
+			       bit_cow_read(node_space[j].avail_cow))) {
 			i = j;
 			continue;
 		}
 		node_space[i].end_time = node_space[j].end_time;
 		node_space[i].next = node_space[j].next;
-		FREE_NULL_BITMAP(node_space[j].avail_bitmap);
+		FREE_NULL_BIT_COW(node_space[j].avail_cow);
+		_build_node_space_index(node_space);
 		break;
 	}
 }
@@ -2966,10 +3303,11 @@ static bool _test_resv_overlap(node_space_map_t *node_space,
 	bool overlap = false;
 	int j;
 
-	for (j=0; ; ) {
-		if ((node_space[j].end_time   > start_time) &&
-		    (node_space[j].begin_time < end_reserve) &&
-		    (!bit_super_set(use_bitmap, node_space[j].avail_bitmap))) {
+	for (j = _node_space_first(node_space, start_time); j >= 0; ) {
+		if (node_space[j].begin_time >= end_reserve)
+			break;	/* all later records begin even later */
+		if (!bit_super_set(use_bitmap,
+				   bit_cow_read(node_space[j].avail_cow))) {
 			overlap = true;
 			break;
 		}
@@ -139,7 +139,8 @@ static void _load_config(void)
 static void _compute_start_times(void)
 {
 	int j, rc = SLURM_SUCCESS, job_cnt = 0;
-	List job_queue;
+	xvector_t *job_queue;
+	xarena_t *job_queue_arena = NULL;
 	job_queue_rec_t *job_queue_rec;
 	List preemptee_candidates = NULL;
 	struct job_record *job_ptr;
@@ -153,12 +154,11 @@ static void _compute_start_times(void)
 	sched_start = now;
 	last_job_alloc = now - 1;
 	alloc_bitmap = bit_alloc(node_record_count);
-	job_queue = build_job_queue(true, false);
+	job_queue = build_job_queue(true, false, &job_queue_arena);
 	sort_job_queue(job_queue);
-	while ((job_queue_rec = (job_queue_rec_t *) list_pop(job_queue))) {
+	while ((job_queue_rec = (job_queue_rec_t *) xvector_pop(job_queue))) {
 		job_ptr  = job_queue_rec->job_ptr;
 		part_ptr = job_queue_rec->part_ptr;
-		xfree(job_queue_rec);
 		if (part_ptr != job_ptr->part_ptr)
 			continue;	/* Only test one partition */
 
@@ -232,7 +232,8 @@ static void _compute_start_times(void)
 			break;
 		}
 	}
-	FREE_NULL_LIST(job_queue);
+	FREE_NULL_XVECTOR(job_queue);
+	xarena_destroy(job_queue_arena);
 	FREE_NULL_BITMAP(alloc_bitmap);
 }
 
@@ -2125,7 +2125,10 @@ static int _eval_nodes_topo(struct job_record *job_ptr, bitstr_t *bitmap,
 		switches_bitmap[i] = bit_copy(switch_record_table[i].
 					      node_bitmap);
 		bit_and(switches_bitmap[i], bitmap);
-		bit_or(avail_nodes_bitmap, switches_bitmap[i]);
+		if (switch_record_table[i].level == 0) {
+			/* Leaf switches cover every node in the tree */
+			bit_or(avail_nodes_bitmap, switches_bitmap[i]);
+		}
 		switches_node_cnt[i] = bit_set_count(switches_bitmap[i]);
 		if (req_nodes_bitmap &&
 		    bit_overlap(req_nodes_bitmap, switches_bitmap[i])) {
@@ -2585,7 +2588,10 @@ static int _eval_nodes_dfly(struct job_record *job_ptr, bitstr_t *bitmap,
 		switches_bitmap[i] = bit_copy(switch_record_table[i].
 					      node_bitmap);
 		bit_and(switches_bitmap[i], bitmap);
-		bit_or(avail_nodes_bitmap, switches_bitmap[i]);
+		if (switch_record_table[i].level == 0) {
+			/* Leaf switches cover every node in the tree */
+			bit_or(avail_nodes_bitmap, switches_bitmap[i]);
+		}
 		switches_node_cnt[i] = bit_set_count(switches_bitmap[i]);
 	}
 	bit_nclear(bitmap, 0, cr_node_cnt - 1);
@@ -51,11 +51,15 @@ extern slurmctld_config_t slurmctld_config __attribute__((weak_import));
 extern bitstr_t *idle_node_bitmap __attribute__((weak_import));
 extern struct node_record *node_record_table_ptr __attribute__((weak_import));
 extern List job_list __attribute__((weak_import));
+extern time_t last_job_update __attribute__((weak_import));
+extern time_t last_node_update __attribute__((weak_import));
 #else
 slurmctld_config_t slurmctld_config;
 bitstr_t *idle_node_bitmap;
 struct node_record *node_record_table_ptr;
 List job_list;
+time_t last_job_update;
+time_t last_node_update;
 #endif
 
 typedef enum {
@@ -204,6 +208,14 @@ static int _verify_node_state(struct part_res_record *cr_part_ptr,
 			      struct node_use_record *node_usage,
 			      enum node_cr_state job_node_req,
 			      bitstr_t **exc_cores, bool qos_preemptor);
+static int _verify_node_state_test(struct part_res_record *cr_part_ptr,
+				   struct job_record *job_ptr,
+				   bitstr_t *node_bitmap,
+				   uint16_t cr_type,
+				   struct node_use_record *node_usage,
+				   enum node_cr_state job_node_req,
+				   bitstr_t **exc_cores, bool qos_preemptor,
+				   uint64_t min_mem);
 
 /* Find node_weight_type element from list with same weight as node config */
 static int _node_weight_find(void *x, void *key)
@@ -477,6 +489,88 @@ extern bool job_cleaning(struct job_record *job_ptr)
 	return false;
 }
 
+/*
+ * Cycle-scoped cache of the cores allocated to running jobs: the union
+ * of every partition row bitmap, per node. Each job test previously
+ * rebuilt this union by scanning all partition rows; within a
+ * scheduling cycle the allocations change only when a placement commits
+ * or a job releases resources, so the union is maintained here and the
+ * affected nodes are rebuilt lazily. The cache describes only the live
+ * select_part_record state, never the copies used by will-run and
+ * preemption tests; alloc_core_cache_job_change() must be called for
+ * every job added to or removed from the live partition rows.
+ */
+static bitstr_t **alloc_core_cache = NULL;	/* allocated cores per node */
+static bitstr_t *alloc_core_dirty = NULL;	/* nodes needing a rebuild */
+static bool alloc_core_cache_valid = false;
+
+/* Rebuild cached allocated-core bitmap of node [n] from partition rows */
+static void _alloc_core_cache_build_node(int n)
+{
+	struct part_res_record *p_ptr;
+	int r;
+
+	FREE_NULL_BITMAP(alloc_core_cache[n]);
+	for (p_ptr = select_part_record; p_ptr; p_ptr = p_ptr->next) {
+		if (!p_ptr->row)
+			continue;
+		for (r = 0; r < p_ptr->num_rows; r++) {
+			if (!p_ptr->row[r].row_bitmap ||
+			    !p_ptr->row[r].row_bitmap[n])
+				continue;
+			if (alloc_core_cache[n]) {
+				bit_or(alloc_core_cache[n],
+				       p_ptr->row[r].row_bitmap[n]);
+			} else {
+				alloc_core_cache[n] = bit_copy(
+					p_ptr->row[r].row_bitmap[n]);
+			}
+		}
+	}
+}
+
+/*
+ * Note that [job] was added to or removed from the live partition row
+ * bitmaps; its nodes are rebuilt on the next job test
+ */
+extern void alloc_core_cache_job_change(struct job_resources *job)
+{
+	if (!alloc_core_cache_valid || !job || !job->node_bitmap)
+		return;
+	bit_or(alloc_core_dirty, job->node_bitmap);
+}
+
+/* Release the allocated-core cache (node or partition table rebuild) */
+extern void alloc_core_cache_destroy(void)
+{
+	free_core_array(&alloc_core_cache);
+	FREE_NULL_BITMAP(alloc_core_dirty);
+	alloc_core_cache_valid = false;
+}
+
+/* Return the up to date allocated-core union, refreshing dirty nodes */
+static bitstr_t **_alloc_core_cache_get(void)
+{
+	int n;
+
+	if (!alloc_core_cache_valid) {
+		alloc_core_cache_destroy();
+		alloc_core_cache = build_core_array();
+		alloc_core_dirty = bit_alloc(select_node_cnt);
+		for (n = 0; n < select_node_cnt; n++)
+			_alloc_core_cache_build_node(n);
+		alloc_core_cache_valid = true;
+	} else if (bit_ffs(alloc_core_dirty) >= 0) {
+		for (n = 0; n < select_node_cnt; n++) {
+			if (bit_test(alloc_core_dirty, n))
+				_alloc_core_cache_build_node(n);
+		}
+		bit_clear_all(alloc_core_dirty);
+	}
+
+	return alloc_core_cache;
+}
+
 /*
  * Deallocate resources previously allocated to the given job
  * - subtract 'struct job_resources' resources from 'struct part_res_record'
@@ -588,6 +682,9 @@ extern int rm_job_res(struct part_res_record *part_record_ptr,
 			return SLURM_ERROR;
 		}
 
+		if (part_record_ptr == select_part_record)
+			alloc_core_cache_job_change(job);
+
 		for (p_ptr = part_record_ptr; p_ptr; p_ptr = p_ptr->next) {
 			if (p_ptr->part_ptr == job_ptr->part_ptr)
 				break;
@@ -1460,21 +1557,49 @@ static int _job_test(struct job_record *job_ptr, bitstr_t *node_bitmap,
 	}
 
 	/* remove all existing allocations from free_cores */
-	for (p_ptr = cr_part_ptr; p_ptr; p_ptr = p_ptr->next) {
-		if (!p_ptr->row)
-			continue;
-		for (i = 0; i < p_ptr->num_rows; i++) {
-			if (!p_ptr->row[i].row_bitmap)
+	if (cr_part_ptr == select_part_record) {
+		/*
+		 * Testing against the live allocations: subtract the
+		 * incrementally maintained union of all partition rows
+		 * and scan only the job's own partition for its core map
+		 */
+		core_array_and_not(free_cores, _alloc_core_cache_get());
+		for (p_ptr = cr_part_ptr; p_ptr; p_ptr = p_ptr->next) {
+			if (!p_ptr->row ||
+			    (p_ptr->part_ptr != job_ptr->part_ptr))
 				continue;
-			core_array_and_not(free_cores,p_ptr->row[i].row_bitmap);
-			if (p_ptr->part_ptr != job_ptr->part_ptr)
+			for (i = 0; i < p_ptr->num_rows; i++) {
+				if (!p_ptr->row[i].row_bitmap)
+					continue;
+				if (part_core_map) {
+					core_array_or(part_core_map,
+						      p_ptr->row[i].
+						      row_bitmap);
+				} else {
+					part_core_map = copy_core_array(
+						p_ptr->row[i].row_bitmap);
+				}
+			}
+		}
+	} else {
+		for (p_ptr = cr_part_ptr; p_ptr; p_ptr = p_ptr->next) {
+			if (!p_ptr->row)
 				continue;
-			if (part_core_map) {
-				core_array_or(part_core_map,
-					      p_ptr->row[i].row_bitmap);
-			} else {
-				part_core_map =
-				      copy_core_array(p_ptr->row[i].row_bitmap);
+			for (i = 0; i < p_ptr->num_rows; i++) {
+				if (!p_ptr->row[i].row_bitmap)
+					continue;
+				core_array_and_not(free_cores,
+						   p_ptr->row[i].row_bitmap);
+				if (p_ptr->part_ptr != job_ptr->part_ptr)
+					continue;
+				if (part_core_map) {
+					core_array_or(part_core_map,
+						      p_ptr->row[i].
+						      row_bitmap);
+				} else {
+					part_core_map = copy_core_array(
+						p_ptr->row[i].row_bitmap);
+				}
 			}
 		}
 	}
@@ -3600,9 +3725,8 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 		nw = list_peek(node_weight_list);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
-		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
 		if (req_nodes_bitmap &&
-		    bit_overlap(req_nodes_bitmap, switch_node_bitmap[i])) {
+		    bit_overlap(req_nodes_bitmap, switch_ptr->node_bitmap)) {
 			switch_required[i] = 1;
 			if (switch_record_table[i].level == 0) {
 				leaf_switch_count++;
@@ -3615,7 +3739,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 			}
 		}
 		if (!req_nodes_bitmap &&
-		    bit_overlap(nw->node_bitmap, switch_node_bitmap[i])) {
+		    bit_overlap(nw->node_bitmap, switch_ptr->node_bitmap)) {
 			if ((top_switch_inx == -1) ||
 			    (switch_record_table[i].level >
 			     switch_record_table[top_switch_inx].level)) {
@@ -3639,24 +3763,13 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	/* Check that all specificly required nodes are on shared network */
 	if (req_nodes_bitmap &&
 	    !bit_super_set(req_nodes_bitmap,
-			   switch_node_bitmap[top_switch_inx])) {
+			   switch_record_table[top_switch_inx].node_bitmap)) {
 		rc = SLURM_ERROR;
 		info("%s: %s: %pJ requires nodes that do not have shared network",
 		     plugin_type, __func__, job_ptr);
 		goto fini;
 	}
 
-	/*
-	 * Remove nodes from consideration that can not be reached from this
-	 * top level switch
-	 */
-	for (i = 0; i < switch_record_cnt; i++) {
-		if (top_switch_inx != i) {
-			  bit_and(switch_node_bitmap[i],
-				  switch_node_bitmap[top_switch_inx]);
-		}
-	}
-
 	/*
 	 * Identify the best set of nodes (i.e. nodes with the lowest weight,
 	 * in addition to the required nodes) that can be used to satisfy the
@@ -3687,7 +3800,8 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 			if (avail_cpu_per_node[i])
 				continue;	/* Required node */
 			if (!bit_test(nw->node_bitmap, i) ||
-			    !bit_test(switch_node_bitmap[top_switch_inx], i))
+			    !bit_test(switch_record_table[top_switch_inx].
+				      node_bitmap, i))
 				continue;
 			_select_cores(job_ptr, mc_ptr, enforce_binding, i,
 				      &avail_cpus, max_nodes, min_rem_nodes,
@@ -3776,7 +3890,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 			if (switch_required[i])
 				continue;
 			if (bit_overlap(req2_nodes_bitmap,
-					switch_node_bitmap[i])) {
+					switch_ptr->node_bitmap)) {
 				switch_required[i] = 1;
 				if (switch_record_table[i].level == 0) {
 					leaf_switch_count++;
@@ -3820,6 +3934,12 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	avail_nodes_bitmap = bit_alloc(node_record_count);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
+		/*
+		 * Build the per-switch bitmaps here, where the first and only
+		 * intersection is needed. All of the best nodes sit under the
+		 * top level switch identified above.
+		 */
+		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
 		bit_and(switch_node_bitmap[i], best_nodes_bitmap);
 		bit_or(avail_nodes_bitmap, switch_node_bitmap[i]);
 		switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
@@ -4232,9 +4352,8 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 		nw = list_peek(node_weight_list);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
-		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
 		if (req_nodes_bitmap &&
-		    bit_overlap(req_nodes_bitmap, switch_node_bitmap[i])) {
+		    bit_overlap(req_nodes_bitmap, switch_ptr->node_bitmap)) {
 			switch_required[i] = 1;
 			if (switch_record_table[i].level == 0) {
 				leaf_switch_count++;
@@ -4247,7 +4366,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 			}
 		}
 		if (!req_nodes_bitmap &&
-		    bit_overlap(nw->node_bitmap, switch_node_bitmap[i])) {
+		    bit_overlap(nw->node_bitmap, switch_ptr->node_bitmap)) {
 			if ((top_switch_inx == -1) ||
 			    (switch_record_table[i].level >
 			     switch_record_table[top_switch_inx].level)) {
@@ -4271,24 +4390,13 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	/* Check that all specificly required nodes are on shared network */
 	if (req_nodes_bitmap &&
 	    !bit_super_set(req_nodes_bitmap,
-			   switch_node_bitmap[top_switch_inx])) {
+			   switch_record_table[top_switch_inx].node_bitmap)) {
 		rc = SLURM_ERROR;
 		info("%s: %s: %pJ requires nodes that do not have shared network",
 		     plugin_type, __func__, job_ptr);
 		goto fini;
 	}
 
-	/*
-	 * Remove nodes from consideration that can not be reached from this
-	 * top level switch.
-	 */
-	for (i = 0; i < switch_record_cnt; i++) {
-		if (top_switch_inx != i) {
-			  bit_and(switch_node_bitmap[i],
-				  switch_node_bitmap[top_switch_inx]);
-		}
-	}
-
 	/*
 	 * Identify the best set of nodes (i.e. nodes with the lowest weight,
 	 * in addition to the required nodes) that can be used to satisfy the
@@ -4319,7 +4427,8 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 			if (avail_cpu_per_node[i])
 				continue;	/* Required node */
 			if (!bit_test(nw->node_bitmap, i) ||
-			    !bit_test(switch_node_bitmap[top_switch_inx], i))
+			    !bit_test(switch_record_table[top_switch_inx].
+				      node_bitmap, i))
 				continue;
 			_select_cores(job_ptr, mc_ptr, enforce_binding, i,
 				      &avail_cpus, max_nodes, min_rem_nodes,
@@ -4408,7 +4517,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 			if (switch_required[i])
 				continue;
 			if (bit_overlap(req2_nodes_bitmap,
-					switch_node_bitmap[i])) {
+					switch_ptr->node_bitmap)) {
 				switch_required[i] = 1;
 				if (switch_record_table[i].level == 0) {
 					leaf_switch_count++;
@@ -4453,6 +4562,12 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	avail_nodes_bitmap = bit_alloc(node_record_count);
 	for (i = 0, switch_ptr = switch_record_table; i < switch_record_cnt;
 	     i++, switch_ptr++) {
+		/*
+		 * Build the per-switch bitmaps here, where the first and only
+		 * intersection is needed. All of the best nodes sit under the
+		 * top level switch identified above.
+		 */
+		switch_node_bitmap[i] = bit_copy(switch_ptr->node_bitmap);
 		bit_and(switch_node_bitmap[i], best_nodes_bitmap);
 		bit_or(avail_nodes_bitmap, switch_node_bitmap[i]);
 		switch_node_cnt[i] = bit_set_count(switch_node_bitmap[i]);
@@ -6230,6 +6345,71 @@ static int _is_node_busy(struct part_res_record *p_ptr, uint32_t node_i,
  *  - job_node_req = NODE_CR_RESERVED, then we need idle nodes
  *  - job_node_req = NODE_CR_ONE_ROW, then we need idle or non-sharing nodes
  */
+/*
+ * Cache of recent _verify_node_state_test() results. Large job arrays
+ * submit thousands of identical tasks and each scheduling cycle repeats
+ * the same per-node memory/GRES/sharing scan for every one of them.
+ * Entries are only served while last_job_update and last_node_update
+ * still match the values seen when the entry was filled, and only for
+ * the live select_node_usage/select_part_record state (never for the
+ * copies used by will-run and preemption tests). With the one second
+ * resolution of those generation stamps, an entry filled in the same
+ * second as the last update cannot be trusted.
+ */
+#define VNS_CACHE_SIZE 4
+typedef struct vns_cache {
+	bitstr_t *in_bitmap;		/* candidate nodes at entry */
+	bitstr_t *out_bitmap;		/* resulting usable nodes */
+	int rc;				/* return code */
+	uint64_t min_mem;
+	uint16_t cr_type;
+	uint32_t job_node_req;
+	bool qos_preemptor;
+	bool mem_set;			/* JOB_MEM_SET flag state */
+	struct part_record *part_ptr;
+	bitstr_t *req_node_bitmap;	/* required node bitmap pointer */
+	char *tres_sig;			/* job TRES/GRES request strings */
+	time_t job_gen;			/* last_job_update at fill time */
+	time_t node_gen;		/* last_node_update at fill time */
+	time_t fill_time;
+	time_t last_used;
+} vns_cache_t;
+static vns_cache_t vns_cache[VNS_CACHE_SIZE];
+
+/* Build the signature of all job request strings feeding the per-node
+ * GRES test; identical job array tasks share identical strings */
+static char *_vns_tres_sig(struct job_record *job_ptr)
+{
+	char *sig = NULL;
+
+	xstrfmtcat(sig, "%s|%s|%s|%s|%s|%s|%s",
+		   job_ptr->cpus_per_tres ? job_ptr->cpus_per_tres : "",
+		   job_ptr->mem_per_tres ? job_ptr->mem_per_tres : "",
+		   job_ptr->tres_per_job ? job_ptr->tres_per_job : "",
+		   job_ptr->tres_per_node ? job_ptr->tres_per_node : "",
+		   job_ptr->tres_per_socket ? job_ptr->tres_per_socket : "",
+		   job_ptr->tres_per_task ? job_ptr->tres_per_task : "",
+		   job_ptr->tres_bind ? job_ptr->tres_bind : "");
+	return sig;
+}
+
+static bool _vns_cache_entry_valid(vns_cache_t *entry)
+{
+	return entry->in_bitmap &&
+	       (entry->job_gen  == last_job_update)  &&
+	       (entry->node_gen == last_node_update) &&
+	       (entry->fill_time > last_job_update)  &&
+	       (entry->fill_time > last_node_update);
+}
+
+static void _vns_cache_entry_clear(vns_cache_t *entry)
+{
+	FREE_NULL_BITMAP(entry->in_bitmap);
+	FREE_NULL_BITMAP(entry->out_bitmap);
+	xfree(entry->tres_sig);
+	memset(entry, 0, sizeof(vns_cache_t));
+}
+
 static int _verify_node_state(struct part_res_record *cr_part_ptr,
 			      struct job_record *job_ptr,
 			      bitstr_t *node_bitmap,
@@ -6238,13 +6418,15 @@ static int _verify_node_state(struct part_res_record *cr_part_ptr,
 			      enum node_cr_state job_node_req,
 			      bitstr_t **exc_cores, bool qos_preemptor)
 {
-	struct node_record *node_ptr;
-	uint32_t gres_cpus, gres_cores;
-	uint64_t free_mem, min_mem, avail_mem;
-	List gres_list;
-	int i, i_first, i_last;
-
-	if (!(job_ptr->bit_flags & JOB_MEM_SET) &&
+	uint64_t min_mem;
+	bool cache_usable;
+	bool mem_set = (job_ptr->bit_flags & JOB_MEM_SET);
+	char *tres_sig = NULL;
+	bitstr_t *in_bitmap = NULL;
+	vns_cache_t *entry;
+	int rc, inx;
+
+	if (!mem_set &&
 	    ((min_mem = gres_plugin_job_mem_max(job_ptr->gres_list)))) {
 		/*
 		 * Clear default partition or system per-node memory limit.
@@ -6263,6 +6445,85 @@ static int _verify_node_state(struct part_res_record *cr_part_ptr,
 		min_mem = job_ptr->details->pn_min_memory;
 	}
 
+	/* exc_cores only matters to whole node jobs */
+	cache_usable = (node_usage == select_node_usage) &&
+		       (cr_part_ptr == select_part_record) &&
+		       (!exc_cores || (job_ptr->details->whole_node != 1));
+	if (!cache_usable) {
+		return _verify_node_state_test(cr_part_ptr, job_ptr,
+					       node_bitmap, cr_type,
+					       node_usage, job_node_req,
+					       exc_cores, qos_preemptor,
+					       min_mem);
+	}
+
+	tres_sig = _vns_tres_sig(job_ptr);
+	for (inx = 0; inx < VNS_CACHE_SIZE; inx++) {
+		entry = &vns_cache[inx];
+		if (!_vns_cache_entry_valid(entry))
+			continue;
+		if ((entry->min_mem != min_mem) ||
+		    (entry->cr_type != cr_type) ||
+		    (entry->job_node_req != job_node_req) ||
+		    (entry->qos_preemptor != qos_preemptor) ||
+		    (entry->mem_set != mem_set) ||
+		    (entry->part_ptr != job_ptr->part_ptr) ||
+		    (entry->req_node_bitmap !=
+		     job_ptr->details->req_node_bitmap) ||
+		    xstrcmp(entry->tres_sig, tres_sig) ||
+		    !bit_equal(entry->in_bitmap, node_bitmap))
+			continue;
+		bit_copybits(node_bitmap, entry->out_bitmap);
+		entry->last_used = time(NULL);
+		xfree(tres_sig);
+		return entry->rc;
+	}
+
+	in_bitmap = bit_copy(node_bitmap);
+	rc = _verify_node_state_test(cr_part_ptr, job_ptr, node_bitmap,
+				     cr_type, node_usage, job_node_req,
+				     exc_cores, qos_preemptor, min_mem);
+
+	/* Fill the oldest cache slot with this result */
+	entry = &vns_cache[0];
+	for (inx = 1; inx < VNS_CACHE_SIZE; inx++) {
+		if (vns_cache[inx].last_used < entry->last_used)
+			entry = &vns_cache[inx];
+	}
+	_vns_cache_entry_clear(entry);
+	entry->in_bitmap = in_bitmap;
+	entry->out_bitmap = bit_copy(node_bitmap);
+	entry->rc = rc;
+	entry->min_mem = min_mem;
+	entry->cr_type = cr_type;
+	entry->job_node_req = job_node_req;
+	entry->qos_preemptor = qos_preemptor;
+	entry->mem_set = mem_set;
+	entry->part_ptr = job_ptr->part_ptr;
+	entry->req_node_bitmap = job_ptr->details->req_node_bitmap;
+	entry->tres_sig = tres_sig;
+	entry->job_gen = last_job_update;
+	entry->node_gen = last_node_update;
+	entry->fill_time = entry->last_used = time(NULL);
+
+	return rc;
+}
+
+static int _verify_node_state_test(struct part_res_record *cr_part_ptr,
+				   struct job_record *job_ptr,
+				   bitstr_t *node_bitmap,
+				   uint16_t cr_type,
+				   struct node_use_record *node_usage,
+				   enum node_cr_state job_node_req,
+				   bitstr_t **exc_cores, bool qos_preemptor,
+				   uint64_t min_mem)
+{
+	struct node_record *node_ptr;
+	uint32_t gres_cpus, gres_cores;
+	uint64_t free_mem, avail_mem;
+	List gres_list;
+	int i, i_first, i_last;
+
 	i_first = bit_ffs(node_bitmap);
 	if (i_first == -1)
 		i_last = -2;
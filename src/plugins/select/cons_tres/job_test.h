@@ -160,6 +160,16 @@ extern int rm_job_res(struct part_res_record *part_record_ptr,
 		      struct node_use_record *node_usage,
 		      struct job_record *job_ptr, int action, bool job_fini);
 
+/*
+ * Note that the given job was added to or removed from the live
+ * partition row bitmaps so the cached allocated-core union can be
+ * refreshed for its nodes
+ */
+extern void alloc_core_cache_job_change(struct job_resources *job);
+
+/* Release the cached allocated-core union (partition table rebuild) */
+extern void alloc_core_cache_destroy(void);
+
 /* Allocate resources for a job now, if possible */
 extern int run_now(struct job_record *job_ptr, bitstr_t *node_bitmap,
 		   uint32_t min_nodes, uint32_t max_nodes,
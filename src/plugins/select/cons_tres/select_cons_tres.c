@@ -64,7 +64,9 @@ extern struct node_record *node_record_table_ptr __attribute__((weak_import));
 extern List part_list __attribute__((weak_import));
 extern List job_list __attribute__((weak_import));
 extern int node_record_count __attribute__((weak_import));
+extern time_t last_job_update __attribute__((weak_import));
 extern time_t last_node_update __attribute__((weak_import));
+extern time_t last_part_update __attribute__((weak_import));
 extern struct switch_record *switch_record_table __attribute__((weak_import));
 extern int switch_record_cnt __attribute__((weak_import));
 extern bitstr_t *avail_node_bitmap __attribute__((weak_import));
@@ -78,7 +80,9 @@ struct node_record *node_record_table_ptr;
 List part_list;
 List job_list;
 int node_record_count;
+time_t last_job_update;
 time_t last_node_update;
+time_t last_part_update;
 struct switch_record *switch_record_table;
 int switch_record_cnt;
 bitstr_t *avail_node_bitmap;
@@ -153,6 +157,33 @@ bool       spec_cores_first	= false;
 bitstr_t **spec_core_res	= NULL;
 bool       topo_optional	= false;
 
+/*
+ * Memo of failed "run now" job tests. Job arrays and batches of jobs
+ * with identical resource requests are each run through the full
+ * select logic in one scheduling cycle even though the previous
+ * identical request just failed for lack of resources. A failed
+ * SELECT_MODE_RUN_NOW verdict is recorded under a signature of every
+ * job attribute the test reads and replayed for the next identical
+ * request, but only while last_job_update, last_node_update and
+ * last_part_update still match the values captured when the verdict
+ * was recorded (and the fill is strictly later than each, given their
+ * one second resolution). Tests involving preemption candidates or
+ * excluded reservation cores are never memoized.
+ */
+#define JOB_TEST_MEMO_SIZE 8
+typedef struct jt_memo {
+	char *sig;			/* resource signature */
+	bitstr_t *in_bitmap;		/* candidate nodes at entry */
+	bitstr_t *out_bitmap;		/* node bitmap state at failure */
+	int rc;				/* failed return code */
+	time_t job_gen;			/* last_job_update at fill time */
+	time_t node_gen;		/* last_node_update at fill time */
+	time_t part_gen;		/* last_part_update at fill time */
+	time_t fill_time;
+	time_t last_used;
+} jt_memo_t;
+static jt_memo_t jt_memo[JOB_TEST_MEMO_SIZE];
+
 /* Global functions */
 extern select_nodeinfo_t *select_p_select_nodeinfo_alloc(void);
 extern int select_p_select_nodeinfo_free(select_nodeinfo_t *nodeinfo);
@@ -305,6 +336,7 @@ static int _add_job_to_res(struct job_record *job_ptr, int action)
 			      plugin_type, __func__, job_ptr);
 			/* No row available to record this job */
 		}
+		alloc_core_cache_job_change(job);
 		/* update the node state */
 		for (i = i_first, n = -1; i <= i_last; i++) {
 			if (bit_test(job->node_bitmap, i)) {
@@ -450,6 +482,7 @@ static void _create_part_data(void)
 	struct part_res_record *this_ptr, *last_ptr = NULL;
 	int num_parts;
 
+	alloc_core_cache_destroy();
 	cr_destroy_part_data(select_part_record);
 	select_part_record = NULL;
 
@@ -946,6 +979,7 @@ extern int fini(void)
 	cr_destroy_node_data(select_node_usage, select_node_record);
 	select_node_record = NULL;
 	select_node_usage = NULL;
+	alloc_core_cache_destroy();
 	cr_destroy_part_data(select_part_record);
 	select_part_record = NULL;
 	free_core_array(&spec_core_res);
@@ -1123,6 +1157,81 @@ extern int select_p_block_init(List part_list)
 	return SLURM_SUCCESS;
 }
 
+/*
+ * Build the resource signature of a job test: every job attribute read
+ * by the selection logic. Identical job array tasks produce identical
+ * signatures.
+ */
+static char *_jt_memo_sig(struct job_record *job_ptr, uint32_t min_nodes,
+			  uint32_t max_nodes, uint32_t req_nodes,
+			  uint16_t job_node_req)
+{
+	struct job_details *d = job_ptr->details;
+	struct multi_core_data *mc = d->mc_ptr;
+	char *sig = NULL;
+
+	xstrfmtcat(sig, "%s|%u|%u|%u|%u|%"PRIu64"|%u|%u|%u|%u|%u|%u|%u|%u|%u",
+		   job_ptr->partition ? job_ptr->partition : "",
+		   min_nodes, max_nodes, req_nodes, job_node_req,
+		   d->pn_min_memory, d->pn_min_cpus, d->min_cpus, d->max_cpus,
+		   d->min_nodes, d->max_nodes, d->num_tasks,
+		   d->ntasks_per_node, d->cpus_per_task, d->core_spec);
+	xstrfmtcat(sig, "|%u|%u|%u|%u|%p",
+		   (uint32_t) d->whole_node, (uint32_t) d->contiguous,
+		   (uint32_t) d->share_res, (uint32_t) d->overcommit,
+		   d->req_node_bitmap);
+	if (mc) {
+		xstrfmtcat(sig, "|%u|%u|%u|%u|%u|%u",
+			   mc->sockets_per_node, mc->cores_per_socket,
+			   mc->threads_per_core, mc->ntasks_per_socket,
+			   mc->ntasks_per_core, mc->plane_size);
+	}
+	xstrfmtcat(sig, "|%s|%s|%s|%s|%s|%s|%s|%s",
+		   d->features ? d->features : "",
+		   job_ptr->cpus_per_tres ? job_ptr->cpus_per_tres : "",
+		   job_ptr->mem_per_tres ? job_ptr->mem_per_tres : "",
+		   job_ptr->tres_per_job ? job_ptr->tres_per_job : "",
+		   job_ptr->tres_per_node ? job_ptr->tres_per_node : "",
+		   job_ptr->tres_per_socket ? job_ptr->tres_per_socket : "",
+		   job_ptr->tres_per_task ? job_ptr->tres_per_task : "",
+		   job_ptr->tres_bind ? job_ptr->tres_bind : "");
+	return sig;
+}
+
+static bool _jt_memo_entry_valid(jt_memo_t *entry)
+{
+	return entry->sig &&
+	       (entry->job_gen  == last_job_update)  &&
+	       (entry->node_gen == last_node_update) &&
+	       (entry->part_gen == last_part_update) &&
+	       (entry->fill_time > last_job_update)  &&
+	       (entry->fill_time > last_node_update) &&
+	       (entry->fill_time > last_part_update);
+}
+
+/* Record a failed test, taking ownership of sig and in_bitmap */
+static void _jt_memo_add(char *sig, bitstr_t *in_bitmap,
+			 bitstr_t *out_bitmap, int rc)
+{
+	jt_memo_t *entry = &jt_memo[0];
+
+	for (int inx = 1; inx < JOB_TEST_MEMO_SIZE; inx++) {
+		if (jt_memo[inx].last_used < entry->last_used)
+			entry = &jt_memo[inx];
+	}
+	xfree(entry->sig);
+	FREE_NULL_BITMAP(entry->in_bitmap);
+	FREE_NULL_BITMAP(entry->out_bitmap);
+	entry->sig = sig;
+	entry->in_bitmap = in_bitmap;
+	entry->out_bitmap = out_bitmap;
+	entry->rc = rc;
+	entry->job_gen = last_job_update;
+	entry->node_gen = last_node_update;
+	entry->part_gen = last_part_update;
+	entry->fill_time = entry->last_used = time(NULL);
+}
+
 /*
  * select_p_job_test - Given a specification of scheduling requirements,
  *	identify the nodes which "best" satisfy the request.
@@ -1156,6 +1265,9 @@ extern int select_p_job_test(struct job_record *job_ptr, bitstr_t *node_bitmap,
 	uint16_t job_node_req;
 	bitstr_t **exc_cores;
 	char tmp[128];
+	char *memo_sig = NULL;
+	bitstr_t *memo_in_bitmap = NULL;
+	bool memo_usable;
 
 	xassert(node_bitmap);
 	debug2("%s: %s: evaluating %pJ", plugin_type, __func__, job_ptr);
@@ -1193,6 +1305,30 @@ extern int select_p_job_test(struct job_record *job_ptr, bitstr_t *node_bitmap,
 		job_ptr->details->mc_ptr = _create_default_mc();
 	job_node_req = _get_job_node_req(job_ptr);
 
+	memo_usable = (mode == SELECT_MODE_RUN_NOW) && !exc_core_bitmap &&
+		      (!preemptee_candidates ||
+		       (list_count(preemptee_candidates) == 0));
+	if (memo_usable) {
+		memo_sig = _jt_memo_sig(job_ptr, min_nodes, max_nodes,
+					req_nodes, job_node_req);
+		for (i = 0; i < JOB_TEST_MEMO_SIZE; i++) {
+			jt_memo_t *entry = &jt_memo[i];
+			if (!_jt_memo_entry_valid(entry) ||
+			    xstrcmp(entry->sig, memo_sig) ||
+			    !bit_equal(entry->in_bitmap, node_bitmap))
+				continue;
+			debug2("%s: %s: replaying failed test for %pJ",
+			       plugin_type, __func__, job_ptr);
+			free_job_resources(&job_ptr->job_resrcs);
+			bit_copybits(node_bitmap, entry->out_bitmap);
+			entry->last_used = time(NULL);
+			xfree(memo_sig);
+			free_core_array(&exc_cores);
+			return entry->rc;
+		}
+		memo_in_bitmap = bit_copy(node_bitmap);
+	}
+
 	if (select_debug_flags & DEBUG_FLAG_SELECT_TYPE) {
 		char *node_mode = "Unknown", *alloc_mode = "Unknown";
 		char *core_list = NULL, *node_list, *sep = "";
@@ -1250,9 +1386,21 @@ extern int select_p_job_test(struct job_record *job_ptr, bitstr_t *node_bitmap,
 		/* Should never get here */
 		error("%s: %s: Mode %d is invalid", plugin_type, __func__, mode);
 		free_core_array(&exc_cores);
+		xfree(memo_sig);
+		FREE_NULL_BITMAP(memo_in_bitmap);
 		return EINVAL;
 	}
 
+	if (memo_usable) {
+		if (rc != SLURM_SUCCESS) {
+			_jt_memo_add(memo_sig, memo_in_bitmap,
+				     bit_copy(node_bitmap), rc);
+		} else {
+			xfree(memo_sig);
+			FREE_NULL_BITMAP(memo_in_bitmap);
+		}
+	}
+
 	if ((select_debug_flags & DEBUG_FLAG_CPU_BIND) ||
 	    (select_debug_flags & DEBUG_FLAG_SELECT_TYPE)) {
 		if (job_ptr->job_resrcs) {
@@ -1435,6 +1583,14 @@ extern int select_p_job_resized(struct job_record *job_ptr,
 
 
 	/* some node of job removed from core-bitmap, so rebuild core bitmaps */
+	if (part_record_ptr == select_part_record) {
+		/*
+		 * The job's node_bitmap no longer covers the removed
+		 * node, so flush the whole allocated-core cache rather
+		 * than tracking it; resizing jobs is rare
+		 */
+		alloc_core_cache_destroy();
+	}
 	build_row_bitmaps(p_ptr, NULL);
 
 	/*
@@ -126,6 +126,105 @@ static void _lllp_free_masks(const uint32_t maxtasks, bitstr_t **masks)
 	xfree(masks);
 }
 
+/*
+ * Cache of recently generated automatic binding layouts.  Throughput
+ * workloads launch many identically shaped steps back to back, and
+ * the layout only depends on the task geometry, the binding options
+ * and the set of CPUs allocated to the step on this node, so remember
+ * the last few results and reuse them instead of redoing the
+ * distribution loops for every launch.
+ */
+#define LLLP_CACHE_SIZE 16
+
+typedef struct {
+	/* inputs */
+	uint32_t maxtasks;
+	uint16_t cpus_per_task;
+	uint16_t cpu_bind_type;
+	uint32_t task_dist;
+	uint16_t ntasks_per_core;
+	char *avail_map_str;	/* CPUs allocated to the step on this node */
+	/* results */
+	uint16_t out_bind_type;
+	uint16_t out_cpus_per_task;
+	char *out_cpu_bind;
+} lllp_cache_ent_t;
+
+static lllp_cache_ent_t lllp_cache[LLLP_CACHE_SIZE];
+static int lllp_cache_next = 0;
+static pthread_mutex_t lllp_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* build the allocated CPUs part of the cache key, NULL if unavailable */
+static char *_lllp_cache_key(launch_tasks_request_msg_t *req)
+{
+	uint16_t hw_sockets = 0, hw_cores = 0, hw_threads = 0;
+	bitstr_t *avail_map;
+	char *map_str;
+
+	avail_map = _get_avail_map(req, &hw_sockets, &hw_cores, &hw_threads);
+	if (!avail_map)
+		return NULL;
+	map_str = bit_fmt_hexmask(avail_map);
+	FREE_NULL_BITMAP(avail_map);
+	return map_str;
+}
+
+/* on a hit, install the cached binding into the request */
+static bool _lllp_cache_lookup(launch_tasks_request_msg_t *req,
+			       uint32_t node_id, char *key)
+{
+	lllp_cache_ent_t *ent;
+	int i;
+
+	slurm_mutex_lock(&lllp_cache_lock);
+	for (i = 0; i < LLLP_CACHE_SIZE; i++) {
+		ent = &lllp_cache[i];
+		if (!ent->avail_map_str ||
+		    (ent->maxtasks != req->tasks_to_launch[(int)node_id]) ||
+		    (ent->cpus_per_task != req->cpus_per_task) ||
+		    (ent->cpu_bind_type != req->cpu_bind_type) ||
+		    (ent->task_dist != req->task_dist) ||
+		    (ent->ntasks_per_core != req->ntasks_per_core) ||
+		    xstrcmp(ent->avail_map_str, key))
+			continue;
+		xfree(req->cpu_bind);
+		req->cpu_bind = xstrdup(ent->out_cpu_bind);
+		req->cpu_bind_type = ent->out_bind_type;
+		req->cpus_per_task = ent->out_cpus_per_task;
+		slurm_mutex_unlock(&lllp_cache_lock);
+		debug("lllp_distribution jobid [%u] cached binding: %s",
+		      req->job_id, req->cpu_bind);
+		return true;
+	}
+	slurm_mutex_unlock(&lllp_cache_lock);
+	return false;
+}
+
+/* remember a generated binding; takes ownership of key */
+static void _lllp_cache_insert(launch_tasks_request_msg_t *req,
+			       uint32_t node_id, char *key,
+			       uint16_t in_bind_type,
+			       uint16_t in_cpus_per_task)
+{
+	lllp_cache_ent_t *ent;
+
+	slurm_mutex_lock(&lllp_cache_lock);
+	ent = &lllp_cache[lllp_cache_next];
+	lllp_cache_next = (lllp_cache_next + 1) % LLLP_CACHE_SIZE;
+	xfree(ent->avail_map_str);
+	xfree(ent->out_cpu_bind);
+	ent->maxtasks = req->tasks_to_launch[(int)node_id];
+	ent->cpus_per_task = in_cpus_per_task;
+	ent->cpu_bind_type = in_bind_type;
+	ent->task_dist = req->task_dist;
+	ent->ntasks_per_core = req->ntasks_per_core;
+	ent->avail_map_str = key;
+	ent->out_bind_type = req->cpu_bind_type;
+	ent->out_cpus_per_task = req->cpus_per_task;
+	ent->out_cpu_bind = xstrdup(req->cpu_bind);
+	slurm_mutex_unlock(&lllp_cache_lock);
+}
+
 #ifdef HAVE_NUMA
 /* _match_mask_to_ldom
  *
@@ -368,6 +467,8 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 	int rc = SLURM_SUCCESS;
 	bitstr_t **masks = NULL;
 	char buf_type[100];
+	char *cache_key = NULL;
+	uint16_t in_bind_type = 0, in_cpus_per_task = 0;
 	int maxtasks = req->tasks_to_launch[(int)node_id];
 	int whole_nodes, whole_sockets, whole_cores, whole_threads;
 	int part_sockets, part_cores;
@@ -505,6 +606,20 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 		     req->job_id, buf_type, req->task_dist);
 	}
 
+	/*
+	 * Reuse a recently generated layout if one matches.  Plane
+	 * distributions are not cached since their geometry depends on
+	 * more than the fields in the cache key.
+	 */
+	if ((req->task_dist & SLURM_DIST_STATE_BASE) != SLURM_DIST_PLANE)
+		cache_key = _lllp_cache_key(req);
+	if (cache_key && _lllp_cache_lookup(req, node_id, cache_key)) {
+		xfree(cache_key);
+		return;
+	}
+	in_bind_type = req->cpu_bind_type;
+	in_cpus_per_task = req->cpus_per_task;
+
 	switch (req->task_dist & SLURM_DIST_STATE_BASE) {
 	case SLURM_DIST_BLOCK_BLOCK:
 	case SLURM_DIST_CYCLIC_BLOCK:
@@ -567,6 +682,12 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 	}
 	if (masks)
 		_lllp_free_masks(maxtasks, masks);
+
+	if ((rc == SLURM_SUCCESS) && cache_key && req->cpu_bind)
+		_lllp_cache_insert(req, node_id, cache_key,
+				   in_bind_type, in_cpus_per_task);
+	else
+		xfree(cache_key);
 }
 
 
@@ -90,15 +90,19 @@ static char* topo_conf = NULL;
 
 static void _destroy_switches(void *ptr);
 static void _free_switch_record_table(void);
-static int  _get_switch_inx(const char *name);
+static void _free_switch_table(struct switch_record *table, int cnt);
+static int  _get_switch_inx(struct switch_record *table, int cnt,
+			    const char *name);
 static void _log_switches(void);
-static int  _node_name2bitmap(char *node_names, bitstr_t **bitmap, 
+static int  _node_name2bitmap(char *node_names, bitstr_t **bitmap,
 			      hostlist_t *invalid_hostlist);
 static int  _parse_switches(void **dest, slurm_parser_enum_t type,
 			    const char *key, const char *value,
 			    const char *line, char **leftover);
 extern int  _read_topo_file(slurm_conf_switches_t **ptr_array[]);
-static void _find_child_switches (int sw);
+static void _find_child_switches(struct switch_record *table, int cnt,
+				 int sw);
+static bool _switch_tables_equal(struct switch_record *table, int cnt);
 static void _validate_switches(void);
 
 
@@ -220,7 +224,8 @@ extern int topo_get_node_addr(char* node_name, char** paddr, char** ppattern)
  * find_child_switches creates an array of indexes to the
  * immediate descendants of switch sw.
  */
-static void _find_child_switches (int sw)
+static void _find_child_switches(struct switch_record *table, int cnt,
+				 int sw)
 {
 	int i;
 	int cldx; /* index into array of child switches */
@@ -228,21 +233,20 @@ static void _find_child_switches (int sw)
 	hostlist_t swlist;
 	char *swname;
 
-	swlist = hostlist_create(switch_record_table[sw].switches);
-	switch_record_table[sw].num_switches = hostlist_count(swlist);
-	switch_record_table[sw].switch_index =
-			xmalloc(switch_record_table[sw].num_switches
-				* sizeof(uint16_t));
+	swlist = hostlist_create(table[sw].switches);
+	table[sw].num_switches = hostlist_count(swlist);
+	table[sw].switch_index = xmalloc(table[sw].num_switches
+					 * sizeof(uint16_t));
 
 	hi = hostlist_iterator_create(swlist);
 	cldx = 0;
 	while ((swname = hostlist_next(hi))) {
 		/* Find switch whose name is the name of this child.
 		 * and add its index to child index array */
-		for (i=0; i<switch_record_cnt; i++) {
-			if (xstrcmp(swname, switch_record_table[i].name) == 0) {
-				switch_record_table[sw].switch_index[cldx] = i;
-				switch_record_table[i].parent = sw;
+		for (i=0; i<cnt; i++) {
+			if (xstrcmp(swname, table[i].name) == 0) {
+				table[sw].switch_index[cldx] = i;
+				table[i].parent = sw;
 				cldx++;
 				break;
 			}
@@ -253,11 +257,50 @@ static void _find_child_switches (int sw)
 	hostlist_destroy(swlist);
 }
 
+/*
+ * Return true if the given table matches the one currently published in
+ * switch_record_table, so an unchanged topology.conf can be reloaded
+ * without invalidating anything built on top of the existing table.
+ */
+static bool _switch_tables_equal(struct switch_record *table, int cnt)
+{
+	int i;
+
+	if (!switch_record_table || (switch_record_cnt != cnt))
+		return false;
+	for (i = 0; i < cnt; i++) {
+		if (xstrcmp(switch_record_table[i].name, table[i].name) ||
+		    (switch_record_table[i].level != table[i].level) ||
+		    (switch_record_table[i].link_speed !=
+		     table[i].link_speed) ||
+		    (switch_record_table[i].parent != table[i].parent) ||
+		    (switch_record_table[i].num_switches !=
+		     table[i].num_switches))
+			return false;
+		if (switch_record_table[i].node_bitmap &&
+		    table[i].node_bitmap) {
+			if (!bit_equal(switch_record_table[i].node_bitmap,
+				       table[i].node_bitmap))
+				return false;
+		} else if (switch_record_table[i].node_bitmap ||
+			   table[i].node_bitmap)
+			return false;
+		if (table[i].num_switches &&
+		    memcmp(switch_record_table[i].switch_index,
+			   table[i].switch_index,
+			   table[i].num_switches * sizeof(uint16_t)))
+			return false;
+	}
+	return true;
+}
+
 static void _validate_switches(void)
 {
 	slurm_conf_switches_t *ptr, **ptr_array;
 	int depth, i, j;
 	struct switch_record *switch_ptr, *prior_ptr;
+	struct switch_record *table, *old_table;
+	int cnt, levels, old_cnt;
 	hostlist_t hl, invalid_hl = NULL;
 	char *child, *buf;
 	bool  have_root = false;
@@ -265,24 +308,27 @@ static void _validate_switches(void)
 	bitstr_t *switches_bitmap = NULL;	/* nodes on any leaf switch */
 	bitstr_t *tmp_bitmap = NULL;
 
-	_free_switch_record_table();
-
-	switch_record_cnt = _read_topo_file(&ptr_array);
-	if (switch_record_cnt == 0) {
+	/*
+	 * Build the new table aside and only swap it in at the end, so RPC
+	 * traffic never sees a partially built topology and an unchanged
+	 * topology.conf leaves the published table untouched.
+	 */
+	cnt = _read_topo_file(&ptr_array);
+	if (cnt == 0) {
 		error("No switches configured");
 		s_p_hashtbl_destroy(conf_hashtbl);
+		_free_switch_record_table();
 		return;
 	}
 
-	switch_record_table = xmalloc(sizeof(struct switch_record) *
-				      switch_record_cnt);
+	table = xmalloc(sizeof(struct switch_record) * cnt);
 	multi_homed_bitmap = bit_alloc(node_record_count);
-	switch_ptr = switch_record_table;
-	for (i=0; i<switch_record_cnt; i++, switch_ptr++) {
+	switch_ptr = table;
+	for (i=0; i<cnt; i++, switch_ptr++) {
 		ptr = ptr_array[i];
 		switch_ptr->name = xstrdup(ptr->switch_name);
 		/* See if switch name has already been defined. */
-		prior_ptr = switch_record_table;
+		prior_ptr = table;
 		for (j=0; j<i; j++, prior_ptr++) {
 			if (xstrcmp(switch_ptr->name, prior_ptr->name) == 0) {
 				fatal("Switch (%s) has already been defined",
@@ -322,8 +368,8 @@ static void _validate_switches(void)
 
 	for (depth=1; ; depth++) {
 		bool resolved = true;
-		switch_ptr = switch_record_table;
-		for (i=0; i<switch_record_cnt; i++, switch_ptr++) {
+		switch_ptr = table;
+		for (i=0; i<cnt; i++, switch_ptr++) {
 			if (switch_ptr->level != -1)
 				continue;
 			hl = hostlist_create(switch_ptr->switches);
@@ -332,13 +378,13 @@ static void _validate_switches(void)
 				      switch_ptr->switches);
 			}
 			while ((child = hostlist_pop(hl))) {
-				j = _get_switch_inx(child);
+				j = _get_switch_inx(table, cnt, child);
 				if ((j < 0) || (j == i)) {
 					fatal("Switch configuration %s has "
 					      "invalid child (%s)",
 					      switch_ptr->name, child);
 				}
-				if (switch_record_table[j].level == -1) {
+				if (table[j].level == -1) {
 					/* Children not resolved */
 					resolved = false;
 					switch_ptr->level = -1;
@@ -349,18 +395,17 @@ static void _validate_switches(void)
 				}
 				if (switch_ptr->level == -1) {
 					switch_ptr->level = 1 +
-						switch_record_table[j].level;
+						table[j].level;
 					switch_ptr->node_bitmap =
-						bit_copy(switch_record_table[j].
+						bit_copy(table[j].
 							 node_bitmap);
 				} else {
 					switch_ptr->level =
 						MAX(switch_ptr->level,
-						     (switch_record_table[j].
+						     (table[j].
 						      level + 1));
 					bit_or(switch_ptr->node_bitmap,
-					       switch_record_table[j].
-					       node_bitmap);
+					       table[j].node_bitmap);
 				}
 				free(child);
 			}
@@ -372,10 +417,10 @@ static void _validate_switches(void)
 			fatal("Switch configuration is not a tree");
 	}
 
-	switch_levels = 0;
-	switch_ptr = switch_record_table;
-	for (i=0; i<switch_record_cnt; i++, switch_ptr++) {
-		switch_levels = MAX(switch_levels, switch_ptr->level);
+	levels = 0;
+	switch_ptr = table;
+	for (i=0; i<cnt; i++, switch_ptr++) {
+		levels = MAX(levels, switch_ptr->level);
 		if (switch_ptr->node_bitmap == NULL)
 			error("switch %s has no nodes", switch_ptr->name);
 	}
@@ -413,12 +458,12 @@ static void _validate_switches(void)
 
 	/* Create array of indexes of children of each switch,
 	 * and see if any switch can reach all nodes */
-	for (i = 0; i < switch_record_cnt; i++) {
-		if (switch_record_table[i].level != 0) {
-			_find_child_switches (i);
+	for (i = 0; i < cnt; i++) {
+		if (table[i].level != 0) {
+			_find_child_switches(table, cnt, i);
 		}
 		if (node_record_count ==
-			bit_set_count(switch_record_table[i].node_bitmap)) {
+			bit_set_count(table[i].node_bitmap)) {
 			have_root = true;
 		}
 	}
@@ -428,6 +473,24 @@ static void _validate_switches(void)
 				"Do not use route/topology");
 	}
 	s_p_hashtbl_destroy(conf_hashtbl);
+
+	if (_switch_tables_equal(table, cnt)) {
+		/*
+		 * The reloaded configuration matches the published table.
+		 * Keep the existing table so anything keyed on it (e.g.
+		 * cached routing information) remains valid.
+		 */
+		debug("%s: switch table unchanged by reconfiguration",
+		      __func__);
+		_free_switch_table(table, cnt);
+	} else {
+		old_table = switch_record_table;
+		old_cnt = switch_record_cnt;
+		switch_record_table = table;
+		switch_record_cnt = cnt;
+		switch_levels = levels;
+		_free_switch_table(old_table, old_cnt);
+	}
 	_log_switches();
 }
 
@@ -449,13 +512,14 @@ static void _log_switches(void)
 }
 
 /* Return the index of a given switch name or -1 if not found */
-static int _get_switch_inx(const char *name)
+static int _get_switch_inx(struct switch_record *table, int cnt,
+			   const char *name)
 {
 	int i;
 	struct switch_record *switch_ptr;
 
-	switch_ptr = switch_record_table;
-	for (i=0; i<switch_record_cnt; i++, switch_ptr++) {
+	switch_ptr = table;
+	for (i=0; i<cnt; i++, switch_ptr++) {
 		if (xstrcmp(switch_ptr->name, name) == 0)
 			return i;
 	}
@@ -463,20 +527,29 @@ static int _get_switch_inx(const char *name)
 	return -1;
 }
 
-/* Free all memory associated with switch_record_table structure */
-static void _free_switch_record_table(void)
+/* Free all memory associated with a switch record table */
+static void _free_switch_table(struct switch_record *table, int cnt)
 {
 	int i;
 
-	if (switch_record_table) {
-		for (i=0; i<switch_record_cnt; i++) {
-			xfree(switch_record_table[i].name);
-			xfree(switch_record_table[i].nodes);
-			xfree(switch_record_table[i].switches);
-			xfree(switch_record_table[i].switch_index);
-			FREE_NULL_BITMAP(switch_record_table[i].node_bitmap);
+	if (table) {
+		for (i=0; i<cnt; i++) {
+			xfree(table[i].name);
+			xfree(table[i].nodes);
+			xfree(table[i].switches);
+			xfree(table[i].switch_index);
+			FREE_NULL_BITMAP(table[i].node_bitmap);
 		}
-		xfree(switch_record_table);
+		xfree(table);
+	}
+}
+
+/* Free all memory associated with switch_record_table structure */
+static void _free_switch_record_table(void)
+{
+	if (switch_record_table) {
+		_free_switch_table(switch_record_table, switch_record_cnt);
+		switch_record_table = NULL;
 		switch_record_cnt = 0;
 		switch_levels = 0;
 	}
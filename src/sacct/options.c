@@ -55,6 +55,11 @@
 #define OPT_LONG_UNITS     0x104
 #define OPT_LONG_FEDR      0x105
 #define OPT_LONG_WHETJOB   0x106
+#define OPT_LONG_PARALLEL  0x107
+
+/* bounds for --parallel-fetch */
+#define PARALLEL_FETCH_DEFAULT 4
+#define PARALLEL_FETCH_MAX     16
 
 #define JOB_HASH_SIZE 1000
 
@@ -482,6 +487,10 @@ sacct [<OPTION>]                                                            \n \
      -o, --format:                                                          \n\
 	           Comma separated list of fields. (use \"--helpformat\"    \n\
                    for a list of available fields).                         \n\
+     --parallel-fetch[=count]:                                              \n\
+	           Split the requested time period into count (default 4)   \n\
+                   shards fetched over concurrent connections and merge     \n\
+                   the results, speeding up reports over long periods.      \n\
      -p, --parsable: output will be '|' delimited with a '|' at the end     \n\
      -P, --parsable2: output will be '|' delimited without a '|' at the end \n\
      -q, --qos:                                                             \n\
@@ -660,6 +669,131 @@ static void _remove_duplicate_fed_jobs(List jobs)
 	xfree(hash_job);
 }
 
+typedef struct {
+	slurmdb_job_cond_t *job_cond;
+	List jobs;
+	pthread_t tid;
+} fetch_shard_t;
+
+static void *_fetch_shard(void *arg)
+{
+	fetch_shard_t *shard = (fetch_shard_t *) arg;
+	void *db_conn;
+
+	/* each shard gets its own connection so the fetches overlap */
+	if (!(db_conn = slurmdb_connection_get()))
+		return NULL;
+	shard->jobs = slurmdb_jobs_get(db_conn, shard->job_cond);
+	slurmdb_connection_close(&db_conn);
+	return NULL;
+}
+
+/* Record the job in the dedup hash.
+ * RET true if a job with the same id, submit time and cluster was
+ * already recorded (i.e. it spanned a shard boundary) */
+static bool _shard_job_seen(slurmdb_job_rec_t ***hash_job, int *hash_cnt,
+			    int *hash_sz, slurmdb_job_rec_t *job)
+{
+	int hash_inx = job->jobid % JOB_HASH_SIZE, i;
+	slurmdb_job_rec_t *dup;
+
+	for (i = 0; i < hash_cnt[hash_inx]; i++) {
+		dup = hash_job[hash_inx][i];
+		if ((dup->jobid == job->jobid) &&
+		    (dup->submit == job->submit) &&
+		    !xstrcmp(dup->cluster, job->cluster))
+			return true;
+	}
+	if (hash_cnt[hash_inx] >= hash_sz[hash_inx]) {
+		hash_sz[hash_inx] = MAX(hash_sz[hash_inx] * 2, 16);
+		xrealloc(hash_job[hash_inx],
+			 sizeof(slurmdb_job_rec_t *) * hash_sz[hash_inx]);
+	}
+	hash_job[hash_inx][hash_cnt[hash_inx]++] = job;
+	return false;
+}
+
+/*
+ * Fetch the requested jobs by splitting the time period into shards
+ * queried over concurrent connections.  A job active across a shard
+ * boundary comes back from each shard it overlaps, so the merge drops
+ * those duplicates; get_data() sorts the merged list afterwards as it
+ * does for a single fetch.
+ */
+static List _get_jobs_parallel(slurmdb_job_cond_t *job_cond)
+{
+	List cond_list, merged = NULL;
+	fetch_shard_t *shards;
+	slurmdb_job_rec_t *job, ***hash_job;
+	int *hash_cnt, *hash_sz;
+	ListIterator itr;
+	int cnt, i;
+	bool fail = false;
+
+	if (!(cond_list = slurmdb_job_cond_shard(
+		      job_cond, params.opt_parallel_fetch))) {
+		debug("requested time period can not be split, "
+		      "falling back to a single fetch");
+		return slurmdb_jobs_get(acct_db_conn, job_cond);
+	}
+
+	cnt = list_count(cond_list);
+	shards = xmalloc(sizeof(fetch_shard_t) * cnt);
+	itr = list_iterator_create(cond_list);
+	for (i = 0; i < cnt; i++) {
+		shards[i].job_cond = list_next(itr);
+		slurm_thread_create(&shards[i].tid, _fetch_shard, &shards[i]);
+	}
+	list_iterator_destroy(itr);
+
+	for (i = 0; i < cnt; i++) {
+		pthread_join(shards[i].tid, NULL);
+		if (!shards[i].jobs)
+			fail = true;
+	}
+
+	if (fail) {
+		error("parallel fetch failed, retrying with a single query");
+		for (i = 0; i < cnt; i++)
+			FREE_NULL_LIST(shards[i].jobs);
+		xfree(shards);
+		FREE_NULL_LIST(cond_list);
+		return slurmdb_jobs_get(acct_db_conn, job_cond);
+	}
+
+	hash_job = xmalloc(sizeof(slurmdb_job_rec_t **) * JOB_HASH_SIZE);
+	hash_cnt = xmalloc(sizeof(int) * JOB_HASH_SIZE);
+	hash_sz = xmalloc(sizeof(int) * JOB_HASH_SIZE);
+
+	/* the first shard's list (with its destructor) becomes the result */
+	merged = shards[0].jobs;
+	shards[0].jobs = NULL;
+	itr = list_iterator_create(merged);
+	while ((job = list_next(itr)))
+		(void) _shard_job_seen(hash_job, hash_cnt, hash_sz, job);
+	list_iterator_destroy(itr);
+
+	for (i = 1; i < cnt; i++) {
+		while ((job = list_dequeue(shards[i].jobs))) {
+			if (_shard_job_seen(hash_job, hash_cnt, hash_sz, job))
+				slurmdb_destroy_job_rec(job);
+			else
+				list_append(merged, job);
+		}
+		FREE_NULL_LIST(shards[i].jobs);
+	}
+
+	for (i = 0; i < JOB_HASH_SIZE; i++)
+		xfree(hash_job[i]);
+	xfree(hash_job);
+	xfree(hash_cnt);
+	xfree(hash_sz);
+	xfree(shards);
+	FREE_NULL_LIST(cond_list);
+
+	return merged;
+}
+
 extern int get_data(void)
 {
 	slurmdb_job_rec_t *job = NULL;
@@ -673,6 +807,8 @@ extern int get_data(void)
 	if (params.opt_completion) {
 		jobs = slurmdb_jobcomp_jobs_get(job_cond);
 		return SLURM_SUCCESS;
+	} else if (params.opt_parallel_fetch > 1) {
+		jobs = _get_jobs_parallel(job_cond);
 	} else {
 		jobs = slurmdb_jobs_get(acct_db_conn, job_cond);
 	}
@@ -796,6 +932,7 @@ extern void parse_command_line(int argc, char **argv)
                 {"noheader",       no_argument,       0,    'n'},
                 {"fields",         required_argument, 0,    'o'},
                 {"format",         required_argument, 0,    'o'},
+                {"parallel-fetch", optional_argument, 0,    OPT_LONG_PARALLEL},
                 {"parsable",       no_argument,       0,    'p'},
                 {"parsable2",      no_argument,       0,    'P'},
                 {"qos",            required_argument, 0,    'q'},
@@ -997,6 +1134,19 @@ extern void parse_command_line(int argc, char **argv)
 		case 'o':
 			xstrfmtcat(params.opt_field_list, "%s,", optarg);
 			break;
+		case OPT_LONG_PARALLEL:
+			if (optarg)
+				params.opt_parallel_fetch = atoi(optarg);
+			else
+				params.opt_parallel_fetch =
+					PARALLEL_FETCH_DEFAULT;
+			if ((params.opt_parallel_fetch < 2) ||
+			    (params.opt_parallel_fetch > PARALLEL_FETCH_MAX)) {
+				error("Invalid parallel-fetch level, "
+				      "use 2 through %d", PARALLEL_FETCH_MAX);
+				exit(1);
+			}
+			break;
 		case 'p':
 			print_fields_parsable_print =
 				PRINT_FIELDS_PARSABLE_ENDING;
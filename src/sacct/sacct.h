@@ -207,6 +207,7 @@ typedef struct {
 	int opt_help;		/* --help */
 	bool opt_local;		/* --local */
 	int opt_noheader;	/* can only be cleared */
+	int opt_parallel_fetch;	/* --parallel-fetch shard count */
 	int opt_uid;		/* running persons uid */
 	int units;		/* --units*/
 } sacct_parameters_t;
@@ -164,10 +164,34 @@ extern int sacctmgr_list_config(bool have_db_conn)
 	return SLURM_SUCCESS;
 }
 
+/* Report the pct'th percentile service time in usecs for RPC type
+ * histogram row inx (power of two microsecond buckets) */
+static uint64_t _hist_percentile(slurmdb_stats_rec_t *stats, int inx, int pct)
+{
+	uint32_t *hist = stats->rpc_type_hist +
+			 (inx * stats->rpc_type_hist_size);
+	uint64_t total = 0, seen = 0, target;
+	int b;
+
+	for (b = 0; b < stats->rpc_type_hist_size; b++)
+		total += hist[b];
+	if (total == 0)
+		return 0;
+	target = ((total * pct) + 99) / 100;
+	for (b = 0; b < (stats->rpc_type_hist_size - 1); b++) {
+		seen += hist[b];
+		if (seen >= target)
+			break;
+	}
+
+	return ((uint64_t) 1) << (b + 1);
+}
+
 extern int sacctmgr_list_stats(int argc, char **argv)
 {
 	uint32_t *rpc_type_ave_time = NULL, *rpc_user_ave_time = NULL;
 	slurmdb_stats_rec_t *buf = NULL;
+	uint16_t *orig_type_id = NULL;
 	int error_code, i, j;
 	uint16_t type_id;
 	uint32_t type_ave, type_cnt, user_ave, user_cnt, user_id;
@@ -206,6 +230,14 @@ extern int sacctmgr_list_stats(int argc, char **argv)
 	rpc_type_ave_time = xmalloc(sizeof(uint32_t) * buf->type_cnt);
 	rpc_user_ave_time = xmalloc(sizeof(uint32_t) * buf->user_cnt);
 
+	if (buf->rpc_type_hist_size) {
+		/* The sorts below reorder the rpc_type arrays but not the
+		 * histograms, so remember the original row order */
+		orig_type_id = xmalloc(sizeof(uint16_t) * buf->type_cnt);
+		memcpy(orig_type_id, buf->rpc_type_id,
+		       sizeof(uint16_t) * buf->type_cnt);
+	}
+
 	if (sort_by_ave_time) {
 		for (i = 0; i < buf->type_cnt; i++) {
 			if (buf->rpc_type_cnt[i]) {
@@ -344,10 +376,23 @@ extern int sacctmgr_list_stats(int argc, char **argv)
 		if (buf->rpc_type_cnt[i] == 0)
 			continue;
 		printf("\t%-25s(%5u) count:%-6u "
-		       "ave_time:%-6u total_time:%"PRIu64"\n",
+		       "ave_time:%-6u total_time:%"PRIu64,
 		       slurmdbd_msg_type_2_str(buf->rpc_type_id[i], 1),
 		       buf->rpc_type_id[i], buf->rpc_type_cnt[i],
 		       rpc_type_ave_time[i], buf->rpc_type_time[i]);
+		if (orig_type_id) {
+			for (j = 0; j < buf->type_cnt; j++) {
+				if (orig_type_id[j] == buf->rpc_type_id[i])
+					break;
+			}
+			if (j < buf->type_cnt)
+				printf(" p50:%-6"PRIu64" p99:%-6"PRIu64
+				       " max_time:%"PRIu64,
+				       _hist_percentile(buf, j, 50),
+				       _hist_percentile(buf, j, 99),
+				       buf->rpc_type_time_max[j]);
+		}
+		printf("\n");
 	}
 
 	printf("\nRemote Procedure Call statistics by user\n");
@@ -361,6 +406,7 @@ extern int sacctmgr_list_stats(int argc, char **argv)
 		       rpc_user_ave_time[i], buf->rpc_user_time[i]);
 	}
 
+	xfree(orig_type_id);
 	xfree(rpc_type_ave_time);
 	xfree(rpc_user_ave_time);
 	slurmdb_destroy_stats_rec(buf);
@@ -38,6 +38,7 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <ctype.h>
 #include <fcntl.h>
 #include <pwd.h>
 #include <stdio.h>
@@ -79,6 +80,7 @@ static int   _set_rlimit_env(void);
 static void  _set_spank_env(void);
 static void  _set_submit_dir_env(void);
 static int   _set_umask_env(void);
+static int   _submit_manifest(char *script_name, int argc, char **argv);
 
 int main(int argc, char **argv)
 {
@@ -128,6 +130,19 @@ int main(int argc, char **argv)
 		log_alter(logopt, 0, NULL);
 	}
 
+	if (sbopt.manifest) {
+		if (sbopt.wrap || script_name) {
+			error("--manifest is incompatible with --wrap and an explicit script");
+			exit(error_exit);
+		}
+		if (sbopt.wait || sbopt.test_only || opt.clusters) {
+			error("--manifest is incompatible with --wait, --test-only and --clusters");
+			exit(error_exit);
+		}
+		exit(_submit_manifest(script_name, argc - sbopt.script_argc,
+				      argv));
+	}
+
 	if (sbopt.wrap != NULL) {
 		script_body = _script_wrap(sbopt.wrap);
 	} else {
@@ -343,6 +358,172 @@ int main(int argc, char **argv)
 	return rc;
 }
 
+
+static void _free_manifest_name(void *x)
+{
+	xfree(x);
+}
+
+/*
+ * Submit one independent batch job per script listed in the manifest
+ * file, all in a single RPC to the controller. Each line names a job
+ * script; blank lines and "#" comment lines are ignored. Command line
+ * options apply to every job, and each script's own #SBATCH directives
+ * are processed as usual.
+ */
+static int _submit_manifest(char *script_name, int argc, char **argv)
+{
+	char line[PATH_MAX + 2], *path, *sep;
+	char *manifest = xstrdup(sbopt.manifest);
+	submit_response_msg_t *resp;
+	job_desc_msg_t *desc = NULL;
+	List job_req_list, name_list, resp_list = NULL;
+	ListIterator name_iter, resp_iter;
+	int rc = 0, retries = 0, argc_off = 0, script_size;
+	char *script_body;
+	FILE *fp;
+
+	if (!(fp = fopen(manifest, "r"))) {
+		error("Unable to open manifest file %s: %m", manifest);
+		exit(error_exit);
+	}
+
+	job_req_list = list_create(NULL);
+	name_list = list_create(_free_manifest_name);
+	while (fgets(line, sizeof(line), fp)) {
+		bool more_packs = false;
+
+		path = line;
+		while (isspace(*path))
+			path++;
+		if ((path[0] == '\0') || (path[0] == '#'))
+			continue;
+		sep = path + strlen(path) - 1;
+		while ((sep >= path) && isspace(*sep))
+			*sep-- = '\0';
+
+		script_size = 0;
+		script_body = _get_script_buffer(path, &script_size);
+		if (!script_body)
+			exit(error_exit);
+
+		init_envs(&pack_env);
+		process_options_second_pass(argc, argv, &argc_off, 0,
+					    &more_packs, xbasename(path),
+					    script_body, script_size);
+		if (more_packs) {
+			error("Heterogeneous job directives are not supported with --manifest: %s",
+			      path);
+			exit(error_exit);
+		}
+
+		if (opt.burst_buffer_file) {
+			Buf buf = create_mmap_buf(opt.burst_buffer_file);
+			if (!buf) {
+				error("Invalid --bbf specification");
+				exit(error_exit);
+			}
+			_add_bb_to_script(&script_body, get_buf_data(buf));
+			free_buf(buf);
+		}
+
+		if (spank_init_post_opt() < 0) {
+			error("Plugin stack post-option processing failed");
+			exit(error_exit);
+		}
+
+		if (opt.get_user_env_time < 0)
+			(void) _set_rlimit_env();
+
+		if (sbopt.export_file != NULL)
+			env_unset_environment();
+
+		_set_prio_process_env();
+		_set_spank_env();
+		_set_submit_dir_env();
+		_set_umask_env();
+
+		desc = xmalloc(sizeof(job_desc_msg_t));
+		slurm_init_job_desc_msg(desc);
+		if (_fill_job_desc_from_opts(desc) == -1)
+			exit(error_exit);
+		desc->script = script_body;
+		set_env_from_opts(&opt, &desc->environment, -1);
+		set_envs(&desc->environment, &pack_env, -1);
+		desc->env_size = envcount(desc->environment);
+		list_append(job_req_list, desc);
+		list_append(name_list, xstrdup(path));
+	}
+	fclose(fp);
+
+	if (list_count(job_req_list) == 0) {
+		error("No job scripts in manifest file %s", manifest);
+		exit(error_exit);
+	}
+
+	while (true) {
+		static char *msg;
+		rc = slurm_submit_batch_jobs(job_req_list, &resp_list);
+		if (rc >= 0)
+			break;
+		if (errno == ESLURM_ERROR_ON_DESC_TO_RECORD_COPY) {
+			msg = "Slurm job queue full, sleeping and retrying";
+		} else if (errno == ESLURM_NODES_BUSY) {
+			msg = "Job creation temporarily disabled, retrying";
+		} else if (errno == EAGAIN) {
+			msg = "Slurm temporarily unable to accept job, "
+			      "sleeping and retrying";
+		} else
+			msg = NULL;
+		if ((msg == NULL) || (retries >= MAX_RETRIES)) {
+			error("Batch job submission failed: %m");
+			exit(error_exit);
+		}
+
+		if (retries)
+			debug("%s", msg);
+		else
+			error("%s", msg);
+		FREE_NULL_LIST(resp_list);
+		sleep(++retries);
+	}
+
+	if (!resp_list) {
+		error("Batch job submission failed: %m");
+		exit(error_exit);
+	}
+
+	rc = 0;
+	name_iter = list_iterator_create(name_list);
+	resp_iter = list_iterator_create(resp_list);
+	while ((path = list_next(name_iter)) &&
+	       (resp = list_next(resp_iter))) {
+		print_multi_line_string(resp->job_submit_user_msg, -1,
+					LOG_LEVEL_INFO);
+		if (resp->error_code && !resp->job_id) {
+			error("%s: %s", path, slurm_strerror(resp->error_code));
+			rc = error_exit;
+			continue;
+		}
+		cli_filter_plugin_post_submit(0, resp->job_id, NO_VAL);
+		if (opt.quiet)
+			continue;
+		if (!sbopt.parsable)
+			printf("Submitted batch job %u (%s)\n",
+			       resp->job_id, path);
+		else
+			printf("%u;%s\n", resp->job_id, path);
+	}
+	list_iterator_destroy(resp_iter);
+	list_iterator_destroy(name_iter);
+
+	FREE_NULL_LIST(resp_list);
+	FREE_NULL_LIST(name_list);
+	FREE_NULL_LIST(job_req_list);
+	xfree(manifest);
+	return rc;
+}
+
 /* Insert the contents of "burst_buffer_file" into "script_body" */
 static void  _add_bb_to_script(char **script_body, char *burst_buffer_file)
 {
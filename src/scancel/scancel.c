@@ -66,6 +66,10 @@
 
 static void  _add_delay(void);
 static int   _cancel_jobs(void);
+static int   _bulk_signal_resp(job_array_resp_msg_t *resp, uint16_t sig);
+static int   _bulk_signal_by_filter(void);
+static int   _bulk_signal_job_list(void);
+static bool  _bulk_signal_usable(void);
 static void *_cancel_job_id (void *cancel_info);
 static void *_cancel_step_id (void *cancel_info);
 static int  _confirmation(job_info_t *job_ptr, uint32_t step_id);
@@ -150,6 +154,24 @@ _proc_cluster(void)
 		return rc;
 	}
 
+	/* A filter on only user, partition and/or state with no explicit
+	 * job list can be evaluated entirely by the controller in a single
+	 * REQUEST_KILL_JOBS RPC, avoiding a job info load plus one RPC per
+	 * matching job. */
+	if ((opt.job_cnt == 0)	&&
+	    (!opt.interactive)	&&
+	    (!opt.account)	&&
+	    (!opt.job_name)	&&
+	    (!opt.nodelist)	&&
+	    (!opt.qos)		&&
+	    (!opt.reservation)	&&
+	    (!opt.wckey)	&&
+	    ((opt.user_name) || (opt.partition) || (opt.state != JOB_END)) &&
+	    _bulk_signal_usable()) {
+		rc = _bulk_signal_by_filter();
+		return rc;
+	}
+
 	_load_job_records();
 	rc = _verify_job_ids();
 	if ((opt.account) ||
@@ -908,11 +930,136 @@ _confirmation(job_info_t *job_ptr, uint32_t step_id)
 
 }
 
+/* Determine if the target slurmctld understands REQUEST_KILL_JOBS.
+ * The sibling option is excluded since the bulk request does not
+ * carry a sibling cluster name. */
+static bool _bulk_signal_usable(void)
+{
+	if (opt.sibling)
+		return false;
+	if (working_cluster_rec &&
+	    (working_cluster_rec->rpc_version < SLURM_20_02_PROTOCOL_VERSION))
+		return false;
+	return true;
+}
+
+/* Report the per-job error codes from a bulk kill response.
+ * RET 1 on any reported error, otherwise 0 */
+static int _bulk_signal_resp(job_array_resp_msg_t *resp, uint16_t sig)
+{
+	int i, err, rc = 0;
+
+	for (i = 0; i < resp->job_array_count; i++) {
+		err = resp->error_code[i];
+		if (err == SLURM_SUCCESS) {
+			verbose("Signal %u to job %s sent", sig,
+				resp->job_array_id[i]);
+			continue;
+		}
+		if (((err == ESLURM_ALREADY_DONE) ||
+		     (err == ESLURM_INVALID_JOB_ID)) &&
+		    (sig == SIGKILL) && (opt.verbose <= 0))
+			continue;	/* Ignore error if job done */
+		error("Kill job error on job id %s: %s",
+		      resp->job_array_id[i], slurm_strerror(err));
+		rc = 1;
+	}
+
+	return rc;
+}
+
+/* Build the kill flags common to every job in a bulk request */
+static uint16_t _bulk_signal_flags(void)
+{
+	uint16_t flags = 0;
+
+	if (opt.batch)
+		flags |= KILL_JOB_BATCH;
+	if (opt.full)
+		flags |= KILL_FULL_JOB;
+	if (opt.hurry)
+		flags |= KILL_HURRY;
+
+	return flags;
+}
+
+/* Signal every job in opt.job_list with a single RPC */
+static int _bulk_signal_job_list(void)
+{
+	kill_jobs_msg_t kill_msg;
+	job_array_resp_msg_t *resp = NULL;
+	uint16_t sig = opt.signal;
+	int i, rc = 0;
+
+	if (sig == NO_VAL16)
+		sig = SIGKILL;
+
+	memset(&kill_msg, 0, sizeof(kill_jobs_msg_t));
+	kill_msg.signal    = sig;
+	kill_msg.flags     = _bulk_signal_flags();
+	kill_msg.job_state = NO_VAL;
+	for (i = 0; opt.job_list[i]; i++)
+		;
+	kill_msg.jobs_cnt   = i;
+	kill_msg.jobs_array = opt.job_list;
+
+	verbose("Signal %u to %u jobs in one request", sig, kill_msg.jobs_cnt);
+	if (slurm_kill_jobs(&kill_msg, &resp) != SLURM_SUCCESS) {
+		error("Kill job error: %s", slurm_strerror(slurm_get_errno()));
+		return 1;
+	}
+	if (resp) {
+		rc = _bulk_signal_resp(resp, sig);
+		slurm_free_job_array_resp(resp);
+	}
+
+	return rc;
+}
+
+/* Signal every job matching the user/partition/state filters with a
+ * single RPC, the controller selects the jobs */
+static int _bulk_signal_by_filter(void)
+{
+	kill_jobs_msg_t kill_msg;
+	job_array_resp_msg_t *resp = NULL;
+	uint16_t sig = opt.signal;
+	int rc = 0;
+
+	if (sig == NO_VAL16)
+		sig = SIGKILL;
+
+	memset(&kill_msg, 0, sizeof(kill_jobs_msg_t));
+	kill_msg.signal    = sig;
+	kill_msg.flags     = _bulk_signal_flags();
+	kill_msg.user_name = opt.user_name;
+	kill_msg.partition = opt.partition;
+	if (opt.state == JOB_END)
+		kill_msg.job_state = NO_VAL;
+	else
+		kill_msg.job_state = opt.state;
+
+	if (slurm_kill_jobs(&kill_msg, &resp) != SLURM_SUCCESS) {
+		error("Kill job error: %s", slurm_strerror(slurm_get_errno()));
+		return 1;
+	}
+	if (resp) {
+		if ((resp->job_array_count == 0) && (opt.verbose > 0))
+			error("No active jobs match ALL job filters");
+		rc = _bulk_signal_resp(resp, sig);
+		slurm_free_job_array_resp(resp);
+	}
+
+	return rc;
+}
+
 static int _signal_job_by_str(void)
 {
 	job_cancel_info_t *cancel_info;
 	int i, rc = 0;
 
+	if (_bulk_signal_usable())
+		return _bulk_signal_job_list();
+
 	slurm_mutex_init(&num_active_threads_lock);
 	slurm_cond_init(&num_active_threads_cond, NULL);
 
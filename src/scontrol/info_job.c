@@ -48,6 +48,7 @@
 #include "src/common/stepd_api.h"
 
 #define POLL_SLEEP	3	/* retry interval in seconds  */
+#define JOB_PAGE_SIZE	1000	/* detailed job records fetched per RPC */
 
 /* Load current job table information into *job_buffer_pptr */
 extern int
@@ -304,6 +305,130 @@ static bool _task_id_in_job(job_info_t *job_ptr, uint32_t array_id)
 	return false;
 }
 
+static int _cmp_job_id(const void *x, const void *y)
+{
+	uint32_t id_x = *(uint32_t *) x, id_y = *(uint32_t *) y;
+
+	if (id_x < id_y)
+		return -1;
+	if (id_x > id_y)
+		return 1;
+	return 0;
+}
+
+/* Fetch and print the detailed records for one page of job IDs */
+static int _print_job_page(uint32_t *job_ids, int job_id_cnt,
+			   uint16_t show_flags, int *print_cnt)
+{
+	job_info_msg_t *page_msg = NULL;
+	int i, rc;
+
+	if ((rc = slurm_load_job_ids((time_t) NULL, &page_msg, job_ids,
+				     job_id_cnt, show_flags))) {
+		exit_code = 1;
+		if (quiet_flag != 1)
+			slurm_perror("slurm_load_job_ids error");
+		return rc;
+	}
+	for (i = 0; i < page_msg->record_count; i++)
+		slurm_print_job_info(stdout, &page_msg->job_array[i],
+				     one_liner);
+	*print_cnt += page_msg->record_count;
+	slurm_free_job_info_msg(page_msg);
+	return SLURM_SUCCESS;
+}
+
+/*
+ * Print every job in pages of JOB_PAGE_SIZE detailed records rather than
+ * loading the whole job table at once, so output starts as soon as the
+ * first page arrives and client memory is bounded by the page size.  A
+ * first slim pass (SHOW_SLIM) collects just the job IDs; array tasks and
+ * pack job components are then fetched through their meta/leader job so
+ * each record is printed exactly once.
+ * RET SLURM_SUCCESS if the request was handled here (even if a page
+ * failed part way through, which is reported and reflected in exit_code),
+ * or SLURM_ERROR if nothing was printed and the caller should fall back
+ * on the unpaged code path
+ */
+static int _print_job_paged(void)
+{
+	job_info_msg_t *id_msg = NULL;
+	job_info_t *job_ptr;
+	uint32_t *sorted_ids = NULL, *page_ids = NULL;
+	uint16_t show_flags = 0;
+	int i, page_cnt = 0, print_cnt = 0;
+	int rc = SLURM_SUCCESS;
+
+	if (all_flag)
+		show_flags |= SHOW_ALL;
+	if (detail_flag)
+		show_flags |= SHOW_DETAIL;
+
+	if (slurm_load_jobs((time_t) NULL, &id_msg, show_flags | SHOW_SLIM))
+		return SLURM_ERROR;
+	if (id_msg->record_count <= JOB_PAGE_SIZE) {
+		/* Not worth a second pass, reload with the full fields */
+		slurm_free_job_info_msg(id_msg);
+		return SLURM_ERROR;
+	}
+
+	if (quiet_flag == -1) {
+		char time_str[32];
+		slurm_make_time_str((time_t *)&id_msg->last_update,
+				    time_str, sizeof(time_str));
+		printf("last_update_time=%s, records=%d\n",
+		       time_str, id_msg->record_count);
+	}
+
+	sorted_ids = xmalloc(sizeof(uint32_t) * id_msg->record_count);
+	for (i = 0, job_ptr = id_msg->job_array;
+	     i < id_msg->record_count; i++, job_ptr++)
+		sorted_ids[i] = job_ptr->job_id;
+	qsort(sorted_ids, id_msg->record_count, sizeof(uint32_t),
+	      _cmp_job_id);
+
+	page_ids = xmalloc(sizeof(uint32_t) * JOB_PAGE_SIZE);
+	for (i = 0, job_ptr = id_msg->job_array;
+	     i < id_msg->record_count; i++, job_ptr++) {
+		/*
+		 * Array tasks and pack job components are returned along
+		 * with their meta/leader job, so only query them directly
+		 * when that record is gone from the job table.
+		 */
+		if (job_ptr->array_job_id &&
+		    (job_ptr->job_id != job_ptr->array_job_id) &&
+		    bsearch(&job_ptr->array_job_id, sorted_ids,
+			    id_msg->record_count, sizeof(uint32_t),
+			    _cmp_job_id))
+			continue;
+		if (job_ptr->pack_job_id &&
+		    (job_ptr->job_id != job_ptr->pack_job_id) &&
+		    bsearch(&job_ptr->pack_job_id, sorted_ids,
+			    id_msg->record_count, sizeof(uint32_t),
+			    _cmp_job_id))
+			continue;
+		page_ids[page_cnt++] = job_ptr->job_id;
+		if (page_cnt < JOB_PAGE_SIZE)
+			continue;
+		rc = _print_job_page(page_ids, page_cnt, show_flags,
+				     &print_cnt);
+		page_cnt = 0;
+		if (rc != SLURM_SUCCESS)
+			break;
+	}
+	if ((rc == SLURM_SUCCESS) && page_cnt)
+		rc = _print_job_page(page_ids, page_cnt, show_flags,
+				     &print_cnt);
+	xfree(page_ids);
+	xfree(sorted_ids);
+	slurm_free_job_info_msg(id_msg);
+
+	if ((rc == SLURM_SUCCESS) && (print_cnt == 0) && (quiet_flag != 1))
+		printf("No jobs in the system\n");
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * scontrol_print_job - print the specified job's information
  * IN job_id - job's id or NULL to print information about all jobs
@@ -340,6 +465,16 @@ extern void scontrol_print_job(char * job_id_str)
 			pack_job_offset = strtol(end_ptr + 1, &end_ptr, 10);
 	}
 
+	/*
+	 * Page through a large job table rather than holding it all in
+	 * memory.  Queries against a single job, a federation, or a cached
+	 * table still use the unpaged path below.
+	 */
+	if (!job_id_str && !federation_flag && !sibling_flag &&
+	    !old_job_info_ptr &&
+	    (_print_job_paged() == SLURM_SUCCESS))
+		return;
+
 	error_code = scontrol_load_job(&job_buffer_ptr, job_id);
 	if (error_code) {
 		exit_code = 1;
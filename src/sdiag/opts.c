@@ -44,6 +44,7 @@
 #include "src/common/proc_args.h"
 
 #define OPT_LONG_USAGE 0x101
+#define OPT_LONG_PROMETHEUS 0x102
 
 static void  _help( void );
 static void  _usage( void );
@@ -52,6 +53,7 @@ extern int  sdiag_param;
 extern bool sort_by_id;
 extern bool sort_by_time;
 extern bool sort_by_time2;
+extern bool prometheus_output;
 
 /*
  * parse_command_line, fill in params data structure with data
@@ -63,6 +65,7 @@ extern void parse_command_line(int argc, char **argv)
 	static struct option long_options[] = {
 		{"all",		no_argument,	0,	'a'},
 		{"help",	no_argument,	0,	'h'},
+		{"prometheus",	no_argument,	0,	OPT_LONG_PROMETHEUS},
 		{"reset",	no_argument,	0,	'r'},
 		{"sort-by-id",	no_argument,	0,	'i'},
 		{"sort-by-time",no_argument,	0,	't'},
@@ -98,6 +101,9 @@ extern void parse_command_line(int argc, char **argv)
 				print_slurm_version();
 				exit(0);
 				break;
+			case (int)OPT_LONG_PROMETHEUS:
+				prometheus_output = true;
+				break;
 			case (int)OPT_LONG_USAGE:
 				_usage();
 				exit(0);
@@ -120,6 +126,7 @@ Usage: sdiag [OPTIONS]\n\
   -r              reset statistics\n\
 \nHelp options:\n\
   --help          show this help message\n\
+  --prometheus    write queue telemetry in Prometheus text format\n\
   --sort-by-id    sort RPCs by id\n\
   --sort-by-time  sort RPCs by total run time\n\
   --sort-by-time2 sort RPCs by average run time\n\
@@ -41,6 +41,7 @@
 
 #include <slurm.h>
 #include "src/common/macros.h"
+#include "src/common/parse_time.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_protocol_defs.h"
 #include "src/common/slurm_time.h"
@@ -55,12 +56,19 @@ int sdiag_param = STAT_COMMAND_GET;
 bool sort_by_id    = false;
 bool sort_by_time  = false;
 bool sort_by_time2 = false;
+bool prometheus_output = false;
 
 stats_info_response_msg_t *buf;
 uint32_t *rpc_type_ave_time = NULL, *rpc_user_ave_time = NULL;
 
 static int  _print_stats(void);
+static int  _print_prometheus(void);
 static void _sort_rpc(void);
+static uint64_t _hist_percentile(int inx, int pct);
+static uint64_t _lock_hist_percentile(int inx, int pct);
+static void _print_job_timing(const char *label, uint32_t *hist);
+static void _print_lock_stats(void);
+static void _swap_type_hist(int i, int j);
 
 stats_info_request_msg_t req;
 
@@ -85,8 +93,12 @@ int main(int argc, char **argv)
 		rc = slurm_get_statistics(&buf,
 					  (stats_info_request_msg_t *)&req);
 		if (rc == SLURM_SUCCESS) {
-			_sort_rpc();
-			rc = _print_stats();
+			if (prometheus_output) {
+				rc = _print_prometheus();
+			} else {
+				_sort_rpc();
+				rc = _print_stats();
+			}
 #ifdef MEMORY_LEAK_DEBUG
 			uid_cache_clear();
 			slurm_free_stats_response_msg(buf);
@@ -117,6 +129,7 @@ static int _print_stats(void)
 	printf("*******************************************************\n");
 
 	printf("Server thread count:  %d\n", buf->server_thread_count);
+	printf("RPC queue depth:      %d\n", buf->rpc_queue_depth);
 	printf("Agent queue size:     %d\n", buf->agent_queue_size);
 	printf("Agent count:          %d\n", buf->agent_count);
 	printf("DBD Agent queue size: %d\n\n", buf->dbd_agent_queue_size);
@@ -188,6 +201,59 @@ static int _print_stats(void)
 		printf("\tMean table size: %u\n",
 		       buf->bf_table_size_sum / buf->bf_cycle_counter);
 	}
+	if (buf->bf_cycle_rec_cnt > 0) {
+		printf("\tLast %u cycles (oldest first):\n",
+		       buf->bf_cycle_rec_cnt);
+		printf("\t\t%-20s %10s %10s %6s %6s %6s %6s %6s\n",
+		       "When", "Micros", "TryMicros", "Depth", "Try",
+		       "Yields", "Table", "Queue");
+		for (i = 0; i < buf->bf_cycle_rec_cnt; i++) {
+			char time_str[32];
+			slurm_make_time_str(&buf->bf_cycle_rec_when[i],
+					    time_str, sizeof(time_str));
+			printf("\t\t%-20s %10u %10u %6u %6u %6u %6u %6u\n",
+			       time_str,
+			       buf->bf_cycle_rec_usec[i],
+			       buf->bf_cycle_rec_try_usec[i],
+			       buf->bf_cycle_rec_depth[i],
+			       buf->bf_cycle_rec_depth_try[i],
+			       buf->bf_cycle_rec_yields[i],
+			       buf->bf_cycle_rec_table_size[i],
+			       buf->bf_cycle_rec_queue_len[i]);
+		}
+	}
+
+	if (buf->job_timing_hist_size) {
+		printf("\nJob lifecycle intervals (microseconds)\n");
+		printf("\t%-22s %10s %10s %10s\n",
+		       "Interval", "Jobs", "p50", "p99");
+		_print_job_timing("Submit to first eval",
+				  buf->job_timing_submit_eval_hist);
+		_print_job_timing("Alloc to batch launch",
+				  buf->job_timing_alloc_launch_hist);
+		_print_job_timing("Complete to cleanup",
+				  buf->job_timing_complete_clean_hist);
+	}
+
+	if (buf->queue_cnt) {
+		printf("\nInternal queue statistics\n");
+		printf("\t%-12s %8s %9s %12s %12s\n",
+		       "Queue", "Depth", "HeadAge", "Enqueued", "Dequeued");
+		for (i = 0; i < buf->queue_cnt; i++) {
+			printf("\t%-12s %8u %9u %12"PRIu64" %12"PRIu64"\n",
+			       buf->queue_name[i], buf->queue_depth[i],
+			       buf->queue_head_age[i], buf->queue_enqueued[i],
+			       buf->queue_dequeued[i]);
+		}
+	}
+
+	if (buf->lock_domain_cnt) {
+		uint64_t total_locks = 0;
+		for (i = 0; i < buf->lock_domain_cnt; i++)
+			total_locks += buf->lock_domain_lock_cnt[i];
+		if (total_locks)
+			_print_lock_stats();
+	}
 
 	printf("\nLatency for 1000 calls to gettimeofday(): %d microseconds\n",
 	       buf->gettimeofday_latency);
@@ -195,10 +261,16 @@ static int _print_stats(void)
 	printf("\nRemote Procedure Call statistics by message type\n");
 	for (i = 0; i < buf->rpc_type_size; i++) {
 		printf("\t%-40s(%5u) count:%-6u "
-		       "ave_time:%-6u total_time:%"PRIu64"\n",
+		       "ave_time:%-6u total_time:%"PRIu64,
 		       rpc_num2string(buf->rpc_type_id[i]),
 		       buf->rpc_type_id[i], buf->rpc_type_cnt[i],
 		       rpc_type_ave_time[i], buf->rpc_type_time[i]);
+		if (buf->rpc_type_hist_size) {
+			printf(" p50:%-8"PRIu64" p99:%"PRIu64,
+			       _hist_percentile(i, 50),
+			       _hist_percentile(i, 99));
+		}
+		printf("\n");
 	}
 
 	printf("\nRemote Procedure Call statistics by user\n");
@@ -234,6 +306,192 @@ static int _print_stats(void)
 	return 0;
 }
 
+/*
+ * Estimate a latency percentile in microseconds for one RPC type from
+ * its power of two bucket histogram, reporting the upper bound of the
+ * bucket containing the requested percentile.
+ */
+static uint64_t _hist_percentile(int inx, int pct)
+{
+	uint32_t *hist = buf->rpc_type_hist +
+			 (inx * buf->rpc_type_hist_size);
+	uint64_t total = 0, seen = 0, target;
+	int b;
+
+	for (b = 0; b < buf->rpc_type_hist_size; b++)
+		total += hist[b];
+	if (total == 0)
+		return 0;
+	target = ((total * pct) + 99) / 100;
+	for (b = 0; b < (buf->rpc_type_hist_size - 1); b++) {
+		seen += hist[b];
+		if (seen >= target)
+			break;
+	}
+
+	return ((uint64_t) 1) << (b + 1);
+}
+
+/* As _hist_percentile, but for a lock domain hold time histogram */
+static uint64_t _lock_hist_percentile(int inx, int pct)
+{
+	uint32_t *hist = buf->lock_hold_hist + (inx * buf->lock_hist_size);
+	uint64_t total = 0, seen = 0, target;
+	int b;
+
+	for (b = 0; b < buf->lock_hist_size; b++)
+		total += hist[b];
+	if (total == 0)
+		return 0;
+	target = ((total * pct) + 99) / 100;
+	for (b = 0; b < (buf->lock_hist_size - 1); b++) {
+		seen += hist[b];
+		if (seen >= target)
+			break;
+	}
+
+	return ((uint64_t) 1) << (b + 1);
+}
+
+
+/* Emit queue telemetry in the Prometheus text exposition format so the
+ * output can be dropped into the node_exporter textfile collector */
+static int _print_prometheus(void)
+{
+	int i;
+
+	if (!buf) {
+		fprintf(stderr, "No data available. "
+			"Probably slurmctld is not working\n");
+		return -1;
+	}
+
+	printf("# HELP slurmctld_server_thread_count Active slurmctld server threads\n");
+	printf("# TYPE slurmctld_server_thread_count gauge\n");
+	printf("slurmctld_server_thread_count %u\n",
+	       buf->server_thread_count);
+
+	printf("# HELP slurmctld_rpc_queue_depth RPCs waiting for a worker thread\n");
+	printf("# TYPE slurmctld_rpc_queue_depth gauge\n");
+	printf("slurmctld_rpc_queue_depth %u\n", buf->rpc_queue_depth);
+
+	printf("# HELP slurmctld_queue_depth Current elements in an internal work queue\n");
+	printf("# TYPE slurmctld_queue_depth gauge\n");
+	for (i = 0; i < buf->queue_cnt; i++) {
+		printf("slurmctld_queue_depth{queue=\"%s\"} %u\n",
+		       buf->queue_name[i], buf->queue_depth[i]);
+	}
+
+	printf("# HELP slurmctld_queue_head_age_seconds Seconds the queue head element has been waiting\n");
+	printf("# TYPE slurmctld_queue_head_age_seconds gauge\n");
+	for (i = 0; i < buf->queue_cnt; i++) {
+		printf("slurmctld_queue_head_age_seconds{queue=\"%s\"} %u\n",
+		       buf->queue_name[i], buf->queue_head_age[i]);
+	}
+
+	printf("# HELP slurmctld_queue_enqueued_total Elements added since daemon start\n");
+	printf("# TYPE slurmctld_queue_enqueued_total counter\n");
+	for (i = 0; i < buf->queue_cnt; i++) {
+		printf("slurmctld_queue_enqueued_total{queue=\"%s\"} %"PRIu64"\n",
+		       buf->queue_name[i], buf->queue_enqueued[i]);
+	}
+
+	printf("# HELP slurmctld_queue_dequeued_total Elements removed since daemon start\n");
+	printf("# TYPE slurmctld_queue_dequeued_total counter\n");
+	for (i = 0; i < buf->queue_cnt; i++) {
+		printf("slurmctld_queue_dequeued_total{queue=\"%s\"} %"PRIu64"\n",
+		       buf->queue_name[i], buf->queue_dequeued[i]);
+	}
+
+	return 0;
+}
+
+/* Print one job lifecycle interval line: count, p50 and p99 over a
+ * histogram of job_timing_hist_size power of two microsecond buckets */
+static void _print_job_timing(const char *label, uint32_t *hist)
+{
+	uint64_t total = 0, seen = 0, p50 = 0, p99 = 0, target;
+	int b;
+
+	for (b = 0; b < buf->job_timing_hist_size; b++)
+		total += hist[b];
+	if (total) {
+		target = ((total * 50) + 99) / 100;
+		for (b = 0; b < (buf->job_timing_hist_size - 1); b++) {
+			seen += hist[b];
+			if (seen >= target)
+				break;
+		}
+		p50 = ((uint64_t) 1) << (b + 1);
+		seen = 0;
+		target = ((total * 99) + 99) / 100;
+		for (b = 0; b < (buf->job_timing_hist_size - 1); b++) {
+			seen += hist[b];
+			if (seen >= target)
+				break;
+		}
+		p99 = ((uint64_t) 1) << (b + 1);
+	}
+	printf("\t%-22s %10"PRIu64" %10"PRIu64" %10"PRIu64"\n",
+	       label, total, p50, p99);
+}
+
+/* Report lock wait/hold statistics collected with DebugFlags=LockProfile */
+static void _print_lock_stats(void)
+{
+	int i;
+
+	printf("\nLock statistics (DebugFlags=LockProfile, usec)\n");
+	printf("\t%-14s %10s %12s %10s %12s %10s %10s %10s\n",
+	       "Domain", "Count", "TotalWait", "MaxWait", "TotalHold",
+	       "MaxHold", "p50Hold", "p99Hold");
+	for (i = 0; i < buf->lock_domain_cnt; i++) {
+		if (!buf->lock_domain_lock_cnt[i])
+			continue;
+		printf("\t%-14s %10u %12"PRIu64" %10"PRIu64" %12"PRIu64
+		       " %10"PRIu64" %10"PRIu64" %10"PRIu64"\n",
+		       buf->lock_domain_names[i],
+		       buf->lock_domain_lock_cnt[i],
+		       buf->lock_domain_wait_time[i],
+		       buf->lock_domain_wait_max[i],
+		       buf->lock_domain_hold_time[i],
+		       buf->lock_domain_hold_max[i],
+		       _lock_hist_percentile(i, 50),
+		       _lock_hist_percentile(i, 99));
+	}
+	printf("\tCallers (lock_slurmctld return addresses, resolve with "
+	       "addr2line)\n");
+	for (i = 0; i < buf->lock_caller_cnt; i++) {
+		if (!buf->lock_caller_lock_cnt[i])
+			continue;
+		printf("\t0x%-12"PRIx64" %10u %12"PRIu64" %10"PRIu64
+		       " %12"PRIu64" %10"PRIu64"\n",
+		       buf->lock_caller_addr[i],
+		       buf->lock_caller_lock_cnt[i],
+		       buf->lock_caller_wait_time[i],
+		       buf->lock_caller_wait_max[i],
+		       buf->lock_caller_hold_time[i],
+		       buf->lock_caller_hold_max[i]);
+	}
+}
+
+/* Keep each histogram row with its RPC type while sorting */
+static void _swap_type_hist(int i, int j)
+{
+	uint32_t tmp, *hist_i, *hist_j;
+	int b;
+
+	if (!buf->rpc_type_hist_size)
+		return;
+	hist_i = buf->rpc_type_hist + (i * buf->rpc_type_hist_size);
+	hist_j = buf->rpc_type_hist + (j * buf->rpc_type_hist_size);
+	for (b = 0; b < buf->rpc_type_hist_size; b++) {
+		tmp = hist_i[b];
+		hist_i[b] = hist_j[b];
+		hist_j[b] = tmp;
+	}
+}
+
 static void _sort_rpc(void)
 {
 	int i, j;
@@ -258,6 +516,7 @@ static void _sort_rpc(void)
 				buf->rpc_type_id[j]   = type_id;
 				buf->rpc_type_cnt[j]  = type_cnt;
 				buf->rpc_type_time[j] = type_time;
+				_swap_type_hist(i, j);
 			}
 			if (buf->rpc_type_cnt[i]) {
 				rpc_type_ave_time[i] = buf->rpc_type_time[i] /
@@ -297,6 +556,7 @@ static void _sort_rpc(void)
 				buf->rpc_type_id[j]   = type_id;
 				buf->rpc_type_cnt[j]  = type_cnt;
 				buf->rpc_type_time[j] = type_time;
+				_swap_type_hist(i, j);
 			}
 			if (buf->rpc_type_cnt[i]) {
 				rpc_type_ave_time[i] = buf->rpc_type_time[i] /
@@ -345,6 +605,7 @@ static void _sort_rpc(void)
 				buf->rpc_type_id[j]   = type_id;
 				buf->rpc_type_cnt[j]  = type_cnt;
 				buf->rpc_type_time[j] = type_time;
+				_swap_type_hist(i, j);
 			}
 		}
 		for (i = 0; i < buf->rpc_user_size; i++) {
@@ -385,6 +646,7 @@ static void _sort_rpc(void)
 				buf->rpc_type_id[j]   = type_id;
 				buf->rpc_type_cnt[j]  = type_cnt;
 				buf->rpc_type_time[j] = type_time;
+				_swap_type_hist(i, j);
 			}
 			if (buf->rpc_type_cnt[i]) {
 				rpc_type_ave_time[i] = buf->rpc_type_time[i] /
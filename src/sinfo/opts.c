@@ -59,6 +59,7 @@
 #define OPT_LONG_LOCAL     0x103
 #define OPT_LONG_NOCONVERT 0x104
 #define OPT_LONG_FEDR      0x105
+#define OPT_LONG_WATCH     0x106
 
 /* FUNCTIONS */
 static List  _build_state_list( char* str );
@@ -117,6 +118,7 @@ extern void parse_command_line(int argc, char **argv)
 		{"reservation",no_argument,      0, 'T'},
 		{"usage",     no_argument,       0, OPT_LONG_USAGE},
 		{"verbose",   no_argument,       0, 'v'},
+		{"watch",     no_argument,       0, OPT_LONG_WATCH},
 		{"version",   no_argument,       0, 'V'},
 		{NULL,        0,                 0, 0}
 	};
@@ -291,12 +293,22 @@ extern void parse_command_line(int argc, char **argv)
 		case OPT_LONG_LOCAL:
 			params.local = true;
 			break;
+		case OPT_LONG_WATCH:
+			params.watch_flag = true;
+			break;
 		}
 	}
 
 	if (params.long_output && params.format)
 		fatal("Options -o(--format) and -l(--long) are mutually exclusive. Please remove one and retry.");
 
+	if (params.watch_flag) {
+		if (params.clusters)
+			fatal("Options --watch and --clusters are mutually exclusive. Please remove one and retry.");
+		if (!params.iterate)
+			params.iterate = 2;
+	}
+
 	if (opt_a_set && opt_p_set) {
 		error("Conflicting options, -a and -p, specified. "
 		      "Please choose one or the other.");
@@ -1298,6 +1310,7 @@ void _print_options( void )
 					"true" : "false");
 	printf("states      = %s\n", params.states);
 	printf("sort        = %s\n", params.sort);
+	printf("watch       = %s\n", params.watch_flag ? "true" : "false");
 	printf("summarize   = %s\n", params.summarize   ? "true" : "false");
 	printf("verbose     = %d\n", params.verbose);
 	printf("-----------------------------\n");
@@ -1398,6 +1411,10 @@ Usage: sinfo [OPTIONS]\n\
   -T, --reservation          show only reservation information\n\
   -v, --verbose              verbosity level\n\
   -V, --version              output version information and exit\n\
+      --watch                periodically redraw the output, only refetching\n\
+                             and repainting it when the controller reports\n\
+                             a change (implies --iterate=2 unless -i is\n\
+                             also given)\n\
 \nHelp options:\n\
   --help                     show this help message\n\
   --usage                    display brief usage message\n");
@@ -66,6 +66,7 @@ typedef struct load_info_struct {
 
 struct sinfo_parameters params;
 
+static bool data_changed = true; /* any load since the last paint changed */
 static int sinfo_cnt;	/* thread count */
 static pthread_mutex_t sinfo_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  sinfo_cnt_cond  = PTHREAD_COND_INITIALIZER;
@@ -78,6 +79,9 @@ void *      _build_part_info(void *args);
 static int  _build_sinfo_data(List sinfo_list,
 			      partition_info_msg_t *partition_msg,
 			      node_info_msg_t *node_msg);
+static int  _build_summary_sinfo_data(List sinfo_list,
+				      partition_info_msg_t *partition_msg,
+				      node_summary_info_msg_t *summary_msg);
 static sinfo_data_t *_create_sinfo(partition_info_t* part_ptr,
 				   uint16_t part_inx, node_info_t *node_ptr);
 static int  _find_part_list(void *x, void *key);
@@ -94,13 +98,14 @@ static bool _match_part_data(sinfo_data_t *sinfo_ptr,
 static int  _multi_cluster(List clusters);
 static void _node_list_delete(void *data);
 static void _part_list_delete(void *data);
-static List _query_fed_servers(slurmdb_federation_rec_t *fed,
-			       List node_info_msg_list,
-			       List part_info_msg_list);
+static List _query_clusters(List cluster_list,
+			    List node_info_msg_list,
+			    List part_info_msg_list);
 static List _query_server(bool clear_old);
 static int  _reservation_report(reserve_info_msg_t *resv_ptr);
 static bool _serial_part_data(void);
 static void _sinfo_list_delete(void *data);
+static bool _summary_query(void);
 static void _sort_hostlist(List sinfo_list);
 static void _update_sinfo(sinfo_data_t *sinfo_ptr, node_info_t *node_ptr);
 
@@ -118,7 +123,7 @@ int main(int argc, char **argv)
 	}
 
 	while (1) {
-		if ((!params.no_header) &&
+		if ((!params.no_header) && !params.watch_flag &&
 		    (params.iterate || params.verbose || params.long_output))
 			print_date();
 
@@ -128,7 +133,8 @@ int main(int argc, char **argv)
 		} else if (_multi_cluster(params.clusters) != 0)
 			rc = 1;
 		if (params.iterate) {
-			printf("\n");
+			if (!params.watch_flag)
+				printf("\n");
 			sleep(params.iterate);
 		} else
 			break;
@@ -153,6 +159,59 @@ static void prepend_cluster_name(void)
 	format_prepend_cluster_name(params.format_list, 8, false, "");
 }
 
+/*
+ * Query every cluster concurrently so the run time is bound by the
+ * slowest cluster rather than the sum of all of them, then print the
+ * reports in the listed cluster order.
+ */
+static int _multi_cluster_parallel(List clusters)
+{
+	List node_info_msg_list, part_info_msg_list, sinfo_list;
+	List cluster_sinfo_list;
+	ListIterator itr, sinfo_itr;
+	slurmdb_cluster_rec_t *cluster;
+	sinfo_data_t *sinfo_ptr;
+	bool first = true;
+	int rc = 0;
+
+	node_info_msg_list = list_create(_node_list_delete);
+	part_info_msg_list = list_create(_part_list_delete);
+	sinfo_list = _query_clusters(clusters, node_info_msg_list,
+				     part_info_msg_list);
+
+	itr = list_iterator_create(clusters);
+	while ((cluster = (slurmdb_cluster_rec_t *) list_next(itr))) {
+		working_cluster_rec = cluster;
+		if (!params.no_header) {
+			if (first)
+				first = false;
+			else
+				printf("\n");
+			printf("CLUSTER: %s\n", cluster->name);
+		}
+
+		/* Report this cluster's slice of the merged response */
+		cluster_sinfo_list = list_create(NULL);
+		sinfo_itr = list_iterator_create(sinfo_list);
+		while ((sinfo_ptr = (sinfo_data_t *) list_next(sinfo_itr))) {
+			if (!xstrcmp(sinfo_ptr->cluster_name, cluster->name))
+				list_append(cluster_sinfo_list, sinfo_ptr);
+		}
+		list_iterator_destroy(sinfo_itr);
+
+		sort_sinfo_list(cluster_sinfo_list);
+		print_sinfo_list(cluster_sinfo_list);
+		FREE_NULL_LIST(cluster_sinfo_list);
+	}
+	list_iterator_destroy(itr);
+
+	FREE_NULL_LIST(node_info_msg_list);
+	FREE_NULL_LIST(part_info_msg_list);
+	FREE_NULL_LIST(sinfo_list);
+
+	return rc;
+}
+
 static int _multi_cluster(List clusters)
 {
 	ListIterator itr;
@@ -162,6 +221,15 @@ static int _multi_cluster(List clusters)
 	if ((list_count(clusters) > 1) && params.no_header &&
 	    params.def_format)
 		prepend_cluster_name();
+
+	/*
+	 * Node and partition queries carry no inter-cluster state, so they
+	 * can be issued to all clusters at once. Reservation queries still
+	 * walk the clusters one by one.
+	 */
+	if ((list_count(clusters) > 1) && !params.reservation_flag)
+		return _multi_cluster_parallel(clusters);
+
 	itr = list_iterator_create(clusters);
 	while ((working_cluster_rec = list_next(itr))) {
 		if (!params.no_header) {
@@ -191,6 +259,26 @@ static int _set_cluster_name(void *x, void *arg)
  *		  another cluster)
  * fed IN - information about other clusters in this federation
  */
+/*
+ * In --watch mode decide whether the screen needs repainting.  Returns
+ * true if the caller should print (after the screen was cleared), false
+ * if the local mirror is unchanged and the last table painted can stay.
+ */
+static bool _watch_redraw(void)
+{
+	static bool first_draw = true;
+
+	if (!params.watch_flag)
+		return true;
+	if (!first_draw && !data_changed)
+		return false;
+	first_draw = false;
+	if (isatty(STDOUT_FILENO))
+		printf("\033[H\033[J");	/* home cursor, clear below */
+	print_date();
+	return true;
+}
+
 static int _get_info(bool clear_old, slurmdb_federation_rec_t *fed,
 		     char *cluster_name)
 {
@@ -202,22 +290,33 @@ static int _get_info(bool clear_old, slurmdb_federation_rec_t *fed,
 	if (params.reservation_flag) {
 		if (_load_resv(&reserv_msg, clear_old))
 			rc = SLURM_ERROR;
-		else
+		else {
+			if (!_watch_redraw())
+				return rc;
 			(void) _reservation_report(reserv_msg);
+		}
 		return rc;
 	}
 
 	if (fed) {
+		data_changed = true;
 		node_info_msg_list = list_create(_node_list_delete);
 		part_info_msg_list = list_create(_part_list_delete);
-		sinfo_list = _query_fed_servers(fed, node_info_msg_list,
-						part_info_msg_list);
+		sinfo_list = _query_clusters(fed->cluster_list,
+					     node_info_msg_list,
+					     part_info_msg_list);
 	} else {
 		sinfo_list = _query_server(clear_old);
 	}
 
 	if (!sinfo_list)
 		return SLURM_ERROR;
+	if (!_watch_redraw()) {
+		FREE_NULL_LIST(node_info_msg_list);
+		FREE_NULL_LIST(part_info_msg_list);
+		FREE_NULL_LIST(sinfo_list);
+		return SLURM_SUCCESS;
+	}
 	if (cluster_name) {
 		(void) list_for_each(sinfo_list, _set_cluster_name,
 				     cluster_name);
@@ -258,6 +357,7 @@ static int _reservation_report(reserve_info_msg_t *resv_ptr)
 static int _load_resv(reserve_info_msg_t **reserv_pptr, bool clear_old)
 {
 	static reserve_info_msg_t *old_resv_ptr = NULL, *new_resv_ptr;
+	reserve_info_msg_t *prev_resv_ptr = old_resv_ptr;
 	int error_code;
 
 	if (old_resv_ptr) {
@@ -282,6 +382,7 @@ static int _load_resv(reserve_info_msg_t **reserv_pptr, bool clear_old)
 	}
 	old_resv_ptr = new_resv_ptr;
 	*reserv_pptr = new_resv_ptr;
+	data_changed = (new_resv_ptr != prev_resv_ptr);
 
 	return SLURM_SUCCESS;
 }
@@ -296,6 +397,10 @@ static List _query_server(bool clear_old)
 {
 	static partition_info_msg_t *old_part_ptr = NULL, *new_part_ptr;
 	static node_info_msg_t *old_node_ptr = NULL, *new_node_ptr;
+	static node_summary_info_msg_t *old_sum_ptr = NULL, *new_sum_ptr;
+	partition_info_msg_t *prev_part_ptr = old_part_ptr;
+	node_info_msg_t *prev_node_ptr = old_node_ptr;
+	node_summary_info_msg_t *prev_sum_ptr = old_sum_ptr;
 	int error_code;
 	uint16_t show_flags = 0;
 	int cc;
@@ -326,6 +431,43 @@ static List _query_server(bool clear_old)
 	}
 	old_part_ptr = new_part_ptr;
 
+	/*
+	 * The default summary report only needs per-partition node state
+	 * counts, so ask the controller for just those in place of a full
+	 * node info dump.
+	 */
+	if (_summary_query()) {
+		if (old_sum_ptr) {
+			if (clear_old)
+				old_sum_ptr->last_update = 0;
+			error_code = slurm_load_node_summary(
+				old_sum_ptr->last_update, &new_sum_ptr,
+				show_flags);
+			if (error_code == SLURM_SUCCESS)
+				slurm_free_node_summary_info_msg(old_sum_ptr);
+			else if (slurm_get_errno() == SLURM_NO_CHANGE_IN_DATA) {
+				error_code = SLURM_SUCCESS;
+				new_sum_ptr = old_sum_ptr;
+			}
+		} else {
+			error_code = slurm_load_node_summary((time_t) NULL,
+							     &new_sum_ptr,
+							     show_flags);
+		}
+		if (error_code) {
+			slurm_perror("slurm_load_node_summary");
+			return sinfo_list;
+		}
+		old_sum_ptr = new_sum_ptr;
+		data_changed = (new_part_ptr != prev_part_ptr) ||
+			       (new_sum_ptr != prev_sum_ptr);
+
+		sinfo_list = list_create(_sinfo_list_delete);
+		_build_summary_sinfo_data(sinfo_list, new_part_ptr,
+					  new_sum_ptr);
+		return sinfo_list;
+	}
+
 	/* GRES used is only populated on nodes with detail flag */
 	if (params.match_flags.gres_used_flag)
 		show_flags |= SHOW_DETAIL;
@@ -359,6 +501,8 @@ static List _query_server(bool clear_old)
 		return sinfo_list;
 	}
 	old_node_ptr = new_node_ptr;
+	data_changed = (new_part_ptr != prev_part_ptr) ||
+		       (new_node_ptr != prev_node_ptr);
 
 	/* Set the node state as NODE_STATE_MIXED. */
 	for (cc = 0; cc < new_node_ptr->record_count; cc++) {
@@ -469,14 +613,15 @@ static void *_load_job_prio_thread(void *args)
 }
 
 /*
- * _query_fed_servers - download the current server state in parallel for
- *		all clusters in a federation
- * fed IN - identification of clusters in federation
+ * _query_clusters - download the current server state of every listed
+ *		cluster in parallel (federation members or a --clusters
+ *		selection)
+ * cluster_list IN - clusters to be queried
  * RET List of node/partition records
  */
-static List _query_fed_servers(slurmdb_federation_rec_t *fed,
-			       List node_info_msg_list,
-			       List part_info_msg_list)
+static List _query_clusters(List cluster_list,
+			    List node_info_msg_list,
+			    List part_info_msg_list)
 {
 	List resp_msg_list;
 	int pthread_count = 0;
@@ -488,9 +633,9 @@ static List _query_fed_servers(slurmdb_federation_rec_t *fed,
 
 	/* Spawn one pthread per cluster to collect job information */
 	load_thread = xmalloc(sizeof(pthread_t) *
-			      list_count(fed->cluster_list));
+			      list_count(cluster_list));
 	resp_msg_list = list_create(_sinfo_list_delete);
-	iter = list_iterator_create(fed->cluster_list);
+	iter = list_iterator_create(cluster_list);
 	while ((cluster = (slurmdb_cluster_rec_t *) list_next(iter))) {
 		if ((cluster->control_host == NULL) ||
 		    (cluster->control_host[0] == '\0'))
@@ -659,6 +804,69 @@ static int _build_sinfo_data(List sinfo_list,
 	return SLURM_SUCCESS;
 }
 
+/*
+ * _summary_query - return true if the report can be built from the node
+ *	summary RPC rather than a full node info dump. Only the default
+ *	--summarize output qualifies; custom formats and node filters may
+ *	need per-node data the summary does not carry.
+ */
+static bool _summary_query(void)
+{
+	if (!params.summarize || !params.def_format)
+		return false;
+	if (params.nodes || params.dead_nodes || params.responding_nodes ||
+	    params.state_list)
+		return false;
+	return true;
+}
+
+/*
+ * _build_summary_sinfo_data - make one sinfo_data entry per partition from
+ *	the node summary message, the counterpart of _build_sinfo_data() for
+ *	the default --summarize report
+ * sinfo_list IN/OUT - list of sinfo_data records to report
+ * partition_msg IN - partition info message
+ * summary_msg IN - node summary message
+ * RET zero or error code
+ */
+static int _build_summary_sinfo_data(List sinfo_list,
+				     partition_info_msg_t *partition_msg,
+				     node_summary_info_msg_t *summary_msg)
+{
+	partition_info_t *part_ptr;
+	partition_summary_t *sum;
+	sinfo_data_t *sinfo_ptr;
+	int i, j;
+
+	part_ptr = partition_msg->partition_array;
+	for (j = 0; j < partition_msg->record_count; j++, part_ptr++) {
+		if (params.part_list &&
+		    !list_find_first(params.part_list, _find_part_list,
+				     part_ptr->name))
+			continue;
+		sinfo_ptr = _create_sinfo(part_ptr, (uint16_t) j, NULL);
+		for (i = 0; i < summary_msg->record_count; i++) {
+			sum = &summary_msg->summary_array[i];
+			if (xstrcmp(sum->partition, part_ptr->name))
+				continue;
+			sinfo_ptr->nodes_alloc = sum->nodes_alloc;
+			sinfo_ptr->nodes_idle  = sum->nodes_idle;
+			sinfo_ptr->nodes_other = sum->nodes_other;
+			sinfo_ptr->nodes_total = sum->nodes_total;
+			sinfo_ptr->cpus_alloc  = sum->cpus_alloc;
+			sinfo_ptr->cpus_idle   = sum->cpus_idle;
+			sinfo_ptr->cpus_other  = sum->cpus_other;
+			sinfo_ptr->cpus_total  = sum->cpus_total;
+			break;
+		}
+		if (part_ptr->nodes)
+			hostlist_push(sinfo_ptr->nodes, part_ptr->nodes);
+		list_append(sinfo_list, sinfo_ptr);
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * _filter_out - Determine if the specified node should be filtered out or
  *	reported.
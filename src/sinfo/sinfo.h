@@ -178,6 +178,7 @@ struct sinfo_parameters {
 	bool responding_nodes;
 	bool list_reasons;
 	bool summarize;
+	bool watch_flag;
 	struct sinfo_match_flags match_flags;
 
 	char* format;
@@ -3451,6 +3451,21 @@ extern bool acct_policy_job_runnable_pre_select(struct job_record *job_ptr,
 		safe_limits = true;
 
 	assoc_ptr = job_ptr->assoc_ptr;
+
+	/*
+	 * The lineage limit flags record which of the limits checked in
+	 * the loop below are set anywhere in the association chain.
+	 * Most associations have none of them, so the walk can usually
+	 * be skipped outright.
+	 */
+	if (assoc_ptr &&
+	    !(assoc_ptr->usage->lineage_limits &
+	      (SLURMDB_LINEAGE_LIMIT_GRP_JOBS |
+	       SLURMDB_LINEAGE_LIMIT_GRP_WALL |
+	       SLURMDB_LINEAGE_LIMIT_MAX_JOBS |
+	       SLURMDB_LINEAGE_LIMIT_MAX_WALL)))
+		goto end_it;
+
 	while (assoc_ptr) {
 		/* This only trips when the grp_used_wall is divisible
 		 * by 60, i.e if a limit is 1 min and you have only
@@ -86,6 +86,8 @@
 #include "src/common/parse_time.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_interface.h"
+#include "src/common/slurm_time.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xsignal.h"
 #include "src/common/xassert.h"
@@ -198,6 +200,7 @@ static void *_wdog(void *args);
 static mail_info_t *_mail_alloc(void);
 static void  _mail_free(void *arg);
 static void *_mail_proc(void *arg);
+static void  _register_queue_stats(void);
 static char *_mail_type_str(uint16_t mail_type);
 static char **_build_mail_env(void);
 
@@ -207,8 +210,21 @@ static pthread_mutex_t retry_mutex = PTHREAD_MUTEX_INITIALIZER;
 static List defer_list = NULL;		/* agent_arg_t list for requests
 					 * requiring job write lock */
 static List mail_list = NULL;		/* pending e-mail requests */
+/*
+ * Pending requests are kept on two lists guarded by retry_mutex so that
+ * dispatch is O(1) instead of a full scan of one combined list:
+ * retry_new_list is a FIFO of never-attempted requests (last_attempt == 0)
+ * and retry_list holds attempted requests. Appends to retry_list always
+ * carry a current last_attempt stamp, so it stays ordered by retry
+ * deadline and its head is the next request eligible for replay.
+ */
+static List retry_new_list = NULL;	/* agent_arg_t list, never tried */
 static List retry_list = NULL;		/* agent_arg_t list for retry */
 
+static int retry_qid = -1;		/* queue telemetry, see timers.h */
+static int mail_qid = -1;
+static pthread_once_t queue_stats_once = PTHREAD_ONCE_INIT;
+
 
 static pthread_mutex_t agent_cnt_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  agent_cnt_cond  = PTHREAD_COND_INITIALIZER;
@@ -297,7 +313,7 @@ void *agent(void *args)
 		goto cleanup;
 
 	/* basic argument value tests */
-	begin_time = time(NULL);
+	begin_time = slurm_cached_time();
 	if (_valid_agent_arg(agent_arg_ptr))
 		goto cleanup;
 
@@ -348,7 +364,7 @@ void *agent(void *args)
 
 	/* Wait for termination of remaining threads */
 	pthread_join(thread_wdog, NULL);
-	delay = (int) difftime(time(NULL), begin_time);
+	delay = (int) difftime(slurm_cached_time(), begin_time);
 	if (delay > (slurm_get_msg_timeout() * 2)) {
 		info("agent msg_type=%u ran for %d seconds",
 			agent_arg_ptr->msg_type,  delay);
@@ -607,7 +623,7 @@ static void *_wdog(void *args)
 		thd_comp.fail_cnt    = 0;   /* assume no threads failures */
 		thd_comp.no_resp_cnt = 0;   /* assume all threads respond */
 		thd_comp.retry_cnt   = 0;   /* assume no required retries */
-		thd_comp.now         = time(NULL);
+		thd_comp.now         = slurm_cached_time();
 
 		usleep(usec);
 		usec = MIN((usec * 2), 1000000);
@@ -914,7 +930,7 @@ static void *_thread_per_group_rpc(void *args)
 			(msg_type == RESPONSE_RESOURCE_ALLOCATION) ||
 			(msg_type == SRUN_NODE_FAIL) );
 
-	thread_ptr->start_time = time(NULL);
+	thread_ptr->start_time = slurm_cached_time();
 
 	slurm_mutex_lock(thread_mutex_ptr);
 	thread_ptr->state = DSH_ACTIVE;
@@ -1211,7 +1227,7 @@ cleanup:
 	slurm_mutex_lock(thread_mutex_ptr);
 	thread_ptr->ret_list = ret_list;
 	thread_ptr->state = thread_state;
-	thread_ptr->end_time = (time_t) difftime(time(NULL),
+	thread_ptr->end_time = (time_t) difftime(slurm_cached_time(),
 						 thread_ptr->start_time);
 	/* Signal completion so another thread can replace us */
 	(*threads_active_ptr)--;
@@ -1354,12 +1370,67 @@ static void _queue_agent_retry(agent_info_t * agent_info_ptr, int count)
 	/* add the requeust to a list */
 	queued_req_ptr = xmalloc(sizeof(queued_request_t));
 	queued_req_ptr->agent_arg_ptr = agent_arg_ptr;
-	queued_req_ptr->last_attempt  = time(NULL);
+	queued_req_ptr->last_attempt  = slurm_cached_time();
 	slurm_mutex_lock(&retry_mutex);
 	if (retry_list == NULL)
 		retry_list = list_create(_list_delete_retry);
 	(void) list_append(retry_list, (void *) queued_req_ptr);
 	slurm_mutex_unlock(&retry_mutex);
+	pthread_once(&queue_stats_once, _register_queue_stats);
+	queue_stats_enqueued(retry_qid);
+}
+
+static int _retry_queue_depth(void)
+{
+	int depth = 0;
+
+	slurm_mutex_lock(&retry_mutex);
+	if (retry_new_list)
+		depth += list_count(retry_new_list);
+	if (retry_list)
+		depth += list_count(retry_list);
+	slurm_mutex_unlock(&retry_mutex);
+
+	return depth;
+}
+
+/* Queue time of the request at the head of the retry lists, zero when
+ * empty or when the head was never attempted and carries no stamp */
+static time_t _retry_queue_head(void)
+{
+	queued_request_t *req = NULL;
+	time_t head = 0;
+
+	slurm_mutex_lock(&retry_mutex);
+	if (retry_new_list)
+		req = list_peek(retry_new_list);
+	if (req && req->first_attempt)
+		head = req->first_attempt;
+	else if (!req && retry_list && (req = list_peek(retry_list)))
+		head = req->last_attempt;
+	slurm_mutex_unlock(&retry_mutex);
+
+	return head;
+}
+
+static int _mail_queue_depth(void)
+{
+	int depth = 0;
+
+	slurm_mutex_lock(&mail_mutex);
+	if (mail_list)
+		depth = list_count(mail_list);
+	slurm_mutex_unlock(&mail_mutex);
+
+	return depth;
+}
+
+static void _register_queue_stats(void)
+{
+	retry_qid = queue_stats_register("agent_retry", _retry_queue_depth,
+					 _retry_queue_head);
+	mail_qid = queue_stats_register("agent_mail", _mail_queue_depth,
+					NULL);
 }
 
 /*
@@ -1390,7 +1461,7 @@ static void *_agent_init(void *arg)
 		slurm_mutex_lock(&pending_mutex);
 		while (!slurmctld_config.shutdown_time &&
 		       !pending_mail && (pending_wait_time == NO_VAL16)) {
-			ts.tv_sec  = time(NULL) + 2;
+			ts.tv_sec  = slurm_cached_time() + 2;
 			slurm_cond_timedwait(&pending_cond, &pending_mutex,
 					     &ts);
 		}
@@ -1405,7 +1476,7 @@ static void *_agent_init(void *arg)
 		slurm_mutex_unlock(&pending_mutex);
 
 		if (last_defer_attempt + 2 < last_job_update) {
-			last_defer_attempt = time(NULL);
+			last_defer_attempt = slurm_cached_time();
 			_agent_defer();
 		}
 
@@ -1469,7 +1540,7 @@ extern void agent_pack_pending_rpc_stats(Buf buffer)
 	agent_arg_t *agent_arg_ptr = NULL;
 	ListIterator list_iter;
 
-	now = time(NULL);
+	now = slurm_cached_time();
 	if (difftime(now, cache_build_time) <= RPC_PACK_MAX_AGE)
 		goto pack_it;	/* Send cached data */
 	cache_build_time = now;
@@ -1495,8 +1566,11 @@ extern void agent_pack_pending_rpc_stats(Buf buffer)
 	}
 
 	slurm_mutex_lock(&retry_mutex);
-	if (retry_list) {
-		list_iter = list_iterator_create(retry_list);
+	for (int j = 0; j < 2; j++) {
+		List pend_list = (j == 0) ? retry_new_list : retry_list;
+		if (!pend_list)
+			continue;
+		list_iter = list_iterator_create(pend_list);
 		/* iterate through list, find type slot or make a new one */
 		while ((queued_req_ptr = list_next(list_iter))) {
 			agent_arg_ptr = queued_req_ptr->agent_arg_ptr;
@@ -1562,13 +1636,16 @@ static void _agent_defer(void)
 					queued_req_ptr->agent_arg_ptr);
 				xfree(queued_req_ptr);
 			} else if (rc == 0) {
-				/* ready to process now, move to retry_list */
+				/* ready to process now, queue for dispatch */
+				pthread_once(&queue_stats_once,
+					     _register_queue_stats);
 				slurm_mutex_lock(&retry_mutex);
-				if (!retry_list)
-					retry_list =
+				if (!retry_new_list)
+					retry_new_list =
 						list_create(_list_delete_retry);
-				list_append(retry_list, queued_req_ptr);
+				list_append(retry_new_list, queued_req_ptr);
 				slurm_mutex_unlock(&retry_mutex);
+				queue_stats_enqueued(retry_qid);
 			} else if (rc == 1) {
 				if (!tmp_list)
 					tmp_list =
@@ -1593,30 +1670,42 @@ static void _agent_defer(void)
  * This is a separate thread so the job records can be locked */
 static void _agent_retry(int min_wait, bool mail_too)
 {
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 	queued_request_t *queued_req_ptr = NULL;
 	agent_arg_t *agent_arg_ptr = NULL;
 	ListIterator retry_iter;
 	mail_info_t *mi = NULL;
 
 	slurm_mutex_lock(&retry_mutex);
-	if (retry_list) {
+	if (retry_list || retry_new_list) {
 		static time_t last_msg_time = (time_t) 0;
 		uint32_t msg_type[5] = {0, 0, 0, 0, 0};
-		int i = 0, list_size = list_count(retry_list);
+		int i = 0, j, list_size = 0;
+		List lists[2] = { retry_new_list, retry_list };
+		if (retry_new_list)
+			list_size += list_count(retry_new_list);
+		if (retry_list)
+			list_size += list_count(retry_list);
 		if (((list_size > 100) &&
 		     (difftime(now, last_msg_time) > 300)) ||
 		    ((list_size > 0) &&
 		     (slurmctld_conf.debug_flags & DEBUG_FLAG_AGENT))) {
 			/* Note sizable backlog (retry_list_size()) of work */
-			retry_iter = list_iterator_create(retry_list);
-			while ((queued_req_ptr = list_next(retry_iter))) {
-				agent_arg_ptr = queued_req_ptr->agent_arg_ptr;
-				msg_type[i++] = agent_arg_ptr->msg_type;
-				if (i == 5)
-					break;
+			for (j = 0; (j < 2) && (i < 5); j++) {
+				if (!lists[j])
+					continue;
+				retry_iter = list_iterator_create(lists[j]);
+				while ((queued_req_ptr =
+					list_next(retry_iter))) {
+					agent_arg_ptr =
+						queued_req_ptr->agent_arg_ptr;
+					msg_type[i++] =
+						agent_arg_ptr->msg_type;
+					if (i == 5)
+						break;
+				}
+				list_iterator_destroy(retry_iter);
 			}
-			list_iterator_destroy(retry_iter);
 			info("   retry_list retry_list_size:%d msg_type=%s,%s,%s,%s,%s",
 			     list_size, rpc_num2string(msg_type[0]),
 			     rpc_num2string(msg_type[1]),
@@ -1636,35 +1725,25 @@ static void _agent_retry(int min_wait, bool mail_too)
 	}
 	slurm_mutex_unlock(&agent_cnt_mutex);
 
-	if (retry_list) {
-		/* first try to find a new (never tried) record */
-		retry_iter = list_iterator_create(retry_list);
-		while ((queued_req_ptr = list_next(retry_iter))) {
- 			if (queued_req_ptr->last_attempt == 0) {
-				list_remove(retry_iter);
-				break;		/* Process this request now */
-			}
-		}
-		list_iterator_destroy(retry_iter);
-	}
+	/* first take a new (never tried) record, in submission order */
+	if (retry_new_list)
+		queued_req_ptr = list_dequeue(retry_new_list);
 
 	if (retry_list && (queued_req_ptr == NULL)) {
-		/* now try to find a requeue request that is
-		 * relatively old */
-		double age = 0;
-
-		retry_iter = list_iterator_create(retry_list);
-		/* next try to find an older record to retry */
-		while ((queued_req_ptr = list_next(retry_iter))) {
-			age = difftime(now, queued_req_ptr->last_attempt);
-			if (age > min_wait) {
-				list_remove(retry_iter);
-				break;
-			}
-		}
-		list_iterator_destroy(retry_iter);
+		/*
+		 * retry_list is ordered by last_attempt, so only its head
+		 * can be due for replay
+		 */
+		queued_req_ptr = list_peek(retry_list);
+		if (queued_req_ptr &&
+		    (difftime(now, queued_req_ptr->last_attempt) > min_wait))
+			queued_req_ptr = list_dequeue(retry_list);
+		else
+			queued_req_ptr = NULL;
 	}
 	slurm_mutex_unlock(&retry_mutex);
+	if (queued_req_ptr)
+		queue_stats_dequeued(retry_qid);
 
 	if (queued_req_ptr) {
 		agent_arg_ptr = queued_req_ptr->agent_arg_ptr;
@@ -1683,6 +1762,7 @@ static void _agent_retry(int min_wait, bool mail_too)
 			if (!mi)
 				break;
 
+			queue_stats_dequeued(mail_qid);
 			agent_thread_cnt++;
 			slurm_thread_create_detached(NULL, _mail_proc, mi);
 		}
@@ -1732,9 +1812,9 @@ void agent_queue_request(agent_arg_t *agent_arg_ptr)
 		slurm_mutex_unlock(&defer_mutex);
 	} else {
 		slurm_mutex_lock(&retry_mutex);
-		if (retry_list == NULL)
-			retry_list = list_create(_list_delete_retry);
-		list_append(retry_list, (void *)queued_req_ptr);
+		if (retry_new_list == NULL)
+			retry_new_list = list_create(_list_delete_retry);
+		list_append(retry_new_list, (void *)queued_req_ptr);
 		slurm_mutex_unlock(&retry_mutex);
 	}
 	/* now process the request in a separate pthread
@@ -1747,9 +1827,10 @@ extern void agent_purge(void)
 {
 	int i;
 
-	if (retry_list) {
+	if (retry_list || retry_new_list) {
 		slurm_mutex_lock(&retry_mutex);
 		FREE_NULL_LIST(retry_list);
+		FREE_NULL_LIST(retry_new_list);
 		slurm_mutex_unlock(&retry_mutex);
 	}
 	if (defer_list) {
@@ -1962,17 +2043,17 @@ static void _set_job_time(struct job_record *job_ptr, uint16_t mail_type,
 	     (mail_type == MAIL_JOB_TIME80)  ||
 	     (mail_type == MAIL_JOB_TIME50)) && job_ptr->start_time) {
 		if (job_ptr->suspend_time) {
-			interval  = time(NULL) - job_ptr->suspend_time;
+			interval  = slurm_cached_time() - job_ptr->suspend_time;
 			interval += job_ptr->pre_sus_time;
 		} else
-			interval = time(NULL) - job_ptr->start_time;
+			interval = slurm_cached_time() - job_ptr->start_time;
 		snprintf(buf, buf_len, ", Run time ");
 		secs2time_str(interval, buf+11, buf_len-11);
 		return;
 	}
 
 	if ((mail_type == MAIL_JOB_STAGE_OUT) && job_ptr->end_time) {
-		interval = time(NULL) - job_ptr->end_time;
+		interval = slurm_cached_time() - job_ptr->end_time;
 		snprintf(buf, buf_len, " time ");
 		secs2time_str(interval, buf + 6, buf_len - 6);
 		return;
@@ -2110,6 +2191,8 @@ extern void mail_job_info (struct job_record *job_ptr, uint16_t mail_type)
 		mail_list = list_create(_mail_free);
 	(void) list_enqueue(mail_list, (void *) mi);
 	slurm_mutex_unlock(&mail_mutex);
+	pthread_once(&queue_stats_once, _register_queue_stats);
+	queue_stats_enqueued(mail_qid);
 	return;
 }
 
@@ -2122,7 +2205,7 @@ static int _batch_launch_defer(queued_request_t *queued_req_ptr)
 {
 	agent_arg_t *agent_arg_ptr;
 	batch_job_launch_msg_t *launch_msg_ptr;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 	struct job_record *job_ptr;
 	int nodes_ready = 0, tmp = 0;
 
@@ -2212,7 +2295,7 @@ static int _signal_defer(queued_request_t *queued_req_ptr)
 {
 	agent_arg_t *agent_arg_ptr;
 	signal_tasks_msg_t *signal_msg_ptr;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 	struct job_record *job_ptr;
 
 	agent_arg_ptr = queued_req_ptr->agent_arg_ptr;
@@ -2240,12 +2323,16 @@ static int _signal_defer(queued_request_t *queued_req_ptr)
 	return 1;
 }
 
-/* Return length of agent's retry_list */
+/* Return number of pending requests on the agent's retry lists */
 extern int retry_list_size(void)
 {
-	if (retry_list == NULL)
-		return 0;
-	return list_count(retry_list);
+	int size = 0;
+
+	if (retry_new_list)
+		size += list_count(retry_new_list);
+	if (retry_list)
+		size += list_count(retry_list);
+	return size;
 }
 
 static void _reboot_from_ctld(agent_arg_t *agent_arg_ptr)
@@ -169,6 +169,16 @@ void run_backup(slurm_trigger_callbacks_t *callbacks)
 			continue;
 
 		last_ping = time(NULL);
+
+		/*
+		 * Keep the page cache warm with the primary's latest state
+		 * save files while idle. Takeover then reads current state
+		 * from the local cache rather than pulling every file across
+		 * the shared state save filesystem, which dominates the
+		 * failover time with a deep queue.
+		 */
+		preread_state_files();
+
 		if (ping_controllers(false) == SLURM_SUCCESS)
 			last_controller_response = time(NULL);
 		else if (takeover) {
@@ -81,6 +81,7 @@
 #include "src/common/slurm_jobacct_gather.h"
 #include "src/common/slurm_jobcomp.h"
 #include "src/common/slurm_mcs.h"
+#include "src/common/slurm_persist_conn.h"
 #include "src/common/slurm_priority.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_interface.h"
@@ -226,6 +227,50 @@ typedef struct primary_thread_arg {
 	char *prog_type;
 } primary_thread_arg_t;
 
+/*
+ * Incoming RPC connections are serviced by a persistent pool of worker
+ * threads fed from rpc_conn_queue rather than by one pthread per RPC.
+ * Read-only info RPCs received while a backlog of connections is pending
+ * are parked on rpc_defer_queue, which only drains when no new connection
+ * is waiting, so cheap squeue/sinfo/ping storms cannot starve job submit
+ * or node registration traffic. If the connection queue is saturated a
+ * detached thread is spawned as before, preserving the historic
+ * MAX_SERVER_THREADS concurrency bound under extreme load.
+ * Pool size may be set with SlurmctldParameters=rpc_pool_size=#.
+ */
+#define RPC_POOL_SIZE_DEFAULT 64
+
+typedef struct {
+	connection_arg_t *conn;
+	slurm_msg_t *msg;
+} rpc_defer_item_t;
+
+static pthread_mutex_t rpc_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  rpc_queue_cond = PTHREAD_COND_INITIALIZER;
+static List rpc_conn_queue = NULL;
+static List rpc_defer_queue = NULL;
+static int  rpc_pool_size = RPC_POOL_SIZE_DEFAULT;
+static int  rpc_pool_active = 0;
+static bool rpc_pool_shutdown = false;
+
+/*
+ * Long-lived slurmd RPC connections (PERSIST_TYPE_RPC) are watched by a
+ * single poller thread rather than one thread each, so they cost one
+ * file descriptor apiece rather than a thread. A readable connection is
+ * handed to the worker pool above, which services exactly one message
+ * before returning the connection to the poll set.
+ */
+typedef struct {
+	bool busy;		/* a pool worker is servicing a message */
+	bool dead;		/* connection failed; reaped by the poller */
+	slurm_persist_conn_t *conn;
+} rpc_persist_conn_t;
+
+static pthread_mutex_t rpc_persist_mutex = PTHREAD_MUTEX_INITIALIZER;
+static List rpc_persist_conns = NULL;
+static List rpc_persist_queue = NULL;
+static int  rpc_persist_pipe[2] = {-1, -1};
+
 static int          _accounting_cluster_ready();
 static int          _accounting_mark_all_nodes_down(char *reason);
 static void *       _assoc_cache_mgr(void *no_data);
@@ -238,8 +283,19 @@ static void         _init_config(void);
 static void         _init_pidfile(void);
 static int          _init_tres(void);
 static void         _kill_old_slurmctld(void);
+static void *       _node_addrs_thread(void *no_data);
 static void         _parse_commandline(int argc, char **argv);
+static void         _prefetch_group_cache(void);
 static void *       _purge_files_thread(void *no_data);
+static void *       _rpc_persist_poller(void *no_data);
+static void         _rpc_persist_service(rpc_persist_conn_t *pconn);
+static void         _rpc_persist_wake(void);
+static void         _rpc_pool_start(void);
+static void *       _rpc_pool_worker(void *no_data);
+static void         _rpc_process_msg(connection_arg_t *conn,
+				     slurm_msg_t *msg);
+static void         _rpc_queue_conn(connection_arg_t *conn);
+static bool         _rpc_read_only_type(uint16_t msg_type);
 static void         _remove_assoc(slurmdb_assoc_rec_t *rec);
 static void         _remove_qos(slurmdb_qos_rec_t *rec);
 static void         _run_primary_prog(bool primary_on);
@@ -726,6 +782,11 @@ int main(int argc, char **argv)
 		if (slurm_mcs_init() != SLURM_SUCCESS)
 			fatal("failed to initialize mcs plugin");
 
+		/* warm the name caches before RPC traffic starts */
+		(void) uid_cache_state_restore(
+			slurmctld_conf.state_save_location);
+		_prefetch_group_cache();
+
 		/*
 		 * create attached thread to process RPCs
 		 */
@@ -883,6 +944,10 @@ int main(int argc, char **argv)
 	reserve_port_config(NULL);
 	free_rpc_stats();
 
+	/* Finish any deferred teardown while the plugins that the
+	 * destructors may call are still loaded */
+	xfree_deferred_drain();
+
 	/* Some plugins are needed to purge job/node data structures,
 	 * unplug after other data structures are purged */
 	ext_sensors_fini();
@@ -1164,6 +1229,7 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 			debug2("slurmctld listening on %s:%d", ip, ntohs(port));
 		}
 	}
+	_rpc_pool_start();
 	unlock_slurmctld(config_read_lock);
 
 	/*
@@ -1225,12 +1291,15 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 			slurmctld_diag_stats.proc_req_raw++;
 			_service_connection(conn_arg);
 		} else {
-			slurm_thread_create_detached(NULL, _service_connection,
-						     conn_arg);
+			_rpc_queue_conn(conn_arg);
 		}
 	}
 
 	debug3("%s shutting down", __func__);
+	slurm_mutex_lock(&rpc_queue_mutex);
+	rpc_pool_shutdown = true;
+	slurm_cond_broadcast(&rpc_queue_cond);
+	slurm_mutex_unlock(&rpc_queue_mutex);
 	for (i = 0; i < nports; i++)
 		close(fds[i].fd);
 	xfree(fds);
@@ -1239,6 +1308,58 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 	return NULL;
 }
 
+/* Report the number of accepted connections waiting for a worker */
+extern int server_rpc_queue_depth(void)
+{
+	int depth = 0;
+
+	slurm_mutex_lock(&rpc_queue_mutex);
+	if (rpc_conn_queue)
+		depth += list_count(rpc_conn_queue);
+	if (rpc_defer_queue)
+		depth += list_count(rpc_defer_queue);
+	slurm_mutex_unlock(&rpc_queue_mutex);
+
+	return depth;
+}
+
+/* Return true for cheap, read-only info RPCs which may be deferred
+ * behind other traffic during a request storm */
+static bool _rpc_read_only_type(uint16_t msg_type)
+{
+	switch (msg_type) {
+	case REQUEST_PING:
+	case REQUEST_BUILD_INFO:
+	case REQUEST_FED_INFO:
+	case REQUEST_JOB_INFO:
+	case REQUEST_JOB_INFO_SINGLE:
+	case REQUEST_JOB_USER_INFO:
+	case REQUEST_NODE_INFO:
+	case REQUEST_NODE_INFO_SINGLE:
+	case REQUEST_PARTITION_INFO:
+	case REQUEST_PRIORITY_FACTORS:
+	case REQUEST_RESERVATION_INFO:
+	case REQUEST_SHARE_INFO:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Process a fully received RPC and release the connection */
+static void _rpc_process_msg(connection_arg_t *conn, slurm_msg_t *msg)
+{
+	slurmctld_req(msg, conn);
+
+	if ((conn->newsockfd >= 0) && (close(conn->newsockfd) < 0))
+		error("close(%d): %m", conn->newsockfd);
+
+	slurm_free_msg_members(msg);
+	xfree(msg);
+	xfree(conn);
+	server_thread_decr();
+}
+
 /*
  * _service_connection - service the RPC
  * IN/OUT arg - really just the connection's file descriptor, freed
@@ -1248,49 +1369,380 @@ static void *_slurmctld_rpc_mgr(void *no_data)
 static void *_service_connection(void *arg)
 {
 	connection_arg_t *conn = (connection_arg_t *) arg;
-	void *return_code = NULL;
-	slurm_msg_t msg;
+	slurm_msg_t *msg = xmalloc(sizeof(slurm_msg_t));
 
 #if HAVE_SYS_PRCTL_H
 	if (prctl(PR_SET_NAME, "srvcn", NULL, NULL, NULL) < 0) {
 		error("%s: cannot set my name to %s %m", __func__, "srvcn");
 	}
 #endif
-	slurm_msg_t_init(&msg);
-	msg.flags |= SLURM_MSG_KEEP_BUFFER;
+	slurm_msg_t_init(msg);
+	msg->flags |= SLURM_MSG_KEEP_BUFFER;
 	/*
 	 * slurm_receive_msg sets msg connection fd to accepted fd. This allows
 	 * possibility for slurmctld_req() to close accepted connection.
 	 */
-	if (slurm_receive_msg(conn->newsockfd, &msg, 0) != 0) {
+	if (slurm_receive_msg(conn->newsockfd, msg, 0) != 0) {
 		char addr_buf[32];
 		slurm_print_slurm_addr(&conn->cli_addr, addr_buf,
 				       sizeof(addr_buf));
 		error("slurm_receive_msg [%s]: %m", addr_buf);
 		/* close the new socket */
 		close(conn->newsockfd);
-		goto cleanup;
+		slurm_free_msg_members(msg);
+		xfree(msg);
+		xfree(conn);
+		server_thread_decr();
+		return NULL;
 	}
 
 	if (errno != SLURM_SUCCESS) {
 		if (errno == SLURM_PROTOCOL_VERSION_ERROR) {
-			slurm_send_rc_msg(&msg, SLURM_PROTOCOL_VERSION_ERROR);
+			slurm_send_rc_msg(msg, SLURM_PROTOCOL_VERSION_ERROR);
 		} else
 			info("_service_connection/slurm_receive_msg %m");
-	} else {
-		/* process the request */
-		slurmctld_req(&msg, conn);
+		if ((conn->newsockfd >= 0) && (close(conn->newsockfd) < 0))
+			error("close(%d): %m", conn->newsockfd);
+		slurm_free_msg_members(msg);
+		xfree(msg);
+		xfree(conn);
+		server_thread_decr();
+		return NULL;
 	}
 
-	if ((conn->newsockfd >= 0) && (close(conn->newsockfd) < 0))
-		error ("close(%d): %m",  conn->newsockfd);
+	/*
+	 * Defer read-only info RPCs while new connections are backed up,
+	 * unless the deferred queue itself is saturated.
+	 */
+	if (!slurmctld_config.shutdown_time &&
+	    _rpc_read_only_type(msg->msg_type)) {
+		bool deferred = false;
+		slurm_mutex_lock(&rpc_queue_mutex);
+		if (rpc_conn_queue && !rpc_pool_shutdown &&
+		    (list_count(rpc_conn_queue) > rpc_pool_size) &&
+		    (list_count(rpc_defer_queue) < (2 * rpc_pool_size))) {
+			rpc_defer_item_t *item =
+				xmalloc(sizeof(rpc_defer_item_t));
+			item->conn = conn;
+			item->msg = msg;
+			list_enqueue(rpc_defer_queue, item);
+			slurm_cond_signal(&rpc_queue_cond);
+			deferred = true;
+		}
+		slurm_mutex_unlock(&rpc_queue_mutex);
+		if (deferred)
+			return NULL;
+	}
 
-cleanup:
-	slurm_free_msg_members(&msg);
-	xfree(arg);
-	server_thread_decr();
+	_rpc_process_msg(conn, msg);
+	return NULL;
+}
+
+/* Worker thread for the RPC connection pool */
+static void *_rpc_pool_worker(void *no_data)
+{
+	connection_arg_t *conn;
+	rpc_defer_item_t *item;
+	rpc_persist_conn_t *pconn;
+
+#if HAVE_SYS_PRCTL_H
+	if (prctl(PR_SET_NAME, "rpcpool", NULL, NULL, NULL) < 0) {
+		error("%s: cannot set my name to %s %m", __func__, "rpcpool");
+	}
+#endif
+	while (true) {
+		conn = NULL;
+		item = NULL;
+		pconn = NULL;
+		slurm_mutex_lock(&rpc_queue_mutex);
+		while (!rpc_pool_shutdown &&
+		       (list_count(rpc_conn_queue) == 0) &&
+		       (list_count(rpc_persist_queue) == 0) &&
+		       (list_count(rpc_defer_queue) == 0)) {
+			slurm_cond_wait(&rpc_queue_cond, &rpc_queue_mutex);
+		}
+		/* New connections take precedence over deferred info RPCs */
+		if (!(conn = list_dequeue(rpc_conn_queue)) &&
+		    !(pconn = list_dequeue(rpc_persist_queue)))
+			item = list_dequeue(rpc_defer_queue);
+		if (!conn && !pconn && !item && rpc_pool_shutdown) {
+			rpc_pool_active--;
+			slurm_mutex_unlock(&rpc_queue_mutex);
+			break;
+		}
+		slurm_mutex_unlock(&rpc_queue_mutex);
 
-	return return_code;
+		if (conn)
+			(void) _service_connection(conn);
+		else if (pconn)
+			_rpc_persist_service(pconn);
+		else if (item) {
+			_rpc_process_msg(item->conn, item->msg);
+			xfree(item);
+		}
+	}
+	return NULL;
+}
+
+/* Start (or, after a backup to primary resume cycle, restart) the RPC
+ * worker pool */
+static void _rpc_pool_start(void)
+{
+	char *tmp_ptr;
+	int started = 0;
+
+	if ((tmp_ptr = xstrcasestr(slurmctld_conf.slurmctld_params,
+				   "rpc_pool_size="))) {
+		rpc_pool_size = atoi(tmp_ptr + 14);
+		if ((rpc_pool_size < 1) ||
+		    (rpc_pool_size > max_server_threads)) {
+			error("Invalid SlurmctldParameters rpc_pool_size ignored");
+			rpc_pool_size = RPC_POOL_SIZE_DEFAULT;
+		}
+	}
+
+	if (!rpc_conn_queue) {
+		rpc_conn_queue = list_create(NULL);
+		rpc_defer_queue = list_create(NULL);
+		rpc_persist_queue = list_create(NULL);
+	}
+
+	/*
+	 * Spawn only the workers which are missing. After a shutdown of
+	 * the pool most will have drained and exited, but any worker
+	 * still inside the loop rejoins the pool once the shutdown flag
+	 * is cleared.
+	 */
+	slurm_mutex_lock(&rpc_queue_mutex);
+	rpc_pool_shutdown = false;
+	while (rpc_pool_active < rpc_pool_size) {
+		slurm_thread_create_detached(NULL, _rpc_pool_worker, NULL);
+		rpc_pool_active++;
+		started++;
+	}
+	slurm_mutex_unlock(&rpc_queue_mutex);
+	if (started)
+		debug("started %d RPC pool worker threads", started);
+}
+
+/*
+ * Hand an accepted connection to the RPC worker pool, falling back to a
+ * dedicated thread if the pool is backlogged. server_thread_count
+ * continues to bound the total number of outstanding connections.
+ */
+static void _rpc_queue_conn(connection_arg_t *conn)
+{
+	bool queued = false;
+
+	slurm_mutex_lock(&rpc_queue_mutex);
+	if (rpc_conn_queue && !rpc_pool_shutdown &&
+	    (list_count(rpc_conn_queue) < (2 * rpc_pool_size))) {
+		list_enqueue(rpc_conn_queue, conn);
+		slurm_cond_signal(&rpc_queue_cond);
+		queued = true;
+	}
+	slurm_mutex_unlock(&rpc_queue_mutex);
+
+	if (!queued)
+		slurm_thread_create_detached(NULL, _service_connection, conn);
+}
+
+/* Wake the persistent connection poller to rebuild its poll set */
+static void _rpc_persist_wake(void)
+{
+	char c = 0;
+
+	if ((rpc_persist_pipe[1] >= 0) &&
+	    (write(rpc_persist_pipe[1], &c, 1) < 0))
+		debug3("%s: poller already awake", __func__);
+}
+
+/*
+ * Service one message on a long-lived slurmd RPC connection. Any
+ * response is sent by the RPC handler (or an error rc built here) over
+ * the same connection, then the connection is returned to the poller.
+ */
+static void _rpc_persist_service(rpc_persist_conn_t *pconn)
+{
+	slurm_persist_conn_t *persist_conn = pconn->conn;
+	persist_msg_t persist_msg;
+	uint32_t uid = NO_VAL;
+	Buf buffer, ret_buf = NULL;
+	bool failed = false;
+	int rc;
+
+	if ((buffer = slurm_persist_recv_msg(persist_conn))) {
+		rc = slurm_persist_conn_process_msg(
+			persist_conn, &persist_msg,
+			get_buf_data(buffer), size_buf(buffer),
+			&ret_buf, false);
+		if (rc == SLURM_SUCCESS) {
+			(void) (persist_conn->callback_proc)(
+				persist_conn, &persist_msg, &ret_buf, &uid);
+			slurm_free_msg_data(persist_msg.msg_type,
+					    persist_msg.data);
+		}
+		if (ret_buf) {
+			if (slurm_persist_send_msg(persist_conn, ret_buf)
+			    != SLURM_SUCCESS)
+				failed = true;
+			free_buf(ret_buf);
+		}
+		free_buf(buffer);
+	} else		/* EOF or read error */
+		failed = true;
+
+	slurm_mutex_lock(&rpc_persist_mutex);
+	pconn->busy = false;
+	if (failed)
+		pconn->dead = true;
+	slurm_mutex_unlock(&rpc_persist_mutex);
+	_rpc_persist_wake();
+}
+
+/*
+ * Watch all long-lived slurmd RPC connections with a single poll() and
+ * hand readable ones to the RPC worker pool, one message at a time.
+ */
+static void *_rpc_persist_poller(void *no_data)
+{
+	struct pollfd *fds = NULL;
+	rpc_persist_conn_t **cmap = NULL;
+	rpc_persist_conn_t *pconn;
+	ListIterator itr;
+	int fds_alloc = 0;
+	int nfds, rc, i;
+
+#if HAVE_SYS_PRCTL_H
+	if (prctl(PR_SET_NAME, "rpcconns", NULL, NULL, NULL) < 0) {
+		error("%s: cannot set my name to %s %m", __func__, "rpcconns");
+	}
+#endif
+
+	while (!slurmctld_config.shutdown_time) {
+		slurm_mutex_lock(&rpc_persist_mutex);
+		/* Reap failed connections no worker is still using */
+		itr = list_iterator_create(rpc_persist_conns);
+		while ((pconn = list_next(itr))) {
+			if (pconn->dead && !pconn->busy) {
+				slurm_persist_conn_destroy(pconn->conn);
+				list_remove(itr);
+				xfree(pconn);
+			}
+		}
+		list_iterator_destroy(itr);
+
+		nfds = list_count(rpc_persist_conns) + 1;
+		if (nfds > fds_alloc) {
+			fds_alloc = nfds + 64;
+			xrealloc_nz(fds, fds_alloc * sizeof(struct pollfd));
+			xrealloc_nz(cmap,
+				    fds_alloc * sizeof(rpc_persist_conn_t *));
+		}
+		fds[0].fd = rpc_persist_pipe[0];
+		fds[0].events = POLLIN;
+		fds[0].revents = 0;
+		nfds = 1;
+		itr = list_iterator_create(rpc_persist_conns);
+		while ((pconn = list_next(itr))) {
+			if (pconn->busy || pconn->dead ||
+			    (pconn->conn->fd < 0))
+				continue;
+			fds[nfds].fd = pconn->conn->fd;
+			fds[nfds].events = POLLIN;
+			fds[nfds].revents = 0;
+			cmap[nfds] = pconn;
+			nfds++;
+		}
+		list_iterator_destroy(itr);
+		slurm_mutex_unlock(&rpc_persist_mutex);
+
+		/* Bounded wait so shutdown is noticed */
+		if ((rc = poll(fds, nfds, 1000)) < 1) {
+			if ((rc == -1) && (errno != EINTR))
+				error("%s: poll: %m", __func__);
+			continue;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			char tmp[64];
+			while (read(rpc_persist_pipe[0], tmp,
+				    sizeof(tmp)) > 0)
+				;
+		}
+
+		slurm_mutex_lock(&rpc_persist_mutex);
+		for (i = 1; i < nfds; i++) {
+			if (!fds[i].revents)
+				continue;
+			pconn = cmap[i];
+			if (!(fds[i].revents & POLLIN)) {
+				pconn->dead = true;
+				continue;
+			}
+			pconn->busy = true;
+			slurm_mutex_lock(&rpc_queue_mutex);
+			if (rpc_persist_queue && !rpc_pool_shutdown) {
+				list_enqueue(rpc_persist_queue, pconn);
+				slurm_cond_signal(&rpc_queue_cond);
+			} else	/* nothing left to service it */
+				pconn->busy = false;
+			slurm_mutex_unlock(&rpc_queue_mutex);
+		}
+		slurm_mutex_unlock(&rpc_persist_mutex);
+	}
+
+	slurm_mutex_lock(&rpc_persist_mutex);
+	itr = list_iterator_create(rpc_persist_conns);
+	while ((pconn = list_next(itr))) {
+		if (!pconn->busy) {
+			slurm_persist_conn_destroy(pconn->conn);
+			list_remove(itr);
+			xfree(pconn);
+		}
+	}
+	list_iterator_destroy(itr);
+	slurm_mutex_unlock(&rpc_persist_mutex);
+	xfree(fds);
+	xfree(cmap);
+	return NULL;
+}
+
+/*
+ * Register a long-lived slurmd RPC connection (PERSIST_TYPE_RPC) to be
+ * serviced by the RPC worker pool. Called from the REQUEST_PERSIST_INIT
+ * handler; on success the connection belongs to the poller.
+ */
+extern int slurmctld_rpc_conn_add(slurm_persist_conn_t *persist_conn,
+				  char **comment)
+{
+	rpc_persist_conn_t *pconn;
+
+	slurm_mutex_lock(&rpc_persist_mutex);
+	if (!rpc_persist_conns) {
+		if (pipe(rpc_persist_pipe) < 0) {
+			slurm_mutex_unlock(&rpc_persist_mutex);
+			error("%s: pipe: %m", __func__);
+			*comment = xstrdup("unable to create poller pipe");
+			return SLURM_ERROR;
+		}
+		fd_set_nonblocking(rpc_persist_pipe[0]);
+		fd_set_nonblocking(rpc_persist_pipe[1]);
+		fd_set_close_on_exec(rpc_persist_pipe[0]);
+		fd_set_close_on_exec(rpc_persist_pipe[1]);
+		rpc_persist_conns = list_create(NULL);
+		slurm_thread_create_detached(NULL, _rpc_persist_poller, NULL);
+	}
+	persist_conn->flags |= PERSIST_FLAG_ALREADY_INITED;
+	/* Bound reads so a stalled sender can not pin a pool worker */
+	persist_conn->timeout = slurm_get_msg_timeout() * 1000;
+	pconn = xmalloc(sizeof(rpc_persist_conn_t));
+	pconn->conn = persist_conn;
+	list_append(rpc_persist_conns, pconn);
+	slurm_mutex_unlock(&rpc_persist_mutex);
+	_rpc_persist_wake();
+
+	return SLURM_SUCCESS;
 }
 
 /* Increment slurmctld_config.server_thread_count and don't return
@@ -1874,6 +2326,21 @@ static void _queue_reboot_msg(void)
 	}
 }
 
+/* Track a node address resolution thread already in progress */
+static bool node_addrs_resolving = false;
+
+/*
+ * Resolve the addresses of all configured nodes into the cache used by
+ * agent and forwarding threads. Run in a separate thread since a slow or
+ * dead DNS server could otherwise stall background processing.
+ */
+static void *_node_addrs_thread(void *no_data)
+{
+	slurm_conf_prime_node_addrs(true);
+	node_addrs_resolving = false;
+	return NULL;
+}
+
 /*
  * _slurmctld_background - process slurmctld background activities
  *	purge defunct job records, save state, schedule jobs, and
@@ -1899,6 +2366,7 @@ static void *_slurmctld_background(void *no_data)
 	static time_t last_node_acct;
 	static time_t last_ctld_bu_ping;
 	static time_t last_uid_update;
+	static time_t last_node_addrs_time = (time_t) 0;
 	static time_t last_reboot_msg_time;
 	time_t now;
 	int no_resp_msg_interval, ping_interval, purge_job_interval;
@@ -2143,6 +2611,8 @@ static void *_slurmctld_background(void *no_data)
 			load_part_uid_allow_list(slurmctld_conf.group_force);
 			unlock_slurmctld(part_write_lock);
 			group_cache_cleanup();
+			(void) uid_cache_state_save(
+				slurmctld_conf.state_save_location);
 		}
 
 		if (difftime(now, last_purge_job_time) >= purge_job_interval) {
@@ -2259,6 +2729,22 @@ static void *_slurmctld_background(void *no_data)
 		}
 		unlock_slurmctld(config_read_lock);
 
+		if (!node_addrs_resolving &&
+		    (difftime(now, last_node_addrs_time) >=
+		     PERIODIC_NODE_ADDRS)) {
+			/*
+			 * Resolve all node addresses into the cache so
+			 * communication paths need not call the resolver.
+			 * Runs immediately on startup since
+			 * last_node_addrs_time is initialized to zero.
+			 */
+			now = time(NULL);
+			last_node_addrs_time = now;
+			node_addrs_resolving = true;
+			slurm_thread_create_detached(NULL, _node_addrs_thread,
+						     NULL);
+		}
+
 		if (difftime(now, last_uid_update) >= 3600) {
 			/*
 			 * Make sure we update the uids in the
@@ -2880,6 +3366,13 @@ void update_logging(void)
 			      (int) slurm_user_id, (int) slurm_user_gid);
 		}
 	}
+
+	/*
+	 * Defer logfile writes to a dedicated thread so RPC and scheduler
+	 * threads do not block on disk I/O with high debug levels in use.
+	 */
+	log_set_async(xstrcasestr(slurmctld_conf.slurmctld_params,
+				  "async_logging") && !test_config);
 }
 
 /* Reset slurmd nice value */
@@ -3339,6 +3832,63 @@ static void  _set_work_dir(void)
 	}
 }
 
+/*
+ * _prefetch_group_cache - warm the group cache for the users of all
+ * active jobs recovered from the state save. This runs the name service
+ * queries in one background thread so the first credential requests
+ * after a failover or restart are served from cache.
+ */
+static void _prefetch_group_cache(void)
+{
+	/* Locks: Read job */
+	slurmctld_lock_t job_read_lock = {
+		NO_LOCK, READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
+	group_cache_user_t *users = NULL;
+	int user_cnt = 0, user_size = 0;
+	uid_t *uids;
+	ListIterator job_iterator;
+	struct job_record *job_ptr;
+
+	lock_slurmctld(job_read_lock);
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = list_next(job_iterator))) {
+		int i;
+
+		if (IS_JOB_FINISHED(job_ptr))
+			continue;
+
+		for (i = 0; i < user_cnt; i++) {
+			if ((users[i].uid == job_ptr->user_id) &&
+			    (users[i].gid == job_ptr->group_id))
+				break;
+		}
+		if (i < user_cnt)	/* already have this user */
+			continue;
+
+		if (user_cnt >= user_size) {
+			user_size = MAX(user_size * 2, 64);
+			xrecalloc(users, user_size,
+				  sizeof(group_cache_user_t));
+		}
+		users[user_cnt].uid = job_ptr->user_id;
+		users[user_cnt].gid = job_ptr->group_id;
+		user_cnt++;
+	}
+	list_iterator_destroy(job_iterator);
+	unlock_slurmctld(job_read_lock);
+
+	if (user_cnt) {
+		uids = xmalloc(sizeof(uid_t) * user_cnt);
+		for (int i = 0; i < user_cnt; i++)
+			uids[i] = users[i].uid;
+		/* hands off ownership of uids[] */
+		uid_cache_warm(uids, user_cnt);
+	}
+
+	/* hands off ownership of users[] */
+	group_cache_prefetch(users, user_cnt);
+}
+
 /*
  * _purge_files_thread - separate thread to remove job batch/environ files
  * from the state directory. Runs async from purge_old_jobs to avoid
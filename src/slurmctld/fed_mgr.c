@@ -2196,6 +2196,112 @@ static void *_fed_job_update_thread(void *arg)
 	return NULL;
 }
 
+/*
+ * Drain the pending RPC queue for a single sibling cluster by issuing one
+ * combined RPC. Run in a separate thread per sibling so that a slow or
+ * unresponsive sibling only delays its own queue rather than every cluster
+ * in the federation.
+ */
+static void *_agent_queue_send(void *arg)
+{
+	slurmdb_cluster_rec_t *cluster = (slurmdb_cluster_rec_t *) arg;
+	time_t now = time(NULL);
+	ListIterator rpc_iter;
+	agent_queue_t *rpc_rec;
+	slurm_msg_t req_msg, resp_msg;
+	ctld_list_msg_t ctld_req_msg;
+	bitstr_t *success_bits;
+	int rc, resp_inx, success_size;
+
+	/* Move currently pending RPCs to new list */
+	ctld_req_msg.my_list = NULL;
+	rpc_iter = list_iterator_create(cluster->send_rpc);
+	while ((rpc_rec = list_next(rpc_iter))) {
+		if ((rpc_rec->last_try + rpc_rec->last_defer) >= now)
+			continue;
+		if (!ctld_req_msg.my_list)
+			ctld_req_msg.my_list = list_create(NULL);
+		list_append(ctld_req_msg.my_list, rpc_rec->buffer);
+		rpc_rec->last_try = now;
+		if (rpc_rec->last_defer == 128) {
+			info("%s: %s JobId=%u request to cluster %s is repeatedly failing",
+			     __func__, rpc_num2string(rpc_rec->msg_type),
+			     rpc_rec->job_id, cluster->name);
+			rpc_rec->last_defer *= 2;
+		} else if (rpc_rec->last_defer)
+			rpc_rec->last_defer *= 2;
+		else
+			rpc_rec->last_defer = 2;
+	}
+	list_iterator_destroy(rpc_iter);
+	if (!ctld_req_msg.my_list)
+		return NULL;
+
+	/* Build, pack and send the combined RPC */
+	slurm_msg_t_init(&req_msg);
+	req_msg.msg_type = REQUEST_CTLD_MULT_MSG;
+	req_msg.data     = &ctld_req_msg;
+	rc = _send_recv_msg(cluster, &req_msg, &resp_msg, false);
+
+	/* Process the response */
+	if ((rc == SLURM_SUCCESS) &&
+	    (resp_msg.msg_type == RESPONSE_CTLD_MULT_MSG)) {
+		/* Remove successfully processed RPCs */
+		resp_inx = 0;
+		success_bits = _parse_resp_ctld_mult(&resp_msg);
+		success_size = bit_size(success_bits);
+		rpc_iter = list_iterator_create(cluster->send_rpc);
+		while ((rpc_rec = list_next(rpc_iter))) {
+			if (rpc_rec->last_try != now)
+				continue;
+			if (resp_inx >= success_size) {
+				error("%s: bitmap too small (%d >= %d)",
+				      __func__, resp_inx, success_size);
+				break;
+			}
+			if (bit_test(success_bits, resp_inx++))
+				list_delete_item(rpc_iter);
+		}
+		list_iterator_destroy(rpc_iter);
+		FREE_NULL_BITMAP(success_bits);
+	} else {
+		/* Failed to process combined RPC.
+		 * Leave all RPCs on the queue. */
+		if (rc != SLURM_SUCCESS) {
+			if (_comm_fail_log(cluster)) {
+				error("%s: Failed to send RPC: %s",
+				      __func__, slurm_strerror(rc));
+			} else {
+				debug("%s: Failed to send RPC: %s",
+				      __func__, slurm_strerror(rc));
+			}
+		} else if (resp_msg.msg_type == PERSIST_RC) {
+			persist_rc_msg_t *msg;
+			char *err_str;
+			msg = resp_msg.data;
+			if (msg->comment)
+				err_str = msg->comment;
+			else
+				err_str = slurm_strerror(msg->rc);
+			error("%s: failed to process msg: %s",
+			      __func__, err_str);
+		} else if (resp_msg.msg_type == RESPONSE_SLURM_RC) {
+			rc = slurm_get_return_code(resp_msg.msg_type,
+						   resp_msg.data);
+			error("%s: failed to process msg: %s",
+			      __func__, slurm_strerror(rc));
+		} else {
+			error("%s: Invalid response msg_type: %u",
+			      __func__, resp_msg.msg_type);
+		}
+	}
+	(void) slurm_free_msg_data(resp_msg.msg_type, resp_msg.data);
+
+	list_destroy(ctld_req_msg.my_list);
+
+	return NULL;
+}
+
 /* Start a thread to manage queued agent requests */
 static void *_agent_thread(void *arg)
 {
@@ -2203,10 +2309,8 @@ static void *_agent_thread(void *arg)
 	struct timespec ts = {0, 0};
 	ListIterator cluster_iter, rpc_iter;
 	agent_queue_t *rpc_rec;
-	slurm_msg_t req_msg, resp_msg;
-	ctld_list_msg_t ctld_req_msg;
-	bitstr_t *success_bits;
-	int rc, resp_inx, success_size;
+	pthread_t *tids;
+	int i, thread_cnt;
 
 	slurmctld_lock_t fed_read_lock = {
 		NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK, READ_LOCK };
@@ -2235,115 +2339,30 @@ static void *_agent_thread(void *arg)
 			continue;
 		}
 
-		/* Look for work on each cluster */
+		/*
+		 * Look for work on each cluster. Drain each sibling in a
+		 * separate thread so that one pass takes the time of the
+		 * slowest sibling rather than the sum of all of them.
+		 */
+		thread_cnt = 0;
+		tids = xcalloc(list_count(fed_mgr_fed_rec->cluster_list),
+			       sizeof(pthread_t));
 		cluster_iter = list_iterator_create(
 					fed_mgr_fed_rec->cluster_list);
 		while (!slurmctld_config.shutdown_time &&
 		       (cluster = list_next(cluster_iter))) {
-			time_t now = time(NULL);
 			if ((cluster->send_rpc == NULL) ||
 			   (list_count(cluster->send_rpc) == 0))
 				continue;
 
-			/* Move currently pending RPCs to new list */
-			ctld_req_msg.my_list = NULL;
-			rpc_iter = list_iterator_create(cluster->send_rpc);
-			while ((rpc_rec = list_next(rpc_iter))) {
-				if ((rpc_rec->last_try + rpc_rec->last_defer) >=
-				    now)
-					continue;
-				if (!ctld_req_msg.my_list)
-					ctld_req_msg.my_list =list_create(NULL);
-				list_append(ctld_req_msg.my_list,
-					    rpc_rec->buffer);
-				rpc_rec->last_try = now;
-				if (rpc_rec->last_defer == 128) {
-					info("%s: %s JobId=%u request to cluster %s is repeatedly failing",
-					     __func__,
-					     rpc_num2string(rpc_rec->msg_type),
-					     rpc_rec->job_id, cluster->name);
-					rpc_rec->last_defer *= 2;
-				} else if (rpc_rec->last_defer)
-					rpc_rec->last_defer *= 2;
-				else
-					rpc_rec->last_defer = 2;
-			}
-			list_iterator_destroy(rpc_iter);
-			if (!ctld_req_msg.my_list)
-				continue;
-
-			/* Build, pack and send the combined RPC */
-			slurm_msg_t_init(&req_msg);
-			req_msg.msg_type = REQUEST_CTLD_MULT_MSG;
-			req_msg.data     = &ctld_req_msg;
-			rc = _send_recv_msg(cluster, &req_msg, &resp_msg,
-					    false);
-
-			/* Process the response */
-			if ((rc == SLURM_SUCCESS) &&
-			    (resp_msg.msg_type == RESPONSE_CTLD_MULT_MSG)) {
-				/* Remove successfully processed RPCs */
-				resp_inx = 0;
-				success_bits = _parse_resp_ctld_mult(&resp_msg);
-				success_size = bit_size(success_bits);
-				rpc_iter = list_iterator_create(cluster->
-								send_rpc);
-				while ((rpc_rec = list_next(rpc_iter))) {
-					if (rpc_rec->last_try != now)
-						continue;
-					if (resp_inx >= success_size) {
-						error("%s: bitmap too small (%d >= %d)",
-						      __func__, resp_inx,
-						      success_size);
-						break;
-					}
-					if (bit_test(success_bits, resp_inx++))
-						list_delete_item(rpc_iter);
-				}
-				list_iterator_destroy(rpc_iter);
-				FREE_NULL_BITMAP(success_bits);
-			} else {
-				/* Failed to process combined RPC.
-				 * Leave all RPCs on the queue. */
-				if (rc != SLURM_SUCCESS) {
-					if (_comm_fail_log(cluster)) {
-						error("%s: Failed to send RPC: %s",
-						      __func__,
-						      slurm_strerror(rc));
-					} else {
-						debug("%s: Failed to send RPC: %s",
-						      __func__,
-						      slurm_strerror(rc));
-					}
-				} else if (resp_msg.msg_type ==
-					   PERSIST_RC) {
-					persist_rc_msg_t *msg;
-					char *err_str;
-					msg = resp_msg.data;
-					if (msg->comment)
-						err_str = msg->comment;
-					else
-						err_str=slurm_strerror(msg->rc);
-					error("%s: failed to process msg: %s",
-					      __func__, err_str);
-				} else if (resp_msg.msg_type ==
-					   RESPONSE_SLURM_RC) {
-					rc = slurm_get_return_code(
-						resp_msg.msg_type,
-						resp_msg.data);
-					error("%s: failed to process msg: %s",
-					      __func__, slurm_strerror(rc));
-				} else {
-					error("%s: Invalid response msg_type: %u",
-					      __func__, resp_msg.msg_type);
-				}
-			}
-			(void) slurm_free_msg_data(resp_msg.msg_type,
-						   resp_msg.data);
-
-			list_destroy(ctld_req_msg.my_list);
+			slurm_thread_create(&tids[thread_cnt],
+					    _agent_queue_send, cluster);
+			thread_cnt++;
 		}
 		list_iterator_destroy(cluster_iter);
+		for (i = 0; i < thread_cnt; i++)
+			pthread_join(tids[i], NULL);
+		xfree(tids);
 
 		unlock_slurmctld(fed_read_lock);
 	}
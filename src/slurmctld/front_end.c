@@ -394,17 +394,22 @@ extern void log_front_end_state(void)
 #endif
 }
 
-/*
- * purge_front_end_state - purge all front end node state
- */
-extern void purge_front_end_state(void)
-{
 #ifdef HAVE_FRONT_END
+/* Holder for a detached front end node table handed to the
+ * xfree_deferred() reaper */
+typedef struct {
+	front_end_record_t *node_table;
+	uint16_t record_count;
+} old_front_end_state_t;
+
+static void _free_old_front_end_state(void *x)
+{
+	old_front_end_state_t *old_state = x;
 	front_end_record_t *front_end_ptr;
 	int i;
 
-	for (i = 0, front_end_ptr = front_end_nodes;
-	     i < front_end_node_cnt; i++, front_end_ptr++) {
+	for (i = 0, front_end_ptr = old_state->node_table;
+	     i < old_state->record_count; i++, front_end_ptr++) {
 		xassert(front_end_ptr->magic == FRONT_END_MAGIC);
 		xfree(front_end_ptr->allow_gids);
 		xfree(front_end_ptr->allow_groups);
@@ -418,8 +423,31 @@ extern void purge_front_end_state(void)
 		xfree(front_end_ptr->reason);
 		xfree(front_end_ptr->version);
 	}
-	xfree(front_end_nodes);
+	xfree(old_state->node_table);
+	xfree(old_state);
+}
+#endif
+
+/*
+ * purge_front_end_state - purge all front end node state
+ */
+extern void purge_front_end_state(void)
+{
+#ifdef HAVE_FRONT_END
+	old_front_end_state_t *old_state;
+
+	if (!front_end_nodes) {
+		front_end_node_cnt = 0;
+		return;
+	}
+
+	/* Detach the table and release its memory on the reaper thread */
+	old_state = xmalloc(sizeof(old_front_end_state_t));
+	old_state->node_table = front_end_nodes;
+	old_state->record_count = front_end_node_cnt;
+	front_end_nodes = NULL;
 	front_end_node_cnt = 0;
+	xfree_deferred(old_state, _free_old_front_end_state);
 #endif
 }
 
@@ -89,6 +89,7 @@ struct gs_job {
 	struct job_record *job_ptr;
 	uint16_t sig_state;
 	uint16_t row_state;
+	struct gs_job *hash_next;
 };
 
 struct gs_part {
@@ -97,6 +98,7 @@ struct gs_part {
 	uint32_t num_jobs;
 	struct gs_job **job_list;
 	uint32_t job_list_size;
+	struct gs_job **job_hash; /* job_list entries hashed by job_id */
 	uint32_t num_shadows;
 	struct gs_job **shadow;  /* see '"Shadow" Design' below */
 	uint32_t shadow_size;
@@ -149,6 +151,8 @@ static uint16_t gr_type = GS_NODE;
 static uint16_t gs_fast_schedule = 0;
 static List gs_part_list = NULL;
 static uint32_t default_job_list_size = 64;
+#define GS_JOB_HASH_SIZE 128
+#define GS_JOB_HASH_INX(_job_id) ((_job_id) % GS_JOB_HASH_SIZE)
 static pthread_mutex_t data_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static uint16_t *gs_bits_per_node = NULL;
@@ -326,6 +330,7 @@ static void _destroy_parts(void *x)
 	FREE_NULL_BITMAP(gs_part_ptr->active_resmap);
 	xfree(gs_part_ptr->active_cpus);
 	xfree(gs_part_ptr->job_list);
+	xfree(gs_part_ptr->job_hash);
 	xfree(gs_part_ptr);
 }
 
@@ -370,10 +375,54 @@ static int _find_gs_part(void *x, void *key)
 	return 0;
 }
 
+/* Find the gs_job record of the given job_id in the given partition.
+ * The hash makes a miss (the common case when scanning the master
+ * job_list) constant time instead of a walk of every tracked job. */
+static struct gs_job *_find_gs_job(struct gs_part *p_ptr, uint32_t job_id)
+{
+	struct gs_job *j_ptr;
+
+	if (!p_ptr->job_hash)
+		return NULL;
+	j_ptr = p_ptr->job_hash[GS_JOB_HASH_INX(job_id)];
+	while (j_ptr && (j_ptr->job_id != job_id))
+		j_ptr = j_ptr->hash_next;
+	return j_ptr;
+}
+
+static void _gs_job_hash_add(struct gs_part *p_ptr, struct gs_job *j_ptr)
+{
+	int inx = GS_JOB_HASH_INX(j_ptr->job_id);
+
+	if (!p_ptr->job_hash) {
+		p_ptr->job_hash = xmalloc(GS_JOB_HASH_SIZE *
+					  sizeof(struct gs_job *));
+	}
+	j_ptr->hash_next = p_ptr->job_hash[inx];
+	p_ptr->job_hash[inx] = j_ptr;
+}
+
+static void _gs_job_hash_rm(struct gs_part *p_ptr, struct gs_job *j_ptr)
+{
+	struct gs_job **pprev;
+
+	if (!p_ptr->job_hash)
+		return;
+	pprev = &p_ptr->job_hash[GS_JOB_HASH_INX(j_ptr->job_id)];
+	while (*pprev && (*pprev != j_ptr))
+		pprev = &(*pprev)->hash_next;
+	if (*pprev)
+		*pprev = j_ptr->hash_next;
+	j_ptr->hash_next = NULL;
+}
+
 /* Find the job_list index of the given job_id in the given partition */
 static int _find_job_index(struct gs_part *p_ptr, uint32_t job_id)
 {
 	int i;
+
+	if (!_find_gs_job(p_ptr, job_id))
+		return -1;
 	for (i = 0; i < p_ptr->num_jobs; i++) {
 		if (p_ptr->job_list[i]->job_ptr->job_id == job_id)
 			return i;
@@ -937,6 +986,8 @@ static void _remove_job_from_part(uint32_t job_id, struct gs_part *p_ptr,
 	/* remove any shadow first */
 	_clear_shadow(j_ptr);
 
+	_gs_job_hash_rm(p_ptr, j_ptr);
+
 	/* remove the job from the job_list by shifting everyone else down */
 	p_ptr->num_jobs--;
 	for (; i < p_ptr->num_jobs; i++) {
@@ -966,7 +1017,6 @@ static void _remove_job_from_part(uint32_t job_id, struct gs_part *p_ptr,
 static uint16_t _add_job_to_part(struct gs_part *p_ptr,
 				 struct job_record *job_ptr)
 {
-	int i;
 	struct gs_job *j_ptr;
 	uint16_t preempt_mode;
 
@@ -990,8 +1040,7 @@ static uint16_t _add_job_to_part(struct gs_part *p_ptr,
 	}
 
 	/* protect against duplicates */
-	i = _find_job_index(p_ptr, job_ptr->job_id);
-	if (i >= 0) {
+	if (_find_gs_job(p_ptr, job_ptr->job_id)) {
 		/* This job already exists, but the resource allocation
 		 * may have changed. In any case, remove the existing
 		 * job before adding this new one.
@@ -1021,6 +1070,7 @@ static uint16_t _add_job_to_part(struct gs_part *p_ptr,
 
 	/* append this job to the job_list */
 	p_ptr->job_list[p_ptr->num_jobs++] = j_ptr;
+	_gs_job_hash_add(p_ptr, j_ptr);
 
 	/* determine the immediate fate of this job (run or suspend) */
 	if (!IS_JOB_SUSPENDED(job_ptr) &&
@@ -1067,7 +1117,6 @@ static void _scan_slurm_job_list(void)
 {
 	struct job_record *job_ptr;
 	struct gs_part *p_ptr;
-	int i;
 	ListIterator job_iterator;
 	char *part_name;
 
@@ -1100,8 +1149,8 @@ static void _scan_slurm_job_list(void)
 						part_name);
 			if (!p_ptr) /* no partition */
 				continue;
-			i = _find_job_index(p_ptr, job_ptr->job_id);
-			if (i >= 0) /* we're tracking it, so continue */
+			if (_find_gs_job(p_ptr, job_ptr->job_id))
+				/* we're tracking it, so continue */
 				continue;
 
 			/* We're not tracking this job. Resume it if it's
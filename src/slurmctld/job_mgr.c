@@ -53,6 +53,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <sys/param.h>
 #include <unistd.h>
@@ -79,6 +80,7 @@
 #include "src/common/switch.h"
 #include "src/common/timers.h"
 #include "src/common/track_script.h"
+#include "src/common/uid.h"
 #include "src/common/tres_bind.h"
 #include "src/common/tres_frequency.h"
 #include "src/common/xassert.h"
@@ -116,6 +118,16 @@
 #define JOB_ARRAY_HASH_INX(_job_id, _task_id) \
 	((_job_id + _task_id) % hash_table_size)
 
+/*
+ * The job hash tables are striped across JOB_HASH_SHARDS rwlocks so that
+ * hash insert/delete and chain walks are internally consistent without the
+ * global job lock. Lookups which only need to map a job ID to a record
+ * (e.g. REQUEST_JOB_INFO_SINGLE fast paths) can then run concurrently with
+ * each other. Must be a power of two.
+ */
+#define JOB_HASH_SHARDS	64
+#define JOB_HASH_SHARD(_inx)	((_inx) & (JOB_HASH_SHARDS - 1))
+
 /* No need to change we always pack SLURM_PROTOCOL_VERSION */
 #define JOB_STATE_VERSION     "PROTOCOL_VERSION"
 #define JOB_CKPT_VERSION      "PROTOCOL_VERSION"
@@ -135,6 +147,7 @@ typedef struct {
 
 typedef struct {
 	Buf       buffer;
+	Buf       delta_prev;
 	uint32_t  filter_uid;
 	uint32_t *jobs_packed;
 	uint16_t  protocol_version;
@@ -159,6 +172,8 @@ static uint32_t job_id_sequence = 0;	/* first job_id to assign new job */
 static struct   job_record **job_hash = NULL;
 static struct   job_record **job_array_hash_j = NULL;
 static struct   job_record **job_array_hash_t = NULL;
+static pthread_rwlock_t job_hash_lock[JOB_HASH_SHARDS];
+static bool     job_hash_lock_init = false;
 static bool     kill_invalid_dep;
 static time_t   last_file_write_time = (time_t) 0;
 static uint32_t max_array_size = NO_VAL;
@@ -169,6 +184,7 @@ static bool     validate_cfgd_licenses = true;
 /* Local functions */
 static void _add_job_hash(struct job_record *job_ptr);
 static void _add_job_array_hash(struct job_record *job_ptr);
+static void _add_split_meta_hash(struct job_record *job_ptr);
 static int  _checkpoint_job_record (struct job_record *job_ptr,
 				    char *image_dir);
 static void _clear_job_gres_details(struct job_record *job_ptr);
@@ -198,9 +214,12 @@ static void _job_array_comp(struct job_record *job_ptr, bool was_running,
 static int  _job_create(job_desc_msg_t * job_specs, int allocate, int will_run,
 			struct job_record **job_rec_ptr, uid_t submit_uid,
 			char **err_msg, uint16_t protocol_version);
+static uint32_t _job_rec_cksum(unsigned char *data, uint32_t len);
 static void _job_timed_out(struct job_record *job_ptr, bool preempted);
 static void _kill_dependent(struct job_record *job_ptr);
 static void _list_delete_job(void *job_entry);
+static void _unlink_job_record(struct job_record *job_ptr);
+static void _free_job_record(void *job_entry);
 static int  _list_find_job_old(void *job_entry, void *key);
 static int  _load_job_details(struct job_record *job_ptr, Buf buffer,
 			      uint16_t protocol_version);
@@ -215,7 +234,7 @@ static Buf  _open_job_state_file(char **state_file);
 static time_t _get_last_job_state_write_time(void);
 static void _pack_job_for_ckpt (struct job_record *job_ptr, Buf buffer);
 static void _pack_default_job_details(struct job_record *job_ptr,
-				      Buf buffer,
+				      uint16_t show_flags, Buf buffer,
 				      uint16_t protocol_version);
 static void _pack_pending_job_details(struct job_details *detail_ptr,
 				      Buf buffer,
@@ -639,6 +658,9 @@ static void _delete_job_details(struct job_record *job_entry)
 		uint32_t *job_id = xmalloc(sizeof(uint32_t));
 		*job_id = job_entry->job_id;
 		list_enqueue(purge_files_list, job_id);
+		slurm_mutex_lock(&purge_thread_lock);
+		slurm_cond_signal(&purge_thread_cond);
+		slurm_mutex_unlock(&purge_thread_lock);
 	}
 
 	xfree(job_entry->details->acctg_freq);
@@ -790,6 +812,24 @@ static slurmdb_qos_rec_t *_determine_and_validate_qos(
 	return qos_ptr;
 }
 
+/*
+ * FNV-1a checksum over one packed job record. Each record in the job
+ * state file is framed by its length and this checksum so that restore
+ * can skip a corrupted record and recover the jobs that follow it
+ * rather than discarding the remainder of the file.
+ */
+static uint32_t _job_rec_cksum(unsigned char *data, uint32_t len)
+{
+	uint32_t cksum = 2166136261u;
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		cksum ^= data[i];
+		cksum *= 16777619u;
+	}
+	return cksum;
+}
+
 /*
  * dump_all_job_state - save the state of all jobs to file for checkpoint
  *	Changes here should be reflected in load_last_job_id() and
@@ -811,6 +851,7 @@ int dump_all_job_state(void)
 	Buf buffer = init_buf(high_buffer_size);
 	time_t now = time(NULL);
 	time_t last_state_file_time;
+	uint32_t start_offset, end_offset, rec_len;
 	DEF_TIMERS;
 
 	START_TIMER;
@@ -848,11 +889,56 @@ int dump_all_job_state(void)
 	debug3("Writing job id %u to header record of job_state file",
 	       job_id_sequence);
 
-	/* write individual job records */
+	/*
+	 * Write individual job records, each framed by its packed length
+	 * and an FNV-1a checksum so load_all_job_state() can isolate a
+	 * corrupted record instead of failing the whole file. Finished
+	 * jobs are typically the bulk of a large job_list and no longer
+	 * change, so their framed image is cached on first dump and
+	 * appended as raw bytes on subsequent dumps. Any update to a
+	 * finished record must call job_state_cache_clear() to force a
+	 * re-pack.
+	 */
 	lock_slurmctld(job_read_lock);
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
+		if (job_ptr->state_cache) {
+			uint32_t len = job_ptr->state_cache_len;
+			if (remaining_buf(buffer) < len)
+				grow_buf(buffer, MAX(BUF_SIZE, len));
+			memcpy(get_buf_data(buffer) + get_buf_offset(buffer),
+			       job_ptr->state_cache, len);
+			set_buf_offset(buffer, get_buf_offset(buffer) + len);
+			continue;
+		}
+		start_offset = get_buf_offset(buffer);
+		pack32(0, buffer);	/* record length, set below */
+		pack32(0, buffer);	/* record checksum, set below */
 		_dump_job_state(job_ptr, buffer);
+		end_offset = get_buf_offset(buffer);
+		rec_len = end_offset - start_offset - (2 * sizeof(uint32_t));
+		set_buf_offset(buffer, start_offset);
+		pack32(rec_len, buffer);
+		pack32(_job_rec_cksum((unsigned char *)
+				      get_buf_data(buffer) +
+				      start_offset + (2 * sizeof(uint32_t)),
+				      rec_len), buffer);
+		set_buf_offset(buffer, end_offset);
+		/*
+		 * Do not cache until the record also has its db_index;
+		 * the slurmdbd agent may still set it after the job
+		 * finishes and it must land in the state file.
+		 */
+		if (IS_JOB_FINISHED(job_ptr) && job_ptr->db_index &&
+		    (job_ptr->db_index != NO_VAL64)) {
+			job_ptr->state_cache_len = get_buf_offset(buffer) -
+						   start_offset;
+			job_ptr->state_cache =
+				xmalloc(job_ptr->state_cache_len);
+			memcpy(job_ptr->state_cache,
+			       get_buf_data(buffer) + start_offset,
+			       job_ptr->state_cache_len);
+		}
 	}
 	list_iterator_destroy(job_iterator);
 
@@ -1058,11 +1144,12 @@ unpack_error:
 extern int load_all_job_state(void)
 {
 	int error_code = SLURM_SUCCESS;
-	int job_cnt = 0;
+	int job_cnt = 0, skip_cnt = 0;
 	char *state_file = NULL;
 	Buf buffer;
 	time_t buf_time;
 	uint32_t saved_job_id;
+	uint32_t rec_len, rec_cksum, rec_offset;
 	char *ver_str = NULL;
 	uint32_t ver_str_len;
 	uint16_t protocol_version = NO_VAL16;
@@ -1110,10 +1197,47 @@ extern int load_all_job_state(void)
 	 * into the _load_job_state function than any other option.
 	 */
 	while (remaining_buf(buffer) > 0) {
-		error_code = _load_job_state(buffer, protocol_version);
-		if (error_code != SLURM_SUCCESS)
-			goto unpack_error;
-		job_cnt++;
+		if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+			/*
+			 * Records are framed by length and checksum, so a
+			 * record which is corrupted or fails to unpack can
+			 * be skipped without losing the jobs behind it.
+			 */
+			safe_unpack32(&rec_len, buffer);
+			safe_unpack32(&rec_cksum, buffer);
+			if (rec_len > remaining_buf(buffer))
+				goto unpack_error;
+			rec_offset = get_buf_offset(buffer);
+			if (_job_rec_cksum((unsigned char *)
+					   get_buf_data(buffer) + rec_offset,
+					   rec_len) != rec_cksum) {
+				error("Job state record at offset %u fails its checksum, skipping record",
+				      rec_offset);
+				set_buf_offset(buffer, rec_offset + rec_len);
+				skip_cnt++;
+				continue;
+			}
+			if (_load_job_state(buffer, protocol_version) !=
+			    SLURM_SUCCESS) {
+				error("Could not unpack job state record at offset %u, skipping record",
+				      rec_offset);
+				skip_cnt++;
+			} else
+				job_cnt++;
+			/* Realign on the frame for the next record */
+			set_buf_offset(buffer, rec_offset + rec_len);
+		} else {
+			error_code = _load_job_state(buffer, protocol_version);
+			if (error_code != SLURM_SUCCESS)
+				goto unpack_error;
+			job_cnt++;
+		}
+	}
+	if (skip_cnt) {
+		if (!ignore_state_errors)
+			fatal("%d corrupted job state records, start with '-i' to ignore this",
+			      skip_cnt);
+		error("Skipped %d corrupted job state records", skip_cnt);
 	}
 	debug3("Set job_id_sequence to %u", job_id_sequence);
 
@@ -2182,6 +2306,9 @@ static int _load_job_state(Buf buffer, uint16_t protocol_version)
 
 	_add_job_hash(job_ptr);
 	_add_job_array_hash(job_ptr);
+	if (job_ptr->array_recs && (job_ptr->array_task_id == NO_VAL) &&
+	    (job_ptr->job_id != job_ptr->array_job_id))
+		_add_split_meta_hash(job_ptr);
 
 	memset(&assoc_rec, 0, sizeof(assoc_rec));
 
@@ -2632,8 +2759,10 @@ static void _add_job_hash(struct job_record *job_ptr)
 	int inx;
 
 	inx = JOB_HASH_INX(job_ptr->job_id);
+	slurm_rwlock_wrlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 	job_ptr->job_next = job_hash[inx];
 	job_hash[inx] = job_ptr;
+	slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 }
 
 /* _remove_job_hash - remove a job hash entry for given job record, job_id must
@@ -2646,27 +2775,31 @@ static void _remove_job_hash(struct job_record *job_entry,
 			     job_hash_type_t type)
 {
 	struct job_record *job_ptr, **job_pptr;
+	int inx;
 
 	xassert(job_entry);
 
 	switch (type) {
 	case JOB_HASH_JOB:
-		job_pptr = &job_hash[JOB_HASH_INX(job_entry->job_id)];
+		inx = JOB_HASH_INX(job_entry->job_id);
+		job_pptr = &job_hash[inx];
 		break;
 	case JOB_HASH_ARRAY_JOB:
-		job_pptr = &job_array_hash_j[
-			JOB_HASH_INX(job_entry->array_job_id)];
+		inx = JOB_HASH_INX(job_entry->array_job_id);
+		job_pptr = &job_array_hash_j[inx];
 		break;
 	case JOB_HASH_ARRAY_TASK:
-		job_pptr = &job_array_hash_t[
-			JOB_ARRAY_HASH_INX(job_entry->array_job_id,
-					   job_entry->array_task_id)];
+		inx = JOB_ARRAY_HASH_INX(job_entry->array_job_id,
+					 job_entry->array_task_id);
+		job_pptr = &job_array_hash_t[inx];
 		break;
 	default:
 		fatal("%s: unknown job_hash_type_t %d", __func__, type);
 		return;
 	}
 
+	slurm_rwlock_wrlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+
 	while ((job_pptr != NULL) && (*job_pptr != NULL) &&
 	       ((job_ptr = *job_pptr) != job_entry)) {
 		xassert(job_ptr->magic == JOB_MAGIC);
@@ -2700,6 +2833,7 @@ static void _remove_job_hash(struct job_record *job_entry,
 			      job_entry->array_task_id);
 			break;
 		}
+		slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 		return;
 	}
 
@@ -2717,6 +2851,8 @@ static void _remove_job_hash(struct job_record *job_entry,
 		job_entry->job_array_next_t = NULL;
 		break;
 	}
+
+	slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 }
 
 /* _add_job_array_hash - add a job hash entry for given job record,
@@ -2726,18 +2862,64 @@ static void _remove_job_hash(struct job_record *job_entry,
  */
 void _add_job_array_hash(struct job_record *job_ptr)
 {
+	struct job_record *scan_ptr;
 	int inx;
 
 	if (job_ptr->array_task_id == NO_VAL)
 		return;	/* Not a job array */
 
+	/* A record converted between meta and task forms may already be
+	 * present in either table, so guard against double insertion */
 	inx = JOB_HASH_INX(job_ptr->array_job_id);
-	job_ptr->job_array_next_j = job_array_hash_j[inx];
-	job_array_hash_j[inx] = job_ptr;
+	slurm_rwlock_wrlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+	for (scan_ptr = job_array_hash_j[inx]; scan_ptr;
+	     scan_ptr = scan_ptr->job_array_next_j) {
+		if (scan_ptr == job_ptr)
+			break;
+	}
+	if (!scan_ptr) {
+		job_ptr->job_array_next_j = job_array_hash_j[inx];
+		job_array_hash_j[inx] = job_ptr;
+	}
+	slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 
 	inx = JOB_ARRAY_HASH_INX(job_ptr->array_job_id,job_ptr->array_task_id);
-	job_ptr->job_array_next_t = job_array_hash_t[inx];
-	job_array_hash_t[inx] = job_ptr;
+	slurm_rwlock_wrlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+	for (scan_ptr = job_array_hash_t[inx]; scan_ptr;
+	     scan_ptr = scan_ptr->job_array_next_t) {
+		if (scan_ptr == job_ptr)
+			break;
+	}
+	if (!scan_ptr) {
+		job_ptr->job_array_next_t = job_array_hash_t[inx];
+		job_array_hash_t[inx] = job_ptr;
+	}
+	slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+}
+
+/* _add_split_meta_hash - add a meta record which does not hold the array's
+ *	base job ID to the job array hash table, so that array-wide
+ *	operations can still find it. The base meta record is reachable
+ *	through the regular job hash table instead.
+ * IN job_ptr - pointer to job record, array_job_id must already be set
+ */
+static void _add_split_meta_hash(struct job_record *job_ptr)
+{
+	struct job_record *scan_ptr;
+	int inx;
+
+	inx = JOB_HASH_INX(job_ptr->array_job_id);
+	slurm_rwlock_wrlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+	for (scan_ptr = job_array_hash_j[inx]; scan_ptr;
+	     scan_ptr = scan_ptr->job_array_next_j) {
+		if (scan_ptr == job_ptr)
+			break;
+	}
+	if (!scan_ptr) {
+		job_ptr->job_array_next_j = job_array_hash_j[inx];
+		job_array_hash_j[inx] = job_ptr;
+	}
+	slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 }
 
 /* For the job array data structure, build the string representation of the
@@ -2954,27 +3136,33 @@ extern struct job_record *find_job_array_rec(uint32_t array_job_id,
 			return job_ptr;
 
 		inx = JOB_HASH_INX(array_job_id);
+		slurm_rwlock_rdlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 		job_ptr = job_array_hash_j[inx];
 		while (job_ptr) {
 			if (job_ptr->array_job_id == array_job_id) {
 				match_job_ptr = job_ptr;
-				if (!IS_JOB_FINISHED(job_ptr)) {
-					return job_ptr;
-				}
+				if (!IS_JOB_FINISHED(job_ptr))
+					break;
 			}
 			job_ptr = job_ptr->job_array_next_j;
 		}
+		slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+		if (job_ptr)
+			return job_ptr;
 		return match_job_ptr;
 	} else {		/* Find specific task ID */
 		inx = JOB_ARRAY_HASH_INX(array_job_id, array_task_id);
+		slurm_rwlock_rdlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 		job_ptr = job_array_hash_t[inx];
 		while (job_ptr) {
 			if ((job_ptr->array_job_id == array_job_id) &&
-			    (job_ptr->array_task_id == array_task_id)) {
-				return job_ptr;
-			}
+			    (job_ptr->array_task_id == array_task_id))
+				break;
 			job_ptr = job_ptr->job_array_next_t;
 		}
+		slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+		if (job_ptr)
+			return job_ptr;
 		/* Look for job record with all of the pending tasks */
 		job_ptr = find_job_record(array_job_id);
 		if (job_ptr && job_ptr->array_recs &&
@@ -2986,7 +3174,24 @@ extern struct job_record *find_job_array_rec(uint32_t array_job_id,
 				return job_ptr;
 			}
 		}
-		return NULL;	/* None found */
+		/* Look for a meta record split out of the base record
+		 * which still holds this task */
+		inx = JOB_HASH_INX(array_job_id);
+		slurm_rwlock_rdlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+		job_ptr = job_array_hash_j[inx];
+		while (job_ptr) {
+			if ((job_ptr->array_job_id == array_job_id) &&
+			    job_ptr->array_recs &&
+			    job_ptr->array_recs->task_id_bitmap &&
+			    (array_task_id <
+			     bit_size(job_ptr->array_recs->task_id_bitmap)) &&
+			    bit_test(job_ptr->array_recs->task_id_bitmap,
+				     array_task_id))
+				break;
+			job_ptr = job_ptr->job_array_next_j;
+		}
+		slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+		return job_ptr;	/* NULL if none found */
 	}
 }
 
@@ -3002,12 +3207,7 @@ extern struct job_record *find_job_pack_record(uint32_t job_id,
 	struct job_record *pack_leader, *pack_job;
 	ListIterator iter;
 
-	pack_leader = job_hash[JOB_HASH_INX(job_id)];
-	while (pack_leader) {
-		if (pack_leader->job_id == job_id)
-			break;
-		pack_leader = pack_leader->job_next;
-	}
+	pack_leader = find_job_record(job_id);
 	if (!pack_leader)
 		return NULL;
 	if (pack_leader->pack_job_offset == pack_id)
@@ -3038,15 +3238,18 @@ extern struct job_record *find_job_pack_record(uint32_t job_id,
 extern struct job_record *find_job_record(uint32_t job_id)
 {
 	struct job_record *job_ptr;
+	int inx = JOB_HASH_INX(job_id);
 
-	job_ptr = job_hash[JOB_HASH_INX(job_id)];
+	slurm_rwlock_rdlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
+	job_ptr = job_hash[inx];
 	while (job_ptr) {
 		if (job_ptr->job_id == job_id)
-			return job_ptr;
+			break;
 		job_ptr = job_ptr->job_next;
 	}
+	slurm_rwlock_unlock(&job_hash_lock[JOB_HASH_SHARD(inx)]);
 
-	return NULL;
+	return job_ptr;
 }
 
 /* rebuild a job's partition name list based upon the contents of its
@@ -4136,6 +4339,12 @@ extern void rehash_jobs(void)
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
 	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
 
+	if (!job_hash_lock_init) {
+		for (int i = 0; i < JOB_HASH_SHARDS; i++)
+			slurm_rwlock_init(&job_hash_lock[i]);
+		job_hash_lock_init = true;
+	}
+
 	if (job_hash == NULL) {
 		hash_table_size = slurmctld_conf.max_job_cnt;
 		job_hash = xcalloc(hash_table_size,
@@ -4199,6 +4408,10 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	job_ptr_pend->db_flags = 0;
 	job_ptr_pend->step_list = save_step_list;
 	job_ptr_pend->db_index = save_db_index;
+	job_ptr_pend->state_cache = NULL;
+	job_ptr_pend->state_cache_len = 0;
+	job_ptr_pend->job_array_next_j = NULL;
+	job_ptr_pend->job_array_next_t = NULL;
 
 	job_ptr_pend->prio_factors = save_prio_factors;
 	slurm_copy_priority_factors_object(job_ptr_pend->prio_factors,
@@ -4258,6 +4471,11 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	_add_job_hash(job_ptr);		/* Sets job_next */
 	_add_job_hash(job_ptr_pend);	/* Sets job_next */
 	_add_job_array_hash(job_ptr);
+	if (job_ptr_pend->job_id != job_ptr_pend->array_job_id) {
+		/* The remaining tasks no longer ride on the array's base
+		 * job ID, keep the new meta record reachable */
+		_add_split_meta_hash(job_ptr_pend);
+	}
 	job_ptr_pend->job_resrcs = NULL;
 
 	job_ptr_pend->licenses = xstrdup(job_ptr->licenses);
@@ -4392,6 +4610,50 @@ extern struct job_record *job_array_split(struct job_record *job_ptr)
 	return job_ptr_pend;
 }
 
+/* Split the tasks of sel_bitmap out of a job array meta record into a
+ * new meta record of their own, leaving the remaining tasks behind, so
+ * that an operation on part of a pending array touches a single record
+ * rather than one per task.
+ * IN job_ptr - META job record for a job array. On return it holds only
+ *	the tasks of sel_bitmap.
+ * IN sel_bitmap - tasks to retain in job_ptr, must be a non-empty strict
+ *	subset of the record's task_id_bitmap.
+ * RET - The new META job record holding the remaining tasks (and the
+ *	original job ID), or NULL on error. */
+static struct job_record *_job_array_split_select(struct job_record *job_ptr,
+						  bitstr_t *sel_bitmap)
+{
+	struct job_record *meta_ptr;
+	uint32_t sel_cnt = bit_set_count(sel_bitmap);
+
+	job_ptr->array_task_id = bit_ffs(sel_bitmap);
+	meta_ptr = job_array_split(job_ptr);
+	if (!meta_ptr) {
+		job_ptr->array_task_id = NO_VAL;
+		return NULL;
+	}
+
+	/* job_array_split() turned job_ptr into a single task record,
+	 * rebuild it as the meta record owning all the selected tasks */
+	_remove_job_hash(job_ptr, JOB_HASH_ARRAY_TASK);
+	job_ptr->array_task_id = NO_VAL;
+	job_ptr->array_recs = xmalloc(sizeof(job_array_struct_t));
+	job_ptr->array_recs->task_id_bitmap = bit_copy(sel_bitmap);
+	job_ptr->array_recs->task_cnt = sel_cnt;
+	job_ptr->array_recs->array_flags = meta_ptr->array_recs->array_flags;
+	job_ptr->array_recs->max_run_tasks =
+		meta_ptr->array_recs->max_run_tasks;
+
+	/* Remove the remaining selected tasks from the original record,
+	 * the first one was already cleared by job_array_split() */
+	bit_and_not(meta_ptr->array_recs->task_id_bitmap, sel_bitmap);
+	xfree(meta_ptr->array_recs->task_id_str);
+	meta_ptr->array_recs->task_cnt =
+		bit_set_count(meta_ptr->array_recs->task_id_bitmap);
+
+	return meta_ptr;
+}
+
 /* Add job array data stucture to the job record */
 static void _create_job_array(struct job_record *job_ptr,
 			      job_desc_msg_t *job_specs)
@@ -4501,6 +4763,26 @@ static int _select_nodes_parts(struct job_record *job_ptr, bool test_only,
 				}
 			}
 
+			/*
+			 * Skip the full selection pass for a partition which
+			 * cannot possibly satisfy the request: fewer nodes
+			 * than the job requires or required nodes outside
+			 * the partition. select_nodes() would return the
+			 * same code after considerably more work, which
+			 * multiplies the latency for jobs submitted to many
+			 * partitions.
+			 */
+			if ((job_ptr->details->min_nodes >
+			     part_ptr->total_nodes) ||
+			    (job_ptr->details->req_node_bitmap &&
+			     !bit_super_set(job_ptr->details->req_node_bitmap,
+					    part_ptr->node_bitmap))) {
+				debug2("%pJ cannot be satisfied by partition %s, not attempting selection",
+				       job_ptr, part_ptr->name);
+				rc = ESLURM_REQUESTED_NODE_CONFIG_UNAVAILABLE;
+				continue;
+			}
+
 			if (part_limits_rc == WAIT_NO_REASON) {
 				rc = select_nodes(job_ptr, test_only,
 						  select_node_bitmap, err_msg,
@@ -5279,6 +5561,103 @@ static bool _get_whole_hetjob(void)
 	return whole_hetjob;
 }
 
+/*
+ * Signal the tasks of array_bitmap still held by a pending meta job
+ * record. For SIGKILL the tasks are cancelled in place by clearing them
+ * from the record's task bitmap, regardless of how many there are. The
+ * bits serviced here are cleared from array_bitmap, leaving only tasks
+ * which were previously split into records of their own.
+ */
+static int _signal_meta_tasks(struct job_record *job_ptr,
+			      bitstr_t **array_bitmap_ptr, uint16_t signal,
+			      uid_t uid, time_t now)
+{
+	bitstr_t *array_bitmap = *array_bitmap_ptr;
+	int len, rc = SLURM_SUCCESS;
+
+	if (!IS_JOB_PENDING(job_ptr) || !job_ptr->array_recs ||
+	    !job_ptr->array_recs->task_id_bitmap)
+		return SLURM_SUCCESS;
+
+	/* Ensure bitmap sizes match for AND operations */
+	len = bit_size(job_ptr->array_recs->task_id_bitmap);
+	if (bit_size(array_bitmap) < len) {
+		array_bitmap = bit_realloc(array_bitmap, len);
+		*array_bitmap_ptr = array_bitmap;
+	} else if (bit_size(array_bitmap) > len) {
+		job_ptr->array_recs->task_id_bitmap = bit_realloc(
+			job_ptr->array_recs->task_id_bitmap,
+			bit_size(array_bitmap));
+	}
+
+	if (!bit_overlap(job_ptr->array_recs->task_id_bitmap, array_bitmap))
+		return SLURM_SUCCESS;
+
+	if (signal == SIGKILL) {
+		uint32_t orig_task_cnt, new_task_count;
+		/* task_id_bitmap changes, so we need a copy of it */
+		bitstr_t *task_id_bitmap_orig =
+			bit_copy(job_ptr->array_recs->task_id_bitmap);
+
+		bit_and_not(job_ptr->array_recs->task_id_bitmap,
+			array_bitmap);
+		xfree(job_ptr->array_recs->task_id_str);
+		orig_task_cnt = job_ptr->array_recs->task_cnt;
+		new_task_count = bit_set_count(job_ptr->array_recs->
+					       task_id_bitmap);
+		if (!new_task_count) {
+			last_job_update		= now;
+			job_ptr->job_state	= JOB_CANCELLED;
+			job_ptr->start_time	= now;
+			job_ptr->end_time	= now;
+			job_ptr->requid		= uid;
+			srun_allocate_abort(job_ptr);
+			job_completion_logger(job_ptr, false);
+			/*
+			 * Master job record, even wihtout tasks,
+			 * counts as one job record
+			 */
+			job_count -= (orig_task_cnt - 1);
+		} else {
+			_job_array_comp(job_ptr, false, false);
+			job_count -= (orig_task_cnt - new_task_count);
+			/*
+			 * Since we are altering the job array's
+			 * task_cnt we must go alter this count in the
+			 * acct_policy code as if they are finishing
+			 * (accrue_cnt/job_submit etc...).
+			 */
+			if (job_ptr->array_recs->task_cnt >
+			    new_task_count) {
+				uint32_t tmp_state = job_ptr->job_state;
+				job_ptr->job_state = JOB_CANCELLED;
+
+				job_ptr->array_recs->task_cnt -=
+					new_task_count;
+				acct_policy_remove_job_submit(job_ptr);
+				job_ptr->bit_flags &= ~JOB_ACCRUE_OVER;
+				job_ptr->job_state = tmp_state;
+			}
+		}
+
+		/*
+		 * Set the task_cnt here since
+		 * job_completion_logger needs the total
+		 * pending count to handle the acct_policy
+		 * limit for submitted jobs correctly.
+		 */
+		job_ptr->array_recs->task_cnt = new_task_count;
+		bit_and_not(array_bitmap, task_id_bitmap_orig);
+		FREE_NULL_BITMAP(task_id_bitmap_orig);
+	} else {
+		bit_and_not(array_bitmap,
+			    job_ptr->array_recs->task_id_bitmap);
+		rc = ESLURM_TRANSITION_STATE_NO_UPDATE;
+	}
+
+	return rc;
+}
+
 /*
  * job_str_signal - signal the specified job
  * IN job_id_str - id of the job to be signaled, valid formats include "#"
@@ -5300,7 +5679,7 @@ extern int job_str_signal(char *job_id_str, uint16_t signal, uint16_t flags,
 	bitstr_t *array_bitmap = NULL;
 	bool valid = true;
 	int32_t i, i_first, i_last;
-	int rc = SLURM_SUCCESS, rc2, len;
+	int rc = SLURM_SUCCESS, rc2;
 
 	if (max_array_size == NO_VAL) {
 		max_array_size = slurmctld_conf.max_array_sz;
@@ -5472,79 +5851,19 @@ extern int job_str_signal(char *job_id_str, uint16_t signal, uint16_t flags,
 		goto endit;
 	}
 
-	if (IS_JOB_PENDING(job_ptr) &&
-	    job_ptr->array_recs && job_ptr->array_recs->task_id_bitmap) {
-		/* Ensure bitmap sizes match for AND operations */
-		len = bit_size(job_ptr->array_recs->task_id_bitmap);
-		i_last++;
-		if (i_last < len) {
-			array_bitmap = bit_realloc(array_bitmap, len);
-		} else {
-			array_bitmap = bit_realloc(array_bitmap, i_last);
-			job_ptr->array_recs->task_id_bitmap = bit_realloc(
-				job_ptr->array_recs->task_id_bitmap, i_last);
-		}
-		if (signal == SIGKILL) {
-			uint32_t orig_task_cnt, new_task_count;
-			/* task_id_bitmap changes, so we need a copy of it */
-			bitstr_t *task_id_bitmap_orig =
-				bit_copy(job_ptr->array_recs->task_id_bitmap);
-
-			bit_and_not(job_ptr->array_recs->task_id_bitmap,
-				array_bitmap);
-			xfree(job_ptr->array_recs->task_id_str);
-			orig_task_cnt = job_ptr->array_recs->task_cnt;
-			new_task_count = bit_set_count(job_ptr->array_recs->
-						       task_id_bitmap);
-			if (!new_task_count) {
-				last_job_update		= now;
-				job_ptr->job_state	= JOB_CANCELLED;
-				job_ptr->start_time	= now;
-				job_ptr->end_time	= now;
-				job_ptr->requid		= uid;
-				srun_allocate_abort(job_ptr);
-				job_completion_logger(job_ptr, false);
-				/*
-				 * Master job record, even wihtout tasks,
-				 * counts as one job record
-				 */
-				job_count -= (orig_task_cnt - 1);
-			} else {
-				_job_array_comp(job_ptr, false, false);
-				job_count -= (orig_task_cnt - new_task_count);
-				/*
-				 * Since we are altering the job array's
-				 * task_cnt we must go alter this count in the
-				 * acct_policy code as if they are finishing
-				 * (accrue_cnt/job_submit etc...).
-				 */
-				if (job_ptr->array_recs->task_cnt >
-				    new_task_count) {
-					uint32_t tmp_state = job_ptr->job_state;
-					job_ptr->job_state = JOB_CANCELLED;
-
-					job_ptr->array_recs->task_cnt -=
-						new_task_count;
-					acct_policy_remove_job_submit(job_ptr);
-					job_ptr->bit_flags &= ~JOB_ACCRUE_OVER;
-					job_ptr->job_state = tmp_state;
-				}
-			}
+	rc2 = _signal_meta_tasks(job_ptr, &array_bitmap, signal, uid, now);
+	rc = MAX(rc, rc2);
 
-			/*
-			 * Set the task_cnt here since
-			 * job_completion_logger needs the total
-			 * pending count to handle the acct_policy
-			 * limit for submitted jobs correctly.
-			 */
-			job_ptr->array_recs->task_cnt = new_task_count;
-			bit_and_not(array_bitmap, task_id_bitmap_orig);
-			FREE_NULL_BITMAP(task_id_bitmap_orig);
-		} else {
-			bit_and_not(array_bitmap,
-				    job_ptr->array_recs->task_id_bitmap);
-			rc = ESLURM_TRANSITION_STATE_NO_UPDATE;
+	/* Tasks may also be held by meta records split out of the
+	 * array's base record */
+	job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
+	while (job_ptr) {
+		if (job_ptr->array_job_id == job_id) {
+			rc2 = _signal_meta_tasks(job_ptr, &array_bitmap,
+						 signal, uid, now);
+			rc = MAX(rc, rc2);
 		}
+		job_ptr = job_ptr->job_array_next_j;
 	}
 
 	i_first = bit_ffs(array_bitmap);
@@ -5572,6 +5891,129 @@ endit:
 	return rc;
 }
 
+/* Append one job's result to a bulk signal response, growing the arrays
+ * as needed. Takes ownership of job_id_str. */
+static void _signal_jobs_resp_add(job_array_resp_msg_t *resp,
+				  uint32_t *resp_size,
+				  char *job_id_str, int rc)
+{
+	if (resp->job_array_count >= *resp_size) {
+		*resp_size = MAX(*resp_size * 2, 64);
+		xrealloc(resp->job_array_id, *resp_size * sizeof(char *));
+		xrealloc(resp->error_code, *resp_size * sizeof(uint32_t));
+	}
+	resp->job_array_id[resp->job_array_count] = job_id_str;
+	resp->error_code[resp->job_array_count] = rc;
+	resp->job_array_count++;
+}
+
+/*
+ * job_signal_jobs - signal every job named by or matching a bulk kill
+ *	request under the single lock acquisition of the caller and
+ *	respond with one aggregated per-job error code array
+ * IN kill_msg - explicit job ids and/or filters plus signal to deliver
+ * IN uid - uid of requesting user
+ * IN conn_fd - file descriptor on which to send reply
+ * IN protocol_version - slurm protocol version of client
+ * RET 0 on success, otherwise ESLURM error code
+ */
+extern int job_signal_jobs(kill_jobs_msg_t *kill_msg, uid_t uid, int conn_fd,
+			   uint16_t protocol_version)
+{
+	job_array_resp_msg_t *resp = NULL;
+	uint32_t resp_size = 0, i;
+	int rc = SLURM_SUCCESS, rc2;
+	slurm_msg_t resp_msg;
+	return_code_msg_t rc_msg;
+
+	resp = xmalloc(sizeof(job_array_resp_msg_t));
+
+	if (kill_msg->jobs_cnt) {
+		for (i = 0; i < kill_msg->jobs_cnt; i++) {
+			rc2 = job_str_signal(kill_msg->jobs_array[i],
+					     kill_msg->signal, kill_msg->flags,
+					     uid, false);
+			_signal_jobs_resp_add(resp, &resp_size,
+					      xstrdup(kill_msg->jobs_array[i]),
+					      rc2);
+		}
+	} else {
+		ListIterator job_iterator;
+		struct job_record *job_ptr;
+		uid_t filter_uid = NO_VAL;
+		bool is_operator = validate_operator(uid);
+
+		if (kill_msg->user_name &&
+		    (uid_from_string(kill_msg->user_name, &filter_uid) < 0)) {
+			rc = ESLURM_USER_ID_MISSING;
+			goto reply;
+		}
+
+		job_iterator = list_iterator_create(job_list);
+		while ((job_ptr = list_next(job_iterator))) {
+			char *job_id_str;
+
+			if (IS_JOB_FINISHED(job_ptr))
+				continue;
+			if ((filter_uid != NO_VAL) &&
+			    (job_ptr->user_id != filter_uid))
+				continue;
+			if (kill_msg->partition &&
+			    xstrcmp(kill_msg->partition, job_ptr->partition))
+				continue;
+			if ((kill_msg->job_state != NO_VAL) &&
+			    ((job_ptr->job_state & JOB_STATE_BASE) !=
+			     kill_msg->job_state))
+				continue;
+			/* Hetjob components die with their leader */
+			if (job_ptr->pack_job_id && !job_ptr->pack_job_list)
+				continue;
+
+			if ((job_ptr->user_id != uid) && !is_operator &&
+			    !assoc_mgr_is_user_acct_coord(acct_db_conn, uid,
+							  job_ptr->account))
+				rc2 = ESLURM_ACCESS_DENIED;
+			else if (job_ptr->pack_job_list)
+				rc2 = pack_job_signal(job_ptr,
+						      kill_msg->signal,
+						      kill_msg->flags, uid,
+						      false);
+			else
+				rc2 = job_signal(job_ptr, kill_msg->signal,
+						 kill_msg->flags, uid, false);
+
+			if (job_ptr->array_task_id != NO_VAL)
+				job_id_str = xstrdup_printf(
+					"%u_%u", job_ptr->array_job_id,
+					job_ptr->array_task_id);
+			else
+				job_id_str = xstrdup_printf(
+					"%u", job_ptr->job_id);
+			_signal_jobs_resp_add(resp, &resp_size, job_id_str,
+					      rc2);
+		}
+		list_iterator_destroy(job_iterator);
+		last_job_update = time(NULL);
+	}
+
+reply:
+	if (conn_fd >= 0) {
+		slurm_msg_t_init(&resp_msg);
+		resp_msg.protocol_version = protocol_version;
+		if (rc == SLURM_SUCCESS) {
+			resp_msg.msg_type = RESPONSE_JOB_ARRAY_ERRORS;
+			resp_msg.data     = resp;
+		} else {
+			resp_msg.msg_type  = RESPONSE_SLURM_RC;
+			rc_msg.return_code = rc;
+			resp_msg.data      = &rc_msg;
+		}
+		slurm_send_node_msg(conn_fd, &resp_msg);
+	}
+	slurm_free_job_array_resp(resp);
+	return rc;
+}
+
 static void
 _signal_batch_job(struct job_record *job_ptr, uint16_t signal, uint16_t flags)
 {
@@ -6890,6 +7332,7 @@ static int _job_create(job_desc_msg_t *job_desc, int allocate, int will_run,
 	job_ptr->part_ptr_list = part_ptr_list;
 	job_ptr->bit_flags |= JOB_DEPENDENT;
 	job_ptr->last_sched_eval = time(NULL);
+	(void) job_timing_stamp(&job_ptr->timing.submit);
 
 	part_ptr_list = NULL;
 	if ((error_code = checkpoint_alloc_jobinfo(&(job_ptr->check_job)))) {
@@ -8432,198 +8875,492 @@ static bool _pack_configuring_test(struct job_record *job_ptr)
 }
 
 /*
- * job_time_limit - terminate jobs which have exceeded their time limit
- * global: job_list - pointer global job list
- *	last_job_update - time of last job table update
+ * Timer wheel used by job_time_limit() for deadline driven enforcement.
+ *
+ * Running jobs are filed by the time of their next deadline driven
+ * event (time limit, warn signal, pending time limit mail, reservation
+ * end, step time limit) so the periodic pass only has to process the
+ * expired buckets instead of walking every running job under the job
+ * write lock. A full scan of job_list is still made when a test which
+ * is not deadline driven is in use (InactiveLimit, accounting limit
+ * enforcement), when node features change, and periodically as a
+ * safety net for any state change not reported through
+ * job_time_limit_register().
  */
-void job_time_limit(void)
+#define JOB_TIMER_BUCKETS	128
+#define JOB_TIMER_WIDTH		32	/* seconds covered per bucket */
+#define JOB_TIMER_RESYNC	(PERIODIC_TIMEOUT * 10)
+
+typedef struct {
+	time_t check_time;
+	uint32_t job_id;
+} job_timer_ent_t;
+
+static List job_timer_bucket[JOB_TIMER_BUCKETS];
+static List job_timer_overflow = NULL;
+static time_t job_timer_base = 0;	/* start of bucket zero */
+static time_t job_timer_rehome = 0;	/* next overflow list refile */
+static time_t job_timer_resync = 0;	/* next full job_list scan */
+
+static void _job_timer_ent_del(void *x)
+{
+	xfree(x);
+}
+
+static void _job_timer_init(time_t now)
+{
+	int i;
+
+	if (job_timer_base)
+		return;
+	for (i = 0; i < JOB_TIMER_BUCKETS; i++)
+		job_timer_bucket[i] = list_create(_job_timer_ent_del);
+	job_timer_overflow = list_create(_job_timer_ent_del);
+	job_timer_base = now - (now % JOB_TIMER_WIDTH);
+	job_timer_rehome = job_timer_base +
+			   ((JOB_TIMER_BUCKETS / 2) * JOB_TIMER_WIDTH);
+}
+
+/* File an entry in its bucket, or on the overflow list if its check
+ * time lies beyond the horizon of the wheel */
+static void _job_timer_file(job_timer_ent_t *timer_ent)
+{
+	time_t check_time = timer_ent->check_time;
+	int inx;
+
+	if (check_time >= (job_timer_base +
+			   (JOB_TIMER_BUCKETS * JOB_TIMER_WIDTH))) {
+		list_append(job_timer_overflow, timer_ent);
+		return;
+	}
+	if (check_time < job_timer_base)
+		check_time = job_timer_base;
+	inx = (check_time / JOB_TIMER_WIDTH) % JOB_TIMER_BUCKETS;
+	list_append(job_timer_bucket[inx], timer_ent);
+}
+
+/* Move the entries of every expired bucket onto expired_list and
+ * advance the wheel, refiling overflow entries well before the wheel
+ * could reach them */
+static void _job_timer_expire(time_t now, List expired_list)
+{
+	job_timer_ent_t *timer_ent;
+	ListIterator iter;
+	int inx;
+
+	while ((job_timer_base + JOB_TIMER_WIDTH) <= now) {
+		inx = (job_timer_base / JOB_TIMER_WIDTH) % JOB_TIMER_BUCKETS;
+		list_transfer(expired_list, job_timer_bucket[inx]);
+		job_timer_base += JOB_TIMER_WIDTH;
+	}
+
+	if (job_timer_base < job_timer_rehome)
+		return;
+	iter = list_iterator_create(job_timer_overflow);
+	while ((timer_ent = list_next(iter))) {
+		if (timer_ent->check_time >=
+		    (job_timer_base + (JOB_TIMER_BUCKETS * JOB_TIMER_WIDTH)))
+			continue;
+		list_remove(iter);
+		_job_timer_file(timer_ent);
+	}
+	list_iterator_destroy(iter);
+	job_timer_rehome = job_timer_base +
+			   ((JOB_TIMER_BUCKETS / 2) * JOB_TIMER_WIDTH);
+}
+
+static void _next_check(time_t *check_time, time_t when)
+{
+	if ((*check_time == 0) || (when < *check_time))
+		*check_time = when;
+}
+
+/* Determine the time of the next deadline driven event for a running
+ * job, mirroring the tests made by _job_time_limit_test(). 0 is
+ * returned if the job has no such event. */
+static time_t _job_next_time_check(struct job_record *job_ptr, time_t now)
+{
+	uint32_t resv_over_run = slurmctld_conf.resv_over_run;
+	uint16_t over_time_limit;
+	time_t check_time = 0;
+
+	if (IS_JOB_CONFIGURING(job_ptr))
+		return now;	/* poll for the nodes becoming ready */
+
+	if (job_ptr->warn_signal && !(job_ptr->warn_flags & WARN_SENT) &&
+	    job_ptr->warn_time)
+		_next_check(&check_time, job_ptr->end_time -
+			    job_ptr->warn_time - PERIODIC_TIMEOUT);
+
+	if (job_ptr->preempt_time) {
+		_next_check(&check_time, job_ptr->end_time);
+		goto fini;
+	}
+
+	if (job_ptr->time_limit != INFINITE) {
+		if (job_ptr->mail_type & MAIL_JOB_TIME100)
+			_next_check(&check_time, job_ptr->end_time);
+		if (job_ptr->mail_type & MAIL_JOB_TIME90)
+			_next_check(&check_time, job_ptr->end_time -
+				    (job_ptr->time_limit * 6));
+		if (job_ptr->mail_type & MAIL_JOB_TIME80)
+			_next_check(&check_time, job_ptr->end_time -
+				    (job_ptr->time_limit * 12));
+		if (job_ptr->mail_type & MAIL_JOB_TIME50)
+			_next_check(&check_time, job_ptr->end_time -
+				    (job_ptr->time_limit * 30));
+
+		if (job_ptr->part_ptr &&
+		    (job_ptr->part_ptr->over_time_limit != NO_VAL16)) {
+			over_time_limit =
+				job_ptr->part_ptr->over_time_limit;
+		} else {
+			over_time_limit = slurmctld_conf.over_time_limit;
+		}
+		if (over_time_limit == INFINITE16)
+			_next_check(&check_time,
+				    job_ptr->end_time + YEAR_SECONDS);
+		else
+			_next_check(&check_time, job_ptr->end_time +
+				    (over_time_limit * 60));
+	}
+
+	if (job_ptr->resv_ptr &&
+	    !(job_ptr->resv_ptr->flags & RESERVE_FLAG_FLEX)) {
+		if (resv_over_run == INFINITE16)
+			resv_over_run = YEAR_SECONDS;
+		else
+			resv_over_run *= 60;
+		_next_check(&check_time,
+			    job_ptr->resv_ptr->end_time + resv_over_run);
+	}
+
+	if (job_ptr->step_list && (list_count(job_ptr->step_list) > 0)) {
+		ListIterator step_iterator =
+			list_iterator_create(job_ptr->step_list);
+		struct step_record *step_ptr;
+
+		while ((step_ptr = list_next(step_iterator))) {
+			if (step_ptr->state != JOB_RUNNING)
+				continue;
+			if ((step_ptr->time_limit == INFINITE) ||
+			    (step_ptr->time_limit == NO_VAL))
+				continue;
+			_next_check(&check_time, step_ptr->start_time +
+				    step_ptr->tot_sus_time +
+				    (step_ptr->time_limit * 60));
+		}
+		list_iterator_destroy(step_iterator);
+	}
+
+	/* Give srun command warning message about pending timeout */
+	_next_check(&check_time, job_ptr->end_time - (PERIODIC_TIMEOUT * 2));
+
+fini:
+	if (check_time && (check_time < now))
+		check_time = now;
+	return check_time;
+}
+
+/*
+ * job_time_limit_register - file a running job on the deadline timer
+ *	wheel based upon the time of its next deadline driven event
+ * IN job_ptr - pointer to job being registered
+ * IN now - current time
+ */
+extern void job_time_limit_register(struct job_record *job_ptr, time_t now)
+{
+	job_timer_ent_t *timer_ent;
+	time_t check_time;
+
+	if (!job_timer_base)
+		_job_timer_init(now);
+
+	if (!IS_JOB_RUNNING(job_ptr)) {
+		job_ptr->next_time_check = 0;
+		return;
+	}
+
+	check_time = _job_next_time_check(job_ptr, now);
+	if (!check_time) {
+		job_ptr->next_time_check = 0;
+		return;
+	}
+	if (job_ptr->next_time_check == check_time)
+		return;	/* already filed for this time */
+
+	/* Any previously filed entry no longer matches next_time_check
+	 * and will be discarded as stale when its bucket expires */
+	job_ptr->next_time_check = check_time;
+	timer_ent = xmalloc(sizeof(job_timer_ent_t));
+	timer_ent->check_time = check_time;
+	timer_ent->job_id = job_ptr->job_id;
+	_job_timer_file(timer_ent);
+}
+
+/*
+ * Run the time limit and state tests for one job. Return false if only
+ * the quick tests were made, true if the slow tests ran and the caller
+ * should consider releasing locks before testing another job.
+ */
+static bool _job_time_limit_test(struct job_record *job_ptr, time_t now,
+				 time_t old, uint32_t resv_over_run)
 {
-	ListIterator job_iterator;
-	struct job_record *job_ptr;
-	time_t now = time(NULL);
-	time_t old = now - ((slurmctld_conf.inactive_limit * 4 / 3) +
-			    slurmctld_conf.msg_timeout + 1);
 	time_t over_run;
 	uint16_t over_time_limit;
 	uint8_t prolog;
-	int job_test_count = 0;
-	uint32_t resv_over_run = slurmctld_conf.resv_over_run;
-
-	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
 
-	if (resv_over_run == INFINITE16)
-		resv_over_run = YEAR_SECONDS;
+	if (job_ptr->details)
+		prolog = job_ptr->details->prolog_running;
 	else
-		resv_over_run *= 60;
+		prolog = 0;
+	if ((prolog == 0) && IS_JOB_CONFIGURING(job_ptr) &&
+	    test_job_nodes_ready(job_ptr)) {
+		info("%s: Configuration for %pJ complete",
+		     __func__, job_ptr);
+		job_config_fini(job_ptr);
+		if (job_ptr->bit_flags & NODE_REBOOT) {
+			job_ptr->bit_flags &= (~NODE_REBOOT);
+			job_validate_mem(job_ptr);
+			if (job_ptr->batch_flag)
+				launch_job(job_ptr);
+		}
+	}
 
 	/*
-	 * locks same as in _slurmctld_background() (The only current place this
-	 * is called).
+	 * Features have been changed on some node, make job eligiable
+	 * to run and test to see if it can run now
 	 */
-	slurmctld_lock_t job_write_lock = {
-		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
-	DEF_TIMERS;
+	if (node_features_updated &&
+	    (job_ptr->state_reason == FAIL_BAD_CONSTRAINTS) &&
+	    IS_JOB_PENDING(job_ptr) && (job_ptr->priority == 0)) {
+		job_ptr->state_reason = WAIT_NO_REASON;
+		set_job_prio(job_ptr);
+		last_job_update = now;
+	}
 
-	job_iterator = list_iterator_create(job_list);
-	START_TIMER;
-	while ((job_ptr = list_next(job_iterator))) {
-		xassert (job_ptr->magic == JOB_MAGIC);
-		job_test_count++;
+	/* Don't enforce time limits for configuring pack jobs */
+	if (_pack_configuring_test(job_ptr))
+		return false;
 
-		if (job_ptr->details)
-			prolog = job_ptr->details->prolog_running;
-		else
-			prolog = 0;
-		if ((prolog == 0) && IS_JOB_CONFIGURING(job_ptr) &&
-		    test_job_nodes_ready(job_ptr)) {
-			info("%s: Configuration for %pJ complete",
+	/*
+	 * Only running jobs can be killed due to timeout. Do not kill
+	 * suspended jobs due to timeout.
+	 */
+	if (!IS_JOB_RUNNING(job_ptr))
+		return false;
+
+	/*
+	 * everything above here is considered "quick", and returns false
+	 * to skip the lock release test made after each slow test
+	 */
+	if (job_ptr->preempt_time) {
+		send_job_warn_signal(job_ptr, false);
+
+		if (job_ptr->end_time <= now) {
+			last_job_update = now;
+			info("%s: Preemption GraceTime reached %pJ",
 			     __func__, job_ptr);
-			job_config_fini(job_ptr);
-			if (job_ptr->bit_flags & NODE_REBOOT) {
-				job_ptr->bit_flags &= (~NODE_REBOOT);
-				job_validate_mem(job_ptr);
-				if (job_ptr->batch_flag)
-					launch_job(job_ptr);
-			}
+			job_ptr->job_state = JOB_PREEMPTED |
+					     JOB_COMPLETING;
+			_job_timed_out(job_ptr, true);
+			xfree(job_ptr->state_desc);
 		}
+		return true;
+	}
 
-		/*
-		 * Features have been changed on some node, make job eligiable
-		 * to run and test to see if it can run now
-		 */
-		if (node_features_updated &&
-		    (job_ptr->state_reason == FAIL_BAD_CONSTRAINTS) &&
-		    IS_JOB_PENDING(job_ptr) && (job_ptr->priority == 0)) {
-			job_ptr->state_reason = WAIT_NO_REASON;
-			set_job_prio(job_ptr);
+	if (slurmctld_conf.inactive_limit &&
+	    (job_ptr->batch_flag == 0)    &&
+	    (job_ptr->time_last_active <= old) &&
+	    (job_ptr->other_port) &&
+	    (job_ptr->part_ptr) &&
+	    (!(job_ptr->part_ptr->flags & PART_FLAG_ROOT_ONLY))) {
+		/* job inactive, kill it */
+		info("%s: inactivity time limit reached for %pJ",
+		     __func__, job_ptr);
+		_job_timed_out(job_ptr, false);
+		job_ptr->state_reason = FAIL_INACTIVE_LIMIT;
+		xfree(job_ptr->state_desc);
+		return true;
+	}
+	if (job_ptr->time_limit != INFINITE) {
+		send_job_warn_signal(job_ptr, false);
+		if ((job_ptr->mail_type & MAIL_JOB_TIME100) &&
+		    (now >= job_ptr->end_time)) {
+			job_ptr->mail_type &= (~MAIL_JOB_TIME100);
+			mail_job_info(job_ptr, MAIL_JOB_TIME100);
+		}
+		if ((job_ptr->mail_type & MAIL_JOB_TIME90) &&
+		    (now + (job_ptr->time_limit * 60 * 0.1) >=
+		     job_ptr->end_time)) {
+			job_ptr->mail_type &= (~MAIL_JOB_TIME90);
+			mail_job_info(job_ptr, MAIL_JOB_TIME90);
+		}
+		if ((job_ptr->mail_type & MAIL_JOB_TIME80) &&
+		    (now + (job_ptr->time_limit * 60 * 0.2) >=
+		     job_ptr->end_time)) {
+			job_ptr->mail_type &= (~MAIL_JOB_TIME80);
+			mail_job_info(job_ptr, MAIL_JOB_TIME80);
+		}
+		if ((job_ptr->mail_type & MAIL_JOB_TIME50) &&
+		    (now + (job_ptr->time_limit * 60 * 0.5) >=
+		     job_ptr->end_time)) {
+			job_ptr->mail_type &= (~MAIL_JOB_TIME50);
+			mail_job_info(job_ptr, MAIL_JOB_TIME50);
+		}
+
+		if (job_ptr->part_ptr &&
+		    (job_ptr->part_ptr->over_time_limit != NO_VAL16)) {
+			over_time_limit =
+				job_ptr->part_ptr->over_time_limit;
+		} else {
+			over_time_limit =
+				slurmctld_conf.over_time_limit;
+		}
+		if (over_time_limit == INFINITE16)
+			over_run = now - YEAR_SECONDS;
+		else
+			over_run = now - (over_time_limit  * 60);
+		if (job_ptr->end_time <= over_run) {
 			last_job_update = now;
+			info("Time limit exhausted for %pJ", job_ptr);
+			_job_timed_out(job_ptr, false);
+			job_ptr->state_reason = FAIL_TIMEOUT;
+			xfree(job_ptr->state_desc);
+			return true;
 		}
+	}
 
-		/* Don't enforce time limits for configuring pack jobs */
-		if (_pack_configuring_test(job_ptr))
-			continue;
+	if (job_ptr->resv_ptr &&
+	    !(job_ptr->resv_ptr->flags & RESERVE_FLAG_FLEX) &&
+	    (job_ptr->resv_ptr->end_time + resv_over_run) < time(NULL)) {
+		last_job_update = now;
+		info("Reservation ended for %pJ", job_ptr);
+		_job_timed_out(job_ptr, false);
+		job_ptr->state_reason = FAIL_TIMEOUT;
+		xfree(job_ptr->state_desc);
+		return true;
+	}
+
+	/*
+	 * check if any individual job steps have exceeded
+	 * their time limit
+	 */
+	if (job_ptr->step_list &&
+	    (list_count(job_ptr->step_list) > 0))
+		check_job_step_time_limit(job_ptr, now);
+
+	acct_policy_job_time_out(job_ptr);
+
+	if (job_ptr->state_reason == FAIL_TIMEOUT) {
+		last_job_update = now;
+		_job_timed_out(job_ptr, false);
+		xfree(job_ptr->state_desc);
+		return true;
+	}
+
+	/* Give srun command warning message about pending timeout */
+	if (job_ptr->end_time <= (now + PERIODIC_TIMEOUT * 2))
+		srun_timeout (job_ptr);
+
+	return true;
+}
+
+/*
+ * job_time_limit - terminate jobs which have exceeded their time limit
+ * global: job_list - pointer global job list
+ *	last_job_update - time of last job table update
+ */
+void job_time_limit(void)
+{
+	ListIterator job_iterator;
+	struct job_record *job_ptr;
+	job_timer_ent_t *timer_ent;
+	List expired_list = NULL;
+	time_t now = time(NULL);
+	time_t old = now - ((slurmctld_conf.inactive_limit * 4 / 3) +
+			    slurmctld_conf.msg_timeout + 1);
+	int job_test_count = 0;
+	uint32_t resv_over_run = slurmctld_conf.resv_over_run;
+	bool full_scan, slow;
 
-		/*
-		 * Only running jobs can be killed due to timeout. Do not kill
-		 * suspended jobs due to timeout.
-		 */
-		if (!IS_JOB_RUNNING(job_ptr))
-			continue;
+	xassert(verify_lock(JOB_LOCK, WRITE_LOCK));
 
-		/*
-		 * everything above here is considered "quick", and skips the
-		 * timeout at the bottom of the loop by using a continue.
-		 * everything below is considered "slow", and needs to jump to
-		 * time_check before the next job is tested
-		 */
-		if (job_ptr->preempt_time) {
-			send_job_warn_signal(job_ptr, false);
-
-			if (job_ptr->end_time <= now) {
-				last_job_update = now;
-				info("%s: Preemption GraceTime reached %pJ",
-				     __func__, job_ptr);
-				job_ptr->job_state = JOB_PREEMPTED |
-						     JOB_COMPLETING;
-				_job_timed_out(job_ptr, true);
-				xfree(job_ptr->state_desc);
-			}
-			goto time_check;
-		}
+	if (resv_over_run == INFINITE16)
+		resv_over_run = YEAR_SECONDS;
+	else
+		resv_over_run *= 60;
 
-		if (slurmctld_conf.inactive_limit &&
-		    (job_ptr->batch_flag == 0)    &&
-		    (job_ptr->time_last_active <= old) &&
-		    (job_ptr->other_port) &&
-		    (job_ptr->part_ptr) &&
-		    (!(job_ptr->part_ptr->flags & PART_FLAG_ROOT_ONLY))) {
-			/* job inactive, kill it */
-			info("%s: inactivity time limit reached for %pJ",
-			     __func__, job_ptr);
-			_job_timed_out(job_ptr, false);
-			job_ptr->state_reason = FAIL_INACTIVE_LIMIT;
-			xfree(job_ptr->state_desc);
-			goto time_check;
-		}
-		if (job_ptr->time_limit != INFINITE) {
-			send_job_warn_signal(job_ptr, false);
-			if ((job_ptr->mail_type & MAIL_JOB_TIME100) &&
-			    (now >= job_ptr->end_time)) {
-				job_ptr->mail_type &= (~MAIL_JOB_TIME100);
-				mail_job_info(job_ptr, MAIL_JOB_TIME100);
-			}
-			if ((job_ptr->mail_type & MAIL_JOB_TIME90) &&
-			    (now + (job_ptr->time_limit * 60 * 0.1) >=
-			     job_ptr->end_time)) {
-				job_ptr->mail_type &= (~MAIL_JOB_TIME90);
-				mail_job_info(job_ptr, MAIL_JOB_TIME90);
-			}
-			if ((job_ptr->mail_type & MAIL_JOB_TIME80) &&
-			    (now + (job_ptr->time_limit * 60 * 0.2) >=
-			     job_ptr->end_time)) {
-				job_ptr->mail_type &= (~MAIL_JOB_TIME80);
-				mail_job_info(job_ptr, MAIL_JOB_TIME80);
-			}
-			if ((job_ptr->mail_type & MAIL_JOB_TIME50) &&
-			    (now + (job_ptr->time_limit * 60 * 0.5) >=
-			     job_ptr->end_time)) {
-				job_ptr->mail_type &= (~MAIL_JOB_TIME50);
-				mail_job_info(job_ptr, MAIL_JOB_TIME50);
-			}
+	/*
+	 * locks same as in _slurmctld_background() (The only current place this
+	 * is called).
+	 */
+	slurmctld_lock_t job_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
+	DEF_TIMERS;
 
-			if (job_ptr->part_ptr &&
-			    (job_ptr->part_ptr->over_time_limit != NO_VAL16)) {
-				over_time_limit =
-					job_ptr->part_ptr->over_time_limit;
-			} else {
-				over_time_limit =
-					slurmctld_conf.over_time_limit;
+	_job_timer_init(now);
+
+	full_scan = node_features_updated ||
+		    (job_timer_resync <= now) ||
+		    (slurmctld_conf.inactive_limit != 0) ||
+		    (accounting_enforce & ACCOUNTING_ENFORCE_LIMITS);
+
+	if (!full_scan) {
+		/* Only test the jobs with a deadline event coming due */
+		expired_list = list_create(_job_timer_ent_del);
+		_job_timer_expire(now, expired_list);
+		START_TIMER;
+		while ((timer_ent = list_pop(expired_list))) {
+			job_ptr = find_job_record(timer_ent->job_id);
+			if (!job_ptr ||
+			    (job_ptr->next_time_check !=
+			     timer_ent->check_time)) {
+				xfree(timer_ent);	/* stale entry */
+				continue;
 			}
-			if (over_time_limit == INFINITE16)
-				over_run = now - YEAR_SECONDS;
-			else
-				over_run = now - (over_time_limit  * 60);
-			if (job_ptr->end_time <= over_run) {
-				last_job_update = now;
-				info("Time limit exhausted for %pJ", job_ptr);
-				_job_timed_out(job_ptr, false);
-				job_ptr->state_reason = FAIL_TIMEOUT;
-				xfree(job_ptr->state_desc);
-				goto time_check;
+			xfree(timer_ent);
+			xassert(job_ptr->magic == JOB_MAGIC);
+			job_test_count++;
+			job_ptr->next_time_check = 0;
+			slow = _job_time_limit_test(job_ptr, now, old,
+						    resv_over_run);
+			job_time_limit_register(job_ptr, now);
+			if (!slow)
+				continue;
+			/*
+			 * Release the job write lock periodically, as in
+			 * the full scan below. The remaining entries are
+			 * found by job id once the locks are reacquired.
+			 */
+			if (slurm_delta_tv(&tv1) >= 3000000 &&
+			    list_count(expired_list)) {
+				END_TIMER;
+				debug("%s: yielding locks after testing"
+				      " %d jobs, %s",
+				      __func__, job_test_count, TIME_STR);
+				unlock_slurmctld(job_write_lock);
+				usleep(1000000);
+				lock_slurmctld(job_write_lock);
+				START_TIMER;
+				job_test_count = 0;
 			}
 		}
+		FREE_NULL_LIST(expired_list);
+		return;
+	}
 
-		if (job_ptr->resv_ptr &&
-		    !(job_ptr->resv_ptr->flags & RESERVE_FLAG_FLEX) &&
-		    (job_ptr->resv_ptr->end_time + resv_over_run) < time(NULL)){
-			last_job_update = now;
-			info("Reservation ended for %pJ", job_ptr);
-			_job_timed_out(job_ptr, false);
-			job_ptr->state_reason = FAIL_TIMEOUT;
-			xfree(job_ptr->state_desc);
-			goto time_check;
-		}
-
-		/*
-		 * check if any individual job steps have exceeded
-		 * their time limit
-		 */
-		if (job_ptr->step_list &&
-		    (list_count(job_ptr->step_list) > 0))
-			check_job_step_time_limit(job_ptr, now);
-
-		acct_policy_job_time_out(job_ptr);
-
-		if (job_ptr->state_reason == FAIL_TIMEOUT) {
-			last_job_update = now;
-			_job_timed_out(job_ptr, false);
-			xfree(job_ptr->state_desc);
-			goto time_check;
-		}
+	job_timer_resync = now + JOB_TIMER_RESYNC;
+	job_iterator = list_iterator_create(job_list);
+	START_TIMER;
+	while ((job_ptr = list_next(job_iterator))) {
+		xassert (job_ptr->magic == JOB_MAGIC);
+		job_test_count++;
 
-		/* Give srun command warning message about pending timeout */
-		if (job_ptr->end_time <= (now + PERIODIC_TIMEOUT * 2))
-			srun_timeout (job_ptr);
+		slow = _job_time_limit_test(job_ptr, now, old, resv_over_run);
+		job_time_limit_register(job_ptr, now);
+		if (!slow)
+			continue;
 
 		/*
 		 * _job_timed_out() and other calls can take a long time on
@@ -8639,9 +9376,9 @@ void job_time_limit(void)
 		 * list_peek_next is used in the unlikely event the timer has
 		 * expired just as the end of the job_list is reached.
 		 */
-time_check:
 		/* Use a hard-coded 3 second timeout, with a 1 second sleep. */
-		if (slurm_delta_tv(&tv1) >= 3000000 && list_peek_next(job_iterator) ) {
+		if (slurm_delta_tv(&tv1) >= 3000000 &&
+		    list_peek_next(job_iterator)) {
 			END_TIMER;
 			debug("%s: yielding locks after testing"
 			      " %d jobs, %s",
@@ -9055,18 +9792,27 @@ _validate_min_mem_partition(job_desc_msg_t *job_desc_msg,
 }
 
 /*
- * _list_delete_job - delete a job record and its corresponding job_details,
- *	see common/list.h for documentation
- * IN job_entry - pointer to job_record to delete
+ * job_state_cache_clear - release the cached state save image of a job
+ *	record. Must be called whenever a finished job's record is modified
+ *	so dump_all_job_state() will re-pack it.
  */
-static void _list_delete_job(void *job_entry)
+extern void job_state_cache_clear(struct job_record *job_ptr)
 {
-	struct job_record *job_ptr = (struct job_record *) job_entry;
-	int job_array_size, i;
+	xfree(job_ptr->state_cache);
+	job_ptr->state_cache_len = 0;
+}
 
-	xassert(job_entry);
-	xassert (job_ptr->magic == JOB_MAGIC);
-	job_ptr->magic = 0;	/* make sure we don't delete record twice */
+/*
+ * _unlink_job_record - detach a job record from all shared state (hash
+ *	tables, federation info, job_count). Must be called with the job
+ *	write lock held. The record's memory may then be released outside
+ *	the lock with _free_job_record().
+ */
+static void _unlink_job_record(struct job_record *job_ptr)
+{
+	int job_array_size;
+
+	xassert(job_ptr->magic == JOB_MAGIC);
 
 	/* Remove record from fed_job_list */
 	fed_mgr_remove_fed_job_info(job_ptr->job_id);
@@ -9084,9 +9830,35 @@ static void _list_delete_job(void *job_entry)
 	if (job_ptr->array_task_id != NO_VAL) {
 		_remove_job_hash(job_ptr, JOB_HASH_ARRAY_JOB);
 		_remove_job_hash(job_ptr, JOB_HASH_ARRAY_TASK);
+	} else if (job_ptr->array_recs &&
+		   (job_ptr->job_id != job_ptr->array_job_id)) {
+		/* Split out meta record, present in the "J" table only */
+		_remove_job_hash(job_ptr, JOB_HASH_ARRAY_JOB);
+	}
+
+	if (job_array_size > job_count) {
+		error("job_count underflow");
+		job_count = 0;
+	} else {
+		job_count -= job_array_size;
 	}
+}
+
+/*
+ * _free_job_record - release all memory of an already unlinked job
+ *	record. Safe to call without the job lock held.
+ */
+static void _free_job_record(void *job_entry)
+{
+	struct job_record *job_ptr = (struct job_record *) job_entry;
+	int i;
+
+	xassert(job_entry);
+	xassert (job_ptr->magic == JOB_MAGIC);
+	job_ptr->magic = 0;	/* make sure we don't delete record twice */
 
 	_delete_job_details(job_ptr);
+	job_state_cache_clear(job_ptr);
 	xfree(job_ptr->account);
 	xfree(job_ptr->admin_comment);
 	xfree(job_ptr->alias_list);
@@ -9161,16 +9933,47 @@ static void _list_delete_job(void *job_entry)
 	select_g_select_jobinfo_free(job_ptr->select_jobinfo);
 	xfree(job_ptr->user_name);
 	xfree(job_ptr->wckey);
-	if (job_array_size > job_count) {
-		error("job_count underflow");
-		job_count = 0;
-	} else {
-		job_count -= job_array_size;
-	}
 	job_ptr->job_id = 0;
 	xfree(job_ptr);
 }
 
+/*
+ * _list_delete_job - delete a job record and its corresponding job_details,
+ *	see common/list.h for documentation
+ * IN job_entry - pointer to job_record to delete
+ */
+/* Interval between two lifecycle stamps, zero if either is unset */
+static uint64_t _timing_delta(uint64_t from, uint64_t to)
+{
+	if (from && (to > from))
+		return to - from;
+	return 0;
+}
+
+static void _list_delete_job(void *job_entry)
+{
+	struct job_record *job_ptr = (struct job_record *) job_entry;
+
+	xassert(job_entry);
+	if ((slurmctld_conf.debug_flags & DEBUG_FLAG_TRACE_JOBS) &&
+	    job_ptr->timing.submit) {
+		job_timing_t *t = &job_ptr->timing;
+		info("%s: %pJ lifecycle usec submit->eval:%"PRIu64
+		     " eval->alloc:%"PRIu64" alloc->prolog:%"PRIu64
+		     " alloc->launch:%"PRIu64" launch->complete:%"PRIu64
+		     " complete->clean:%"PRIu64,
+		     __func__, job_ptr,
+		     _timing_delta(t->submit, t->first_eval),
+		     _timing_delta(t->first_eval, t->alloc),
+		     _timing_delta(t->alloc, t->prolog_done),
+		     _timing_delta(t->alloc, t->launch),
+		     _timing_delta(t->launch, t->complete),
+		     _timing_delta(t->complete, t->cleanup_done));
+	}
+	_unlink_job_record(job_ptr);
+	xfree_deferred(job_ptr, _free_job_record);
+}
+
 
 /*
  * list_find_job_id - find specific job_id entry in the job list,
@@ -9330,6 +10133,89 @@ static bool _hide_job(struct job_record *job_ptr, uid_t uid,
 	return false;
 }
 
+/*
+ * Minimum length for a run of bytes matching the previous record to be
+ * encoded as a copy rather than folded into the adjacent literals. Each
+ * chunk costs eight bytes of framing, so short runs are not worth it.
+ */
+#define JOB_DELTA_MIN_COPY 16
+
+/*
+ * Pack one job record as a binary delta against the previously packed
+ * record of the same message. The tasks of a job array share nearly
+ * every attribute, so sibling records reduce to a few literal runs
+ * (job id, task id, state, times, node names) referencing the bulk of
+ * the previous record. The encoding is field-agnostic: each record is
+ * its full packed length followed by pairs of (copy length, literal
+ * bytes), where a copy takes bytes from the previous record at the
+ * same offset. Decoded by _unpack_job_info_msg(), which rebuilds each
+ * record before unpacking it through the regular member parser; only
+ * used for SLURM_20_02_PROTOCOL_VERSION and later on both ends.
+ */
+static void _pack_job_delta(struct job_record *job_ptr, uint16_t show_flags,
+			    Buf buffer, uint16_t protocol_version, uid_t uid,
+			    Buf *delta_prev)
+{
+	Buf scratch = init_buf(16 * 1024);
+	char *data, *prev_data = NULL;
+	uint32_t len, prev_len = 0, off = 0, run, lit_start;
+
+	pack_job(job_ptr, show_flags, scratch, protocol_version, uid);
+	data = get_buf_data(scratch);
+	len = get_buf_offset(scratch);
+	if (*delta_prev) {
+		Buf prev = *delta_prev;
+		prev_data = get_buf_data(prev);
+		prev_len = get_buf_offset(prev);
+	}
+
+	pack32(len, buffer);
+	while (off < len) {
+		/* Run of bytes matching the previous record */
+		run = 0;
+		while (((off + run) < len) && ((off + run) < prev_len) &&
+		       (data[off + run] == prev_data[off + run]))
+			run++;
+		pack32(run, buffer);
+		off += run;
+
+		/* Literal bytes up to the next copy run worth encoding */
+		lit_start = off;
+		while (off < len) {
+			if ((off < prev_len) && (data[off] == prev_data[off])) {
+				run = 1;
+				while (((off + run) < len) &&
+				       ((off + run) < prev_len) &&
+				       (data[off + run] ==
+					prev_data[off + run]))
+					run++;
+				if ((run >= JOB_DELTA_MIN_COPY) ||
+				    ((off + run) == len))
+					break;
+				off += run;
+			} else
+				off++;
+		}
+		packmem(data + lit_start, off - lit_start, buffer);
+	}
+
+	FREE_NULL_BUFFER(*delta_prev);
+	*delta_prev = scratch;
+}
+
+/* Pack one job record, delta-encoded for protocols supporting it */
+static void _pack_job_record(struct job_record *job_ptr, uint16_t show_flags,
+			     Buf buffer, uint16_t protocol_version, uid_t uid,
+			     Buf *delta_prev)
+{
+	if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+		_pack_job_delta(job_ptr, show_flags, buffer, protocol_version,
+				uid, delta_prev);
+	} else {
+		pack_job(job_ptr, show_flags, buffer, protocol_version, uid);
+	}
+}
+
 static void _pack_job(struct job_record *job_ptr,
 		      _foreach_pack_job_info_t *pack_info)
 {
@@ -9347,22 +10233,151 @@ static void _pack_job(struct job_record *job_ptr,
 	if (_hide_job(job_ptr, pack_info->uid, pack_info->show_flags))
 		return;
 
-	pack_job(job_ptr, pack_info->show_flags, pack_info->buffer,
-		 pack_info->protocol_version, pack_info->uid);
+	_pack_job_record(job_ptr, pack_info->show_flags, pack_info->buffer,
+			 pack_info->protocol_version, pack_info->uid,
+			 &pack_info->delta_prev);
 
 	(*pack_info->jobs_packed)++;
 }
 
+/*
+ * Cache of serialized RESPONSE_JOB_INFO payloads, so concurrent polling
+ * clients (squeue/sview/monitoring) are served by a memcpy rather than an
+ * O(jobs) pack under the job read lock. Entries are keyed by everything
+ * that affects pack output and are only served while no job or partition
+ * record has changed since they were filled. fill_time must be a later
+ * second than the generation stamps, else another update within the same
+ * second as the fill could go undetected.
+ */
+#define JOB_PACK_CACHE_SIZE 8
+
+typedef struct {
+	char *data;
+	int data_size;
+	uint16_t show_flags;
+	uid_t uid;
+	uint32_t filter_uid;
+	uint16_t protocol_version;
+	time_t job_update_gen;
+	time_t part_update_gen;
+	time_t fill_time;
+	time_t last_used;
+} job_pack_cache_t;
+
+static pthread_mutex_t job_pack_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static job_pack_cache_t job_pack_cache[JOB_PACK_CACHE_SIZE];
+
+static bool _job_pack_cache_lookup(char **buffer_ptr, int *buffer_size,
+				   uint16_t show_flags, uid_t uid,
+				   uint32_t filter_uid,
+				   uint16_t protocol_version)
+{
+	job_pack_cache_t *ent;
+	bool hit = false;
+
+	slurm_mutex_lock(&job_pack_cache_mutex);
+	for (int i = 0; i < JOB_PACK_CACHE_SIZE; i++) {
+		ent = &job_pack_cache[i];
+		if (!ent->data ||
+		    (ent->show_flags != show_flags) ||
+		    (ent->uid != uid) ||
+		    (ent->filter_uid != filter_uid) ||
+		    (ent->protocol_version != protocol_version))
+			continue;
+		if ((ent->job_update_gen != last_job_update) ||
+		    (ent->part_update_gen != last_part_update) ||
+		    (ent->fill_time <= ent->job_update_gen) ||
+		    (ent->fill_time <= ent->part_update_gen))
+			break;
+		*buffer_size = ent->data_size;
+		buffer_ptr[0] = xmalloc(ent->data_size);
+		memcpy(buffer_ptr[0], ent->data, ent->data_size);
+		ent->last_used = time(NULL);
+		hit = true;
+		break;
+	}
+	slurm_mutex_unlock(&job_pack_cache_mutex);
+	return hit;
+}
+
+static void _job_pack_cache_insert(char *data, int data_size,
+				   uint16_t show_flags, uid_t uid,
+				   uint32_t filter_uid,
+				   uint16_t protocol_version)
+{
+	job_pack_cache_t *ent, *evict;
+	time_t now = time(NULL);
+
+	slurm_mutex_lock(&job_pack_cache_mutex);
+	evict = &job_pack_cache[0];
+	for (int i = 0; i < JOB_PACK_CACHE_SIZE; i++) {
+		ent = &job_pack_cache[i];
+		if (!ent->data ||
+		    ((ent->show_flags == show_flags) && (ent->uid == uid) &&
+		     (ent->filter_uid == filter_uid) &&
+		     (ent->protocol_version == protocol_version))) {
+			evict = ent;
+			break;
+		}
+		if (ent->last_used < evict->last_used)
+			evict = ent;
+	}
+	xfree(evict->data);
+	evict->data = xmalloc(data_size);
+	memcpy(evict->data, data, data_size);
+	evict->data_size = data_size;
+	evict->show_flags = show_flags;
+	evict->uid = uid;
+	evict->filter_uid = filter_uid;
+	evict->protocol_version = protocol_version;
+	evict->job_update_gen = last_job_update;
+	evict->part_update_gen = last_part_update;
+	evict->fill_time = now;
+	evict->last_used = now;
+	slurm_mutex_unlock(&job_pack_cache_mutex);
+}
+
 static int _foreach_pack_jobid(void *object, void *arg)
 {
-	struct job_record *job_ptr;
+	struct job_record *job_ptr, *array_ptr;
 	uint32_t job_id = *(uint32_t *)object;
 	_foreach_pack_job_info_t *info = (_foreach_pack_job_info_t *)arg;
 
-	if (!(job_ptr = find_job_record(job_id)))
+	job_ptr = find_job_record(job_id);
+
+	if (job_ptr && job_ptr->pack_job_list) {
+		/* Pack all heterogeneous job components */
+		struct job_record *pack_ptr;
+		ListIterator iter;
+
+		iter = list_iterator_create(job_ptr->pack_job_list);
+		while ((pack_ptr = (struct job_record *) list_next(iter))) {
+			if (pack_ptr->pack_job_id == job_ptr->pack_job_id)
+				_pack_job(pack_ptr, info);
+			else
+				error("%s: Bad pack_job_list for %pJ",
+				      __func__, job_ptr);
+		}
+		list_iterator_destroy(iter);
 		return SLURM_SUCCESS;
+	}
+
+	if (job_ptr)
+		_pack_job(job_ptr, info);
 
-	_pack_job(job_ptr, info);
+	/*
+	 * The tasks of a job array run under their own job IDs, so also
+	 * pack any record spun off from the array identified by job_id.
+	 * Only the record found above can have job_id as its own ID, so
+	 * nothing is packed twice.
+	 */
+	array_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
+	while (array_ptr) {
+		if ((array_ptr != job_ptr) &&
+		    (array_ptr->array_job_id == job_id))
+			_pack_job(array_ptr, info);
+		array_ptr = array_ptr->job_array_next_j;
+	}
 
 	return SLURM_SUCCESS;
 }
@@ -9393,6 +10408,11 @@ extern void pack_all_jobs(char **buffer_ptr, int *buffer_size,
 	buffer_ptr[0] = NULL;
 	*buffer_size = 0;
 
+	if (_job_pack_cache_lookup(buffer_ptr, buffer_size, show_flags, uid,
+				   filter_uid, protocol_version))
+		return;
+
+	PHASE_TRACE_BEGIN(PHASE_TRACE_PACK_JOB_INFO);
 	buffer = init_buf(BUF_SIZE);
 
 	/* write message body header : size and time */
@@ -9413,6 +10433,7 @@ extern void pack_all_jobs(char **buffer_ptr, int *buffer_size,
 		_pack_job(job_ptr, &pack_info);
 	}
 	list_iterator_destroy(itr);
+	FREE_NULL_BUFFER(pack_info.delta_prev);
 
 	/* put the real record count in the message body header */
 	tmp_offset = get_buf_offset(buffer);
@@ -9422,6 +10443,10 @@ extern void pack_all_jobs(char **buffer_ptr, int *buffer_size,
 
 	*buffer_size = get_buf_offset(buffer);
 	buffer_ptr[0] = xfer_buf_data(buffer);
+
+	_job_pack_cache_insert(buffer_ptr[0], *buffer_size, show_flags, uid,
+			       filter_uid, protocol_version);
+	PHASE_TRACE_END(PHASE_TRACE_PACK_JOB_INFO);
 }
 
 /*
@@ -9467,6 +10492,7 @@ extern void pack_spec_jobs(char **buffer_ptr, int *buffer_size, List job_ids,
 	pack_info.uid              = uid;
 
 	list_for_each(job_ids, _foreach_pack_jobid, &pack_info);
+	FREE_NULL_BUFFER(pack_info.delta_prev);
 
 	/* put the real record count in the message body header */
 	tmp_offset = get_buf_offset(buffer);
@@ -9479,7 +10505,8 @@ extern void pack_spec_jobs(char **buffer_ptr, int *buffer_size, List job_ids,
 }
 
 static int _pack_hetero_job(struct job_record *job_ptr, uint16_t show_flags,
-			    Buf buffer, uint16_t protocol_version, uid_t uid)
+			    Buf buffer, uint16_t protocol_version, uid_t uid,
+			    Buf *delta_prev)
 {
 	struct job_record *pack_ptr;
 	int job_cnt = 0;
@@ -9488,8 +10515,8 @@ static int _pack_hetero_job(struct job_record *job_ptr, uint16_t show_flags,
 	iter = list_iterator_create(job_ptr->pack_job_list);
 	while ((pack_ptr = (struct job_record *) list_next(iter))) {
 		if (pack_ptr->pack_job_id == job_ptr->pack_job_id) {
-			pack_job(pack_ptr, show_flags, buffer, protocol_version,
-				 uid);
+			_pack_job_record(pack_ptr, show_flags, buffer,
+					 protocol_version, uid, delta_prev);
 			job_cnt++;
 		} else {
 			error("%s: Bad pack_job_list for %pJ",
@@ -9519,7 +10546,7 @@ extern int pack_one_job(char **buffer_ptr, int *buffer_size,
 {
 	struct job_record *job_ptr;
 	uint32_t jobs_packed = 0, tmp_offset;
-	Buf buffer;
+	Buf buffer, delta_prev = NULL;
 
 	buffer_ptr[0] = NULL;
 	*buffer_size = 0;
@@ -9537,14 +10564,14 @@ extern int pack_one_job(char **buffer_ptr, int *buffer_size,
 		if (!_hide_job(job_ptr, uid, show_flags)) {
 			jobs_packed = _pack_hetero_job(job_ptr, show_flags,
 						       buffer, protocol_version,
-						       uid);
+						       uid, &delta_prev);
 		}
 	} else if (job_ptr && (job_ptr->array_task_id == NO_VAL) &&
 		   !job_ptr->array_recs) {
 		/* Pack regular (not array) job */
 		if (!_hide_job(job_ptr, uid, show_flags)) {
-			pack_job(job_ptr, show_flags, buffer, protocol_version,
-				 uid);
+			_pack_job_record(job_ptr, show_flags, buffer,
+					 protocol_version, uid, &delta_prev);
 			jobs_packed++;
 		}
 	} else {
@@ -9554,8 +10581,9 @@ extern int pack_one_job(char **buffer_ptr, int *buffer_size,
 		if (job_ptr) {
 			packed_head = true;
 			if (!_hide_job(job_ptr, uid, show_flags)) {
-				pack_job(job_ptr, show_flags, buffer,
-					 protocol_version, uid);
+				_pack_job_record(job_ptr, show_flags, buffer,
+						 protocol_version, uid,
+						 &delta_prev);
 				jobs_packed++;
 			}
 		}
@@ -9567,13 +10595,15 @@ extern int pack_one_job(char **buffer_ptr, int *buffer_size,
 			} else if (job_ptr->array_job_id == job_id) {
 				if (_hide_job(job_ptr, uid, show_flags))
 					break;
-				pack_job(job_ptr, show_flags, buffer,
-					 protocol_version, uid);
+				_pack_job_record(job_ptr, show_flags, buffer,
+						 protocol_version, uid,
+						 &delta_prev);
 				jobs_packed++;
 			}
 			job_ptr = job_ptr->job_array_next_j;
 		}
 	}
+	FREE_NULL_BUFFER(delta_prev);
 
 	if (jobs_packed == 0) {
 		free_buf(buffer);
@@ -9616,6 +10646,18 @@ static void _pack_job_gres(struct job_record *dump_job_ptr, Buf buffer,
  * NOTE: change _unpack_job_info_members() in common/slurm_protocol_pack.c
  *	  whenever the data format changes
  */
+/*
+ * Pack a string field which the requester asked us to skip (SHOW_SLIM) as
+ * an empty placeholder so the field sequence stays intact on the wire.
+ */
+static void _packstr_slim(char *str, bool slim, Buf buffer)
+{
+	if (slim)
+		packnull(buffer);
+	else
+		packstr(str, buffer);
+}
+
 void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 	      uint16_t protocol_version, uid_t uid)
 {
@@ -9623,6 +10665,7 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 	time_t accrue_time = 0, begin_time = 0, start_time = 0, end_time = 0;
 	uint32_t time_limit;
 	char *nodelist = NULL;
+	bool slim = (show_flags & SHOW_SLIM);
 	assoc_mgr_lock_t locks = { .qos = READ_LOCK };
 
 	if (protocol_version >= SLURM_19_05_PROTOCOL_VERSION) {
@@ -9747,15 +10790,15 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 		else
 			packstr(dump_job_ptr->partition, buffer);
 		packstr(dump_job_ptr->account, buffer);
-		packstr(dump_job_ptr->admin_comment, buffer);
+		_packstr_slim(dump_job_ptr->admin_comment, slim, buffer);
 		pack32(dump_job_ptr->site_factor, buffer);
-		packstr(dump_job_ptr->network, buffer);
-		packstr(dump_job_ptr->comment, buffer);
-		packstr(dump_job_ptr->batch_features, buffer);
-		packstr(dump_job_ptr->batch_host, buffer);
-		packstr(dump_job_ptr->burst_buffer, buffer);
-		packstr(dump_job_ptr->burst_buffer_state, buffer);
-		packstr(dump_job_ptr->system_comment, buffer);
+		_packstr_slim(dump_job_ptr->network, slim, buffer);
+		_packstr_slim(dump_job_ptr->comment, slim, buffer);
+		_packstr_slim(dump_job_ptr->batch_features, slim, buffer);
+		_packstr_slim(dump_job_ptr->batch_host, slim, buffer);
+		_packstr_slim(dump_job_ptr->burst_buffer, slim, buffer);
+		_packstr_slim(dump_job_ptr->burst_buffer_state, slim, buffer);
+		_packstr_slim(dump_job_ptr->system_comment, slim, buffer);
 
 		assoc_mgr_lock(&locks);
 		if (dump_job_ptr->qos_ptr)
@@ -9783,7 +10826,7 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 		packstr(dump_job_ptr->licenses, buffer);
 		packstr(dump_job_ptr->state_desc, buffer);
 		packstr(dump_job_ptr->resv_name, buffer);
-		packstr(dump_job_ptr->mcs_label, buffer);
+		_packstr_slim(dump_job_ptr->mcs_label, slim, buffer);
 
 		pack32(dump_job_ptr->exit_code, buffer);
 		pack32(dump_job_ptr->derived_ec, buffer);
@@ -9799,11 +10842,11 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 
 		packstr(dump_job_ptr->name, buffer);
 		packstr(dump_job_ptr->user_name, buffer);
-		packstr(dump_job_ptr->wckey, buffer);
+		_packstr_slim(dump_job_ptr->wckey, slim, buffer);
 		pack32(dump_job_ptr->req_switch, buffer);
 		pack32(dump_job_ptr->wait4switch, buffer);
 
-		packstr(dump_job_ptr->alloc_node, buffer);
+		_packstr_slim(dump_job_ptr->alloc_node, slim, buffer);
 		if (!IS_JOB_COMPLETING(dump_job_ptr))
 			pack_bit_str_hex(dump_job_ptr->node_bitmap, buffer);
 		else
@@ -9813,7 +10856,7 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 					     buffer, protocol_version);
 
 		/* A few details are always dumped here */
-		_pack_default_job_details(dump_job_ptr, buffer,
+		_pack_default_job_details(dump_job_ptr, show_flags, buffer,
 					  protocol_version);
 
 		/* other job details are only dumped until the job starts
@@ -9825,8 +10868,8 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 			_pack_pending_job_details(NULL, buffer,
 						  protocol_version);
 		pack32(dump_job_ptr->bit_flags, buffer);
-		packstr(dump_job_ptr->tres_fmt_alloc_str, buffer);
-		packstr(dump_job_ptr->tres_fmt_req_str, buffer);
+		_packstr_slim(dump_job_ptr->tres_fmt_alloc_str, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_fmt_req_str, slim, buffer);
 		pack16(dump_job_ptr->start_protocol_ver, buffer);
 
 		if (dump_job_ptr->fed_details) {
@@ -9847,14 +10890,14 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 			packnull(buffer);
 		}
 
-		packstr(dump_job_ptr->cpus_per_tres, buffer);
-		packstr(dump_job_ptr->mem_per_tres, buffer);
-		packstr(dump_job_ptr->tres_bind, buffer);
-		packstr(dump_job_ptr->tres_freq, buffer);
-		packstr(dump_job_ptr->tres_per_job, buffer);
-		packstr(dump_job_ptr->tres_per_node, buffer);
-		packstr(dump_job_ptr->tres_per_socket, buffer);
-		packstr(dump_job_ptr->tres_per_task, buffer);
+		_packstr_slim(dump_job_ptr->cpus_per_tres, slim, buffer);
+		_packstr_slim(dump_job_ptr->mem_per_tres, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_bind, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_freq, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_job, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_node, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_socket, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_task, slim, buffer);
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		detail_ptr = dump_job_ptr->details;
 		pack32(dump_job_ptr->array_job_id, buffer);
@@ -9967,14 +11010,14 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 		else
 			packstr(dump_job_ptr->partition, buffer);
 		packstr(dump_job_ptr->account, buffer);
-		packstr(dump_job_ptr->admin_comment, buffer);
-		packstr(dump_job_ptr->network, buffer);
-		packstr(dump_job_ptr->comment, buffer);
-		packstr(dump_job_ptr->batch_features, buffer);
-		packstr(dump_job_ptr->batch_host, buffer);
-		packstr(dump_job_ptr->burst_buffer, buffer);
-		packstr(dump_job_ptr->burst_buffer_state, buffer);
-		packstr(dump_job_ptr->system_comment, buffer);
+		_packstr_slim(dump_job_ptr->admin_comment, slim, buffer);
+		_packstr_slim(dump_job_ptr->network, slim, buffer);
+		_packstr_slim(dump_job_ptr->comment, slim, buffer);
+		_packstr_slim(dump_job_ptr->batch_features, slim, buffer);
+		_packstr_slim(dump_job_ptr->batch_host, slim, buffer);
+		_packstr_slim(dump_job_ptr->burst_buffer, slim, buffer);
+		_packstr_slim(dump_job_ptr->burst_buffer_state, slim, buffer);
+		_packstr_slim(dump_job_ptr->system_comment, slim, buffer);
 
 		assoc_mgr_lock(&locks);
 		if (dump_job_ptr->qos_ptr)
@@ -9992,7 +11035,7 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 		packstr(dump_job_ptr->licenses, buffer);
 		packstr(dump_job_ptr->state_desc, buffer);
 		packstr(dump_job_ptr->resv_name, buffer);
-		packstr(dump_job_ptr->mcs_label, buffer);
+		_packstr_slim(dump_job_ptr->mcs_label, slim, buffer);
 
 		pack32(dump_job_ptr->exit_code, buffer);
 		pack32(dump_job_ptr->derived_ec, buffer);
@@ -10008,11 +11051,11 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 
 		packstr(dump_job_ptr->name, buffer);
 		packstr(dump_job_ptr->user_name, buffer);
-		packstr(dump_job_ptr->wckey, buffer);
+		_packstr_slim(dump_job_ptr->wckey, slim, buffer);
 		pack32(dump_job_ptr->req_switch, buffer);
 		pack32(dump_job_ptr->wait4switch, buffer);
 
-		packstr(dump_job_ptr->alloc_node, buffer);
+		_packstr_slim(dump_job_ptr->alloc_node, slim, buffer);
 		if (!IS_JOB_COMPLETING(dump_job_ptr))
 			pack_bit_str_hex(dump_job_ptr->node_bitmap, buffer);
 		else
@@ -10022,7 +11065,7 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 					     buffer, protocol_version);
 
 		/* A few details are always dumped here */
-		_pack_default_job_details(dump_job_ptr, buffer,
+		_pack_default_job_details(dump_job_ptr, show_flags, buffer,
 					  protocol_version);
 
 		/* other job details are only dumped until the job starts
@@ -10034,8 +11077,8 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 			_pack_pending_job_details(NULL, buffer,
 						  protocol_version);
 		pack32(dump_job_ptr->bit_flags, buffer);
-		packstr(dump_job_ptr->tres_fmt_alloc_str, buffer);
-		packstr(dump_job_ptr->tres_fmt_req_str, buffer);
+		_packstr_slim(dump_job_ptr->tres_fmt_alloc_str, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_fmt_req_str, slim, buffer);
 		pack16(dump_job_ptr->start_protocol_ver, buffer);
 
 		if (dump_job_ptr->fed_details) {
@@ -10056,14 +11099,14 @@ void pack_job(struct job_record *dump_job_ptr, uint16_t show_flags, Buf buffer,
 			packnull(buffer);
 		}
 
-		packstr(dump_job_ptr->cpus_per_tres, buffer);
-		packstr(dump_job_ptr->mem_per_tres, buffer);
-		packstr(dump_job_ptr->tres_bind, buffer);
-		packstr(dump_job_ptr->tres_freq, buffer);
-		packstr(dump_job_ptr->tres_per_job, buffer);
-		packstr(dump_job_ptr->tres_per_node, buffer);
-		packstr(dump_job_ptr->tres_per_socket, buffer);
-		packstr(dump_job_ptr->tres_per_task, buffer);
+		_packstr_slim(dump_job_ptr->cpus_per_tres, slim, buffer);
+		_packstr_slim(dump_job_ptr->mem_per_tres, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_bind, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_freq, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_job, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_node, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_socket, slim, buffer);
+		_packstr_slim(dump_job_ptr->tres_per_task, slim, buffer);
 	} else {
 		error("pack_job: protocol_version "
 		      "%hu not supported", protocol_version);
@@ -10099,7 +11142,8 @@ static void _find_node_config(int *cpu_cnt_ptr, int *core_cnt_ptr)
 
 /* pack default job details for "get_job_info" RPC */
 static void _pack_default_job_details(struct job_record *job_ptr,
-				      Buf buffer, uint16_t protocol_version)
+				      uint16_t show_flags, Buf buffer,
+				      uint16_t protocol_version)
 {
 	int max_cpu_cnt = -1, max_core_cnt = -1;
 	int i;
@@ -10139,12 +11183,15 @@ static void _pack_default_job_details(struct job_record *job_ptr,
 
 	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		if (detail_ptr) {
-			packstr(detail_ptr->features,   buffer);
-			packstr(detail_ptr->cluster_features, buffer);
-			packstr(detail_ptr->work_dir,   buffer);
-			packstr(detail_ptr->dependency, buffer);
+			bool slim = (show_flags & SHOW_SLIM);
+
+			_packstr_slim(detail_ptr->features, slim, buffer);
+			_packstr_slim(detail_ptr->cluster_features, slim,
+				      buffer);
+			_packstr_slim(detail_ptr->work_dir, slim, buffer);
+			_packstr_slim(detail_ptr->dependency, slim, buffer);
 
-			if (detail_ptr->argv) {
+			if (detail_ptr->argv && !slim) {
 				char *cmd_line = NULL;
 				for (i = 0; detail_ptr->argv[i]; i++) {
 					if (i != 0)
@@ -10448,17 +11495,31 @@ void purge_old_job(void)
 	}
 	list_iterator_destroy(job_iterator);
 
-	i = list_delete_all(job_list, &_list_find_job_old, "");
+	/*
+	 * Unlink expired job records while holding the job write lock, but
+	 * defer the (relatively slow) release of their memory to the
+	 * xfree_deferred() reaper. This minimizes the time the job lock
+	 * is held when many jobs age out at once.
+	 */
+	i = 0;
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = list_next(job_iterator))) {
+		if (!_list_find_job_old(job_ptr, ""))
+			continue;
+		list_remove(job_iterator);
+		_unlink_job_record(job_ptr);
+		xfree_deferred(job_ptr, _free_job_record);
+		i++;
+	}
+	list_iterator_destroy(job_iterator);
 	if (i) {
 		debug2("purge_old_job: purged %d old job records", i);
 		last_job_update = time(NULL);
-		slurm_mutex_lock(&purge_thread_lock);
-		slurm_cond_signal(&purge_thread_cond);
-		slurm_mutex_unlock(&purge_thread_lock);
 	}
 }
 
 
+
 /*
  * purge_job_record - purge specific job record. No testing is performed to
  *	ensure the job records has no active references. Use only for job
@@ -11205,6 +12266,8 @@ static int _update_job(struct job_record *job_ptr, job_desc_msg_t * job_specs,
 	if (job_ptr->db_index == NO_VAL64)
 		return ESLURM_JOB_SETTING_DB_INX;
 
+	job_state_cache_clear(job_ptr);
+
 	operator = validate_operator(uid);
 	if (job_specs->burst_buffer) {
 		/*
@@ -12229,6 +13292,7 @@ static int _update_job(struct job_record *job_ptr, job_desc_msg_t * job_specs,
 					_xmit_new_end_time(job_ptr);
 				}
 				job_ptr->end_time_exp = job_ptr->end_time;
+				job_time_limit_register(job_ptr, now);
 			}
 			sched_info("%s: setting time_limit to %u for %pJ",
 				   __func__, job_specs->time_limit, job_ptr);
@@ -12288,6 +13352,7 @@ static int _update_job(struct job_record *job_ptr, job_desc_msg_t * job_specs,
 			int delta_t  = job_specs->end_time - job_ptr->end_time;
 			job_ptr->end_time = job_specs->end_time;
 			job_ptr->time_limit += (delta_t+30)/60; /* Sec->min */
+			job_time_limit_register(job_ptr, now);
 			sched_info("%s: setting time_limit to %u for %pJ",
 				   __func__, job_ptr->time_limit, job_ptr);
 			/* Always use the acct_policy_limit_set.*
@@ -13377,6 +14442,75 @@ extern int update_job(slurm_msg_t *msg, uid_t uid, bool send_msg)
 	return rc;
 }
 
+/*
+ * Apply a job update to the tasks of array_bitmap still held by a
+ * pending meta job record. When only part of the record's tasks are
+ * affected, those tasks are first split out into one meta record of
+ * their own, so the update touches a single record rather than one per
+ * task. The bits serviced here are cleared from array_bitmap.
+ * RET ESLURM_JOB_SETTING_DB_INX if the update must be retried later,
+ *	otherwise SLURM_SUCCESS (per task results go into resp_array)
+ */
+static int _update_job_array_meta(struct job_record *job_ptr,
+				  job_desc_msg_t *job_specs, uid_t uid,
+				  bitstr_t **array_bitmap_ptr,
+				  resp_array_struct_t **resp_array)
+{
+	struct job_record *new_job_ptr;
+	bitstr_t *array_bitmap = *array_bitmap_ptr, *tmp_bitmap;
+	int len, rc2;
+
+	if (!IS_JOB_PENDING(job_ptr) || !job_ptr->array_recs ||
+	    !job_ptr->array_recs->task_id_bitmap)
+		return SLURM_SUCCESS;
+
+	/* Ensure bitmap sizes match for AND operations */
+	len = bit_size(job_ptr->array_recs->task_id_bitmap);
+	if (bit_size(array_bitmap) < len) {
+		array_bitmap = bit_realloc(array_bitmap, len);
+		*array_bitmap_ptr = array_bitmap;
+	} else if (bit_size(array_bitmap) > len) {
+		job_ptr->array_recs->task_id_bitmap = bit_realloc(
+			job_ptr->array_recs->task_id_bitmap,
+			bit_size(array_bitmap));
+	}
+
+	if (!bit_overlap(job_ptr->array_recs->task_id_bitmap,
+			 array_bitmap)) {
+		/* Nothing to do with this job record */
+	} else if (bit_super_set(job_ptr->array_recs->task_id_bitmap,
+				 array_bitmap)) {
+		/* Update the record with all pending tasks */
+		rc2 = _update_job(job_ptr, job_specs, uid);
+		if (rc2 == ESLURM_JOB_SETTING_DB_INX)
+			return rc2;
+		_resp_array_add(resp_array, job_ptr, rc2);
+		bit_and_not(array_bitmap,
+			    job_ptr->array_recs->task_id_bitmap);
+	} else {
+		/* Split the tasks to be modified out to a separate meta
+		 * job record and update that */
+		tmp_bitmap = bit_copy(job_ptr->array_recs->task_id_bitmap);
+		bit_and(tmp_bitmap, array_bitmap);
+		new_job_ptr = _job_array_split_select(job_ptr, tmp_bitmap);
+		if (!new_job_ptr) {
+			error("%s: Unable to copy record for %pJ",
+			      __func__, job_ptr);
+		} else {
+			rc2 = _update_job(job_ptr, job_specs, uid);
+			if (rc2 == ESLURM_JOB_SETTING_DB_INX) {
+				FREE_NULL_BITMAP(tmp_bitmap);
+				return rc2;
+			}
+			_resp_array_add(resp_array, job_ptr, rc2);
+			bit_and_not(array_bitmap, tmp_bitmap);
+		}
+		FREE_NULL_BITMAP(tmp_bitmap);
+	}
+
+	return SLURM_SUCCESS;
+}
+
 /*
  * IN msg - RPC to update job, including change specification
  * IN job_specs - a job's specification
@@ -13390,14 +14524,14 @@ extern int update_job_str(slurm_msg_t *msg, uid_t uid)
 
 	slurm_msg_t resp_msg;
 	job_desc_msg_t *job_specs = (job_desc_msg_t *) msg->data;
-	struct job_record *job_ptr, *new_job_ptr, *pack_job;
+	struct job_record *job_ptr, *pack_job;
 	ListIterator iter;
 	long int long_id;
 	uint32_t job_id = 0, pack_offset;
-	bitstr_t *array_bitmap = NULL, *tmp_bitmap;
+	bitstr_t *array_bitmap = NULL;
 	bool valid = true;
 	int32_t i, i_first, i_last;
-	int len, rc = SLURM_SUCCESS, rc2;
+	int rc = SLURM_SUCCESS, rc2;
 	char *end_ptr, *tok, *tmp = NULL;
 	char *job_id_str;
 	resp_array_struct_t *resp_array = NULL;
@@ -13515,60 +14649,31 @@ extern int update_job_str(slurm_msg_t *msg, uid_t uid)
 		goto reply;
 	}
 
+	/* Update tasks still held by meta job records, splitting out
+	 * partially affected meta records as needed */
 	job_ptr = find_job_record(job_id);
-	if (job_ptr && IS_JOB_PENDING(job_ptr) &&
-	    job_ptr->array_recs && job_ptr->array_recs->task_id_bitmap) {
-		/* Ensure bitmap sizes match for AND operations */
-		len = bit_size(job_ptr->array_recs->task_id_bitmap);
-		i_last++;
-		if (i_last < len) {
-			array_bitmap = bit_realloc(array_bitmap, len);
-		} else {
-			array_bitmap = bit_realloc(array_bitmap, i_last);
-			job_ptr->array_recs->task_id_bitmap = bit_realloc(
-				job_ptr->array_recs->task_id_bitmap, i_last);
+	if (job_ptr) {
+		rc2 = _update_job_array_meta(job_ptr, job_specs, uid,
+					     &array_bitmap, &resp_array);
+		if (rc2 == ESLURM_JOB_SETTING_DB_INX) {
+			rc = rc2;
+			goto reply;
 		}
-		if (!bit_overlap(job_ptr->array_recs->task_id_bitmap,
-				 array_bitmap)) {
-			/* Nothing to do with this job record */
-		} else if (bit_super_set(job_ptr->array_recs->task_id_bitmap,
-					 array_bitmap)) {
-			/* Update the record with all pending tasks */
-			rc2 = _update_job(job_ptr, job_specs, uid);
+	}
+	/* Tasks may also be held by meta records split out of the
+	 * array's base record */
+	job_ptr = job_array_hash_j[JOB_HASH_INX(job_id)];
+	while (job_ptr) {
+		if (job_ptr->array_job_id == job_id) {
+			rc2 = _update_job_array_meta(job_ptr, job_specs, uid,
+						     &array_bitmap,
+						     &resp_array);
 			if (rc2 == ESLURM_JOB_SETTING_DB_INX) {
 				rc = rc2;
 				goto reply;
 			}
-			_resp_array_add(&resp_array, job_ptr, rc2);
-			bit_and_not(array_bitmap,
-				    job_ptr->array_recs->task_id_bitmap);
-		} else {
-			/* Need to split out tasks to separate job records */
-			tmp_bitmap = bit_copy(job_ptr->array_recs->
-					      task_id_bitmap);
-			bit_and(tmp_bitmap, array_bitmap);
-			i_first = bit_ffs(tmp_bitmap);
-			if (i_first >= 0)
-				i_last = bit_fls(tmp_bitmap);
-			else
-				i_last = -2;
-			for (i = i_first; i <= i_last; i++) {
-				if (!bit_test(tmp_bitmap, i))
-					continue;
-				job_ptr->array_task_id = i;
-				new_job_ptr = job_array_split(job_ptr);
-				if (!new_job_ptr) {
-					error("%s: Unable to copy record for %pJ",
-					      __func__, job_ptr);
-				} else {
-					/* The array_recs structure is moved
-					 * to the new job record copy */
-					bb_g_job_validate2(job_ptr, NULL);
-					job_ptr = new_job_ptr;
-				}
-			}
-			FREE_NULL_BITMAP(tmp_bitmap);
 		}
+		job_ptr = job_ptr->job_array_next_j;
 	}
 
 	i_first = bit_ffs(array_bitmap);
@@ -14853,6 +15958,33 @@ static void _job_array_comp(struct job_record *job_ptr, bool was_running,
 }
 
 /* log the completion of the specified job */
+extern bool job_timing_stamp(uint64_t *stamp)
+{
+	struct timeval tv;
+
+	if (*stamp)
+		return false;
+	gettimeofday(&tv, NULL);
+	*stamp = ((uint64_t) tv.tv_sec * 1000000) + tv.tv_usec;
+
+	return true;
+}
+
+extern void job_timing_interval(uint64_t from, uint64_t to, uint32_t *hist)
+{
+	uint64_t usec;
+	int bucket = 0;
+
+	if (!from || (to <= from))
+		return;
+	usec = to - from;
+	while ((usec > 1) && (bucket < (JOB_TIMING_NBUCKETS - 1))) {
+		usec >>= 1;
+		bucket++;
+	}
+	hist[bucket]++;
+}
+
 extern void job_completion_logger(struct job_record *job_ptr, bool requeue)
 {
 	int base_state;
@@ -14863,6 +15995,8 @@ extern void job_completion_logger(struct job_record *job_ptr, bool requeue)
 
 	xassert(job_ptr);
 
+	(void) job_timing_stamp(&job_ptr->timing.complete);
+
 	acct_policy_remove_job_submit(job_ptr);
 	if (job_ptr->nodes && ((job_ptr->bit_flags & JOB_KILL_HURRY) == 0)
 	    && !IS_JOB_RESIZING(job_ptr)) {
@@ -15543,6 +16677,7 @@ static int _job_suspend_op(struct job_record *job_ptr, uint16_t op,
 				- job_ptr->pre_sus_time;
 		}
 		resume_job_step(job_ptr);
+		job_time_limit_register(job_ptr, now);
 	}
 
 	job_ptr->time_last_active = now;
@@ -15894,6 +17029,7 @@ static int _job_requeue_op(uid_t uid, struct job_record *job_ptr, bool preempt,
 	}
 
 	last_job_update = now;
+	job_state_cache_clear(job_ptr);
 
 	/*
 	 * In the job is in the process of completing
@@ -17579,6 +18715,8 @@ extern void job_end_time_reset(struct job_record *job_ptr)
 				    (job_ptr->time_limit * 60);	/* secs */
 	}
 	job_ptr->end_time_exp = job_ptr->end_time;
+	if (IS_JOB_RUNNING(job_ptr))
+		job_time_limit_register(job_ptr, time(NULL));
 }
 
 /* trace_job() - print the job details if
@@ -66,6 +66,7 @@
 #include "src/common/power.h"
 #include "src/common/slurm_accounting_storage.h"
 #include "src/common/slurm_acct_gather.h"
+#include "src/common/slurm_time.h"
 #include "src/common/strlcpy.h"
 #include "src/common/parse_time.h"
 #include "src/common/timers.h"
@@ -117,9 +118,11 @@ static char **	_build_env(struct job_record *job_ptr, bool is_epilog);
 static batch_job_launch_msg_t *_build_launch_job_msg(struct job_record *job_ptr,
 						     uint16_t protocol_version);
 static void	_depend_list_del(void *dep_ptr);
-static void	_job_queue_append(List job_queue, struct job_record *job_ptr,
+static void	_job_queue_append(xvector_t *job_queue, xarena_t *arena,
+				  struct job_record *job_ptr,
 				  struct part_record *part_ptr, uint32_t priority);
-static void	_job_queue_rec_del(void *x);
+static void	_split_job_array_bb(struct job_record *job_ptr);
+static void	_split_job_array_correspond(struct job_record *job_ptr);
 static bool	_job_runnable_test1(struct job_record *job_ptr,
 				    bool clear_start);
 static bool	_job_runnable_test2(struct job_record *job_ptr,
@@ -233,23 +236,20 @@ static List _build_user_job_list(uint32_t user_id, char* job_name)
 	return job_queue;
 }
 
-static void _job_queue_append(List job_queue, struct job_record *job_ptr,
+static void _job_queue_append(xvector_t *job_queue, xarena_t *arena,
+			      struct job_record *job_ptr,
 			      struct part_record *part_ptr, uint32_t prio)
 {
 	job_queue_rec_t *job_queue_rec;
 
-	job_queue_rec = xmalloc(sizeof(job_queue_rec_t));
+	job_queue_rec = xarena_alloc(arena, sizeof(job_queue_rec_t));
 	job_queue_rec->array_task_id = job_ptr->array_task_id;
 	job_queue_rec->job_id   = job_ptr->job_id;
 	job_queue_rec->job_ptr  = job_ptr;
 	job_queue_rec->part_ptr = part_ptr;
 	job_queue_rec->priority = prio;
-	list_append(job_queue, job_queue_rec);
-}
-
-static void _job_queue_rec_del(void *x)
-{
-	xfree(x);
+	job_queue_rec->presched_reject = false;
+	xvector_append(job_queue, job_queue_rec);
 }
 
 /* Return true if the job has some step still in a cleaning state, which
@@ -282,7 +282,7 @@ static bool _job_runnable_test1(struct job_record *job_ptr, bool sched_plugin)
 {
 	bool job_indepen = false;
 	uint16_t cleaning = 0;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 
 	xassert(job_ptr->magic == JOB_MAGIC);
 	if (!IS_JOB_PENDING(job_ptr) || IS_JOB_COMPLETING(job_ptr))
@@ -393,126 +393,154 @@ static bool _job_runnable_test3(struct job_record *job_ptr,
 	return true;
 }
 
+/* Split an individual job record out of a job array that needs burst
+ * buffer staging */
+static void _split_job_array_bb(struct job_record *job_ptr)
+{
+	struct job_record *new_job_ptr;
+	int i, pend_cnt;
+
+	if (!IS_JOB_PENDING(job_ptr) ||
+	    !job_ptr->burst_buffer || !job_ptr->array_recs ||
+	    !job_ptr->array_recs->task_id_bitmap ||
+	    (job_ptr->array_task_id != NO_VAL))
+		return;
+
+	if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
+		return;
+	pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
+	if (pend_cnt >= bb_array_stage_cnt)
+		return;
+	if (job_ptr->array_recs->task_cnt < 1)
+		return;
+	if (job_ptr->array_recs->task_cnt == 1) {
+		job_ptr->array_task_id = i;
+		(void) job_array_post_sched(job_ptr);
+		return;
+	}
+	job_ptr->array_task_id = i;
+	new_job_ptr = job_array_split(job_ptr);
+	if (new_job_ptr) {
+		debug("%s: Split out %pJ for burst buffer use",
+		      __func__, job_ptr);
+		new_job_ptr->job_state = JOB_PENDING;
+		new_job_ptr->start_time = (time_t) 0;
+		/* Do NOT clear db_index here, it is handled when
+		 * task_id_str is created elsewhere */
+		(void) bb_g_job_validate2(job_ptr, NULL);
+	} else {
+		error("%s: Unable to copy record for %pJ",
+		      __func__, job_ptr);
+	}
+}
+
+/* Split an individual job record out of a job array with
+ * depend_type == SLURM_DEPEND_AFTER_CORRESPOND */
+static void _split_job_array_correspond(struct job_record *job_ptr)
+{
+	ListIterator depend_iter;
+	struct job_record *new_job_ptr;
+	struct depend_spec *dep_ptr;
+	int i, pend_cnt, dep_corr;
+
+	if (!IS_JOB_PENDING(job_ptr) ||
+	    !job_ptr->array_recs ||
+	    !job_ptr->array_recs->task_id_bitmap ||
+	    (job_ptr->array_task_id != NO_VAL))
+		return;
+	if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
+		return;
+	if ((job_ptr->details == NULL) ||
+	    (job_ptr->details->depend_list == NULL) ||
+	    (list_count(job_ptr->details->depend_list) == 0))
+		return;
+	depend_iter = list_iterator_create(
+		job_ptr->details->depend_list);
+	dep_corr = 0;
+	while ((dep_ptr = list_next(depend_iter))) {
+		if (dep_ptr->depend_type ==
+		    SLURM_DEPEND_AFTER_CORRESPOND) {
+			dep_corr = 1;
+			break;
+		}
+	}
+	list_iterator_destroy(depend_iter);
+	if (!dep_corr)
+		return;
+	pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
+	if (pend_cnt >= CORRESPOND_ARRAY_TASK_CNT)
+		return;
+	if (job_ptr->array_recs->task_cnt < 1)
+		return;
+	if (job_ptr->array_recs->task_cnt == 1) {
+		job_ptr->array_task_id = i;
+		(void) job_array_post_sched(job_ptr);
+		return;
+	}
+	job_ptr->array_task_id = i;
+	new_job_ptr = job_array_split(job_ptr);
+	if (new_job_ptr) {
+		info("%s: Split out %pJ for SLURM_DEPEND_AFTER_CORRESPOND use",
+		     __func__, job_ptr);
+		new_job_ptr->job_state = JOB_PENDING;
+		new_job_ptr->start_time = (time_t) 0;
+		/* Do NOT clear db_index here, it is handled when
+		 * task_id_str is created elsewhere */
+	} else {
+		error("%s: Unable to copy record for %pJ",
+		      __func__, job_ptr);
+	}
+}
+
 /*
  * build_job_queue - build (non-priority ordered) list of pending jobs
  * IN clear_start - if set then clear the start_time for pending jobs,
  *		    true when called from sched/backfill or sched/builtin
  * IN backfill - true if running backfill scheduler, enforce min time limit
+ * OUT arena_p - arena holding the queue records; the caller must call
+ *	xarena_destroy() on it once done with the queue and must not
+ *	xfree() individual records popped from the queue
  * RET the job queue
- * NOTE: the caller must call FREE_NULL_LIST() on RET value to free memory
+ * NOTE: the caller must call FREE_NULL_XVECTOR() on RET value to free memory
  */
-extern List build_job_queue(bool clear_start, bool backfill)
+extern xvector_t *build_job_queue(bool clear_start, bool backfill,
+				  xarena_t **arena_p)
 {
 	static time_t last_log_time = 0;
-	List job_queue;
-	ListIterator depend_iter, job_iterator, part_iterator;
-	struct job_record *job_ptr = NULL, *new_job_ptr;
+	xvector_t *job_queue;
+	ListIterator job_iterator, part_iterator;
+	struct job_record *job_ptr = NULL;
 	struct part_record *part_ptr;
-	struct depend_spec *dep_ptr;
-	int i, pend_cnt, reason, dep_corr;
+	int reason;
 	struct timeval start_tv = {0, 0};
 	int tested_jobs = 0;
 	int job_part_pairs = 0;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 
 	/* init the timer */
 	(void) slurm_delta_tv(&start_tv);
-	job_queue = list_create(_job_queue_rec_del);
+	*arena_p = xarena_create();
+	job_queue = xvector_create(NULL);
 
-	/* Create individual job records for job arrays that need burst buffer
-	 * staging */
+	/*
+	 * All of the work below was formerly done in three separate full
+	 * passes over job_list (two job array split passes, then the queue
+	 * build pass). Fold everything into a single pass so a large job
+	 * list is only walked once per scheduling cycle. Records split out
+	 * of a job array are appended to job_list and picked up later by
+	 * this same iterator, just as they were by the subsequent passes
+	 * before.
+	 */
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->burst_buffer || !job_ptr->array_recs ||
-		    !job_ptr->array_recs->task_id_bitmap ||
-		    (job_ptr->array_task_id != NO_VAL))
-			continue;
+		/* Create individual job records for job arrays that need
+		 * burst buffer staging */
+		_split_job_array_bb(job_ptr);
 
-		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
-			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= bb_array_stage_cnt)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		if (new_job_ptr) {
-			debug("%s: Split out %pJ for burst buffer use",
-			      __func__, job_ptr);
-			new_job_ptr->job_state = JOB_PENDING;
-			new_job_ptr->start_time = (time_t) 0;
-			/* Do NOT clear db_index here, it is handled when
-			 * task_id_str is created elsewhere */
-			(void) bb_g_job_validate2(job_ptr, NULL);
-		} else {
-			error("%s: Unable to copy record for %pJ",
-			      __func__, job_ptr);
-		}
-	}
-	list_iterator_destroy(job_iterator);
-
-	/* Create individual job records for job arrays with
-	 * depend_type == SLURM_DEPEND_AFTER_CORRESPOND */
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->array_recs ||
-		    !job_ptr->array_recs->task_id_bitmap ||
-		    (job_ptr->array_task_id != NO_VAL))
-			continue;
-		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
-			continue;
-		if ((job_ptr->details == NULL) ||
-		    (job_ptr->details->depend_list == NULL) ||
-		    (list_count(job_ptr->details->depend_list) == 0))
-			continue;
-		depend_iter = list_iterator_create(
-			job_ptr->details->depend_list);
-		dep_corr = 0;
-		while ((dep_ptr = list_next(depend_iter))) {
-			if (dep_ptr->depend_type ==
-			    SLURM_DEPEND_AFTER_CORRESPOND) {
-				dep_corr = 1;
-				break;
-			}
-		}
-		if (!dep_corr)
-			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= CORRESPOND_ARRAY_TASK_CNT)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		if (new_job_ptr) {
-			info("%s: Split out %pJ for SLURM_DEPEND_AFTER_CORRESPOND use",
-			     __func__, job_ptr);
-			new_job_ptr->job_state = JOB_PENDING;
-			new_job_ptr->start_time = (time_t) 0;
-			/* Do NOT clear db_index here, it is handled when
-			 * task_id_str is created elsewhere */
-		} else {
-			error("%s: Unable to copy record for %pJ",
-			      __func__, job_ptr);
-		}
-	}
-	list_iterator_destroy(job_iterator);
+		/* Create individual job records for job arrays with
+		 * depend_type == SLURM_DEPEND_AFTER_CORRESPOND */
+		_split_job_array_correspond(job_ptr);
 
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
 		if (IS_JOB_PENDING(job_ptr))
 			acct_policy_handle_accrue_time(job_ptr, false);
 
@@ -572,13 +600,13 @@ extern List build_job_queue(bool clear_start, bool backfill)
 					continue;
 				job_part_pairs++;
 				if (job_ptr->priority_array) {
-					_job_queue_append(job_queue, job_ptr,
-							  part_ptr,
+					_job_queue_append(job_queue, *arena_p,
+							  job_ptr, part_ptr,
 							  job_ptr->
 							  priority_array[inx]);
 				} else {
-					_job_queue_append(job_queue, job_ptr,
-							  part_ptr,
+					_job_queue_append(job_queue, *arena_p,
+							  job_ptr, part_ptr,
 							  job_ptr->priority);
 				}
 			}
@@ -598,7 +626,7 @@ extern List build_job_queue(bool clear_start, bool backfill)
 			if (!_job_runnable_test2(job_ptr, backfill))
 				continue;
 			job_part_pairs++;
-			_job_queue_append(job_queue, job_ptr,
+			_job_queue_append(job_queue, *arena_p, job_ptr,
 					  job_ptr->part_ptr, job_ptr->priority);
 		}
 	}
@@ -629,7 +657,7 @@ extern bool job_is_completing(bitstr_t *eff_cg_bitmap)
 	if ((job_list == NULL) || (complete_wait == 0))
 		return completing;
 
-	recent = time(NULL) - complete_wait;
+	recent = slurm_cached_time() - complete_wait;
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
 		if (IS_JOB_COMPLETING(job_ptr) &&
@@ -661,7 +689,7 @@ extern void set_job_elig_time(void)
 	ListIterator job_iterator;
 	slurmctld_lock_t job_write_lock =
 		{ READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, NO_LOCK };
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 
 	lock_slurmctld(job_write_lock);
 	job_iterator = list_iterator_create(job_list);
@@ -741,6 +769,200 @@ static bool _all_partition_priorities_same(void)
 	return result;
 }
 
+static time_t sched_domain_time = 0;	/* last_part_update when computed */
+static int sched_domain_cnt = 1;	/* count of disjoint node domains */
+
+/* Relabel every partition in scheduling domain "from" as domain "to" */
+static void _relabel_sched_domain(int from, int to)
+{
+	struct part_record *part_ptr;
+	ListIterator iter;
+
+	iter = list_iterator_create(part_list);
+	while ((part_ptr = (struct part_record *) list_next(iter))) {
+		if (part_ptr->sched_domain == from)
+			part_ptr->sched_domain = to;
+	}
+	list_iterator_destroy(iter);
+}
+
+/*
+ * Group the partitions into disjoint node domains. Partitions whose node
+ * bitmaps overlap (directly or through some other partition) share a
+ * domain; partitions on completely disjoint node sets land in different
+ * domains and their pending jobs can be screened by separate threads.
+ * Recomputed only after a partition change. Caller must hold at least a
+ * partition read lock; sched_domain is scheduler-private scratch space.
+ */
+static void _build_sched_domains(void)
+{
+	struct part_record *part_ptr;
+	ListIterator iter;
+	bitstr_t **dom_bitmap;
+	int dom_cnt = 0, d, first;
+
+	if (sched_domain_time == last_part_update)
+		return;
+
+	dom_bitmap = xcalloc(list_count(part_list), sizeof(bitstr_t *));
+	iter = list_iterator_create(part_list);
+	while ((part_ptr = (struct part_record *) list_next(iter))) {
+		if (!part_ptr->node_bitmap ||
+		    (bit_ffs(part_ptr->node_bitmap) == -1)) {
+			/* Empty partition conflicts with nothing */
+			part_ptr->sched_domain = 0;
+			continue;
+		}
+		first = -1;
+		for (d = 0; d < dom_cnt; d++) {
+			if (!bit_overlap(dom_bitmap[d],
+					 part_ptr->node_bitmap))
+				continue;
+			if (first == -1) {
+				first = d;
+				bit_or(dom_bitmap[d], part_ptr->node_bitmap);
+				part_ptr->sched_domain = d;
+				continue;
+			}
+			/* This partition bridges two domains, merge them */
+			bit_or(dom_bitmap[first], dom_bitmap[d]);
+			bit_free(dom_bitmap[d]);
+			_relabel_sched_domain(d, first);
+			dom_bitmap[d] = dom_bitmap[--dom_cnt];
+			if (d != dom_cnt)
+				_relabel_sched_domain(dom_cnt, d);
+			d--;	/* re-test the domain moved into this slot */
+		}
+		if (first == -1) {
+			dom_bitmap[dom_cnt] = bit_copy(part_ptr->node_bitmap);
+			part_ptr->sched_domain = dom_cnt++;
+		}
+	}
+	list_iterator_destroy(iter);
+	for (d = 0; d < dom_cnt; d++)
+		bit_free(dom_bitmap[d]);
+	xfree(dom_bitmap);
+
+	sched_domain_cnt = MAX(dom_cnt, 1);
+	sched_domain_time = last_part_update;
+	sched_debug("%d partition scheduling domain(s)", sched_domain_cnt);
+}
+
+typedef struct presched_args {
+	xvector_t *job_queue;	/* sorted queue shared by all workers */
+	int worker_id;		/* this worker's index */
+	int worker_cnt;		/* total count of workers */
+	bool rejected;		/* OUT - some job's state was changed */
+} presched_args_t;
+
+/*
+ * Pre-screen worker for one set of scheduling domains. Each queue entry
+ * belongs to exactly one domain (that of its partition) and each domain
+ * to exactly one worker, so the workers operate on disjoint sets of
+ * entries. Only simple jobs (single partition, not an array or pack job
+ * component) are screened here; they have exactly one queue entry, making
+ * this worker the only thread touching the job record. The tests applied
+ * are those main-pass tests whose outcome cannot be changed by jobs
+ * started later in the same pass: resources only shrink and accounting
+ * limits only tighten as the pass proceeds, so a job rejected against the
+ * initial state would also be rejected by the serialized pass.
+ */
+static void *_presched_worker(void *x)
+{
+	presched_args_t *args = (presched_args_t *) x;
+	job_queue_rec_t *job_queue_rec;
+	struct job_record *job_ptr;
+	uint32_t i, queue_cnt = xvector_count(args->job_queue);
+	int avail_nodes;
+
+	for (i = 0; i < queue_cnt; i++) {
+		job_queue_rec = (job_queue_rec_t *)
+			xvector_get(args->job_queue, i);
+		if ((job_queue_rec->part_ptr->sched_domain %
+		     args->worker_cnt) != args->worker_id)
+			continue;
+		job_ptr = job_queue_rec->job_ptr;
+		if (job_ptr->part_ptr_list || job_ptr->pack_job_id ||
+		    job_ptr->array_recs ||
+		    (job_ptr->array_task_id != NO_VAL))
+			continue;
+		if (!IS_JOB_PENDING(job_ptr)) {
+			job_queue_rec->presched_reject = true;
+			continue;
+		}
+		if (!_job_runnable_test3(job_ptr, job_queue_rec->part_ptr)) {
+			job_queue_rec->presched_reject = true;
+			continue;
+		}
+		if (!acct_policy_job_runnable_state(job_ptr) &&
+		    !acct_policy_job_runnable_pre_select(job_ptr, false)) {
+			job_queue_rec->presched_reject = true;
+			args->rejected = true;
+			continue;
+		}
+		if ((job_ptr->state_reason == WAIT_NODE_NOT_AVAIL) &&
+		    job_ptr->details && job_ptr->details->req_node_bitmap &&
+		    !bit_super_set(job_ptr->details->req_node_bitmap,
+				   avail_node_bitmap)) {
+			job_queue_rec->presched_reject = true;
+			continue;
+		}
+		avail_nodes = bit_overlap(avail_node_bitmap,
+					  job_queue_rec->part_ptr->node_bitmap);
+		if ((job_ptr->details &&
+		     (job_ptr->details->min_nodes != NO_VAL) &&
+		     (job_ptr->details->min_nodes > avail_nodes)) ||
+		    (!job_ptr->details && (avail_nodes == 0))) {
+			job_ptr->state_reason = WAIT_RESOURCES;
+			xfree(job_ptr->state_desc);
+			job_ptr->state_desc = xstrdup("Nodes required for job are DOWN, DRAINED or reserved for jobs in higher priority partitions");
+			job_queue_rec->presched_reject = true;
+			args->rejected = true;
+			continue;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Screen the sorted job queue with one worker thread per group of
+ * scheduling domains, leaving the serialized main pass to handle the
+ * survivors plus everything the workers do not cover. Caller must hold
+ * the job write lock. Returns true if some job's state was changed.
+ */
+static bool _presched_queue(xvector_t *job_queue, int thread_cnt)
+{
+	presched_args_t *presched_args;
+	pthread_t *presched_tids;
+	bool rejected = false;
+	int i, worker_cnt;
+
+	_build_sched_domains();
+	worker_cnt = MIN(thread_cnt, sched_domain_cnt);
+	if (worker_cnt < 2)
+		return false;
+
+	presched_args = xcalloc(worker_cnt, sizeof(presched_args_t));
+	presched_tids = xcalloc(worker_cnt, sizeof(pthread_t));
+	for (i = 0; i < worker_cnt; i++) {
+		presched_args[i].job_queue  = job_queue;
+		presched_args[i].worker_id  = i;
+		presched_args[i].worker_cnt = worker_cnt;
+		slurm_thread_create(&presched_tids[i], _presched_worker,
+				    &presched_args[i]);
+	}
+	for (i = 0; i < worker_cnt; i++) {
+		pthread_join(presched_tids[i], NULL);
+		if (presched_args[i].rejected)
+			rejected = true;
+	}
+	xfree(presched_tids);
+	xfree(presched_args);
+
+	return rejected;
+}
+
 /*
  * schedule - attempt to schedule all pending jobs
  *	pending jobs for each partition will be scheduled in priority
@@ -800,7 +1022,9 @@ extern int schedule(uint32_t job_limit)
 		sched_job_limit = NO_VAL;
 		slurm_mutex_unlock(&sched_mutex);
 
+		PHASE_TRACE_BEGIN(PHASE_TRACE_SCHED_CYCLE);
 		job_count = _schedule(job_limit);
+		PHASE_TRACE_END(PHASE_TRACE_SCHED_CYCLE);
 
 		slurm_mutex_lock(&sched_mutex);
 		gettimeofday(&now, NULL);
@@ -871,7 +1095,7 @@ extern bool deadline_ok(struct job_record *job_ptr, char *func)
 	bool fail_job = false;
 	time_t inter;
 
-	now = time(NULL);
+	now = slurm_cached_time();
 	if ((job_ptr->time_min) && (job_ptr->time_min != NO_VAL)) {
 		inter = now + job_ptr->time_min * 60;
 		if (job_ptr->deadline < inter) {
@@ -914,7 +1138,8 @@ extern bool deadline_ok(struct job_record *job_ptr, char *func)
 static int _schedule(uint32_t job_limit)
 {
 	ListIterator job_iterator = NULL, part_iterator = NULL;
-	List job_queue = NULL;
+	xvector_t *job_queue = NULL;
+	xarena_t *job_queue_arena = NULL;
 	int failed_part_cnt = 0, failed_resv_cnt = 0, job_cnt = 0;
 	int error_code, i, j, part_cnt, time_limit, pend_time;
 	uint32_t job_depth = 0, array_task_id;
@@ -934,6 +1159,7 @@ static int _schedule(uint32_t job_limit)
 	static bool fifo_sched = false;
 	static bool assoc_limit_stop = false;
 	static int sched_timeout = 0;
+	static int sched_domain_threads = 0;
 	static int sched_max_job_start = 0;
 	static int bf_min_age_reserve = 0;
 	static uint32_t bf_min_prio_reserve = 0;
@@ -1139,6 +1365,18 @@ static int _schedule(uint32_t job_limit)
 			sched_min_interval = 2;
 		}
 
+		if ((tmp_ptr = xstrcasestr(sched_params,
+					   "sched_domain_threads="))) {
+			sched_domain_threads = atoi(tmp_ptr + 21);
+			if (sched_domain_threads < 0) {
+				error("Invalid sched_domain_threads: %d",
+				      sched_domain_threads);
+				sched_domain_threads = 0;
+			}
+		} else {
+			sched_domain_threads = 0;
+		}
+
 		if ((tmp_ptr = xstrcasestr(sched_params,
 					   "sched_max_job_start="))) {
 			sched_max_job_start = atoi(tmp_ptr + 20);
@@ -1179,7 +1417,7 @@ static int _schedule(uint32_t job_limit)
 		job_limit = def_job_limit;
 
 	lock_slurmctld(job_write_lock);
-	now = time(NULL);
+	now = slurm_cached_time();
 	sched_start = now;
 	last_job_sched_start = now;
 	START_TIMER;
@@ -1281,9 +1519,12 @@ static int _schedule(uint32_t job_limit)
 		slurmctld_diag_stats.schedule_queue_len = list_count(job_list);
 		job_iterator = list_iterator_create(job_list);
 	} else {
-		job_queue = build_job_queue(false, false);
-		slurmctld_diag_stats.schedule_queue_len = list_count(job_queue);
+		job_queue = build_job_queue(false, false, &job_queue_arena);
+		slurmctld_diag_stats.schedule_queue_len = xvector_count(job_queue);
 		sort_job_queue(job_queue);
+		if (sched_domain_threads &&
+		    _presched_queue(job_queue, sched_domain_threads))
+			last_job_update = now;
 	}
 	while (1) {
 		if (fifo_sched) {
@@ -1330,14 +1571,15 @@ next_part:			part_ptr = (struct part_record *)
 					continue;
 			}
 		} else {
-			job_queue_rec = list_pop(job_queue);
+			job_queue_rec = xvector_pop(job_queue);
 			if (!job_queue_rec)
 				break;
+			if (job_queue_rec->presched_reject)
+				continue;	/* rejected by pre-screen */
 			array_task_id = job_queue_rec->array_task_id;
 			job_ptr  = job_queue_rec->job_ptr;
 			part_ptr = job_queue_rec->part_ptr;
 			job_ptr->priority = job_queue_rec->priority;
-			xfree(job_queue_rec);
 			if (!avail_front_end(job_ptr)) {
 				job_ptr->state_reason = WAIT_FRONT_END;
 				xfree(job_ptr->state_desc);
@@ -1359,7 +1601,7 @@ next_part:			part_ptr = (struct part_record *)
 			job_ptr->part_ptr = part_ptr;
 		}
 
-		job_ptr->last_sched_eval = time(NULL);
+		job_ptr->last_sched_eval = slurm_cached_time();
 
 		if (job_ptr->preempt_in_progress)
 			continue;	/* scheduled in another partition */
@@ -1375,7 +1617,7 @@ next_part:			part_ptr = (struct part_record *)
 			is_job_array_head = false;
 
 next_task:
-		if ((time(NULL) - sched_start) >= sched_timeout) {
+		if ((slurm_cached_time() - sched_start) >= sched_timeout) {
 			sched_debug("loop taking too long, breaking out");
 			break;
 		}
@@ -1587,7 +1829,7 @@ next_task:
 				     job_ptr->priority, job_ptr->partition);
 			continue;
 		}
-		if (license_job_test(job_ptr, time(NULL), true) !=
+		if (license_job_test(job_ptr, slurm_cached_time(), true) !=
 		    SLURM_SUCCESS) {
 			job_ptr->state_reason = WAIT_LICENSES;
 			xfree(job_ptr->state_desc);
@@ -1627,8 +1869,10 @@ next_task:
 			goto skip_start;
 		}
 
+		PHASE_TRACE_BEGIN(PHASE_TRACE_SELECT_NODES);
 		error_code = select_nodes(job_ptr, false, NULL, NULL, false,
 					  SLURMDB_JOB_FLAG_SCHED);
+		PHASE_TRACE_END(PHASE_TRACE_SELECT_NODES);
 
 		if (error_code == SLURM_SUCCESS) {
 			/*
@@ -1843,7 +2087,8 @@ fail_this_part:	if (fail_by_part) {
 		if (part_iterator)
 			list_iterator_destroy(part_iterator);
 	} else if (job_queue) {
-		FREE_NULL_LIST(job_queue);
+		FREE_NULL_XVECTOR(job_queue);
+		xarena_destroy(job_queue_arena);
 	}
 	xfree(sched_part_ptr);
 	xfree(sched_part_jobs);
@@ -1873,9 +2118,9 @@ out:
  * sort_job_queue - sort job_queue in descending priority order
  * IN/OUT job_queue - sorted job queue
  */
-extern void sort_job_queue(List job_queue)
+extern void sort_job_queue(xvector_t *job_queue)
 {
-	list_sort(job_queue, sort_job_queue2);
+	xvector_sort(job_queue, (__compar_fn_t) sort_job_queue2);
 }
 
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
@@ -2095,7 +2340,7 @@ static batch_job_launch_msg_t *_build_launch_job_msg(struct job_record *job_ptr,
 		      job_ptr);
 		slurm_free_job_launch_msg(launch_msg_ptr);
 		job_ptr->batch_flag = 1;	/* Allow repeated requeue */
-		job_ptr->details->begin_time = time(NULL) + 120;
+		job_ptr->details->begin_time = slurm_cached_time() + 120;
 		job_complete(job_ptr->job_id, slurmctld_conf.slurm_user_id,
 			     true, false, 0);
 		return NULL;
@@ -2452,6 +2697,11 @@ extern void launch_job(struct job_record *job_ptr)
 	agent_arg_ptr->msg_type = REQUEST_BATCH_JOB_LAUNCH;
 	agent_arg_ptr->msg_args = (void *) launch_msg_ptr;
 
+	if (job_timing_stamp(&job_ptr->timing.launch))
+		job_timing_interval(job_ptr->timing.alloc,
+				    job_ptr->timing.launch,
+				    slurmctld_diag_stats.job_timing_alloc_launch);
+
 	/* Launch the RPC via agent */
 	agent_queue_request(agent_arg_ptr);
 }
@@ -2687,6 +2937,20 @@ extern int test_job_dependency(struct job_record *job_ptr)
 		return 0;
 	}
 
+	/*
+	 * Dependency outcomes only change when some job changes state, and
+	 * every such change advances last_job_update. If this job was left
+	 * dependent by an evaluation more recent than the last job state
+	 * change then the result must still hold, so skip rescanning the
+	 * dependency list. This matters for large fan-outs (one parent with
+	 * many thousands of afterok dependents), where every scheduling
+	 * cycle otherwise re-tests every dependent in full.
+	 */
+	if ((job_ptr->bit_flags & JOB_DEPENDENT) &&
+	    job_ptr->details->depend_test_time &&
+	    (last_job_update < job_ptr->details->depend_test_time))
+		return 1;
+
 	depend_iter = list_iterator_create(job_ptr->details->depend_list);
 	while ((dep_ptr = list_next(depend_iter))) {
 		bool clear_dep = false;
@@ -2828,7 +3092,7 @@ extern int test_job_dependency(struct job_record *job_ptr)
 			else
 				failure = true;
 		} else if (dep_ptr->depend_type == SLURM_DEPEND_EXPAND) {
-			time_t now = time(NULL);
+			time_t now = slurm_cached_time();
 			if (IS_JOB_PENDING(djob_ptr)) {
 				depends = true;
 			} else if (IS_JOB_COMPLETED(djob_ptr))
@@ -2894,6 +3158,15 @@ extern int test_job_dependency(struct job_record *job_ptr)
 		job_ptr->bit_flags &= ~JOB_DEPENDENT;
 	}
 
+	/*
+	 * Only an unsatisfied-but-valid outcome is reusable; failures and
+	 * satisfied dependencies change job state themselves.
+	 */
+	if (results == 1)
+		job_ptr->details->depend_test_time = time(NULL);
+	else
+		job_ptr->details->depend_test_time = 0;
+
 	return results;
 }
 
@@ -3283,6 +3556,7 @@ extern int update_job_dependency(struct job_record *job_ptr, char *new_depend)
 	if (rc == SLURM_SUCCESS) {
 		FREE_NULL_LIST(job_ptr->details->depend_list);
 		job_ptr->details->depend_list = new_depend_list;
+		job_ptr->details->depend_test_time = 0;
 		_depend_list2str(job_ptr, or_flag);
 #if _DEBUG
 		print_job_dependency(job_ptr);
@@ -3444,7 +3718,7 @@ extern int job_start_data(job_desc_msg_t *job_desc_msg,
 	bitstr_t *exc_core_bitmap = NULL;
 	uint32_t min_nodes, max_nodes, req_nodes;
 	int i, rc = SLURM_SUCCESS;
-	time_t now = time(NULL), start_res, orig_start_time = (time_t) 0;
+	time_t now = slurm_cached_time(), start_res, orig_start_time = (time_t) 0;
 	List preemptee_candidates = NULL, preemptee_job_list = NULL;
 	bool resv_overlap = false;
 	ListIterator iter = NULL;
@@ -4007,7 +4281,7 @@ extern int reboot_job_nodes(struct job_record *job_ptr)
 	agent_arg_t *reboot_agent_args = NULL;
 	reboot_msg_t *reboot_msg;
 	struct node_record *node_ptr;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 	bitstr_t *boot_node_bitmap = NULL, *feature_node_bitmap = NULL;
 	char *nodes, *reboot_features = NULL;
 	uint16_t protocol_version = SLURM_PROTOCOL_VERSION;
@@ -4165,7 +4439,7 @@ static void *_wait_boot(void *arg)
 		READ_LOCK, WRITE_LOCK, WRITE_LOCK, NO_LOCK, READ_LOCK };
 	uint16_t resume_timeout = slurm_get_resume_timeout();
 	struct node_record *node_ptr;
-	time_t start_time = time(NULL);
+	time_t start_time = slurm_cached_time();
 	int i, total_node_cnt, wait_node_cnt;
 	uint32_t save_job_id = job_ptr->job_id;
 	bool job_timeout = false;
@@ -4211,7 +4485,7 @@ static void *_wait_boot(void *arg)
 			info("%pJ boot complete for all %d nodes",
 			     job_ptr, total_node_cnt);
 		}
-		i = (int) difftime(time(NULL), start_time);
+		i = (int) difftime(slurm_cached_time(), start_time);
 		if (i >= resume_timeout) {
 			error("%pJ timeout waiting for node %d of %d boots",
 			      job_ptr, wait_node_cnt, total_node_cnt);
@@ -4273,7 +4547,7 @@ static void *_run_prolog(void *arg)
 	slurmctld_lock_t config_read_lock = {
 		READ_LOCK, WRITE_LOCK, WRITE_LOCK, NO_LOCK, READ_LOCK };
 	bitstr_t *node_bitmap = NULL;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 	uint16_t resume_timeout = slurm_get_resume_timeout();
 	uint16_t tm;
 	track_script_rec_t *track_script_rec;
@@ -4418,6 +4692,8 @@ extern void prolog_running_decr(struct job_record *job_ptr)
 	    (--job_ptr->details->prolog_running > 0))
 		return;
 
+	(void) job_timing_stamp(&job_ptr->timing.prolog_done);
+
 	/* Federated job notified the origin that the job is to be requeued,
 	 * need to wait for this job to be cancelled. */
 	if (job_ptr->job_state & JOB_REQUEUE_FED)
@@ -4849,6 +5125,11 @@ cleanup_completing(struct job_record *job_ptr)
 
 	trace_job(job_ptr, __func__, "");
 
+	if (job_timing_stamp(&job_ptr->timing.cleanup_done))
+		job_timing_interval(job_ptr->timing.complete,
+				    job_ptr->timing.cleanup_done,
+				    slurmctld_diag_stats.job_timing_complete_clean);
+
 	delay = last_job_update - job_ptr->end_time;
 	if (delay > 60) {
 		info("%s: %pJ completion process took %ld seconds",
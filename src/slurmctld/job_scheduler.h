@@ -42,6 +42,8 @@
 #ifndef _JOB_SCHEDULER_H
 #define _JOB_SCHEDULER_H
 
+#include "src/common/xmalloc.h"
+#include "src/common/xvector.h"
 #include "src/slurmctld/slurmctld.h"
 
 typedef struct job_queue_rec {
@@ -51,6 +53,8 @@ typedef struct job_queue_rec {
 	struct part_record *part_ptr;	/* Pointer to partition record. Each
 					 * job may have multiple partitions. */
 	uint32_t priority;		/* Job priority in THIS partition */
+	bool presched_reject;		/* Rejected by a parallel pre-screen
+					 * worker, skip in the main pass */
 } job_queue_rec_t;
 
 /*
@@ -65,10 +69,14 @@ extern int build_feature_list(struct job_record *job_ptr);
  * build_job_queue - build (non-priority ordered) list of pending jobs
  * IN clear_start - if set then clear the start_time for pending jobs
  * IN backfill - true if running backfill scheduler, enforce min time limit
+ * OUT arena_p - arena holding the queue records; the caller must call
+ *	xarena_destroy() on it once done with the queue and must not
+ *	xfree() individual records popped from the queue
  * RET the job queue
- * NOTE: the caller must call list_destroy() on RET value to free memory
+ * NOTE: the caller must call FREE_NULL_XVECTOR() on RET value to free memory
  */
-extern List build_job_queue(bool clear_start, bool backfill);
+extern xvector_t *build_job_queue(bool clear_start, bool backfill,
+				  xarena_t **arena_p);
 
 /* Given a scheduled job, return a pointer to it batch_job_launch_msg_t data */
 extern batch_job_launch_msg_t *build_launch_job_msg(
@@ -199,7 +207,7 @@ extern void set_job_elig_time(void);
  * sort_job_queue - sort job_queue in decending priority order
  * IN/OUT job_queue - sorted job queue previously made by build_job_queue()
  */
-extern void sort_job_queue(List job_queue);
+extern void sort_job_queue(xvector_t *job_queue);
 
 /* Note this differs from the ListCmpF typedef since we want jobs sorted
  *	in order of decreasing priority */
@@ -77,6 +77,13 @@ static slurm_submit_ops_t *ops = NULL;
 static plugin_context_t **g_context = NULL;
 static char *submit_plugin_list = NULL;
 static pthread_mutex_t g_context_lock = PTHREAD_MUTEX_INITIALIZER;
+/*
+ * Taken for read around plugin calls so that submissions can run
+ * concurrently in plugins which support it, and for write while the
+ * plugin context is torn down. Plugins with non-reentrant internal
+ * state are responsible for their own serialization.
+ */
+static pthread_rwlock_t g_context_use_lock = PTHREAD_RWLOCK_INITIALIZER;
 static bool init_run = false;
 
 /*
@@ -152,6 +159,10 @@ extern int job_submit_plugin_fini(void)
 	if (g_context_cnt < 0)
 		goto fini;
 
+	/* Wait for in-flight plugin calls to complete, then keep new
+	 * callers out while the plugin contexts are destroyed */
+	slurm_rwlock_wrlock(&g_context_use_lock);
+
 	init_run = false;
 	for (i=0; i<g_context_cnt; i++) {
 		if (g_context[i]) {
@@ -164,6 +175,7 @@ extern int job_submit_plugin_fini(void)
 	xfree(g_context);
 	xfree(submit_plugin_list);
 	g_context_cnt = -1;
+	slurm_rwlock_unlock(&g_context_use_lock);
 
 fini:	slurm_mutex_unlock(&g_context_lock);
 	return rc;
@@ -230,14 +242,14 @@ extern int job_submit_plugin_submit(struct job_descriptor *job_desc,
 	job_desc->site_factor = NO_VAL;
 
 	rc = job_submit_plugin_init();
-	slurm_mutex_lock(&g_context_lock);
+	slurm_rwlock_rdlock(&g_context_use_lock);
 	/* NOTE: On function entry read locks are set on config, job, node and
 	 * partition structures. Do not attempt to unlock them and then
 	 * lock again (say with a write lock) since doing so will trigger
-	 * a deadlock with the g_context_lock above. */
+	 * a deadlock with the g_context_use_lock above. */
 	for (i = 0; ((i < g_context_cnt) && (rc == SLURM_SUCCESS)); i++)
 		rc = (*(ops[i].submit))(job_desc, submit_uid, err_msg);
-	slurm_mutex_unlock(&g_context_lock);
+	slurm_rwlock_unlock(&g_context_use_lock);
 	END_TIMER2("job_submit_plugin_submit");
 
 	return rc;
@@ -266,10 +278,10 @@ extern int job_submit_plugin_modify(struct job_descriptor *job_desc,
 	job_desc->site_factor = NO_VAL;
 
 	rc = job_submit_plugin_init();
-	slurm_mutex_lock(&g_context_lock);
+	slurm_rwlock_rdlock(&g_context_use_lock);
 	for (i = 0; ((i < g_context_cnt) && (rc == SLURM_SUCCESS)); i++)
 		rc = (*(ops[i].modify))(job_desc, job_ptr, submit_uid);
-	slurm_mutex_unlock(&g_context_lock);
+	slurm_rwlock_unlock(&g_context_use_lock);
 	END_TIMER2("job_submit_plugin_modify");
 
 	return rc;
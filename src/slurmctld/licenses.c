@@ -57,7 +57,14 @@
 
 List license_list = (List) NULL;
 time_t last_license_update = 0;
-static pthread_mutex_t license_mutex = PTHREAD_MUTEX_INITIALIZER;
+/*
+ * license_lock protects license_list and the counters within it. The
+ * scheduler and backfill test paths only take the read lock, so they
+ * can proceed in parallel with each other and with status RPCs; the
+ * write lock is reserved for configuration changes and for the actual
+ * allocate/release of licenses at job start and finish.
+ */
+static pthread_rwlock_t license_lock;
 static void _pack_license(struct licenses *lic, Buf buffer, uint16_t protocol_version);
 
 /* Print all licenses on a list */
@@ -206,7 +213,7 @@ extern char *license_list_to_string(List license_list)
 	return licenses;
 }
 
-/* license_mutex should be locked before calling this. */
+/* license_lock should be write locked before calling this. */
 static void _add_res_rec_2_lic_list(slurmdb_res_rec_t *rec, bool sync)
 {
 	licenses_t *license_entry = xmalloc(sizeof(licenses_t));
@@ -227,7 +234,7 @@ extern char *get_licenses_used(void)
 	licenses_t *license_entry;
 	ListIterator iter;
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_rdlock(&license_lock);
 	if (license_list) {
 		iter = list_iterator_create(license_list);
 		while ((license_entry = (licenses_t *) list_next(iter))) {
@@ -239,7 +246,7 @@ extern char *get_licenses_used(void)
 		}
 		list_iterator_destroy(iter);
 	}
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 
 	return licenses_used;
 }
@@ -252,7 +259,10 @@ extern int license_init(char *licenses)
 
 	last_license_update = time(NULL);
 
-	slurm_mutex_lock(&license_mutex);
+	/* first caller in, nothing else references the lock yet */
+	slurm_rwlock_init(&license_lock);
+
+	slurm_rwlock_wrlock(&license_lock);
 	if (license_list)
 		fatal("license_list already defined");
 
@@ -261,7 +271,7 @@ extern int license_init(char *licenses)
 		fatal("Invalid configured licenses: %s", licenses);
 
 	_licenses_print("init_license", license_list, NULL);
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 	return SLURM_SUCCESS;
 }
 
@@ -278,10 +288,10 @@ extern int license_update(char *licenses)
         if (!valid)
                 fatal("Invalid configured licenses: %s", licenses);
 
-        slurm_mutex_lock(&license_mutex);
+        slurm_rwlock_wrlock(&license_lock);
         if (!license_list) {        /* no licenses before now */
                 license_list = new_list;
-                slurm_mutex_unlock(&license_mutex);
+                slurm_rwlock_unlock(&license_lock);
                 return SLURM_SUCCESS;
         }
 
@@ -318,7 +328,7 @@ extern int license_update(char *licenses)
         FREE_NULL_LIST(license_list);
         license_list = new_list;
         _licenses_print("update_license", license_list, NULL);
-        slurm_mutex_unlock(&license_mutex);
+        slurm_rwlock_unlock(&license_lock);
         return SLURM_SUCCESS;
 }
 
@@ -333,7 +343,7 @@ extern void license_add_remote(slurmdb_res_rec_t *rec)
 
 	name = xstrdup_printf("%s@%s", rec->name, rec->server);
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_wrlock(&license_lock);
 	if (!license_list) {
 		/* If last_license_update then init already ran and we
 		 * don't have any licenses defined in the slurm.conf
@@ -353,7 +363,7 @@ extern void license_add_remote(slurmdb_res_rec_t *rec)
 
 	xfree(name);
 
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 }
 
 extern void license_update_remote(slurmdb_res_rec_t *rec)
@@ -367,7 +377,7 @@ extern void license_update_remote(slurmdb_res_rec_t *rec)
 
 	name = xstrdup_printf("%s@%s", rec->name, rec->server);
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_wrlock(&license_lock);
 	if (!license_list) {
 		/* If last_license_update then init already ran and we
 		 * don't have any licenses defined in the slurm.conf
@@ -397,7 +407,7 @@ extern void license_update_remote(slurmdb_res_rec_t *rec)
 
 	xfree(name);
 
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 }
 
 extern void license_remove_remote(slurmdb_res_rec_t *rec)
@@ -409,7 +419,7 @@ extern void license_remove_remote(slurmdb_res_rec_t *rec)
 	xassert(rec);
 	xassert(rec->type == SLURMDB_RESOURCE_LICENSE);
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_wrlock(&license_lock);
 	if (!license_list) {
 		xassert(last_license_update);
 		license_list = list_create(license_free_rec);
@@ -436,7 +446,7 @@ extern void license_remove_remote(slurmdb_res_rec_t *rec)
 		error("license_remote_remote: License '%s' not found", name);
 
 	xfree(name);
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 }
 
 extern void license_sync_remote(List res_list)
@@ -445,7 +455,7 @@ extern void license_sync_remote(List res_list)
 	licenses_t *license_entry;
 	ListIterator iter;
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_wrlock(&license_lock);
 	if (res_list && !license_list) {
 		xassert(last_license_update);
 		license_list = list_create(license_free_rec);
@@ -500,15 +510,15 @@ extern void license_sync_remote(List res_list)
 	}
 	list_iterator_destroy(iter);
 
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 }
 
 /* Free memory associated with licenses on this system */
 extern void license_free(void)
 {
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_wrlock(&license_lock);
 	FREE_NULL_LIST(license_list);
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 }
 
 /*
@@ -547,7 +557,7 @@ extern List license_validate(char *licenses, bool validate_configured,
 		tres_req.type = "license";
 	}
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_rdlock(&license_lock);
 	_licenses_print("request_license", job_license_list, NULL);
 	iter = list_iterator_create(job_license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
@@ -584,7 +594,7 @@ extern List license_validate(char *licenses, bool validate_configured,
 		}
 	}
 	list_iterator_destroy(iter);
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 
 	if (!(*valid)) {
 		FREE_NULL_LIST(job_license_list);
@@ -625,7 +635,7 @@ extern int license_job_test(struct job_record *job_ptr, time_t when,
 	if (!job_ptr->license_list)	/* no licenses needed */
 		return rc;
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_rdlock(&license_lock);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
 		match = list_find_first(license_list, _license_find_rec,
@@ -658,7 +668,7 @@ extern int license_job_test(struct job_record *job_ptr, time_t when,
 		}
 	}
 	list_iterator_destroy(iter);
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 	return rc;
 }
 
@@ -704,7 +714,7 @@ extern int license_job_get(struct job_record *job_ptr)
 
 	last_license_update = time(NULL);
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_wrlock(&license_lock);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
 		match = list_find_first(license_list, _license_find_rec,
@@ -720,7 +730,7 @@ extern int license_job_get(struct job_record *job_ptr)
 	}
 	list_iterator_destroy(iter);
 	_licenses_print("acquire_license", license_list, job_ptr);
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 	return rc;
 }
 
@@ -740,7 +750,7 @@ extern int license_job_return(struct job_record *job_ptr)
 
 	last_license_update = time(NULL);
 	trace_job(job_ptr, __func__, "");
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_wrlock(&license_lock);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
 		match = list_find_first(license_list, _license_find_rec,
@@ -763,7 +773,7 @@ extern int license_job_return(struct job_record *job_ptr)
 	}
 	list_iterator_destroy(iter);
 	_licenses_print("return_license", license_list, job_ptr);
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 	return rc;
 }
 
@@ -823,7 +833,7 @@ get_all_license_info(char **buffer_ptr,
 	pack32(lics_packed, buffer);
 	pack_time(now, buffer);
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_rdlock(&license_lock);
 	if (license_list) {
 		iter = list_iterator_create(license_list);
 		while ((lic_entry = list_next(iter))) {
@@ -835,7 +845,7 @@ get_all_license_info(char **buffer_ptr,
 		list_iterator_destroy(iter);
 	}
 
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 	debug2("%s: processed %d licenses", __func__, lics_packed);
 
 	/* put the real record count in the message body header
@@ -854,7 +864,7 @@ extern uint32_t get_total_license_cnt(char *name)
 	uint32_t count = 0;
 	licenses_t *lic;
 
-	slurm_mutex_lock(&license_mutex);
+	slurm_rwlock_rdlock(&license_lock);
 	if (license_list) {
 		lic = list_find_first(
 			license_list, _license_find_rec, name);
@@ -862,7 +872,7 @@ extern uint32_t get_total_license_cnt(char *name)
 		if (lic)
 			count = lic->total;
 	}
-	slurm_mutex_unlock(&license_mutex);
+	slurm_rwlock_unlock(&license_lock);
 
 	return count;
 }
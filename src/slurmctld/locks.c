@@ -40,8 +40,11 @@
 #include <errno.h>
 #include <pthread.h>
 #include <string.h>
+#include <sys/time.h>
 #include <sys/types.h>
 
+#include "src/common/macros.h"
+#include "src/common/xmalloc.h"
 #include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 
@@ -49,6 +52,156 @@ static pthread_mutex_t state_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 static pthread_rwlock_t slurmctld_locks[ENTITY_COUNT];
 
+/*
+ * Optional lock profiling, enabled with DebugFlags=LockProfile and
+ * reported by sdiag. Wait and hold times are recorded per lock domain
+ * (read and write separately) and per lock_slurmctld() caller. Stats
+ * are sharded by thread to keep the profiler itself off the lock
+ * acquisition critical path; shards are merged when packed.
+ */
+#define LOCK_PROF_SHARDS	16
+#define LOCK_PROF_CALLERS	64
+#define LOCK_PROF_DOMAINS	(ENTITY_COUNT * 2)
+#define LOCK_PROF_NBUCKETS	24	/* power of two usec hold buckets */
+
+typedef struct {
+	pthread_mutex_t lock;
+	uint32_t domain_cnt[LOCK_PROF_DOMAINS];
+	uint64_t domain_wait[LOCK_PROF_DOMAINS];
+	uint64_t domain_wait_max[LOCK_PROF_DOMAINS];
+	uint64_t domain_hold[LOCK_PROF_DOMAINS];
+	uint64_t domain_hold_max[LOCK_PROF_DOMAINS];
+	uint32_t hold_hist[LOCK_PROF_DOMAINS * LOCK_PROF_NBUCKETS];
+	uint32_t caller_cnt[LOCK_PROF_CALLERS];
+	uint64_t caller_wait[LOCK_PROF_CALLERS];
+	uint64_t caller_wait_max[LOCK_PROF_CALLERS];
+	uint64_t caller_hold[LOCK_PROF_CALLERS];
+	uint64_t caller_hold_max[LOCK_PROF_CALLERS];
+} lock_prof_shard_t;
+
+static lock_prof_shard_t lock_prof_shards[LOCK_PROF_SHARDS];
+/* Append-only caller address table, scanned without locking.
+ * lock_prof_mutex serializes installation of new entries only. */
+static void *lock_prof_caller_tbl[LOCK_PROF_CALLERS];
+static pthread_mutex_t lock_prof_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t lock_prof_once = PTHREAD_ONCE_INIT;
+
+static const char *lock_prof_names[LOCK_PROF_DOMAINS] = {
+	"config/R",	"config/W",
+	"job/R",	"job/W",
+	"node/R",	"node/W",
+	"partition/R",	"partition/W",
+	"federation/R",	"federation/W",
+	"job_acct/R",	"job_acct/W",
+	"node_state/R",	"node_state/W",
+};
+
+/* Per-thread profile context for the currently held lock set */
+static __thread bool prof_active = false;
+static __thread void *prof_caller = NULL;
+static __thread uint64_t prof_hold_start = 0;
+static __thread uint64_t prof_wait[ENTITY_COUNT];
+
+static void _lock_prof_init(void)
+{
+	int i;
+
+	for (i = 0; i < LOCK_PROF_SHARDS; i++)
+		slurm_mutex_init(&lock_prof_shards[i].lock);
+}
+
+static uint64_t _prof_now_usec(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return ((uint64_t) tv.tv_sec * 1000000) + tv.tv_usec;
+}
+
+static int _prof_shard_inx(void)
+{
+	uintptr_t h = (uintptr_t) pthread_self();
+
+	h ^= (h >> 12);
+	return (int) (h % LOCK_PROF_SHARDS);
+}
+
+/* Map a caller return address to its table slot, installing it on
+ * first use. Returns -1 if the table is full. */
+static int _prof_caller_inx(void *addr)
+{
+	int i;
+
+	for (i = 0; i < LOCK_PROF_CALLERS; i++) {
+		if (lock_prof_caller_tbl[i] == addr)
+			return i;
+		if (!lock_prof_caller_tbl[i])
+			break;
+	}
+	slurm_mutex_lock(&lock_prof_mutex);
+	for (i = 0; i < LOCK_PROF_CALLERS; i++) {
+		if (lock_prof_caller_tbl[i] == addr)
+			break;
+		if (!lock_prof_caller_tbl[i]) {
+			lock_prof_caller_tbl[i] = addr;
+			break;
+		}
+	}
+	slurm_mutex_unlock(&lock_prof_mutex);
+	if (i >= LOCK_PROF_CALLERS)
+		return -1;
+	return i;
+}
+
+static int _prof_bucket(uint64_t usec)
+{
+	int b = 0;
+
+	while ((usec >>= 1) && (b < (LOCK_PROF_NBUCKETS - 1)))
+		b++;
+	return b;
+}
+
+/* Record the completed lock/unlock cycle described by lock_levels.
+ * Called after the locks have been released. */
+static void _prof_record(slurmctld_lock_t lock_levels, uint64_t hold_usec)
+{
+	lock_level_t *levels = (lock_level_t *) &lock_levels;
+	lock_prof_shard_t *shard;
+	uint64_t wait_total = 0;
+	int i, j, b, c;
+
+	shard = &lock_prof_shards[_prof_shard_inx()];
+	b = _prof_bucket(hold_usec);
+	c = _prof_caller_inx(prof_caller);
+
+	slurm_mutex_lock(&shard->lock);
+	for (i = 0; i < ENTITY_COUNT; i++) {
+		if (levels[i] == NO_LOCK)
+			continue;
+		j = (i * 2) + ((levels[i] == WRITE_LOCK) ? 1 : 0);
+		shard->domain_cnt[j]++;
+		shard->domain_wait[j] += prof_wait[i];
+		shard->domain_wait_max[j] = MAX(shard->domain_wait_max[j],
+						prof_wait[i]);
+		shard->domain_hold[j] += hold_usec;
+		shard->domain_hold_max[j] = MAX(shard->domain_hold_max[j],
+						hold_usec);
+		shard->hold_hist[(j * LOCK_PROF_NBUCKETS) + b]++;
+		wait_total += prof_wait[i];
+	}
+	if (c >= 0) {
+		shard->caller_cnt[c]++;
+		shard->caller_wait[c] += wait_total;
+		shard->caller_wait_max[c] = MAX(shard->caller_wait_max[c],
+						wait_total);
+		shard->caller_hold[c] += hold_usec;
+		shard->caller_hold_max[c] = MAX(shard->caller_hold_max[c],
+						hold_usec);
+	}
+	slurm_mutex_unlock(&shard->lock);
+}
+
 #ifndef NDEBUG
 /*
  * Used to protect against double-locking within a single thread. Calling
@@ -102,10 +255,47 @@ extern bool verify_lock(lock_datatype_t datatype, lock_level_t level)
 }
 #endif
 
+/*
+ * A lock on the job or node domain implies the same level on its
+ * sub-domain, so legacy requests exclude sub-domain writers. Derive the
+ * effective levels once so that lock, unlock and the NDEBUG bookkeeping
+ * all agree.
+ */
+static slurmctld_lock_t _derive_levels(slurmctld_lock_t lock_levels)
+{
+	if (lock_levels.job > lock_levels.job_acct)
+		lock_levels.job_acct = lock_levels.job;
+	if (lock_levels.node > lock_levels.node_state)
+		lock_levels.node_state = lock_levels.node;
+
+	return lock_levels;
+}
+
+/* Acquire one domain lock, timing the wait when profiling is active */
+static void _lock_one(lock_datatype_t datatype, lock_level_t level)
+{
+	uint64_t t1 = 0;
+
+	if (level == NO_LOCK)
+		return;
+	if (prof_active)
+		t1 = _prof_now_usec();
+
+	if (level == READ_LOCK)
+		slurm_rwlock_rdlock(&slurmctld_locks[datatype]);
+	else
+		slurm_rwlock_wrlock(&slurmctld_locks[datatype]);
+
+	if (prof_active)
+		prof_wait[datatype] = _prof_now_usec() - t1;
+}
+
 /* lock_slurmctld - Issue the required lock requests in a well defined order */
 extern void lock_slurmctld(slurmctld_lock_t lock_levels)
 {
 	static bool init_run = false;
+
+	lock_levels = _derive_levels(lock_levels);
 	xassert(_store_locks(lock_levels));
 
 	if (!init_run) {
@@ -114,52 +304,66 @@ extern void lock_slurmctld(slurmctld_lock_t lock_levels)
 			slurm_rwlock_init(&slurmctld_locks[i]);
 	}
 
-	if (lock_levels.conf == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[CONF_LOCK]);
-	else if (lock_levels.conf == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[CONF_LOCK]);
-
-	if (lock_levels.job == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[JOB_LOCK]);
-	else if (lock_levels.job == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[JOB_LOCK]);
-
-	if (lock_levels.node == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[NODE_LOCK]);
-	else if (lock_levels.node == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[NODE_LOCK]);
+	/* Latch the flag here so the matching unlock_slurmctld() is
+	 * consistent even if DebugFlags change while locks are held */
+	if (slurmctld_conf.debug_flags & DEBUG_FLAG_LOCK_PROFILE) {
+		pthread_once(&lock_prof_once, _lock_prof_init);
+		prof_active = true;
+		prof_caller = __builtin_return_address(0);
+		memset(prof_wait, 0, sizeof(prof_wait));
+	}
 
-	if (lock_levels.part == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[PART_LOCK]);
-	else if (lock_levels.part == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[PART_LOCK]);
+	_lock_one(CONF_LOCK, lock_levels.conf);
+	_lock_one(JOB_LOCK, lock_levels.job);
+	_lock_one(JOB_ACCT_LOCK, lock_levels.job_acct);
+	_lock_one(NODE_LOCK, lock_levels.node);
+	_lock_one(NODE_STATE_LOCK, lock_levels.node_state);
+	_lock_one(PART_LOCK, lock_levels.part);
+	_lock_one(FED_LOCK, lock_levels.fed);
 
-	if (lock_levels.fed == READ_LOCK)
-		slurm_rwlock_rdlock(&slurmctld_locks[FED_LOCK]);
-	else if (lock_levels.fed == WRITE_LOCK)
-		slurm_rwlock_wrlock(&slurmctld_locks[FED_LOCK]);
+	if (prof_active)
+		prof_hold_start = _prof_now_usec();
 }
 
 /* unlock_slurmctld - Issue the required unlock requests in a well
  *	defined order */
 extern void unlock_slurmctld(slurmctld_lock_t lock_levels)
 {
+	uint64_t hold_usec = 0;
+
+	lock_levels = _derive_levels(lock_levels);
 	xassert(_clear_locks(lock_levels));
 
+	if (prof_active)
+		hold_usec = _prof_now_usec() - prof_hold_start;
+
 	if (lock_levels.fed)
 		slurm_rwlock_unlock(&slurmctld_locks[FED_LOCK]);
 
 	if (lock_levels.part)
 		slurm_rwlock_unlock(&slurmctld_locks[PART_LOCK]);
 
+	if (lock_levels.node_state)
+		slurm_rwlock_unlock(&slurmctld_locks[NODE_STATE_LOCK]);
+
 	if (lock_levels.node)
 		slurm_rwlock_unlock(&slurmctld_locks[NODE_LOCK]);
 
+	if (lock_levels.job_acct)
+		slurm_rwlock_unlock(&slurmctld_locks[JOB_ACCT_LOCK]);
+
 	if (lock_levels.job)
 		slurm_rwlock_unlock(&slurmctld_locks[JOB_LOCK]);
 
 	if (lock_levels.conf)
 		slurm_rwlock_unlock(&slurmctld_locks[CONF_LOCK]);
+
+	if (prof_active) {
+		/* Record after the release so bookkeeping cost does not
+		 * extend the measured hold */
+		_prof_record(lock_levels, hold_usec);
+		prof_active = false;
+	}
 }
 
 /*
@@ -186,26 +390,156 @@ static void _report_lock_set(char **str, lock_datatype_t datatype)
 int report_locks_set(void)
 {
 	char *conf = "", *job = "", *node = "", *part = "", *fed = "";
+	char *job_acct = "", *node_state = "";
 	int lock_count;
 
 	_report_lock_set(&conf, CONF_LOCK);
 	_report_lock_set(&job, JOB_LOCK);
+	_report_lock_set(&job_acct, JOB_ACCT_LOCK);
 	_report_lock_set(&node, NODE_LOCK);
+	_report_lock_set(&node_state, NODE_STATE_LOCK);
 	_report_lock_set(&part, PART_LOCK);
 	_report_lock_set(&fed, FED_LOCK);
 
 	lock_count = strlen(conf) + strlen(job) + strlen(node)
-		     + strlen(part) + strlen(fed);
+		     + strlen(part) + strlen(fed)
+		     + strlen(job_acct) + strlen(node_state);
 
 	if (lock_count > 0) {
 		error("Locks left set "
-		      "config:%s, job:%s, node:%s, partition:%s, federation:%s",
-		      conf, job, node, part, fed);
+		      "config:%s, job:%s, job_acct:%s, node:%s, "
+		      "node_state:%s, partition:%s, federation:%s",
+		      conf, job, job_acct, node, node_state, part, fed);
 	}
 	return lock_count;
 }
 
 
+/*
+ * lock_profile_pack - append merged lock profile statistics to buffer
+ *	for the REQUEST_STATS_INFO response
+ */
+extern void lock_profile_pack(Buf buffer)
+{
+	uint32_t domain_cnt[LOCK_PROF_DOMAINS];
+	uint64_t domain_wait[LOCK_PROF_DOMAINS];
+	uint64_t domain_wait_max[LOCK_PROF_DOMAINS];
+	uint64_t domain_hold[LOCK_PROF_DOMAINS];
+	uint64_t domain_hold_max[LOCK_PROF_DOMAINS];
+	uint32_t *hold_hist;
+	uint64_t caller_addr[LOCK_PROF_CALLERS];
+	uint32_t caller_cnt[LOCK_PROF_CALLERS];
+	uint64_t caller_wait[LOCK_PROF_CALLERS];
+	uint64_t caller_wait_max[LOCK_PROF_CALLERS];
+	uint64_t caller_hold[LOCK_PROF_CALLERS];
+	uint64_t caller_hold_max[LOCK_PROF_CALLERS];
+	lock_prof_shard_t *shard;
+	uint32_t i, j, caller_n;
+
+	pthread_once(&lock_prof_once, _lock_prof_init);
+
+	memset(domain_cnt, 0, sizeof(domain_cnt));
+	memset(domain_wait, 0, sizeof(domain_wait));
+	memset(domain_wait_max, 0, sizeof(domain_wait_max));
+	memset(domain_hold, 0, sizeof(domain_hold));
+	memset(domain_hold_max, 0, sizeof(domain_hold_max));
+	hold_hist = xcalloc(LOCK_PROF_DOMAINS * LOCK_PROF_NBUCKETS,
+			    sizeof(uint32_t));
+	memset(caller_addr, 0, sizeof(caller_addr));
+	memset(caller_cnt, 0, sizeof(caller_cnt));
+	memset(caller_wait, 0, sizeof(caller_wait));
+	memset(caller_wait_max, 0, sizeof(caller_wait_max));
+	memset(caller_hold, 0, sizeof(caller_hold));
+	memset(caller_hold_max, 0, sizeof(caller_hold_max));
+
+	slurm_mutex_lock(&lock_prof_mutex);
+	for (caller_n = 0; caller_n < LOCK_PROF_CALLERS; caller_n++) {
+		if (!lock_prof_caller_tbl[caller_n])
+			break;
+		caller_addr[caller_n] =
+			(uint64_t) (uintptr_t) lock_prof_caller_tbl[caller_n];
+	}
+	slurm_mutex_unlock(&lock_prof_mutex);
+
+	for (j = 0; j < LOCK_PROF_SHARDS; j++) {
+		shard = &lock_prof_shards[j];
+		slurm_mutex_lock(&shard->lock);
+		for (i = 0; i < LOCK_PROF_DOMAINS; i++) {
+			domain_cnt[i]  += shard->domain_cnt[i];
+			domain_wait[i] += shard->domain_wait[i];
+			domain_wait_max[i] = MAX(domain_wait_max[i],
+						 shard->domain_wait_max[i]);
+			domain_hold[i] += shard->domain_hold[i];
+			domain_hold_max[i] = MAX(domain_hold_max[i],
+						 shard->domain_hold_max[i]);
+		}
+		for (i = 0; i < (LOCK_PROF_DOMAINS * LOCK_PROF_NBUCKETS); i++)
+			hold_hist[i] += shard->hold_hist[i];
+		for (i = 0; i < caller_n; i++) {
+			caller_cnt[i]  += shard->caller_cnt[i];
+			caller_wait[i] += shard->caller_wait[i];
+			caller_wait_max[i] = MAX(caller_wait_max[i],
+						 shard->caller_wait_max[i]);
+			caller_hold[i] += shard->caller_hold[i];
+			caller_hold_max[i] = MAX(caller_hold_max[i],
+						 shard->caller_hold_max[i]);
+		}
+		slurm_mutex_unlock(&shard->lock);
+	}
+
+	pack32(LOCK_PROF_DOMAINS, buffer);
+	packstr_array((char **) lock_prof_names, LOCK_PROF_DOMAINS, buffer);
+	pack32_array(domain_cnt, LOCK_PROF_DOMAINS, buffer);
+	pack64_array(domain_wait, LOCK_PROF_DOMAINS, buffer);
+	pack64_array(domain_wait_max, LOCK_PROF_DOMAINS, buffer);
+	pack64_array(domain_hold, LOCK_PROF_DOMAINS, buffer);
+	pack64_array(domain_hold_max, LOCK_PROF_DOMAINS, buffer);
+	pack32(LOCK_PROF_NBUCKETS, buffer);
+	pack32_array(hold_hist, LOCK_PROF_DOMAINS * LOCK_PROF_NBUCKETS,
+		     buffer);
+	pack32(caller_n, buffer);
+	pack64_array(caller_addr, caller_n, buffer);
+	pack32_array(caller_cnt, caller_n, buffer);
+	pack64_array(caller_wait, caller_n, buffer);
+	pack64_array(caller_wait_max, caller_n, buffer);
+	pack64_array(caller_hold, caller_n, buffer);
+	pack64_array(caller_hold_max, caller_n, buffer);
+
+	xfree(hold_hist);
+}
+
+/* lock_profile_reset - clear accumulated lock profile statistics */
+extern void lock_profile_reset(void)
+{
+	lock_prof_shard_t *shard;
+	int i;
+
+	pthread_once(&lock_prof_once, _lock_prof_init);
+	for (i = 0; i < LOCK_PROF_SHARDS; i++) {
+		shard = &lock_prof_shards[i];
+		slurm_mutex_lock(&shard->lock);
+		memset(shard->domain_cnt, 0, sizeof(shard->domain_cnt));
+		memset(shard->domain_wait, 0, sizeof(shard->domain_wait));
+		memset(shard->domain_wait_max, 0,
+		       sizeof(shard->domain_wait_max));
+		memset(shard->domain_hold, 0, sizeof(shard->domain_hold));
+		memset(shard->domain_hold_max, 0,
+		       sizeof(shard->domain_hold_max));
+		memset(shard->hold_hist, 0, sizeof(shard->hold_hist));
+		memset(shard->caller_cnt, 0, sizeof(shard->caller_cnt));
+		memset(shard->caller_wait, 0, sizeof(shard->caller_wait));
+		memset(shard->caller_wait_max, 0,
+		       sizeof(shard->caller_wait_max));
+		memset(shard->caller_hold, 0, sizeof(shard->caller_hold));
+		memset(shard->caller_hold_max, 0,
+		       sizeof(shard->caller_hold_max));
+		slurm_mutex_unlock(&shard->lock);
+	}
+	slurm_mutex_lock(&lock_prof_mutex);
+	memset(lock_prof_caller_tbl, 0, sizeof(lock_prof_caller_tbl));
+	slurm_mutex_unlock(&lock_prof_mutex);
+}
+
 /* un/lock semaphore used for saving state of slurmctld */
 extern void lock_state_files(void)
 {
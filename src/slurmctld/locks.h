@@ -93,6 +93,8 @@
 
 #include <stdbool.h>
 
+#include "src/common/pack.h"
+
 /* levels of locking required for each data structure */
 typedef enum {
 	NO_LOCK,
@@ -100,13 +102,26 @@ typedef enum {
 	WRITE_LOCK
 }	lock_level_t;
 
-/* slurmctld specific data structures to lock via APIs */
+/*
+ * slurmctld specific data structures to lock via APIs
+ *
+ * job_acct and node_state are finer-grained sub-domains of the job and
+ * node domains respectively. job_acct covers job accounting/statistics
+ * fields, node_state covers volatile node state (load, energy, reason).
+ * A READ or WRITE lock on the parent domain implies the same level on the
+ * sub-domain, so existing callers and plugins that only populate the first
+ * five members remain correct. New code which only touches sub-domain
+ * fields may request just the sub-lock and run concurrently with full
+ * domain readers of the other fields.
+ */
 typedef struct {
 	lock_level_t conf;
 	lock_level_t job;
 	lock_level_t node;
 	lock_level_t part;
 	lock_level_t fed;
+	lock_level_t job_acct;
+	lock_level_t node_state;
 }	slurmctld_lock_t;
 
 typedef enum {
@@ -115,6 +130,8 @@ typedef enum {
 	NODE_LOCK,
 	PART_LOCK,
 	FED_LOCK,
+	JOB_ACCT_LOCK,
+	NODE_STATE_LOCK,
 	ENTITY_COUNT
 }	lock_datatype_t;
 
@@ -135,6 +152,13 @@ extern void unlock_slurmctld (slurmctld_lock_t lock_levels);
 
 extern int report_locks_set(void);
 
+/* lock_profile_pack - append merged lock profile statistics to buffer
+ *	for the REQUEST_STATS_INFO response */
+extern void lock_profile_pack(Buf buffer);
+
+/* lock_profile_reset - clear accumulated lock profile statistics */
+extern void lock_profile_reset(void);
+
 /* un/lock semaphore used for saving state of slurmctld */
 extern void lock_state_files ( void );
 extern void unlock_state_files ( void );
@@ -763,6 +763,156 @@ static bool _node_is_hidden(struct node_record *node_ptr, uid_t uid)
 	return true;
 }
 
+static pthread_mutex_t node_sched_view_mutex = PTHREAD_MUTEX_INITIALIZER;
+static node_sched_view_t node_sched_view_data;
+static time_t node_sched_view_gen = 0;
+
+/*
+ * node_sched_view - return the scheduling view of the node table,
+ *	rebuilding it first if any node record changed.
+ * NOTE: Call with node read (or write) lock held; the returned arrays
+ *	remain valid only while that lock is held.
+ */
+extern const node_sched_view_t *node_sched_view(void)
+{
+	node_sched_view_t *view = &node_sched_view_data;
+	struct node_record *node_ptr;
+	int i;
+
+	slurm_mutex_lock(&node_sched_view_mutex);
+	if ((node_sched_view_gen == last_node_update) &&
+	    (view->node_cnt == node_record_count)) {
+		slurm_mutex_unlock(&node_sched_view_mutex);
+		return view;
+	}
+
+	if (view->node_cnt != node_record_count) {
+		view->node_cnt = node_record_count;
+		xrealloc(view->state,
+			 node_record_count * sizeof(uint32_t));
+		xrealloc(view->cpus,
+			 node_record_count * sizeof(uint16_t));
+		xrealloc(view->sockets,
+			 node_record_count * sizeof(uint16_t));
+		xrealloc(view->cores,
+			 node_record_count * sizeof(uint16_t));
+		xrealloc(view->threads,
+			 node_record_count * sizeof(uint16_t));
+		xrealloc(view->total_cores,
+			 node_record_count * sizeof(int));
+		xrealloc(view->real_memory,
+			 node_record_count * sizeof(uint64_t));
+		xrealloc(view->tmp_disk,
+			 node_record_count * sizeof(uint32_t));
+	}
+
+	for (i = 0, node_ptr = node_record_table_ptr;
+	     i < node_record_count; i++, node_ptr++) {
+		view->state[i]       = node_ptr->node_state;
+		view->cpus[i]        = node_ptr->cpus;
+		view->sockets[i]     = node_ptr->sockets;
+		view->cores[i]       = node_ptr->cores;
+		view->threads[i]     = node_ptr->threads;
+		view->total_cores[i] = node_ptr->boards *
+				       node_ptr->sockets * node_ptr->cores;
+		view->real_memory[i] = node_ptr->real_memory;
+		view->tmp_disk[i]    = node_ptr->tmp_disk;
+	}
+	node_sched_view_gen = last_node_update;
+	slurm_mutex_unlock(&node_sched_view_mutex);
+
+	return view;
+}
+
+/*
+ * Cache of serialized RESPONSE_NODE_INFO payloads, mirroring the job-info
+ * pack cache in job_mgr.c. Entries are served only while no node or
+ * partition record changed since the fill, and the fill must be in a
+ * later second than the generation stamps so an update within the fill
+ * second cannot go undetected.
+ */
+#define NODE_PACK_CACHE_SIZE 8
+
+typedef struct {
+	char *data;
+	int data_size;
+	uint16_t show_flags;
+	uid_t uid;
+	uint16_t protocol_version;
+	time_t node_update_gen;
+	time_t part_update_gen;
+	time_t fill_time;
+	time_t last_used;
+} node_pack_cache_t;
+
+static pthread_mutex_t node_pack_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static node_pack_cache_t node_pack_cache[NODE_PACK_CACHE_SIZE];
+
+static bool _node_pack_cache_lookup(char **buffer_ptr, int *buffer_size,
+				    uint16_t show_flags, uid_t uid,
+				    uint16_t protocol_version)
+{
+	node_pack_cache_t *ent;
+	bool hit = false;
+
+	slurm_mutex_lock(&node_pack_cache_mutex);
+	for (int i = 0; i < NODE_PACK_CACHE_SIZE; i++) {
+		ent = &node_pack_cache[i];
+		if (!ent->data ||
+		    (ent->show_flags != show_flags) ||
+		    (ent->uid != uid) ||
+		    (ent->protocol_version != protocol_version))
+			continue;
+		if ((ent->node_update_gen != last_node_update) ||
+		    (ent->part_update_gen != last_part_update) ||
+		    (ent->fill_time <= ent->node_update_gen) ||
+		    (ent->fill_time <= ent->part_update_gen))
+			break;
+		*buffer_size = ent->data_size;
+		buffer_ptr[0] = xmalloc(ent->data_size);
+		memcpy(buffer_ptr[0], ent->data, ent->data_size);
+		ent->last_used = time(NULL);
+		hit = true;
+		break;
+	}
+	slurm_mutex_unlock(&node_pack_cache_mutex);
+	return hit;
+}
+
+static void _node_pack_cache_insert(char *data, int data_size,
+				    uint16_t show_flags, uid_t uid,
+				    uint16_t protocol_version)
+{
+	node_pack_cache_t *ent, *evict;
+	time_t now = time(NULL);
+
+	slurm_mutex_lock(&node_pack_cache_mutex);
+	evict = &node_pack_cache[0];
+	for (int i = 0; i < NODE_PACK_CACHE_SIZE; i++) {
+		ent = &node_pack_cache[i];
+		if (!ent->data ||
+		    ((ent->show_flags == show_flags) && (ent->uid == uid) &&
+		     (ent->protocol_version == protocol_version))) {
+			evict = ent;
+			break;
+		}
+		if (ent->last_used < evict->last_used)
+			evict = ent;
+	}
+	xfree(evict->data);
+	evict->data = xmalloc(data_size);
+	memcpy(evict->data, data, data_size);
+	evict->data_size = data_size;
+	evict->show_flags = show_flags;
+	evict->uid = uid;
+	evict->protocol_version = protocol_version;
+	evict->node_update_gen = last_node_update;
+	evict->part_update_gen = last_part_update;
+	evict->fill_time = now;
+	evict->last_used = now;
+	slurm_mutex_unlock(&node_pack_cache_mutex);
+}
+
 /*
  * pack_all_node - dump all configuration and node information for all nodes
  *	in machine independent form (for network transmission)
@@ -792,6 +942,11 @@ extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 	buffer_ptr[0] = NULL;
 	*buffer_size = 0;
 
+	if (_node_pack_cache_lookup(buffer_ptr, buffer_size, show_flags, uid,
+				    protocol_version))
+		return;
+
+	PHASE_TRACE_BEGIN(PHASE_TRACE_PACK_NODE_INFO);
 	buffer = init_buf (BUF_SIZE*16);
 	nodes_packed = 0;
 
@@ -847,6 +1002,97 @@ extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 
 	*buffer_size = get_buf_offset (buffer);
 	buffer_ptr[0] = xfer_buf_data (buffer);
+
+	_node_pack_cache_insert(buffer_ptr[0], *buffer_size, show_flags, uid,
+				protocol_version);
+	PHASE_TRACE_END(PHASE_TRACE_PACK_NODE_INFO);
+}
+
+/*
+ * build_node_summary - report per-partition counts of allocated, idle and
+ *	other (down/drained/draining) nodes and CPUs
+ * IN show_flags - partition filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * RET summary message, free with slurm_free_node_summary_info_msg()
+ * NOTE: The node state classification must match what sinfo derives from
+ *	 a full node info dump, including the MIXED determination made in
+ *	 sinfo's _query_server()
+ */
+extern node_summary_info_msg_t *build_node_summary(uid_t uid,
+						   uint16_t show_flags)
+{
+	node_summary_info_msg_t *summary_msg;
+	partition_summary_t *sum;
+	ListIterator part_iterator;
+	struct part_record *part_ptr;
+	struct node_record *node_ptr;
+	uint16_t alloc_cpus;
+	uint32_t total_cpus, base_state;
+	bool mixed;
+	int i;
+
+	xassert(verify_lock(CONF_LOCK, READ_LOCK));
+	xassert(verify_lock(PART_LOCK, READ_LOCK));
+
+	summary_msg = xmalloc(sizeof(node_summary_info_msg_t));
+	summary_msg->last_update = time(NULL);
+	summary_msg->summary_array = xcalloc(list_count(part_list),
+					     sizeof(partition_summary_t));
+
+	part_iterator = list_iterator_create(part_list);
+	while ((part_ptr = (struct part_record *) list_next(part_iterator))) {
+		xassert (part_ptr->magic == PART_MAGIC);
+		if (((show_flags & SHOW_ALL) == 0) &&
+		    !part_is_visible(part_ptr, uid))
+			continue;
+		sum = &summary_msg->summary_array[summary_msg->record_count++];
+		sum->partition = xstrdup(part_ptr->name);
+		if (!part_ptr->node_bitmap)
+			continue;
+		for (i = 0; i < node_record_count; i++) {
+			if (!bit_test(part_ptr->node_bitmap, i))
+				continue;
+			node_ptr = node_record_table_ptr + i;
+			alloc_cpus = 0;
+			select_g_select_nodeinfo_get(node_ptr->select_nodeinfo,
+						     SELECT_NODEDATA_SUBCNT,
+						     NODE_STATE_ALLOCATED,
+						     &alloc_cpus);
+			if (slurmctld_conf.fast_schedule)
+				total_cpus = node_ptr->config_ptr->cpus;
+			else
+				total_cpus = node_ptr->cpus;
+			base_state = node_ptr->node_state & NODE_STATE_BASE;
+			if (IS_NODE_DRAIN(node_ptr)) {
+				/* Whole node is being drained, never MIXED */
+				mixed = false;
+			} else {
+				mixed = (alloc_cpus &&
+					 (alloc_cpus != total_cpus));
+			}
+
+			if ((base_state == NODE_STATE_ALLOCATED) || mixed ||
+			    IS_NODE_COMPLETING(node_ptr))
+				sum->nodes_alloc++;
+			else if (IS_NODE_DRAIN(node_ptr) ||
+				 (base_state == NODE_STATE_DOWN))
+				sum->nodes_other++;
+			else
+				sum->nodes_idle++;
+			sum->nodes_total++;
+
+			sum->cpus_alloc += alloc_cpus;
+			sum->cpus_total += total_cpus;
+			if (IS_NODE_DRAIN(node_ptr) ||
+			    (base_state == NODE_STATE_DOWN))
+				sum->cpus_other += (total_cpus - alloc_cpus);
+			else
+				sum->cpus_idle += (total_cpus - alloc_cpus);
+		}
+	}
+	list_iterator_destroy(part_iterator);
+
+	return summary_msg;
 }
 
 /*
@@ -2304,6 +2550,50 @@ extern int validate_node_specs(slurm_node_registration_status_msg_t *reg_msg,
 	node_ptr->version = reg_msg->version;
 	reg_msg->version = NULL;
 
+	if (reg_msg->flags & SLURMD_REG_FLAG_SLIM) {
+		/*
+		 * The slurmd omitted its static configuration because it is
+		 * unchanged since a full registration we already validated.
+		 * Only take that shortcut while the node is in a steady
+		 * state; anything which needs the full validation or state
+		 * transition logic below gets an error back, which makes
+		 * the slurmd immediately re-register with a full message.
+		 */
+		if ((reg_msg->status != SLURM_SUCCESS) ||
+		    IS_NODE_UNKNOWN(node_ptr) || IS_NODE_FUTURE(node_ptr) ||
+		    IS_NODE_DOWN(node_ptr) || IS_NODE_NO_RESPOND(node_ptr) ||
+		    IS_NODE_POWER_UP(node_ptr) ||
+		    IS_NODE_POWER_SAVE(node_ptr) ||
+		    IS_NODE_REBOOT(node_ptr) ||
+		    (IS_NODE_ALLOCATED(node_ptr) &&
+		     (reg_msg->job_count == 0)) ||
+		    (IS_NODE_COMPLETING(node_ptr) &&
+		     (reg_msg->job_count == 0)) ||
+		    (IS_NODE_IDLE(node_ptr) && reg_msg->job_count)) {
+			debug("Abbreviated registration from node %s needs full validation",
+			      reg_msg->node_name);
+			return EAGAIN;
+		}
+
+		if (node_ptr->cpu_load != reg_msg->cpu_load) {
+			node_ptr->cpu_load = reg_msg->cpu_load;
+			node_ptr->cpu_load_time = now;
+			last_node_update = now;
+		}
+		if (node_ptr->free_mem != reg_msg->free_mem) {
+			node_ptr->free_mem = reg_msg->free_mem;
+			node_ptr->free_mem_time = now;
+			last_node_update = now;
+		}
+		if (reg_msg->energy)
+			memcpy(node_ptr->energy, reg_msg->energy,
+			       sizeof(acct_gather_energy_t));
+
+		node_ptr->last_response = MAX(now, node_ptr->last_response);
+		*newly_up = false;
+		return SLURM_SUCCESS;
+	}
+
 	if (IS_NODE_POWER_UP(node_ptr) &&
 	    (node_ptr->boot_time < node_ptr->boot_req_time)) {
 		debug("Still waiting for boot of node %s", node_ptr->name);
@@ -125,6 +125,7 @@ static int  _build_node_list(struct job_record *job_ptr,
 			     int *node_set_size, char **err_msg,
 			     bool test_only, bool can_reboot);
 static int  _fill_in_gres_fields(struct job_record *job_ptr);
+static uint16_t _get_ntasks_per_core(struct job_details *details);
 static void _filter_nodes_in_set(struct node_set *node_set_ptr,
 				 struct job_details *detail_ptr,
 				 char **err_msg);
@@ -157,6 +158,165 @@ static bitstr_t *_valid_features(struct job_record *job_ptr,
 
 static uint32_t reboot_weight = 0;
 
+/*
+ * Cache of the config-record node sets built by _build_node_list(),
+ * keyed by the job requirement class. Queues commonly hold thousands
+ * of jobs with identical requirements; they can share one candidate
+ * set construction per node/partition state generation. Only the
+ * job-independent portion is cached (the per-config filtering and
+ * feature splits); power state and QOS node splits are applied to a
+ * private copy on every call. Entries are flushed whenever node or
+ * partition state changes. Access is serialized by the job write lock
+ * held by all callers of select_nodes().
+ */
+typedef struct node_set_cache_entry {
+	char *part_name;		/* partition name */
+	char *features;			/* job feature specification */
+	uint64_t pn_min_memory;		/* minimum memory per node */
+	uint32_t pn_min_cpus;		/* minimum CPUs per node */
+	uint32_t pn_min_tmp_disk;	/* minimum tmp_disk per node */
+	uint16_t cpus_per_task;
+	uint16_t ntasks_per_core;
+	uint16_t sockets_per_node;	/* NO_VAL16 if not specified */
+	uint16_t cores_per_socket;	/* NO_VAL16 if not specified */
+	uint16_t threads_per_core;	/* NO_VAL16 if not specified */
+	bool can_reboot;
+	bool test_only;
+	struct node_set *node_sets;
+	int node_set_size;
+} node_set_cache_entry_t;
+
+#define NODE_SET_CACHE_MAX 64
+static List node_set_cache = NULL;
+static time_t node_set_cache_node_time = (time_t) 0;
+static time_t node_set_cache_part_time = (time_t) 0;
+
+static void _free_node_sets(struct node_set *node_set_ptr, int node_set_size)
+{
+	int i;
+
+	for (i = 0; i < node_set_size; i++) {
+		xfree(node_set_ptr[i].features);
+		FREE_NULL_BITMAP(node_set_ptr[i].my_bitmap);
+		FREE_NULL_BITMAP(node_set_ptr[i].feature_bits);
+	}
+	xfree(node_set_ptr);
+}
+
+static void _node_set_cache_del(void *x)
+{
+	node_set_cache_entry_t *entry = (node_set_cache_entry_t *) x;
+
+	xfree(entry->part_name);
+	xfree(entry->features);
+	_free_node_sets(entry->node_sets, entry->node_set_size);
+	xfree(entry);
+}
+
+/* Deep copy "cnt" node sets into a new array of "len" records */
+static struct node_set *_copy_node_sets(struct node_set *src, int cnt, int len)
+{
+	struct node_set *dst;
+	int i;
+
+	dst = xcalloc(len, sizeof(struct node_set));
+	for (i = 0; i < cnt; i++) {
+		dst[i] = src[i];
+		dst[i].features = xstrdup(src[i].features);
+		dst[i].feature_bits = bit_copy(src[i].feature_bits);
+		dst[i].my_bitmap = bit_copy(src[i].my_bitmap);
+	}
+	return dst;
+}
+
+/* Flush the node set cache if node or partition state has changed */
+static void _node_set_cache_validate(void)
+{
+	if (!node_set_cache)
+		node_set_cache = list_create(_node_set_cache_del);
+	if ((node_set_cache_node_time != last_node_update) ||
+	    (node_set_cache_part_time != last_part_update)) {
+		list_flush(node_set_cache);
+		node_set_cache_node_time = last_node_update;
+		node_set_cache_part_time = last_part_update;
+	}
+}
+
+/* Fill in the requirement class key fields for this job */
+static void _node_set_cache_key(node_set_cache_entry_t *key,
+				struct job_record *job_ptr,
+				bool test_only, bool can_reboot)
+{
+	struct job_details *detail_ptr = job_ptr->details;
+	multi_core_data_t *mc_ptr = detail_ptr->mc_ptr;
+
+	memset(key, 0, sizeof(node_set_cache_entry_t));
+	key->part_name        = job_ptr->part_ptr->name;
+	key->features         = detail_ptr->features;
+	key->pn_min_memory    = detail_ptr->pn_min_memory;
+	key->pn_min_cpus      = detail_ptr->pn_min_cpus;
+	key->pn_min_tmp_disk  = detail_ptr->pn_min_tmp_disk;
+	key->cpus_per_task    = detail_ptr->cpus_per_task;
+	key->ntasks_per_core  = _get_ntasks_per_core(detail_ptr);
+	key->sockets_per_node = mc_ptr ? mc_ptr->sockets_per_node : NO_VAL16;
+	key->cores_per_socket = mc_ptr ? mc_ptr->cores_per_socket : NO_VAL16;
+	key->threads_per_core = mc_ptr ? mc_ptr->threads_per_core : NO_VAL16;
+	key->can_reboot       = can_reboot;
+	key->test_only        = test_only;
+}
+
+static int _node_set_cache_find(void *x, void *arg)
+{
+	node_set_cache_entry_t *entry = (node_set_cache_entry_t *) x;
+	node_set_cache_entry_t *key = (node_set_cache_entry_t *) arg;
+
+	if ((entry->pn_min_memory    != key->pn_min_memory)    ||
+	    (entry->pn_min_cpus      != key->pn_min_cpus)      ||
+	    (entry->pn_min_tmp_disk  != key->pn_min_tmp_disk)  ||
+	    (entry->cpus_per_task    != key->cpus_per_task)    ||
+	    (entry->ntasks_per_core  != key->ntasks_per_core)  ||
+	    (entry->sockets_per_node != key->sockets_per_node) ||
+	    (entry->cores_per_socket != key->cores_per_socket) ||
+	    (entry->threads_per_core != key->threads_per_core) ||
+	    (entry->can_reboot       != key->can_reboot)       ||
+	    (entry->test_only        != key->test_only)        ||
+	    xstrcmp(entry->part_name, key->part_name)          ||
+	    xstrcmp(entry->features, key->features))
+		return 0;
+	return 1;
+}
+
+static node_set_cache_entry_t *_node_set_cache_lookup(
+	struct job_record *job_ptr, bool test_only, bool can_reboot)
+{
+	node_set_cache_entry_t key;
+
+	_node_set_cache_validate();
+	_node_set_cache_key(&key, job_ptr, test_only, can_reboot);
+	return list_find_first(node_set_cache, _node_set_cache_find, &key);
+}
+
+static void _node_set_cache_insert(struct job_record *job_ptr,
+				   bool test_only, bool can_reboot,
+				   struct node_set *node_set_ptr,
+				   int node_set_size)
+{
+	node_set_cache_entry_t key, *entry;
+
+	_node_set_cache_validate();
+	if (list_count(node_set_cache) >= NODE_SET_CACHE_MAX)
+		return;
+	_node_set_cache_key(&key, job_ptr, test_only, can_reboot);
+	entry = xmalloc(sizeof(node_set_cache_entry_t));
+	*entry = key;
+	entry->part_name = xstrdup(key.part_name);
+	entry->features = xstrdup(key.features);
+	entry->node_sets = _copy_node_sets(node_set_ptr, node_set_size,
+					   node_set_size);
+	entry->node_set_size = node_set_size;
+	list_append(node_set_cache, entry);
+}
+
 /*
  * _get_ntasks_per_core - Retrieve the value of ntasks_per_core from
  *	the given job_details record.  If it wasn't set, return 0xffff.
@@ -645,7 +805,8 @@ extern void deallocate_nodes(struct job_record *job_ptr, bool timeout,
 /*
  * For every element in the feature_list, identify the nodes with that feature
  * either active or available and set the feature_list's node_bitmap_active and
- * node_bitmap_avail fields accordingly.
+ * node_bitmap_avail fields accordingly. The resolved bitmaps are cached on the
+ * feature_list and reused until the global feature lists change.
  */
 extern void find_feature_nodes(List feature_list, bool can_reboot)
 {
@@ -655,10 +816,23 @@ extern void find_feature_nodes(List feature_list, bool can_reboot)
 
 	if (!feature_list)
 		return;
+
+	/*
+	 * All elements are resolved together, so testing the first one is
+	 * sufficient to validate the cached bitmaps for the whole list
+	 */
+	job_feat_ptr = (job_feature_t *) list_peek(feature_list);
+	if (job_feat_ptr && job_feat_ptr->node_bitmap_active &&
+	    (job_feat_ptr->bitmap_gen == feature_list_gen) &&
+	    (job_feat_ptr->bitmap_reboot == can_reboot))
+		return;
+
 	feat_iter = list_iterator_create(feature_list);
 	while ((job_feat_ptr = (job_feature_t *) list_next(feat_iter))) {
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_active);
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_avail);
+		job_feat_ptr->bitmap_gen = feature_list_gen;
+		job_feat_ptr->bitmap_reboot = can_reboot;
 		node_feat_ptr = list_find_first(active_feature_list,
 						list_find_feature,
 						job_feat_ptr->name);
@@ -2681,6 +2855,11 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 	xassert(job_ptr);
 	xassert(job_ptr->magic == JOB_MAGIC);
 
+	if (job_timing_stamp(&job_ptr->timing.first_eval))
+		job_timing_interval(job_ptr->timing.submit,
+				    job_ptr->timing.first_eval,
+				    slurmctld_diag_stats.job_timing_submit_eval);
+
 	if (!acct_policy_job_runnable_pre_select(job_ptr, false))
 		return ESLURM_ACCOUNTING_POLICY;
 
@@ -3056,6 +3235,7 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 
 	job_ptr->job_state = JOB_RUNNING;
 	job_ptr->bit_flags |= JOB_WAS_RUNNING;
+	(void) job_timing_stamp(&job_ptr->timing.alloc);
 
 	if (select_g_select_nodeinfo_set(job_ptr) != SLURM_SUCCESS) {
 		error("select_g_select_nodeinfo_set(%pJ): %m", job_ptr);
@@ -3130,6 +3310,8 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 		job_ptr->job_state |= JOB_CONFIGURING;
 	}
 
+	job_time_limit_register(job_ptr, now);
+
 	/*
 	 * Request asynchronous launch of a prolog for a
 	 * non-batch job as long as the node is not configuring for
@@ -3729,6 +3911,8 @@ static int _build_node_list(struct job_record *job_ptr,
 	bool resv_overlap = false;
 	bitstr_t *node_maps[NM_TYPES] = { NULL, NULL, NULL, NULL, NULL, NULL };
 	bitstr_t *reboot_bitmap = NULL;
+	node_set_cache_entry_t *cache_ent;
+	bool cacheable;
 
 	if (job_ptr->resv_name) {
 		/*
@@ -3796,10 +3980,32 @@ static int _build_node_list(struct job_record *job_ptr,
 		return ESLURM_REQUESTED_NODE_CONFIG_UNAVAILABLE;
 	}
 
+	/*
+	 * Reservations restrict and split node sets in job-specific ways;
+	 * everything else is a function of the job requirement class and
+	 * the current node/partition state, so the thousands of jobs with
+	 * identical requirements in a typical queue can share one
+	 * construction per state generation.
+	 */
+	cacheable = !job_ptr->resv_name && !job_ptr->resv_ptr &&
+		    !detail_ptr->exc_node_bitmap;
+	node_set_len = list_count(config_list) * 16 + 1;
+	if (cacheable &&
+	    (cache_ent = _node_set_cache_lookup(job_ptr, test_only,
+						can_reboot))) {
+		FREE_NULL_BITMAP(usable_node_mask);
+		node_set_ptr = _copy_node_sets(cache_ent->node_sets,
+					       cache_ent->node_set_size,
+					       node_set_len);
+		node_set_inx = cache_ent->node_set_size;
+		if (err_msg)
+			xfree(*err_msg);
+		goto use_node_sets;
+	}
+
 	if (can_reboot)
 		reboot_bitmap = bit_alloc(node_record_count);
 	node_set_inx = 0;
-	node_set_len = list_count(config_list) * 16 + 1;
 	node_set_ptr = xcalloc(node_set_len, sizeof(struct node_set));
 	config_iterator = list_iterator_create(config_list);
 	while ((config_ptr = (struct config_record *)
@@ -4108,6 +4314,11 @@ end_node_set:
 	if (err_msg)
 		xfree(*err_msg);
 
+	if (cacheable)
+		_node_set_cache_insert(job_ptr, test_only, can_reboot,
+				       node_set_ptr, node_set_inx);
+
+use_node_sets:
 	/*
 	 * If any nodes are powered down, put them into a new node_set
 	 * record with a higher scheduling weight. This means we avoid
@@ -4342,29 +4553,28 @@ static void _filter_nodes_in_set(struct node_set *node_set_ptr,
 		}
 
 	} else {	/* fast_schedule == 0, test individual node records */
-		struct node_record   *node_ptr = NULL;
+		/* Scan the compact scheduling view, not the node records */
+		const node_sched_view_t *view = node_sched_view();
 		for (i = 0; i < node_record_count; i++) {
 			int job_ok = 0, job_mc_ptr_ok = 0;
 			if (bit_test(node_set_ptr->my_bitmap, i) == 0)
 				continue;
-			node_ptr = &node_record_table_ptr[i];
-			total_cores = node_ptr->boards * node_ptr->sockets *
-				      node_ptr->cores;
 			adj_cpus = adjust_cpus_nppcu(
 						_get_ntasks_per_core(job_con),
 						job_con->cpus_per_task,
-						total_cores, node_ptr->cpus);
+						view->total_cores[i],
+						view->cpus[i]);
 			if ((job_con->pn_min_cpus     <= adj_cpus)            &&
 			    ((job_con->pn_min_memory & (~MEM_PER_CPU)) <=
-			      node_ptr->real_memory)                          &&
-			    (job_con->pn_min_tmp_disk <= node_ptr->tmp_disk))
+			      view->real_memory[i])                           &&
+			    (job_con->pn_min_tmp_disk <= view->tmp_disk[i]))
 				job_ok = 1;
 			if (mc_ptr &&
-			    (((mc_ptr->sockets_per_node <= node_ptr->sockets)  ||
+			    (((mc_ptr->sockets_per_node <= view->sockets[i])  ||
 			      (mc_ptr->sockets_per_node == NO_VAL16)) &&
-			     ((mc_ptr->cores_per_socket <= node_ptr->cores)    ||
+			     ((mc_ptr->cores_per_socket <= view->cores[i])    ||
 			      (mc_ptr->cores_per_socket == NO_VAL16)) &&
-			     ((mc_ptr->threads_per_core <= node_ptr->threads)  ||
+			     ((mc_ptr->threads_per_core <= view->threads[i])  ||
 			      (mc_ptr->threads_per_core == NO_VAL16))))
 				job_mc_ptr_ok = 1;
 			if (job_ok && (!mc_ptr || job_mc_ptr_ok))
@@ -57,6 +57,14 @@
 /* Log an error for ping that takes more than 100 seconds to complete */
 #define PING_TIMEOUT 100
 
+/* Number of consecutive responsive ping cycles after which a node is
+ * considered stable and its periodic re-registration is stretched */
+#define NODE_STABLE_CYCLES 10
+
+/* Periodic re-registration of stable nodes happens only on every Nth
+ * rotation of the registration window */
+#define STABLE_REG_STRETCH 4
+
 static pthread_mutex_t lock_mutex = PTHREAD_MUTEX_INITIALIZER;
 static int ping_count = 0;
 static time_t ping_start = 0;
@@ -136,6 +144,10 @@ void ping_nodes (void)
 					 * this can include DOWN nodes, so
 					 * limit the number to avoid huge
 					 * communication delays */
+	static uint16_t *stable_cnt = NULL; /* consecutive responsive ping
+					 * cycles for each node */
+	static int stable_cnt_size = 0;
+	static int reg_round = 0;	/* registration window rotations */
 	int i;
 	time_t now = time(NULL), still_live_time, node_dead_time;
 	static time_t last_ping_time = (time_t) 0;
@@ -188,8 +200,16 @@ void ping_nodes (void)
 	}
 	offset += max_reg_threads;
 	if ((offset > node_record_count) &&
-	    (offset >= (max_reg_threads * MAX_REG_FREQUENCY)))
+	    (offset >= (max_reg_threads * MAX_REG_FREQUENCY))) {
 		offset = 0;
+		reg_round++;
+	}
+
+	if (stable_cnt_size != node_record_count) {
+		xfree(stable_cnt);
+		stable_cnt = xcalloc(node_record_count, sizeof(uint16_t));
+		stable_cnt_size = node_record_count;
+	}
 
 #ifdef HAVE_FRONT_END
 	for (i = 0, front_end_ptr = front_end_nodes;
@@ -302,14 +322,29 @@ void ping_nodes (void)
 		    && (node_ptr->last_response < slurmctld_conf.last_update))
 			node_ptr->last_response = slurmctld_conf.last_update;
 
+		/* Track stability history. A node which has responded
+		 * across many consecutive ping cycles does not need its
+		 * configuration refreshed on every rotation of the
+		 * registration window below. */
+		if (IS_NODE_UNKNOWN(node_ptr) || IS_NODE_DOWN(node_ptr) ||
+		    IS_NODE_NO_RESPOND(node_ptr))
+			stable_cnt[i] = 0;
+		else if ((node_ptr->last_response >= still_live_time) &&
+			 (stable_cnt[i] < NO_VAL16))
+			stable_cnt[i]++;
+
 		/* Request a node registration if its state is UNKNOWN or
 		 * on a periodic basis (about every MAX_REG_FREQUENCY ping,
 		 * this mechanism avoids an additional (per node) timer or
 		 * counter and gets updated configuration information
 		 * once in a while). We limit these requests since they
-		 * can generate a flood of incoming RPCs. */
+		 * can generate a flood of incoming RPCs. Nodes with a long
+		 * stable history are re-registered on only every
+		 * STABLE_REG_STRETCH rotation of the window. */
 		if (IS_NODE_UNKNOWN(node_ptr) || (node_ptr->boot_time == 0) ||
-		    ((i >= offset) && (i < (offset + max_reg_threads)))) {
+		    ((i >= offset) && (i < (offset + max_reg_threads)) &&
+		     ((stable_cnt[i] < NODE_STABLE_CYCLES) ||
+		      ((reg_round % STABLE_REG_STRETCH) == 0)))) {
 			if (reg_agent_args->protocol_version >
 			    node_ptr->protocol_version)
 				reg_agent_args->protocol_version =
@@ -54,7 +54,12 @@ int        port_resv_cnt   = 0;
 int        port_resv_min   = 0;
 int        port_resv_max   = 0;
 
+/* Ports with no reservation on any node. Allocation draws from this set
+ * first, avoiding a per-node overlap test against every candidate port. */
+static bitstr_t *port_unused_bitmap = NULL;
+
 static void _dump_resv_port_info(void);
+static void _port_use_update(int port_inx);
 static void _make_all_resv(void);
 static void _make_step_resv(struct step_record *step_ptr);
 static void _rebuild_port_array(struct step_record *step_ptr);
@@ -76,6 +81,15 @@ static void _dump_resv_port_info(void)
 #endif
 }
 
+/* Update the unused port set after a change to one port's reservations */
+static void _port_use_update(int port_inx)
+{
+	if (bit_set_count(port_resv_table[port_inx]) == 0)
+		bit_set(port_unused_bitmap, port_inx);
+	else
+		bit_clear(port_unused_bitmap, port_inx);
+}
+
 /* Builds the job step's resv_port_array based upon resv_ports (a string) */
 static void _rebuild_port_array(struct step_record *step_ptr)
 {
@@ -130,6 +144,7 @@ static void _make_step_resv(struct step_record *step_ptr)
 			continue;
 		j = step_ptr->resv_port_array[i] - port_resv_min;
 		bit_or(port_resv_table[j], step_ptr->step_node_bitmap);
+		bit_clear(port_unused_bitmap, j);
 	}
 }
 
@@ -170,6 +185,7 @@ extern int reserve_port_config(char *mpi_params)
 			for (i=0; i<port_resv_cnt; i++)
 				FREE_NULL_BITMAP(port_resv_table[i]);
 			xfree(port_resv_table);
+			FREE_NULL_BITMAP(port_unused_bitmap);
 			port_resv_cnt = 0;
 			port_resv_min = port_resv_max = 0;
 		}
@@ -204,6 +220,9 @@ extern int reserve_port_config(char *mpi_params)
 	port_resv_table = xmalloc(sizeof(bitstr_t *) * port_resv_cnt);
 	for (i=0; i<port_resv_cnt; i++)
 		port_resv_table[i] = bit_alloc(node_record_count);
+	FREE_NULL_BITMAP(port_unused_bitmap);
+	port_unused_bitmap = bit_alloc(port_resv_cnt);
+	bit_nset(port_unused_bitmap, 0, port_resv_cnt - 1);
 
 	_make_all_resv();
 	_dump_resv_port_info();
@@ -233,19 +252,32 @@ extern int resv_port_alloc(struct step_record *step_ptr)
 		return ESLURM_PORTS_INVALID;
 	}
 
-	/* Identify available ports */
+	/* Identify available ports, preferring completely unused ports,
+	 * which need no per-node overlap test */
 	port_array = xmalloc(sizeof(int) * step_ptr->resv_port_cnt);
 	port_inx = 0;
 	for (i=0; i<port_resv_cnt; i++) {
 		if (++last_port_alloc >= port_resv_cnt)
 			last_port_alloc = 0;
-		if (bit_overlap(step_ptr->step_node_bitmap,
-				port_resv_table[last_port_alloc]))
+		if (!bit_test(port_unused_bitmap, last_port_alloc))
 			continue;
 		port_array[port_inx++] = last_port_alloc;
 		if (port_inx >= step_ptr->resv_port_cnt)
 			break;
 	}
+	/* Fall back upon ports used on nodes disjoint from this step.
+	 * Every unused port was already taken above, so skip them here. */
+	for (i=0; ((i<port_resv_cnt) &&
+		   (port_inx < step_ptr->resv_port_cnt)); i++) {
+		if (++last_port_alloc >= port_resv_cnt)
+			last_port_alloc = 0;
+		if (bit_test(port_unused_bitmap, last_port_alloc))
+			continue;
+		if (bit_overlap(step_ptr->step_node_bitmap,
+				port_resv_table[last_port_alloc]))
+			continue;
+		port_array[port_inx++] = last_port_alloc;
+	}
 	if (port_inx < step_ptr->resv_port_cnt) {
 		info("insufficient ports for %pS to reserve (%d of %u)",
 		     step_ptr, port_inx, step_ptr->resv_port_cnt);
@@ -258,6 +290,7 @@ extern int resv_port_alloc(struct step_record *step_ptr)
 	for (i=0; i<port_inx; i++) {
 		bit_or(port_resv_table[port_array[i]],
 		       step_ptr->step_node_bitmap);
+		bit_clear(port_unused_bitmap, port_array[i]);
 		port_array[i] += port_resv_min;
 		snprintf(port_str, sizeof(port_str), "%d", port_array[i]);
 		hostlist_push_host(hl, port_str);
@@ -289,7 +322,7 @@ extern void resv_port_free(struct step_record *step_ptr)
 			continue;
 		j = step_ptr->resv_port_array[i] - port_resv_min;
 		bit_and_not(port_resv_table[j], step_ptr->step_node_bitmap);
-
+		_port_use_update(j);
 	}
 	xfree(step_ptr->resv_port_array);
 
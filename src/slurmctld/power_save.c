@@ -57,6 +57,7 @@
 #include <unistd.h>
 
 #include "src/common/bitstring.h"
+#include "src/common/hostlist.h"
 #include "src/common/list.h"
 #include "src/common/macros.h"
 #include "src/common/node_features.h"
@@ -95,6 +96,7 @@ time_t last_config = (time_t) 0;
 time_t last_log = (time_t) 0, last_work_scan = (time_t) 0;
 uint16_t slurmd_timeout;
 static bool idle_on_node_suspend = false;
+static int power_save_batch_size = 0;
 
 typedef struct exc_node_partital {
 	int exc_node_cnt;
@@ -670,20 +672,56 @@ static void _do_failed_nodes(char *hosts)
 		     (int)pid, hosts);
 }
 
+/*
+ * Run a suspend or resume program over a set of nodes, splitting the set
+ * into batches of power_save_batch_size nodes run as concurrent processes.
+ * A program which acts upon its node list serially otherwise gates large
+ * cloud resume operations on a single process. With power_save_batch_size
+ * unset the program is run once with the full node list as before.
+ */
+static void _run_prog_batched(char *prog, char *hosts, char *action)
+{
+	hostlist_t hl, batch_hl;
+	char *name, *batch_hosts;
+	pid_t pid;
+	int cnt;
+
+	if (power_save_batch_size < 1) {
+		pid = _run_prog(prog, hosts, NULL, 0);
+		if (power_save_debug)
+			info("power_save: pid %d %s nodes %s",
+			     (int) pid, action, hosts);
+		return;
+	}
+
+	hl = hostlist_create(hosts);
+	while (hostlist_count(hl) > 0) {
+		batch_hl = hostlist_create(NULL);
+		for (cnt = 0; cnt < power_save_batch_size; cnt++) {
+			if (!(name = hostlist_shift(hl)))
+				break;
+			hostlist_push_host(batch_hl, name);
+			free(name);
+		}
+		batch_hosts = hostlist_ranged_string_xmalloc(batch_hl);
+		pid = _run_prog(prog, batch_hosts, NULL, 0);
+		if (power_save_debug)
+			info("power_save: pid %d %s nodes %s",
+			     (int) pid, action, batch_hosts);
+		xfree(batch_hosts);
+		hostlist_destroy(batch_hl);
+	}
+	hostlist_destroy(hl);
+}
+
 static void _do_resume(char *host)
 {
-	pid_t pid = _run_prog(resume_prog, host, NULL, 0);
-	if (power_save_debug)
-		info("power_save: pid %d waking nodes %s",
-		     (int) pid, host);
+	_run_prog_batched(resume_prog, host, "waking");
 }
 
 static void _do_suspend(char *host)
 {
-	pid_t pid = _run_prog(suspend_prog, host, NULL, 0);
-	if (power_save_debug)
-		info("power_save: pid %d suspending nodes %s",
-		     (int) pid, host);
+	_run_prog_batched(suspend_prog, host, "suspending");
 }
 
 /* run a suspend or resume program
@@ -851,6 +889,8 @@ static void _clear_power_config(void)
  */
 static int _init_power_config(void)
 {
+	char *tmp_ptr;
+
 	last_config     = slurmctld_conf.last_update;
 	last_work_scan  = 0;
 	last_log	= 0;
@@ -875,6 +915,16 @@ static int _init_power_config(void)
 	idle_on_node_suspend = xstrcasestr(slurmctld_conf.slurmctld_params,
 					   "idle_on_node_suspend");
 
+	power_save_batch_size = 0;
+	if ((tmp_ptr = xstrcasestr(slurmctld_conf.slurmctld_params,
+				   "power_save_batch_size="))) {
+		power_save_batch_size = atoi(tmp_ptr + 22);
+		if (power_save_batch_size < 1) {
+			error("Invalid SlurmctldParameters power_save_batch_size ignored");
+			power_save_batch_size = 0;
+		}
+	}
+
 	if (idle_time < 0) {	/* not an error */
 		debug("power_save module disabled, SuspendTime < 0");
 		return -1;
@@ -64,6 +64,27 @@
 #define L_NUM_FREQ	"NumFreqChoices"
 #define L_CUR_POWER	"CurrentCorePower"
 
+/*
+ * The per node power values come from the "power" layout, which cannot be
+ * reloaded without a full restart (see layouts_load_config() in
+ * read_config.c), so they are cached here in node index order along with
+ * their cluster wide rollups. Only CurrentPower style values have to be
+ * fetched live from the layout. The full cluster evaluation used by the
+ * scheduler's feasibility check is additionally memoized against
+ * last_node_update, making it O(1) between node state changes.
+ */
+static int watts_cache_cnt = 0;
+static uint32_t *node_max_watts = NULL;
+static uint32_t *node_idle_watts = NULL;
+static uint32_t *node_down_watts = NULL;
+static uint32_t *node_save_watts = NULL;
+static uint32_t cluster_max_watts = 0;
+static uint32_t cluster_min_watts = 0;
+
+/* Cache of the cap_watts value parsed out of PowerParameters */
+static uint32_t cap_watts_cache = 0;
+static time_t cap_watts_conf_update = (time_t) 0;
+
 static bool _powercap_enabled(void)
 {
 	if (powercap_get_cluster_current_cap() == 0)
@@ -71,6 +92,50 @@ static bool _powercap_enabled(void)
 	return true;
 }
 
+/* Build the per node watts arrays and cluster rollups from the layout.
+ * RET true when the cache is usable */
+static bool _build_watts_cache(void)
+{
+	uint32_t min_watts;
+	struct node_record *node_ptr;
+	int i;
+
+	if (node_max_watts && (watts_cache_cnt == node_record_count))
+		return true;
+
+	if (!power_layout_ready())
+		return false;
+
+	xfree(node_max_watts);
+	xfree(node_idle_watts);
+	xfree(node_down_watts);
+	xfree(node_save_watts);
+	node_max_watts = xcalloc(node_record_count, sizeof(uint32_t));
+	node_idle_watts = xcalloc(node_record_count, sizeof(uint32_t));
+	node_down_watts = xcalloc(node_record_count, sizeof(uint32_t));
+	node_save_watts = xcalloc(node_record_count, sizeof(uint32_t));
+	cluster_max_watts = cluster_min_watts = 0;
+
+	for (i = 0, node_ptr = node_record_table_ptr; i < node_record_count;
+	     i++, node_ptr++) {
+		layouts_entity_get_kv(L_NAME, node_ptr->name, L_NODE_MAX,
+					  &node_max_watts[i], L_T_UINT32);
+		layouts_entity_get_kv(L_NAME, node_ptr->name, L_NODE_IDLE,
+					  &node_idle_watts[i], L_T_UINT32);
+		layouts_entity_get_kv(L_NAME, node_ptr->name, L_NODE_DOWN,
+					  &node_down_watts[i], L_T_UINT32);
+		layouts_entity_get_kv(L_NAME, node_ptr->name, L_NODE_SAVE,
+					  &node_save_watts[i], L_T_UINT32);
+		cluster_max_watts += node_max_watts[i];
+		min_watts = MIN(node_idle_watts[i], node_down_watts[i]);
+		min_watts = MIN(min_watts, node_save_watts[i]);
+		cluster_min_watts += min_watts;
+	}
+	watts_cache_cnt = node_record_count;
+
+	return true;
+}
+
 int _which_power_layout(char *layout)
 {
 	uint32_t max_watts;
@@ -102,11 +167,17 @@ int which_power_layout(void)
 bool power_layout_ready(void)
 {
 	static time_t last_error_time = (time_t) 0;
+	static bool layout_ready = false;
 	time_t now = time(NULL);
 	struct node_record *node_ptr;
 	uint32_t data[2];
 	int i;
 
+	/* The layouts configuration can only change with a restart, so a
+	 * complete layout stays complete. */
+	if (layout_ready)
+		return true;
+
 	for (i = 0, node_ptr = node_record_table_ptr; i < node_record_count;
 	     i++, node_ptr++) {
 		if (layouts_entity_get_mkv(L_NAME, node_ptr->name,
@@ -121,52 +192,31 @@ bool power_layout_ready(void)
 			return false;
 		}
 	}
+	layout_ready = true;
 	return true;
 }
 
 
 uint32_t powercap_get_cluster_max_watts(void)
 {
-	uint32_t max_watts;
-
 	if (!_powercap_enabled())
 		return 0;
 
-	if (!power_layout_ready())
+	if (!_build_watts_cache())
 		return 0;
 
-	layouts_entity_get_kv(L_NAME, L_CLUSTER, L_SUM_MAX, &max_watts,
-				  L_T_UINT32);
-
-	return max_watts;
+	return cluster_max_watts;
 }
 
 uint32_t powercap_get_cluster_min_watts(void)
 {
-	uint32_t min_watts = 0, tmp_watts, save_watts, down_watts;
-	struct node_record *node_ptr;
-	int i;
-
 	if (!_powercap_enabled())
 		return 0;
-	
-	if (!power_layout_ready())
-		return 0;
 
-	for (i = 0, node_ptr = node_record_table_ptr; i < node_record_count;
-	     i++, node_ptr++) {
-		layouts_entity_get_kv(L_NAME, node_ptr->name, L_NODE_IDLE,
-					  &tmp_watts, L_T_UINT32);
-		layouts_entity_get_kv(L_NAME, node_ptr->name, L_NODE_DOWN,
-					  &down_watts, L_T_UINT32);
-		tmp_watts = MIN(tmp_watts, down_watts);
-		layouts_entity_get_kv(L_NAME, node_ptr->name, L_NODE_SAVE,
-					  &save_watts, L_T_UINT32);
-		tmp_watts = MIN(tmp_watts, save_watts);
-		min_watts += tmp_watts;
-	}
+	if (!_build_watts_cache())
+		return 0;
 
-	return min_watts;
+	return cluster_min_watts;
 }
 
 uint32_t powercap_get_cluster_current_cap(void)
@@ -174,6 +224,13 @@ uint32_t powercap_get_cluster_current_cap(void)
 	char *end_ptr = NULL, *power_params, *tmp_ptr;
 	uint32_t cap_watts = 0;
 
+	/* Parsing PowerParameters costs a conf lock and a string dup, so
+	 * keep the value until the config is reloaded or the cap is reset
+	 * through powercap_set_cluster_cap(). */
+	if (cap_watts_conf_update &&
+	    (cap_watts_conf_update == slurmctld_conf.last_update))
+		return cap_watts_cache;
+
 	power_params = slurm_get_power_parameters();
 	if (!power_params)
 		return cap_watts;
@@ -192,6 +249,9 @@ uint32_t powercap_get_cluster_current_cap(void)
 	}
 	xfree(power_params);
 
+	cap_watts_cache = cap_watts;
+	cap_watts_conf_update = slurmctld_conf.last_update;
+
 	return cap_watts;
 }
 
@@ -235,6 +295,9 @@ int powercap_set_cluster_cap(uint32_t new_cap)
 	else
 		xstrfmtcat(power_params, "%scap_watts=%u", sep, new_cap);
 	slurm_set_power_parameters(power_params);
+	/* Changing PowerParameters does not touch slurmctld_conf.last_update,
+	 * so drop the cached cap explicitly */
+	cap_watts_conf_update = (time_t) 0;
 	power_g_reconfig();
 	xfree(power_params);
 
@@ -243,27 +306,20 @@ int powercap_set_cluster_cap(uint32_t new_cap)
 
 uint32_t powercap_get_cluster_adjusted_max_watts(void)
 {
-	uint32_t adj_max_watts = 0,val;
-	struct node_record *node_ptr;
+	uint32_t adj_max_watts = 0;
 	int i;
 
 	if (!_powercap_enabled())
 		return 0;
-	if (!power_layout_ready())
+	if (!_build_watts_cache())
 		return 0;
-	for (i = 0, node_ptr = node_record_table_ptr; i < node_record_count;
-	     i++, node_ptr++) {
-		if (bit_test(power_node_bitmap, i)) {
-			layouts_entity_get_kv(L_NAME, node_ptr->name,
-					L_NODE_SAVE, &val, L_T_UINT32);
-		} else if (!bit_test(up_node_bitmap, i)) {
-			layouts_entity_get_kv(L_NAME, node_ptr->name,
-					L_NODE_DOWN, &val, L_T_UINT32);
-		} else {
-			layouts_entity_get_kv(L_NAME, node_ptr->name,
-					L_NODE_MAX, &val, L_T_UINT32);
-		}
-		adj_max_watts += val;
+	for (i = 0; i < node_record_count; i++) {
+		if (bit_test(power_node_bitmap, i))
+			adj_max_watts += node_save_watts[i];
+		else if (!bit_test(up_node_bitmap, i))
+			adj_max_watts += node_down_watts[i];
+		else
+			adj_max_watts += node_max_watts[i];
 	}
 
 	return adj_max_watts;
@@ -290,55 +346,52 @@ uint32_t powercap_get_cluster_current_max_watts(void)
 
 uint32_t powercap_get_node_bitmap_maxwatts(bitstr_t *idle_bitmap)
 {
-	uint32_t max_watts = 0, val;
-	struct node_record *node_ptr;
+	static uint32_t cluster_cur_max_watts = 0;
+	static time_t cache_node_update = (time_t) 0;
+	uint32_t max_watts = 0;
+	time_t node_update;
 	int i;
-	bitstr_t *tmp_bitmap = NULL;
 
 	if (!_powercap_enabled())
 		return 0;
-	if (!power_layout_ready())
+	if (!_build_watts_cache())
 		return 0;
 
-	/* if no input bitmap, consider the current idle nodes 
-	 * bitmap as the input bitmap tagging nodes to consider 
+	/* if no input bitmap, consider the current idle nodes
+	 * bitmap as the input bitmap tagging nodes to consider
 	 * as idle while computing the max watts of the cluster */
 	if (idle_bitmap == NULL) {
-		tmp_bitmap = bit_copy(idle_node_bitmap);
-		idle_bitmap = tmp_bitmap;
+		/* This is the scheduler's cluster wide evaluation: the sum
+		 * only moves when some node changes state, so reuse it
+		 * until last_node_update says otherwise. */
+		if (cache_node_update &&
+		    (cache_node_update == last_node_update))
+			return cluster_cur_max_watts;
+		idle_bitmap = idle_node_bitmap;
 	}
 
-	for (i = 0, node_ptr = node_record_table_ptr; i < node_record_count;
-	     i++, node_ptr++) {
+	node_update = last_node_update;
+	for (i = 0; i < node_record_count; i++) {
 		/* non reserved node, evaluate the different cases */
 		if (bit_test(idle_bitmap, i)) {
 			 /* idle nodes, 2 cases : power save or not */
-			if (bit_test(power_node_bitmap, i)) {
-				layouts_entity_get_kv(L_NAME,
-						node_ptr->name, L_NODE_SAVE,
-						&val, L_T_UINT32);
-			} else {
-				layouts_entity_get_kv(L_NAME,
-						node_ptr->name, L_NODE_IDLE,
-						&val, L_T_UINT32);
-			}
+			if (bit_test(power_node_bitmap, i))
+				max_watts += node_save_watts[i];
+			else
+				max_watts += node_idle_watts[i];
 		} else {
 			/* non idle nodes, 2 cases : down or not */
-			if (!bit_test(up_node_bitmap, i)) {
-				layouts_entity_get_kv(L_NAME, 
-						node_ptr->name, L_NODE_DOWN,
-						&val, L_T_UINT32);
-			} else {
-				layouts_entity_get_kv(L_NAME,
-						node_ptr->name, L_NODE_MAX,
-						&val, L_T_UINT32);
-			}
+			if (!bit_test(up_node_bitmap, i))
+				max_watts += node_down_watts[i];
+			else
+				max_watts += node_max_watts[i];
 		}
-		max_watts += val;	
 	}
 
-	if (tmp_bitmap)
-		bit_free(tmp_bitmap);
+	if (idle_bitmap == idle_node_bitmap) {
+		cluster_cur_max_watts = max_watts;
+		cache_node_update = node_update;
+	}
 
 	return max_watts;
 }
@@ -489,6 +542,8 @@ uint32_t powercap_get_node_bitmap_maxwatts_dvfs(bitstr_t *idle_bitmap,
 
 	if (!_powercap_enabled())
 		return 0;
+	if (!_build_watts_cache())
+		return 0;
 
 	if (max_watts_dvfs != NULL) {
 		tmp_max_watts_dvfs = 
@@ -508,16 +563,11 @@ uint32_t powercap_get_node_bitmap_maxwatts_dvfs(bitstr_t *idle_bitmap,
 	     i++, node_ptr++) {
 		if (bit_test(idle_bitmap, i)) {
 			/* idle nodes, 2 cases : power save or not */
-			if (bit_test(power_node_bitmap, i)) {
-				layouts_entity_get_kv(L_NAME,
-						  node_ptr->name, L_NODE_SAVE,
-						  &val, L_T_UINT32);
-			} else {
-				layouts_entity_get_kv(L_NAME,
-						  node_ptr->name, L_NODE_IDLE,
-						  &val, L_T_UINT32);
-			}
-		
+			if (bit_test(power_node_bitmap, i))
+				val = node_save_watts[i];
+			else
+				val = node_idle_watts[i];
+
 		} else if (bit_test(select_bitmap, i)) {
 			layouts_entity_get_mkv(L_NAME, node_ptr->name,
 				"IdleWatts,MaxWatts,CoresCount,LastCore,CurrentPower",
@@ -575,10 +625,9 @@ uint32_t powercap_get_node_bitmap_maxwatts_dvfs(bitstr_t *idle_bitmap,
 		} else {
 			/* non-idle nodes, 2 cases : down or not */
 			if (!bit_test(up_node_bitmap, i)) {
-				layouts_entity_get_kv(L_NAME,
-						  node_ptr->name, L_NODE_DOWN,
-						  &val, L_T_UINT32);
+				val = node_down_watts[i];
 			} else {
+				/* CurrentPower is dynamic, fetch it live */
 				layouts_entity_get_kv(L_NAME,
 						  node_ptr->name, L_NODE_CUR,
 						  &val, L_T_UINT32);
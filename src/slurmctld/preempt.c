@@ -79,6 +79,7 @@ static void _preempt_signal(struct job_record *job_ptr, uint32_t grace_time)
 	job_ptr->preempt_time = time(NULL);
 	job_ptr->end_time = MIN(job_ptr->end_time,
 				(job_ptr->preempt_time + (time_t)grace_time));
+	job_time_limit_register(job_ptr, job_ptr->preempt_time);
 
 	/* Signal the job at the beginning of preemption GraceTime */
 	job_signal(job_ptr, SIGCONT, 0, 0, 0);
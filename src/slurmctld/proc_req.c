@@ -78,6 +78,7 @@
 #include "src/common/slurm_priority.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_protocol_interface.h"
+#include "src/common/slurm_time.h"
 #include "src/common/slurm_topology.h"
 #include "src/common/switch.h"
 #include "src/common/uid.h"
@@ -105,15 +106,33 @@
 #include "src/slurmctld/state_save.h"
 #include "src/slurmctld/trigger_mgr.h"
 
+/*
+ * RPC counts, processing times and latency histograms are kept in shards
+ * selected by the service thread identifier and merged when read, so
+ * recording a sample does not contend on a single lock. The rpc_type_id
+ * and rpc_user_id tables only grow; established entries are scanned
+ * without locking and rpc_mutex is only taken to install a new entry.
+ */
+#define RPC_STATS_SHARDS  16
+#define RPC_TYPE_SIZE     100	/* Capture info for first 100 RPC types */
+#define RPC_USER_SIZE     200	/* Capture info for first 200 RPC users */
+/* Power of two microsecond latency buckets, the last bucket is overflow */
+#define RPC_TIME_NBUCKETS 24
+
+typedef struct rpc_stats_shard {
+	pthread_mutex_t lock;
+	uint32_t type_cnt[RPC_TYPE_SIZE];
+	uint64_t type_time[RPC_TYPE_SIZE];
+	uint32_t type_hist[RPC_TYPE_SIZE * RPC_TIME_NBUCKETS];
+	uint32_t user_cnt[RPC_USER_SIZE];
+	uint64_t user_time[RPC_USER_SIZE];
+} rpc_stats_shard_t;
+
 static pthread_mutex_t rpc_mutex = PTHREAD_MUTEX_INITIALIZER;
-static int rpc_type_size = 0;	/* Size of rpc_type_* arrays */
-static uint16_t *rpc_type_id = NULL;
-static uint32_t *rpc_type_cnt = NULL;
-static uint64_t *rpc_type_time = NULL;
-static int rpc_user_size = 0;	/* Size of rpc_user_* arrays */
-static uint32_t *rpc_user_id = NULL;
-static uint32_t *rpc_user_cnt = NULL;
-static uint64_t *rpc_user_time = NULL;
+static uint16_t rpc_type_id[RPC_TYPE_SIZE];
+static uint32_t rpc_user_id[RPC_USER_SIZE];
+static rpc_stats_shard_t rpc_stats_shards[RPC_STATS_SHARDS];
+static pthread_once_t rpc_stats_once = PTHREAD_ONCE_INIT;
 
 static pthread_mutex_t throttle_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t throttle_cond = PTHREAD_COND_INITIALIZER;
@@ -159,6 +178,7 @@ inline static void  _slurm_rpc_dump_job_single(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_licenses(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_nodes(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_node_single(slurm_msg_t * msg);
+inline static void  _slurm_rpc_dump_node_summary(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_partitions(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_spank(slurm_msg_t * msg);
 inline static void  _slurm_rpc_dump_stats(slurm_msg_t * msg);
@@ -182,6 +202,7 @@ inline static void  _slurm_rpc_job_will_run(slurm_msg_t * msg);
 inline static void  _slurm_rpc_job_alloc_info(slurm_msg_t * msg);
 inline static void  _slurm_rpc_job_pack_alloc_info(slurm_msg_t * msg);
 inline static void  _slurm_rpc_kill_job(slurm_msg_t *msg);
+inline static void  _slurm_rpc_kill_jobs(slurm_msg_t *msg);
 inline static void  _slurm_rpc_node_registration(slurm_msg_t *msg,
 						 bool running_composite);
 inline static void  _slurm_rpc_ping(slurm_msg_t * msg);
@@ -210,6 +231,7 @@ inline static void  _slurm_rpc_step_complete(slurm_msg_t * msg,
 inline static void  _slurm_rpc_step_layout(slurm_msg_t * msg);
 inline static void  _slurm_rpc_step_update(slurm_msg_t * msg);
 inline static void  _slurm_rpc_submit_batch_job(slurm_msg_t * msg);
+inline static void  _slurm_rpc_submit_batch_jobs(slurm_msg_t * msg);
 inline static void  _slurm_rpc_submit_batch_pack_job(slurm_msg_t * msg);
 inline static void  _slurm_rpc_suspend(slurm_msg_t * msg);
 inline static void  _slurm_rpc_top_job(slurm_msg_t * msg);
@@ -249,6 +271,93 @@ extern diag_stats_t slurmctld_diag_stats;
 static __thread bool drop_priv = false;
 #endif
 
+static void _rpc_stats_init(void)
+{
+	int i;
+
+	for (i = 0; i < RPC_STATS_SHARDS; i++)
+		slurm_mutex_init(&rpc_stats_shards[i].lock);
+}
+
+/* Shard used by this thread for recording RPC statistics */
+static rpc_stats_shard_t *_rpc_stats_shard(void)
+{
+	size_t h = (size_t) pthread_self();
+
+	/* Thread handles are aligned pointers on many systems, fold in the
+	 * high bits so the shards spread over more than the alignment */
+	h ^= (h >> 12);
+	return &rpc_stats_shards[h % RPC_STATS_SHARDS];
+}
+
+/*
+ * Index of a message type in the rpc_type_id table, adding it if not
+ * yet present. Entries are never changed once installed (outside of an
+ * explicit statistics reset), so the common case scans without locking.
+ */
+static int _rpc_type_index(uint16_t msg_type)
+{
+	int i;
+
+	for (i = 0; i < RPC_TYPE_SIZE; i++) {
+		if (rpc_type_id[i] == msg_type)
+			return i;
+		if (rpc_type_id[i] == 0)
+			break;
+	}
+
+	slurm_mutex_lock(&rpc_mutex);
+	for (i = 0; i < RPC_TYPE_SIZE; i++) {
+		if (rpc_type_id[i] == 0)
+			rpc_type_id[i] = msg_type;
+		if (rpc_type_id[i] == msg_type) {
+			slurm_mutex_unlock(&rpc_mutex);
+			return i;
+		}
+	}
+	slurm_mutex_unlock(&rpc_mutex);
+	return -1;
+}
+
+/* As above for the rpc_user_id table. Slot 0 is reserved for uid 0. */
+static int _rpc_user_index(uint32_t rpc_uid)
+{
+	int i;
+
+	if (rpc_uid == 0)
+		return 0;
+	for (i = 1; i < RPC_USER_SIZE; i++) {
+		if (rpc_user_id[i] == rpc_uid)
+			return i;
+		if (rpc_user_id[i] == 0)
+			break;
+	}
+
+	slurm_mutex_lock(&rpc_mutex);
+	for (i = 1; i < RPC_USER_SIZE; i++) {
+		if (rpc_user_id[i] == 0)
+			rpc_user_id[i] = rpc_uid;
+		if (rpc_user_id[i] == rpc_uid) {
+			slurm_mutex_unlock(&rpc_mutex);
+			return i;
+		}
+	}
+	slurm_mutex_unlock(&rpc_mutex);
+	return -1;
+}
+
+/* Histogram bucket for an RPC processing time in microseconds */
+static int _rpc_time_bucket(uint64_t usec)
+{
+	int bucket = 0;
+
+	while ((usec > 1) && (bucket < (RPC_TIME_NBUCKETS - 1))) {
+		usec >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
 /*
  * slurmctld_req  - Process an individual RPC request
  * IN/OUT msg - the request message, data associated with the message is freed
@@ -257,6 +366,7 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 {
 	DEF_TIMERS;
 	int i, rpc_type_index = -1, rpc_user_index = -1;
+	rpc_stats_shard_t *shard;
 	uint32_t rpc_uid;
 
 	if (arg && (arg->newsockfd >= 0))
@@ -274,36 +384,9 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 	}
 	rpc_uid = (uint32_t) g_slurm_auth_get_uid(msg->auth_cred);
 
-	slurm_mutex_lock(&rpc_mutex);
-	if (rpc_type_size == 0) {
-		rpc_type_size = 100;  /* Capture info for first 100 RPC types */
-		rpc_type_id   = xmalloc(sizeof(uint16_t) * rpc_type_size);
-		rpc_type_cnt  = xmalloc(sizeof(uint32_t) * rpc_type_size);
-		rpc_type_time = xmalloc(sizeof(uint64_t) * rpc_type_size);
-	}
-	for (i = 0; i < rpc_type_size; i++) {
-		if (rpc_type_id[i] == 0)
-			rpc_type_id[i] = msg->msg_type;
-		else if (rpc_type_id[i] != msg->msg_type)
-			continue;
-		rpc_type_index = i;
-		break;
-	}
-	if (rpc_user_size == 0) {
-		rpc_user_size = 200;  /* Capture info for first 200 RPC users */
-		rpc_user_id   = xmalloc(sizeof(uint32_t) * rpc_user_size);
-		rpc_user_cnt  = xmalloc(sizeof(uint32_t) * rpc_user_size);
-		rpc_user_time = xmalloc(sizeof(uint64_t) * rpc_user_size);
-	}
-	for (i = 0; i < rpc_user_size; i++) {
-		if ((rpc_user_id[i] == 0) && (i != 0))
-			rpc_user_id[i] = rpc_uid;
-		else if (rpc_user_id[i] != rpc_uid)
-			continue;
-		rpc_user_index = i;
-		break;
-	}
-	slurm_mutex_unlock(&rpc_mutex);
+	pthread_once(&rpc_stats_once, _rpc_stats_init);
+	rpc_type_index = _rpc_type_index(msg->msg_type);
+	rpc_user_index = _rpc_user_index(rpc_uid);
 
 	/* Debug the protocol layer.
 	 */
@@ -369,6 +452,9 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 	case REQUEST_NODE_INFO_SINGLE:
 		_slurm_rpc_dump_node_single(msg);
 		break;
+	case REQUEST_NODE_INFO_SUMMARY:
+		_slurm_rpc_dump_node_summary(msg);
+		break;
 	case REQUEST_PARTITION_INFO:
 		_slurm_rpc_dump_partitions(msg);
 		break;
@@ -444,6 +530,9 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 	case REQUEST_SUBMIT_BATCH_JOB_PACK:
 		_slurm_rpc_submit_batch_pack_job(msg);
 		break;
+	case REQUEST_SUBMIT_BATCH_JOBS:
+		_slurm_rpc_submit_batch_jobs(msg);
+		break;
 	case REQUEST_UPDATE_FRONT_END:
 		_slurm_rpc_update_front_end(msg);
 		break;
@@ -573,6 +662,9 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 	case REQUEST_KILL_JOB:
 		_slurm_rpc_kill_job(msg);
 		break;
+	case REQUEST_KILL_JOBS:
+		_slurm_rpc_kill_jobs(msg);
+		break;
 	case MESSAGE_COMPOSITE:
 		_slurm_rpc_composite_msg(msg);
 		break;
@@ -603,16 +695,21 @@ void slurmctld_req(slurm_msg_t *msg, connection_arg_t *arg)
 	}
 
 	END_TIMER;
-	slurm_mutex_lock(&rpc_mutex);
-	if (rpc_type_index >= 0) {
-		rpc_type_cnt[rpc_type_index]++;
-		rpc_type_time[rpc_type_index] += DELTA_TIMER;
-	}
-	if (rpc_user_index >= 0) {
-		rpc_user_cnt[rpc_user_index]++;
-		rpc_user_time[rpc_user_index] += DELTA_TIMER;
+	if ((rpc_type_index >= 0) || (rpc_user_index >= 0)) {
+		shard = _rpc_stats_shard();
+		slurm_mutex_lock(&shard->lock);
+		if (rpc_type_index >= 0) {
+			shard->type_cnt[rpc_type_index]++;
+			shard->type_time[rpc_type_index] += DELTA_TIMER;
+			shard->type_hist[(rpc_type_index * RPC_TIME_NBUCKETS) +
+					 _rpc_time_bucket(DELTA_TIMER)]++;
+		}
+		if (rpc_user_index >= 0) {
+			shard->user_cnt[rpc_user_index]++;
+			shard->user_time[rpc_user_index] += DELTA_TIMER;
+		}
+		slurm_mutex_unlock(&shard->lock);
 	}
-	slurm_mutex_unlock(&rpc_mutex);
 }
 
 /* These functions prevent certain RPCs from keeping the slurmctld write locks
@@ -692,7 +789,7 @@ static void _fill_ctld_conf(slurm_ctl_conf_t * conf_ptr)
 
 	memset(conf_ptr, 0, sizeof(slurm_ctl_conf_t));
 
-	conf_ptr->last_update         = time(NULL);
+	conf_ptr->last_update         = slurm_cached_time();
 	conf_ptr->accounting_storage_enforce =
 		conf->accounting_storage_enforce;
 	conf_ptr->accounting_storage_host =
@@ -1125,7 +1222,7 @@ static int _make_step_cred(struct step_record *step_ptr,
 static int _pack_job_cancel(void *x, void *arg)
 {
 	struct job_record *job_ptr = (struct job_record *) x;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 
 	info("Cancelling aborted pack job submit: %pJ", job_ptr);
 	job_ptr->job_state	= JOB_CANCELLED;
@@ -1978,30 +2075,102 @@ static void  _slurm_rpc_get_shares(slurm_msg_t *msg)
 	response_msg.data     = &resp_msg;
 	slurm_send_node_msg(msg->conn_fd, &response_msg);
 	FREE_NULL_LIST(resp_msg.assoc_shares_list);
-	/* don't free the resp_msg.tres_names */
+	if (resp_msg.tres_names) {
+		int i;
+		for (i = 0; i < resp_msg.tres_cnt; i++)
+			xfree(resp_msg.tres_names[i]);
+		xfree(resp_msg.tres_names);
+	}
 	END_TIMER2("_slurm_rpc_get_share");
 	debug2("_slurm_rpc_get_shares %s", TIME_STR);
 }
 
 static void  _slurm_rpc_get_priority_factors(slurm_msg_t *msg)
 {
+	static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+	static Buf cache_buf = NULL;
+	static time_t cache_job_update = (time_t) 0;
+	static uid_t cache_uid = NO_VAL;
+	static uint16_t cache_version = 0;
 	DEF_TIMERS;
 	priority_factors_request_msg_t *req_msg =
 		(priority_factors_request_msg_t *) msg->data;
 	priority_factors_response_msg_t resp_msg;
 	slurm_msg_t response_msg;
+	/* Read lock on jobs (for last_job_update) */
+	slurmctld_lock_t job_read_lock =
+		{ NO_LOCK, READ_LOCK, NO_LOCK, NO_LOCK, NO_LOCK };
+	char *dump = NULL;
+	int dump_size = 0;
+	bool cacheable;
+	uid_t key_uid;
 
 	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
 
 	START_TIMER;
 	debug2("Processing RPC: REQUEST_PRIORITY_FACTORS from uid=%d", uid);
-	resp_msg.priority_factors_list = priority_g_get_priority_factors_list(
-		req_msg, uid);
+
+	/*
+	 * Building and packing the factors list walks every pending job, so
+	 * cache the packed image of the unfiltered response.  It only goes
+	 * stale when the job table changes (the decay thread updates
+	 * last_job_update after each recalculation).  The requesting uid is
+	 * part of the key only when it filters the content.
+	 */
+	cacheable = !req_msg->job_id_list && !req_msg->uid_list &&
+		    !req_msg->partitions;
+	if (slurmctld_conf.private_data & PRIVATE_DATA_JOBS)
+		key_uid = uid;
+	else
+		key_uid = NO_VAL;
+	if (cacheable) {
+		lock_slurmctld(job_read_lock);
+		slurm_mutex_lock(&cache_mutex);
+		if (cache_buf && (cache_job_update == last_job_update) &&
+		    (cache_uid == key_uid) &&
+		    (cache_version == msg->protocol_version)) {
+			dump_size = get_buf_offset(cache_buf);
+			dump = xmalloc(dump_size);
+			memcpy(dump, get_buf_data(cache_buf), dump_size);
+		}
+		slurm_mutex_unlock(&cache_mutex);
+		unlock_slurmctld(job_read_lock);
+	}
+
+	if (!dump) {
+		Buf buffer;
+		time_t job_update;
+
+		resp_msg.priority_factors_list =
+			priority_g_get_priority_factors_list(req_msg, uid);
+		lock_slurmctld(job_read_lock);
+		job_update = last_job_update;
+		unlock_slurmctld(job_read_lock);
+		buffer = init_buf(BUF_SIZE);
+		pack_priority_factors_response_msg(&resp_msg, buffer,
+						   msg->protocol_version);
+		FREE_NULL_LIST(resp_msg.priority_factors_list);
+		dump_size = get_buf_offset(buffer);
+		dump = xmalloc(dump_size);
+		memcpy(dump, get_buf_data(buffer), dump_size);
+		if (cacheable) {
+			slurm_mutex_lock(&cache_mutex);
+			FREE_NULL_BUFFER(cache_buf);
+			cache_buf = buffer;
+			cache_job_update = job_update;
+			cache_uid = key_uid;
+			cache_version = msg->protocol_version;
+			slurm_mutex_unlock(&cache_mutex);
+		} else
+			free_buf(buffer);
+	}
+
 	response_init(&response_msg, msg);
 	response_msg.msg_type = RESPONSE_PRIORITY_FACTORS;
-	response_msg.data     = &resp_msg;
+	response_msg.data     = dump;
+	response_msg.data_size = dump_size;
 	slurm_send_node_msg(msg->conn_fd, &response_msg);
-	FREE_NULL_LIST(resp_msg.priority_factors_list);
+	xfree(dump);
 	END_TIMER2("_slurm_rpc_get_priority_factors");
 	debug2("_slurm_rpc_get_priority_factors %s", TIME_STR);
 }
@@ -2211,6 +2380,57 @@ static void _slurm_rpc_dump_node_single(slurm_msg_t * msg)
 	xfree(dump);
 }
 
+/* _slurm_rpc_dump_node_summary - dump RPC for per-partition node state
+ * counts, in place of a full node info dump */
+static void _slurm_rpc_dump_node_summary(slurm_msg_t * msg)
+{
+	DEF_TIMERS;
+	node_summary_info_msg_t *summary_msg;
+	slurm_msg_t response_msg;
+	node_info_request_msg_t *node_req_msg =
+		(node_info_request_msg_t *) msg->data;
+	/* Locks: Read config, write node (reset allocated CPU count in some
+	 * select plugins), read part (for part_is_visible) */
+	slurmctld_lock_t node_write_lock = {
+		READ_LOCK, NO_LOCK, WRITE_LOCK, READ_LOCK, NO_LOCK };
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
+
+	START_TIMER;
+	debug3("Processing RPC: REQUEST_NODE_INFO_SUMMARY from uid=%d", uid);
+
+	if ((slurmctld_conf.private_data & PRIVATE_DATA_NODES) &&
+	    (!validate_operator(uid))) {
+		error("Security violation, REQUEST_NODE_INFO_SUMMARY RPC from uid=%d",
+		      uid);
+		slurm_send_rc_msg(msg, ESLURM_ACCESS_DENIED);
+		return;
+	}
+
+	lock_slurmctld(node_write_lock);
+
+	select_g_select_nodeinfo_set_all();
+
+	if (((node_req_msg->last_update - 1) >= last_node_update) &&
+	    ((node_req_msg->last_update - 1) >= last_part_update)) {
+		unlock_slurmctld(node_write_lock);
+		debug3("_slurm_rpc_dump_node_summary, no change");
+		slurm_send_rc_msg(msg, SLURM_NO_CHANGE_IN_DATA);
+	} else {
+		summary_msg = build_node_summary(uid,
+						 node_req_msg->show_flags);
+		unlock_slurmctld(node_write_lock);
+		END_TIMER2("_slurm_rpc_dump_node_summary");
+
+		response_init(&response_msg, msg);
+		response_msg.msg_type = RESPONSE_NODE_INFO_SUMMARY;
+		response_msg.data = summary_msg;
+
+		/* send message */
+		slurm_send_node_msg(msg->conn_fd, &response_msg);
+		slurm_free_node_summary_info_msg(summary_msg);
+	}
+}
+
 /* _slurm_rpc_dump_partitions - process RPC for partition state information */
 static void _slurm_rpc_dump_partitions(slurm_msg_t * msg)
 {
@@ -2259,6 +2479,55 @@ static void _slurm_rpc_dump_partitions(slurm_msg_t * msg)
 	}
 }
 
+/* Epilog completion queued for batched processing */
+typedef struct epilog_queue_rec {
+	uint32_t job_id;
+	char *node_name;
+	uint32_t return_code;
+} epilog_queue_rec_t;
+
+/*
+ * Pending epilog completions. When a large job ends every node sends
+ * MESSAGE_EPILOG_COMPLETE at nearly the same time; the completions are
+ * coalesced here so one job write lock acquisition covers a whole batch
+ * rather than taking the locks once per message.
+ */
+static pthread_mutex_t epilog_queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static List epilog_queue = NULL;
+static bool epilog_queue_draining = false;
+
+/* Window for additional completions to arrive before a batch is applied */
+#define EPILOG_BATCH_WINDOW_USEC 10000
+
+static void _epilog_queue_rec_free(void *x)
+{
+	epilog_queue_rec_t *rec = (epilog_queue_rec_t *) x;
+
+	xfree(rec->node_name);
+	xfree(rec);
+}
+
+/* Apply one queued epilog completion, caller holds the job write lock */
+static void _epilog_complete_apply(epilog_queue_rec_t *rec,
+				   bool *run_scheduler)
+{
+	struct job_record *job_ptr;
+
+	if (job_epilog_complete(rec->job_id, rec->node_name,
+				rec->return_code))
+		*run_scheduler = true;
+
+	job_ptr = find_job_record(rec->job_id);
+
+	if (rec->return_code)
+		error("%s: epilog error %pJ Node=%s Err=%s",
+		      __func__, job_ptr, rec->node_name,
+		      slurm_strerror(rec->return_code));
+	else
+		debug2("%s: %pJ Node=%s",
+		       __func__, job_ptr, rec->node_name);
+}
+
 /* _slurm_rpc_epilog_complete - process RPC noting the completion of
  * the epilog denoting the completion of a job it its entirety */
 static void  _slurm_rpc_epilog_complete(slurm_msg_t *msg,
@@ -2275,7 +2544,8 @@ static void  _slurm_rpc_epilog_complete(slurm_msg_t *msg,
 	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
 	epilog_complete_msg_t *epilog_msg =
 		(epilog_complete_msg_t *) msg->data;
-	struct job_record  *job_ptr;
+	epilog_queue_rec_t *rec;
+	List batch;
 
 	START_TIMER;
 	debug2("Processing RPC: MESSAGE_EPILOG_COMPLETE uid=%d", uid);
@@ -2285,42 +2555,81 @@ static void  _slurm_rpc_epilog_complete(slurm_msg_t *msg,
 		return;
 	}
 
-	/* Only throttle on none composite messages, the lock should
-	 * already be set earlier. */
-	if (!running_composite) {
-		if (config_update != slurmctld_conf.last_update) {
-			char *sched_params = slurm_get_sched_params();
-			defer_sched = (xstrcasestr(sched_params, "defer"));
-			xfree(sched_params);
-			config_update = slurmctld_conf.last_update;
-		}
-
-		_throttle_start(&active_rpc_cnt);
-		lock_slurmctld(job_write_lock);
-	}
-
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_ROUTE)
 		info("_slurm_rpc_epilog_complete: "
 		     "node_name = %s, JobId=%u", epilog_msg->node_name,
 		     epilog_msg->job_id);
 
-	if (job_epilog_complete(epilog_msg->job_id, epilog_msg->node_name,
-				epilog_msg->return_code))
-		*run_scheduler = true;
+	if (running_composite) {
+		/* The caller already holds the job write lock */
+		if (job_epilog_complete(epilog_msg->job_id,
+					epilog_msg->node_name,
+					epilog_msg->return_code))
+			*run_scheduler = true;
+
+		if (epilog_msg->return_code)
+			error("%s: epilog error %pJ Node=%s Err=%s %s",
+			      __func__, find_job_record(epilog_msg->job_id),
+			      epilog_msg->node_name,
+			      slurm_strerror(epilog_msg->return_code),
+			      TIME_STR);
+		else
+			debug2("%s: %pJ Node=%s %s",
+			       __func__, find_job_record(epilog_msg->job_id),
+			       epilog_msg->node_name, TIME_STR);
+		END_TIMER2("_slurm_rpc_epilog_complete");
+		return;
+	}
 
-	job_ptr = find_job_record(epilog_msg->job_id);
+	if (config_update != slurmctld_conf.last_update) {
+		char *sched_params = slurm_get_sched_params();
+		defer_sched = (xstrcasestr(sched_params, "defer"));
+		xfree(sched_params);
+		config_update = slurmctld_conf.last_update;
+	}
 
-	if (epilog_msg->return_code)
-		error("%s: epilog error %pJ Node=%s Err=%s %s",
-		      __func__, job_ptr, epilog_msg->node_name,
-		      slurm_strerror(epilog_msg->return_code), TIME_STR);
-	else
-		debug2("%s: %pJ Node=%s %s",
-		       __func__, job_ptr, epilog_msg->node_name, TIME_STR);
+	rec = xmalloc(sizeof(epilog_queue_rec_t));
+	rec->job_id = epilog_msg->job_id;
+	rec->node_name = xstrdup(epilog_msg->node_name);
+	rec->return_code = epilog_msg->return_code;
 
-	if (!running_composite) {
+	slurm_mutex_lock(&epilog_queue_mutex);
+	if (!epilog_queue)
+		epilog_queue = list_create(_epilog_queue_rec_free);
+	list_append(epilog_queue, rec);
+	if (epilog_queue_draining) {
+		/* The draining thread will apply this completion */
+		slurm_mutex_unlock(&epilog_queue_mutex);
+		return;
+	}
+	epilog_queue_draining = true;
+	slurm_mutex_unlock(&epilog_queue_mutex);
+
+	/* Let completions from other nodes of the same jobs arrive so one
+	 * lock acquisition covers them all. No response is expected by the
+	 * sender, so briefly holding this service thread is harmless. */
+	usleep(EPILOG_BATCH_WINDOW_USEC);
+
+	while (1) {
+		slurm_mutex_lock(&epilog_queue_mutex);
+		batch = epilog_queue;
+		epilog_queue = NULL;
+		if (!batch) {
+			epilog_queue_draining = false;
+			slurm_mutex_unlock(&epilog_queue_mutex);
+			break;
+		}
+		slurm_mutex_unlock(&epilog_queue_mutex);
+
+		_throttle_start(&active_rpc_cnt);
+		lock_slurmctld(job_write_lock);
+		while ((rec = list_pop(batch))) {
+			_epilog_complete_apply(rec, run_scheduler);
+			_epilog_queue_rec_free(rec);
+		}
 		unlock_slurmctld(job_write_lock);
 		_throttle_fini(&active_rpc_cnt);
+		FREE_NULL_LIST(batch);
 	}
 
 	END_TIMER2("_slurm_rpc_epilog_complete");
@@ -3635,7 +3944,7 @@ static void _slurm_rpc_shutdown_controller(slurm_msg_t * msg)
 {
 	int error_code = SLURM_SUCCESS;
 	uint16_t options = 0;
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 	shutdown_msg_t *shutdown_msg = (shutdown_msg_t *) msg->data;
 	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
 	/* Locks: Read node */
@@ -4354,6 +4663,179 @@ send_msg:
 	xfree(job_submit_user_msg);
 }
 
+static void _free_submit_response(void *x)
+{
+	slurm_free_submit_response_response_msg(x);
+}
+
+/*
+ * _slurm_rpc_submit_batch_jobs - process RPC to submit a set of independent
+ * batch jobs, validated in one pass and inserted under a single lock
+ * acquisition, with per-job results returned in request order
+ */
+static void _slurm_rpc_submit_batch_jobs(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	ListIterator desc_iter, resp_iter;
+	int error_code = SLURM_SUCCESS, accept_cnt = 0;
+	DEF_TIMERS;
+	struct job_record *job_ptr = NULL;
+	slurm_msg_t response_msg;
+	submit_response_msg_t *resp;
+	job_desc_msg_t *job_desc_msg;
+	/* Locks: Read config, read job, read node, read partition */
+	slurmctld_lock_t job_read_lock = {
+		READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK };
+	/* Locks: Read config, write job, write node, read partition, read
+	 * federation */
+	slurmctld_lock_t job_write_lock = {
+		READ_LOCK, WRITE_LOCK, WRITE_LOCK, READ_LOCK, READ_LOCK };
+	List job_req_list = (List) msg->data;
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
+	gid_t gid = g_slurm_auth_get_gid(msg->auth_cred);
+	char *hostname = g_slurm_auth_get_host(msg->auth_cred);
+	char *err_msg = NULL;
+	List resp_list = NULL;
+
+	START_TIMER;
+	debug2("Processing RPC: REQUEST_SUBMIT_BATCH_JOBS from uid=%d", uid);
+	if (!job_req_list || (list_count(job_req_list) == 0)) {
+		info("REQUEST_SUBMIT_BATCH_JOBS from uid=%d with empty job list",
+		     uid);
+		error_code = SLURM_ERROR;
+		goto send_rc;
+	}
+	if (slurmctld_config.submissions_disabled) {
+		info("Submissions disabled on system");
+		error_code = ESLURM_SUBMISSIONS_DISABLED;
+		goto send_rc;
+	}
+
+	/*
+	 * Federated submissions are routed through the origin cluster's
+	 * sibling logic one job at a time, so there is nothing to batch
+	 * here; the client falls back to individual submissions.
+	 */
+	if (fed_mgr_fed_rec) {
+		error_code = ESLURM_NOT_SUPPORTED;
+		goto send_rc;
+	}
+
+	/*
+	 * Validate every request in one pass. A bad descriptor only fails
+	 * its own entry, the remainder of the batch is still submitted.
+	 */
+	resp_list = list_create(_free_submit_response);
+	lock_slurmctld(job_read_lock);     /* Locks for job_submit plugin use */
+	desc_iter = list_iterator_create(job_req_list);
+	while ((job_desc_msg = (job_desc_msg_t *) list_next(desc_iter))) {
+		resp = xmalloc(sizeof(submit_response_msg_t));
+		resp->step_id = SLURM_BATCH_SCRIPT;
+		list_append(resp_list, resp);
+
+		if ((resp->error_code = _valid_id("REQUEST_SUBMIT_BATCH_JOBS",
+						  job_desc_msg, uid, gid)))
+			continue;
+
+		/* use the credential to validate where we came from */
+		if (hostname) {
+			xfree(job_desc_msg->alloc_node);
+			job_desc_msg->alloc_node = xstrdup(hostname);
+		}
+
+		if ((job_desc_msg->alloc_node == NULL) ||
+		    (job_desc_msg->alloc_node[0] == '\0')) {
+			error("REQUEST_SUBMIT_BATCH_JOBS lacks alloc_node from uid=%d",
+			      uid);
+			resp->error_code = ESLURM_INVALID_NODE_NAME;
+			continue;
+		}
+
+		dump_job_desc(job_desc_msg);
+
+		job_desc_msg->pack_job_offset = NO_VAL;
+		resp->error_code = validate_job_create_req(job_desc_msg, uid,
+							   &err_msg);
+		if (err_msg) {
+			resp->job_submit_user_msg = err_msg;
+			err_msg = NULL;
+		}
+	}
+	list_iterator_destroy(desc_iter);
+	unlock_slurmctld(job_read_lock);
+	xfree(hostname);
+
+	/* Create all job allocations under a single lock acquisition */
+	_throttle_start(&active_rpc_cnt);
+	lock_slurmctld(job_write_lock);
+	START_TIMER;	/* Restart after we have locks */
+	desc_iter = list_iterator_create(job_req_list);
+	resp_iter = list_iterator_create(resp_list);
+	while ((job_desc_msg = (job_desc_msg_t *) list_next(desc_iter)) &&
+	       (resp = (submit_response_msg_t *) list_next(resp_iter))) {
+		if (resp->error_code)
+			continue;
+		job_ptr = NULL;
+		job_desc_msg->pack_job_offset = NO_VAL;
+		error_code = job_allocate(job_desc_msg,
+					  job_desc_msg->immediate,
+					  false, NULL, 0, uid, &job_ptr,
+					  &err_msg,
+					  msg->protocol_version);
+		if (!job_ptr ||
+		    (error_code && (job_ptr->job_state == JOB_FAILED))) {
+			resp->error_code = error_code ? error_code :
+					   SLURM_ERROR;
+		} else {
+			resp->job_id     = job_ptr->job_id;
+			resp->error_code = error_code;
+			accept_cnt++;
+		}
+
+		if (job_desc_msg->immediate && (error_code != SLURM_SUCCESS))
+			resp->error_code = ESLURM_CAN_NOT_START_IMMEDIATELY;
+
+		if (err_msg) {
+			/* Keep any job submit plugin message as well */
+			if (resp->job_submit_user_msg) {
+				xstrfmtcat(resp->job_submit_user_msg, "\n%s",
+					   err_msg);
+				xfree(err_msg);
+			} else {
+				resp->job_submit_user_msg = err_msg;
+				err_msg = NULL;
+			}
+		}
+	}
+	list_iterator_destroy(resp_iter);
+	list_iterator_destroy(desc_iter);
+	unlock_slurmctld(job_write_lock);
+	_throttle_fini(&active_rpc_cnt);
+
+	END_TIMER2("_slurm_rpc_submit_batch_jobs");
+	info("%s: %d of %d jobs accepted %s",
+	     __func__, accept_cnt, list_count(job_req_list), TIME_STR);
+
+	response_init(&response_msg, msg);
+	response_msg.msg_type = RESPONSE_SUBMIT_BATCH_JOBS;
+	response_msg.data = resp_list;
+	slurm_send_node_msg(msg->conn_fd, &response_msg);
+	FREE_NULL_LIST(resp_list);
+
+	if (accept_cnt) {
+		schedule_job_save();	/* Has own locks */
+		schedule_node_save();	/* Has own locks */
+		queue_job_scheduler();
+	}
+	return;
+
+send_rc:
+	END_TIMER2("_slurm_rpc_submit_batch_jobs");
+	info("%s: %s", __func__, slurm_strerror(error_code));
+	slurm_send_rc_msg(msg, error_code);
+	xfree(hostname);
+}
+
 /* _slurm_rpc_update_job - process RPC to update the configuration of a
  * job (e.g. priority)
  */
@@ -5696,7 +6178,7 @@ inline static void  _slurm_rpc_set_debug_flags(slurm_msg_t *msg)
 		{ WRITE_LOCK, READ_LOCK, READ_LOCK, READ_LOCK, READ_LOCK };
 	set_debug_flags_msg_t *request_msg =
 		(set_debug_flags_msg_t *) msg->data;
-	uint64_t debug_flags;
+	uint64_t debug_flags, prior_flags;
 	char *flag_string;
 
 	debug2("Processing RPC: REQUEST_SET_DEBUG_FLAGS from uid=%d", uid);
@@ -5708,11 +6190,12 @@ inline static void  _slurm_rpc_set_debug_flags(slurm_msg_t *msg)
 	}
 
 	lock_slurmctld (config_write_lock);
+	prior_flags  = slurmctld_conf.debug_flags;
 	debug_flags  = slurmctld_conf.debug_flags;
 	debug_flags &= (~request_msg->debug_flags_minus);
 	debug_flags |= request_msg->debug_flags_plus;
 	slurm_set_debug_flags(debug_flags);
-	slurmctld_conf.last_update = time(NULL);
+	slurmctld_conf.last_update = slurm_cached_time();
 
 	/* Reset cached debug_flags values */
 	log_set_debug_flags();
@@ -5728,6 +6211,26 @@ inline static void  _slurm_rpc_set_debug_flags(slurm_msg_t *msg)
 	flag_string = debug_flags2str(debug_flags);
 	info("Set DebugFlags to %s", flag_string ? flag_string : "none");
 	xfree(flag_string);
+
+	if ((prior_flags ^ debug_flags) & DEBUG_FLAG_PHASE_TRACE) {
+		if (debug_flags & DEBUG_FLAG_PHASE_TRACE) {
+			phase_trace_set(true);
+		} else {
+			char *dump_file = NULL;
+			/* Clearing the flag dumps the recorded events */
+			phase_trace_set(false);
+			xstrfmtcat(dump_file, "%s/phase_trace.%ld",
+				   slurmctld_conf.state_save_location,
+				   (long) time(NULL));
+			if (phase_trace_dump(dump_file) == SLURM_SUCCESS)
+				info("Phase trace written to %s", dump_file);
+			xfree(dump_file);
+		}
+	}
+	/* Setting the Memory flag logs allocation statistics */
+	if (((prior_flags ^ debug_flags) & DEBUG_FLAG_MEMORY) &&
+	    (debug_flags & DEBUG_FLAG_MEMORY))
+		xmalloc_stats_log();
 	slurm_send_rc_msg(msg, SLURM_SUCCESS);
 }
 
@@ -5779,7 +6282,7 @@ inline static void  _slurm_rpc_set_debug_level(slurm_msg_t *msg)
 		info("Set debug level to %d", debug_level);
 
 	slurmctld_conf.slurmctld_debug = debug_level;
-	slurmctld_conf.last_update = time(NULL);
+	slurmctld_conf.last_update = slurm_cached_time();
 
 	slurm_send_rc_msg(msg, SLURM_SUCCESS);
 }
@@ -5827,7 +6330,7 @@ inline static void  _slurm_rpc_set_schedlog_level(slurm_msg_t *msg)
 		sched_info("Set scheduler log level to %d", schedlog_level);
 
 	slurmctld_conf.sched_log_level = schedlog_level;
-	slurmctld_conf.last_update = time(NULL);
+	slurmctld_conf.last_update = slurm_cached_time();
 
 	slurm_send_rc_msg(msg, SLURM_SUCCESS);
 }
@@ -5923,7 +6426,7 @@ inline static void _slurm_rpc_reboot_nodes(slurm_msg_t * msg)
 	/* Locks: write node lock */
 	slurmctld_lock_t node_write_lock = {
 		NO_LOCK, NO_LOCK, WRITE_LOCK, NO_LOCK, NO_LOCK };
-	time_t now = time(NULL);
+	time_t now = slurm_cached_time();
 #endif
 	DEF_TIMERS;
 
@@ -6006,7 +6509,7 @@ inline static void _slurm_rpc_reboot_nodes(slurm_msg_t * msg)
 inline static void  _slurm_rpc_accounting_first_reg(slurm_msg_t *msg)
 {
 	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
-	time_t event_time = time(NULL);
+	time_t event_time = slurm_cached_time();
 
 	DEF_TIMERS;
 
@@ -6103,53 +6606,98 @@ inline static void _slurm_rpc_dump_spank(slurm_msg_t * msg)
 
 static void _clear_rpc_stats(void)
 {
+	rpc_stats_shard_t *shard;
 	int i;
 
+	pthread_once(&rpc_stats_once, _rpc_stats_init);
 	slurm_mutex_lock(&rpc_mutex);
-	for (i = 0; i < rpc_type_size; i++) {
-		rpc_type_cnt[i] = 0;
-		rpc_type_id[i] = 0;
-		rpc_type_time[i] = 0;
-	}
-	for (i = 0; i < rpc_user_size; i++) {
-		rpc_user_cnt[i] = 0;
-		rpc_user_id[i] = 0;
-		rpc_user_time[i] = 0;
-	}
+	for (i = 0; i < RPC_STATS_SHARDS; i++) {
+		shard = &rpc_stats_shards[i];
+		slurm_mutex_lock(&shard->lock);
+		memset(shard->type_cnt, 0, sizeof(shard->type_cnt));
+		memset(shard->type_time, 0, sizeof(shard->type_time));
+		memset(shard->type_hist, 0, sizeof(shard->type_hist));
+		memset(shard->user_cnt, 0, sizeof(shard->user_cnt));
+		memset(shard->user_time, 0, sizeof(shard->user_time));
+		slurm_mutex_unlock(&shard->lock);
+	}
+	memset(rpc_type_id, 0, sizeof(rpc_type_id));
+	memset(rpc_user_id, 0, sizeof(rpc_user_id));
 	slurm_mutex_unlock(&rpc_mutex);
 }
 
 static void _pack_rpc_stats(int resp, char **buffer_ptr, int *buffer_size,
 			    uint16_t protocol_version)
 {
-	uint32_t i;
+	uint32_t i, j, type_cnt_n, user_cnt_n;
+	uint32_t *type_cnt, *type_hist, *user_cnt;
+	uint64_t *type_time, *user_time;
+	rpc_stats_shard_t *shard;
 	Buf buffer;
 
+	pthread_once(&rpc_stats_once, _rpc_stats_init);
 	slurm_mutex_lock(&rpc_mutex);
 	buffer = create_buf(*buffer_ptr, *buffer_size);
 	set_buf_offset(buffer, *buffer_size);
 
 	if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
-		for (i = 0; i < rpc_type_size; i++) {
+		for (i = 0; i < RPC_TYPE_SIZE; i++) {
 			if (rpc_type_id[i] == 0)
 				break;
 		}
-		pack32(i, buffer);
-		pack16_array(rpc_type_id,   i, buffer);
-		pack32_array(rpc_type_cnt,  i, buffer);
-		pack64_array(rpc_type_time, i, buffer);
-
-		for (i = 1; i < rpc_user_size; i++) {
+		type_cnt_n = i;
+		for (i = 1; i < RPC_USER_SIZE; i++) {
 			if (rpc_user_id[i] == 0)
 				break;
 		}
-		pack32(i, buffer);
-		pack32_array(rpc_user_id,   i, buffer);
-		pack32_array(rpc_user_cnt,  i, buffer);
-		pack64_array(rpc_user_time, i, buffer);
+		user_cnt_n = i;
+
+		/* Merge the per-shard counters for a consistent snapshot */
+		type_cnt  = xcalloc(RPC_TYPE_SIZE, sizeof(uint32_t));
+		type_time = xcalloc(RPC_TYPE_SIZE, sizeof(uint64_t));
+		type_hist = xcalloc(RPC_TYPE_SIZE * RPC_TIME_NBUCKETS,
+				    sizeof(uint32_t));
+		user_cnt  = xcalloc(RPC_USER_SIZE, sizeof(uint32_t));
+		user_time = xcalloc(RPC_USER_SIZE, sizeof(uint64_t));
+		for (j = 0; j < RPC_STATS_SHARDS; j++) {
+			shard = &rpc_stats_shards[j];
+			slurm_mutex_lock(&shard->lock);
+			for (i = 0; i < type_cnt_n; i++) {
+				type_cnt[i]  += shard->type_cnt[i];
+				type_time[i] += shard->type_time[i];
+			}
+			for (i = 0; i < (type_cnt_n * RPC_TIME_NBUCKETS); i++)
+				type_hist[i] += shard->type_hist[i];
+			for (i = 0; i < user_cnt_n; i++) {
+				user_cnt[i]  += shard->user_cnt[i];
+				user_time[i] += shard->user_time[i];
+			}
+			slurm_mutex_unlock(&shard->lock);
+		}
+
+		pack32(type_cnt_n, buffer);
+		pack16_array(rpc_type_id, type_cnt_n, buffer);
+		pack32_array(type_cnt,    type_cnt_n, buffer);
+		pack64_array(type_time,   type_cnt_n, buffer);
+		if (protocol_version >= SLURM_20_02_PROTOCOL_VERSION) {
+			pack32(RPC_TIME_NBUCKETS, buffer);
+			pack32_array(type_hist,
+				     type_cnt_n * RPC_TIME_NBUCKETS, buffer);
+			pack32((uint32_t) server_rpc_queue_depth(), buffer);
+		}
+
+		pack32(user_cnt_n, buffer);
+		pack32_array(rpc_user_id, user_cnt_n, buffer);
+		pack32_array(user_cnt,    user_cnt_n, buffer);
+		pack64_array(user_time,   user_cnt_n, buffer);
 
 		agent_pack_pending_rpc_stats(buffer);
 
+		xfree(type_cnt);
+		xfree(type_time);
+		xfree(type_hist);
+		xfree(user_cnt);
+		xfree(user_time);
 	}
 
 	slurm_mutex_unlock(&rpc_mutex);
@@ -6277,20 +6825,10 @@ _slurm_rpc_dump_licenses(slurm_msg_t * msg)
 	xfree(dump);
 }
 
-/* Free memory used to track RPC usage by type and user */
+/* Reset RPC usage tracking by type and user, the storage is static */
 extern void free_rpc_stats(void)
 {
-	slurm_mutex_lock(&rpc_mutex);
-	xfree(rpc_type_cnt);
-	xfree(rpc_type_id);
-	xfree(rpc_type_time);
-	rpc_type_size = 0;
-
-	xfree(rpc_user_cnt);
-	xfree(rpc_user_id);
-	xfree(rpc_user_time);
-	rpc_user_size = 0;
-	slurm_mutex_unlock(&rpc_mutex);
+	_clear_rpc_stats();
 }
 
 /*
@@ -6395,6 +6933,45 @@ _slurm_rpc_kill_job(slurm_msg_t *msg)
 	END_TIMER2("_slurm_rpc_kill_job");
 }
 
+/*
+ * _slurm_rpc_kill_jobs - signal a batch of jobs named by id or matched
+ * by filter with one lock acquisition, replying with one aggregated
+ * per-job error code array
+ */
+inline static void
+_slurm_rpc_kill_jobs(slurm_msg_t *msg)
+{
+	static int active_rpc_cnt = 0;
+	DEF_TIMERS;
+	kill_jobs_msg_t *kill = (kill_jobs_msg_t *) msg->data;
+	/* Locks: Read config, write job, write node, read fed */
+	slurmctld_lock_t job_write_lock = {READ_LOCK, WRITE_LOCK,
+					   WRITE_LOCK, NO_LOCK, READ_LOCK };
+	uid_t uid = g_slurm_auth_get_uid(msg->auth_cred);
+	int cc;
+
+	START_TIMER;
+	info("%s: REQUEST_KILL_JOBS %u ids user %s sig %u uid %d",
+	     __func__, kill->jobs_cnt,
+	     kill->user_name ? kill->user_name : "N/A", kill->signal, uid);
+
+	_throttle_start(&active_rpc_cnt);
+	lock_slurmctld(job_write_lock);
+	cc = job_signal_jobs(kill, uid, msg->conn_fd,
+			     msg->protocol_version);
+	unlock_slurmctld(job_write_lock);
+	_throttle_fini(&active_rpc_cnt);
+
+	if (cc != SLURM_SUCCESS) {
+		info("%s: job_signal_jobs() returned %s",
+		     __func__, slurm_strerror(cc));
+	} else {
+		slurmctld_diag_stats.jobs_canceled++;
+	}
+
+	END_TIMER2("_slurm_rpc_kill_jobs");
+}
+
 /* The batch messages when made for the comp_msg need to be freed
  * differently than the normal free, so do that here.
  */
@@ -6726,6 +7303,8 @@ static void _slurm_rpc_persist_init(slurm_msg_t *msg, connection_arg_t *arg)
 
 	if (persist_init->persist_type == PERSIST_TYPE_FED)
 		rc = fed_mgr_add_sibling_conn(persist_conn, &comment);
+	else if (persist_init->persist_type == PERSIST_TYPE_RPC)
+		rc = slurmctld_rpc_conn_add(persist_conn, &comment);
 	else
 		rc = SLURM_ERROR;
 end_it:
@@ -6960,7 +7539,7 @@ inline static void  _slurm_rpc_set_fs_dampening_factor(slurm_msg_t *msg)
 
 	lock_slurmctld(config_write_lock);
 	slurm_set_fs_dampening_factor(factor);
-	slurmctld_conf.last_update = time(NULL);
+	slurmctld_conf.last_update = slurm_cached_time();
 	priority_g_reconfig(false);
 	unlock_slurmctld(config_write_lock);
 
@@ -64,6 +64,7 @@
 #include "src/common/read_config.h"
 #include "src/common/slurm_jobcomp.h"
 #include "src/common/slurm_mcs.h"
+#include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_topology.h"
 #include "src/common/slurm_rlimits_info.h"
 #include "src/common/slurm_route.h"
@@ -97,6 +98,9 @@
 /* Global variables */
 List active_feature_list;	/* list of currently active features_records */
 List avail_feature_list;	/* list of available features_records */
+uint32_t feature_list_gen = 1;	/* incremented whenever the feature lists
+				 * above change, used to validate cached job
+				 * feature node bitmaps */
 bool node_features_updated = false;
 bool slurmctld_init_db = true;
 
@@ -113,6 +117,7 @@ static int  _compare_hostnames(struct node_record *old_node_table,
 static void _gres_reconfig(bool reconfig);
 static int  _init_all_slurm_conf(void);
 static void _list_delete_feature(void *feature_entry);
+static void *_preread_state_file(void *arg);
 static int  _preserve_select_type_param(slurm_ctl_conf_t * ctl_conf_ptr,
 					uint16_t old_select_type_p);
 static int  _preserve_plugins(slurm_ctl_conf_t * ctl_conf_ptr,
@@ -139,6 +144,7 @@ static int  _sync_nodes_to_jobs(bool reconfig);
 static int  _sync_nodes_to_active_job(struct job_record *job_ptr);
 static void _sync_nodes_to_suspended_job(struct job_record *job_ptr);
 static void _sync_part_prio(void);
+static void _update_rpc_capture(void);
 static int  _update_preempt(uint16_t old_enable_preempt);
 
 
@@ -209,6 +215,46 @@ static void _stat_slurm_dirs(void)
 	}
 }
 
+/* Read one state save file to prime the page cache, then discard it */
+static void *_preread_state_file(void *arg)
+{
+	char *path = (char *) arg;
+	char *buf = xmalloc(BUF_SIZE);
+	int fd;
+
+	if ((fd = open(path, O_RDONLY)) >= 0) {
+		while (read(fd, buf, BUF_SIZE) > 0)
+			;
+		close(fd);
+	}
+	xfree(buf);
+	xfree(path);
+	return NULL;
+}
+
+/*
+ * Warm the page cache for all state save files in parallel with the
+ * state restore. The files must still be loaded in dependency order
+ * (nodes and partitions before jobs, reservations after jobs) and their
+ * unpack routines assert the caller's slurmctld locks, so the restore
+ * itself stays sequential; prefetching overlaps the file I/O, which
+ * dominates failover time with large state files on shared filesystems.
+ */
+extern void preread_state_files(void)
+{
+	static const char *state_files[] = {
+		"node_state", "front_end_state", "part_state", "job_state",
+		"resv_state", "trigger_state", NULL
+	};
+
+	for (int i = 0; state_files[i]; i++) {
+		char *path = xstrdup_printf("%s/%s",
+					    slurmctld_conf.state_save_location,
+					    state_files[i]);
+		slurm_thread_create_detached(NULL, _preread_state_file, path);
+	}
+}
+
 /*
  * _reorder_nodes_by_name - order node table in ascending order of name
  */
@@ -354,11 +400,13 @@ static int _set_share_node_bitmap(void *x, void *arg)
  * _set_slurmd_addr - establish the slurm_addr_t for the slurmd on each node
  *	Uses common data structures.
  */
-static void _set_slurmd_addr(void)
+static void _set_slurmd_addr(struct node_record *old_node_table_ptr,
+			     int old_node_record_count)
 {
 #ifndef HAVE_FRONT_END
 	int i;
 	struct node_record *node_ptr = node_record_table_ptr;
+	struct node_record *old_node_ptr;
 	DEF_TIMERS;
 
 	xassert(verify_lock(CONF_LOCK, READ_LOCK));
@@ -383,6 +431,25 @@ static void _set_slurmd_addr(void)
 		}
 		if (node_ptr->port == 0)
 			node_ptr->port = slurmctld_conf.slurmd_port;
+		/*
+		 * On reconfigure, reuse the address already resolved for
+		 * this node rather than repeating a DNS lookup for every
+		 * node with all of the slurmctld locks held. The node
+		 * tables are index-aligned unless the node ordering
+		 * changed, in which case we fall through and resolve.
+		 */
+		if (old_node_table_ptr && (i < old_node_record_count)) {
+			old_node_ptr = old_node_table_ptr + i;
+			if (!xstrcmp(old_node_ptr->name, node_ptr->name) &&
+			    !xstrcmp(old_node_ptr->comm_name,
+				     node_ptr->comm_name) &&
+			    (old_node_ptr->slurm_addr.sin_port ==
+			     htons(node_ptr->port))) {
+				node_ptr->slurm_addr =
+					old_node_ptr->slurm_addr;
+				continue;
+			}
+		}
 		slurm_set_addr(&node_ptr->slurm_addr, node_ptr->port,
 			       node_ptr->comm_name);
 		if (node_ptr->slurm_addr.sin_port)
@@ -400,6 +467,34 @@ static void _set_slurmd_addr(void)
 #endif
 }
 
+/*
+ * _topo_conf_changed - test if topology.conf was modified since the last
+ *	call and remember its current state. Used to avoid rebuilding the
+ *	topology plugin's tables on reconfigure when its input is untouched.
+ * RET true if the file changed (or on the first call), false otherwise
+ */
+static bool _topo_conf_changed(void)
+{
+	static time_t topo_conf_mtime = (time_t) -1;
+	static off_t topo_conf_size = -1;
+	struct stat stat_buf;
+	char *topo_conf;
+	bool changed;
+
+	topo_conf = get_extra_conf_path("topology.conf");
+	if (stat(topo_conf, &stat_buf) < 0) {
+		stat_buf.st_mtime = 0;
+		stat_buf.st_size = 0;
+	}
+	changed = (stat_buf.st_mtime != topo_conf_mtime) ||
+		  (stat_buf.st_size  != topo_conf_size);
+	topo_conf_mtime = stat_buf.st_mtime;
+	topo_conf_size  = stat_buf.st_size;
+	xfree(topo_conf);
+
+	return changed;
+}
+
 /*
  * _build_bitmaps - build node bitmaps to define which nodes are in which
  *    1) partition  2) configuration record  3) up state  4) idle state
@@ -939,6 +1034,29 @@ static int _reset_part_prio(void *x, void *arg)
 }
 
 /* _sync_part_prio - Set normalized partition priorities */
+/*
+ * Start or stop raw RPC capture per
+ * SlurmctldParameters=rpc_capture_file=<path>. Runs at startup and on
+ * each reconfigure so capture can be toggled on a live controller.
+ */
+static void _update_rpc_capture(void)
+{
+	char *tmp_ptr, *path, *sep;
+
+	if ((tmp_ptr = xstrcasestr(slurmctld_conf.slurmctld_params,
+				   "rpc_capture_file="))) {
+		path = xstrdup(tmp_ptr + 17);
+		if ((sep = strchr(path, ',')))
+			sep[0] = '\0';
+		if (path[0] == '\0')
+			error("Empty SlurmctldParameters rpc_capture_file ignored");
+		else
+			(void) slurm_rpc_capture_start(path);
+		xfree(path);
+	} else
+		slurm_rpc_capture_stop();
+}
+
 static void _sync_part_prio(void)
 {
 	/* reset global value from part list */
@@ -1117,6 +1235,8 @@ int read_slurm_conf(int recover, bool reconfig)
 	int old_node_record_count = 0;
 	struct node_record *old_node_table_ptr = NULL, *node_ptr;
 	bool do_reorder_nodes = false;
+	bool config_unchanged = false, topo_changed;
+	uint32_t old_hash_val = slurmctld_conf.hash_val;
 	List old_part_list = NULL;
 	char *old_def_part_name = NULL;
 	char *old_auth_type       = xstrdup(slurmctld_conf.authtype);
@@ -1176,6 +1296,17 @@ int read_slurm_conf(int recover, bool reconfig)
 		return error_code;
 	}
 
+	/*
+	 * The parser hashes slurm.conf and its include files as it reads
+	 * them. If a reconfigure produced the identical hash, the rebuilt
+	 * tables below are guaranteed to match the old ones and some of
+	 * the more expensive re-initialization can be skipped.
+	 */
+	if (reconfig && old_hash_val && slurmctld_conf.hash_val &&
+	    (old_hash_val == slurmctld_conf.hash_val))
+		config_unchanged = true;
+	topo_changed = _topo_conf_changed();
+
 	if (reconfig)
 		xcgroup_reconfig_slurm_cgroup_conf();
 
@@ -1235,6 +1366,7 @@ int read_slurm_conf(int recover, bool reconfig)
 			dump_config_state_lite();
 	}
 	update_logging();
+	_update_rpc_capture();
 	g_slurm_jobcomp_init(slurmctld_conf.job_comp_loc);
 	if (slurm_sched_init() != SLURM_SUCCESS) {
 		if (test_config) {
@@ -1283,14 +1415,18 @@ int read_slurm_conf(int recover, bool reconfig)
 		_reorder_nodes_by_name();
 
 	rehash_node();
-	slurm_topo_build_config();
+	if (reconfig && config_unchanged && !topo_changed)
+		debug("%s: slurm.conf and topology.conf unchanged, keeping current topology tables",
+		      __func__);
+	else
+		slurm_topo_build_config();
 	route_g_reconfigure();
 	if (reconfig)
 		power_g_reconfig();
 	cpu_freq_reconfig();
 
 	rehash_jobs();
-	_set_slurmd_addr();
+	_set_slurmd_addr(old_node_table_ptr, old_node_record_count);
 
 	_stat_slurm_dirs();
 
@@ -1346,6 +1482,7 @@ int read_slurm_conf(int recover, bool reconfig)
 		reset_first_job_id();
 		(void) slurm_sched_g_reconfig();
 	} else if (recover == 1) {	/* Load job & node state files */
+		preread_state_files();
 		(void) load_all_node_state(true);
 		_set_features(node_record_table_ptr, node_record_count,
 			      recover);
@@ -1353,6 +1490,7 @@ int read_slurm_conf(int recover, bool reconfig)
 		load_job_ret = load_all_job_state();
 		sync_job_priorities();
 	} else if (recover > 1) {	/* Load node, part & job state files */
+		preread_state_files();
 		(void) load_all_node_state(false);
 		_set_features(old_node_table_ptr, old_node_record_count,
 			      recover);
@@ -1645,6 +1783,7 @@ extern void build_feature_list_eq(void)
 		list_append(active_feature_list, active_feature_ptr);
 	}
 	list_iterator_destroy(feature_iter);
+	feature_list_gen++;
 }
 
 /*
@@ -1716,6 +1855,7 @@ extern void build_feature_list_ne(void)
 			xfree(tmp_str);
 		}
 	}
+	feature_list_gen++;
 }
 
 /*
@@ -1750,6 +1890,7 @@ extern void update_feature_list(List feature_list, char *new_features,
 		}
 		xfree(tmp_str);
 	}
+	feature_list_gen++;
 	node_features_updated = true;
 }
 
@@ -2060,18 +2201,46 @@ static int _restore_node_state(int recover,
 }
 
 /* Purge old node state information */
+/* Holder for a detached node table handed to the xfree_deferred() reaper */
+typedef struct {
+	struct node_record *node_table;
+	int record_count;
+} old_node_state_t;
+
+static void _free_old_node_state(void *x)
+{
+	old_node_state_t *old_state = x;
+	struct node_record *node_ptr = old_state->node_table;
+	int i;
+
+	for (i = 0; i < old_state->record_count; i++, node_ptr++)
+		purge_node_rec(node_ptr);
+	xfree(old_state->node_table);
+	xfree(old_state);
+}
+
 static void _purge_old_node_state(struct node_record *old_node_table_ptr,
 				int old_node_record_count)
 {
-	int i;
-	struct node_record *node_ptr;
+	old_node_state_t *old_state;
 
-	node_ptr = old_node_table_ptr;
-	if (old_node_table_ptr) {
-		for (i = 0; i< old_node_record_count; i++, node_ptr++)
-			purge_node_rec(node_ptr);
-		xfree(old_node_table_ptr);
-	}
+	if (!old_node_table_ptr)
+		return;
+
+	/*
+	 * Releasing thousands of node records with their gres and config
+	 * state is slow; do it on the reaper thread rather than extending
+	 * the time reconfiguration blocks RPC processing.
+	 */
+	old_state = xmalloc(sizeof(old_node_state_t));
+	old_state->node_table = old_node_table_ptr;
+	old_state->record_count = old_node_record_count;
+	xfree_deferred(old_state, _free_old_node_state);
+}
+
+static void _free_old_part_list(void *x)
+{
+	list_destroy((List) x);
 }
 
 /* Restore partition information from saved records */
@@ -2433,7 +2602,7 @@ static void _purge_old_part_state(List old_part_list, char *old_def_part_name)
 
 	if (!old_part_list)
 		return;
-	FREE_NULL_LIST(old_part_list);
+	xfree_deferred(old_part_list, _free_old_part_list);
 }
 
 /*
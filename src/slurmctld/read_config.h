@@ -69,6 +69,14 @@ extern void cluster_rec_free(void);
  */
 extern int read_slurm_conf(int recover, bool reconfig);
 
+/*
+ * Read all state save files to prime the page cache without loading them.
+ * Used to overlap file I/O with the state restore and by the backup
+ * controller to keep its cache warm while idle so that takeover reads
+ * are served locally.
+ */
+extern void preread_state_files(void);
+
 extern int dump_config_state_lite(void);
 extern int load_config_state_lite(void);
 
@@ -4815,6 +4815,125 @@ extern uint32_t job_test_watts_resv(struct job_record *job_ptr, time_t when,
 	return resv_cnt;
 }
 
+/*
+ * Time ordered index over resv_list used by job_test_resv(). The
+ * scheduler and backfill test every job against every reservation, and
+ * with hundreds of recurring maintenance reservations most of that scan
+ * is reservations entirely outside the job's run window. The index is
+ * sorted by start time so the scan can stop at the first reservation
+ * starting after the job would end, and reservations ending before the
+ * job starts are skipped without touching the reservation record.
+ * Reservation changes bump last_resv_update, which invalidates the
+ * index. The index can not be used (and the full scan runs instead)
+ * while any TIME_FLOAT reservation exists, since its effective times
+ * depend upon the present time, or once a recurring reservation has
+ * expired, since iterating it must advance its times.
+ */
+typedef struct {
+	slurmctld_resv_t *resv_ptr;
+	time_t start;		/* start_time_first */
+	time_t end;		/* end_time */
+} resv_time_inx_t;
+
+#define RESV_RECUR_FLAGS (RESERVE_FLAG_DAILY | RESERVE_FLAG_WEEKDAY | \
+			  RESERVE_FLAG_WEEKEND | RESERVE_FLAG_WEEKLY)
+
+static resv_time_inx_t *resv_time_inx = NULL;
+static int resv_time_inx_cnt = 0;
+static int resv_time_inx_size = 0;
+static bool resv_time_inx_usable = false;
+static time_t resv_time_inx_recur_end = 0; /* earliest recurring resv end */
+static time_t resv_time_inx_gen = 0;
+static time_t resv_time_inx_fill = 0;
+static uint32_t resv_time_inx_boot = 0;	/* maximum reservation boot_time */
+
+static int _sort_resv_time_inx(const void *x, const void *y)
+{
+	const resv_time_inx_t *rec1 = x;
+	const resv_time_inx_t *rec2 = y;
+
+	if (rec1->start > rec2->start)
+		return 1;
+	if (rec1->start < rec2->start)
+		return -1;
+	return 0;
+}
+
+static void _build_resv_time_inx(void)
+{
+	ListIterator iter;
+	slurmctld_resv_t *resv_ptr;
+
+	resv_time_inx_cnt = 0;
+	resv_time_inx_usable = true;
+	resv_time_inx_recur_end = 0;
+	resv_time_inx_boot = 0;
+	iter = list_iterator_create(resv_list);
+	while ((resv_ptr = (slurmctld_resv_t *) list_next(iter))) {
+		if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT) {
+			resv_time_inx_usable = false;
+			break;
+		}
+		if ((resv_ptr->flags & RESV_RECUR_FLAGS) &&
+		    ((resv_time_inx_recur_end == 0) ||
+		     (resv_ptr->end_time < resv_time_inx_recur_end)))
+			resv_time_inx_recur_end = resv_ptr->end_time;
+		resv_time_inx_boot = MAX(resv_time_inx_boot,
+					 resv_ptr->boot_time);
+		if (resv_time_inx_cnt >= resv_time_inx_size) {
+			resv_time_inx_size = MAX(resv_time_inx_size * 2, 64);
+			xrealloc(resv_time_inx, resv_time_inx_size *
+				 sizeof(resv_time_inx_t));
+		}
+		resv_time_inx[resv_time_inx_cnt].resv_ptr = resv_ptr;
+		resv_time_inx[resv_time_inx_cnt].start =
+			resv_ptr->start_time_first;
+		resv_time_inx[resv_time_inx_cnt].end = resv_ptr->end_time;
+		resv_time_inx_cnt++;
+	}
+	list_iterator_destroy(iter);
+
+	if (resv_time_inx_usable) {
+		qsort(resv_time_inx, resv_time_inx_cnt,
+		      sizeof(resv_time_inx_t), _sort_resv_time_inx);
+	}
+	resv_time_inx_gen = last_resv_update;
+	resv_time_inx_fill = time(NULL);
+}
+
+static bool _resv_time_inx_valid(time_t now)
+{
+	return resv_time_inx_usable &&
+	       (resv_time_inx_gen == last_resv_update) &&
+	       (resv_time_inx_fill > resv_time_inx_gen) &&
+	       ((resv_time_inx_recur_end == 0) ||
+		(now < resv_time_inx_recur_end));
+}
+
+/*
+ * Return the next indexed reservation which could overlap the given
+ * time window, NULL when no more could. window_bound must be at least
+ * the job end time plus any applicable boot time so no reservation the
+ * full scan would visit is skipped.
+ */
+static slurmctld_resv_t *_resv_time_inx_next(int *inx, time_t window_start,
+					     time_t window_bound)
+{
+	resv_time_inx_t *rec;
+
+	while (*inx < resv_time_inx_cnt) {
+		rec = resv_time_inx + (*inx)++;
+		if (rec->start >= window_bound) {
+			*inx = resv_time_inx_cnt; /* sorted by start time */
+			return NULL;
+		}
+		if (rec->end <= window_start)
+			continue;
+		return rec->resv_ptr;
+	}
+	return NULL;
+}
+
 /*
  * Determine which nodes a job can use based upon reservations
  * IN job_ptr      - job to test
@@ -4845,10 +4964,10 @@ extern int job_test_resv(struct job_record *job_ptr, time_t *when,
 {
 	slurmctld_resv_t *resv_ptr = NULL, *res2_ptr;
 	time_t job_start_time, job_end_time, job_end_time_use, lic_resv_time;
-	time_t start_relative, end_relative;
+	time_t start_relative, end_relative, inx_bound = 0;
 	time_t now = time(NULL);
 	ListIterator iter;
-	int i, rc = SLURM_SUCCESS, rc2;
+	int i, resv_inx = 0, rc = SLURM_SUCCESS, rc2;
 
 	*resv_overlap = false;	/* initialize to false */
 	job_start_time = *when;
@@ -4977,11 +5096,32 @@ extern int job_test_resv(struct job_record *job_ptr, time_t *when,
 	 * Job has no reservation, try to find time when this can
 	 * run and get it's required nodes (if any)
 	 */
+	if ((resv_time_inx_gen != last_resv_update) ||
+	    (resv_time_inx_fill <= resv_time_inx_gen))
+		_build_resv_time_inx();
+
 	for (i = 0; ; i++) {
 		lic_resv_time = (time_t) 0;
 
-		iter = list_iterator_create(resv_list);
-		while ((resv_ptr = (slurmctld_resv_t *) list_next(iter))) {
+		if (_resv_time_inx_valid(now)) {
+			inx_bound = job_end_time;
+			if (reboot)
+				inx_bound += resv_time_inx_boot;
+			resv_inx = 0;
+			iter = NULL;
+		} else
+			iter = list_iterator_create(resv_list);
+		while (1) {
+			if (iter) {
+				resv_ptr = (slurmctld_resv_t *)
+					   list_next(iter);
+			} else {
+				resv_ptr = _resv_time_inx_next(&resv_inx,
+							       job_start_time,
+							       inx_bound);
+			}
+			if (!resv_ptr)
+				break;
 			if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT) {
 				start_relative = resv_ptr->start_time + now;
 				if (resv_ptr->duration == INFINITE)
@@ -5078,7 +5218,8 @@ extern int job_test_resv(struct job_record *job_ptr, time_t *when,
 				continue;
 			}
 		}
-		list_iterator_destroy(iter);
+		if (iter)
+			list_iterator_destroy(iter);
 
 		if ((rc == SLURM_SUCCESS) && move_time) {
 			if (license_job_test(job_ptr, job_start_time, reboot)
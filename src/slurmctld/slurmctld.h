@@ -105,6 +105,11 @@
 #define TRIGGER_INTERVAL 15
 #endif
 
+/* Refresh cached node address resolution every PERIODIC_NODE_ADDRS seconds */
+#ifndef PERIODIC_NODE_ADDRS
+#define PERIODIC_NODE_ADDRS 3600
+#endif
+
 /* Report current node accounting state every PERIODIC_NODE_ACCT seconds */
 #ifndef PERIODIC_NODE_ACCT
 #define PERIODIC_NODE_ACCT 300
@@ -155,6 +160,28 @@ typedef struct slurmctld_config {
 	pthread_t thread_id_rpc;
 } slurmctld_config_t;
 
+#ifndef BF_CYCLE_RECORDS
+#define BF_CYCLE_RECORDS 20	/* Backfill cycle introspection ring size */
+#endif
+
+/* Per-cycle backfill introspection record. The last BF_CYCLE_RECORDS
+ * cycles are kept in a ring in diag_stats_t and reported by sdiag. */
+typedef struct {
+	time_t   when;		/* cycle start time */
+	uint32_t cycle_usec;	/* active cycle time, sleep excluded */
+	uint32_t try_usec;	/* time testing job resource availability */
+	uint32_t depth;		/* jobs evaluated */
+	uint32_t depth_try;	/* jobs subjected to a full resource test */
+	uint32_t yields;	/* lock yields taken during the cycle */
+	uint32_t table_size;	/* node/time table records at cycle end */
+	uint32_t queue_len;	/* backfill queue length at cycle start */
+} bf_cycle_rec_t;
+
+#ifndef JOB_TIMING_NBUCKETS
+#define JOB_TIMING_NBUCKETS 24	/* Power of two usec lifecycle buckets,
+				 * the last bucket is overflow */
+#endif
+
 /* Job scheduling statistics */
 typedef struct diag_stats {
 	int proc_req_threads;
@@ -194,6 +221,13 @@ typedef struct diag_stats {
 	uint32_t bf_table_size;
 	uint32_t bf_table_size_sum;
 	time_t   bf_when_last_cycle;
+	bf_cycle_rec_t bf_cycle_recs[BF_CYCLE_RECORDS];
+	uint32_t bf_cycle_rec_inx;	/* next bf_cycle_recs slot, wraps */
+
+	/* Job lifecycle interval histograms, see job_timing_t */
+	uint32_t job_timing_submit_eval[JOB_TIMING_NBUCKETS];
+	uint32_t job_timing_alloc_launch[JOB_TIMING_NBUCKETS];
+	uint32_t job_timing_complete_clean[JOB_TIMING_NBUCKETS];
 
 	uint32_t latency;
 } diag_stats_t;
@@ -252,6 +286,9 @@ typedef struct node_features {
 
 extern List active_feature_list;/* list of currently active node features */
 extern List avail_feature_list;	/* list of available node features */
+extern uint32_t feature_list_gen;/* incremented on each change to the lists
+				 * above, used to validate cached job
+				 * feature node bitmaps */
 
 /*****************************************************************************\
  *  NODE states and bitmaps
@@ -386,6 +423,8 @@ struct part_record {
 	uint16_t preempt_mode;	/* See PREEMPT_MODE_* in slurm/slurm.h */
 	uint16_t priority_job_factor;	/* job priority weight factor */
 	uint16_t priority_tier;	/* tier for scheduling and preemption */
+	uint16_t sched_domain;	/* disjoint node domain index used to shard
+				 * scheduling work, NO PACK */
 	char *qos_char;         /* requested QOS from slurm.conf */
 	slurmdb_qos_rec_t *qos_ptr; /* pointer to the quality of
 				     * service record attached to this
@@ -485,6 +524,10 @@ typedef struct job_feature {
 	bitstr_t *node_bitmap_active;	/* nodes with this feature active */
 	bitstr_t *node_bitmap_avail;	/* nodes with this feature available */
 	uint16_t paren;			/* count of enclosing parenthesis */
+	uint32_t bitmap_gen;		/* value of feature_list_gen when the
+					 * node bitmaps above were resolved */
+	bool bitmap_reboot;		/* can_reboot value used when the
+					 * node bitmaps above were resolved */
 } job_feature_t;
 
 /*
@@ -527,6 +570,9 @@ struct job_details {
 					 * each task */
 	uint16_t orig_cpus_per_task;	/* requested value of cpus_per_task */
 	List depend_list;		/* list of job_ptr:state pairs */
+	time_t depend_test_time;	/* time dependencies last found
+					 * unsatisfied, zero to force a
+					 * re-test, not saved in state */
 	char *dependency;		/* wait for other jobs */
 	char *orig_dependency;		/* original value (for archiving) */
 	uint16_t env_cnt;		/* size of env_sup (see below) */
@@ -640,6 +686,24 @@ typedef struct {
 	uint32_t priority;		/* whole hetjob calculated priority */
 } pack_details_t;
 
+/*
+ * Microsecond job lifecycle stamps, zero until the stage is reached.
+ * Each stage stamps only once, so a requeued job keeps the times of
+ * its first pass. Interval histograms aggregated from these live in
+ * slurmctld_diag_stats and are reported by sdiag; the per job
+ * breakdown is logged when the record is purged with
+ * DebugFlags=TraceJobs.
+ */
+typedef struct {
+	uint64_t submit;	/* job record created from the submit RPC */
+	uint64_t first_eval;	/* first scheduler evaluation */
+	uint64_t alloc;		/* resource allocation committed */
+	uint64_t prolog_done;	/* PrologSlurmctld completed */
+	uint64_t launch;	/* batch launch RPC sent */
+	uint64_t complete;	/* completion processed */
+	uint64_t cleanup_done;	/* last epilog complete, nodes released */
+} job_timing_t;
+
 /*
  * NOTE: When adding fields to the job_record, or any underlying structures,
  * be sure to sync with job_array_split.
@@ -746,6 +810,9 @@ struct job_record {
 	char *name;			/* name of the job */
 	char *network;			/* network/switch requirement spec */
 	uint32_t next_step_id;		/* next step id to be used */
+	time_t next_time_check;		/* next deadline test scheduled by
+					 * job_time_limit(), 0 if none,
+					 * don't pack */
 	char *nodes;			/* list of nodes allocated to job */
 	slurm_addr_t *node_addr;	/* addresses of the nodes allocated to
 					 * job */
@@ -791,6 +858,10 @@ struct job_record {
 	uint32_t *priority_array;	/* partition based priority */
 	priority_factors_object_t *prio_factors; /* cached value used
 						  * by sprio command */
+	uint64_t prio_factors_epoch;	/* generation of the global priority
+					 * inputs when prio_factors was last
+					 * computed, maintained by the
+					 * priority/multifactor plugin */
 	uint32_t profile;		/* Acct_gather_profile option */
 	uint32_t qos_id;		/* quality of service id */
 	slurmdb_qos_rec_t *qos_ptr;	/* pointer to the quality of
@@ -820,6 +891,13 @@ struct job_record {
 					 * allocation */
 	time_t start_time;		/* time execution begins,
 					 * actual or expected */
+	char *state_cache;		/* packed state save image of this
+					 * record, reused by successive
+					 * dump_all_job_state() calls for
+					 * finished jobs, cleared by
+					 * job_state_cache_clear() on any
+					 * subsequent record update */
+	uint32_t state_cache_len;	/* size of state_cache in bytes */
 	char *state_desc;		/* optional details for state_reason */
 	uint32_t state_reason;		/* reason job still pending or failed
 					 * see slurm.h:enum job_state_reason */
@@ -839,6 +917,7 @@ struct job_record {
 	uint32_t time_min;		/* minimum time_limit minutes or
 					 * INFINITE,
 					 * zero implies same as time_limit */
+	job_timing_t timing;		/* lifecycle stage stamps, usecs */
 	time_t tot_sus_time;		/* total time in suspend state */
 	uint32_t total_cpus;		/* number of allocated cpus,
 					 * for accounting */
@@ -1162,6 +1241,13 @@ extern int drain_nodes ( char *nodes, char *reason, uint32_t reason_uid );
  * RET 0 or error code */
 extern int dump_all_job_state ( void );
 
+/*
+ * job_state_cache_clear - release the cached state save image of a job
+ *	record. Must be called whenever a finished job's record is modified
+ *	so dump_all_job_state() will re-pack it.
+ */
+extern void job_state_cache_clear(struct job_record *job_ptr);
+
 /* dump_all_node_state - save the state of all nodes to file */
 extern int dump_all_node_state ( void );
 
@@ -1441,6 +1527,18 @@ extern int job_checkpoint(checkpoint_msg_t *ckpt_ptr, uid_t uid,
 /* log the completion of the specified job */
 extern void job_completion_logger(struct job_record  *job_ptr, bool requeue);
 
+/*
+ * Record the current time in a job lifecycle stage stamp unless the
+ * stage was already reached.
+ * RET true if the stamp was taken now
+ */
+extern bool job_timing_stamp(uint64_t *stamp);
+
+/* Add the interval between two lifecycle stamps to a
+ * slurmctld_diag_stats histogram of JOB_TIMING_NBUCKETS power of two
+ * microsecond buckets. Does nothing unless both stages were reached. */
+extern void job_timing_interval(uint64_t from, uint64_t to, uint32_t *hist);
+
 /*
  * Return total amount of memory allocated to a job. This can be based upon
  * a GRES specification with various GRES/memory allocations on each node.
@@ -1547,6 +1645,18 @@ extern int job_signal(struct job_record *job_ptr, uint16_t signal,
  */
 extern int job_signal_id(uint32_t job_id, uint16_t signal, uint16_t flags,
 			 uid_t uid, bool preempt);
+
+/*
+ * job_signal_jobs - signal every job named by or matching a bulk kill
+ *	request and respond with one aggregated per-job error code array
+ * IN kill_msg - explicit job ids and/or filters plus signal to deliver
+ * IN uid - uid of requesting user
+ * IN conn_fd - file descriptor on which to send reply
+ * IN protocol_version - slurm protocol version of client
+ * RET 0 on success, otherwise ESLURM error code
+ */
+extern int job_signal_jobs(kill_jobs_msg_t *kill_msg, uid_t uid, int conn_fd,
+			   uint16_t protocol_version);
 /*
  * pack_job_signal - signal all components of a pack job
  * IN pack_leader - job record of job pack leader
@@ -1740,6 +1850,17 @@ int job_step_signal(uint32_t job_id, uint32_t step_id,
  */
 extern void job_time_limit (void);
 
+/*
+ * job_time_limit_register - file a running job on the deadline timer
+ *	wheel used by job_time_limit() based upon the time of its next
+ *	deadline driven event. Call this whenever a job starts, resumes
+ *	or has its time limit, end time or steps changed; unreported
+ *	changes are picked up by the periodic full scan.
+ * IN job_ptr - pointer to job being registered
+ * IN now - current time
+ */
+extern void job_time_limit_register(struct job_record *job_ptr, time_t now);
+
 /* Builds the tres_req_cnt and tres_req_str of a job.
  * Only set when job is pending.
  * NOTE: job write lock must be locked before calling this */
@@ -2012,10 +2133,47 @@ extern void pack_spec_jobs(char **buffer_ptr, int *buffer_size, List job_ids,
  * NOTE: change slurm_load_node() in api/node_info.c when data format changes
  * NOTE: READ lock_slurmctld config before entry
  */
+/*
+ * build_node_summary - report per-partition counts of allocated, idle and
+ *	other (down/drained/draining) nodes and CPUs
+ * IN show_flags - partition filtering options
+ * IN uid - uid of user making request (for partition filtering)
+ * RET summary message, free with slurm_free_node_summary_info_msg()
+ */
+extern node_summary_info_msg_t *build_node_summary(uid_t uid,
+						   uint16_t show_flags);
+
 extern void pack_all_node (char **buffer_ptr, int *buffer_size,
 			   uint16_t show_flags, uid_t uid,
 			   uint16_t protocol_version);
 
+/*
+ * Structure-of-arrays mirror of the scheduling-relevant node fields.
+ * Scheduler scans touch only a handful of fields per node_record; packing
+ * those fields into parallel arrays keeps the per-cycle scans of large
+ * systems from pulling a full node_record cache line per node. The view
+ * is rebuilt lazily when last_node_update changes.
+ */
+typedef struct {
+	int node_cnt;		/* entries in each array below */
+	uint32_t *state;	/* node_state including flags */
+	uint16_t *cpus;		/* count of processors per node */
+	uint16_t *sockets;	/* sockets per node */
+	uint16_t *cores;	/* cores per socket */
+	uint16_t *threads;	/* threads per core */
+	int *total_cores;	/* boards * sockets * cores */
+	uint64_t *real_memory;	/* MB of real memory per node */
+	uint32_t *tmp_disk;	/* MB of total disk in TMP_FS */
+} node_sched_view_t;
+
+/*
+ * node_sched_view - return the scheduling view of the node table,
+ *	rebuilding it first if any node record changed.
+ * NOTE: Call with node read (or write) lock held; the returned arrays
+ *	remain valid only while that lock is held.
+ */
+extern const node_sched_view_t *node_sched_view(void);
+
 /* Pack all scheduling statistics */
 extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 			  uint16_t protocol_version);
@@ -2306,6 +2464,15 @@ extern void server_thread_decr(void);
 /* Increment slurmctld thread count (as applies to thread limit) */
 extern void server_thread_incr(void);
 
+/* Number of accepted RPC connections waiting for a worker thread */
+extern int server_rpc_queue_depth(void);
+
+/* Register a long-lived slurmd RPC connection (PERSIST_TYPE_RPC) to be
+ * serviced by the RPC worker pool. On error *comment is set to an
+ * explanation for the remote end. */
+extern int slurmctld_rpc_conn_add(slurm_persist_conn_t *persist_conn,
+				  char **comment);
+
 /* Set a job's alias_list string */
 extern void set_job_alias_list(struct job_record *job_ptr);
 
@@ -41,6 +41,8 @@
 
 #include <string.h>
 
+#include "src/common/list.h"
+#include "src/common/macros.h"
 #include "src/common/node_select.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
@@ -51,25 +53,166 @@
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/srun_comm.h"
 
-/* Launch the srun request. Note that retry is always zero since
- * we don't want to clog the system up with messages destined for
- * defunct srun processes
+/* srun notification queued for asynchronous delivery */
+typedef struct srun_queued_msg {
+	agent_arg_t *agent_args;	/* agent request, lacks only addr */
+	uint16_t port;			/* srun port, resolved at delivery */
+	char *resp_host;		/* srun host, resolved at delivery */
+} srun_queued_msg_t;
+
+static List srun_send_list = NULL;
+static pthread_mutex_t srun_send_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  srun_send_cond  = PTHREAD_COND_INITIALIZER;
+static bool srun_send_thread_running = false;
+
+static void *_srun_send_thread(void *no_data);
+
+/* Release a queued srun notification which was never delivered */
+static void _free_srun_queued(void *x)
+{
+	srun_queued_msg_t *queued = (srun_queued_msg_t *) x;
+
+	if (!queued)
+		return;
+	if (queued->agent_args) {
+		agent_arg_t *agent_args = queued->agent_args;
+		if (agent_args->msg_type == RESPONSE_RESOURCE_ALLOCATION) {
+			resource_allocation_response_msg_t *alloc_msg =
+				agent_args->msg_args;
+			/* NULL out working_cluster_rec because it's pointing
+			 * to the actual cluster_rec. */
+			alloc_msg->working_cluster_rec = NULL;
+			slurm_free_resource_allocation_response_msg(alloc_msg);
+		} else if (agent_args->msg_type ==
+			   RESPONSE_JOB_PACK_ALLOCATION) {
+			List alloc_list = agent_args->msg_args;
+			FREE_NULL_LIST(alloc_list);
+		} else {
+			slurm_free_msg_data(agent_args->msg_type,
+					    agent_args->msg_args);
+		}
+		hostlist_destroy(agent_args->hostlist);
+		xfree(agent_args);
+	}
+	xfree(queued->resp_host);
+	xfree(queued);
+}
+
+/* Queue the srun request for delivery by _srun_send_thread(). Note that
+ * retry is always zero since we don't want to clog the system up with
+ * messages destined for defunct srun processes. Address resolution and
+ * hand off to the agent happen outside the slurmctld locks, so the
+ * caller never waits on srun reachability.
  */
-static void _srun_agent_launch(slurm_addr_t *addr, char *host,
+static void _srun_agent_launch(uint16_t port, char *resp_host, char *host,
 			       slurm_msg_type_t type, void *msg_args,
 			       uint16_t protocol_version)
 {
 	agent_arg_t *agent_args = xmalloc(sizeof(agent_arg_t));
+	srun_queued_msg_t *queued;
 
 	agent_args->node_count = 1;
 	agent_args->retry      = 0;
-	agent_args->addr       = addr;
 	agent_args->hostlist   = hostlist_create(host);
 	agent_args->msg_type   = type;
 	agent_args->msg_args   = msg_args;
 	agent_args->protocol_version = protocol_version;
 
-	agent_queue_request(agent_args);
+	queued = xmalloc(sizeof(srun_queued_msg_t));
+	queued->agent_args = agent_args;
+	queued->port       = port;
+	queued->resp_host  = xstrdup(resp_host);
+
+	slurm_mutex_lock(&srun_send_mutex);
+	if (!srun_send_list)
+		srun_send_list = list_create(_free_srun_queued);
+	list_append(srun_send_list, queued);
+	if (!srun_send_thread_running) {
+		slurm_thread_create_detached(NULL, _srun_send_thread, NULL);
+		srun_send_thread_running = true;
+	}
+	slurm_cond_signal(&srun_send_cond);
+	slurm_mutex_unlock(&srun_send_mutex);
+}
+
+/* Fold queued SRUN_NODE_FAIL notifications bound for the same srun and
+ * job/step into the message at hand so each destination gets a single
+ * message per batch of failures */
+static void _merge_node_fail_msgs(srun_queued_msg_t *queued, List work_list)
+{
+	srun_node_fail_msg_t *msg = queued->agent_args->msg_args;
+	srun_node_fail_msg_t *merge_msg;
+	srun_queued_msg_t *merge;
+	ListIterator iter;
+	hostlist_t fail_list = NULL;
+
+	iter = list_iterator_create(work_list);
+	while ((merge = (srun_queued_msg_t *) list_next(iter))) {
+		if ((merge->agent_args->msg_type != SRUN_NODE_FAIL) ||
+		    (merge->port != queued->port) ||
+		    xstrcmp(merge->resp_host, queued->resp_host))
+			continue;
+		merge_msg = merge->agent_args->msg_args;
+		if ((merge_msg->job_id  != msg->job_id) ||
+		    (merge_msg->step_id != msg->step_id))
+			continue;
+		if (!fail_list)
+			fail_list = hostlist_create(msg->nodelist);
+		hostlist_push(fail_list, merge_msg->nodelist);
+		list_delete_item(iter);
+	}
+	list_iterator_destroy(iter);
+
+	if (fail_list) {
+		hostlist_uniq(fail_list);
+		xfree(msg->nodelist);
+		msg->nodelist = hostlist_ranged_string_xmalloc(fail_list);
+		hostlist_destroy(fail_list);
+	}
+}
+
+/* Deliver queued srun notifications. Draining the whole queue per wakeup
+ * batches notifications generated by a single event (e.g. a node failure
+ * hitting many interactive jobs) into one pass */
+static void *_srun_send_thread(void *no_data)
+{
+	srun_queued_msg_t *queued;
+	slurm_addr_t *addr;
+	struct timespec ts = {0, 0};
+	List work_list;
+
+	while (true) {
+		slurm_mutex_lock(&srun_send_mutex);
+		while (!slurmctld_config.shutdown_time &&
+		       (!srun_send_list || list_is_empty(srun_send_list))) {
+			ts.tv_sec = time(NULL) + 2;
+			slurm_cond_timedwait(&srun_send_cond, &srun_send_mutex,
+					     &ts);
+		}
+		if (slurmctld_config.shutdown_time) {
+			FREE_NULL_LIST(srun_send_list);
+			srun_send_thread_running = false;
+			slurm_mutex_unlock(&srun_send_mutex);
+			break;
+		}
+		work_list = srun_send_list;
+		srun_send_list = NULL;
+		slurm_mutex_unlock(&srun_send_mutex);
+
+		while ((queued = (srun_queued_msg_t *) list_pop(work_list))) {
+			if (queued->agent_args->msg_type == SRUN_NODE_FAIL)
+				_merge_node_fail_msgs(queued, work_list);
+			addr = xmalloc(sizeof(slurm_addr_t));
+			slurm_set_addr(addr, queued->port, queued->resp_host);
+			queued->agent_args->addr = addr;
+			agent_queue_request(queued->agent_args);
+			queued->agent_args = NULL;
+			_free_srun_queued(queued);
+		}
+		FREE_NULL_LIST(work_list);
+	}
+
+	return NULL;
 }
 
 static bool _pending_pack_jobs(struct job_record *job_ptr)
@@ -127,7 +270,6 @@ extern void srun_allocate(struct job_record *job_ptr)
 {
 	struct job_record *pack_job, *pack_leader;
 	resource_allocation_response_msg_t *msg_arg = NULL;
-	slurm_addr_t *addr;
 	ListIterator iter;
 	List job_resp_list = NULL;
 
@@ -138,20 +280,14 @@ extern void srun_allocate(struct job_record *job_ptr)
 		return;
 
 	if (job_ptr->pack_job_id == 0) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, job_ptr->alloc_resp_port,
-			job_ptr->resp_host);
-
 		msg_arg = build_alloc_msg(job_ptr, SLURM_SUCCESS, NULL);
-		_srun_agent_launch(addr, job_ptr->alloc_node,
+		_srun_agent_launch(job_ptr->alloc_resp_port,
+				   job_ptr->resp_host, job_ptr->alloc_node,
 				   RESPONSE_RESOURCE_ALLOCATION, msg_arg,
 				   job_ptr->start_protocol_ver);
 	} else if (_pending_pack_jobs(job_ptr)) {
 		return;
 	} else if ((pack_leader = find_job_record(job_ptr->pack_job_id))) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, pack_leader->alloc_resp_port,
-			       pack_leader->resp_host);
 		job_resp_list = list_create(_free_srun_alloc);
 		iter = list_iterator_create(pack_leader->pack_job_list);
 		while ((pack_job = (struct job_record *) list_next(iter))) {
@@ -166,7 +302,8 @@ extern void srun_allocate(struct job_record *job_ptr)
 			msg_arg = NULL;
 		}
 		list_iterator_destroy(iter);
-		_srun_agent_launch(addr, job_ptr->alloc_node,
+		_srun_agent_launch(pack_leader->alloc_resp_port,
+				   pack_leader->resp_host, job_ptr->alloc_node,
 				   RESPONSE_JOB_PACK_ALLOCATION, job_resp_list,
 				   job_ptr->start_protocol_ver);
 	} else {
@@ -183,15 +320,12 @@ extern void srun_allocate_abort(struct job_record *job_ptr)
 {
 	if (job_ptr && job_ptr->alloc_resp_port && job_ptr->alloc_node &&
 	    job_ptr->resp_host) {
-		slurm_addr_t * addr;
 		srun_job_complete_msg_t *msg_arg;
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, job_ptr->alloc_resp_port,
-			       job_ptr->resp_host);
 		msg_arg = xmalloc(sizeof(srun_timeout_msg_t));
 		msg_arg->job_id   = job_ptr->job_id;
 		msg_arg->step_id  = NO_VAL;
-		_srun_agent_launch(addr, job_ptr->alloc_node,
+		_srun_agent_launch(job_ptr->alloc_resp_port,
+				   job_ptr->resp_host, job_ptr->alloc_node,
 				   SRUN_JOB_COMPLETE,
 				   msg_arg,
 				   job_ptr->start_protocol_ver);
@@ -209,7 +343,6 @@ extern void srun_node_fail(struct job_record *job_ptr, char *node_name)
 	struct node_record *node_ptr;
 #endif
 	int bit_position = -1;
-	slurm_addr_t * addr;
 	srun_node_fail_msg_t *msg_arg;
 	ListIterator step_iterator;
 	struct step_record *step_ptr;
@@ -239,25 +372,23 @@ extern void srun_node_fail(struct job_record *job_ptr, char *node_name)
 		     (step_ptr->batch_step)      ||
 		     (step_ptr->host[0] == '\0') )
 			continue;
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, step_ptr->port, step_ptr->host);
 		msg_arg = xmalloc(sizeof(srun_node_fail_msg_t));
 		msg_arg->job_id   = job_ptr->job_id;
 		msg_arg->step_id  = step_ptr->step_id;
 		msg_arg->nodelist = xstrdup(node_name);
-		_srun_agent_launch(addr, step_ptr->host, SRUN_NODE_FAIL,
+		_srun_agent_launch(step_ptr->port, step_ptr->host,
+				   step_ptr->host, SRUN_NODE_FAIL,
 				   msg_arg, step_ptr->start_protocol_ver);
 	}
 	list_iterator_destroy(step_iterator);
 
 	if (job_ptr->other_port && job_ptr->alloc_node && job_ptr->resp_host) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, job_ptr->other_port, job_ptr->resp_host);
 		msg_arg = xmalloc(sizeof(srun_node_fail_msg_t));
 		msg_arg->job_id   = job_ptr->job_id;
 		msg_arg->step_id  = NO_VAL;
 		msg_arg->nodelist = xstrdup(node_name);
-		_srun_agent_launch(addr, job_ptr->alloc_node, SRUN_NODE_FAIL,
+		_srun_agent_launch(job_ptr->other_port, job_ptr->resp_host,
+				   job_ptr->alloc_node, SRUN_NODE_FAIL,
 				   msg_arg, job_ptr->start_protocol_ver);
 	}
 }
@@ -267,7 +398,6 @@ extern void srun_ping (void)
 {
 	ListIterator job_iterator;
 	struct job_record *job_ptr;
-	slurm_addr_t * addr;
 	time_t now = time(NULL);
 	time_t old = now - (slurmctld_conf.inactive_limit / 3) +
 			   slurmctld_conf.msg_timeout + 1;
@@ -285,13 +415,12 @@ extern void srun_ping (void)
 
 		if ((job_ptr->time_last_active <= old) && job_ptr->other_port
 		    &&  job_ptr->alloc_node && job_ptr->resp_host) {
-			addr = xmalloc(sizeof(struct sockaddr_in));
-			slurm_set_addr(addr, job_ptr->other_port,
-				job_ptr->resp_host);
 			msg_arg = xmalloc(sizeof(srun_ping_msg_t));
 			msg_arg->job_id  = job_ptr->job_id;
 			msg_arg->step_id = NO_VAL;
-			_srun_agent_launch(addr, job_ptr->alloc_node,
+			_srun_agent_launch(job_ptr->other_port,
+					   job_ptr->resp_host,
+					   job_ptr->alloc_node,
 					   SRUN_PING, msg_arg,
 					   job_ptr->start_protocol_ver);
 		}
@@ -307,7 +436,6 @@ extern void srun_ping (void)
  */
 extern void srun_step_timeout(struct step_record *step_ptr, time_t timeout_val)
 {
-	slurm_addr_t *addr;
 	srun_timeout_msg_t *msg_arg;
 
 	xassert(step_ptr);
@@ -316,13 +444,12 @@ extern void srun_step_timeout(struct step_record *step_ptr, time_t timeout_val)
 	    || !step_ptr->host || (step_ptr->host[0] == '\0'))
 		return;
 
-	addr = xmalloc(sizeof(struct sockaddr_in));
-	slurm_set_addr(addr, step_ptr->port, step_ptr->host);
 	msg_arg = xmalloc(sizeof(srun_timeout_msg_t));
 	msg_arg->job_id   = step_ptr->job_ptr->job_id;
 	msg_arg->step_id  = step_ptr->step_id;
 	msg_arg->timeout  = timeout_val;
-	_srun_agent_launch(addr, step_ptr->host, SRUN_TIMEOUT, msg_arg,
+	_srun_agent_launch(step_ptr->port, step_ptr->host, step_ptr->host,
+			   SRUN_TIMEOUT, msg_arg,
 			   step_ptr->start_protocol_ver);
 }
 
@@ -332,7 +459,6 @@ extern void srun_step_timeout(struct step_record *step_ptr, time_t timeout_val)
  */
 extern void srun_timeout (struct job_record *job_ptr)
 {
-	slurm_addr_t * addr;
 	srun_timeout_msg_t *msg_arg;
 	ListIterator step_iterator;
 	struct step_record *step_ptr;
@@ -342,13 +468,12 @@ extern void srun_timeout (struct job_record *job_ptr)
 		return;
 
 	if (job_ptr->other_port && job_ptr->alloc_node && job_ptr->resp_host) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, job_ptr->other_port, job_ptr->resp_host);
 		msg_arg = xmalloc(sizeof(srun_timeout_msg_t));
 		msg_arg->job_id   = job_ptr->job_id;
 		msg_arg->step_id  = NO_VAL;
 		msg_arg->timeout  = job_ptr->end_time;
-		_srun_agent_launch(addr, job_ptr->alloc_node, SRUN_TIMEOUT,
+		_srun_agent_launch(job_ptr->other_port, job_ptr->resp_host,
+				   job_ptr->alloc_node, SRUN_TIMEOUT,
 				   msg_arg, job_ptr->start_protocol_ver);
 	}
 
@@ -364,7 +489,6 @@ extern void srun_timeout (struct job_record *job_ptr)
  */
 extern int srun_user_message(struct job_record *job_ptr, char *msg)
 {
-	slurm_addr_t * addr;
 	srun_user_msg_t *msg_arg;
 
 	xassert(job_ptr);
@@ -373,12 +497,11 @@ extern int srun_user_message(struct job_record *job_ptr, char *msg)
 
 	if (job_ptr->other_port &&
 	    job_ptr->resp_host && job_ptr->resp_host[0]) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, job_ptr->other_port, job_ptr->resp_host);
 		msg_arg = xmalloc(sizeof(srun_user_msg_t));
 		msg_arg->job_id = job_ptr->job_id;
 		msg_arg->msg    = xstrdup(msg);
-		_srun_agent_launch(addr, job_ptr->resp_host, SRUN_USER_MSG,
+		_srun_agent_launch(job_ptr->other_port, job_ptr->resp_host,
+				   job_ptr->resp_host, SRUN_USER_MSG,
 				   msg_arg, job_ptr->start_protocol_ver);
 		return SLURM_SUCCESS;
 	} else if (job_ptr->batch_flag && IS_JOB_RUNNING(job_ptr)) {
@@ -430,7 +553,6 @@ extern int srun_user_message(struct job_record *job_ptr, char *msg)
  */
 extern void srun_job_complete (struct job_record *job_ptr)
 {
-	slurm_addr_t * addr;
 	srun_job_complete_msg_t *msg_arg;
 	ListIterator step_iterator;
 	struct step_record *step_ptr;
@@ -438,12 +560,11 @@ extern void srun_job_complete (struct job_record *job_ptr)
 	xassert(job_ptr);
 
 	if (job_ptr->other_port && job_ptr->alloc_node && job_ptr->resp_host) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, job_ptr->other_port, job_ptr->resp_host);
 		msg_arg = xmalloc(sizeof(srun_job_complete_msg_t));
 		msg_arg->job_id   = job_ptr->job_id;
 		msg_arg->step_id  = NO_VAL;
-		_srun_agent_launch(addr, job_ptr->alloc_node,
+		_srun_agent_launch(job_ptr->other_port, job_ptr->resp_host,
+				   job_ptr->alloc_node,
 				   SRUN_JOB_COMPLETE, msg_arg,
 				   job_ptr->start_protocol_ver);
 	}
@@ -465,19 +586,17 @@ extern void srun_job_complete (struct job_record *job_ptr)
  */
 extern bool srun_job_suspend (struct job_record *job_ptr, uint16_t op)
 {
-	slurm_addr_t * addr;
 	suspend_msg_t *msg_arg;
 	bool msg_sent = false;
 
 	xassert(job_ptr);
 
 	if (job_ptr->other_port && job_ptr->alloc_node && job_ptr->resp_host) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, job_ptr->other_port, job_ptr->resp_host);
 		msg_arg = xmalloc(sizeof(suspend_msg_t));
 		msg_arg->job_id  = job_ptr->job_id;
 		msg_arg->op     = op;
-		_srun_agent_launch(addr, job_ptr->alloc_node,
+		_srun_agent_launch(job_ptr->other_port, job_ptr->resp_host,
+				   job_ptr->alloc_node,
 				   SRUN_REQUEST_SUSPEND, msg_arg,
 				   job_ptr->start_protocol_ver);
 		msg_sent = true;
@@ -491,17 +610,15 @@ extern bool srun_job_suspend (struct job_record *job_ptr, uint16_t op)
  */
 extern void srun_step_complete (struct step_record *step_ptr)
 {
-	slurm_addr_t * addr;
 	srun_job_complete_msg_t *msg_arg;
 
 	xassert(step_ptr);
 	if (step_ptr->port && step_ptr->host && step_ptr->host[0]) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, step_ptr->port, step_ptr->host);
 		msg_arg = xmalloc(sizeof(srun_job_complete_msg_t));
 		msg_arg->job_id   = step_ptr->job_ptr->job_id;
 		msg_arg->step_id  = step_ptr->step_id;
-		_srun_agent_launch(addr, step_ptr->host, SRUN_JOB_COMPLETE,
+		_srun_agent_launch(step_ptr->port, step_ptr->host,
+				   step_ptr->host, SRUN_JOB_COMPLETE,
 				   msg_arg, step_ptr->start_protocol_ver);
 	}
 }
@@ -515,18 +632,16 @@ extern void srun_step_complete (struct step_record *step_ptr)
 extern void srun_step_missing (struct step_record *step_ptr,
 			       char *node_list)
 {
-	slurm_addr_t * addr;
 	srun_step_missing_msg_t *msg_arg;
 
 	xassert(step_ptr);
 	if (step_ptr->port && step_ptr->host && step_ptr->host[0]) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, step_ptr->port, step_ptr->host);
 		msg_arg = xmalloc(sizeof(srun_step_missing_msg_t));
 		msg_arg->job_id   = step_ptr->job_ptr->job_id;
 		msg_arg->step_id  = step_ptr->step_id;
 		msg_arg->nodelist = xstrdup(node_list);
-		_srun_agent_launch(addr, step_ptr->host, SRUN_STEP_MISSING,
+		_srun_agent_launch(step_ptr->port, step_ptr->host,
+				   step_ptr->host, SRUN_STEP_MISSING,
 				   msg_arg, step_ptr->start_protocol_ver);
 	}
 }
@@ -539,18 +654,16 @@ extern void srun_step_missing (struct step_record *step_ptr,
  */
 extern void srun_step_signal (struct step_record *step_ptr, uint16_t signal)
 {
-	slurm_addr_t * addr;
 	job_step_kill_msg_t *msg_arg;
 
 	xassert(step_ptr);
 	if (step_ptr->port && step_ptr->host && step_ptr->host[0]) {
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, step_ptr->port, step_ptr->host);
 		msg_arg = xmalloc(sizeof(job_step_kill_msg_t));
 		msg_arg->job_id      = step_ptr->job_ptr->job_id;
 		msg_arg->job_step_id = step_ptr->step_id;
 		msg_arg->signal      = signal;
-		_srun_agent_launch(addr, step_ptr->host, SRUN_STEP_SIGNAL,
+		_srun_agent_launch(step_ptr->port, step_ptr->host,
+				   step_ptr->host, SRUN_STEP_SIGNAL,
 				   msg_arg, step_ptr->start_protocol_ver);
 	}
 }
@@ -563,7 +676,6 @@ extern void srun_step_signal (struct step_record *step_ptr, uint16_t signal)
  */
 extern void srun_exec(struct step_record *step_ptr, char **argv)
 {
-	slurm_addr_t * addr;
 	srun_exec_msg_t *msg_arg;
 	int cnt = 1, i;
 
@@ -572,8 +684,6 @@ extern void srun_exec(struct step_record *step_ptr, char **argv)
 	if (step_ptr->port && step_ptr->host && step_ptr->host[0]) {
 		for (i=0; argv[i]; i++)
 			cnt++;	/* start at 1 to include trailing NULL */
-		addr = xmalloc(sizeof(struct sockaddr_in));
-		slurm_set_addr(addr, step_ptr->port, step_ptr->host);
 		msg_arg = xmalloc(sizeof(srun_exec_msg_t));
 		msg_arg->job_id  = step_ptr->job_ptr->job_id;
 		msg_arg->step_id = step_ptr->step_id;
@@ -581,7 +691,8 @@ extern void srun_exec(struct step_record *step_ptr, char **argv)
 		msg_arg->argv    = xmalloc(sizeof(char *) * cnt);
 		for (i=0; i<cnt ; i++)
 			msg_arg->argv[i] = xstrdup(argv[i]);
-		_srun_agent_launch(addr, step_ptr->host, SRUN_EXEC,
+		_srun_agent_launch(step_ptr->port, step_ptr->host,
+				   step_ptr->host, SRUN_EXEC,
 				   msg_arg, step_ptr->start_protocol_ver);
 	} else {
 		error("srun_exec %pS lacks communication channel",
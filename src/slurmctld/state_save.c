@@ -46,6 +46,7 @@
 #include <pthread.h>
 
 #include "src/common/macros.h"
+#include "src/common/timers.h"
 #include "src/slurmctld/front_end.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/slurmctld.h"
@@ -62,59 +63,108 @@ static int save_jobs = 0, save_nodes = 0, save_parts = 0;
 static int save_front_end = 0, save_triggers = 0, save_resv = 0;
 static bool run_save_thread = true;
 
+static int save_qid = -1;	/* queue telemetry, see timers.h */
+static time_t save_oldest = 0;	/* when the oldest pending save arrived */
+static pthread_once_t save_stats_once = PTHREAD_ONCE_INIT;
 
-/* Queue saving of front_end state information */
-extern void schedule_front_end_save(void)
+/* Pending state save classes, each counts as one queued work item */
+static int _state_save_depth(void)
 {
+	int depth = 0;
+
 	slurm_mutex_lock(&state_save_lock);
-	save_front_end++;
-	slurm_cond_broadcast(&state_save_cond);
+	if (save_jobs)
+		depth++;
+	if (save_nodes)
+		depth++;
+	if (save_parts)
+		depth++;
+	if (save_front_end)
+		depth++;
+	if (save_resv)
+		depth++;
+	if (save_triggers)
+		depth++;
 	slurm_mutex_unlock(&state_save_lock);
+
+	return depth;
 }
 
-/* Queue saving of job state information */
-extern void schedule_job_save(void)
+static time_t _state_save_head(void)
 {
+	time_t head;
+
 	slurm_mutex_lock(&state_save_lock);
-	save_jobs++;
-	slurm_cond_broadcast(&state_save_cond);
+	head = save_oldest;
 	slurm_mutex_unlock(&state_save_lock);
+
+	return head;
 }
 
-/* Queue saving of node state information */
-extern void schedule_node_save(void)
+static void _register_save_stats(void)
 {
+	save_qid = queue_stats_register("state_save", _state_save_depth,
+					_state_save_head);
+}
+
+/* Queue one class of state save. Repeated requests for a class already
+ * pending coalesce into the single queued save, so only the first one
+ * counts as an enqueue. */
+static void _queue_save(int *flag)
+{
+	pthread_once(&save_stats_once, _register_save_stats);
 	slurm_mutex_lock(&state_save_lock);
-	save_nodes++;
+	if ((*flag)++ == 0)
+		queue_stats_enqueued(save_qid);
+	if (!save_oldest)
+		save_oldest = time(NULL);
 	slurm_cond_broadcast(&state_save_cond);
 	slurm_mutex_unlock(&state_save_lock);
 }
 
+/* Note one class of state save drained. Call with state_save_lock set. */
+static void _save_dequeued(void)
+{
+	queue_stats_dequeued(save_qid);
+	if ((save_jobs + save_nodes + save_parts + save_front_end +
+	     save_resv + save_triggers) == 0)
+		save_oldest = 0;
+}
+
+/* Queue saving of front_end state information */
+extern void schedule_front_end_save(void)
+{
+	_queue_save(&save_front_end);
+}
+
+/* Queue saving of job state information */
+extern void schedule_job_save(void)
+{
+	_queue_save(&save_jobs);
+}
+
+/* Queue saving of node state information */
+extern void schedule_node_save(void)
+{
+	_queue_save(&save_nodes);
+}
+
 /* Queue saving of partition state information */
 extern void schedule_part_save(void)
 {
-	slurm_mutex_lock(&state_save_lock);
-	save_parts++;
-	slurm_cond_broadcast(&state_save_cond);
-	slurm_mutex_unlock(&state_save_lock);
+	_queue_save(&save_parts);
 }
 
 /* Queue saving of reservation state information */
 extern void schedule_resv_save(void)
 {
-	slurm_mutex_lock(&state_save_lock);
-	save_resv++;
-	slurm_cond_broadcast(&state_save_cond);
-	slurm_mutex_unlock(&state_save_lock);
+	_queue_save(&save_resv);
 }
 
 /* Queue saving of trigger state information */
 extern void schedule_trigger_save(void)
 {
-	slurm_mutex_lock(&state_save_lock);
-	save_triggers++;
-	slurm_cond_broadcast(&state_save_cond);
-	slurm_mutex_unlock(&state_save_lock);
+	_queue_save(&save_triggers);
 }
 
 /* shutdown the slurmctld_state_save thread */
@@ -184,6 +234,7 @@ extern void *slurmctld_state_save(void *no_data)
 		if (save_front_end) {
 			run_save = true;
 			save_front_end = 0;
+			_save_dequeued();
 		}
 		slurm_mutex_unlock(&state_save_lock);
 		if (run_save)
@@ -195,6 +246,7 @@ extern void *slurmctld_state_save(void *no_data)
 		if (save_jobs) {
 			run_save = true;
 			save_jobs = 0;
+			_save_dequeued();
 		}
 		slurm_mutex_unlock(&state_save_lock);
 		if (run_save)
@@ -206,6 +258,7 @@ extern void *slurmctld_state_save(void *no_data)
 		if (save_nodes) {
 			run_save = true;
 			save_nodes = 0;
+			_save_dequeued();
 		}
 		slurm_mutex_unlock(&state_save_lock);
 		if (run_save)
@@ -217,6 +270,7 @@ extern void *slurmctld_state_save(void *no_data)
 		if (save_parts) {
 			run_save = true;
 			save_parts = 0;
+			_save_dequeued();
 		}
 		slurm_mutex_unlock(&state_save_lock);
 		if (run_save)
@@ -228,6 +282,7 @@ extern void *slurmctld_state_save(void *no_data)
 		if (save_resv) {
 			run_save = true;
 			save_resv = 0;
+			_save_dequeued();
 		}
 		slurm_mutex_unlock(&state_save_lock);
 		if (run_save)
@@ -239,6 +294,7 @@ extern void *slurmctld_state_save(void *no_data)
 		if (save_triggers) {
 			run_save = true;
 			save_triggers = 0;
+			_save_dequeued();
 		}
 		slurm_mutex_unlock(&state_save_lock);
 		if (run_save)
@@ -37,13 +37,16 @@
 #include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "src/slurmctld/agent.h"
+#include "src/slurmctld/locks.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/common/list.h"
 #include "src/common/pack.h"
 #include "src/common/xstring.h"
 #include "src/common/slurmdbd_defs.h"
+#include "src/common/timers.h"
 
 extern int retry_list_size(void);
 
@@ -56,6 +59,8 @@ extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 	int agent_queue_size;
 	int agent_count;
 	int slurmdbd_queue_size;
+	uint32_t i, j, rec_cnt;
+	bf_cycle_rec_t *rec;
 	time_t now = time(NULL);
 
 	buffer_ptr[0] = NULL;
@@ -137,6 +142,42 @@ extern void pack_all_stat(int resp, char **buffer_ptr, int *buffer_size,
 			pack32(slurmctld_diag_stats.bf_active, buffer);
 			pack32(slurmctld_diag_stats.backfilled_pack_jobs,
 			       buffer);
+
+			/* Ring of per-cycle backfill records, oldest first */
+			rec_cnt = MIN(slurmctld_diag_stats.bf_cycle_counter,
+				      BF_CYCLE_RECORDS);
+			pack32(rec_cnt, buffer);
+			for (i = 0; i < rec_cnt; i++) {
+				j = (slurmctld_diag_stats.bf_cycle_rec_inx +
+				     BF_CYCLE_RECORDS - rec_cnt + i) %
+				    BF_CYCLE_RECORDS;
+				rec = &slurmctld_diag_stats.bf_cycle_recs[j];
+				pack_time(rec->when, buffer);
+				pack32(rec->cycle_usec, buffer);
+				pack32(rec->try_usec, buffer);
+				pack32(rec->depth, buffer);
+				pack32(rec->depth_try, buffer);
+				pack32(rec->yields, buffer);
+				pack32(rec->table_size, buffer);
+				pack32(rec->queue_len, buffer);
+			}
+
+			lock_profile_pack(buffer);
+
+			/* Job lifecycle interval histograms */
+			pack32(JOB_TIMING_NBUCKETS, buffer);
+			pack32_array(
+				slurmctld_diag_stats.job_timing_submit_eval,
+				JOB_TIMING_NBUCKETS, buffer);
+			pack32_array(
+				slurmctld_diag_stats.job_timing_alloc_launch,
+				JOB_TIMING_NBUCKETS, buffer);
+			pack32_array(
+				slurmctld_diag_stats.job_timing_complete_clean,
+				JOB_TIMING_NBUCKETS, buffer);
+
+			/* Internal work queue depths and event counters */
+			queue_stats_pack(buffer);
 		}
 	} else if (protocol_version >= SLURM_MIN_PROTOCOL_VERSION) {
 		parts_packed = resp;
@@ -244,6 +285,16 @@ extern void reset_stats(int level)
 	slurmctld_diag_stats.bf_last_depth = 0;
 	slurmctld_diag_stats.bf_last_depth_try = 0;
 	slurmctld_diag_stats.bf_active = 0;
+	memset(slurmctld_diag_stats.bf_cycle_recs, 0,
+	       sizeof(slurmctld_diag_stats.bf_cycle_recs));
+	slurmctld_diag_stats.bf_cycle_rec_inx = 0;
+	memset(slurmctld_diag_stats.job_timing_submit_eval, 0,
+	       sizeof(slurmctld_diag_stats.job_timing_submit_eval));
+	memset(slurmctld_diag_stats.job_timing_alloc_launch, 0,
+	       sizeof(slurmctld_diag_stats.job_timing_alloc_launch));
+	memset(slurmctld_diag_stats.job_timing_complete_clean, 0,
+	       sizeof(slurmctld_diag_stats.job_timing_complete_clean));
+	lock_profile_reset();
 
 	last_proc_req_start = time(NULL);
 }
@@ -2555,6 +2555,7 @@ step_create(job_step_create_request_msg_t *step_specs,
 	}
 	step_ptr->start_time = time(NULL);
 	step_ptr->state      = JOB_RUNNING;
+	job_time_limit_register(job_ptr, step_ptr->start_time);
 
 	if (step_specs->step_id != NO_VAL) {
 		step_ptr->step_id = step_specs->step_id;
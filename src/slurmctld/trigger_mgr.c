@@ -55,6 +55,7 @@
 #include "src/common/list.h"
 #include "src/common/slurmdbd_defs.h"
 #include "src/common/slurm_protocol_defs.h"
+#include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
@@ -72,6 +73,8 @@
 List trigger_list;
 uint32_t next_trigger_id = 1;
 static pthread_mutex_t trigger_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int trigger_qid = -1;	/* queue telemetry, see timers.h */
+static pthread_once_t trigger_stats_once = PTHREAD_ONCE_INIT;
 bitstr_t *trigger_down_front_end_bitmap = NULL;
 bitstr_t *trigger_up_front_end_bitmap = NULL;
 bitstr_t *trigger_down_nodes_bitmap = NULL;
@@ -92,6 +95,13 @@ static bool trigger_pri_dbd_res_op = false;
 static bool trigger_pri_db_fail = false;
 static bool trigger_pri_db_res_op = false;
 
+/* TRIGGER_TYPE_* events which fired since the last trigger_process()
+ * cycle, computed once per cycle so that event dispatch only touches
+ * triggers with a matching pending event rather than re-testing the
+ * event bitmaps for every registered trigger */
+static uint32_t node_event_types = 0;
+static uint32_t front_end_event_types = 0;
+
 /* Current trigger pull states (saved and restored) */
 uint8_t ctld_failure = 0;
 uint8_t bu_ctld_failure = 0;
@@ -120,8 +130,21 @@ typedef struct trig_mgr_info {
 	time_t   orig_time;	/* offset (pending) or time stamp (complete) */
 } trig_mgr_info_t;
 
+/* Registered triggers awaiting their event or program completion */
+static int _trigger_queue_depth(void)
+{
+	return trigger_list ? list_count(trigger_list) : 0;
+}
+
+static void _register_trigger_stats(void)
+{
+	trigger_qid = queue_stats_register("trigger", _trigger_queue_depth,
+					   NULL);
+}
+
 /* Prototype for ListDelF */
 void _trig_del(void *x) {
+	queue_stats_dequeued(trigger_qid);
 	trig_mgr_info_t * tmp = (trig_mgr_info_t *) x;
 	xfree(tmp->res_id);
 	xfree(tmp->orig_res_id);
@@ -494,6 +517,8 @@ extern int trigger_set(uid_t uid, gid_t gid, trigger_info_msg_t *msg)
 			continue;
 		}
 		list_append(trigger_list, trig_add);
+		pthread_once(&trigger_stats_once, _register_trigger_stats);
+		queue_stats_enqueued(trigger_qid);
 		schedule_trigger_save();
 	}
 
@@ -799,6 +824,8 @@ static int _load_trigger_state(Buf buffer, uint16_t protocol_version)
 	if (trigger_list == NULL)
 		trigger_list = list_create(_trig_del);
 	list_append(trigger_list, trig_ptr);
+	pthread_once(&trigger_stats_once, _register_trigger_stats);
+	queue_stats_enqueued(trigger_qid);
 	next_trigger_id = MAX(next_trigger_id, trig_ptr->trig_id + 1);
 	slurm_mutex_unlock(&trigger_mutex);
 
@@ -1043,7 +1070,8 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_DOWN) {
+	if ((trig_in->trig_type & TRIGGER_TYPE_DOWN) &&
+	    (front_end_event_types & TRIGGER_TYPE_DOWN)) {
 		if (_front_end_job_test(trigger_down_front_end_bitmap,
 					trig_in->job_ptr)) {
 			if (slurmctld_conf.debug_flags & DEBUG_FLAG_TRIGGERS) {
@@ -1057,7 +1085,8 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_DOWN) {
+	if ((trig_in->trig_type & TRIGGER_TYPE_DOWN) &&
+	    (node_event_types & TRIGGER_TYPE_DOWN)) {
 		if (trigger_down_nodes_bitmap &&
 		    bit_overlap(trig_in->job_ptr->node_bitmap,
 				trigger_down_nodes_bitmap)) {
@@ -1072,7 +1101,8 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_FAIL) {
+	if ((trig_in->trig_type & TRIGGER_TYPE_FAIL) &&
+	    (node_event_types & TRIGGER_TYPE_FAIL)) {
 		if (trigger_fail_nodes_bitmap &&
 		    bit_overlap(trig_in->job_ptr->node_bitmap,
 				trigger_fail_nodes_bitmap)) {
@@ -1087,7 +1117,8 @@ static void _trigger_job_event(trig_mgr_info_t *trig_in, time_t now)
 		}
 	}
 
-	if (trig_in->trig_type & TRIGGER_TYPE_UP) {
+	if ((trig_in->trig_type & TRIGGER_TYPE_UP) &&
+	    (node_event_types & TRIGGER_TYPE_UP)) {
 		if (trigger_up_nodes_bitmap &&
 		    bit_overlap(trig_in->job_ptr->node_bitmap,
 				trigger_up_nodes_bitmap)) {
@@ -1591,6 +1622,34 @@ static void _clear_event_triggers(void)
 	trigger_pri_db_res_op = false;
 }
 
+/* Identify which node and front end events fired since the last cycle */
+static void _get_fired_events(void)
+{
+	node_event_types = TRIGGER_TYPE_IDLE;	/* always polled */
+	if (trigger_down_nodes_bitmap &&
+	    (bit_ffs(trigger_down_nodes_bitmap) != -1))
+		node_event_types |= TRIGGER_TYPE_DOWN;
+	if (trigger_drained_nodes_bitmap &&
+	    (bit_ffs(trigger_drained_nodes_bitmap) != -1))
+		node_event_types |= TRIGGER_TYPE_DRAINED;
+	if (trigger_fail_nodes_bitmap &&
+	    (bit_ffs(trigger_fail_nodes_bitmap) != -1))
+		node_event_types |= TRIGGER_TYPE_FAIL;
+	if (trigger_up_nodes_bitmap &&
+	    (bit_ffs(trigger_up_nodes_bitmap) != -1))
+		node_event_types |= TRIGGER_TYPE_UP;
+	if (trigger_node_reconfig)
+		node_event_types |= TRIGGER_TYPE_RECONFIG;
+
+	front_end_event_types = 0;
+	if (trigger_down_front_end_bitmap &&
+	    (bit_ffs(trigger_down_front_end_bitmap) != -1))
+		front_end_event_types |= TRIGGER_TYPE_DOWN;
+	if (trigger_up_front_end_bitmap &&
+	    (bit_ffs(trigger_up_front_end_bitmap) != -1))
+		front_end_event_types |= TRIGGER_TYPE_UP;
+}
+
 /* Make a copy of a trigger and pre-pend it on our list */
 static void _trigger_clone(trig_mgr_info_t *trig_in)
 {
@@ -1617,6 +1676,7 @@ static void _trigger_clone(trig_mgr_info_t *trig_in)
 	trig_add->group_id  = trig_in->group_id;
 	trig_add->program   = xstrdup(trig_in->program);;
 	list_prepend(trigger_list, trig_add);
+	queue_stats_enqueued(trigger_qid);
 }
 
 extern void trigger_process(void)
@@ -1631,6 +1691,7 @@ extern void trigger_process(void)
 	slurm_mutex_lock(&trigger_mutex);
 	if (trigger_list == NULL)
 		trigger_list = list_create(_trig_del);
+	_get_fired_events();
 
 	trig_iter = list_iterator_create(trigger_list);
 	while ((trig_in = list_next(trig_iter))) {
@@ -1639,9 +1700,10 @@ extern void trigger_process(void)
 				_trigger_other_event(trig_in, now);
 			else if (trig_in->res_type == TRIGGER_RES_TYPE_JOB)
 				_trigger_job_event(trig_in, now);
-			else if (trig_in->res_type == TRIGGER_RES_TYPE_NODE)
-				_trigger_node_event(trig_in, now);
-			else if (trig_in->res_type ==
+			else if (trig_in->res_type == TRIGGER_RES_TYPE_NODE) {
+				if (trig_in->trig_type & node_event_types)
+					_trigger_node_event(trig_in, now);
+			} else if (trig_in->res_type ==
 				 TRIGGER_RES_TYPE_SLURMCTLD)
 				_trigger_slurmctld_event(trig_in, now);
 			else if (trig_in->res_type ==
@@ -1651,8 +1713,10 @@ extern void trigger_process(void)
 				 TRIGGER_RES_TYPE_DATABASE)
 			 	_trigger_database_event(trig_in, now);
 			else if (trig_in->res_type ==
-				 TRIGGER_RES_TYPE_FRONT_END)
-			 	_trigger_front_end_event(trig_in, now);
+				 TRIGGER_RES_TYPE_FRONT_END) {
+				if (trig_in->trig_type & front_end_event_types)
+					_trigger_front_end_event(trig_in, now);
+			}
 		}
 		if ((trig_in->state == 1) &&
 		    (trig_in->trig_time <= now)) {
@@ -80,6 +80,21 @@ extern char *fname_create(stepd_step_rec_t *job, const char *format, int taskid)
 	if (((id = fname_single_task_io(format)) >= 0) && (taskid != id))
 		return (xstrdup ("/dev/null"));
 
+	/* "spool" keeps all output on the compute node: each task
+	 * writes a spool file under the node-local TmpFS directory
+	 * rather than streaming anything back to the client */
+	if (xstrcasecmp(format, "spool") == 0) {
+		if (job->batch)
+			xstrfmtcat(name, "%s/slurm_spool_job%u.out",
+				   conf->tmpfs, job->jobid);
+		else
+			xstrfmtcat(name,
+				   "%s/slurm_spool_job%u.%u_task_%d.out",
+				   conf->tmpfs, job->jobid, job->stepid,
+				   taskid);
+		return name;
+	}
+
 	orig = xstrdup(format);
 	esc = remove_path_slashes(orig);
 
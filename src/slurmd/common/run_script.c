@@ -36,16 +36,20 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#include <ctype.h>
 #include <glob.h>
 #include <poll.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/errno.h>
+#include <sys/time.h>
 #include <sys/wait.h>
 
 #include "slurm/slurm_errno.h"
 #include "src/common/list.h"
+#include "src/common/macros.h"
+#include "src/common/slurm_protocol_api.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
@@ -103,16 +107,15 @@ int waitpid_timeout (const char *name, pid_t pid, int *pstatus, int timeout)
  * uid IN: user ID of job owner
  * RET 0 on success, -1 on failure.
  */
-static int
-_run_one_script(const char *name, const char *path, uint32_t job_id,
-		int max_wait, char **env, uid_t uid)
+static pid_t
+_fork_one_script(const char *name, const char *path, uint32_t job_id,
+		 char **env)
 {
-	int status;
 	pid_t cpid;
 
 	xassert(env);
 	if (path == NULL || path[0] == '\0')
-		return 0;
+		return (pid_t) -1;
 
 	if (job_id) {
 		debug("[job %u] attempting to run %s [%s]",
@@ -122,12 +125,12 @@ _run_one_script(const char *name, const char *path, uint32_t job_id,
 
 	if (access(path, R_OK | X_OK) < 0) {
 		error("Can not run %s [%s]: %m", name, path);
-		return -1;
+		return (pid_t) -1;
 	}
 
 	if ((cpid = fork()) < 0) {
 		error ("executing %s: fork: %m", name);
-		return -1;
+		return (pid_t) -1;
 	}
 	if (cpid == 0) {
 		char *argv[2];
@@ -151,6 +154,22 @@ _run_one_script(const char *name, const char *path, uint32_t job_id,
 		exit(127);
 	}
 
+	return cpid;
+}
+
+static int
+_run_one_script(const char *name, const char *path, uint32_t job_id,
+		int max_wait, char **env, uid_t uid)
+{
+	int status;
+	pid_t cpid;
+
+	if (path == NULL || path[0] == '\0')
+		return 0;
+
+	if ((cpid = _fork_one_script(name, path, job_id, env)) < 0)
+		return (-1);
+
 	if (waitpid_timeout(name, cpid, &status, max_wait) < 0)
 		return (-1);
 	return status;
@@ -201,12 +220,114 @@ static List _script_list_create (const char *pattern)
 	return l;
 }
 
+/*
+ * Maximum number of prolog/epilog scripts run concurrently, from
+ * SlurmdParameters=script_concurrency=<num>.  The default of one
+ * preserves the strictly serial execution order.
+ */
+static int _script_concurrency(void)
+{
+	static int concurrency = -1;
+	static pthread_mutex_t concurrency_lock = PTHREAD_MUTEX_INITIALIZER;
+
+	slurm_mutex_lock(&concurrency_lock);
+	if (concurrency < 0) {
+		char *params = slurm_get_slurmd_params();
+		char *tmp;
+
+		concurrency = 1;
+		if (params && (tmp = strstr(params, "script_concurrency=")))
+			concurrency = MAX(atoi(tmp + 19), 1);
+		xfree(params);
+	}
+	slurm_mutex_unlock(&concurrency_lock);
+
+	return concurrency;
+}
+
+/*
+ * Stage of a script within its glob list, taken from a leading decimal
+ * prefix on the file name (e.g. "10-container" and "10-scratch" are both
+ * stage 10).  Scripts sharing a stage have no ordering dependency on each
+ * other and may run concurrently; distinct stages run in ascending order.
+ * Returns -1 for file names with no numeric prefix, which always run
+ * alone in glob order.
+ */
+static int _script_stage(const char *path)
+{
+	const char *base = strrchr(path, '/');
+
+	base = base ? (base + 1) : path;
+	if (!isdigit((int) base[0]))
+		return -1;
+	return atoi(base);
+}
+
+/*
+ * Run a group of same-stage scripts concurrently, at most max_par at a
+ * time, waiting for all of them before returning.  The time limit spans
+ * the whole group since the scripts run in parallel.
+ * RET 0 on success or the status of the first script which failed.
+ */
+static int _run_script_stage(const char *name, char **paths, int cnt,
+			     uint32_t job_id, int max_wait, char **env,
+			     int max_par)
+{
+	pid_t *pids = xmalloc(sizeof(pid_t) * cnt);
+	struct timeval tv1, tv2;
+	int rc = 0, status, wait_left, base, wave, j, delta_ms;
+
+	gettimeofday(&tv1, NULL);
+	for (base = 0; base < cnt; base += wave) {
+		wave = MIN(max_par, cnt - base);
+		for (j = 0; j < wave; j++) {
+			pids[base + j] = _fork_one_script(name,
+							  paths[base + j],
+							  job_id, env);
+			if ((pids[base + j] < 0) && !rc)
+				rc = -1;
+		}
+		for (j = 0; j < wave; j++) {
+			if (pids[base + j] < 0)
+				continue;
+			if (max_wait > 0) {
+				gettimeofday(&tv2, NULL);
+				wait_left = max_wait -
+					(tv2.tv_sec - tv1.tv_sec);
+				wait_left = MAX(wait_left, 1);
+			} else
+				wait_left = max_wait;
+			if (waitpid_timeout(name, pids[base + j], &status,
+					    wait_left) < 0)
+				status = -1;
+			if (status) {
+				error("%s: exited with status 0x%04x\n",
+				      paths[base + j], status);
+				if (!rc)
+					rc = status;
+			}
+		}
+		if (rc)
+			break;
+	}
+	gettimeofday(&tv2, NULL);
+	delta_ms = (tv2.tv_sec - tv1.tv_sec) * 1000 +
+		   (tv2.tv_usec - tv1.tv_usec) / 1000;
+	verbose("%s stage %d: %d concurrent scripts took %d.%03d secs",
+		name, _script_stage(paths[0]), cnt,
+		delta_ms / 1000, delta_ms % 1000);
+	xfree(pids);
+
+	return rc;
+}
+
 int run_script(const char *name, const char *pattern, uint32_t job_id,
 	       int max_wait, char **env, uid_t uid)
 {
-	int rc = 0;
+	int rc = 0, cnt, idx, end, stage, max_par;
 	List l;
 	ListIterator i;
+	char **paths;
 	char *s;
 
 	if (pattern == NULL || pattern[0] == '\0')
@@ -216,16 +337,38 @@ int run_script(const char *name, const char *pattern, uint32_t job_id,
 	if (l == NULL)
 		return error ("Unable to run %s [%s]", name, pattern);
 
+	max_par = _script_concurrency();
+	cnt = list_count(l);
+	paths = xmalloc(sizeof(char *) * cnt);
+	idx = 0;
 	i = list_iterator_create (l);
-	while ((s = list_next (i))) {
-		rc = _run_one_script (name, s, job_id, max_wait, env, uid);
-		if (rc) {
-			error ("%s: exited with status 0x%04x\n", s, rc);
-			break;
+	while ((s = list_next (i)))
+		paths[idx++] = s;
+	list_iterator_destroy (i);
+
+	for (idx = 0; (idx < cnt) && !rc; ) {
+		stage = _script_stage(paths[idx]);
+		end = idx + 1;
+		while ((stage >= 0) && (end < cnt) &&
+		       (_script_stage(paths[end]) == stage))
+			end++;
+
+		if (((end - idx) > 1) && (max_par > 1)) {
+			rc = _run_script_stage(name, paths + idx, end - idx,
+					       job_id, max_wait, env, max_par);
+			idx = end;
+			continue;
 		}
 
+		for ( ; (idx < end) && !rc; idx++) {
+			rc = _run_one_script (name, paths[idx], job_id,
+					      max_wait, env, uid);
+			if (rc)
+				error ("%s: exited with status 0x%04x\n",
+				       paths[idx], rc);
+		}
 	}
-	list_iterator_destroy (i);
+	xfree(paths);
 	FREE_NULL_LIST (l);
 
 	return rc;
@@ -57,10 +57,15 @@ int waitpid_timeout (const char *name, pid_t pid, int *pstatus, int timeout);
 /*
  * Run a prolog or epilog script (does NOT drop privileges)
  * name IN: class of program (prolog, epilog, etc.),
- * path IN: pathname of program to run
+ * path IN: pathname of program to run, may be a glob pattern naming
+ *	several scripts.  With SlurmdParameters=script_concurrency=<num>
+ *	scripts whose file names share a leading decimal prefix (e.g.
+ *	"10-container" and "10-scratch") are treated as independent and
+ *	run concurrently, up to <num> at a time; distinct prefixes and
+ *	unnumbered scripts keep running serially in glob order.
  * jobid IN: info on associated job
  * max_wait IN: maximum time to wait in seconds, -1 for no limit
- * env IN: environment variables to use on exec, sets minimal environment 
+ * env IN: environment variables to use on exec, sets minimal environment
  *	if NULL
  * uid IN: user ID of job owner
  * RET 0 on success, -1 on failure.
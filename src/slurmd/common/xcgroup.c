@@ -652,6 +652,82 @@ int xcgroup_get_param(xcgroup_t* cg, char* param, char **content, size_t *csize)
 	return fstatus;
 }
 
+int xcgroup_open_param(xcgroup_t* cg, char* param,
+		       xcgroup_param_handle_t* handle)
+{
+	char file_path[PATH_MAX];
+	char* cpath = cg->path;
+
+	if (snprintf(file_path, PATH_MAX, "%s/%s", cpath, param) >= PATH_MAX) {
+		debug2("unable to build filepath for '%s' and"
+		       " parameter '%s' : %m", cpath, param);
+		return XCGROUP_ERROR;
+	}
+
+	handle->fd = open(file_path, O_RDONLY, 0700);
+	if (handle->fd < 0) {
+		debug2("%s: unable to open '%s' for reading : %m",
+			__func__, file_path);
+		return XCGROUP_ERROR;
+	}
+	handle->path = xstrdup(file_path);
+
+	return XCGROUP_SUCCESS;
+}
+
+int xcgroup_read_param(xcgroup_param_handle_t* handle, char* buf,
+		       size_t bufsize, size_t *csize)
+{
+	ssize_t rc;
+	bool retried = false;
+
+	if (!handle->path)
+		return XCGROUP_ERROR;
+
+again:
+	if (handle->fd < 0) {
+		handle->fd = open(handle->path, O_RDONLY, 0700);
+		if (handle->fd < 0) {
+			debug2("%s: unable to open '%s' for reading : %m",
+				__func__, handle->path);
+			return XCGROUP_ERROR;
+		}
+	}
+
+	do {
+		rc = pread(handle->fd, buf, bufsize - 1, 0);
+	} while (rc < 0 && errno == EINTR);
+
+	if (rc < 0) {
+		/* the cgroup may have been rebuilt under us, reopen once */
+		close(handle->fd);
+		handle->fd = -1;
+		if (!retried) {
+			retried = true;
+			goto again;
+		}
+		debug2("%s: unable to read '%s' : %m",
+			__func__, handle->path);
+		return XCGROUP_ERROR;
+	}
+
+	buf[rc] = '\0';
+	if (csize)
+		*csize = rc;
+
+	return XCGROUP_SUCCESS;
+}
+
+void xcgroup_close_param(xcgroup_param_handle_t* handle)
+{
+	if (!handle->path)
+		return;
+	if (handle->fd >= 0)
+		close(handle->fd);
+	handle->fd = -1;
+	xfree(handle->path);
+}
+
 int xcgroup_set_uint32_param(xcgroup_t* cg, char* param, uint32_t value)
 {
 	int fstatus = XCGROUP_ERROR;
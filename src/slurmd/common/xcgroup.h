@@ -247,6 +247,46 @@ int xcgroup_set_param(xcgroup_t* cg, char* parameter, char* content);
 int xcgroup_get_param(xcgroup_t* cg, char* param, char **content,
 		      size_t *csize);
 
+/*
+ * Cached handle on a cgroup parameter file, for parameters that are
+ * sampled repeatedly (e.g. job accounting).  The file is opened once
+ * and every xcgroup_read_param() rereads it with pread() at offset
+ * zero into a caller supplied buffer, avoiding the path resolution,
+ * open/close and allocation of xcgroup_get_param() on every sample.
+ */
+typedef struct xcgroup_param_handle {
+	char *path;	/* absolute path of the parameter file */
+	int fd;		/* kept open across reads, -1 when closed */
+} xcgroup_param_handle_t;
+
+/*
+ * open a cached handle on a cgroup parameter
+ *
+ * i.e. xcgroup_open_param(&cg,"cpuacct.stat",&handle);
+ *
+ * returned values:
+ *  - XCGROUP_ERROR
+ *  - XCGROUP_SUCCESS
+ */
+int xcgroup_open_param(xcgroup_t* cg, char* param,
+		       xcgroup_param_handle_t* handle);
+
+/*
+ * read the current content of a cached parameter handle into buf
+ * (at most bufsize-1 bytes, NUL terminated), csize may be NULL
+ *
+ * returned values:
+ *  - XCGROUP_ERROR
+ *  - XCGROUP_SUCCESS
+ */
+int xcgroup_read_param(xcgroup_param_handle_t* handle, char* buf,
+		       size_t bufsize, size_t *csize);
+
+/*
+ * close a cached parameter handle, no-op if it was never opened
+ */
+void xcgroup_close_param(xcgroup_param_handle_t* handle);
+
 /*
  * set a cgroup parameter in the form of a uint32_t
  *
@@ -280,6 +280,18 @@ static pthread_cond_t  file_bcast_cond  = PTHREAD_COND_INITIALIZER;
 static int fb_read_lock = 0, fb_write_wait_lock = 0, fb_write_lock = 0;
 static List file_bcast_list = NULL;
 
+/* Cache of content digests for completed file broadcasts, used to skip
+ * transfers whose destination file is already up to date */
+#define BCAST_DIGEST_CACHE_LIMIT 64
+typedef struct {
+	uint64_t digest;	/* content digest from the sending command */
+	uint64_t file_size;	/* size of destination file */
+	char *fname;		/* destination file name */
+	time_t mtime;		/* destination mtime at completion */
+	uid_t uid;		/* uid of owner */
+} bcast_digest_t;
+static List bcast_digest_list = NULL;
+
 void
 slurmd_req(slurm_msg_t *msg)
 {
@@ -699,33 +711,200 @@ rwfail:
 
 
 /*
- * Fork and exec the slurmstepd, then send the slurmstepd its
- * initialization data.  Then wait for slurmstepd to send an "ok"
- * message before returning.  When the "ok" message is received,
- * the slurmstepd has created and begun listening on its unix
- * domain socket.
- *
- * Note that this code forks twice and it is the grandchild that
- * becomes the slurmstepd process, so the slurmstepd's parent process
- * will be init, not slurmd.
+ * Child side of _forkexec_slurmstepd(): detach, fork the grandchild
+ * that execs the slurmstepd and exit.  Never returns.
  */
-static int
-_forkexec_slurmstepd(uint16_t type, void *req,
-		     slurm_addr_t *cli, slurm_addr_t *self,
-		     const hostset_t step_hset, uint16_t protocol_version)
+static void _exec_stepd_child(int *to_stepd, int *to_slurmd,
+			      uint16_t type, void *req)
 {
 	pid_t pid;
+#if (SLURMSTEPD_MEMCHECK == 1)
+	/* memcheck test of slurmstepd, option #1 */
+	char *const argv[3] = {"memcheck",
+			       (char *)conf->stepd_loc, NULL};
+#elif (SLURMSTEPD_MEMCHECK == 2)
+	/* valgrind test of slurmstepd, option #2 */
+	uint32_t job_id = 0, step_id = 0;
+	char log_file[256];
+	char *const argv[13] = {"valgrind", "--tool=memcheck",
+				"--error-limit=no",
+				"--leak-check=summary",
+				"--show-reachable=yes",
+				"--max-stackframe=16777216",
+				"--num-callers=20",
+				"--child-silent-after-fork=yes",
+				"--track-origins=yes",
+				log_file, (char *)conf->stepd_loc,
+				NULL};
+	if (type == LAUNCH_BATCH_JOB) {
+		job_id = ((batch_job_launch_msg_t *)req)->job_id;
+		step_id = ((batch_job_launch_msg_t *)req)->step_id;
+	} else if (type == LAUNCH_TASKS) {
+		job_id = ((launch_tasks_request_msg_t *)req)->job_id;
+		step_id = ((launch_tasks_request_msg_t *)req)->job_step_id;
+	}
+	snprintf(log_file, sizeof(log_file),
+		 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
+		 job_id, step_id);
+#elif (SLURMSTEPD_MEMCHECK == 3)
+	/* valgrind/drd test of slurmstepd, option #3 */
+	uint32_t job_id = 0, step_id = 0;
+	char log_file[256];
+	char *const argv[10] = {"valgrind", "--tool=drd",
+				"--error-limit=no",
+				"--max-stackframe=16777216",
+				"--num-callers=20",
+				"--child-silent-after-fork=yes",
+				log_file, (char *)conf->stepd_loc,
+				NULL};
+	if (type == LAUNCH_BATCH_JOB) {
+		job_id = ((batch_job_launch_msg_t *)req)->job_id;
+		step_id = ((batch_job_launch_msg_t *)req)->step_id;
+	} else if (type == LAUNCH_TASKS) {
+		job_id = ((launch_tasks_request_msg_t *)req)->job_id;
+		step_id = ((launch_tasks_request_msg_t *)req)->job_step_id;
+	}
+	snprintf(log_file, sizeof(log_file),
+		 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
+		 job_id, step_id);
+#elif (SLURMSTEPD_MEMCHECK == 4)
+	/* valgrind/helgrind test of slurmstepd, option #4 */
+	uint32_t job_id = 0, step_id = 0;
+	char log_file[256];
+	char *const argv[10] = {"valgrind", "--tool=helgrind",
+				"--error-limit=no",
+				"--max-stackframe=16777216",
+				"--num-callers=20",
+				"--child-silent-after-fork=yes",
+				log_file, (char *)conf->stepd_loc,
+				NULL};
+	if (type == LAUNCH_BATCH_JOB) {
+		job_id = ((batch_job_launch_msg_t *)req)->job_id;
+		step_id = ((batch_job_launch_msg_t *)req)->step_id;
+	} else if (type == LAUNCH_TASKS) {
+		job_id = ((launch_tasks_request_msg_t *)req)->job_id;
+		step_id = ((launch_tasks_request_msg_t *)req)->job_step_id;
+	}
+	snprintf(log_file, sizeof(log_file),
+		 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
+		 job_id, step_id);
+#else
+	/* no memory checking, default */
+	char *const argv[2] = { (char *)conf->stepd_loc, NULL};
+#endif
+	int i;
+	int failed = 0;
+
+	/*
+	 * Child forks and exits
+	 */
+	if (setsid() < 0) {
+		error("%s: setsid: %m", __func__);
+		failed = 1;
+	}
+	if ((pid = fork()) < 0) {
+		error("%s: Unable to fork grandchild: %m", __func__);
+		failed = 2;
+	} else if (pid > 0) { /* child */
+		exit(0);
+	}
+
+	/*
+	 * Just in case we (or someone we are linking to)
+	 * opened a file and didn't do a close on exec.  This
+	 * is needed mostly to protect us against libs we link
+	 * to that don't set the flag as we should already be
+	 * setting it for those that we open.  The number 256
+	 * is an arbitrary number based off test7.9.
+	 */
+	for (i=3; i<256; i++) {
+		(void) fcntl(i, F_SETFD, FD_CLOEXEC);
+	}
+
+	/*
+	 * Grandchild exec's the slurmstepd
+	 *
+	 * If the slurmd is being shutdown/restarted before
+	 * the pipe happens the old conf->lfd could be reused
+	 * and if we close it the dup2 below will fail.
+	 */
+	if ((to_stepd[0] != conf->lfd)
+	    && (to_slurmd[1] != conf->lfd))
+		close(conf->lfd);
+
+	if (close(to_stepd[1]) < 0)
+		error("close write to_stepd in grandchild: %m");
+	if (close(to_slurmd[0]) < 0)
+		error("close read to_slurmd in parent: %m");
+
+	(void) close(STDIN_FILENO); /* ignore return */
+	if (dup2(to_stepd[0], STDIN_FILENO) == -1) {
+		error("dup2 over STDIN_FILENO: %m");
+		exit(1);
+	}
+	fd_set_close_on_exec(to_stepd[0]);
+	(void) close(STDOUT_FILENO); /* ignore return */
+	if (dup2(to_slurmd[1], STDOUT_FILENO) == -1) {
+		error("dup2 over STDOUT_FILENO: %m");
+		exit(1);
+	}
+	fd_set_close_on_exec(to_slurmd[1]);
+	(void) close(STDERR_FILENO); /* ignore return */
+	if (dup2(devnull, STDERR_FILENO) == -1) {
+		error("dup2 /dev/null to STDERR_FILENO: %m");
+		exit(1);
+	}
+	fd_set_noclose_on_exec(STDERR_FILENO);
+	log_fini();
+	if (!failed) {
+		execvp(argv[0], argv);
+		error("exec of slurmstepd failed: %m");
+	}
+	exit(2);
+}
+
+#if (SLURMSTEPD_MEMCHECK == 0)
+/*
+ * Pool of preforked slurmstepds, enabled with
+ * SlurmdParameters=stepd_pool_size=<num>.  Each pooled stepd has
+ * already paid the fork/exec/dynamic linking cost and is parked in
+ * _init_from_slurmd() reading its stdin pipe, so launching a step
+ * through one costs only the init data handoff.  All per-step state
+ * arrives over that pipe, so a parked stepd is not tied to any job.
+ */
+#define STEPD_POOL_MAX 64
+
+typedef struct {
+	int to_stepd;		/* write end, init data stream */
+	int to_slurmd;		/* read end, return code reply */
+} pooled_stepd_t;
+
+static pthread_mutex_t stepd_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static List stepd_pool = NULL;
+static int stepd_pool_size = -1;	/* -1 until read from conf */
+
+static void _destroy_pooled_stepd(void *object)
+{
+	pooled_stepd_t *stepd = object;
+
+	/* the parked stepd exits when it reads EOF on its stdin pipe */
+	close(stepd->to_stepd);
+	close(stepd->to_slurmd);
+	xfree(stepd);
+}
+
+/* Fork/exec one slurmstepd parked on its init pipe.
+ * RET the pipe ends to hand it a step later, or NULL on error. */
+static pooled_stepd_t *_stepd_pool_spawn(void)
+{
+	pooled_stepd_t *stepd;
+	pid_t pid;
 	int to_stepd[2] = {-1, -1};
 	int to_slurmd[2] = {-1, -1};
 
 	if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
 		error("%s: pipe failed: %m", __func__);
-		return SLURM_ERROR;
-	}
-
-	if (_add_starting_step(type, req)) {
-		error("%s: failed in _add_starting_step: %m", __func__);
-		return SLURM_ERROR;
+		return NULL;
 	}
 
 	if ((pid = fork()) < 0) {
@@ -734,220 +913,209 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 		close(to_stepd[1]);
 		close(to_slurmd[0]);
 		close(to_slurmd[1]);
-		_remove_starting_step(type, req);
-		return SLURM_ERROR;
-	} else if (pid > 0) {
-		int rc = SLURM_SUCCESS;
+		return NULL;
+	} else if (pid == 0) {
+		_exec_stepd_child(to_stepd, to_slurmd, 0, NULL);
+		/* NOTREACHED */
+	}
+
+	if (close(to_stepd[0]) < 0)
+		error("Unable to close read to_stepd in parent: %m");
+	if (close(to_slurmd[1]) < 0)
+		error("Unable to close write to_slurmd in parent: %m");
+
+	/* Reap child, the grandchild reparents to init */
+	if (waitpid(pid, NULL, 0) < 0)
+		error("Unable to reap slurmd child process");
+
+	/* a restarted slurmd must not inherit the pool pipes */
+	fd_set_close_on_exec(to_stepd[1]);
+	fd_set_close_on_exec(to_slurmd[0]);
+
+	stepd = xmalloc(sizeof(pooled_stepd_t));
+	stepd->to_stepd = to_stepd[1];
+	stepd->to_slurmd = to_slurmd[0];
+	return stepd;
+}
+
+/* Take a preforked slurmstepd from the pool, filling the pool on the
+ * first call and replenishing it afterwards.
+ * RET a parked stepd (caller owns the pipe ends) or NULL if disabled */
+static pooled_stepd_t *_stepd_pool_get(void)
+{
+	pooled_stepd_t *stepd, *fresh;
+	int i;
+
+	slurm_mutex_lock(&stepd_pool_lock);
+	if (stepd_pool_size < 0) {
+		char *params = slurm_get_slurmd_params();
+		char *tmp;
+
+		stepd_pool_size = 0;
+		if (params && (tmp = strstr(params, "stepd_pool_size="))) {
+			stepd_pool_size = atoi(tmp + 16);
+			stepd_pool_size = MIN(stepd_pool_size, STEPD_POOL_MAX);
+			stepd_pool_size = MAX(stepd_pool_size, 0);
+		}
+		xfree(params);
+		if (stepd_pool_size) {
+			stepd_pool = list_create(_destroy_pooled_stepd);
+			for (i = 0; i < stepd_pool_size; i++) {
+				if (!(stepd = _stepd_pool_spawn()))
+					break;
+				list_enqueue(stepd_pool, stepd);
+			}
+			verbose("spawned %d pooled slurmstepds",
+				list_count(stepd_pool));
+		}
+	}
+	stepd = stepd_pool ? list_dequeue(stepd_pool) : NULL;
+	slurm_mutex_unlock(&stepd_pool_lock);
+
+	if (!stepd)
+		return NULL;
+
+	/* replenish outside the lock */
+	if ((fresh = _stepd_pool_spawn())) {
+		slurm_mutex_lock(&stepd_pool_lock);
+		list_enqueue(stepd_pool, fresh);
+		slurm_mutex_unlock(&stepd_pool_lock);
+	}
+
+	return stepd;
+}
+#endif	/* SLURMSTEPD_MEMCHECK == 0 */
+
+/*
+ * Hand the slurmstepd its initialization data, preferably through a
+ * preforked stepd from the pool, otherwise by fork/exec of a fresh
+ * one.  Then wait for slurmstepd to send an "ok" message before
+ * returning.  When the "ok" message is received, the slurmstepd has
+ * created and begun listening on its unix domain socket.
+ *
+ * Note that the fresh path forks twice and it is the grandchild that
+ * becomes the slurmstepd process, so the slurmstepd's parent process
+ * will be init, not slurmd.
+ */
+static int
+_forkexec_slurmstepd(uint16_t type, void *req,
+		     slurm_addr_t *cli, slurm_addr_t *self,
+		     const hostset_t step_hset, uint16_t protocol_version)
+{
+	pid_t pid = -1;
+	int rc = SLURM_SUCCESS;
+	int to_stepd[2] = {-1, -1};
+	int to_slurmd[2] = {-1, -1};
+	bool pooled = false;
 #if (SLURMSTEPD_MEMCHECK == 0)
-		int i;
-		time_t start_time = time(NULL);
+	int i;
+	time_t start_time = time(NULL);
+	pooled_stepd_t *stepd;
 #endif
-		/*
-		 * Parent sends initialization data to the slurmstepd
-		 * over the to_stepd pipe, and waits for the return code
-		 * reply on the to_slurmd pipe.
-		 */
-		if (close(to_stepd[0]) < 0)
-			error("Unable to close read to_stepd in parent: %m");
-		if (close(to_slurmd[1]) < 0)
-			error("Unable to close write to_slurmd in parent: %m");
 
-		if ((rc = _send_slurmstepd_init(to_stepd[1], type,
-						req, cli, self,
-						step_hset,
-						protocol_version)) != 0) {
-			error("Unable to init slurmstepd");
-			goto done;
-		}
+	if (_add_starting_step(type, req)) {
+		error("%s: failed in _add_starting_step: %m", __func__);
+		return SLURM_ERROR;
+	}
 
-		/* If running under valgrind/memcheck, this pipe doesn't work
-		 * correctly so just skip it. */
 #if (SLURMSTEPD_MEMCHECK == 0)
-		i = read(to_slurmd[0], &rc, sizeof(int));
-		if (i < 0) {
-			error("%s: Can not read return code from slurmstepd "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else if (i != sizeof(int)) {
-			error("%s: slurmstepd failed to send return code "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else {
-			int delta_time = time(NULL) - start_time;
-			int cc;
-			if (delta_time > 5) {
-				info("Warning: slurmstepd startup took %d sec, "
-				     "possible file system problem or full "
-				     "memory", delta_time);
-			}
-			if (rc != SLURM_SUCCESS)
-				error("slurmstepd return code %d", rc);
-
-			cc = SLURM_SUCCESS;
-			cc = write(to_stepd[1], &cc, sizeof(int));
-			if (cc != sizeof(int)) {
-				error("%s: failed to send ack to stepd %d: %m",
-				      __func__, cc);
-			}
-		}
+	if ((stepd = _stepd_pool_get())) {
+		to_stepd[1] = stepd->to_stepd;
+		to_slurmd[0] = stepd->to_slurmd;
+		xfree(stepd);
+		pooled = true;
+	}
 #endif
-	done:
-		if (_remove_starting_step(type, req))
-			error("Error cleaning up starting_step list");
-
-		/* Reap child */
-		if (waitpid(pid, NULL, 0) < 0)
-			error("Unable to reap slurmd child process");
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in parent: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-		return rc;
-	} else {
-#if (SLURMSTEPD_MEMCHECK == 1)
-		/* memcheck test of slurmstepd, option #1 */
-		char *const argv[3] = {"memcheck",
-				       (char *)conf->stepd_loc, NULL};
-#elif (SLURMSTEPD_MEMCHECK == 2)
-		/* valgrind test of slurmstepd, option #2 */
-		uint32_t job_id = 0, step_id = 0;
-		char log_file[256];
-		char *const argv[13] = {"valgrind", "--tool=memcheck",
-					"--error-limit=no",
-					"--leak-check=summary",
-					"--show-reachable=yes",
-					"--max-stackframe=16777216",
-					"--num-callers=20",
-					"--child-silent-after-fork=yes",
-					"--track-origins=yes",
-					log_file, (char *)conf->stepd_loc,
-					NULL};
-		if (type == LAUNCH_BATCH_JOB) {
-			job_id = ((batch_job_launch_msg_t *)req)->job_id;
-			step_id = ((batch_job_launch_msg_t *)req)->step_id;
-		} else if (type == LAUNCH_TASKS) {
-			job_id = ((launch_tasks_request_msg_t *)req)->job_id;
-			step_id = ((launch_tasks_request_msg_t *)req)->job_step_id;
-		}
-		snprintf(log_file, sizeof(log_file),
-			 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
-			 job_id, step_id);
-#elif (SLURMSTEPD_MEMCHECK == 3)
-		/* valgrind/drd test of slurmstepd, option #3 */
-		uint32_t job_id = 0, step_id = 0;
-		char log_file[256];
-		char *const argv[10] = {"valgrind", "--tool=drd",
-					"--error-limit=no",
-					"--max-stackframe=16777216",
-					"--num-callers=20",
-					"--child-silent-after-fork=yes",
-					log_file, (char *)conf->stepd_loc,
-					NULL};
-		if (type == LAUNCH_BATCH_JOB) {
-			job_id = ((batch_job_launch_msg_t *)req)->job_id;
-			step_id = ((batch_job_launch_msg_t *)req)->step_id;
-		} else if (type == LAUNCH_TASKS) {
-			job_id = ((launch_tasks_request_msg_t *)req)->job_id;
-			step_id = ((launch_tasks_request_msg_t *)req)->job_step_id;
-		}
-		snprintf(log_file, sizeof(log_file),
-			 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
-			 job_id, step_id);
-#elif (SLURMSTEPD_MEMCHECK == 4)
-		/* valgrind/helgrind test of slurmstepd, option #4 */
-		uint32_t job_id = 0, step_id = 0;
-		char log_file[256];
-		char *const argv[10] = {"valgrind", "--tool=helgrind",
-					"--error-limit=no",
-					"--max-stackframe=16777216",
-					"--num-callers=20",
-					"--child-silent-after-fork=yes",
-					log_file, (char *)conf->stepd_loc,
-					NULL};
-		if (type == LAUNCH_BATCH_JOB) {
-			job_id = ((batch_job_launch_msg_t *)req)->job_id;
-			step_id = ((batch_job_launch_msg_t *)req)->step_id;
-		} else if (type == LAUNCH_TASKS) {
-			job_id = ((launch_tasks_request_msg_t *)req)->job_id;
-			step_id = ((launch_tasks_request_msg_t *)req)->job_step_id;
+fork_fresh:
+	if (!pooled) {
+		if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
+			error("%s: pipe failed: %m", __func__);
+			_remove_starting_step(type, req);
+			return SLURM_ERROR;
 		}
-		snprintf(log_file, sizeof(log_file),
-			 "--log-file=/tmp/slurmstepd_valgrind_%u.%u",
-			 job_id, step_id);
-#else
-		/* no memory checking, default */
-		char *const argv[2] = { (char *)conf->stepd_loc, NULL};
-#endif
-		int i;
-		int failed = 0;
 
-		/*
-		 * Child forks and exits
-		 */
-		if (setsid() < 0) {
-			error("%s: setsid: %m", __func__);
-			failed = 1;
-		}
 		if ((pid = fork()) < 0) {
-			error("%s: Unable to fork grandchild: %m", __func__);
-			failed = 2;
-		} else if (pid > 0) { /* child */
-			exit(0);
+			error("%s: fork: %m", __func__);
+			close(to_stepd[0]);
+			close(to_stepd[1]);
+			close(to_slurmd[0]);
+			close(to_slurmd[1]);
+			_remove_starting_step(type, req);
+			return SLURM_ERROR;
+		} else if (pid == 0) {
+			_exec_stepd_child(to_stepd, to_slurmd, type, req);
+			/* NOTREACHED */
 		}
 
-		/*
-		 * Just in case we (or someone we are linking to)
-		 * opened a file and didn't do a close on exec.  This
-		 * is needed mostly to protect us against libs we link
-		 * to that don't set the flag as we should already be
-		 * setting it for those that we open.  The number 256
-		 * is an arbitrary number based off test7.9.
-		 */
-		for (i=3; i<256; i++) {
-			(void) fcntl(i, F_SETFD, FD_CLOEXEC);
-		}
+		if (close(to_stepd[0]) < 0)
+			error("Unable to close read to_stepd in parent: %m");
+		if (close(to_slurmd[1]) < 0)
+			error("Unable to close write to_slurmd in parent: %m");
+	}
 
-		/*
-		 * Grandchild exec's the slurmstepd
-		 *
-		 * If the slurmd is being shutdown/restarted before
-		 * the pipe happens the old conf->lfd could be reused
-		 * and if we close it the dup2 below will fail.
-		 */
-		if ((to_stepd[0] != conf->lfd)
-		    && (to_slurmd[1] != conf->lfd))
-			close(conf->lfd);
-
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in grandchild: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-
-		(void) close(STDIN_FILENO); /* ignore return */
-		if (dup2(to_stepd[0], STDIN_FILENO) == -1) {
-			error("dup2 over STDIN_FILENO: %m");
-			exit(1);
-		}
-		fd_set_close_on_exec(to_stepd[0]);
-		(void) close(STDOUT_FILENO); /* ignore return */
-		if (dup2(to_slurmd[1], STDOUT_FILENO) == -1) {
-			error("dup2 over STDOUT_FILENO: %m");
-			exit(1);
+	/*
+	 * Send initialization data to the slurmstepd over the to_stepd
+	 * pipe, and wait for the return code reply on the to_slurmd pipe.
+	 */
+	if ((rc = _send_slurmstepd_init(to_stepd[1], type,
+					req, cli, self,
+					step_hset,
+					protocol_version)) != 0) {
+		error("Unable to init slurmstepd");
+		if (pooled) {
+			/* The parked stepd may have died since it was
+			 * spawned, retry with a freshly forked one. */
+			close(to_stepd[1]);
+			close(to_slurmd[0]);
+			pooled = false;
+			goto fork_fresh;
 		}
-		fd_set_close_on_exec(to_slurmd[1]);
-		(void) close(STDERR_FILENO); /* ignore return */
-		if (dup2(devnull, STDERR_FILENO) == -1) {
-			error("dup2 /dev/null to STDERR_FILENO: %m");
-			exit(1);
+		goto done;
+	}
+
+	/* If running under valgrind/memcheck, this pipe doesn't work
+	 * correctly so just skip it. */
+#if (SLURMSTEPD_MEMCHECK == 0)
+	i = read(to_slurmd[0], &rc, sizeof(int));
+	if (i < 0) {
+		error("%s: Can not read return code from slurmstepd "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else if (i != sizeof(int)) {
+		error("%s: slurmstepd failed to send return code "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else {
+		int delta_time = time(NULL) - start_time;
+		int cc;
+		if (delta_time > 5) {
+			info("Warning: slurmstepd startup took %d sec, "
+			     "possible file system problem or full "
+			     "memory", delta_time);
 		}
-		fd_set_noclose_on_exec(STDERR_FILENO);
-		log_fini();
-		if (!failed) {
-			execvp(argv[0], argv);
-			error("exec of slurmstepd failed: %m");
+		if (rc != SLURM_SUCCESS)
+			error("slurmstepd return code %d", rc);
+
+		cc = SLURM_SUCCESS;
+		cc = write(to_stepd[1], &cc, sizeof(int));
+		if (cc != sizeof(int)) {
+			error("%s: failed to send ack to stepd %d: %m",
+			      __func__, cc);
 		}
-		exit(2);
 	}
+#endif
+done:
+	if (_remove_starting_step(type, req))
+		error("Error cleaning up starting_step list");
+
+	/* Reap child, pooled stepds were reaped at spawn time */
+	if ((pid > 0) && (waitpid(pid, NULL, 0) < 0))
+		error("Unable to reap slurmd child process");
+	if (close(to_stepd[1]) < 0)
+		error("close write to_stepd in parent: %m");
+	if (close(to_slurmd[0]) < 0)
+		error("close read to_slurmd in parent: %m");
+	return rc;
 }
 
 static void _setup_x11_display(uint32_t job_id, uint32_t step_id,
@@ -4193,6 +4361,78 @@ static void _file_bcast_cleanup(void)
 	_fb_wrunlock();
 }
 
+static void _free_bcast_digest_t(void *arg)
+{
+	bcast_digest_t *d = (bcast_digest_t *) arg;
+
+	if (!d)
+		return;
+
+	xfree(d->fname);
+	xfree(d);
+}
+
+static int _bcast_digest_find(void *x, void *y)
+{
+	bcast_digest_t *d = (bcast_digest_t *) x;
+	file_bcast_info_t *key = (file_bcast_info_t *) y;
+
+	return ((d->uid == key->uid) && (!xstrcmp(d->fname, key->fname)));
+}
+
+/* Test if the destination file already holds the content described by
+ * an arriving broadcast, allowing the transfer to be skipped entirely.
+ * The cached digest is only trusted while the file's size and mtime
+ * still match those recorded when the prior transfer completed. */
+static bool _bcast_digest_test(file_bcast_msg_t *req, file_bcast_info_t *key)
+{
+	bcast_digest_t *digest_rec;
+	struct stat f_stat;
+	bool match = false;
+
+	_fb_rdlock();
+	if (bcast_digest_list &&
+	    (digest_rec = list_find_first(bcast_digest_list,
+					  _bcast_digest_find, key)) &&
+	    (digest_rec->digest == req->file_digest) &&
+	    (digest_rec->file_size == req->file_size) &&
+	    (stat(req->fname, &f_stat) == 0) &&
+	    (f_stat.st_size == digest_rec->file_size) &&
+	    (f_stat.st_mtime == digest_rec->mtime))
+		match = true;
+	_fb_rdunlock();
+
+	return match;
+}
+
+/* Record the content digest of a completed broadcast so an identical
+ * broadcast of the same file can be skipped later */
+static void _bcast_digest_record(file_bcast_msg_t *req,
+				 file_bcast_info_t *key)
+{
+	bcast_digest_t *digest_rec;
+	struct stat f_stat;
+
+	if (stat(req->fname, &f_stat))
+		return;
+
+	digest_rec = xmalloc(sizeof(bcast_digest_t));
+	digest_rec->digest = req->file_digest;
+	digest_rec->file_size = req->file_size;
+	digest_rec->fname = xstrdup(req->fname);
+	digest_rec->mtime = f_stat.st_mtime;
+	digest_rec->uid = key->uid;
+
+	_fb_wrlock();
+	if (!bcast_digest_list)
+		bcast_digest_list = list_create(_free_bcast_digest_t);
+	list_delete_all(bcast_digest_list, _bcast_digest_find, key);
+	while (list_count(bcast_digest_list) >= BCAST_DIGEST_CACHE_LIMIT)
+		_free_bcast_digest_t(list_dequeue(bcast_digest_list));
+	list_append(bcast_digest_list, digest_rec);
+	_fb_wrunlock();
+}
+
 void file_bcast_init(void)
 {
 	/* skip locks during slurmd init */
@@ -4203,6 +4443,7 @@ void file_bcast_purge(void)
 {
 	_fb_wrlock();
 	list_destroy(file_bcast_list);
+	FREE_NULL_LIST(bcast_digest_list);
 	/* destroying list before exit, no need to unlock */
 }
 
@@ -4254,6 +4495,16 @@ static int _rpc_file_bcast(slurm_msg_t *msg)
 		      key.uid, key.job_id, key.fname, req->block_no);
 	}
 
+	/* destination may be left over from a prior broadcast of the
+	 * same content, in which case no transfer is needed at all */
+	if ((req->block_no == 1) && req->file_digest &&
+	    _bcast_digest_test(req, &key)) {
+		info("sbcast req_uid=%u job_id=%u fname=%s already up to date",
+		     key.uid, key.job_id, key.fname);
+		sbcast_cred_arg_free(cred_arg);
+		return ESLURMD_BCAST_FILE_UP_TO_DATE;
+	}
+
 	/* first block must register the file and open fd/mmap */
 	if (req->block_no == 1) {
 		if ((rc = _file_bcast_register_file(msg, cred_arg, &key))) {
@@ -4318,6 +4569,8 @@ static int _rpc_file_bcast(slurm_msg_t *msg)
 
 	if (req->last_block) {
 		_file_bcast_close_file(&key);
+		if (req->file_digest)
+			_bcast_digest_record(req, &key);
 	}
 	return SLURM_SUCCESS;
 }
@@ -92,6 +92,7 @@
 #include "src/common/slurm_acct_gather_energy.h"
 #include "src/common/slurm_jobacct_gather.h"
 #include "src/common/slurm_mcs.h"
+#include "src/common/slurm_persist_conn.h"
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/slurm_rlimits_info.h"
 #include "src/common/slurm_route.h"
@@ -174,15 +175,32 @@ static sig_atomic_t _update_log = 0;
 static pthread_t msg_pthread = (pthread_t) 0;
 static time_t sent_reg_time = (time_t) 0;
 
+/*
+ * Digest of the static configuration carried by the last registration
+ * message built, and whether the controller has accepted a full
+ * registration with that configuration.  While both hold, periodic
+ * re-registrations omit the static configuration (SLURMD_REG_FLAG_SLIM)
+ * and carry only dynamic state.
+ */
+static uint64_t reg_config_digest = 0;
+static bool reg_config_acked = false;
+
+/* long-lived RPC connection to slurmctld */
+static slurm_persist_conn_t *ctld_rpc_conn = NULL;
+static time_t ctld_rpc_conn_shutdown = 0;
+
 static void      _atfork_final(void);
 static void      _atfork_prepare(void);
 static int       _convert_spec_cores(void);
 static int       _core_spec_init(void);
+static void      _ctld_rpc_conn_fini(void);
+static void      _ctld_rpc_conn_init(void);
 static void      _create_msg_socket(void);
 static void      _decrement_thd_count(void);
 static void      _destroy_conf(void);
 static int       _drain_node(char *reason);
-static void      _fill_registration_msg(slurm_node_registration_status_msg_t *);
+static void      _fill_registration_msg(slurm_node_registration_status_msg_t *,
+					 uint32_t status);
 static uint64_t  _get_int(const char *my_str);
 static void      _handle_connection(int fd, slurm_addr_t *client);
 static void      _hup_handler(int);
@@ -393,6 +411,8 @@ main (int argc, char **argv)
 			     conf->msg_aggr_window_time,
 			     conf->msg_aggr_window_msgs);
 
+	_ctld_rpc_conn_init();
+
 	slurm_thread_create_detached(NULL, _registration_engine, NULL);
 
 	_msg_engine();
@@ -418,6 +438,54 @@ main (int argc, char **argv)
        	return 0;
 }
 
+/*
+ * Open one long-lived connection to slurmctld and install it as the channel
+ * for this daemon's controller RPC traffic, amortizing the TCP connect and
+ * auth credential over the life of the daemon instead of paying them per
+ * message. Any failure here (or later on the connection) is not fatal --
+ * the send paths silently fall back to a connection per RPC, which also
+ * covers controllers too old to accept PERSIST_TYPE_RPC.
+ */
+static void _ctld_rpc_conn_init(void)
+{
+	slurm_persist_conn_t *persist_conn;
+	slurm_ctl_conf_t *cf = slurm_conf_lock();
+
+	persist_conn = xmalloc(sizeof(slurm_persist_conn_t));
+	persist_conn->cluster_name = xstrdup(cf->cluster_name);
+	persist_conn->fd = -1;
+	persist_conn->flags = PERSIST_FLAG_RECONNECT |
+			      PERSIST_FLAG_SUPPRESS_ERR;
+	persist_conn->persist_type = PERSIST_TYPE_RPC;
+	persist_conn->rem_host = xstrdup(cf->control_addr[0]);
+	persist_conn->rem_port = cf->slurmctld_port;
+	persist_conn->shutdown = &ctld_rpc_conn_shutdown;
+	persist_conn->timeout = cf->msg_timeout * 1000;
+	persist_conn->version = SLURM_PROTOCOL_VERSION;
+	slurm_conf_unlock();
+
+	if (slurm_persist_conn_open(persist_conn) != SLURM_SUCCESS) {
+		debug("%s: no persistent connection to slurmctld, using a connection per RPC",
+		      __func__);
+		slurm_persist_conn_destroy(persist_conn);
+		return;
+	}
+
+	ctld_rpc_conn = persist_conn;
+	slurm_ctld_rpc_conn_set(ctld_rpc_conn);
+	debug("opened persistent RPC connection to slurmctld");
+}
+
+static void _ctld_rpc_conn_fini(void)
+{
+	slurm_ctld_rpc_conn_set(NULL);
+	ctld_rpc_conn_shutdown = time(NULL);
+	if (ctld_rpc_conn) {
+		slurm_persist_conn_destroy(ctld_rpc_conn);
+		ctld_rpc_conn = NULL;
+	}
+}
+
 /*
  * Spawn a thread to make sure we send at least one registration message to
  * slurmctld. If slurmctld restarts, it will request another registration
@@ -646,6 +714,7 @@ extern int
 send_registration_msg(uint32_t status, bool startup)
 {
 	int ret_val = SLURM_SUCCESS;
+	bool slim_reg;
 	slurm_node_registration_status_msg_t *msg =
 		xmalloc (sizeof (slurm_node_registration_status_msg_t));
 
@@ -654,8 +723,9 @@ send_registration_msg(uint32_t status, bool startup)
 	if (get_reg_resp)
 		msg->flags |= SLURMD_REG_FLAG_RESP;
 
-	_fill_registration_msg(msg);
+	_fill_registration_msg(msg, status);
 	msg->status  = status;
+	slim_reg = (msg->flags & SLURMD_REG_FLAG_SLIM);
 
 	if (conf->msg_aggr_window_msgs > 1) {
 		slurm_msg_t *req = xmalloc_nz(sizeof(slurm_msg_t));
@@ -697,14 +767,79 @@ send_registration_msg(uint32_t status, bool startup)
 
 	}
 
-	if (ret_val == SLURM_SUCCESS)
+	if (ret_val == SLURM_SUCCESS) {
 		sent_reg_time = time(NULL);
+		reg_config_acked = true;
+	} else if (slim_reg) {
+		/*
+		 * The controller would not take an abbreviated registration
+		 * (e.g. it restarted or the node state changed under us).
+		 * Fall back to a full registration right away.
+		 */
+		debug("Abbreviated registration rejected, sending full one");
+		reg_config_acked = false;
+		return send_registration_msg(status, startup);
+	}
 fail:
 	return ret_val;
 }
 
+/* Fold a byte range into a registration configuration digest (FNV-1a) */
+static uint64_t _reg_digest_data(uint64_t digest, const void *data, size_t len)
+{
+	const unsigned char *ptr = data;
+
+	while (len--) {
+		digest ^= *ptr++;
+		digest *= 0x100000001b3;
+	}
+	return digest;
+}
+
+/* Fold a string, including its terminator so fields can not run together */
+static uint64_t _reg_digest_str(uint64_t digest, const char *str)
+{
+	if (!str)
+		str = "";
+	return _reg_digest_data(digest, str, strlen(str) + 1);
+}
+
+/*
+ * Digest of the static configuration fields of a registration message.
+ * Dynamic state (load, free memory, job list, energy) is excluded, so the
+ * digest only changes when the node configuration itself does.
+ */
+static uint64_t _reg_config_digest(slurm_node_registration_status_msg_t *msg)
+{
+	uint64_t digest = 0xcbf29ce484222325;
+
+	digest = _reg_digest_data(digest, &msg->cpus, sizeof(msg->cpus));
+	digest = _reg_digest_data(digest, &msg->boards, sizeof(msg->boards));
+	digest = _reg_digest_data(digest, &msg->sockets, sizeof(msg->sockets));
+	digest = _reg_digest_data(digest, &msg->cores, sizeof(msg->cores));
+	digest = _reg_digest_data(digest, &msg->threads, sizeof(msg->threads));
+	digest = _reg_digest_data(digest, &msg->real_memory,
+				  sizeof(msg->real_memory));
+	digest = _reg_digest_data(digest, &msg->tmp_disk,
+				  sizeof(msg->tmp_disk));
+	digest = _reg_digest_data(digest, &msg->hash_val,
+				  sizeof(msg->hash_val));
+	digest = _reg_digest_str(digest, msg->cpu_spec_list);
+	digest = _reg_digest_str(digest, msg->features_avail);
+	digest = _reg_digest_str(digest, msg->features_active);
+	digest = _reg_digest_str(digest, msg->arch);
+	digest = _reg_digest_str(digest, msg->os);
+	digest = _reg_digest_str(digest, msg->version);
+	if (msg->gres_info)
+		digest = _reg_digest_data(digest,
+					  get_buf_data(msg->gres_info),
+					  get_buf_offset(msg->gres_info));
+	return digest;
+}
+
 static void
-_fill_registration_msg(slurm_node_registration_status_msg_t *msg)
+_fill_registration_msg(slurm_node_registration_status_msg_t *msg,
+		       uint32_t status)
 {
 	List steps;
 	ListIterator i;
@@ -715,6 +850,7 @@ _fill_registration_msg(slurm_node_registration_status_msg_t *msg)
 	static bool first_msg = true;
 	static time_t slurmd_start_time = 0;
 	Buf gres_info;
+	uint64_t digest;
 
 	msg->node_name   = xstrdup (conf->node_name);
 	msg->version     = xstrdup(SLURM_VERSION_STRING);
@@ -833,6 +969,38 @@ _fill_registration_msg(slurm_node_registration_status_msg_t *msg)
 
 	msg->timestamp = time(NULL);
 
+	/*
+	 * If the controller already took a full registration with this
+	 * exact static configuration, strip it from the message and flag
+	 * the registration as abbreviated; the controller then only has
+	 * to process the dynamic state above.  Not done on startup
+	 * registrations, when reporting an error such as a prolog
+	 * failure (the controller's abbreviated path skips the state
+	 * transition logic which acts on the status), with message
+	 * aggregation (no response to detect a rejection from), or on
+	 * front end systems (the front end registration path copies
+	 * these fields to every node).
+	 */
+	digest = _reg_config_digest(msg);
+#ifndef HAVE_FRONT_END
+	if (reg_config_acked && (digest == reg_config_digest) &&
+	    (status == SLURM_SUCCESS) &&
+	    !(msg->flags & SLURMD_REG_FLAG_STARTUP) &&
+	    (conf->msg_aggr_window_msgs <= 1)) {
+		msg->flags |= SLURMD_REG_FLAG_SLIM;
+		xfree(msg->cpu_spec_list);
+		xfree(msg->features_avail);
+		xfree(msg->features_active);
+		xfree(msg->arch);
+		xfree(msg->os);
+		FREE_NULL_BUFFER(msg->gres_info);
+	}
+#endif
+	if (digest != reg_config_digest) {
+		reg_config_digest = digest;
+		reg_config_acked = false;
+	}
+
 	return;
 }
 
@@ -1808,6 +1976,7 @@ cleanup:
 static int
 _slurmd_fini(void)
 {
+	_ctld_rpc_conn_fini();
 	assoc_mgr_fini(false);
 	node_features_g_fini();
 	core_spec_g_fini();
@@ -53,13 +53,13 @@
 #include <poll.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <termios.h>
 #include <unistd.h>
 
-#include "src/common/cbuf.h"
 #include "src/common/eio.h"
 #include "src/common/fd.h"
 #include "src/common/io_hdr.h"
@@ -163,6 +163,124 @@ struct task_write_info {
 static bool _task_readable(eio_obj_t *);
 static int  _task_read(eio_obj_t *, List);
 
+/*
+ * Byte ring for task stdio between the task reader and the client
+ * writer.  Sized to a power of two so free running 32-bit head/tail
+ * counters can be masked into offsets.  The reserve/commit pair lets
+ * read(2) place task output directly into the ring with no
+ * intermediate copy, and a single producer plus single consumer can
+ * proceed without a lock (unlike the general purpose cbuf).
+ */
+typedef struct io_ring {
+	char		*buf;
+	uint32_t	 size;	/* power of two */
+	volatile uint32_t head;	/* total bytes produced */
+	volatile uint32_t tail;	/* total bytes consumed */
+} io_ring_t;
+
+static io_ring_t *_ring_create(uint32_t min_size)
+{
+	io_ring_t *ring = xmalloc(sizeof(io_ring_t));
+
+	ring->size = 1;
+	while (ring->size < min_size)
+		ring->size <<= 1;
+	ring->buf = xmalloc(ring->size);
+
+	return ring;
+}
+
+static inline uint32_t _ring_used(io_ring_t *ring)
+{
+	return ring->head - ring->tail;
+}
+
+static inline uint32_t _ring_free(io_ring_t *ring)
+{
+	return ring->size - _ring_used(ring);
+}
+
+/*
+ * Reserve the contiguous region at the producer position, up to the
+ * wrap point.  Data written there is not visible to the consumer until
+ * _ring_commit() publishes it.
+ * RET the usable length of the region at *ptr, zero if the ring is full
+ */
+static uint32_t _ring_reserve(io_ring_t *ring, char **ptr)
+{
+	uint32_t off = ring->head & (ring->size - 1);
+
+	*ptr = ring->buf + off;
+	return MIN(_ring_free(ring), ring->size - off);
+}
+
+/* Publish n bytes written to the region returned by _ring_reserve() */
+static void _ring_commit(io_ring_t *ring, uint32_t n)
+{
+	__sync_synchronize();	/* order the data before the counter */
+	ring->head += n;
+}
+
+/* Read up to len bytes, returns the number of bytes copied */
+static int _ring_read(io_ring_t *ring, char *dst, uint32_t len)
+{
+	uint32_t off, seg, n = MIN(_ring_used(ring), len);
+
+	if (n == 0)
+		return 0;
+	off = ring->tail & (ring->size - 1);
+	seg = MIN(n, ring->size - off);
+	memcpy(dst, ring->buf + off, seg);
+	if (seg < n)
+		memcpy(dst + seg, ring->buf, n - seg);
+	__sync_synchronize();	/* order the copy before the counter */
+	ring->tail += n;
+
+	return n;
+}
+
+/*
+ * Length of the first complete buffered line, or len if the line was
+ * truncated at len characters, or zero if no complete line is
+ * buffered.  Matches the cbuf_peek_line() length test, without the
+ * copy.
+ */
+static int _ring_line_len(io_ring_t *ring, uint32_t len)
+{
+	uint32_t used = _ring_used(ring), i;
+
+	for (i = 0; i < used; i++) {
+		if (i >= len)
+			return len;
+		if (ring->buf[(ring->tail + i) & (ring->size - 1)] == '\n')
+			return i + 1;
+	}
+
+	return 0;
+}
+
+/*
+ * Read as many complete lines as fit in (len - 1) characters with NUL
+ * termination, as cbuf_read_line() provided.
+ * RET bytes copied, zero if no complete line fits (nothing consumed)
+ */
+static int _ring_read_line(io_ring_t *ring, char *dst, uint32_t len)
+{
+	uint32_t max = MIN(_ring_used(ring), len - 1);
+	uint32_t i, n = 0;
+
+	for (i = 0; i < max; i++) {
+		if (ring->buf[(ring->tail + i) & (ring->size - 1)] == '\n')
+			n = i + 1;
+	}
+	if (n == 0)
+		return 0;
+	(void) _ring_read(ring, dst, n);
+	dst[n] = '\0';
+
+	return n;
+}
+
 struct io_operations task_read_ops = {
 	.readable = &_task_readable,
 	.handle_read = &_task_read,
@@ -177,9 +295,10 @@ struct task_read_info {
 	uint16_t         gtaskid;
 	uint16_t         ltaskid;
 	stepd_step_rec_t    *job;		 /* pointer back to job data   */
-	cbuf_t           buf;
+	struct io_ring  *buf;
 	bool		 eof;
 	bool		 eof_msg_sent;
+	int		 is_pipe;	/* -1 until checked, splice path */
 };
 
 /**********************************************************************
@@ -202,7 +321,8 @@ static void *_io_thr(void *);
 static int _send_io_init_msg(int sock, srun_key_t *key, stepd_step_rec_t *job);
 static void _send_eof_msg(struct task_read_info *out);
 static struct io_buf *_task_build_message(struct task_read_info *out,
-					  stepd_step_rec_t *job, cbuf_t cbuf);
+					  stepd_step_rec_t *job,
+					  io_ring_t *ring);
 static void *_io_thr(void *arg);
 static void _route_msg_task_to_client(eio_obj_t *obj);
 static void _free_outgoing_msg(struct io_buf *msg, stepd_step_rec_t *job);
@@ -719,17 +839,174 @@ _create_task_out_eio(int fd, uint16_t type,
 	out->gtaskid = task->gtid;
 	out->ltaskid = task->id;
 	out->job = job;
-	out->buf = cbuf_create(MAX_MSG_LEN, MAX_MSG_LEN*4);
+	out->buf = _ring_create(MAX_MSG_LEN * 4);
 	out->eof = false;
 	out->eof_msg_sent = false;
-	if (cbuf_opt_set(out->buf, CBUF_OPT_OVERWRITE, CBUF_NO_DROP) == -1)
-		error("setting cbuf options");
+	out->is_pipe = -1;
 
 	eio = eio_obj_create(fd, &task_read_ops, (void *)out);
 
 	return eio;
 }
 
+#if defined(__linux__)
+/* Wait for fd to accept more data, used only on the splice fast path */
+static void _wait_writable(int fd)
+{
+	struct pollfd pfd;
+
+	pfd.fd = fd;
+	pfd.events = POLLOUT;
+	(void) poll(&pfd, 1, -1);
+}
+
+/*
+ * Zero-copy fast path for task output: when there is exactly one
+ * unlabelled socket client and nothing buffered ahead of us, frame the
+ * bytes sitting in the task's stdio pipe with an io_hdr written by
+ * write(2) and move the payload with splice(2), kernel to kernel,
+ * without ever copying it into the cbuf or an io_buf.
+ *
+ * Spliced data bypasses the outgoing message cache, so a client
+ * attaching later (sattach) picks up at the current stream position
+ * instead of replaying cached output.
+ *
+ * RET true if this readable event was fully handled here, false to
+ * fall back to the regular cbuf/message path.
+ */
+static bool _task_splice(eio_obj_t *obj, struct task_read_info *out)
+{
+	stepd_step_rec_t *job = out->job;
+	struct client_io_info *client;
+	eio_obj_t *client_eio;
+	struct slurm_io_header header;
+	char hdr_buf[64];
+	Buf packbuf;
+	struct stat st;
+	bool spliced = false;
+	int avail, n, hdr_len;
+	ssize_t sent;
+	size_t off;
+
+	if (job->flags & LAUNCH_BUFFERED_IO)
+		return false;
+	if (_ring_used(out->buf) > 0)	/* keep the stream ordered */
+		return false;
+	if (list_count(job->clients) != 1)
+		return false;
+	client_eio = list_peek(job->clients);
+	client = (struct client_io_info *)client_eio->arg;
+	xassert(client->magic == CLIENT_IO_MAGIC);
+	if (client->is_local_file || client->labelio || client->out_eof)
+		return false;
+	if (client->out_msg || !list_is_empty(client->msg_queue))
+		return false;
+	if ((out->type == SLURM_IO_STDOUT) &&
+	    (client->ltaskid_stdout != -1) &&
+	    (client->ltaskid_stdout != out->ltaskid))
+		return false;
+	if ((out->type == SLURM_IO_STDERR) &&
+	    (client->ltaskid_stderr != -1) &&
+	    (client->ltaskid_stderr != out->ltaskid))
+		return false;
+
+	if (out->is_pipe == -1) {
+		/* splice(2) requires a pipe, ptys take the regular path */
+		if (fstat(obj->fd, &st) < 0)
+			out->is_pipe = 0;
+		else
+			out->is_pipe = S_ISFIFO(st.st_mode) ? 1 : 0;
+	}
+	if (!out->is_pipe)
+		return false;
+
+	/*
+	 * The wire protocol caps a frame at MAX_MSG_LEN, so drain the
+	 * pipe one frame at a time.  The frame length must be known
+	 * before the header is written, hence FIONREAD.
+	 */
+	while (true) {
+		if (ioctl(obj->fd, FIONREAD, &avail) < 0)
+			break;
+		if (avail <= 0)	/* EOF is left to the regular path */
+			break;
+		n = MIN(avail, MAX_MSG_LEN);
+
+		/* frame the chunk exactly as _task_build_message() does */
+		header.type = out->type;
+		header.ltaskid = out->ltaskid;
+		header.gtaskid = out->gtaskid;
+		header.length = n;
+		packbuf = create_buf(hdr_buf, io_hdr_packed_size());
+		if (!packbuf)
+			break;
+		io_hdr_pack(&header, packbuf);
+		hdr_len = get_buf_offset(packbuf);
+		/* free the Buf packbuf, but not the stack space it packed */
+		packbuf->head = NULL;
+		free_buf(packbuf);
+
+		/*
+		 * Once any part of the header is on the wire the whole
+		 * frame must follow, even if the socket briefly blocks.
+		 * Before that point we can stop cleanly; the data stays
+		 * in the pipe and eio calls us again.
+		 */
+		off = 0;
+		while (off < hdr_len) {
+			sent = write(client_eio->fd, hdr_buf + off,
+				     hdr_len - off);
+			if (sent < 0) {
+				if (errno == EINTR)
+					continue;
+				if (((errno == EAGAIN) ||
+				     (errno == EWOULDBLOCK)) && (off == 0))
+					return spliced;
+				if ((errno == EAGAIN) ||
+				    (errno == EWOULDBLOCK)) {
+					_wait_writable(client_eio->fd);
+					continue;
+				}
+				client->out_eof = true;
+				_free_all_outgoing_msgs(client->msg_queue,
+							job);
+				return spliced;
+			}
+			off += sent;
+		}
+
+		off = 0;
+		while (off < n) {
+			sent = splice(obj->fd, NULL, client_eio->fd, NULL,
+				      n - off, SPLICE_F_MORE);
+			if (sent < 0) {
+				if (errno == EINTR)
+					continue;
+				if ((errno == EAGAIN) ||
+				    (errno == EWOULDBLOCK)) {
+					_wait_writable(client_eio->fd);
+					continue;
+				}
+			}
+			if (sent <= 0) {
+				/* header promised n bytes, stream broken */
+				error("splice to io client failed: %m");
+				client->out_eof = true;
+				_free_all_outgoing_msgs(client->msg_queue,
+							job);
+				return true;
+			}
+			off += sent;
+		}
+		debug5("spliced %d bytes from task %d %s", n, out->gtaskid,
+		       out->type == SLURM_IO_STDOUT ? "STDOUT" : "STDERR");
+		spliced = true;
+	}
+
+	return spliced;
+}
+#endif	/* __linux__ */
+
 static bool
 _task_readable(eio_obj_t *obj)
 {
@@ -742,8 +1019,8 @@ _task_readable(eio_obj_t *obj)
 		debug5("  false, eof message sent");
 		return false;
 	}
-	if (cbuf_free(out->buf) > 0) {
-		debug5("  cbuf_free = %d", cbuf_free(out->buf));
+	if (_ring_free(out->buf) > 0) {
+		debug5("  ring free = %u", _ring_free(out->buf));
 		return true;
 	}
 
@@ -752,37 +1029,47 @@ _task_readable(eio_obj_t *obj)
 }
 
 /*
- * Read output (stdout or stderr) from a task into a cbuf.  The cbuf
- * allows whole lines to be packed into messages if line buffering
- * is requested.
+ * Read output (stdout or stderr) from a task directly into its output
+ * ring.  The ring allows whole lines to be packed into messages if
+ * line buffering is requested.
  */
 static int
 _task_read(eio_obj_t *obj, List objs)
 {
 	struct task_read_info *out = (struct task_read_info *)obj->arg;
-	int len;
+	char *ptr;
+	int len, nread = 0;
 	int rc = -1;
 
 	xassert(out->magic == TASK_OUT_MAGIC);
 
 	debug4("Entering _task_read for obj %zx", (size_t)obj);
-	len = cbuf_free(out->buf);
-	if (len > 0 && !out->eof) {
-again:
-		if ((rc = cbuf_write_from_fd(out->buf, obj->fd, len, NULL))
-		    < 0) {
+#if defined(__linux__)
+	if (_task_splice(obj, out))
+		return SLURM_SUCCESS;
+#endif
+	while (!out->eof && ((len = _ring_reserve(out->buf, &ptr)) > 0)) {
+		rc = read(obj->fd, ptr, len);
+		if (rc < 0) {
 			if (errno == EINTR)
-				goto again;
+				continue;
 			if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
 				debug5("_task_read returned EAGAIN");
-				return SLURM_SUCCESS;
+				if (nread == 0)
+					return SLURM_SUCCESS;
+				break;
 			}
 			debug5("  error in _task_read: %m");
 		}
 		if (rc <= 0) {  /* got eof */
 			debug5("  got eof on task");
 			out->eof = true;
+			break;
 		}
+		_ring_commit(out->buf, rc);
+		nread += rc;
+		if (rc < len)	/* drained the descriptor */
+			break;
 	}
 
 	debug5("************************ %d bytes read from task %s", rc,
@@ -796,7 +1083,7 @@ again:
 	/*
 	 * Send the eof message
 	 */
-	if (cbuf_used(out->buf) == 0 && out->eof && !out->eof_msg_sent) {
+	if (_ring_used(out->buf) == 0 && out->eof && !out->eof_msg_sent) {
 		_send_eof_msg(out);
 	}
 
@@ -1296,9 +1583,9 @@ _route_msg_task_to_client(eio_obj_t *obj)
 	ListIterator clients;
 
 	/* Pack task output into messages for transfer to a client */
-	while (cbuf_used(out->buf) > 0
+	while (_ring_used(out->buf) > 0
 	       && _outgoing_buf_free(out->job)) {
-		debug5("cbuf_used = %d", cbuf_used(out->buf));
+		debug5("ring used = %u", _ring_used(out->buf));
 		msg = _task_build_message(out, out->job, out->buf);
 		if (msg == NULL)
 			return;
@@ -1789,7 +2076,8 @@ _send_eof_msg(struct task_read_info *out)
 
 
 static struct io_buf *
-_task_build_message(struct task_read_info *out, stepd_step_rec_t *job, cbuf_t cbuf)
+_task_build_message(struct task_read_info *out, stepd_step_rec_t *job,
+		    io_ring_t *ring)
 {
 	struct io_buf *msg;
 	char *ptr;
@@ -1811,10 +2099,10 @@ _task_build_message(struct task_read_info *out, stepd_step_rec_t *job, cbuf_t cb
 	ptr = msg->data + io_hdr_packed_size();
 
 	if (buffered_stdio) {
-		avail = cbuf_peek_line(cbuf, ptr, MAX_MSG_LEN, 1);
+		avail = _ring_line_len(ring, MAX_MSG_LEN);
 		if (avail >= MAX_MSG_LEN)
 			must_truncate = true;
-		else if (avail == 0 && cbuf_used(cbuf) >= MAX_MSG_LEN)
+		else if (avail == 0 && _ring_used(ring) >= MAX_MSG_LEN)
 			must_truncate = true;
 	}
 
@@ -1829,9 +2117,9 @@ _task_build_message(struct task_read_info *out, stepd_step_rec_t *job, cbuf_t cb
 	 * Hence the "|| out->eof".
 	 */
 	if (must_truncate || !buffered_stdio || out->eof) {
-		n = cbuf_read(cbuf, ptr, MAX_MSG_LEN);
+		n = _ring_read(ring, ptr, MAX_MSG_LEN);
 	} else {
-		n = cbuf_read_line(cbuf, ptr, MAX_MSG_LEN, -1);
+		n = _ring_read_line(ring, ptr, MAX_MSG_LEN);
 		if (n == 0) {
 			debug5("  partial line in buffer, ignoring");
 			debug4("Leaving  _task_build_message");
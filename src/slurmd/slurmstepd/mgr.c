@@ -1779,6 +1779,12 @@ _fork_all_tasks(stepd_step_rec_t *job, bool *io_initialized)
 
 	exec_wait_list = list_create ((ListDelF) _exec_wait_info_destroy);
 
+	/*
+	 * Build the shared parts of the task environment once, the forked
+	 * tasks inherit them below.
+	 */
+	exec_task_prepare(job);
+
 	/*
 	 * Fork all of the task processes.
 	 */
@@ -348,13 +348,36 @@ _setup_mpi(stepd_step_rec_t *job, int ltaskid)
 	return mpi_hook_slurmstepd_task(info, &job->env);
 }
 
+/*
+ *  Precompute the parts of the task environment which are identical for
+ *  every task on the node, so the forked tasks inherit them instead of
+ *  each rebuilding them.  The global task id list in particular grows
+ *  with the task count, making the per-task rebuild quadratic at high
+ *  tasks per node.  Called once by the parent before the tasks are
+ *  spawned.
+ */
+extern void exec_task_prepare(stepd_step_rec_t *job)
+{
+	uint32_t *gtids;		/* pointer to array of ranks */
+	int j;
+	uint32_t task_offset = 0;
+
+	if (job->pack_task_offset != NO_VAL)
+		task_offset = job->pack_task_offset;
+
+	gtids = xmalloc(job->node_tasks * sizeof(uint32_t));
+	for (j = 0; j < job->node_tasks; j++)
+		gtids[j] = job->task[j]->gtid + task_offset;
+	job->envtp->sgtids = _uint32_array_to_str(job->node_tasks, gtids);
+	xfree(gtids);
+}
+
 /*
  *  Current process is running as the user when this is called.
  */
 extern void exec_task(stepd_step_rec_t *job, int local_proc_id)
 {
-	uint32_t *gtids;		/* pointer to array of ranks */
-	int fd, j;
+	int fd;
 	stepd_step_task_info_t *task = job->task[local_proc_id];
 	char **tmp_env;
 	int saved_errno;
@@ -365,11 +388,8 @@ extern void exec_task(stepd_step_rec_t *job, int local_proc_id)
 	if (job->pack_task_offset != NO_VAL)
 		task_offset = job->pack_task_offset;
 
-	gtids = xmalloc(job->node_tasks * sizeof(uint32_t));
-	for (j = 0; j < job->node_tasks; j++)
-		gtids[j] = job->task[j]->gtid + task_offset;
-	job->envtp->sgtids = _uint32_array_to_str(job->node_tasks, gtids);
-	xfree(gtids);
+	if (!job->envtp->sgtids)	/* normally set by exec_task_prepare */
+		exec_task_prepare(job);
 
 	if (job->pack_jobid != NO_VAL)
 		job->envtp->jobid = job->pack_jobid;
@@ -45,6 +45,7 @@
 
 #include "src/slurmd/slurmstepd/slurmstepd_job.h"
 
+void exec_task_prepare(stepd_step_rec_t *job);
 void exec_task(stepd_step_rec_t *job, int i);
 
 #endif /* !_TASK_H */
@@ -149,8 +149,8 @@ static int _x11_socket_read(eio_obj_t *obj, List objs)
 	slurm_free_msg_members(&resp);
 
 	/* setup eio to handle both sides of the connection now */
-	e1 = eio_obj_create(*local, &half_duplex_ops, remote);
-	e2 = eio_obj_create(*remote, &half_duplex_ops, local);
+	e1 = half_duplex_obj_create(*local, remote);
+	e2 = half_duplex_obj_create(*remote, local);
 	eio_new_obj(eio_handle, e1);
 	eio_new_obj(eio_handle, e2);
 
@@ -556,11 +556,16 @@ proc_req(void *conn, persist_msg_t *msg,
 		      slurmdbd_conn->conn->fd,
 		      slurmdbd_msg_type_2_str(msg->msg_type, 1));
 	else if (slurmdbd_conn->conn->rem_port
-		 && !slurmdbd_conf->commit_delay) {
+		 && !slurmdbd_conf->commit_delay
+		 && !slurmdbd_conn->in_mult_msg) {
 		/* If we are dealing with the slurmctld do the
 		   commit (SUCCESS or NOT) afterwards since we
 		   do transactions for performance reasons.
 		   (don't ever use autocommit with innodb)
+		   Records bundled in a DBD_SEND_MULT_MSG are group
+		   committed by _send_mult_msg() instead; they are all
+		   acked together in its reply, so one fsync covers the
+		   whole bundle.
 		*/
 		acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
 	}
@@ -587,8 +592,21 @@ proc_req(void *conn, persist_msg_t *msg,
 	}
 
 	if (rpc_type_index >= 0) {
+		uint64_t usec = DELTA_TIMER;
+		int bucket = 0;
+
 		rpc_stats.rpc_type_cnt[rpc_type_index]++;
-		rpc_stats.rpc_type_time[rpc_type_index] += DELTA_TIMER;
+		rpc_stats.rpc_type_time[rpc_type_index] += usec;
+		if (rpc_stats.rpc_type_time_max[rpc_type_index] < usec)
+			rpc_stats.rpc_type_time_max[rpc_type_index] = usec;
+		while ((usec > 1) &&
+		       (bucket < (rpc_stats.rpc_type_hist_size - 1))) {
+			usec >>= 1;
+			bucket++;
+		}
+		rpc_stats.rpc_type_hist[(rpc_type_index *
+					 rpc_stats.rpc_type_hist_size) +
+					bucket]++;
 	}
 	if (rpc_user_index >= 0) {
 		rpc_stats.rpc_user_cnt[rpc_user_index]++;
@@ -3308,6 +3326,14 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 
 	list_msg.my_list = list_create(slurmdbd_free_buffer);
 	/* START_TIMER; */
+
+	/* Group commit the whole bundle.  The per-message commit in
+	 * proc_req() made an array-job storm pay one innodb fsync per
+	 * record even though every record in the bundle is acked
+	 * together in the reply built below.
+	 */
+	slurmdbd_conn->in_mult_msg = true;
+
 	itr = list_iterator_create(get_msg->my_list);
 	while ((req_buf = list_next(itr))) {
 		persist_msg_t sub_msg;
@@ -3330,6 +3356,13 @@ static int   _send_mult_msg(slurmdbd_conn_t *slurmdbd_conn,
 			break;
 	}
 	list_iterator_destroy(itr);
+
+	slurmdbd_conn->in_mult_msg = false;
+	if (slurmdbd_conn->conn->rem_port && !slurmdbd_conf->commit_delay) {
+		/* As with single messages, commit SUCCESS or NOT so a
+		 * failure does not leave the transaction open. */
+		acct_storage_g_commit(slurmdbd_conn->db_conn, 1);
+	}
 	/* END_TIMER; */
 	/* info("%d multi took %s", list_count(get_msg->my_list), TIME_STR); */
 
@@ -3490,6 +3523,7 @@ static int  _get_stats(slurmdbd_conn_t *slurmdbd_conn,
 {
 	int rc = SLURM_SUCCESS;
 	char *comment = NULL;
+	bool clear_sql;
 
 	if (!_validate_super_user(*uid, slurmdbd_conn)) {
 		comment = "Your user doesn't have privilege to perform this action";
@@ -3502,6 +3536,11 @@ static int  _get_stats(slurmdbd_conn_t *slurmdbd_conn,
 	}
 
 	info("Get stats request received from UID %u", *uid);
+	/* Per SQL statement timing is free form text, so it goes to the
+	 * log on the server rather than over the wire */
+	clear_sql = false;
+	acct_storage_g_get_data(slurmdbd_conn->db_conn,
+				ACCT_STORAGE_INFO_QUERY_STATS, &clear_sql);
 	*out_buffer = init_buf(32 * 1024);
 	pack16((uint16_t) DBD_GOT_STATS, *out_buffer);
 	slurm_mutex_lock(&rpc_mutex);
@@ -3517,6 +3556,7 @@ static int  _clear_stats(slurmdbd_conn_t *slurmdbd_conn,
 {
 	int i, rc = SLURM_SUCCESS;
 	char *comment = NULL;
+	bool clear_sql;
 
 	if (!_validate_super_user(*uid, slurmdbd_conn)) {
 		comment = "Your user doesn't have privilege to perform this action";
@@ -3539,13 +3579,21 @@ static int  _clear_stats(slurmdbd_conn_t *slurmdbd_conn,
 	for (i = 0; i < rpc_stats.type_cnt; i++) {
 		rpc_stats.rpc_type_cnt[i] = 0;
 		rpc_stats.rpc_type_time[i] = 0;
+		rpc_stats.rpc_type_time_max[i] = 0;
 	}
+	memset(rpc_stats.rpc_type_hist, 0,
+	       sizeof(uint32_t) * rpc_stats.type_cnt *
+	       rpc_stats.rpc_type_hist_size);
 	for (i = 0; i < rpc_stats.user_cnt; i++) {
 		rpc_stats.rpc_user_cnt[i] = 0;
 		rpc_stats.rpc_user_time[i] = 0;
 	}
 	slurm_mutex_unlock(&rpc_mutex);
 
+	clear_sql = true;
+	acct_storage_g_get_data(slurmdbd_conn->db_conn,
+				ACCT_STORAGE_INFO_QUERY_STATS, &clear_sql);
+
 	*out_buffer = slurm_persist_make_rc_msg(slurmdbd_conn->conn,
 						rc, comment, DBD_CLEAR_STATS);
 	return rc;
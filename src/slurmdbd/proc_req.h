@@ -46,6 +46,9 @@
 typedef struct {
 	slurm_persist_conn_t *conn;
 	void *db_conn; /* database connection */
+	bool in_mult_msg; /* processing part of a DBD_SEND_MULT_MSG bundle,
+			   * commit once for the bundle instead of per
+			   * sub-message */
 	char *tres_str;
 } slurmdbd_conn_t;
 
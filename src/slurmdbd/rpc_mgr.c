@@ -104,7 +104,10 @@ extern void *rpc_mgr(void *no_data)
 		conn_arg = xmalloc(sizeof(slurmdbd_conn_t));
 		conn_arg->conn = xmalloc(sizeof(slurm_persist_conn_t));
 		conn_arg->conn->fd = newsockfd;
-		conn_arg->conn->flags = PERSIST_FLAG_DBD;
+		/* PARKABLE: idle clients are polled off their service
+		 * threads so they do not pin thread slots */
+		conn_arg->conn->flags = PERSIST_FLAG_DBD |
+			PERSIST_FLAG_PARKABLE;
 		conn_arg->conn->callback_proc = proc_req;
 		conn_arg->conn->callback_fini = _connection_fini_callback;
 		conn_arg->conn->shutdown = &shutdown_time;
@@ -363,6 +363,13 @@ static void _init_dbd_stats(void)
 		xmalloc(sizeof(uint32_t) * rpc_stats.type_cnt);
 	rpc_stats.rpc_type_time =
 		xmalloc(sizeof(uint64_t) * rpc_stats.type_cnt);
+	rpc_stats.rpc_type_time_max =
+		xmalloc(sizeof(uint64_t) * rpc_stats.type_cnt);
+	/* Power of two microsecond latency buckets, last is overflow */
+	rpc_stats.rpc_type_hist_size = 24;
+	rpc_stats.rpc_type_hist =
+		xmalloc(sizeof(uint32_t) * rpc_stats.type_cnt *
+			rpc_stats.rpc_type_hist_size);
 
 	rpc_stats.user_cnt = 200;  /* Capture info for first 200 RPC users */
 	rpc_stats.rpc_user_id   =
@@ -383,9 +390,12 @@ static void _free_dbd_stats(void)
 	xfree(rpc_stats.rollup_max_time);
 
 	rpc_stats.type_cnt = 0;
+	rpc_stats.rpc_type_hist_size = 0;
 	xfree(rpc_stats.rpc_type_id);
 	xfree(rpc_stats.rpc_type_cnt);
+	xfree(rpc_stats.rpc_type_hist);
 	xfree(rpc_stats.rpc_type_time);
+	xfree(rpc_stats.rpc_type_time_max);
 
 	rpc_stats.user_cnt = 0;
 	xfree(rpc_stats.rpc_user_id);
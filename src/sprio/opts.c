@@ -58,6 +58,7 @@
 #define OPT_LONG_LOCAL     0x102
 #define OPT_LONG_SIBLING   0x103
 #define OPT_LONG_FEDR      0x104
+#define OPT_LONG_SUMMARIZE 0x105
 
 /* FUNCTIONS */
 static List  _build_job_list( char* str );
@@ -122,6 +123,7 @@ parse_command_line( int argc, char* *argv )
 		{"local",      no_argument,       0, OPT_LONG_LOCAL},
 		{"sib",        no_argument,       0, OPT_LONG_SIBLING},
 		{"sibling",    no_argument,       0, OPT_LONG_SIBLING},
+		{"summarize",  no_argument,       0, OPT_LONG_SUMMARIZE},
 		{"usage",      no_argument,       0, OPT_LONG_USAGE},
 		{NULL,         0,                 0, 0}
 	};
@@ -201,6 +203,9 @@ parse_command_line( int argc, char* *argv )
 		case OPT_LONG_SIBLING:
 			params.sibling = true;
 			break;
+		case OPT_LONG_SUMMARIZE:
+			params.summarize = true;
+			break;
 		case OPT_LONG_USAGE:
 			_usage();
 			exit(0);
@@ -553,7 +558,7 @@ _build_user_list(char* str)
 static void _usage(void)
 {
 	printf("Usage: sprio [-j jid[s]] [-u user_name[s]] [-o format] [-p partitions]\n");
-	printf("   [--federation] [--local] [--sibling] [--usage] [-hlnvVw]\n");
+	printf("   [--federation] [--local] [--sibling] [--summarize] [--usage] [-hlnvVw]\n");
 }
 
 static void _help(void)
@@ -573,6 +578,8 @@ Usage: sprio [OPTIONS]\n\
   -n, --norm                      display normalized values\n\
   -o, --format=format             format specification\n\
       --sibling                   display job records separately for each federation cluster\n\
+      --summarize                 display one line per user with the job count\n\
+                                  and min/avg/max weighted priority\n\
   -p, --partition=partition_name  comma separated list of partitions\n\
   -u, --user=user_name            comma separated list of users to view\n\
   -v, --verbose                   verbosity level\n\
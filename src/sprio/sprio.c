@@ -45,7 +45,9 @@
 #include <termios.h>
 #include <sys/ioctl.h>
 
+#include "src/common/macros.h"
 #include "src/common/slurm_priority.h"
+#include "src/common/uid.h"
 #include "src/common/xstring.h"
 #include "src/sprio/sprio.h"
 
@@ -62,6 +64,77 @@ uint32_t weight_part; /* weight for Partition factor */
 uint32_t weight_qos; /* weight for QOS factor */
 char    *weight_tres; /* weights for TRES factors */
 
+typedef struct {
+	uint32_t user_id;
+	uint32_t job_cnt;
+	double min_prio;
+	double max_prio;
+	double sum_prio;
+} user_summary_t;
+
+static void _summary_del(void *x)
+{
+	xfree(x);
+}
+
+static int _match_summary(void *x, void *key)
+{
+	user_summary_t *summary = (user_summary_t *) x;
+	priority_factors_object_t *prio_factors =
+		(priority_factors_object_t *) key;
+
+	if (summary->user_id == prio_factors->user_id)
+		return 1;
+	return 0;
+}
+
+/*
+ * Print one line per user with the pending job count and the minimum,
+ * average and maximum weighted priority of that user's jobs.
+ */
+static void _print_summary(List factors_list)
+{
+	List summary_list = list_create(_summary_del);
+	ListIterator itr;
+	priority_factors_object_t *prio_factors;
+	user_summary_t *summary;
+	double priority;
+
+	itr = list_iterator_create(factors_list);
+	while ((prio_factors = list_next(itr))) {
+		priority = get_priority_from_factors(prio_factors);
+		summary = list_find_first(summary_list, _match_summary,
+					  prio_factors);
+		if (!summary) {
+			summary = xmalloc(sizeof(user_summary_t));
+			summary->user_id = prio_factors->user_id;
+			summary->min_prio = priority;
+			summary->max_prio = priority;
+			list_append(summary_list, summary);
+		}
+		summary->job_cnt++;
+		summary->sum_prio += priority;
+		summary->min_prio = MIN(summary->min_prio, priority);
+		summary->max_prio = MAX(summary->max_prio, priority);
+	}
+	list_iterator_destroy(itr);
+
+	if (!params.no_header)
+		printf("%10s %8s %12s %12s %12s\n", "USER", "JOBS",
+		       "MIN_PRIO", "AVG_PRIO", "MAX_PRIO");
+	itr = list_iterator_create(summary_list);
+	while ((summary = list_next(itr))) {
+		char *user_name = uid_to_string((uid_t) summary->user_id);
+		printf("%10s %8u %12.0f %12.0f %12.0f\n", user_name,
+		       summary->job_cnt, summary->min_prio,
+		       summary->sum_prio / summary->job_cnt,
+		       summary->max_prio);
+		xfree(user_name);
+	}
+	list_iterator_destroy(itr);
+	FREE_NULL_LIST(summary_list);
+}
+
 int main (int argc, char **argv)
 {
 	char *prio_type = NULL;
@@ -132,6 +205,15 @@ int main (int argc, char **argv)
 		exit(error_code);
 	}
 
+	if (params.summarize) {
+		if (resp_msg && resp_msg->priority_factors_list &&
+		    list_count(resp_msg->priority_factors_list))
+			_print_summary(resp_msg->priority_factors_list);
+		else
+			printf("No pending jobs found\n");
+		exit(error_code);
+	}
+
 	if (params.format == NULL) {
 		if (params.normalized) {
 			if (params.long_list) {
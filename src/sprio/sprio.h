@@ -65,6 +65,7 @@ struct sprio_parameters {
 	bool no_header;
 	bool normalized;
 	bool sibling;
+	bool summarize;
 	bool weights;
 
 	int  verbose;
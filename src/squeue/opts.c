@@ -64,6 +64,7 @@
 #define OPT_LONG_LOCAL        0x106
 #define OPT_LONG_SIBLING      0x107
 #define OPT_LONG_FEDR         0x108
+#define OPT_LONG_WATCH        0x109
 
 /* FUNCTIONS */
 static List  _build_job_list( char* str );
@@ -128,6 +129,7 @@ parse_command_line( int argc, char* *argv )
 		{"steps",      optional_argument, 0, 's'},
 		{"states",     required_argument, 0, 't'},
 		{"usage",      no_argument,       0, OPT_LONG_USAGE},
+		{"watch",      no_argument,       0, OPT_LONG_WATCH},
 		{"user",       required_argument, 0, 'u'},
 		{"users",      required_argument, 0, 'u'},
 		{"verbose",    no_argument,       0, 'v'},
@@ -343,12 +345,22 @@ parse_command_line( int argc, char* *argv )
 		case OPT_LONG_USAGE:
 			_usage();
 			exit(0);
+		case OPT_LONG_WATCH:
+			params.watch_flag = true;
+			break;
 		}
 	}
 
 	if (params.long_list && params.format)
 		fatal("Options -o(--format) and -l(--long) are mutually exclusive. Please remove one and retry.");
 
+	if (params.watch_flag) {
+		if (params.clusters)
+			fatal("Options --watch and --clusters are mutually exclusive. Please remove one and retry.");
+		if (!params.iterate)
+			params.iterate = 2;
+	}
+
 	if (!override_format_env) {
 		if ((env_val = getenv("SQUEUE_FORMAT")))
 			params.format = xstrdup(env_val);
@@ -1843,6 +1855,7 @@ _print_options(void)
 	printf( "reservation = %s\n", params.reservation ) ;
 	printf( "sibling      = %s\n", params.sibling_flag ? "true" : "false");
 	printf( "sort        = %s\n", params.sort ) ;
+	printf( "watch       = %s\n", params.watch_flag ? "true" : "false");
 	printf( "start_flag  = %d\n", params.start_flag );
 	printf( "states      = %s\n", params.states ) ;
 	printf( "step_flag   = %d\n", params.step_flag );
@@ -2208,6 +2221,10 @@ Usage: squeue [OPTIONS]\n\
       --name=job_name(s)          comma separated list of job names to view\n\
   -v, --verbose                   verbosity level\n\
   -V, --version                   output version information and exit\n\
+      --watch                     periodically redraw the job table, only\n\
+				  refetching and repainting it when the\n\
+				  controller reports a change (implies\n\
+				  --iterate=2 unless -i is also given)\n\
   -w, --nodelist=hostlist         list of nodes to view, default is \n\
 				  all nodes\n\
 \nHelp options:\n\
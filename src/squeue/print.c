@@ -74,6 +74,58 @@ static int _print_step_from_format(void *x, void *arg);
 
 static partition_info_msg_t *part_info_msg = NULL;
 
+/*****************************************************************************
+ * Output buffering
+ *
+ * Every field print function funnels through the helpers below, which
+ * append into a single growing output buffer instead of making one
+ * stdio call per field (plus one per padding blank).  The buffer is
+ * written out in large chunks, so printing a job costs a handful of
+ * memcpy() calls rather than dozens of locked printf() calls.
+ *****************************************************************************/
+#define OUT_BUF_FLUSH_SIZE (64 * 1024)
+
+static char *out_buf = NULL;
+static size_t out_buf_len = 0;
+static size_t out_buf_size = 0;
+
+static void _out_flush(void)
+{
+	if (out_buf_len) {
+		(void) fwrite(out_buf, 1, out_buf_len, stdout);
+		out_buf_len = 0;
+	}
+}
+
+static int _out_mem(const char *str, int len)
+{
+	if ((out_buf_len + len) > out_buf_size) {
+		out_buf_size = MAX(out_buf_size * 2,
+				   out_buf_len + len + OUT_BUF_FLUSH_SIZE);
+		out_buf = xrealloc(out_buf, out_buf_size);
+	}
+	memcpy(out_buf + out_buf_len, str, len);
+	out_buf_len += len;
+	return len;
+}
+
+static int _out_append(const char *str)
+{
+	return _out_mem(str, strlen(str));
+}
+
+static void _out_char(char c)
+{
+	(void) _out_mem(&c, 1);
+}
+
+static void _out_newline(void)
+{
+	_out_char('\n');
+	if (out_buf_len >= OUT_BUF_FLUSH_SIZE)
+		_out_flush();
+}
+
 /*****************************************************************************
  * Global Print Functions
  *****************************************************************************/
@@ -126,6 +178,7 @@ int print_jobs_array(job_info_t * jobs, int size, List format)
 
 	/* Print the jobs of interest */
 	list_for_each(l, _print_job_from_format, format);
+	_out_flush();
 	FREE_NULL_LIST(l);
 
 	return SLURM_SUCCESS;
@@ -155,6 +208,7 @@ int print_steps_array(job_step_info_t * steps, int size, List format)
 		list_for_each(step_list, _print_step_from_format, format);
 		FREE_NULL_LIST(step_list);
 	}
+	_out_flush();
 
 	return SLURM_SUCCESS;
 }
@@ -296,36 +350,31 @@ static void _part_state_load(void)
 
 static int _print_str(char *str, int width, bool right, bool cut_output)
 {
-	char format[64];
+	int len = strlen(str);
 	int printed = 0;
 
-	if (right == true && width > 0)
-		snprintf(format, 64, "%%%ds", width);
-	else if (width > 0)
-		snprintf(format, 64, "%%.%ds", width);
-	else if (width < 0) {
-		format[0] = '%';
-		format[1] = 's';
-		format[2] = ' ';
-		format[3] = '\0';
-	} else if (width == 0) {
-		format[0] = '%';
-		format[1] = 's';
-		format[2] = '\0';
-	}
-
-	if ((width <= 0) || (cut_output == false) ) {
-		if ((printed = printf(format, str)) < 0)
-			return printed;
+	if ((right == true) && (width > 0)) {
+		if (cut_output && (len > width)) {
+			printed = _out_mem(str, width);
+		} else {
+			while (printed < (width - len)) {
+				_out_char(' ');
+				printed++;
+			}
+			printed += _out_mem(str, len);
+		}
+	} else if (width > 0) {
+		printed = _out_mem(str, MIN(len, width));
+	} else if (width < 0) {
+		printed = _out_mem(str, len);
+		_out_char(' ');
+		printed++;
 	} else {
-		char temp[width + 1];
-		snprintf(temp, width + 1, format, str);
-		if ((printed = printf("%s",temp)) < 0)
-			return printed;
+		printed = _out_mem(str, len);
 	}
 
 	while (printed++ < width)
-		printf(" ");
+		_out_char(' ');
 
 	return printed;
 }
@@ -396,26 +445,50 @@ int _print_time(time_t t, int level, int width, bool right)
 /*****************************************************************************
  * Job Print Functions
  *****************************************************************************/
+/*
+ * Compile a format List into a flat array of its entries, so the per-job
+ * and per-step print loops below do not create a list iterator (an
+ * allocation) for every record printed.  The format is parsed once at
+ * startup and never changes afterwards.
+ */
+static void **_compile_format(List list, int *cnt)
+{
+	static void **fmt_arr = NULL;
+	static int fmt_cnt = 0;
+	static List fmt_src = NULL;
+	ListIterator iter;
+	void *entry;
+
+	if (fmt_src != list) {
+		xfree(fmt_arr);
+		fmt_cnt = 0;
+		fmt_arr = xmalloc(sizeof(void *) * list_count(list));
+		iter = list_iterator_create(list);
+		while ((entry = list_next(iter)))
+			fmt_arr[fmt_cnt++] = entry;
+		list_iterator_destroy(iter);
+		fmt_src = list;
+	}
+	*cnt = fmt_cnt;
+	return fmt_arr;
+}
+
 static int _print_one_job_from_format(job_info_t * job, List list)
 {
-	ListIterator iter = list_iterator_create(list);
-	job_format_t *current;
-	int total_width = 0;
+	job_format_t **fmt_arr, *current;
+	int fmt_cnt, i;
 
-	while ((current = list_next(iter))) {
+	fmt_arr = (job_format_t **) _compile_format(list, &fmt_cnt);
+	for (i = 0; i < fmt_cnt; i++) {
+		current = fmt_arr[i];
 		if (current->
 		    function(job, current->width, current->right_justify,
 			     current->suffix)
 		    != SLURM_SUCCESS)
 			return SLURM_ERROR;
-		if (current->width)
-			total_width += (current->width + 1);
-		else
-			total_width += 10;
 	}
-	list_iterator_destroy(iter);
 
-	printf("\n");
+	_out_newline();
 	return SLURM_SUCCESS;
 }
 
@@ -497,7 +570,7 @@ int _print_job_array_job_id(job_info_t * job, int width, bool right,
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -516,7 +589,7 @@ int _print_job_array_task_id(job_info_t * job, int width, bool right,
 		_print_str("N/A", width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -529,7 +602,7 @@ int _print_job_batch_host(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(eh ? eh : "n/a", width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -541,7 +614,7 @@ int _print_job_burst_buffer(job_info_t * job, int width, bool right, char* suffi
 		_print_str(job->burst_buffer, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -554,7 +627,7 @@ int _print_job_burst_buffer_state(job_info_t * job, int width, bool right,
 		_print_str(job->burst_buffer_state, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -567,7 +640,7 @@ int _print_job_cluster_name(job_info_t * job, int width, bool right,
 		_print_str(job->cluster, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -587,7 +660,7 @@ int _print_job_core_spec(job_info_t * job, int width, bool right, char* suffix)
 		_print_int(job->core_spec, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -598,7 +671,7 @@ int _print_job_delay_boot(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_secs((long)job->delay_boot, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -636,7 +709,7 @@ int _print_job_job_id(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -650,7 +723,7 @@ int _print_job_job_id2(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -662,14 +735,14 @@ int _print_job_partition(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->partition, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
 int _print_job_prefix(job_info_t * job, int width, bool right, char* suffix)
 {
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -686,7 +759,7 @@ int _print_job_reason(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(reason, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -698,7 +771,7 @@ int _print_job_name(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->name, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -710,7 +783,7 @@ int _print_job_licenses(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->licenses, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -722,7 +795,7 @@ int _print_job_wckey(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->wckey, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -733,7 +806,7 @@ int _print_job_user_id(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_int(job->user_id, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -746,7 +819,7 @@ int _print_job_user_name(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(uname, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -757,7 +830,7 @@ int _print_job_group_id(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_int(job->group_id, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -775,7 +848,7 @@ int _print_job_group_name(job_info_t * job, int width, bool right, char* suffix)
 			_print_int(job->group_id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -787,7 +860,7 @@ int _print_job_job_state(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job_state_string(job->job_state), width, right,
 			   true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -799,7 +872,7 @@ int _print_job_last_sched_eval(job_info_t *job, int width, bool right,
 	else
 		_print_time(job->last_sched_eval, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -812,7 +885,7 @@ int _print_job_job_state_compact(job_info_t * job, int width, bool right,
 		_print_str(job_state_string_compact(job->job_state), width,
 			   right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -830,7 +903,7 @@ int _print_job_time_left(job_info_t * job, int width, bool right,
 		_print_secs(time_left, width, right, false);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -846,7 +919,7 @@ int _print_job_time_limit(job_info_t * job, int width, bool right,
 	else
 		_print_secs((job->time_limit*60), width, right, false);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_pack_job_offset(job_info_t * job, int width, bool right,
@@ -863,7 +936,7 @@ int _print_job_pack_job_offset(job_info_t * job, int width, bool right,
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -881,7 +954,7 @@ int _print_job_pack_job_id(job_info_t * job, int width, bool right,
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -896,7 +969,7 @@ int _print_job_pack_job_id_set(job_info_t * job, int width, bool right,
 		_print_str(job->pack_job_id_set, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_time_used(job_info_t * job, int width, bool right,
@@ -907,7 +980,7 @@ int _print_job_time_used(job_info_t * job, int width, bool right,
 	else
 		_print_secs(job_time_used(job), width, right, false);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -940,7 +1013,7 @@ int _print_job_time_submit(job_info_t * job, int width, bool right,
 	else
 		_print_time(job->submit_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -952,7 +1025,7 @@ int _print_job_time_start(job_info_t * job, int width, bool right,
 	else
 		_print_time(job->start_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_deadline(job_info_t * job, int width, bool right, char* suffix)
@@ -962,7 +1035,7 @@ int _print_job_deadline(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_time(job->deadline, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 int _print_job_time_end(job_info_t * job, int width, bool right, char* suffix)
@@ -975,7 +1048,7 @@ int _print_job_time_end(job_info_t * job, int width, bool right, char* suffix)
 	else
 		_print_time(job->end_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -991,7 +1064,7 @@ int _print_job_priority(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(temp, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1005,7 +1078,7 @@ int _print_job_priority_long(job_info_t * job, int width, bool right, char* suff
 		_print_str(temp, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1017,7 +1090,7 @@ int _print_job_nodes(job_info_t * job, int width, bool right, char* suffix)
 		_print_nodes(job->nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 
 	return SLURM_SUCCESS;
 }
@@ -1030,7 +1103,7 @@ int _print_job_schednodes(job_info_t * job, int width, bool right, char* suffix)
 		_print_str(job->sched_nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1058,7 +1131,7 @@ int _print_job_reason_list(job_info_t * job, int width, bool right,
 		_print_nodes(job->nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1071,15 +1144,15 @@ int _print_job_node_inx(job_info_t * job, int width, bool right, char* suffix)
 		int curr_width = 0;
 		while (*current != -1 && curr_width < width) {
 			if (curr_width)
-				printf(",");
+				_out_append(",");
 			curr_width += _print_int(*current, width, right, true);
 			current++;
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out_append(" ");
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1093,7 +1166,7 @@ int _print_job_num_cpus(job_info_t * job, int width, bool right, char* suffix)
        		_print_str(tmp_char, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1109,7 +1182,7 @@ int _print_job_num_nodes(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1147,7 +1220,7 @@ int _print_job_num_sct(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1161,7 +1234,7 @@ int _print_job_num_tasks(job_info_t * job, int width, bool right, char* suffix)
        		_print_str(tmp_char, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1175,7 +1248,7 @@ int _print_job_over_subscribe(job_info_t * job, int width, bool right_justify,
 			   width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1189,7 +1262,7 @@ int _print_job_contiguous(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1207,7 +1280,7 @@ int _print_pn_min_cpus(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1228,7 +1301,7 @@ int _print_sockets(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1249,7 +1322,7 @@ int _print_cores(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1270,7 +1343,7 @@ int _print_threads(job_info_t * job, int width, bool right_justify,
 		_print_str(tmp_char, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1290,7 +1363,7 @@ int _print_pn_min_memory(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1310,7 +1383,7 @@ _print_pn_min_tmp_disk(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1322,7 +1395,7 @@ int _print_job_req_nodes(job_info_t * job, int width, bool right_justify,
 	else
 		_print_nodes(job->req_nodes, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1334,7 +1407,7 @@ int _print_job_exc_nodes(job_info_t * job, int width, bool right_justify,
 	else
 		_print_nodes(job->exc_nodes, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1351,13 +1424,13 @@ _print_job_req_node_inx(job_info_t * job, int width, bool right_justify,
 			curr_width +=
 			    _print_int(*current, width, right_justify,
 				       true);
-			printf(",");
+			_out_append(",");
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out_append(" ");
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1374,13 +1447,13 @@ _print_job_exc_node_inx(job_info_t * job, int width, bool right_justify,
 			curr_width +=
 			    _print_int(*current, width, right_justify,
 				       true);
-			printf(",");
+			_out_append(",");
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out_append(" ");
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1392,7 +1465,7 @@ int _print_job_features(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->features, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1404,7 +1477,7 @@ int _print_job_cluster_features(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->cluster_features, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1416,7 +1489,7 @@ int _print_job_account(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->account, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1428,7 +1501,7 @@ int _print_job_admin_comment(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->admin_comment, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1440,7 +1513,7 @@ int _print_job_system_comment(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->system_comment, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1452,7 +1525,7 @@ int _print_job_comment(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->comment, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1466,7 +1539,7 @@ int _print_job_dependency(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str("", width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1478,7 +1551,7 @@ int _print_job_qos(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->qos, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1496,7 +1569,7 @@ int _print_job_select_jobinfo(job_info_t * job, int width, bool right_justify,
 	_print_str(select_buf, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1508,7 +1581,7 @@ int _print_job_reservation(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->resv_name, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1520,7 +1593,7 @@ int _print_job_command(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->command, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1532,7 +1605,7 @@ int _print_job_work_dir(job_info_t * job, int width, bool right_justify,
 	else
 		_print_str(job->work_dir, width, right_justify, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1547,7 +1620,7 @@ int _print_job_nice(job_info_t * job, int width, bool right_justify,
 		_print_int(nice, width, right_justify, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1561,7 +1634,7 @@ int _print_job_accrue_time(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1574,7 +1647,7 @@ int _print_job_alloc_nodes(job_info_t * job, int width, bool right_justify,
 		_print_str(job->alloc_node, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1587,7 +1660,7 @@ int _print_job_alloc_sid(job_info_t * job, int width, bool right_justify,
 		_print_int(job->alloc_sid, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1600,7 +1673,7 @@ int _print_job_assoc_id(job_info_t * job, int width, bool right_justify,
 		_print_int(job->assoc_id, width, right_justify,true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -1614,7 +1687,7 @@ int _print_job_batch_flag(job_info_t * job, int width, bool right_justify,
 		_print_int(job->batch_flag, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1629,7 +1702,7 @@ int _print_job_boards_per_node(job_info_t * job, int width, bool right_justify,
 		_print_int(job->boards_per_node, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1644,7 +1717,7 @@ int _print_job_cpus_per_task(job_info_t * job, int width, bool right_justify,
 		_print_int(job->cpus_per_task, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1657,7 +1730,7 @@ int _print_job_derived_ec(job_info_t * job, int width, bool right_justify,
 		_print_int(job->derived_ec, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -1672,7 +1745,7 @@ int _print_job_eligible_time(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1685,7 +1758,7 @@ int _print_job_exit_code(job_info_t * job, int width, bool right_justify,
 		_print_int(job->exit_code, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1703,7 +1776,7 @@ int _print_job_fed_origin(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1721,7 +1794,7 @@ int _print_job_fed_origin_raw(job_info_t * job, int width, bool right_justify,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1739,7 +1812,7 @@ int _print_job_fed_siblings_active(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1766,7 +1839,7 @@ int _print_job_fed_siblings_active_raw(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1784,7 +1857,7 @@ int _print_job_fed_siblings_viable(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1811,7 +1884,7 @@ int _print_job_fed_siblings_viable_raw(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1826,7 +1899,7 @@ int _print_job_max_cpus(job_info_t * job, int width, bool right_justify,
 		_print_int(job->num_cpus, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1841,7 +1914,7 @@ int _print_job_max_nodes(job_info_t * job, int width, bool right_justify,
 		_print_int(job->num_nodes, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1854,7 +1927,7 @@ int _print_job_network(job_info_t * job, int width, bool right_justify,
 		_print_str(job->network, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1870,7 +1943,7 @@ int _print_job_ntasks_per_core(job_info_t * job, int width, bool right_justify,
 		_print_int(job->ntasks_per_core, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1886,7 +1959,7 @@ int _print_job_ntasks_per_node(job_info_t * job, int width, bool right_justify,
 		_print_int(job->ntasks_per_node, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1902,7 +1975,7 @@ int _print_job_ntasks_per_socket(job_info_t * job, int width,
 		_print_int(job->ntasks_per_socket, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1918,7 +1991,7 @@ int _print_job_ntasks_per_board(job_info_t * job, int width,
 		_print_int(job->ntasks_per_board, width, right_justify, true);
 
 	if(suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1935,7 +2008,7 @@ int _print_job_preempt_time(job_info_t * job, int width,
 		_print_time(job->preempt_time, 0, width, right_justify);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -1949,7 +2022,7 @@ int _print_job_profile(job_info_t * job, int width,
 		_print_str(acct_gather_profile_to_string(job->profile),
 			   width, right_justify, true);
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1962,7 +2035,7 @@ int _print_job_reboot(job_info_t * job, int width,
 		_print_int(job->reboot, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1975,7 +2048,7 @@ int _print_job_req_switch(job_info_t * job, int width,
 		_print_int(job->req_switch, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -1988,7 +2061,7 @@ int _print_job_requeue(job_info_t * job, int width,
 		_print_int(job->requeue, width, right_justify, true);
 
 	if (suffix)
-		printf("%s",suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2004,7 +2077,7 @@ int _print_job_resize_time(job_info_t * job, int width,
 		_print_str("N/A", width, right_justify, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2018,7 +2091,7 @@ int _print_job_restart_cnt(job_info_t * job, int width,
 		_print_int(job->restart_cnt, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2031,7 +2104,7 @@ int _print_job_sockets_per_board(job_info_t * job, int width,
 		_print_int(job->sockets_per_board, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2057,7 +2130,7 @@ int _print_job_std_err(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2070,7 +2143,7 @@ int _print_job_std_in(job_info_t * job, int width,
 		_print_str(job->std_in, width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2092,7 +2165,7 @@ int _print_job_std_out(job_info_t * job, int width,
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2105,7 +2178,7 @@ int _print_job_min_time(job_info_t * job, int width,
 		_print_secs((job->time_min*60), width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2119,7 +2192,7 @@ int _print_job_wait4switch(job_info_t * job, int width,
 			    width, right_justify, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2138,7 +2211,7 @@ int _print_job_cpus_per_tres(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2157,7 +2230,7 @@ int _print_job_mem_per_tres(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2179,7 +2252,7 @@ int _print_job_tres_alloc(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2198,7 +2271,7 @@ int _print_job_tres_bind(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2217,7 +2290,7 @@ int _print_job_tres_freq(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2236,7 +2309,7 @@ int _print_job_tres_per_job(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2255,7 +2328,7 @@ int _print_job_tres_per_node(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2274,7 +2347,7 @@ int _print_job_tres_per_socket(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2293,7 +2366,7 @@ int _print_job_tres_per_task(job_info_t *job, int width,
 
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2306,7 +2379,7 @@ int _print_job_mcs_label(job_info_t * job, int width,
 		_print_str(job->mcs_label, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2317,23 +2390,19 @@ static int _print_step_from_format(void *x, void *arg)
 {
 	job_step_info_t *job_step = (job_step_info_t *) x;
 	List list = (List) arg;
-	ListIterator i = list_iterator_create(list);
-	step_format_t *current;
-	int total_width = 0;
+	step_format_t **fmt_arr, *current;
+	int fmt_cnt, i;
 
-	while ((current = list_next(i))) {
+	fmt_arr = (step_format_t **) _compile_format(list, &fmt_cnt);
+	for (i = 0; i < fmt_cnt; i++) {
+		current = fmt_arr[i];
 		if (current->
 		    function(job_step, current->width,
 			     current->right_justify, current->suffix)
 		    != SLURM_SUCCESS)
 			return SLURM_ERROR;
-		if (current->width)
-			total_width += current->width;
-		else
-			total_width += 10;
 	}
-	list_iterator_destroy(i);
-	printf("\n");
+	_out_newline();
 
 	return SLURM_SUCCESS;
 }
@@ -2363,7 +2432,7 @@ int _print_step_cluster_name(job_step_info_t *step, int width, bool right,
 		_print_str(step->cluster, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2406,7 +2475,7 @@ int _print_step_id(job_step_info_t * step, int width, bool right, char* suffix)
 		_print_str(id, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2419,7 +2488,7 @@ int _print_step_partition(job_step_info_t * step, int width, bool right,
 		_print_str(step->partition, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2427,7 +2496,7 @@ int _print_step_prefix(job_step_info_t * step, int width, bool right,
 		       char* suffix)
 {
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2439,7 +2508,7 @@ int _print_step_user_id(job_step_info_t * step, int width, bool right,
 	else
 		_print_int(step->user_id, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2453,7 +2522,7 @@ int _print_step_user_name(job_step_info_t * step, int width, bool right,
 		_print_str(uname, width, right, true);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2467,7 +2536,7 @@ int _print_step_time_limit(job_step_info_t * step, int width, bool right,
 	else
 		_print_secs(step->time_limit * 60, width, right, false);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2479,7 +2548,7 @@ int _print_step_time_start(job_step_info_t * step, int width, bool right,
 	else
 		_print_time(step->start_time, 0, width, right);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2493,7 +2562,7 @@ int _print_step_time_used(job_step_info_t * step, int width, bool right,
 		_print_secs(delta_t, width, right, false);
 	}
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2505,7 +2574,7 @@ int _print_step_name(job_step_info_t * step, int width, bool right,
 	else
 		_print_str(step->name, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2518,7 +2587,7 @@ int _print_step_nodes(job_step_info_t * step, int width, bool right,
 		_print_nodes(step->nodes, width, right, false);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2530,7 +2599,7 @@ int _print_step_num_tasks(job_step_info_t * step, int width, bool right,
 	else
 		_print_int(step->num_tasks, width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2545,7 +2614,7 @@ int _print_step_array_job_id(job_step_info_t * step, int width, bool right,
 		_print_int(step->job_id, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2559,7 +2628,7 @@ int _print_step_array_task_id(job_step_info_t * step, int width, bool right,
 	else
 		_print_str("N/A", width, right, true);
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2573,7 +2642,7 @@ int _print_step_chpt_dir(job_step_info_t * step, int width, bool right,
 		_print_str(step->ckpt_dir, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 
 }
@@ -2587,7 +2656,7 @@ int _print_step_chpt_interval(job_step_info_t * step, int width, bool right,
 		_print_secs((step->ckpt_interval*60), width, width, right);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2600,7 +2669,7 @@ int _print_step_job_id(job_step_info_t * step, int width, bool right,
 		_print_int(step->job_id, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2613,7 +2682,7 @@ int _print_step_network(job_step_info_t * step, int width, bool right,
 		_print_str(step->network, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2627,16 +2696,16 @@ int _print_step_node_inx(job_step_info_t * step, int width, bool right,
 		int curr_width = 0;
 		while (*current != -1 && curr_width < width) {
 			if (curr_width)
-				printf(",");
+				_out_append(",");
 			curr_width += _print_int(*current, width, right, true);
 			current++;
 		}
 		while (curr_width < width)
-			curr_width += printf(" ");
+			curr_width += _out_append(" ");
 	}
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2649,7 +2718,7 @@ int _print_step_num_cpus(job_step_info_t * step, int width, bool right,
 		_print_int(step->num_cpus, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2661,7 +2730,7 @@ int _print_step_cpu_freq(job_step_info_t * step, int width, bool right,
 	if (step == NULL) {
 		_print_str("CPU_FREQ", width, right, true);
 		if (suffix)
-			printf("%s", suffix);
+			_out_append(suffix);
 		return SLURM_SUCCESS;
 	}
 	cpu_freq_to_string(bfm, sizeof(bfm), step->cpu_freq_min);
@@ -2671,7 +2740,7 @@ int _print_step_cpu_freq(job_step_info_t * step, int width, bool right,
 	_print_str(bfall, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2684,7 +2753,7 @@ int _print_step_resv_ports(job_step_info_t * step, int width, bool right,
 		_print_str(step->resv_ports, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2697,7 +2766,7 @@ int _print_step_state(job_step_info_t * step, int width, bool right,
 		_print_str(job_state_string(step->state), width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2710,7 +2779,7 @@ int _print_step_cpus_per_tres(job_step_info_t * step, int width, bool right,
 		_print_str(step->cpus_per_tres, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2723,7 +2792,7 @@ int _print_step_mem_per_tres(job_step_info_t * step, int width, bool right,
 		_print_str(step->mem_per_tres, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2736,7 +2805,7 @@ int _print_step_tres_bind(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_bind, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2749,7 +2818,7 @@ int _print_step_tres_freq(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_freq, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2762,7 +2831,7 @@ int _print_step_tres_per_step(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_step, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2775,7 +2844,7 @@ int _print_step_tres_per_node(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_node, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2788,7 +2857,7 @@ int _print_step_tres_per_socket(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_socket, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -2801,7 +2870,7 @@ int _print_step_tres_per_task(job_step_info_t * step, int width, bool right,
 		_print_str(step->tres_per_task, width, right, true);
 
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
 
@@ -3139,6 +3208,6 @@ static int _filter_step(job_step_info_t * step)
 int _print_com_invalid(void * p, int width, bool right, char* suffix)
 {
 	if (suffix)
-		printf("%s", suffix);
+		_out_append(suffix);
 	return SLURM_SUCCESS;
 }
@@ -47,6 +47,7 @@
 #include <sys/ioctl.h>
 #include <termios.h>
 
+#include "src/common/macros.h"
 #include "src/common/read_config.h"
 #include "src/common/slurm_time.h"
 #include "src/common/xstring.h"
@@ -61,10 +62,13 @@ int max_line_size;
 /*************
  * Functions *
  *************/
+static int  _display_jobs(job_info_msg_t *new_job_ptr, bool log_cluster_name);
 static int  _get_info(bool clear_old, bool log_cluster_name);
+static uint16_t _job_show_flags(void);
 static int  _get_window_width( void );
 static void _print_date( void );
 static int  _multi_cluster(List clusters);
+static int  _multi_cluster_parallel(List clusters, bool log_cluster_name);
 static int  _print_job(bool clear_old, bool log_cluster_name);
 static int  _print_job_steps( bool clear_old );
 
@@ -87,7 +91,7 @@ main (int argc, char **argv)
 		working_cluster_rec = list_peek(params.clusters);
 
 	while (1) {
-		if ((!params.no_header) &&
+		if ((!params.no_header) && !params.watch_flag &&
 		    (params.iterate || params.verbose || params.long_list))
 			_print_date ();
 
@@ -98,7 +102,8 @@ main (int argc, char **argv)
 			error_code = 1;
 
 		if ( params.iterate ) {
-			printf( "\n");
+			if (!params.watch_flag)
+				printf( "\n");
 			sleep( params.iterate );
 		} else
 			break;
@@ -110,6 +115,74 @@ main (int argc, char **argv)
 		exit (0);
 }
 
+typedef struct load_cluster_jobs {
+	slurmdb_cluster_rec_t *cluster;
+	job_info_msg_t *job_ptr;
+	uint16_t show_flags;
+	int rc;
+} load_cluster_jobs_t;
+
+static void *_load_jobs_thread(void *args)
+{
+	load_cluster_jobs_t *load = (load_cluster_jobs_t *) args;
+
+	load->rc = slurm_load_jobs2((time_t) NULL, &load->job_ptr,
+				    load->show_flags, load->cluster);
+	return (void *) NULL;
+}
+
+/*
+ * Query every cluster concurrently so the run time is bound by the
+ * slowest cluster rather than the sum of all of them, then print the
+ * reports in the listed cluster order.
+ */
+static int _multi_cluster_parallel(List clusters, bool log_cluster_name)
+{
+	load_cluster_jobs_t *loads;
+	pthread_t *load_thread;
+	slurmdb_cluster_rec_t *cluster;
+	ListIterator itr;
+	bool first = true;
+	int i, cluster_cnt = 0, rc = 0;
+
+	loads = xmalloc(sizeof(load_cluster_jobs_t) * list_count(clusters));
+	load_thread = xmalloc(sizeof(pthread_t) * list_count(clusters));
+	itr = list_iterator_create(clusters);
+	while ((cluster = (slurmdb_cluster_rec_t *) list_next(itr))) {
+		loads[cluster_cnt].cluster = cluster;
+		loads[cluster_cnt].show_flags = _job_show_flags() | SHOW_LOCAL;
+		slurm_thread_create(&load_thread[cluster_cnt],
+				    _load_jobs_thread, &loads[cluster_cnt]);
+		cluster_cnt++;
+	}
+	list_iterator_destroy(itr);
+	for (i = 0; i < cluster_cnt; i++)
+		pthread_join(load_thread[i], NULL);
+	xfree(load_thread);
+
+	for (i = 0; i < cluster_cnt; i++) {
+		working_cluster_rec = loads[i].cluster;
+		if (!params.no_header) {
+			if (first)
+				first = false;
+			else
+				printf("\n");
+			printf("CLUSTER: %s\n", working_cluster_rec->name);
+		}
+		if (loads[i].rc) {
+			slurm_seterrno(loads[i].rc);
+			slurm_perror("slurm_load_jobs error");
+			rc = 1;
+			continue;
+		}
+		(void) _display_jobs(loads[i].job_ptr, log_cluster_name);
+		slurm_free_job_info_msg(loads[i].job_ptr);
+	}
+	xfree(loads);
+
+	return rc;
+}
+
 static int _multi_cluster(List clusters)
 {
 	ListIterator itr;
@@ -118,6 +191,16 @@ static int _multi_cluster(List clusters)
 
 	if ((list_count(clusters) > 1) && params.no_header)
 		log_cluster_name = true;
+
+	/*
+	 * Job queries carry no inter-cluster state, so they can be issued
+	 * to all clusters at once. Step queries and the single job/user
+	 * RPCs still walk the clusters one by one.
+	 */
+	if ((list_count(clusters) > 1) && !params.step_flag &&
+	    !params.job_id && !params.user_id && !params.job_list)
+		return _multi_cluster_parallel(clusters, log_cluster_name);
+
 	itr = list_iterator_create(clusters);
 	while ((working_cluster_rec = list_next(itr))) {
 		if (!params.no_header) {
@@ -167,12 +250,10 @@ _get_window_width( void )
 }
 
 
-/* _print_job - print the specified job's information */
-static int _print_job(bool clear_old, bool log_cluster_name)
+/* Build the show_flags for a job info request */
+static uint16_t _job_show_flags(void)
 {
-	static job_info_msg_t *old_job_ptr;
-	job_info_msg_t *new_job_ptr = NULL;
-	int error_code;
+	static int slim_flag = -1;
 	uint16_t show_flags = 0;
 
 	if (params.all_flag || (params.job_list && list_count(params.job_list)))
@@ -188,6 +269,67 @@ static int _print_job(bool clear_old, bool log_cluster_name)
 	if (params.format && strstr(params.format, "C"))
 		show_flags |= SHOW_DETAIL;
 
+	/*
+	 * The default output formats, sort order and filters read only a
+	 * small subset of the job record, so let the controller send empty
+	 * values for the fields nothing will look at. A user supplied
+	 * format or sort order may reference any field.
+	 */
+	if (slim_flag == -1) {
+		if (!params.format && !params.format_long && !params.sort)
+			slim_flag = SHOW_SLIM;
+		else
+			slim_flag = 0;
+	}
+	show_flags |= slim_flag;
+
+	return show_flags;
+}
+
+/*
+ * When several specific job IDs were requested, push the ID list down to
+ * slurmctld so that only those records are packed and sent rather than
+ * fetching the whole queue and filtering it locally. Duplicate IDs (e.g.
+ * several tasks of one array) are collapsed, the response already holds
+ * every task and heterogeneous job component of each listed ID and
+ * _filter_job() narrows it to the requested tasks.
+ */
+static int _load_job_ids(time_t update_time, job_info_msg_t **new_job_ptr,
+			 uint16_t show_flags)
+{
+	uint32_t *job_ids;
+	squeue_job_step_t *job_step_id;
+	ListIterator iterator;
+	int error_code, i, job_id_cnt = 0;
+
+	job_ids = xmalloc(sizeof(uint32_t) * list_count(params.job_list));
+	iterator = list_iterator_create(params.job_list);
+	while ((job_step_id = list_next(iterator))) {
+		for (i = 0; i < job_id_cnt; i++) {
+			if (job_ids[i] == job_step_id->job_id)
+				break;
+		}
+		if (i >= job_id_cnt)
+			job_ids[job_id_cnt++] = job_step_id->job_id;
+	}
+	list_iterator_destroy(iterator);
+
+	error_code = slurm_load_job_ids(update_time, new_job_ptr, job_ids,
+					job_id_cnt, show_flags);
+	xfree(job_ids);
+
+	return error_code;
+}
+
+/* _print_job - print the specified job's information */
+static int _print_job(bool clear_old, bool log_cluster_name)
+{
+	static job_info_msg_t *old_job_ptr;
+	job_info_msg_t *new_job_ptr = NULL;
+	job_info_msg_t *prev_job_ptr = old_job_ptr;
+	int error_code;
+	uint16_t show_flags = _job_show_flags();
+
 	if (old_job_ptr) {
 		if (clear_old)
 			old_job_ptr->last_update = 0;
@@ -199,6 +341,10 @@ static int _print_job(bool clear_old, bool log_cluster_name)
 			error_code = slurm_load_job_user(&new_job_ptr,
 							 params.user_id,
 							 show_flags);
+		} else if (params.job_list && !params.federation_flag &&
+			   !params.sibling_flag) {
+			error_code = _load_job_ids(old_job_ptr->last_update,
+						   &new_job_ptr, show_flags);
 		} else {
 			if (params.clusters)
 				show_flags |= SHOW_LOCAL;
@@ -218,6 +364,10 @@ static int _print_job(bool clear_old, bool log_cluster_name)
 	} else if (params.user_id) {
 		error_code = slurm_load_job_user(&new_job_ptr, params.user_id,
 						 show_flags);
+	} else if (params.job_list && !params.federation_flag &&
+		   !params.sibling_flag) {
+		error_code = _load_job_ids((time_t) NULL, &new_job_ptr,
+					   show_flags);
 	} else {
 		error_code = slurm_load_jobs((time_t) NULL, &new_job_ptr,
 					     show_flags);
@@ -231,6 +381,28 @@ static int _print_job(bool clear_old, bool log_cluster_name)
 	if (params.job_id || params.user_id)
 		old_job_ptr->last_update = (time_t) 0;
 
+	if (params.watch_flag) {
+		static bool first_draw = true;
+
+		/*
+		 * The local mirror is unchanged (the controller answered
+		 * with SLURM_NO_CHANGE_IN_DATA), so leave the last table
+		 * painted on the screen alone.
+		 */
+		if (!first_draw && (new_job_ptr == prev_job_ptr))
+			return SLURM_SUCCESS;
+		first_draw = false;
+		if (isatty(STDOUT_FILENO))
+			printf("\033[H\033[J");	/* home cursor, clear below */
+		_print_date();
+	}
+
+	return _display_jobs(new_job_ptr, log_cluster_name);
+}
+
+/* Format and print one job info report */
+static int _display_jobs(job_info_msg_t *new_job_ptr, bool log_cluster_name)
+{
 	if (params.verbose) {
 		printf ("last_update_time=%ld records=%u\n",
 			(long) new_job_ptr->last_update,
@@ -303,6 +475,13 @@ _print_job_steps( bool clear_old )
 	}
 	old_step_ptr = new_step_ptr;
 
+	if (params.watch_flag) {
+		/* Steps are always refetched for current run times */
+		if (isatty(STDOUT_FILENO))
+			printf("\033[H\033[J");	/* home cursor, clear below */
+		_print_date();
+	}
+
 	if (params.verbose) {
 		printf ("last_update_time=%ld records=%u\n",
 			(long) new_step_ptr->last_update,
@@ -99,6 +99,18 @@ extern fname_t *fname_create(srun_job_t *job, char *format, int task_count)
 		return fname;
 	}
 
+	if (xstrcasecmp(format, "spool") == 0) {
+		/*
+		 * Tasks write spool files on their own node, opened by
+		 * the slurmstepd under the node-local TmpFS directory
+		 * (expanded in src/slurmd/common/fname.c). No output
+		 * stream is connected back to srun.
+		 */
+		fname->type = IO_PER_TASK;
+		fname->name = xstrdup ("spool");
+		return fname;
+	}
+
 	taskid = strtoul(format, &p, 10);
 	if ((*p == '\0') && ((int) taskid < task_count)) {
 		fname->type   = IO_ONE;
@@ -1540,6 +1540,11 @@ extern void job_update_io_fnames(srun_job_t *job, slurm_opt_t *opt_local)
 	job->efname = opt_local->efname ?
 		      fname_create(job, opt_local->efname, opt_local->ntasks) :
 		      job->ofname;
+
+	if (job->ofname->name && !xstrcmp(job->ofname->name, "spool"))
+		verbose("task output spooled on each node under TmpFS as "
+			"slurm_spool_job%u.<stepid>_task_<taskid>.out",
+			job->jobid);
 }
 
 static char *
@@ -40,10 +40,24 @@
 
 #include "sstat.h"
 
-int _do_stat(uint32_t jobid, uint32_t stepid, char *nodelist,
-	     uint32_t req_cpufreq_min, uint32_t req_cpufreq_max,
-	     uint32_t req_cpufreq_gov,
-	     uint16_t use_protocol_ver);
+/* One queued step stat request and its collected response */
+typedef struct {
+	uint32_t jobid;
+	uint32_t stepid;
+	char *nodelist;		/* NULL means every node in the step */
+	uint32_t req_cpufreq_min;
+	uint32_t req_cpufreq_max;
+	uint32_t req_cpufreq_gov;
+	uint16_t protocol_ver;
+	job_step_stat_response_msg_t *resp;
+	int rc;
+} stat_req_t;
+
+static void _queue_stat(List stat_list, uint32_t jobid, uint32_t stepid,
+			char *nodelist, uint32_t req_cpufreq_min,
+			uint32_t req_cpufreq_max, uint32_t req_cpufreq_gov,
+			uint16_t use_protocol_ver);
+static int _stat_report(stat_req_t *req);
 
 /*
  * Globals
@@ -111,11 +125,48 @@ List print_fields_list = NULL;
 ListIterator print_fields_itr = NULL;
 int field_count = 0;
 
-int _do_stat(uint32_t jobid, uint32_t stepid, char *nodelist,
-	     uint32_t req_cpufreq_min, uint32_t req_cpufreq_max,
-	     uint32_t req_cpufreq_gov, uint16_t use_protocol_ver)
+static void _queue_stat(List stat_list, uint32_t jobid, uint32_t stepid,
+			char *nodelist, uint32_t req_cpufreq_min,
+			uint32_t req_cpufreq_max, uint32_t req_cpufreq_gov,
+			uint16_t use_protocol_ver)
 {
-	job_step_stat_response_msg_t *step_stat_response = NULL;
+	stat_req_t *req = xmalloc(sizeof(stat_req_t));
+
+	req->jobid = jobid;
+	req->stepid = stepid;
+	req->nodelist = xstrdup(nodelist);
+	req->req_cpufreq_min = req_cpufreq_min;
+	req->req_cpufreq_max = req_cpufreq_max;
+	req->req_cpufreq_gov = req_cpufreq_gov;
+	req->protocol_ver = use_protocol_ver;
+	list_append(stat_list, req);
+}
+
+static void *_stat_thread(void *args)
+{
+	stat_req_t *req = (stat_req_t *) args;
+
+	debug("requesting info for job %u.%u", req->jobid, req->stepid);
+	req->rc = slurm_job_step_stat(req->jobid, req->stepid, req->nodelist,
+				      req->protocol_ver, &req->resp);
+	return (void *) NULL;
+}
+
+static void _stat_req_destroy(void *object)
+{
+	stat_req_t *req = (stat_req_t *) object;
+
+	if (req) {
+		xfree(req->nodelist);
+		xfree(req);
+	}
+}
+
+static int _stat_report(stat_req_t *req)
+{
+	job_step_stat_response_msg_t *step_stat_response = req->resp;
+	uint32_t jobid = req->jobid;
+	uint32_t stepid = req->stepid;
 	int rc = SLURM_SUCCESS;
 	ListIterator itr;
 	jobacctinfo_t *total_jobacct = NULL;
@@ -125,9 +176,7 @@ int _do_stat(uint32_t jobid, uint32_t stepid, char *nodelist,
 	hostlist_t hl = NULL;
 	char *ave_usage_tmp = NULL;
 
-	debug("requesting info for job %u.%u", jobid, stepid);
-	if ((rc = slurm_job_step_stat(jobid, stepid, nodelist, use_protocol_ver,
-				      &step_stat_response)) != SLURM_SUCCESS) {
+	if ((rc = req->rc) != SLURM_SUCCESS) {
 		if (rc == ESLURM_INVALID_JOB_ID) {
 			debug("job step %u.%u has already completed",
 			      jobid, stepid);
@@ -149,9 +198,9 @@ int _do_stat(uint32_t jobid, uint32_t stepid, char *nodelist,
 	step.job_ptr = &job;
 	step.stepid = stepid;
 	step.nodes = xmalloc(BUF_SIZE);
-	step.req_cpufreq_min = req_cpufreq_min;
-	step.req_cpufreq_max = req_cpufreq_max;
-	step.req_cpufreq_gov = req_cpufreq_gov;
+	step.req_cpufreq_min = req->req_cpufreq_min;
+	step.req_cpufreq_max = req->req_cpufreq_max;
+	step.req_cpufreq_gov = req->req_cpufreq_gov;
 	step.stepname = NULL;
 	step.state = JOB_RUNNING;
 	hl = hostlist_create(NULL);
@@ -261,6 +310,10 @@ int main(int argc, char **argv)
 	uint32_t req_cpufreq_gov = NO_VAL;
 	uint32_t stepid = NO_VAL;
 	slurmdb_selected_step_t *selected_step = NULL;
+	List stat_list = list_create(_stat_req_destroy);
+	stat_req_t *stat_req = NULL;
+	pthread_t *tids = NULL;
+	int stat_cnt, inx = 0;
 
 	slurm_conf_init(NULL);
 	print_fields_list = list_create(NULL);
@@ -311,8 +364,12 @@ int main(int argc, char **argv)
 			use_protocol_ver = MIN(SLURM_PROTOCOL_VERSION,
 				job_ptr->job_array[0].start_protocol_ver);
 			stepid = SLURM_EXTERN_CONT;
-			nodelist = job_ptr->job_array[0].nodes;
+			_queue_stat(stat_list, selected_step->jobid, stepid,
+				    job_ptr->job_array[0].nodes,
+				    req_cpufreq_min, req_cpufreq_max,
+				    req_cpufreq_gov, use_protocol_ver);
 			slurm_free_job_info_msg(job_ptr);
+			continue;
 		} else if (selected_step->stepid != NO_VAL) {
 			stepid = selected_step->stepid;
 		} else if (params.opt_all_steps) {
@@ -327,14 +384,14 @@ int main(int argc, char **argv)
 			}
 
 			for (i = 0; i < step_ptr->job_step_count; i++) {
-				_do_stat(selected_step->jobid,
-					 step_ptr->job_steps[i].step_id,
-					 step_ptr->job_steps[i].nodes,
-					 step_ptr->job_steps[i].cpu_freq_min,
-					 step_ptr->job_steps[i].cpu_freq_max,
-					 step_ptr->job_steps[i].cpu_freq_gov,
-					 step_ptr->job_steps[i].
-					 start_protocol_ver);
+				_queue_stat(stat_list, selected_step->jobid,
+					    step_ptr->job_steps[i].step_id,
+					    step_ptr->job_steps[i].nodes,
+					    step_ptr->job_steps[i].cpu_freq_min,
+					    step_ptr->job_steps[i].cpu_freq_max,
+					    step_ptr->job_steps[i].cpu_freq_gov,
+					    step_ptr->job_steps[i].
+					    start_protocol_ver);
 			}
 			slurm_free_job_step_info_response_msg(step_ptr);
 			continue;
@@ -373,14 +430,37 @@ int main(int argc, char **argv)
 			use_protocol_ver = MIN(SLURM_PROTOCOL_VERSION,
 					       step_info->start_protocol_ver);
 		}
-		_do_stat(selected_step->jobid, stepid, nodelist,
-			 req_cpufreq_min, req_cpufreq_max, req_cpufreq_gov,
-			 use_protocol_ver);
+		_queue_stat(stat_list, selected_step->jobid, stepid, nodelist,
+			    req_cpufreq_min, req_cpufreq_max, req_cpufreq_gov,
+			    use_protocol_ver);
 		if (free_nodelist && nodelist)
 			free(nodelist);
 	}
 	list_iterator_destroy(itr);
 
+	/*
+	 * Fan the fetches out in parallel, one tree per step, so the run
+	 * time is bounded by the slowest step rather than the sum of them
+	 * all.  Reporting stays serial and in the requested order.
+	 */
+	if ((stat_cnt = list_count(stat_list))) {
+		tids = xmalloc(sizeof(pthread_t) * stat_cnt);
+		itr = list_iterator_create(stat_list);
+		while ((stat_req = list_next(itr)))
+			slurm_thread_create(&tids[inx++], _stat_thread,
+					    stat_req);
+		list_iterator_destroy(itr);
+		while (inx > 0)
+			pthread_join(tids[--inx], NULL);
+		xfree(tids);
+
+		itr = list_iterator_create(stat_list);
+		while ((stat_req = list_next(itr)))
+			_stat_report(stat_req);
+		list_iterator_destroy(itr);
+	}
+	FREE_NULL_LIST(stat_list);
+
 	xfree(params.opt_field_list);
 	FREE_NULL_LIST(params.opt_job_list);
 	if (print_fields_itr)
@@ -3469,9 +3469,16 @@ extern int get_new_info_job(job_info_msg_t **info_ptr,
 	static time_t last;
 	static bool changed = 0;
 	static uint16_t last_flags = 0;
+	static job_info_msg_t *stale_job_info_ptr = NULL;
 	slurm_job_info_t *job_ptr;
 	char *local_cluster;
 
+	/*
+	 * The page thread fetches outside of the GDK lock, so serialize
+	 * against readers coming in from popup threads here.
+	 */
+	g_mutex_lock(sview_fetch_mutex);
+
 	if (g_job_info_ptr && !force
 	    && ((now - last) < working_sview_config.refresh_delay)) {
 		if (*info_ptr != g_job_info_ptr)
@@ -3493,7 +3500,13 @@ extern int get_new_info_job(job_info_msg_t **info_ptr,
 		error_code = slurm_load_jobs(g_job_info_ptr->last_update,
 					     &new_job_ptr, show_flags);
 		if (error_code == SLURM_SUCCESS) {
-			slurm_free_job_info_msg(g_job_info_ptr);
+			/*
+			 * A reader may still be walking the table we are
+			 * replacing, so hold it for one more refresh cycle
+			 * before it is freed.
+			 */
+			slurm_free_job_info_msg(stale_job_info_ptr);
+			stale_job_info_ptr = g_job_info_ptr;
 			changed = 1;
 		} else if (slurm_get_errno() == SLURM_NO_CHANGE_IN_DATA) {
 			error_code = SLURM_NO_CHANGE_IN_DATA;
@@ -3533,6 +3546,7 @@ extern int get_new_info_job(job_info_msg_t **info_ptr,
 
 	*info_ptr = g_job_info_ptr;
 end_it:
+	g_mutex_unlock(sview_fetch_mutex);
 	return error_code;
 }
 
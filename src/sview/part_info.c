@@ -2114,6 +2114,13 @@ extern int get_new_info_part(partition_info_msg_t **part_ptr, int force)
 	static time_t last;
 	static bool changed = 0;
 	static uint16_t last_flags = 0;
+	static partition_info_msg_t *stale_part_info_ptr = NULL;
+
+	/*
+	 * The page thread fetches outside of the GDK lock, so serialize
+	 * against readers coming in from popup threads here.
+	 */
+	g_mutex_lock(sview_fetch_mutex);
 
 	if (g_part_info_ptr && !force
 	    && ((now - last) < working_sview_config.refresh_delay)) {
@@ -2138,7 +2145,13 @@ extern int get_new_info_part(partition_info_msg_t **part_ptr, int force)
 		error_code = slurm_load_partitions(g_part_info_ptr->last_update,
 						   &new_part_ptr, show_flags);
 		if (error_code == SLURM_SUCCESS) {
-			slurm_free_partition_info_msg(g_part_info_ptr);
+			/*
+			 * A reader may still be walking the table we are
+			 * replacing, so hold it for one more refresh cycle
+			 * before it is freed.
+			 */
+			slurm_free_partition_info_msg(stale_part_info_ptr);
+			stale_part_info_ptr = g_part_info_ptr;
 			changed = 1;
 		} else if (slurm_get_errno() == SLURM_NO_CHANGE_IN_DATA) {
 			error_code = SLURM_NO_CHANGE_IN_DATA;
@@ -2160,7 +2173,7 @@ extern int get_new_info_part(partition_info_msg_t **part_ptr, int force)
 
 	*part_ptr = new_part_ptr;
 end_it:
-
+	g_mutex_unlock(sview_fetch_mutex);
 	return error_code;
 }
 
@@ -79,6 +79,7 @@ GtkWidget *main_window = NULL;
 GtkWidget *grid_window = NULL;
 GtkTable *main_grid_table = NULL;
 GMutex *sview_mutex = NULL;
+GMutex *sview_fetch_mutex = NULL;
 GMutex *grid_mutex = NULL;
 GCond *grid_cond = NULL;
 int cluster_dims;
@@ -157,6 +158,32 @@ display_data_t main_display_data[] = {
 	{G_TYPE_NONE, -1, NULL, false, -1}
 };
 
+/*
+ * Pull the next copy of a page's data down before the GDK lock is taken
+ * so the interface only stalls for the model update, not for the RPC
+ * round trip.  The get_new_info_* routines cache the result, so the
+ * display code called under the lock just picks it up.
+ */
+static void _prefetch_page_info(int page_num)
+{
+	switch (page_num) {
+	case JOB_PAGE:
+	{
+		job_info_msg_t *info_ptr = NULL;
+		(void) get_new_info_job(&info_ptr, 1);
+		break;
+	}
+	case PART_PAGE:
+	{
+		partition_info_msg_t *info_ptr = NULL;
+		(void) get_new_info_part(&info_ptr, 1);
+		break;
+	}
+	default:	/* Other pages still fetch under the lock */
+		break;
+	}
+}
+
 void *_page_thr(void *arg)
 {
 	page_thr_t *page = (page_thr_t *)arg;
@@ -191,6 +218,7 @@ void *_page_thr(void *arg)
 		DEF_TIMERS;
 		START_TIMER;
 #endif
+		_prefetch_page_info(display_data->id);
 //		g_mutex_lock(sview_mutex);
 		gdk_threads_enter();
 		sview_init_grid(reset_highlight);
@@ -1457,6 +1485,7 @@ int main(int argc, char **argv)
 	/* Initialize GTK */
 	gtk_init (&argc, &argv);
 	sview_mutex_new(&sview_mutex);
+	sview_mutex_new(&sview_fetch_mutex);
 	sview_mutex_new(&grid_mutex);
 	sview_cond_new(&grid_cond);
 	/* make sure the system is up */
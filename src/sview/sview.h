@@ -318,6 +318,7 @@ extern GtkWidget *main_statusbar;
 extern GtkWidget *main_window;
 extern GtkTable *main_grid_table;
 extern GMutex *sview_mutex;
+extern GMutex *sview_fetch_mutex;
 extern int global_row_count;
 extern gint last_event_x;
 extern gint last_event_y;
@@ -0,0 +1,99 @@
+/* Microbenchmark for src/common/bitstring.c kernels.
+ *
+ * Usage: bench-bitstring [nbits] [iterations]
+ *
+ * Default nbits approximates the core bitmap of a large cluster.
+ */
+#include <stdlib.h>
+
+#include <src/common/bitstring.h>
+
+#include "bench.h"
+
+int main(int argc, char *argv[])
+{
+	int64_t nbits = 100000, iters = 100000, i, sink = 0;
+	bitstr_t *a, *b, *c;
+
+	if (argc > 1)
+		nbits = atoll(argv[1]);
+	if (argc > 2)
+		iters = atoll(argv[2]);
+	if ((nbits <= 0) || (iters <= 0)) {
+		fprintf(stderr, "usage: %s [nbits] [iterations]\n", argv[0]);
+		exit(1);
+	}
+	printf("bitstring: nbits=%"PRId64" iterations=%"PRId64"\n",
+	       nbits, iters);
+
+	a = bit_alloc(nbits);
+	b = bit_alloc(nbits);
+	for (i = 0; i < nbits; i++) {
+		if (bench_rand() & 1)
+			bit_set(a, i);
+		if (bench_rand() & 3)
+			bit_set(b, i);
+	}
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		bit_set(a, bench_rand() % nbits);
+	BENCH_STOP("bit_set (random)", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		sink += bit_test(a, bench_rand() % nbits);
+	BENCH_STOP("bit_test (random)", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		sink += bit_set_count(a);
+	BENCH_STOP("bit_set_count", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		sink += bit_overlap(a, b);
+	BENCH_STOP("bit_overlap", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		sink += bit_super_set(b, a);
+	BENCH_STOP("bit_super_set", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		sink += bit_ffs(a);
+	BENCH_STOP("bit_ffs", iters);
+
+	c = bit_copy(a);
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		bit_and(c, b);
+	BENCH_STOP("bit_and", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		bit_or(c, a);
+	BENCH_STOP("bit_or", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		bit_and_not(c, b);
+	BENCH_STOP("bit_and_not", iters);
+	bit_free(c);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		c = bit_copy(a);
+		bit_free(c);
+	}
+	BENCH_STOP("bit_copy + bit_free", iters);
+
+	bit_free(a);
+	bit_free(b);
+
+	/* Keep the compiler from discarding the measured loops */
+	if (sink == -1)
+		printf("impossible\n");
+	return 0;
+}
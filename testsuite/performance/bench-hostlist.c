@@ -0,0 +1,105 @@
+/* Microbenchmark for src/common/hostlist.c kernels.
+ *
+ * Usage: bench-hostlist [node_count] [iterations]
+ *
+ * Generates a synthetic cluster of node_count nodes with a prefixed,
+ * zero padded naming scheme ("nid00000" style) and measures the
+ * hostlist operations the controller performs on every scheduling
+ * and RPC fanout path.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/hostlist.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include "bench.h"
+
+int main(int argc, char *argv[])
+{
+	int64_t node_cnt = 10000, iters = 100, i, j;
+	hostlist_t hl;
+	char *ranged, *host;
+
+	if (argc > 1)
+		node_cnt = atoll(argv[1]);
+	if (argc > 2)
+		iters = atoll(argv[2]);
+	if ((node_cnt <= 0) || (iters <= 0)) {
+		fprintf(stderr, "usage: %s [node_count] [iterations]\n",
+			argv[0]);
+		exit(1);
+	}
+	printf("hostlist: node_count=%"PRId64" iterations=%"PRId64"\n",
+	       node_cnt, iters);
+
+	/* Build the ranged form once for the create benchmarks */
+	hl = hostlist_create(NULL);
+	for (i = 0; i < node_cnt; i++) {
+		char name[32];
+		snprintf(name, sizeof(name), "nid%05"PRId64, i);
+		hostlist_push_host(hl, name);
+	}
+	hostlist_uniq(hl);
+	ranged = hostlist_ranged_string_xmalloc(hl);
+	hostlist_destroy(hl);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		hl = hostlist_create(ranged);
+		hostlist_destroy(hl);
+	}
+	BENCH_STOP("create (ranged string)", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		hl = hostlist_create(NULL);
+		for (j = 0; j < node_cnt; j++) {
+			char name[32];
+			snprintf(name, sizeof(name), "nid%05"PRId64, j);
+			hostlist_push_host(hl, name);
+		}
+		hostlist_destroy(hl);
+	}
+	BENCH_STOP("push_host (per node)", iters * node_cnt);
+
+	hl = hostlist_create(ranged);
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		char *tmp = hostlist_ranged_string_xmalloc(hl);
+		xfree(tmp);
+	}
+	BENCH_STOP("ranged_string", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++)
+		hostlist_uniq(hl);
+	BENCH_STOP("uniq (sorted input)", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		int64_t probe = bench_rand() % node_cnt;
+		char name[32];
+		snprintf(name, sizeof(name), "nid%05"PRId64, probe);
+		if (hostlist_find(hl, name) < 0) {
+			fprintf(stderr, "find failed for %s\n", name);
+			exit(1);
+		}
+	}
+	BENCH_STOP("find (random)", iters);
+	hostlist_destroy(hl);
+
+	hl = hostlist_create(ranged);
+	BENCH_START();
+	i = 0;
+	while ((host = hostlist_shift(hl))) {
+		free(host);
+		i++;
+	}
+	BENCH_STOP("shift (drain)", i);
+	hostlist_destroy(hl);
+
+	xfree(ranged);
+	return 0;
+}
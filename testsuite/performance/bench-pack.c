@@ -0,0 +1,116 @@
+/* Microbenchmark for src/common/pack.c buffer kernels.
+ *
+ * Usage: bench-pack [element_count] [iterations]
+ *
+ * Measures the pack/unpack primitives underlying every job and node
+ * info response, including buffer growth cost.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <src/common/pack.h>
+#include <src/common/xmalloc.h>
+
+#include "bench.h"
+
+int main(int argc, char *argv[])
+{
+	int64_t elem_cnt = 100000, iters = 100, i, j;
+	uint32_t *array, *out_array, out_cnt, u32;
+	char *str, *out_str;
+	Buf buffer;
+
+	if (argc > 1)
+		elem_cnt = atoll(argv[1]);
+	if (argc > 2)
+		iters = atoll(argv[2]);
+	if ((elem_cnt <= 0) || (iters <= 0)) {
+		fprintf(stderr, "usage: %s [element_count] [iterations]\n",
+			argv[0]);
+		exit(1);
+	}
+	printf("pack: element_count=%"PRId64" iterations=%"PRId64"\n",
+	       elem_cnt, iters);
+
+	array = xcalloc(elem_cnt, sizeof(uint32_t));
+	for (i = 0; i < elem_cnt; i++)
+		array[i] = (uint32_t) bench_rand();
+	str = xmalloc(64);
+	snprintf(str, 64, "cluster/partition/feature=%08x",
+		 (unsigned) bench_rand());
+
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		buffer = init_buf(1024);
+		for (j = 0; j < elem_cnt; j++)
+			pack32(array[j], buffer);
+		free_buf(buffer);
+	}
+	BENCH_STOP("pack32 (with growth)", iters * elem_cnt);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		buffer = init_buf(1024);
+		pack32_array(array, elem_cnt, buffer);
+		free_buf(buffer);
+	}
+	BENCH_STOP("pack32_array", iters);
+
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		buffer = init_buf(1024);
+		for (j = 0; j < elem_cnt; j++)
+			packstr(str, buffer);
+		free_buf(buffer);
+	}
+	BENCH_STOP("packstr", iters * elem_cnt);
+
+	buffer = init_buf(1024);
+	for (j = 0; j < elem_cnt; j++)
+		pack32(array[j], buffer);
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		set_buf_offset(buffer, 0);
+		for (j = 0; j < elem_cnt; j++) {
+			if (unpack32(&u32, buffer)) {
+				fprintf(stderr, "unpack32 failed\n");
+				exit(1);
+			}
+		}
+	}
+	BENCH_STOP("unpack32", iters * elem_cnt);
+	free_buf(buffer);
+
+	buffer = init_buf(1024);
+	pack32_array(array, elem_cnt, buffer);
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		set_buf_offset(buffer, 0);
+		if (unpack32_array(&out_array, &out_cnt, buffer) ||
+		    (out_cnt != elem_cnt)) {
+			fprintf(stderr, "unpack32_array failed\n");
+			exit(1);
+		}
+		xfree(out_array);
+	}
+	BENCH_STOP("unpack32_array", iters);
+	free_buf(buffer);
+
+	buffer = init_buf(1024);
+	packstr(str, buffer);
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		set_buf_offset(buffer, 0);
+		if (unpackstr_xmalloc(&out_str, &out_cnt, buffer)) {
+			fprintf(stderr, "unpackstr failed\n");
+			exit(1);
+		}
+		xfree(out_str);
+	}
+	BENCH_STOP("unpackstr_xmalloc", iters);
+	free_buf(buffer);
+
+	xfree(array);
+	xfree(str);
+	return 0;
+}
@@ -0,0 +1,375 @@
+/* Wire-format benchmark for the RPC pack layer.
+ *
+ * Usage: bench-protocol [--record|--check] [iterations]
+ *
+ * Builds representative messages (a small RC response, a bulk job
+ * signal request with an explicit job id list, a node summary
+ * response and a slurmdbd job start record), then measures pack and
+ * unpack cost and heap allocation counts per message.  With --record
+ * the results are written to bench-protocol.baseline; with --check a
+ * run is compared against that file and the program exits non-zero on
+ * regression, so the check can gate a change to the pack layer.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include <slurm/slurm.h>
+
+#include <src/common/pack.h>
+#include <src/common/slurm_protocol_defs.h>
+#include <src/common/slurm_protocol_pack.h>
+#include <src/common/slurmdbd_defs.h>
+#include <src/common/slurmdbd_pack.h>
+#include <src/common/xmalloc.h>
+#include <src/common/xstring.h>
+
+#include "bench.h"
+
+#define BASELINE_FILE	"bench-protocol.baseline"
+#define RESULT_MAX	16
+/* Wall time is noisy between runs, allocation counts are not */
+#define TIME_TOLERANCE	1.30
+#define ALLOC_TOLERANCE	1.02
+
+typedef struct {
+	char name[48];
+	double ns_op;
+	double allocs_op;
+} bench_result_t;
+
+static bench_result_t results[RESULT_MAX];
+static int result_cnt = 0;
+
+/* Heap allocation counters, substituted via ld --wrap (see Makefile) */
+static uint64_t alloc_count = 0;
+extern void *__real_malloc(size_t size);
+extern void *__real_calloc(size_t nmemb, size_t size);
+extern void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size)
+{
+	alloc_count++;
+	return __real_malloc(size);
+}
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+	alloc_count++;
+	return __real_calloc(nmemb, size);
+}
+void *__wrap_realloc(void *ptr, size_t size)
+{
+	alloc_count++;
+	return __real_realloc(ptr, size);
+}
+
+/* Report one timed section and save it for baseline record/check */
+static void _bench_finish(const char *name, uint64_t ops, uint64_t allocs)
+{
+	bench_result_t *r;
+	uint64_t usec;
+
+	gettimeofday(&_bench_tv2, NULL);
+	usec  = (_bench_tv2.tv_sec - _bench_tv1.tv_sec) * 1000000;
+	usec += _bench_tv2.tv_usec - _bench_tv1.tv_usec;
+
+	r = &results[result_cnt++];
+	snprintf(r->name, sizeof(r->name), "%s", name);
+	r->ns_op = ops ? (1000.0 * usec / ops) : 0.0;
+	r->allocs_op = ops ? ((double) allocs / ops) : 0.0;
+	printf("%-28s %10"PRIu64" ops %10"PRIu64" usec %10.1f ns/op "
+	       "%8.1f allocs/op\n", name, ops, usec, r->ns_op, r->allocs_op);
+}
+
+/* Time pack_msg and unpack_msg round trips for one message */
+static void _bench_msg(const char *label, slurm_msg_t *msg, int64_t iters)
+{
+	char name[sizeof(results[0].name)];
+	uint64_t allocs;
+	slurm_msg_t out;
+	Buf buffer;
+	int64_t i;
+
+	snprintf(name, sizeof(name), "%s pack", label);
+	alloc_count = 0;
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		buffer = init_buf(1024);
+		if (pack_msg(msg, buffer) != SLURM_SUCCESS) {
+			fprintf(stderr, "%s: pack_msg failed\n", label);
+			exit(1);
+		}
+		free_buf(buffer);
+	}
+	allocs = alloc_count;
+	_bench_finish(name, iters, allocs);
+
+	buffer = init_buf(1024);
+	(void) pack_msg(msg, buffer);
+
+	snprintf(name, sizeof(name), "%s unpack", label);
+	alloc_count = 0;
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		set_buf_offset(buffer, 0);
+		slurm_msg_t_init(&out);
+		out.msg_type = msg->msg_type;
+		out.protocol_version = msg->protocol_version;
+		if (unpack_msg(&out, buffer) != SLURM_SUCCESS) {
+			fprintf(stderr, "%s: unpack_msg failed\n", label);
+			exit(1);
+		}
+		slurm_free_msg_data(out.msg_type, out.data);
+	}
+	allocs = alloc_count;
+	_bench_finish(name, iters, allocs);
+	free_buf(buffer);
+}
+
+/* Small fixed-size response, the per-message overhead floor */
+static void _bench_rc(int64_t iters)
+{
+	return_code_msg_t rc_msg = { .return_code = SLURM_SUCCESS };
+	slurm_msg_t msg;
+
+	slurm_msg_t_init(&msg);
+	msg.protocol_version = SLURM_PROTOCOL_VERSION;
+	msg.msg_type = RESPONSE_SLURM_RC;
+	msg.data = &rc_msg;
+	_bench_msg("rc response", &msg, iters * 10);
+}
+
+/* Bulk signal request carrying an explicit job id list */
+static void _bench_kill_jobs(int64_t iters)
+{
+	kill_jobs_msg_t kill_msg;
+	slurm_msg_t msg;
+	int i, job_cnt = 10000;
+
+	memset(&kill_msg, 0, sizeof(kill_msg));
+	kill_msg.signal = SIGKILL;
+	kill_msg.job_state = NO_VAL;
+	kill_msg.jobs_cnt = job_cnt;
+	kill_msg.jobs_array = xcalloc(job_cnt, sizeof(char *));
+	for (i = 0; i < job_cnt; i++)
+		kill_msg.jobs_array[i] = xstrdup_printf("%"PRIu64,
+			100000 + (bench_rand() % 1000000));
+
+	slurm_msg_t_init(&msg);
+	msg.protocol_version = SLURM_PROTOCOL_VERSION;
+	msg.msg_type = REQUEST_KILL_JOBS;
+	msg.data = &kill_msg;
+	_bench_msg("kill jobs", &msg, iters / 10);
+
+	for (i = 0; i < job_cnt; i++)
+		xfree(kill_msg.jobs_array[i]);
+	xfree(kill_msg.jobs_array);
+}
+
+/* Per-partition node summary response, one row per partition */
+static void _bench_node_summary(int64_t iters)
+{
+	node_summary_info_msg_t sum;
+	partition_summary_t *row;
+	slurm_msg_t msg;
+	int i, part_cnt = 512;
+
+	memset(&sum, 0, sizeof(sum));
+	sum.last_update = time(NULL);
+	sum.record_count = part_cnt;
+	sum.summary_array = xcalloc(part_cnt, sizeof(partition_summary_t));
+	for (i = 0; i < part_cnt; i++) {
+		row = &sum.summary_array[i];
+		row->partition = xstrdup_printf("partition%04d", i);
+		row->nodes_alloc = bench_rand() % 1000;
+		row->nodes_idle  = bench_rand() % 1000;
+		row->nodes_other = bench_rand() % 10;
+		row->nodes_total = row->nodes_alloc + row->nodes_idle +
+				   row->nodes_other;
+		row->cpus_alloc  = row->nodes_alloc * 32;
+		row->cpus_idle   = row->nodes_idle * 32;
+		row->cpus_other  = row->nodes_other * 32;
+		row->cpus_total  = row->nodes_total * 32;
+	}
+
+	slurm_msg_t_init(&msg);
+	msg.protocol_version = SLURM_PROTOCOL_VERSION;
+	msg.msg_type = RESPONSE_NODE_INFO_SUMMARY;
+	msg.data = &sum;
+	_bench_msg("node summary", &msg, iters);
+
+	for (i = 0; i < part_cnt; i++)
+		xfree(sum.summary_array[i].partition);
+	xfree(sum.summary_array);
+}
+
+/* Accounting job start record, the bulk of slurmdbd agent traffic */
+static void _bench_dbd_job_start(int64_t iters)
+{
+	dbd_job_start_msg_t start;
+	slurmdbd_msg_t req, out;
+	uint64_t allocs;
+	Buf buffer;
+	int64_t i;
+
+	memset(&start, 0, sizeof(start));
+	start.account = "bench_acct";
+	start.alloc_nodes = 16;
+	start.array_task_id = NO_VAL;
+	start.assoc_id = 42;
+	start.constraints = "haswell&largemem";
+	start.db_index = NO_VAL64;
+	start.eligible_time = time(NULL);
+	start.gid = 1001;
+	start.job_id = 100001;
+	start.job_state = JOB_RUNNING;
+	start.name = "bench_job";
+	start.nodes = "node[0000-0015]";
+	start.node_inx = "0-15";
+	start.partition = "batch";
+	start.priority = 1000;
+	start.qos_id = 1;
+	start.req_cpus = 512;
+	start.req_mem = 2048;
+	start.start_time = time(NULL);
+	start.submit_time = start.start_time - 30;
+	start.timelimit = 60;
+	start.uid = 1001;
+	start.tres_alloc_str = "1=512,2=32768,4=16";
+	start.tres_req_str = "1=512,2=32768,4=16";
+	start.wckey = "bench";
+	start.work_dir = "/home/bench/run.0001";
+	req.msg_type = DBD_JOB_START;
+	req.data = &start;
+
+	alloc_count = 0;
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		buffer = pack_slurmdbd_msg(&req, SLURM_PROTOCOL_VERSION);
+		if (!buffer) {
+			fprintf(stderr, "dbd job start: pack failed\n");
+			exit(1);
+		}
+		free_buf(buffer);
+	}
+	allocs = alloc_count;
+	_bench_finish("dbd job start pack", iters, allocs);
+
+	buffer = pack_slurmdbd_msg(&req, SLURM_PROTOCOL_VERSION);
+	alloc_count = 0;
+	BENCH_START();
+	for (i = 0; i < iters; i++) {
+		set_buf_offset(buffer, 0);
+		memset(&out, 0, sizeof(out));
+		if (unpack_slurmdbd_msg(&out, SLURM_PROTOCOL_VERSION,
+					buffer) != SLURM_SUCCESS) {
+			fprintf(stderr, "dbd job start: unpack failed\n");
+			exit(1);
+		}
+		slurmdbd_free_msg(&out);
+	}
+	allocs = alloc_count;
+	_bench_finish("dbd job start unpack", iters, allocs);
+	free_buf(buffer);
+}
+
+static int _record_baseline(void)
+{
+	FILE *fp = fopen(BASELINE_FILE, "w");
+	int i;
+
+	if (!fp) {
+		perror(BASELINE_FILE);
+		return 1;
+	}
+	for (i = 0; i < result_cnt; i++)
+		fprintf(fp, "%s\t%.1f\t%.3f\n", results[i].name,
+			results[i].ns_op, results[i].allocs_op);
+	fclose(fp);
+	printf("recorded %d baselines to %s\n", result_cnt, BASELINE_FILE);
+	return 0;
+}
+
+static int _check_baseline(void)
+{
+	char line[128], name[sizeof(results[0].name)];
+	double ns_op, allocs_op;
+	int i, found, failures = 0;
+	FILE *fp = fopen(BASELINE_FILE, "r");
+
+	if (!fp) {
+		fprintf(stderr, "no %s, run with --record first\n",
+			BASELINE_FILE);
+		return 1;
+	}
+	while (fgets(line, sizeof(line), fp)) {
+		if (sscanf(line, "%47[^\t]\t%lf\t%lf",
+			   name, &ns_op, &allocs_op) != 3)
+			continue;
+		found = 0;
+		for (i = 0; i < result_cnt; i++) {
+			if (strcmp(results[i].name, name))
+				continue;
+			found = 1;
+			if (results[i].ns_op > (ns_op * TIME_TOLERANCE)) {
+				fprintf(stderr,
+					"REGRESSION %s: %.1f ns/op, "
+					"baseline %.1f\n",
+					name, results[i].ns_op, ns_op);
+				failures++;
+			}
+			if (results[i].allocs_op >
+			    ((allocs_op * ALLOC_TOLERANCE) + 0.5)) {
+				fprintf(stderr,
+					"REGRESSION %s: %.1f allocs/op, "
+					"baseline %.1f\n",
+					name, results[i].allocs_op, allocs_op);
+				failures++;
+			}
+			break;
+		}
+		if (!found)
+			fprintf(stderr, "warning: baseline entry \"%s\" "
+				"not produced by this run\n", name);
+	}
+	fclose(fp);
+	if (failures) {
+		fprintf(stderr, "%d regression(s) against %s\n",
+			failures, BASELINE_FILE);
+		return 1;
+	}
+	printf("all results within tolerance of %s\n", BASELINE_FILE);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int64_t iters = 10000;
+	bool record = false, check = false;
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--record"))
+			record = true;
+		else if (!strcmp(argv[i], "--check"))
+			check = true;
+		else if (atoll(argv[i]) > 0)
+			iters = atoll(argv[i]);
+		else {
+			fprintf(stderr,
+				"usage: %s [--record|--check] [iterations]\n",
+				argv[0]);
+			exit(1);
+		}
+	}
+	printf("protocol: iterations=%"PRId64"\n", iters);
+
+	_bench_rc(iters);
+	_bench_kill_jobs(iters);
+	_bench_node_summary(iters);
+	_bench_dbd_job_start(iters);
+
+	if (record)
+		return _record_baseline();
+	if (check)
+		return _check_baseline();
+	return 0;
+}
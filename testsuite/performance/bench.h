@@ -0,0 +1,37 @@
+/* Shared helpers for the standalone performance harness */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+static struct timeval _bench_tv1, _bench_tv2;
+
+#define BENCH_START() gettimeofday(&_bench_tv1, NULL)
+
+/* Report elapsed time for "ops" operations under label "name" */
+#define BENCH_STOP(name, ops)						\
+do {									\
+	uint64_t _usec, _ops = (uint64_t) (ops);			\
+	gettimeofday(&_bench_tv2, NULL);				\
+	_usec  = (_bench_tv2.tv_sec - _bench_tv1.tv_sec) * 1000000;	\
+	_usec += _bench_tv2.tv_usec - _bench_tv1.tv_usec;		\
+	printf("%-28s %12"PRIu64" ops %12"PRIu64" usec %10.1f ns/op\n",	\
+	       name, _ops, _usec,					\
+	       _ops ? (1000.0 * _usec / _ops) : 0.0);			\
+} while (0)
+
+/* xorshift PRNG, deterministic so runs are comparable */
+static uint64_t _bench_rand_state = 88172645463325252ULL;
+static inline uint64_t bench_rand(void)
+{
+	_bench_rand_state ^= _bench_rand_state << 13;
+	_bench_rand_state ^= _bench_rand_state >> 7;
+	_bench_rand_state ^= _bench_rand_state << 17;
+	return _bench_rand_state;
+}
+
+#endif /* !_BENCH_H */
@@ -0,0 +1,180 @@
+/* Replay a slurmctld RPC capture against a test controller.
+ *
+ * Usage: rpc-replay <capture_file> <host> <port> [speedup]
+ *
+ * The capture is produced on the controller with
+ * SlurmctldParameters=rpc_capture_file=<path> and holds timestamped
+ * raw message buffers in host byte order (see slurm_rpc_capture_start
+ * in src/common/slurm_protocol_api.c); replay on the same
+ * architecture it was captured on. Messages are sent with the
+ * original inter-arrival spacing divided by the speedup factor, one
+ * connection per message as slurmctld expects, and responses are
+ * drained and discarded.
+ *
+ * Captured messages embed auth credentials which expire, so replay
+ * against a test controller running with auth/none. Replays driving
+ * state-changing RPCs will change state: use a throwaway cluster.
+ */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+#define RPC_CAPTURE_MAGIC 0x52504343	/* "RPCC" */
+#define MAX_MSG_SIZE (16 * 1024 * 1024)
+
+static int _connect_to(const char *host, const char *port)
+{
+	struct addrinfo hints, *res, *rp;
+	int fd = -1, one = 1;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	if (getaddrinfo(host, port, &hints, &res)) {
+		fprintf(stderr, "cannot resolve %s:%s\n", host, port);
+		return -1;
+	}
+	for (rp = res; rp; rp = rp->ai_next) {
+		fd = socket(rp->ai_family, rp->ai_socktype, rp->ai_protocol);
+		if (fd < 0)
+			continue;
+		if (connect(fd, rp->ai_addr, rp->ai_addrlen) == 0)
+			break;
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(res);
+	if (fd >= 0)
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	return fd;
+}
+
+static int _write_all(int fd, const char *buf, size_t len)
+{
+	size_t off = 0;
+	ssize_t n;
+
+	while (off < len) {
+		n = write(fd, buf + off, len - off);
+		if (n <= 0)
+			return -1;
+		off += n;
+	}
+	return 0;
+}
+
+/* Drain the response (4 byte length prefix plus body), discarding it */
+static void _drain_response(int fd)
+{
+	uint32_t rsp_len;
+	char drain[65536];
+	size_t left;
+	ssize_t n;
+
+	if (read(fd, &rsp_len, sizeof(rsp_len)) != sizeof(rsp_len))
+		return;
+	left = ntohl(rsp_len);
+	while (left > 0) {
+		n = read(fd, drain,
+			 (left < sizeof(drain)) ? left : sizeof(drain));
+		if (n <= 0)
+			return;
+		left -= n;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t rec[4], wire_len;
+	uint64_t first_cap = 0, start, target, now;
+	uint64_t sent = 0, failed = 0;
+	double speedup = 1.0;
+	char *msg_buf;
+	FILE *fp;
+	int fd;
+
+	if ((argc < 4) || (argc > 5)) {
+		fprintf(stderr,
+			"usage: %s <capture_file> <host> <port> [speedup]\n",
+			argv[0]);
+		exit(1);
+	}
+	if (argc == 5)
+		speedup = atof(argv[4]);
+	if (speedup <= 0.0) {
+		fprintf(stderr, "invalid speedup %s\n", argv[4]);
+		exit(1);
+	}
+
+	if (!(fp = fopen(argv[1], "r"))) {
+		fprintf(stderr, "cannot open %s: %s\n", argv[1],
+			strerror(errno));
+		exit(1);
+	}
+
+	BENCH_START();
+	start = 0;
+	while (fread(rec, sizeof(rec), 1, fp) == 1) {
+		uint64_t cap_time;
+
+		if (rec[0] != RPC_CAPTURE_MAGIC) {
+			fprintf(stderr, "bad record magic, corrupt capture "
+				"or wrong architecture\n");
+			exit(1);
+		}
+		if (rec[3] > MAX_MSG_SIZE) {
+			fprintf(stderr, "insane message length %u\n", rec[3]);
+			exit(1);
+		}
+		msg_buf = malloc(rec[3]);
+		if (!msg_buf || (fread(msg_buf, 1, rec[3], fp) != rec[3])) {
+			fprintf(stderr, "truncated capture\n");
+			exit(1);
+		}
+
+		/* Pace to the recorded inter-arrival times */
+		cap_time = ((uint64_t) rec[1] * 1000000) + rec[2];
+		if (!first_cap) {
+			first_cap = cap_time;
+			gettimeofday(&_bench_tv2, NULL);
+			start = ((uint64_t) _bench_tv2.tv_sec * 1000000) +
+				_bench_tv2.tv_usec;
+		}
+		target = start + (uint64_t) ((cap_time - first_cap) / speedup);
+		gettimeofday(&_bench_tv2, NULL);
+		now = ((uint64_t) _bench_tv2.tv_sec * 1000000) +
+		      _bench_tv2.tv_usec;
+		if (target > now)
+			usleep(target - now);
+
+		wire_len = htonl(rec[3]);
+		if (((fd = _connect_to(argv[2], argv[3])) < 0) ||
+		    _write_all(fd, (char *) &wire_len, sizeof(wire_len)) ||
+		    _write_all(fd, msg_buf, rec[3])) {
+			failed++;
+		} else {
+			_drain_response(fd);
+			sent++;
+		}
+		if (fd >= 0)
+			close(fd);
+		free(msg_buf);
+	}
+	BENCH_STOP("replayed messages", sent);
+	fclose(fp);
+
+	printf("sent %"PRIu64" messages, %"PRIu64" failed, speedup %.2fx\n",
+	       sent, failed, speedup);
+	return failed ? 1 : 0;
+}